@@ -0,0 +1,4 @@
+#pragma once
+
+#include <ATen/Functions.h>
+#include <ATen/Tensor.h>
@@ -0,0 +1,120 @@
+#pragma once
+
+// AT_DISPATCH_*: run a generic lambda with `scalar_t` bound to the C++ type
+// of a runtime ScalarType, e.g.
+//
+//   AT_DISPATCH_ALL_TYPES_AND_FLOAT8(iter.dtype(), "fill_cpu", [&] {
+//     *static_cast<scalar_t*>(ptr) = static_cast<scalar_t>(value);
+//   });
+//
+// The lambda's return value is returned; dtypes outside the listed set
+// throw with NAME in the message.
+
+#include <c10/core/ScalarType.h>
+#include <c10/util/Exception.h>
+
+#define AT_PRIVATE_CASE_TYPE(enum_type, type, ...) \
+  case c10::ScalarType::enum_type: {               \
+    using scalar_t [[maybe_unused]] = type;        \
+    return __VA_ARGS__();                          \
+  }
+
+#define AT_PRIVATE_DISPATCH_SWITCH(TYPE, NAME, CASES)                      \
+  [&] {                                                                    \
+    const c10::ScalarType _st = TYPE;                                      \
+    switch (_st) {                                                         \
+      CASES                                                                \
+      default:                                                             \
+        TORCH_CHECK(false, '"', NAME, "\" not implemented for '", _st, "'"); \
+    }                                                                      \
+  }()
+
+#define AT_PRIVATE_FLOATING_CASES(...)              \
+  AT_PRIVATE_CASE_TYPE(Double, double, __VA_ARGS__) \
+  AT_PRIVATE_CASE_TYPE(Float, float, __VA_ARGS__)
+
+#define AT_PRIVATE_INTEGRAL_CASES(...)                 \
+  AT_PRIVATE_CASE_TYPE(Byte, uint8_t, __VA_ARGS__)     \
+  AT_PRIVATE_CASE_TYPE(Char, int8_t, __VA_ARGS__)      \
+  AT_PRIVATE_CASE_TYPE(Short, int16_t, __VA_ARGS__)    \
+  AT_PRIVATE_CASE_TYPE(Int, int32_t, __VA_ARGS__)      \
+  AT_PRIVATE_CASE_TYPE(Long, int64_t, __VA_ARGS__)     \
+  AT_PRIVATE_CASE_TYPE(UInt16, uint16_t, __VA_ARGS__)  \
+  AT_PRIVATE_CASE_TYPE(UInt32, uint32_t, __VA_ARGS__)  \
+  AT_PRIVATE_CASE_TYPE(UInt64, uint64_t, __VA_ARGS__)
+
+#define AT_DISPATCH_FLOATING_TYPES(TYPE, NAME, ...) \
+  AT_PRIVATE_DISPATCH_SWITCH(TYPE, NAME, AT_PRIVATE_FLOATING_CASES(__VA_ARGS__))
+
+#define AT_DISPATCH_FLOATING_TYPES_AND_HALF(TYPE, NAME, ...) \
+  AT_PRIVATE_DISPATCH_SWITCH(                                \
+      TYPE,                                                  \
+      NAME,                                                  \
+      AT_PRIVATE_FLOATING_CASES(__VA_ARGS__)                 \
+          AT_PRIVATE_CASE_TYPE(Half, c10::Half, __VA_ARGS__))
+
+// Float, Double and the reduced floating types Half and BFloat16, for
+// kernels that compute the latter in at::opmath_type (float)
+#define AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(TYPE, NAME, ...) \
+  AT_PRIVATE_DISPATCH_SWITCH(                                            \
+      TYPE,                                                              \
+      NAME,                                                              \
+      AT_PRIVATE_FLOATING_CASES(__VA_ARGS__)                             \
+          AT_PRIVATE_CASE_TYPE(Half, c10::Half, __VA_ARGS__)             \
+              AT_PRIVATE_CASE_TYPE(BFloat16, c10::BFloat16, __VA_ARGS__))
+
+#define AT_DISPATCH_INTEGRAL_TYPES(TYPE, NAME, ...) \
+  AT_PRIVATE_DISPATCH_SWITCH(TYPE, NAME, AT_PRIVATE_INTEGRAL_CASES(__VA_ARGS__))
+
+#define AT_PRIVATE_FLOAT8_CASES(...)                               \
+  AT_PRIVATE_CASE_TYPE(Float8_e5m2, c10::Float8_e5m2, __VA_ARGS__) \
+  AT_PRIVATE_CASE_TYPE(Float8_e4m3fn, c10::Float8_e4m3fn, __VA_ARGS__)
+
+// the storage-only Float8 types, converted to and from float
+#define AT_DISPATCH_FLOAT8_TYPES(TYPE, NAME, ...) \
+  AT_PRIVATE_DISPATCH_SWITCH(TYPE, NAME, AT_PRIVATE_FLOAT8_CASES(__VA_ARGS__))
+
+// every type of AT_FORALL_SCALAR_TYPES but the Float8, quantized and 4-bit
+// types, which have no arithmetic, see AT_DISPATCH_ALL_TYPES_AND_FLOAT8 and
+// AT_DISPATCH_QINT_TYPES
+#define AT_DISPATCH_ALL_TYPES(TYPE, NAME, ...)                       \
+  AT_PRIVATE_DISPATCH_SWITCH(                                        \
+      TYPE,                                                          \
+      NAME,                                                          \
+      AT_PRIVATE_FLOATING_CASES(__VA_ARGS__)                         \
+          AT_PRIVATE_CASE_TYPE(Half, c10::Half, __VA_ARGS__)         \
+              AT_PRIVATE_INTEGRAL_CASES(__VA_ARGS__)                 \
+                  AT_PRIVATE_CASE_TYPE(Bool, bool, __VA_ARGS__)      \
+                      AT_PRIVATE_CASE_TYPE(                          \
+                          BFloat16, c10::BFloat16, __VA_ARGS__))
+
+// every type of AT_FORALL_SCALAR_TYPES but the quantized and 4-bit ones, for
+// kernels that only move and convert values (fill_, copy_)
+#define AT_DISPATCH_ALL_TYPES_AND_FLOAT8(TYPE, NAME, ...)            \
+  AT_PRIVATE_DISPATCH_SWITCH(                                        \
+      TYPE,                                                          \
+      NAME,                                                          \
+      AT_PRIVATE_FLOATING_CASES(__VA_ARGS__)                         \
+          AT_PRIVATE_CASE_TYPE(Half, c10::Half, __VA_ARGS__)         \
+              AT_PRIVATE_INTEGRAL_CASES(__VA_ARGS__)                 \
+                  AT_PRIVATE_CASE_TYPE(Bool, bool, __VA_ARGS__)      \
+                      AT_PRIVATE_CASE_TYPE(                          \
+                          BFloat16, c10::BFloat16, __VA_ARGS__)      \
+                          AT_PRIVATE_FLOAT8_CASES(__VA_ARGS__))
+
+#define AT_PRIVATE_QINT_CASE_TYPE(enum_type, type, ...)                 \
+  case c10::ScalarType::enum_type: {                                    \
+    using scalar_t [[maybe_unused]] = type;                             \
+    using underlying_t [[maybe_unused]] = typename scalar_t::underlying; \
+    return __VA_ARGS__();                                               \
+  }
+
+// the quantized types, with `underlying_t` bound to the integer type that
+// scalar_t holds, which is what kernels compute on
+#define AT_DISPATCH_QINT_TYPES(TYPE, NAME, ...)                       \
+  AT_PRIVATE_DISPATCH_SWITCH(                                         \
+      TYPE,                                                           \
+      NAME,                                                           \
+      AT_PRIVATE_QINT_CASE_TYPE(QInt8, c10::qint8, __VA_ARGS__)       \
+          AT_PRIVATE_QINT_CASE_TYPE(QUInt8, c10::quint8, __VA_ARGS__) \
+              AT_PRIVATE_QINT_CASE_TYPE(QInt32, c10::qint32, __VA_ARGS__))
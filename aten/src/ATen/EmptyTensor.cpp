@@ -0,0 +1,103 @@
+#include <ATen/EmptyTensor.h>
+#include <c10/cpu/CPUAllocator.h>
+
+namespace at::detail {
+
+namespace {
+
+void check_size_nonnegative(IntArrayRef size) {
+  for (const auto& x : size) {
+    TORCH_CHECK(
+        x >= 0,
+        "Trying to create tensor with negative dimension ",
+        x,
+        ": ",
+        size);
+  }
+}
+
+TensorBase make_empty_tensor(size_t nbytes, ScalarType dtype) {
+  // Tensors created here are never resized in place, so their storage is not
+  // resizable; this lets small CPU tensors carry their data inline.
+  Storage storage(
+      Storage::use_byte_size_t{}, nbytes, c10::GetCPUAllocator(), false);
+  return TensorBase(
+      c10::make_intrusive<TensorImpl>(std::move(storage), TypeMeta(dtype)));
+}
+
+} // namespace
+
+size_t computeStorageNbytes(
+    IntArrayRef sizes,
+    IntArrayRef strides,
+    size_t itemsize,
+    size_t storage_offset) {
+  TORCH_CHECK(
+      sizes.size() == strides.size(),
+      "dimensionality of sizes (",
+      sizes.size(),
+      ") must match dimensionality of strides (",
+      strides.size(),
+      ")");
+  // size of the underlying storage is 1 bigger than the offset of the last
+  // element according to stride
+  size_t size = 1;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (sizes[i] == 0) {
+      return 0;
+    }
+    size += strides[i] * (sizes[i] - 1);
+  }
+  return itemsize * (storage_offset + size);
+}
+
+size_t computeStorageNbytesContiguous(IntArrayRef sizes, size_t itemsize) {
+  size_t numel = 1;
+  for (int64_t size : sizes) {
+    numel *= static_cast<size_t>(size);
+  }
+  return numel * itemsize;
+}
+
+size_t computeStorageNbytes(
+    IntArrayRef sizes,
+    IntArrayRef strides,
+    ScalarType dtype,
+    size_t storage_offset) {
+  return c10::storageNbytes(
+      dtype, computeStorageNbytes(sizes, strides, 1, storage_offset));
+}
+
+size_t computeStorageNbytesContiguous(IntArrayRef sizes, ScalarType dtype) {
+  return c10::storageNbytes(dtype, computeStorageNbytesContiguous(sizes, 1));
+}
+
+TensorBase empty_cpu(
+    IntArrayRef size,
+    ScalarType dtype,
+    std::optional<MemoryFormat> memory_format) {
+  check_size_nonnegative(size);
+  const size_t nbytes = computeStorageNbytesContiguous(size, dtype);
+  TensorBase tensor = make_empty_tensor(nbytes, dtype);
+  TensorImpl* impl = tensor.unsafeGetTensorImpl();
+  impl->set_sizes_contiguous(size);
+  if (memory_format.has_value() and
+      *memory_format != MemoryFormat::Contiguous) {
+    TORCH_CHECK(
+        *memory_format != MemoryFormat::Preserve,
+        "Preserve memory format is unsupported by empty");
+    impl->empty_tensor_restride(*memory_format);
+  }
+  return tensor;
+}
+
+TensorBase
+empty_strided_cpu(IntArrayRef size, IntArrayRef stride, ScalarType dtype) {
+  check_size_nonnegative(size);
+  const size_t nbytes = computeStorageNbytes(size, stride, dtype);
+  TensorBase tensor = make_empty_tensor(nbytes, dtype);
+  tensor.unsafeGetTensorImpl()->set_sizes_and_strides(size, stride);
+  return tensor;
+}
+
+} // namespace at::detail
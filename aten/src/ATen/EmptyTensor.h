@@ -0,0 +1,40 @@
+#pragma once
+
+#include <ATen/core/TensorBase.h>
+
+#include <optional>
+
+namespace at::detail {
+
+// number of bytes a storage needs to back a tensor of the given geometry,
+// 0 for empty tensors
+TORCH_API size_t computeStorageNbytes(
+    IntArrayRef sizes,
+    IntArrayRef strides,
+    size_t itemsize,
+    size_t storage_offset = 0);
+
+TORCH_API size_t
+computeStorageNbytesContiguous(IntArrayRef sizes, size_t itemsize);
+
+// the same for elements of dtype, which may be sub-byte: the storage of a
+// 4-bit tensor ends in a partly used byte if it spans an odd number of
+// elements
+TORCH_API size_t computeStorageNbytes(
+    IntArrayRef sizes,
+    IntArrayRef strides,
+    ScalarType dtype,
+    size_t storage_offset = 0);
+
+TORCH_API size_t
+computeStorageNbytesContiguous(IntArrayRef sizes, ScalarType dtype);
+
+TORCH_API TensorBase empty_cpu(
+    IntArrayRef size,
+    ScalarType dtype,
+    std::optional<MemoryFormat> memory_format = std::nullopt);
+
+TORCH_API TensorBase
+empty_strided_cpu(IntArrayRef size, IntArrayRef stride, ScalarType dtype);
+
+} // namespace at::detail
@@ -0,0 +1,96 @@
+#include <ATen/ExpandUtils.h>
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+
+namespace at {
+
+std::vector<int64_t> infer_size(c10::IntArrayRef a, c10::IntArrayRef b) {
+  const size_t dimsA = a.size();
+  const size_t dimsB = b.size();
+  const size_t ndim = std::max(dimsA, dimsB);
+  std::vector<int64_t> expandedSizes(ndim);
+
+  for (ptrdiff_t i = static_cast<ptrdiff_t>(ndim) - 1; i >= 0; --i) {
+    const ptrdiff_t offset = static_cast<ptrdiff_t>(ndim) - 1 - i;
+    const ptrdiff_t dimA = static_cast<ptrdiff_t>(dimsA) - 1 - offset;
+    const ptrdiff_t dimB = static_cast<ptrdiff_t>(dimsB) - 1 - offset;
+    const int64_t sizeA = dimA >= 0 ? a[dimA] : 1;
+    const int64_t sizeB = dimB >= 0 ? b[dimB] : 1;
+
+    TORCH_CHECK(
+        sizeA == sizeB or sizeA == 1 or sizeB == 1,
+        "The size of tensor a (",
+        sizeA,
+        ") must match the size of tensor b (",
+        sizeB,
+        ") at non-singleton dimension ",
+        i);
+
+    // 1s map to the other size (even 0)
+    expandedSizes[i] = sizeA == 1 ? sizeB : sizeA;
+  }
+  return expandedSizes;
+}
+
+InferExpandGeometryResult inferExpandGeometry(
+    c10::IntArrayRef tensor_sizes,
+    c10::IntArrayRef tensor_strides,
+    c10::IntArrayRef sizes) {
+  const int64_t ndim = static_cast<int64_t>(sizes.size());
+  const int64_t tensor_dim = static_cast<int64_t>(tensor_sizes.size());
+  TORCH_CHECK(
+      ndim >= tensor_dim,
+      "expand: the number of sizes provided (",
+      ndim,
+      ") must be greater or equal to the number of dimensions in the tensor (",
+      tensor_dim,
+      ")");
+
+  InferExpandGeometryResult result;
+  result.sizes.resize(ndim);
+  result.strides.resize(ndim);
+
+  if (tensor_dim == 0) {
+    std::copy(sizes.begin(), sizes.end(), result.sizes.begin());
+    return result;
+  }
+
+  // create a new geometry for the tensors
+  for (int64_t i = ndim - 1; i >= 0; --i) {
+    const int64_t offset = ndim - 1 - i;
+    const int64_t dim = tensor_dim - 1 - offset;
+    int64_t size = dim >= 0 ? tensor_sizes[dim] : 1;
+    int64_t stride = dim >= 0 ? tensor_strides[dim]
+                              : result.sizes[i + 1] * result.strides[i + 1];
+    int64_t target_size = sizes[i];
+    if (target_size == -1) {
+      TORCH_CHECK(
+          dim >= 0,
+          "expand: -1 is not allowed in a leading, non-existing dimension ",
+          i);
+      target_size = size;
+    }
+    if (size != target_size) {
+      TORCH_CHECK(
+          size == 1,
+          "The expanded size of the tensor (",
+          target_size,
+          ") must match the existing size (",
+          size,
+          ") at non-singleton dimension ",
+          i,
+          ".  Target sizes: ",
+          sizes,
+          ".  Tensor sizes: ",
+          tensor_sizes);
+      size = target_size;
+      stride = 0;
+    }
+    result.sizes[i] = size;
+    result.strides[i] = stride;
+  }
+  return result;
+}
+
+} // namespace at
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <c10/util/ArrayRef.h>
+#include <c10/util/Macros.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace at {
+
+// broadcast shape of two tensors, following NumPy rules
+TORCH_API std::vector<int64_t> infer_size(
+    c10::IntArrayRef a,
+    c10::IntArrayRef b);
+
+struct InferExpandGeometryResult {
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> strides;
+};
+
+// Sizes and strides of `tensor_sizes`/`tensor_strides` expanded to `sizes`:
+// new leading dims and expanded size-1 dims get stride 0, so every element
+// along them aliases the same memory. A size of -1 keeps the existing one.
+TORCH_API InferExpandGeometryResult inferExpandGeometry(
+    c10::IntArrayRef tensor_sizes,
+    c10::IntArrayRef tensor_strides,
+    c10::IntArrayRef sizes);
+
+} // namespace at
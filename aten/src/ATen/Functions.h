@@ -0,0 +1,509 @@
+#pragma once
+
+// Operators of the at:: namespace. Only CPU exists, so each one forwards
+// straight to its implementation in ATen/native.
+
+#include <ATen/NativeFunctions.h>
+
+namespace at {
+
+inline Tensor empty(
+    IntArrayRef size,
+    ScalarType dtype = ScalarType::Float,
+    std::optional<MemoryFormat> memory_format = std::nullopt) {
+  return native::empty(size, dtype, memory_format);
+}
+
+inline Tensor empty_strided(
+    IntArrayRef size,
+    IntArrayRef stride,
+    ScalarType dtype = ScalarType::Float) {
+  return native::empty_strided(size, stride, dtype);
+}
+
+// Uninitialized quantized tensors, contiguous, with the given quantization
+// parameters; see ATen/quantized/Quantizer.h.
+inline Tensor _empty_affine_quantized(
+    IntArrayRef size,
+    ScalarType dtype,
+    double scale,
+    int64_t zero_point) {
+  return native::_empty_affine_quantized(size, dtype, scale, zero_point);
+}
+
+inline Tensor _empty_per_channel_affine_quantized(
+    IntArrayRef size,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis,
+    ScalarType dtype) {
+  return native::_empty_per_channel_affine_quantized(
+      size, scales, zero_points, axis, dtype);
+}
+
+// Convolution of an N x C x (L | H x W | D x H x W) input with a C_out x
+// C / groups x kernel weight. stride, padding and dilation hold one value
+// per spatial dim or one for all. Contiguous and channels-last inputs are
+// read as they are, and the output has the same layout; see
+// native/Convolution.h for the algorithms.
+inline Tensor convolution(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  return native::convolution(
+      input, weight, bias, stride, padding, dilation, groups);
+}
+
+inline Tensor conv1d(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias = std::nullopt,
+    IntArrayRef stride = 1,
+    IntArrayRef padding = 0,
+    IntArrayRef dilation = 1,
+    int64_t groups = 1) {
+  return native::conv1d(input, weight, bias, stride, padding, dilation, groups);
+}
+
+inline Tensor conv2d(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias = std::nullopt,
+    IntArrayRef stride = 1,
+    IntArrayRef padding = 0,
+    IntArrayRef dilation = 1,
+    int64_t groups = 1) {
+  return native::conv2d(input, weight, bias, stride, padding, dilation, groups);
+}
+
+inline Tensor conv3d(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias = std::nullopt,
+    IntArrayRef stride = 1,
+    IntArrayRef padding = 0,
+    IntArrayRef dilation = 1,
+    int64_t groups = 1) {
+  return native::conv3d(input, weight, bias, stride, padding, dilation, groups);
+}
+
+// Writes src, broadcast to the sizes of self and converted to its dtype,
+// into self.
+inline const Tensor& copy_(const Tensor& self, const Tensor& src) {
+  return native::copy_(self, src);
+}
+
+// self converted to dtype, laid out like self; self itself if it already
+// has that dtype, unless copy is set.
+inline Tensor to(const Tensor& self, ScalarType dtype, bool copy = false) {
+  return native::to(self, dtype, copy);
+}
+
+// self if it is contiguous in memory_format, else a copy of it that is
+inline Tensor contiguous(
+    const Tensor& self,
+    MemoryFormat memory_format = MemoryFormat::Contiguous) {
+  return native::contiguous(self, memory_format);
+}
+
+// Per-tensor scaled Float8: to_float8() stores self / scale in the Float8
+// dtype, saturating, from_float8() reads it back as self * scale, and
+// float8_scale() is the scale that maps the largest magnitude of self to the
+// largest finite value of dtype.
+inline Tensor to_float8(const Tensor& self, ScalarType dtype, double scale) {
+  return native::to_float8(self, dtype, scale);
+}
+
+inline Tensor from_float8(
+    const Tensor& self,
+    double scale,
+    ScalarType dtype = ScalarType::Float) {
+  return native::from_float8(self, scale, dtype);
+}
+
+inline double float8_scale(const Tensor& self, ScalarType dtype) {
+  return native::float8_scale(self, dtype);
+}
+
+inline const Tensor& fill_(const Tensor& self, double value) {
+  return native::fill_(self, value);
+}
+
+// Normalizes input over its trailing dims normalized_shape to zero mean and
+// unit (biased) variance, then scales by weight and shifts by bias, both of
+// size normalized_shape.
+inline Tensor layer_norm(
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight = std::nullopt,
+    const std::optional<Tensor>& bias = std::nullopt,
+    double eps = 1e-5) {
+  return native::layer_norm(input, normalized_shape, weight, bias, eps);
+}
+
+inline const Tensor& layer_norm_(
+    const Tensor& self,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight = std::nullopt,
+    const std::optional<Tensor>& bias = std::nullopt,
+    double eps = 1e-5) {
+  return native::layer_norm_(self, normalized_shape, weight, bias, eps);
+}
+
+// Divides input by the root mean square over its trailing dims
+// normalized_shape, then scales by weight. eps defaults to the machine
+// epsilon of the dtype.
+inline Tensor rms_norm(
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight = std::nullopt,
+    std::optional<double> eps = std::nullopt) {
+  return native::rms_norm(input, normalized_shape, weight, eps);
+}
+
+inline const Tensor& rms_norm_(
+    const Tensor& self,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight = std::nullopt,
+    std::optional<double> eps = std::nullopt) {
+  return native::rms_norm_(self, normalized_shape, weight, eps);
+}
+
+// A sparse self is multiplied as CSR, converting COO and CSC first, by row
+// ranges of about equal numbers of elements on the intra-op threads.
+inline Tensor mm(const Tensor& self, const Tensor& mat2) {
+  return native::mm(self, mat2);
+}
+
+// self @ (mat2 * scale) for a Float8 mat2, e.g. weights stored in 8 bits,
+// with the dtype of self; mat2 is widened block by block as the product
+// runs, never as a whole.
+inline Tensor scaled_mm(const Tensor& self, const Tensor& mat2, double scale) {
+  return native::scaled_mm(self, mat2, scale);
+}
+
+// input @ weight^T + bias in 8 bits: a QUInt8 [m, k] input quantized per
+// tensor, a QInt8 [n, k] weight quantized per tensor or per output channel
+// (axis 0) and an optional Float bias [n]. The products are accumulated
+// exactly in int32 and the result requantized to a QUInt8 [m, n] tensor of
+// the given output scale and zero point.
+inline Tensor quantized_linear(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    double output_scale,
+    int64_t output_zero_point) {
+  return native::quantized_linear(
+      input, weight, bias, output_scale, output_zero_point);
+}
+
+// Group-wise 4-bit weights (see native/Packed4Bit.h): scales_4bit() is
+// the Half scale of each group of group_size elements of a [n, k] floating
+// weight that maps its largest magnitude to the largest code value (7 for
+// Int4, 1 for NF4), to_4bit() packs weight / scale into codes of dtype,
+// Int4 or NF4, rounding to nearest, and from_4bit() decodes them back to a
+// Float [n, k] tensor.
+inline Tensor
+scales_4bit(const Tensor& weight, ScalarType dtype, int64_t group_size) {
+  return native::scales_4bit(weight, dtype, group_size);
+}
+
+inline Tensor
+to_4bit(const Tensor& weight, ScalarType dtype, const Tensor& scales) {
+  return native::to_4bit(weight, dtype, scales);
+}
+
+inline Tensor from_4bit(const Tensor& self, const Tensor& scales) {
+  return native::from_4bit(self, scales);
+}
+
+// input @ weight^T + bias for a Float [m, k] input and a packed 4-bit
+// [n, k] weight with its scales, as Float [m, n]. Small batches decode the
+// weight in registers as they read it; large ones decode it to Float once
+// for the GEMM.
+inline Tensor linear_4bit(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& scales,
+    const std::optional<Tensor>& bias = std::nullopt) {
+  return native::linear_4bit(input, weight, scales, bias);
+}
+
+// Quantization of a Float tensor to dtype (QInt8, QUInt8 or QInt32), per
+// tensor or per slice along axis, rounding to nearest even and clamping to
+// the range of dtype; dequantize() gives back the real values as Float.
+inline Tensor quantize_per_tensor(
+    const Tensor& self,
+    double scale,
+    int64_t zero_point,
+    ScalarType dtype) {
+  return native::quantize_per_tensor(self, scale, zero_point, dtype);
+}
+
+inline Tensor quantize_per_channel(
+    const Tensor& self,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis,
+    ScalarType dtype) {
+  return native::quantize_per_channel(self, scales, zero_points, axis, dtype);
+}
+
+inline Tensor dequantize(const Tensor& self) {
+  return native::dequantize(self);
+}
+
+// the stored integers of a quantized tensor, as Char, Byte or Int
+inline Tensor int_repr(const Tensor& self) {
+  return native::int_repr(self);
+}
+
+// A quantized tensor holding the integers of self (Char, Byte or Int for
+// QInt8, QUInt8 and QInt32) as they are, with the given parameters.
+inline Tensor _make_per_tensor_quantized_tensor(
+    const Tensor& self,
+    double scale,
+    int64_t zero_point) {
+  return native::_make_per_tensor_quantized_tensor(self, scale, zero_point);
+}
+
+inline Tensor _make_per_channel_quantized_tensor(
+    const Tensor& self,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis) {
+  return native::_make_per_channel_quantized_tensor(
+      self, scales, zero_points, axis);
+}
+
+inline QScheme qscheme(const Tensor& self) {
+  return native::qscheme(self);
+}
+
+inline double q_scale(const Tensor& self) {
+  return native::q_scale(self);
+}
+
+inline int64_t q_zero_point(const Tensor& self) {
+  return native::q_zero_point(self);
+}
+
+inline Tensor q_per_channel_scales(const Tensor& self) {
+  return native::q_per_channel_scales(self);
+}
+
+inline Tensor q_per_channel_zero_points(const Tensor& self) {
+  return native::q_per_channel_zero_points(self);
+}
+
+inline int64_t q_per_channel_axis(const Tensor& self) {
+  return native::q_per_channel_axis(self);
+}
+
+// Sparse tensors (see c10/core/Layout.h), whose index and value arrays are
+// ordinary strided tensors. sparse_coo_tensor() is the COO tensor of the
+// given sizes with values[i] at indices[:, i], for Long [dim, nnz] indices;
+// duplicates add up until coalesce() sorts the indices in row-major order
+// and sums them.
+inline Tensor sparse_coo_tensor(
+    const Tensor& indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  return native::sparse_coo_tensor(indices, values, size);
+}
+
+inline Tensor coalesce(const Tensor& self) {
+  return native::coalesce(self);
+}
+
+inline bool is_coalesced(const Tensor& self) {
+  return native::is_coalesced(self);
+}
+
+// CSR and CSC matrices of the given sizes: the elements of row (column) i
+// are j = crow_indices[i] (ccol_indices[i]) up to the next one, in the
+// column col_indices[j] (row row_indices[j]) with the value values[j].
+inline Tensor sparse_csr_tensor(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  return native::sparse_csr_tensor(crow_indices, col_indices, values, size);
+}
+
+inline Tensor sparse_csc_tensor(
+    const Tensor& ccol_indices,
+    const Tensor& row_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  return native::sparse_csc_tensor(ccol_indices, row_indices, values, size);
+}
+
+// The arrays of a sparse tensor, shared with it: _nnz() is the number of
+// specified elements, indices() those of a COO tensor, values() those of
+// any sparse layout.
+inline int64_t _nnz(const Tensor& self) {
+  return native::_nnz(self);
+}
+
+inline Tensor indices(const Tensor& self) {
+  return native::indices(self);
+}
+
+inline Tensor values(const Tensor& self) {
+  return native::values(self);
+}
+
+inline Tensor crow_indices(const Tensor& self) {
+  return native::crow_indices(self);
+}
+
+inline Tensor col_indices(const Tensor& self) {
+  return native::col_indices(self);
+}
+
+inline Tensor ccol_indices(const Tensor& self) {
+  return native::ccol_indices(self);
+}
+
+inline Tensor row_indices(const Tensor& self) {
+  return native::row_indices(self);
+}
+
+// Conversions between the layouts, self itself if it already has the
+// layout: the sparse layouts keep the nonzero elements of a strided tensor,
+// to_sparse_csr() and to_sparse_csc() take matrices, and to_dense() sums
+// duplicates.
+inline Tensor to_dense(const Tensor& self) {
+  return native::to_dense(self);
+}
+
+inline Tensor to_sparse(const Tensor& self) {
+  return native::to_sparse(self);
+}
+
+inline Tensor to_sparse_csr(const Tensor& self) {
+  return native::to_sparse_csr(self);
+}
+
+inline Tensor to_sparse_csc(const Tensor& self) {
+  return native::to_sparse_csc(self);
+}
+
+inline Tensor sum(
+    const Tensor& self,
+    IntArrayRef dim = {},
+    bool keepdim = false) {
+  return native::sum(self, dim, keepdim);
+}
+
+inline Tensor mean(
+    const Tensor& self,
+    IntArrayRef dim = {},
+    bool keepdim = false) {
+  return native::mean(self, dim, keepdim);
+}
+
+inline Tensor amax(
+    const Tensor& self,
+    IntArrayRef dim = {},
+    bool keepdim = false) {
+  return native::amax(self, dim, keepdim);
+}
+
+inline Tensor amin(
+    const Tensor& self,
+    IntArrayRef dim = {},
+    bool keepdim = false) {
+  return native::amin(self, dim, keepdim);
+}
+
+inline Tensor max(const Tensor& self) {
+  return native::max(self);
+}
+
+inline Tensor min(const Tensor& self) {
+  return native::min(self);
+}
+
+inline Tensor argmax(
+    const Tensor& self,
+    std::optional<int64_t> dim = std::nullopt,
+    bool keepdim = false) {
+  return native::argmax(self, dim, keepdim);
+}
+
+inline Tensor argmin(
+    const Tensor& self,
+    std::optional<int64_t> dim = std::nullopt,
+    bool keepdim = false) {
+  return native::argmin(self, dim, keepdim);
+}
+
+inline Tensor norm(
+    const Tensor& self,
+    double p = 2,
+    IntArrayRef dim = {},
+    bool keepdim = false) {
+  return native::norm(self, p, dim, keepdim);
+}
+
+// exp(self) / sum(exp(self)) along dim, computed without overflow
+inline Tensor softmax(const Tensor& self, int64_t dim) {
+  return native::softmax(self, dim);
+}
+
+inline const Tensor& softmax_(const Tensor& self, int64_t dim) {
+  return native::softmax_(self, dim);
+}
+
+inline Tensor as_strided(
+    const Tensor& self,
+    IntArrayRef size,
+    IntArrayRef stride,
+    std::optional<int64_t> storage_offset = std::nullopt) {
+  return native::as_strided(self, size, stride, storage_offset);
+}
+
+inline Tensor slice(
+    const Tensor& self,
+    int64_t dim = 0,
+    std::optional<int64_t> start = std::nullopt,
+    std::optional<int64_t> end = std::nullopt,
+    int64_t step = 1) {
+  return native::slice(self, dim, start, end, step);
+}
+
+inline Tensor select(const Tensor& self, int64_t dim, int64_t index) {
+  return native::select(self, dim, index);
+}
+
+inline Tensor transpose(const Tensor& self, int64_t dim0, int64_t dim1) {
+  return native::transpose(self, dim0, dim1);
+}
+
+inline Tensor t(const Tensor& self) {
+  return native::t(self);
+}
+
+inline Tensor permute(const Tensor& self, IntArrayRef dims) {
+  return native::permute(self, dims);
+}
+
+inline Tensor expand(const Tensor& self, IntArrayRef size) {
+  return native::expand(self, size);
+}
+
+inline Tensor view(const Tensor& self, IntArrayRef size) {
+  return native::view(self, size);
+}
+
+inline Tensor unsqueeze(const Tensor& self, int64_t dim) {
+  return native::unsqueeze(self, dim);
+}
+
+} // namespace at
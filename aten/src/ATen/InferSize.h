@@ -0,0 +1,47 @@
+#pragma once
+
+#include <c10/util/ArrayRef.h>
+#include <c10/util/Exception.h>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace at {
+
+// Resolves a single -1 in `shape` so that it holds `numel` elements, e.g. for
+// view(). Throws if the shape is incompatible.
+inline std::vector<int64_t> infer_size(c10::IntArrayRef shape, int64_t numel) {
+  std::vector<int64_t> res(shape.begin(), shape.end());
+  int64_t newsize = 1;
+  std::optional<size_t> infer_dim;
+  for (size_t dim = 0; dim < shape.size(); ++dim) {
+    if (shape[dim] == -1) {
+      TORCH_CHECK(!infer_dim.has_value(), "only one dimension can be inferred");
+      infer_dim = dim;
+    } else {
+      TORCH_CHECK(shape[dim] >= 0, "invalid shape dimension ", shape[dim]);
+      newsize *= shape[dim];
+    }
+  }
+
+  if (numel == newsize or (infer_dim.has_value() and newsize > 0 and
+                           numel % newsize == 0)) {
+    if (infer_dim.has_value()) {
+      // a -1 next to a 0 would be ambiguous, e.g. [2, 0, -1] for 0 elements
+      TORCH_CHECK(
+          newsize != 0,
+          "cannot reshape tensor of 0 elements into shape ",
+          shape,
+          " because the unspecified dimension size -1 can be any value and is "
+          "ambiguous");
+      res[*infer_dim] = numel / newsize;
+    }
+    return res;
+  }
+
+  TORCH_CHECK(
+      false, "shape '", shape, "' is invalid for input of size ", numel);
+}
+
+} // namespace at
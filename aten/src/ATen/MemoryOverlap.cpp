@@ -0,0 +1,64 @@
+#include <ATen/MemoryOverlap.h>
+
+namespace at {
+
+MemOverlap has_internal_overlap(const TensorBase& t) {
+  if (t.is_non_overlapping_and_dense()) {
+    return MemOverlap::No;
+  }
+  const IntArrayRef sizes = t.sizes();
+  const IntArrayRef strides = t.strides();
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (strides[i] == 0 and sizes[i] > 1) {
+      return MemOverlap::Yes;
+    }
+  }
+  return MemOverlap::TooHard;
+}
+
+void assert_no_internal_overlap(const TensorBase& t) {
+  TORCH_CHECK(
+      has_internal_overlap(t) != MemOverlap::Yes,
+      "unsupported operation: more than one element of the written-to "
+      "tensor refers to a single memory location.");
+}
+
+MemOverlapStatus get_overlap_status(const TensorBase& a, const TensorBase& b) {
+  if (a.is_same(b)) {
+    return MemOverlapStatus::Full;
+  }
+  if (a.numel() == 0 or b.numel() == 0) {
+    return MemOverlapStatus::No;
+  }
+  if (!a.is_non_overlapping_and_dense() or
+      !b.is_non_overlapping_and_dense()) {
+    return MemOverlapStatus::TooHard;
+  }
+  if (!a.is_alias_of(b)) {
+    return MemOverlapStatus::No;
+  }
+  // dense tensors cover the bytes from their first element to their last
+  const char* a_begin = static_cast<const char*>(a.const_data_ptr());
+  const char* b_begin = static_cast<const char*>(b.const_data_ptr());
+  const char* a_end = a_begin + a.nbytes();
+  const char* b_end = b_begin + b.nbytes();
+  if (a_begin == b_begin and a_end == b_end) {
+    // e.g. a matrix and its transpose cover the same bytes
+    return a.strides() == b.strides() ? MemOverlapStatus::Full
+                                      : MemOverlapStatus::Partial;
+  }
+  if (a_begin < b_end and b_begin < a_end) {
+    return MemOverlapStatus::Partial;
+  }
+  return MemOverlapStatus::No;
+}
+
+void assert_no_partial_overlap(const TensorBase& a, const TensorBase& b) {
+  TORCH_CHECK(
+      get_overlap_status(a, b) != MemOverlapStatus::Partial,
+      "unsupported operation: some elements of the input tensor and the "
+      "written-to tensor refer to a single memory location; copy the input "
+      "first.");
+}
+
+} // namespace at
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <ATen/core/TensorBase.h>
+
+// Whether the elements of tensors share memory, for kernels that write to
+// one tensor while reading another: an element written before it is read
+// through another view gives results that depend on the order of the loop,
+// its tiling and its threads. Only non-overlapping and dense tensors are
+// analysed; other layouts (e.g. slices with gaps) are TooHard and let
+// through, as exact answers would need the gcd of their strides.
+
+namespace at {
+
+// whether two elements of a tensor share memory
+enum class MemOverlap { No, Yes, TooHard };
+
+// how the memory of two tensors overlaps: Full means they are the same
+// elements at the same positions, which elementwise kernels allow
+enum class MemOverlapStatus { Full, Partial, No, TooHard };
+
+TORCH_API MemOverlap has_internal_overlap(const TensorBase& t);
+
+// throws if t, which is written to, has elements that share memory
+TORCH_API void assert_no_internal_overlap(const TensorBase& t);
+
+TORCH_API MemOverlapStatus
+get_overlap_status(const TensorBase& a, const TensorBase& b);
+
+// throws if the written-to tensor a and the input b overlap other than fully
+TORCH_API void assert_no_partial_overlap(
+    const TensorBase& a,
+    const TensorBase& b);
+
+} // namespace at
@@ -0,0 +1,249 @@
+#pragma once
+
+// CPU implementations of the operators exposed in ATen/Functions.h
+
+#include <ATen/core/Tensor.h>
+
+#include <cstdint>
+#include <optional>
+
+namespace at::native {
+
+// TensorFactories.cpp
+TORCH_API Tensor empty(
+    IntArrayRef size,
+    ScalarType dtype = ScalarType::Float,
+    std::optional<MemoryFormat> memory_format = std::nullopt);
+TORCH_API Tensor empty_strided(
+    IntArrayRef size,
+    IntArrayRef stride,
+    ScalarType dtype = ScalarType::Float);
+TORCH_API Tensor _empty_affine_quantized(
+    IntArrayRef size,
+    ScalarType dtype,
+    double scale,
+    int64_t zero_point);
+TORCH_API Tensor _empty_per_channel_affine_quantized(
+    IntArrayRef size,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis,
+    ScalarType dtype);
+
+// Convolution.cpp
+TORCH_API Tensor convolution(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups);
+TORCH_API Tensor conv1d(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias = std::nullopt,
+    IntArrayRef stride = 1,
+    IntArrayRef padding = 0,
+    IntArrayRef dilation = 1,
+    int64_t groups = 1);
+TORCH_API Tensor conv2d(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias = std::nullopt,
+    IntArrayRef stride = 1,
+    IntArrayRef padding = 0,
+    IntArrayRef dilation = 1,
+    int64_t groups = 1);
+TORCH_API Tensor conv3d(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias = std::nullopt,
+    IntArrayRef stride = 1,
+    IntArrayRef padding = 0,
+    IntArrayRef dilation = 1,
+    int64_t groups = 1);
+
+// Copy.cpp
+TORCH_API const Tensor& copy_(const Tensor& self, const Tensor& src);
+TORCH_API Tensor to(const Tensor& self, ScalarType dtype, bool copy = false);
+TORCH_API Tensor contiguous(
+    const Tensor& self,
+    MemoryFormat memory_format = MemoryFormat::Contiguous);
+TORCH_API Tensor
+to_float8(const Tensor& self, ScalarType dtype, double scale);
+TORCH_API Tensor from_float8(
+    const Tensor& self,
+    double scale,
+    ScalarType dtype = ScalarType::Float);
+TORCH_API double float8_scale(const Tensor& self, ScalarType dtype);
+
+// Fill.cpp
+TORCH_API const Tensor& fill_(const Tensor& self, double value);
+
+// LayerNorm.cpp
+TORCH_API Tensor layer_norm(
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight = std::nullopt,
+    const std::optional<Tensor>& bias = std::nullopt,
+    double eps = 1e-5);
+TORCH_API const Tensor& layer_norm_(
+    const Tensor& self,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight = std::nullopt,
+    const std::optional<Tensor>& bias = std::nullopt,
+    double eps = 1e-5);
+TORCH_API Tensor rms_norm(
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight = std::nullopt,
+    std::optional<double> eps = std::nullopt);
+TORCH_API const Tensor& rms_norm_(
+    const Tensor& self,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight = std::nullopt,
+    std::optional<double> eps = std::nullopt);
+
+// LinearAlgebra.cpp
+TORCH_API Tensor mm(const Tensor& self, const Tensor& mat2);
+TORCH_API Tensor
+scaled_mm(const Tensor& self, const Tensor& mat2, double scale);
+TORCH_API Tensor quantized_linear(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    double output_scale,
+    int64_t output_zero_point);
+
+// Packed4Bit.cpp
+TORCH_API Tensor
+scales_4bit(const Tensor& weight, ScalarType dtype, int64_t group_size);
+TORCH_API Tensor
+to_4bit(const Tensor& weight, ScalarType dtype, const Tensor& scales);
+TORCH_API Tensor from_4bit(const Tensor& self, const Tensor& scales);
+TORCH_API Tensor linear_4bit(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& scales,
+    const std::optional<Tensor>& bias = std::nullopt);
+
+// QTensor.cpp
+TORCH_API Tensor quantize_per_tensor(
+    const Tensor& self,
+    double scale,
+    int64_t zero_point,
+    ScalarType dtype);
+TORCH_API Tensor quantize_per_channel(
+    const Tensor& self,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis,
+    ScalarType dtype);
+TORCH_API Tensor dequantize(const Tensor& self);
+TORCH_API Tensor int_repr(const Tensor& self);
+TORCH_API Tensor _make_per_tensor_quantized_tensor(
+    const Tensor& self,
+    double scale,
+    int64_t zero_point);
+TORCH_API Tensor _make_per_channel_quantized_tensor(
+    const Tensor& self,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis);
+TORCH_API QScheme qscheme(const Tensor& self);
+TORCH_API double q_scale(const Tensor& self);
+TORCH_API int64_t q_zero_point(const Tensor& self);
+TORCH_API Tensor q_per_channel_scales(const Tensor& self);
+TORCH_API Tensor q_per_channel_zero_points(const Tensor& self);
+TORCH_API int64_t q_per_channel_axis(const Tensor& self);
+
+// ReduceOps.cpp
+TORCH_API Tensor sum(
+    const Tensor& self,
+    IntArrayRef dim = {},
+    bool keepdim = false);
+TORCH_API Tensor mean(
+    const Tensor& self,
+    IntArrayRef dim = {},
+    bool keepdim = false);
+TORCH_API Tensor amax(
+    const Tensor& self,
+    IntArrayRef dim = {},
+    bool keepdim = false);
+TORCH_API Tensor amin(
+    const Tensor& self,
+    IntArrayRef dim = {},
+    bool keepdim = false);
+TORCH_API Tensor max(const Tensor& self);
+TORCH_API Tensor min(const Tensor& self);
+TORCH_API Tensor argmax(
+    const Tensor& self,
+    std::optional<int64_t> dim = std::nullopt,
+    bool keepdim = false);
+TORCH_API Tensor argmin(
+    const Tensor& self,
+    std::optional<int64_t> dim = std::nullopt,
+    bool keepdim = false);
+TORCH_API Tensor norm(
+    const Tensor& self,
+    double p = 2,
+    IntArrayRef dim = {},
+    bool keepdim = false);
+
+// SoftMax.cpp
+TORCH_API Tensor softmax(const Tensor& self, int64_t dim);
+TORCH_API const Tensor& softmax_(const Tensor& self, int64_t dim);
+
+// SparseCsrTensor.cpp
+TORCH_API Tensor sparse_csr_tensor(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size);
+TORCH_API Tensor sparse_csc_tensor(
+    const Tensor& ccol_indices,
+    const Tensor& row_indices,
+    const Tensor& values,
+    IntArrayRef size);
+TORCH_API Tensor crow_indices(const Tensor& self);
+TORCH_API Tensor col_indices(const Tensor& self);
+TORCH_API Tensor ccol_indices(const Tensor& self);
+TORCH_API Tensor row_indices(const Tensor& self);
+TORCH_API Tensor to_sparse_csr(const Tensor& self);
+TORCH_API Tensor to_sparse_csc(const Tensor& self);
+
+// SparseTensor.cpp
+TORCH_API Tensor sparse_coo_tensor(
+    const Tensor& indices,
+    const Tensor& values,
+    IntArrayRef size);
+TORCH_API Tensor coalesce(const Tensor& self);
+TORCH_API bool is_coalesced(const Tensor& self);
+TORCH_API int64_t _nnz(const Tensor& self);
+TORCH_API Tensor indices(const Tensor& self);
+TORCH_API Tensor values(const Tensor& self);
+TORCH_API Tensor to_dense(const Tensor& self);
+TORCH_API Tensor to_sparse(const Tensor& self);
+
+// TensorShape.cpp
+TORCH_API Tensor as_strided(
+    const Tensor& self,
+    IntArrayRef size,
+    IntArrayRef stride,
+    std::optional<int64_t> storage_offset = std::nullopt);
+TORCH_API Tensor slice(
+    const Tensor& self,
+    int64_t dim = 0,
+    std::optional<int64_t> start = std::nullopt,
+    std::optional<int64_t> end = std::nullopt,
+    int64_t step = 1);
+TORCH_API Tensor select(const Tensor& self, int64_t dim, int64_t index);
+TORCH_API Tensor transpose(const Tensor& self, int64_t dim0, int64_t dim1);
+TORCH_API Tensor t(const Tensor& self);
+TORCH_API Tensor permute(const Tensor& self, IntArrayRef dims);
+TORCH_API Tensor expand(const Tensor& self, IntArrayRef size);
+TORCH_API Tensor view(const Tensor& self, IntArrayRef size);
+TORCH_API Tensor unsqueeze(const Tensor& self, int64_t dim);
+
+} // namespace at::native
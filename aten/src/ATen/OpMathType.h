@@ -0,0 +1,16 @@
+#pragma once
+
+#include <c10/core/ScalarType.h>
+
+#include <type_traits>
+
+namespace at {
+
+// The type kernels compute and accumulate scalar_t in: float for the
+// reduced floating types, which have too few bits to accumulate in, and
+// scalar_t itself otherwise.
+template <typename scalar_t>
+using opmath_type = std::
+    conditional_t<c10::is_reduced_floating_point_v<scalar_t>, float, scalar_t>;
+
+} // namespace at
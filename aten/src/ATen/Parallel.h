@@ -0,0 +1,165 @@
+#pragma once
+
+#include <c10/util/Exception.h>
+#include <c10/util/FunctionRef.h>
+#include <c10/util/Macros.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace at {
+
+inline int64_t divup(int64_t x, int64_t y) {
+  return (x + y - 1) / y;
+}
+
+namespace internal {
+// Ranges smaller than this run on the calling thread; an op over fewer
+// elements is not worth waking up the pool for.
+constexpr int64_t GRAIN_SIZE = 32768;
+
+// Ranges are split into up to this many chunks per thread, so that threads
+// that finish early can steal work from slower ones.
+constexpr int64_t CHUNKS_PER_THREAD = 4;
+
+inline int64_t chunk_size(int64_t range, int64_t grain_size, int num_threads) {
+  return std::max<int64_t>(
+      std::max<int64_t>(grain_size, 1),
+      divup(range, num_threads * CHUNKS_PER_THREAD));
+}
+
+// Runs f(chunk_begin, chunk_end, chunk_index) for the consecutive chunks of
+// chunk_size elements that make up [begin, end), on the intra-op thread
+// pool; rethrows the first exception thrown by f.
+TORCH_API void parallel_run(
+    int64_t begin,
+    int64_t end,
+    int64_t chunk_size,
+    c10::function_ref<void(int64_t, int64_t, int64_t)> f);
+} // namespace internal
+
+// Sets the number of threads used by parallel_for, including the calling
+// thread. Defaults to $OMP_NUM_THREADS or else the number of cpus.
+TORCH_API void set_num_threads(int nthreads);
+
+// Returns the maximum number of threads that may be used in a parallel region
+TORCH_API int get_num_threads();
+
+// Pins the pool's worker threads to the given cpus, round robin; an empty
+// list removes the pinning. Defaults to the comma-separated cpu list in
+// $ATEN_CPU_AFFINITY, if set.
+TORCH_API void set_thread_affinity(std::vector<int> cpus);
+
+// Returns the current thread number (starting from 0) in the current parallel
+// region, or 0 in the sequential region
+TORCH_API int get_thread_num();
+
+// Checks whether the code runs in a parallel region
+TORCH_API bool in_parallel_region();
+
+/*
+parallel_for
+
+begin: index at which to start applying user function
+
+end: index at which to stop applying user function
+
+grain_size: number of elements per chunk. impacts the degree of parallelization
+
+f: user function applied in parallel to the chunks, signature:
+  void f(int64_t begin, int64_t end)
+
+The range is run inline on the calling thread when it is no larger than
+grain_size, when only one thread is configured, or when the caller already is
+inside a parallel region (nested parallelism runs serially).
+*/
+template <class F>
+inline void parallel_for(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const F& f) {
+  TORCH_INTERNAL_ASSERT(grain_size >= 0);
+  if (begin >= end) {
+    return;
+  }
+  const int64_t range = end - begin;
+  if (range <= grain_size or in_parallel_region()) {
+    f(begin, end);
+    return;
+  }
+  const int num_threads = get_num_threads();
+  if (num_threads == 1) {
+    f(begin, end);
+    return;
+  }
+  internal::parallel_run(
+      begin,
+      end,
+      internal::chunk_size(range, grain_size, num_threads),
+      [&f](int64_t chunk_begin, int64_t chunk_end, int64_t /*chunk*/) {
+        f(chunk_begin, chunk_end);
+      });
+}
+
+/*
+parallel_reduce
+
+begin: index at which to start applying reduction
+
+end: index at which to stop applying reduction
+
+grain_size: number of elements per chunk. impacts number of elements in
+intermediate results tensor and degree of parallelization.
+
+ident: identity for binary combination function sf. sf(ident, x) needs to return
+x.
+
+f: function for reduction over a chunk. f needs to be of signature scalar_t
+f(int64_t partial_begin, int64_t partial_end, scalar_t identifiy)
+
+sf: function to combine two partial results. sf needs to be of signature
+scalar_t sf(scalar_t x, scalar_t y)
+
+The partial results are combined in chunk order, so for a given thread count
+the result does not depend on scheduling.
+*/
+template <class scalar_t, class F, class SF>
+inline scalar_t parallel_reduce(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const scalar_t ident,
+    const F& f,
+    const SF& sf) {
+  TORCH_INTERNAL_ASSERT(grain_size >= 0);
+  if (begin >= end) {
+    return ident;
+  }
+  const int64_t range = end - begin;
+  if (range <= grain_size or in_parallel_region()) {
+    return f(begin, end, ident);
+  }
+  const int num_threads = get_num_threads();
+  if (num_threads == 1) {
+    return f(begin, end, ident);
+  }
+  const int64_t chunk_size =
+      internal::chunk_size(range, grain_size, num_threads);
+  std::vector<scalar_t> results(divup(range, chunk_size), ident);
+  internal::parallel_run(
+      begin,
+      end,
+      chunk_size,
+      [&](int64_t chunk_begin, int64_t chunk_end, int64_t chunk) {
+        results[chunk] = f(chunk_begin, chunk_end, ident);
+      });
+  scalar_t result = ident;
+  for (const auto& partial : results) {
+    result = sf(result, partial);
+  }
+  return result;
+}
+
+} // namespace at
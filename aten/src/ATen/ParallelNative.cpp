@@ -0,0 +1,122 @@
+#include <ATen/Parallel.h>
+#include <c10/core/thread_pool.h>
+
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace at {
+
+namespace {
+
+int default_num_threads() {
+  if (const char* env = std::getenv("OMP_NUM_THREADS")) {
+    const int nthreads = std::atoi(env);
+    if (nthreads > 0) {
+      return nthreads;
+    }
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+std::vector<int> default_affinity() {
+  std::vector<int> cpus;
+  if (const char* env = std::getenv("ATEN_CPU_AFFINITY")) {
+    std::stringstream ss(env);
+    std::string cpu;
+    while (std::getline(ss, cpu, ',')) {
+      if (!cpu.empty()) {
+        cpus.push_back(std::stoi(cpu));
+      }
+    }
+  }
+  return cpus;
+}
+
+struct PoolConfig {
+  std::mutex mutex;
+  int num_threads = default_num_threads();
+  std::vector<int> cpus = default_affinity();
+};
+
+PoolConfig& pool_config() {
+  static PoolConfig* config = new PoolConfig();
+  return *config;
+}
+
+// The pool is created on first use and leaked, so that parallel regions
+// started from static destructors still work.
+c10::ThreadPool& intraop_pool() {
+  static c10::ThreadPool* pool = [] {
+    PoolConfig& config = pool_config();
+    std::lock_guard<std::mutex> guard(config.mutex);
+    return new c10::ThreadPool(config.num_threads, config.cpus);
+  }();
+  return *pool;
+}
+
+void reconfigure_pool(int num_threads, std::vector<int> cpus) {
+  PoolConfig& config = pool_config();
+  {
+    std::lock_guard<std::mutex> guard(config.mutex);
+    config.num_threads = num_threads;
+    config.cpus = cpus;
+  }
+  intraop_pool().resize(num_threads, std::move(cpus));
+}
+
+} // namespace
+
+void set_num_threads(int nthreads) {
+  TORCH_CHECK(nthreads > 0, "Expected positive number of threads");
+  TORCH_CHECK(
+      !in_parallel_region(),
+      "set_num_threads cannot be called inside a parallel region");
+  std::vector<int> cpus;
+  {
+    PoolConfig& config = pool_config();
+    std::lock_guard<std::mutex> guard(config.mutex);
+    cpus = config.cpus;
+  }
+  reconfigure_pool(nthreads, std::move(cpus));
+}
+
+int get_num_threads() {
+  return intraop_pool().size();
+}
+
+void set_thread_affinity(std::vector<int> cpus) {
+  TORCH_CHECK(
+      !in_parallel_region(),
+      "set_thread_affinity cannot be called inside a parallel region");
+  reconfigure_pool(get_num_threads(), std::move(cpus));
+}
+
+int get_thread_num() {
+  return c10::ThreadPool::current_thread_num();
+}
+
+bool in_parallel_region() {
+  return c10::ThreadPool::in_parallel_region();
+}
+
+namespace internal {
+
+void parallel_run(
+    int64_t begin,
+    int64_t end,
+    int64_t chunk_size,
+    c10::function_ref<void(int64_t, int64_t, int64_t)> f) {
+  TORCH_INTERNAL_ASSERT(chunk_size > 0);
+  const int64_t num_chunks = divup(end - begin, chunk_size);
+  intraop_pool().run(num_chunks, [&](int64_t chunk) {
+    const int64_t chunk_begin = begin + chunk * chunk_size;
+    f(chunk_begin, std::min(end, chunk_begin + chunk_size), chunk);
+  });
+}
+
+} // namespace internal
+
+} // namespace at
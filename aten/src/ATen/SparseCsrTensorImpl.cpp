@@ -0,0 +1,29 @@
+#include <ATen/SparseCsrTensorImpl.h>
+
+namespace at {
+
+SparseCsrTensorImpl::SparseCsrTensorImpl(
+    Layout layout,
+    IntArrayRef size,
+    Tensor compressed_indices,
+    Tensor plain_indices,
+    Tensor values)
+    : TensorImpl(VIEW, Storage(), values.dtype()),
+      compressed_indices_(std::move(compressed_indices)),
+      plain_indices_(std::move(plain_indices)),
+      values_(std::move(values)) {
+  TORCH_INTERNAL_ASSERT(layout == kSparseCsr or layout == kSparseCsc);
+  layout_ = layout;
+  device_opt_ = values_.device();
+  set_sizes_contiguous(size);
+}
+
+SparseCsrTensorImpl* get_sparse_csr_impl(const TensorBase& self) {
+  TORCH_CHECK(
+      self.is_sparse_csr(),
+      "expected a SparseCsr or SparseCsc tensor, got ",
+      self.layout());
+  return static_cast<SparseCsrTensorImpl*>(self.unsafeGetTensorImpl());
+}
+
+} // namespace at
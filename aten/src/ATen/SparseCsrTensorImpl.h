@@ -0,0 +1,53 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <c10/core/TensorImpl.h>
+
+namespace at {
+
+// The TensorImpl of a compressed sparse matrix, CSR (layout SparseCsr) or
+// CSC (layout SparseCsc). The specified elements are grouped by row for
+// CSR, by column for CSC, the compressed dim: the elements of row (column)
+// i are j = compressed_indices[i] up to compressed_indices[i + 1], in the
+// column (row) plain_indices[j] with the value values[j]. Every other
+// element is zero, and the values of elements specified twice add up.
+//
+// compressed_indices is a contiguous Long tensor with one more element than
+// the compressed dim, starting at 0 and nondecreasing up to nnz,
+// plain_indices a contiguous Long [nnz] tensor and values a contiguous
+// [nnz] tensor of the dtype of the matrix; all three are ordinary strided
+// tensors with their own storages, the impl itself has no storage.
+struct TORCH_API SparseCsrTensorImpl : public c10::TensorImpl {
+  SparseCsrTensorImpl(
+      Layout layout,
+      IntArrayRef size,
+      Tensor compressed_indices,
+      Tensor plain_indices,
+      Tensor values);
+
+  const Tensor& compressed_indices() const {
+    return compressed_indices_;
+  }
+
+  const Tensor& plain_indices() const {
+    return plain_indices_;
+  }
+
+  const Tensor& values() const {
+    return values_;
+  }
+
+  int64_t nnz() const {
+    return values_.size(0);
+  }
+
+ private:
+  Tensor compressed_indices_;
+  Tensor plain_indices_;
+  Tensor values_;
+};
+
+// the SparseCsrTensorImpl of a CSR or CSC matrix
+TORCH_API SparseCsrTensorImpl* get_sparse_csr_impl(const TensorBase& self);
+
+} // namespace at
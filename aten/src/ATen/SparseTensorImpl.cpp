@@ -0,0 +1,25 @@
+#include <ATen/SparseTensorImpl.h>
+
+namespace at {
+
+SparseTensorImpl::SparseTensorImpl(
+    IntArrayRef size,
+    Tensor indices,
+    Tensor values,
+    bool coalesced)
+    : TensorImpl(VIEW, Storage(), values.dtype()),
+      indices_(std::move(indices)),
+      values_(std::move(values)),
+      coalesced_(coalesced) {
+  layout_ = kSparse;
+  device_opt_ = values_.device();
+  set_sizes_contiguous(size);
+}
+
+SparseTensorImpl* get_sparse_impl(const TensorBase& self) {
+  TORCH_CHECK(
+      self.is_sparse(), "expected a Sparse tensor, got ", self.layout());
+  return static_cast<SparseTensorImpl*>(self.unsafeGetTensorImpl());
+}
+
+} // namespace at
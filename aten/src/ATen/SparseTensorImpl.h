@@ -0,0 +1,49 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <c10/core/TensorImpl.h>
+
+namespace at {
+
+// The TensorImpl of a COO tensor (layout Sparse). Of the elements its sizes
+// span, only nnz are specified: element i is at the position indices[:, i]
+// and has the value values[i], every other element is zero. indices is a
+// contiguous Long [dim, nnz] tensor and values a contiguous [nnz] tensor of
+// the dtype of the sparse tensor, both ordinary strided tensors with their
+// own storages; the impl itself has no storage.
+//
+// A COO tensor is coalesced when its indices are unique and sorted in
+// row-major order. Otherwise the values of duplicate indices add up.
+struct TORCH_API SparseTensorImpl : public c10::TensorImpl {
+  SparseTensorImpl(
+      IntArrayRef size,
+      Tensor indices,
+      Tensor values,
+      bool coalesced);
+
+  const Tensor& indices() const {
+    return indices_;
+  }
+
+  const Tensor& values() const {
+    return values_;
+  }
+
+  int64_t nnz() const {
+    return values_.size(0);
+  }
+
+  bool coalesced() const {
+    return coalesced_;
+  }
+
+ private:
+  Tensor indices_;
+  Tensor values_;
+  bool coalesced_;
+};
+
+// the SparseTensorImpl of a COO tensor
+TORCH_API SparseTensorImpl* get_sparse_impl(const TensorBase& self);
+
+} // namespace at
@@ -0,0 +1,543 @@
+#include <ATen/EmptyTensor.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/MemoryOverlap.h>
+#include <ATen/TensorIterator.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace at {
+
+namespace {
+
+// Position of a linear index within the iteration space, advanced in steps
+// of whole rows (dim 0) or, when a range starts at a row boundary, of
+// several rows at once.
+struct DimCounter {
+  DimCounter(IntArrayRef shape, int64_t begin, int64_t end)
+      : shape(shape), begin(begin), end(end), values(shape.size()),
+        offset(begin) {
+    int64_t linear_offset = begin;
+    for (size_t dim = 0; dim < shape.size() and linear_offset > 0; ++dim) {
+      const int64_t size = shape[dim];
+      if (size > 0) {
+        values[dim] = linear_offset % size;
+        linear_offset /= size;
+      }
+    }
+    TORCH_INTERNAL_ASSERT(linear_offset == 0);
+  }
+
+  bool is_done() const {
+    return offset >= end;
+  }
+
+  void increment(const std::array<int64_t, 2>& step) {
+    offset += step[0] * step[1];
+    const size_t ndim = values.size();
+    int64_t overflow = step[0];
+    size_t i = 0;
+    if (step[1] != 1) {
+      TORCH_INTERNAL_ASSERT(step[0] == shape[0] and values[0] == 0);
+      i = 1;
+      overflow = step[1];
+    }
+    for (; i < ndim and overflow > 0; ++i) {
+      const int64_t size = shape[i];
+      int64_t value = values[i] + overflow;
+      if (value >= size) {
+        overflow = 1;
+        value -= size;
+        TORCH_INTERNAL_ASSERT(value < size);
+      } else {
+        overflow = 0;
+      }
+      values[i] = value;
+    }
+    TORCH_INTERNAL_ASSERT(overflow == 0 or overflow == 1);
+  }
+
+  // largest 2-d block that starts at the current position and stays within
+  // both the shape and the range
+  std::array<int64_t, 2> max_2d_step() const {
+    const int64_t step0 = std::min(shape[0] - values[0], end - offset);
+    int64_t step1 = 1;
+    if (step0 == shape[0] and shape.size() > 1) {
+      step1 = std::min(shape[1] - values[1], (end - offset) / shape[0]);
+    }
+    return {step0, step1};
+  }
+
+  IntArrayRef shape;
+  int64_t begin;
+  int64_t end;
+  std::vector<int64_t> values;
+  int64_t offset;
+};
+
+} // namespace
+
+TensorIteratorConfig& TensorIteratorConfig::add_output(const Tensor& output) {
+  TORCH_INTERNAL_ASSERT(
+      num_inputs_ == 0,
+      "Keep in mind that you have to add all outputs first before adding any "
+      "input.");
+  tensors_.push_back(output);
+  num_outputs_++;
+  return *this;
+}
+
+TensorIteratorConfig& TensorIteratorConfig::add_input(const Tensor& input) {
+  TORCH_CHECK(input.defined(), "TensorIterator: inputs must be defined");
+  tensors_.push_back(input);
+  num_inputs_++;
+  return *this;
+}
+
+TensorIterator TensorIterator::unary_op(const Tensor& out, const Tensor& a) {
+  return TensorIteratorConfig().add_output(out).add_input(a).build();
+}
+
+TensorIterator TensorIterator::binary_op(
+    const Tensor& out,
+    const Tensor& a,
+    const Tensor& b) {
+  return TensorIteratorConfig()
+      .add_output(out)
+      .add_input(a)
+      .add_input(b)
+      .build();
+}
+
+TensorIterator TensorIterator::nullary_op(const Tensor& out) {
+  return TensorIteratorConfig().add_output(out).build();
+}
+
+TensorIterator TensorIterator::reduce_op(const Tensor& out, const Tensor& a) {
+  TORCH_INTERNAL_ASSERT(out.defined());
+  return TensorIteratorConfig()
+      .add_output(out)
+      .add_input(a)
+      .check_all_same_dtype(false)
+      .is_reduction(true)
+      .build();
+}
+
+void TensorIterator::build(TensorIteratorConfig& config) {
+  is_reduction_ = config.is_reduction_;
+  enforce_linear_iteration_ = config.enforce_linear_iteration_;
+  populate_operands(config);
+  compute_types(config);
+  compute_mem_overlaps();
+  compute_shape();
+  compute_strides();
+  reorder_dimensions();
+  allocate_outputs();
+  coalesce_dimensions();
+  compute_data_ptrs();
+}
+
+void TensorIterator::populate_operands(TensorIteratorConfig& config) {
+  num_outputs_ = config.num_outputs_;
+  operands_.reserve(config.tensors_.size());
+  for (size_t i = 0; i < config.tensors_.size(); ++i) {
+    operands_.emplace_back(std::move(config.tensors_[i]));
+    OperandInfo& op = operands_.back();
+    op.is_output = static_cast<int>(i) < num_outputs_;
+    op.will_resize = !op.tensor.defined();
+    if (op.tensor.defined()) {
+      op.dtype = op.tensor.scalar_type();
+    }
+  }
+  config.tensors_.clear();
+}
+
+void TensorIterator::compute_types(const TensorIteratorConfig& config) {
+  if (ninputs() > 0) {
+    common_dtype_ = operands_[num_outputs_].dtype;
+  } else {
+    // nullary op, the outputs define the dtype
+    for (const auto& op : operands_) {
+      if (!op.will_resize) {
+        common_dtype_ = op.dtype;
+        break;
+      }
+    }
+  }
+  const ScalarType output_dtype = config.output_dtype_ != ScalarType::Undefined
+      ? config.output_dtype_
+      : common_dtype_;
+  for (auto& op : operands_) {
+    if (op.will_resize) {
+      TORCH_CHECK(
+          output_dtype != ScalarType::Undefined,
+          "TensorIterator: cannot infer the dtype of an undefined output");
+      op.dtype = output_dtype;
+    }
+    // the integers of a quantized tensor mean nothing without its quantizer
+    TORCH_CHECK(
+        !isQIntType(op.dtype),
+        "TensorIterator: quantized tensors are unsupported, got dtype ",
+        op.dtype,
+        "; use int_repr() or dequantize()");
+    TORCH_CHECK(
+        !isSubByteType(op.dtype),
+        "TensorIterator: 4-bit tensors are unsupported, got dtype ",
+        op.dtype,
+        "; use from_4bit()");
+    TORCH_CHECK(
+        !op.tensor.defined() or op.tensor.layout() == kStrided,
+        "TensorIterator: ",
+        op.tensor.defined() ? op.tensor.layout() : kStrided,
+        " tensors are unsupported; use to_dense()");
+    if (config.check_all_same_dtype_) {
+      TORCH_CHECK(
+          op.dtype == common_dtype_,
+          "Found dtype ",
+          op.dtype,
+          " but expected ",
+          common_dtype_);
+    }
+  }
+}
+
+void TensorIterator::compute_mem_overlaps() {
+  // the outputs of a reduction alias themselves on purpose, see reduce_op
+  if (is_reduction_) {
+    return;
+  }
+  for (int i = 0; i < num_outputs_; ++i) {
+    const OperandInfo& output = operands_[i];
+    if (output.will_resize) {
+      continue;
+    }
+    // an output whose elements alias each other can't be written to
+    // concurrently, and one that is read through a different view would be
+    // read after some of it was written
+    assert_no_internal_overlap(output.tensor);
+    for (int j = num_outputs_; j < ntensors(); ++j) {
+      assert_no_partial_overlap(output.tensor, operands_[j].tensor);
+    }
+  }
+}
+
+void TensorIterator::compute_shape() {
+  bool has_shape = false;
+  for (int i = num_outputs_; i < ntensors(); ++i) {
+    const IntArrayRef sizes = operands_[i].tensor.sizes();
+    if (!has_shape) {
+      shape_.assign(sizes.begin(), sizes.end());
+      has_shape = true;
+    } else if (sizes != IntArrayRef(shape_)) {
+      shape_ = infer_size(shape_, sizes);
+    }
+  }
+  for (int i = 0; i < num_outputs_; ++i) {
+    const OperandInfo& op = operands_[i];
+    if (op.will_resize) {
+      continue;
+    }
+    const IntArrayRef sizes = op.tensor.sizes();
+    if (!has_shape) {
+      shape_.assign(sizes.begin(), sizes.end());
+      has_shape = true;
+    }
+    TORCH_CHECK(
+        sizes == IntArrayRef(shape_),
+        "output with shape ",
+        sizes,
+        " doesn't match the broadcast shape ",
+        IntArrayRef(shape_));
+  }
+  TORCH_CHECK(has_shape, "TensorIterator: no operand has a defined shape");
+}
+
+void TensorIterator::compute_strides() {
+  const int64_t ndim = this->ndim();
+  for (auto& op : operands_) {
+    if (op.will_resize) {
+      continue;
+    }
+    const IntArrayRef original_shape = op.tensor.sizes();
+    const IntArrayRef original_stride = op.tensor.strides();
+    const int64_t element_size = op.tensor.element_size();
+    const int64_t offset = ndim - static_cast<int64_t>(original_shape.size());
+    op.stride_bytes.assign(ndim, 0);
+    for (size_t i = 0; i < original_shape.size(); ++i) {
+      if (original_shape[i] == 1 and shape_[offset + i] != 1) {
+        op.stride_bytes[offset + i] = 0;
+      } else {
+        op.stride_bytes[offset + i] = original_stride[i] * element_size;
+      }
+    }
+  }
+}
+
+void TensorIterator::reorder_dimensions() {
+  // Sort the dimensions based on strides in ascending order. The first
+  // operand with a strict preference for an order of two dims decides it;
+  // broadcast dims have no preference. The outputs of a reduction are
+  // skipped, so that the input's layout decides the order.
+  const int64_t ndim = this->ndim();
+  perm_.resize(ndim);
+  if (ndim == 1) {
+    perm_[0] = 0;
+    return;
+  }
+
+  // initialize perm with n-1, n-2, ..., 1, 0
+  std::iota(perm_.rbegin(), perm_.rend(), 0);
+
+  // returns 1 if dim0 should come after dim1, -1 if dim0 should come before
+  // dim1, and 0 if the comparison is ambiguous
+  auto should_swap = [&](int64_t dim0, int64_t dim1) {
+    for (const auto& op : operands_) {
+      if (op.will_resize or (is_reduction_ and op.is_output)) {
+        continue;
+      }
+      const int64_t stride0 = op.stride_bytes[dim0];
+      const int64_t stride1 = op.stride_bytes[dim1];
+      // move on to the next operand if one of the dims is broadcast
+      if (stride0 == 0 or stride1 == 0) {
+        continue;
+      }
+      // return only on strict comparisons, equal strides are tie-broken
+      // below or by the next operand
+      if (stride0 < stride1) {
+        return -1;
+      }
+      if (stride0 > stride1) {
+        return 1;
+      }
+      // for equal strides, the dimension with smaller size goes front
+      if (shape_[dim0] > shape_[dim1]) {
+        return 1;
+      }
+    }
+    return 0;
+  };
+
+  // insertion sort with support for ambiguous comparisons; linear iteration
+  // keeps the C order
+  for (int64_t i = 1; i < ndim and !enforce_linear_iteration_; ++i) {
+    int64_t dim1 = i;
+    for (int64_t dim0 = i - 1; dim0 >= 0; --dim0) {
+      const int comparison = should_swap(perm_[dim0], perm_[dim1]);
+      if (comparison > 0) {
+        std::swap(perm_[dim0], perm_[dim1]);
+        dim1 = dim0;
+      } else if (comparison < 0) {
+        break;
+      }
+    }
+  }
+
+  // apply the permutation to the shape and the strides
+  auto apply_perm = [&](std::vector<int64_t>& values) {
+    std::vector<int64_t> permuted(ndim);
+    for (int64_t i = 0; i < ndim; ++i) {
+      permuted[i] = values[perm_[i]];
+    }
+    values.swap(permuted);
+  };
+  apply_perm(shape_);
+  for (auto& op : operands_) {
+    if (!op.will_resize) {
+      apply_perm(op.stride_bytes);
+    }
+  }
+}
+
+void TensorIterator::allocate_outputs() {
+  const int64_t ndim = this->ndim();
+  for (auto& op : operands_) {
+    if (!op.will_resize) {
+      continue;
+    }
+    // Dense strides in the iteration order, mapped back to tensor dims, so
+    // that the output gets the memory layout of the inputs (e.g. channels
+    // last in, channels last out).
+    const int64_t element_size =
+        static_cast<int64_t>(c10::elementSize(op.dtype));
+    op.stride_bytes.resize(ndim);
+    std::vector<int64_t> tensor_shape(ndim);
+    std::vector<int64_t> tensor_stride(ndim);
+    int64_t next_stride = element_size;
+    for (int64_t i = 0; i < ndim; ++i) {
+      op.stride_bytes[i] = next_stride;
+      next_stride *= std::max<int64_t>(shape_[i], 1);
+    }
+    // perm_[i] is the tensor dim that iterator dim i was taken from
+    for (int64_t i = 0; i < ndim; ++i) {
+      tensor_shape[perm_[i]] = shape_[i];
+      tensor_stride[perm_[i]] = op.stride_bytes[i] / element_size;
+    }
+    op.tensor = Tensor(
+        detail::empty_strided_cpu(tensor_shape, tensor_stride, op.dtype));
+    op.will_resize = false;
+  }
+}
+
+void TensorIterator::coalesce_dimensions() {
+  if (ndim() <= 1) {
+    return;
+  }
+
+  // We can coalesce two adjacent dimensions if either dim has size 1 or if:
+  // shape[n] * stride[n] == stride[n + 1] for every operand.
+  auto can_coalesce = [&](int64_t dim0, int64_t dim1) {
+    const int64_t shape0 = shape_[dim0];
+    const int64_t shape1 = shape_[dim1];
+    if (shape0 == 1 or shape1 == 1) {
+      return true;
+    }
+    for (const auto& op : operands_) {
+      if (shape0 * op.stride_bytes[dim0] != op.stride_bytes[dim1]) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // replace each operand's stride at dim0 with its stride at dim1
+  auto replace_stride = [&](int64_t dim0, int64_t dim1) {
+    for (auto& op : operands_) {
+      op.stride_bytes[dim0] = op.stride_bytes[dim1];
+    }
+  };
+
+  int64_t prev_dim = 0;
+  for (int64_t dim = 1; dim < ndim(); ++dim) {
+    if (can_coalesce(prev_dim, dim)) {
+      if (shape_[prev_dim] == 1) {
+        replace_stride(prev_dim, dim);
+      }
+      shape_[prev_dim] *= shape_[dim];
+    } else {
+      prev_dim++;
+      if (prev_dim != dim) {
+        replace_stride(prev_dim, dim);
+        shape_[prev_dim] = shape_[dim];
+      }
+    }
+  }
+
+  shape_.resize(prev_dim + 1);
+  for (auto& op : operands_) {
+    op.stride_bytes.resize(ndim());
+  }
+}
+
+void TensorIterator::compute_data_ptrs() {
+  for (auto& op : operands_) {
+    op.data = op.is_output
+        ? op.tensor.mutable_data_ptr()
+        : const_cast<void*>(op.tensor.const_data_ptr());
+  }
+}
+
+int64_t TensorIterator::numel() const {
+  int64_t numel = 1;
+  for (int64_t size : shape_) {
+    numel *= size;
+  }
+  return numel;
+}
+
+bool TensorIterator::is_contiguous() const {
+  if (numel() == 1) {
+    return true;
+  }
+  if (ndim() != 1) {
+    return false;
+  }
+  for (const auto& op : operands_) {
+    if (op.stride_bytes[0] !=
+        static_cast<int64_t>(c10::elementSize(op.dtype))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int64_t TensorIterator::num_reduce_elements() const {
+  TORCH_INTERNAL_ASSERT(is_reduction_);
+  int64_t numel = 1;
+  for (int64_t dim = 0; dim < ndim(); ++dim) {
+    if (operands_[0].stride_bytes[dim] == 0) {
+      numel *= shape_[dim];
+    }
+  }
+  return numel;
+}
+
+bool TensorIterator::is_scalar(int arg) const {
+  const auto& stride = operands_[arg].stride_bytes;
+  for (int64_t i = 0; i < ndim(); ++i) {
+    if (stride[i] != 0 and shape_[i] != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TensorIterator::for_each(loop2d_t loop, int64_t grain_size) {
+  const int64_t numel = this->numel();
+  if (numel == 0) {
+    return;
+  }
+  if (numel < grain_size or get_num_threads() == 1) {
+    serial_for_each(loop, 0, numel);
+    return;
+  }
+  parallel_for(0, numel, grain_size, [&](int64_t begin, int64_t end) {
+    serial_for_each(loop, begin, end);
+  });
+}
+
+void TensorIterator::serial_for_each(
+    loop2d_t loop,
+    int64_t begin,
+    int64_t end) const {
+  if (begin >= end) {
+    return;
+  }
+  const int ntensors = this->ntensors();
+  const int64_t ndim = this->ndim();
+
+  // strides of all operands, dim by dim; the loop is always given two dims
+  std::vector<int64_t> strides(ntensors * std::max<int64_t>(ndim, 2), 0);
+  for (int64_t dim = 0; dim < ndim; ++dim) {
+    for (int arg = 0; arg < ntensors; ++arg) {
+      strides[dim * ntensors + arg] = operands_[arg].stride_bytes[dim];
+    }
+  }
+
+  std::vector<char*> ptrs(ntensors);
+  auto compute_ptrs = [&](IntArrayRef index) {
+    for (int arg = 0; arg < ntensors; ++arg) {
+      char* ptr = static_cast<char*>(operands_[arg].data);
+      for (size_t dim = 0; dim < index.size(); ++dim) {
+        ptr += index[dim] * strides[dim * ntensors + arg];
+      }
+      ptrs[arg] = ptr;
+    }
+  };
+
+  if (ndim <= 1) {
+    const int64_t start = begin;
+    compute_ptrs(ndim == 0 ? IntArrayRef() : IntArrayRef(start));
+    loop(ptrs.data(), strides.data(), end - begin, 1);
+    return;
+  }
+
+  DimCounter counter(shape_, begin, end);
+  while (!counter.is_done()) {
+    compute_ptrs(counter.values);
+    const auto step = counter.max_2d_step();
+    loop(ptrs.data(), strides.data(), step[0], step[1]);
+    counter.increment(step);
+  }
+}
+
+} // namespace at
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <c10/util/FunctionRef.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// TensorIterator is the loop engine behind elementwise kernels. Given N
+// operands (outputs first) it
+//
+//  1. broadcasts the inputs to a common shape and allocates undefined
+//     outputs with that shape, rejecting defined outputs whose elements
+//     share memory with each other or, other than fully, with an input
+//     (see MemoryOverlap.h),
+//  2. computes per-operand strides in bytes for every dim of that shape
+//     (zero for broadcast dims),
+//  3. reorders the dims so that the one with the smallest strides comes
+//     first, which keeps the innermost loop walking memory sequentially for
+//     transposed or channels-last operands; newly allocated outputs inherit
+//     that order,
+//  4. coalesces adjacent dims that are contiguous with each other in every
+//     operand, so e.g. two contiguous tensors become a single 1-d loop.
+//
+// Kernels then provide a 2-d inner loop that receives one data pointer per
+// operand plus explicit strides for the two innermost dims; with the dims
+// coalesced the first dim is usually long and unit-stride, which is what the
+// compiler needs to vectorize it. for_each() splits the iteration space
+// across threads when it is large enough.
+//
+// Reductions use a single output restrided to the input's shape with
+// stride 0 in the reduced dims (see reduce_op), so that every input element
+// maps to the output element it is reduced into; the reduction engine in
+// native/cpu/Reduce.h walks the iterator's dims itself instead of calling
+// for_each.
+//
+// Internally dim 0 is the fastest moving one, i.e. the reverse of the
+// order of tensor dims.
+
+namespace at {
+
+struct TORCH_API OperandInfo {
+  OperandInfo() = default;
+  explicit OperandInfo(Tensor t) : tensor(std::move(t)) {}
+
+  // stride of each iterator dim in bytes, fastest moving dim first
+  std::vector<int64_t> stride_bytes;
+
+  Tensor tensor;
+
+  ScalarType dtype = ScalarType::Undefined;
+
+  void* data = nullptr;
+
+  bool is_output = false;
+
+  // the output is undefined and gets allocated by the iterator
+  bool will_resize = false;
+};
+
+class TensorIteratorConfig;
+
+class TORCH_API TensorIterator {
+ public:
+  // data: one pointer per operand
+  // strides: the byte strides of the two innermost dims, i.e. strides[i] is
+  //          the stride of operand i along dim 0 and strides[ntensors + i]
+  //          its stride along dim 1
+  // size0, size1: extents of the two dims; the loop visits size0 * size1
+  //               elements per operand
+  using loop2d_t = c10::function_ref<
+      void(char** data, const int64_t* strides, int64_t size0, int64_t size1)>;
+
+  // adapts a 1-d loop `void(char** data, const int64_t* strides, int64_t n)`
+  // to loop2d_t by running it once per step of the second dim
+  template <typename loop1d_t>
+  static auto loop_2d_from_1d(const loop1d_t& loop, int ntensors);
+
+  static TensorIterator unary_op(const Tensor& out, const Tensor& a);
+  static TensorIterator binary_op(
+      const Tensor& out,
+      const Tensor& a,
+      const Tensor& b);
+  static TensorIterator nullary_op(const Tensor& out);
+  // `out` must have a's shape and stride 0 in the reduced dims; its dtype
+  // may differ from a's
+  static TensorIterator reduce_op(const Tensor& out, const Tensor& a);
+
+  int ndim() const {
+    return static_cast<int>(shape_.size());
+  }
+
+  IntArrayRef shape() const {
+    return shape_;
+  }
+
+  int64_t numel() const;
+
+  int ntensors() const {
+    return static_cast<int>(operands_.size());
+  }
+
+  int noutputs() const {
+    return num_outputs_;
+  }
+
+  int ninputs() const {
+    return ntensors() - noutputs();
+  }
+
+  // byte strides of operand `arg`, fastest moving dim first
+  IntArrayRef strides(int arg) const {
+    return operands_[arg].stride_bytes;
+  }
+
+  void* data_ptr(int arg) const {
+    return operands_[arg].data;
+  }
+
+  ScalarType dtype(int arg = 0) const {
+    return operands_[arg].dtype;
+  }
+
+  ScalarType input_dtype(int arg = 0) const {
+    return operands_[num_outputs_ + arg].dtype;
+  }
+
+  ScalarType common_dtype() const {
+    return common_dtype_;
+  }
+
+  const Tensor& tensor(int arg) const {
+    return operands_[arg].tensor;
+  }
+
+  const Tensor& output(int arg = 0) const {
+    TORCH_INTERNAL_ASSERT(arg < num_outputs_);
+    return operands_[arg].tensor;
+  }
+
+  const Tensor& input(int arg = 0) const {
+    TORCH_INTERNAL_ASSERT(arg >= 0 and arg < ninputs());
+    return operands_[num_outputs_ + arg].tensor;
+  }
+
+  bool is_reduction() const {
+    return is_reduction_;
+  }
+
+  // number of input elements reduced into each output element, for
+  // iterators built with reduce_op
+  int64_t num_reduce_elements() const;
+
+  // whether the iteration is a single dim along which every operand is
+  // contiguous (or a broadcast scalar, if allowed)
+  bool is_contiguous() const;
+
+  // whether operand `arg` has stride 0 in every dim
+  bool is_scalar(int arg) const;
+
+  // runs `loop` over the whole iteration space, in parallel when numel
+  // exceeds grain_size
+  void for_each(loop2d_t loop, int64_t grain_size = internal::GRAIN_SIZE);
+
+  template <
+      typename loop1d_t,
+      std::enable_if_t<
+          std::is_convertible_v<
+              loop1d_t,
+              c10::function_ref<
+                  void(char**, const int64_t* strides, int64_t size)>>,
+          int> = 0>
+  void for_each(
+      const loop1d_t& loop,
+      int64_t grain_size = internal::GRAIN_SIZE) {
+    for_each(loop_2d_from_1d(loop, ntensors()), grain_size);
+  }
+
+  // runs `loop` over the linear index range [begin, end) of the iteration
+  // space on the calling thread
+  void serial_for_each(loop2d_t loop, int64_t begin, int64_t end) const;
+
+ private:
+  friend class TensorIteratorConfig;
+
+  TensorIterator() = default;
+
+  void build(TensorIteratorConfig& config);
+  void populate_operands(TensorIteratorConfig& config);
+  void compute_types(const TensorIteratorConfig& config);
+  void compute_mem_overlaps();
+  void compute_shape();
+  void compute_strides();
+  void reorder_dimensions();
+  void allocate_outputs();
+  void coalesce_dimensions();
+  void compute_data_ptrs();
+
+  std::vector<int64_t> shape_;
+
+  // perm_[i] is the tensor dim that iterator dim i corresponds to, as chosen
+  // by reorder_dimensions (only meaningful before coalescing)
+  std::vector<int64_t> perm_;
+
+  std::vector<OperandInfo> operands_;
+
+  int num_outputs_ = 0;
+
+  ScalarType common_dtype_ = ScalarType::Undefined;
+
+  bool is_reduction_ = false;
+
+  bool enforce_linear_iteration_ = false;
+};
+
+class TORCH_API TensorIteratorConfig final {
+ public:
+  TensorIteratorConfig() = default;
+
+  TensorIteratorConfig(const TensorIteratorConfig&) = delete;
+  TensorIteratorConfig& operator=(const TensorIteratorConfig&) = delete;
+
+  // outputs must be added before inputs; an undefined output is allocated
+  // with the broadcast shape and the common dtype of the inputs
+  TensorIteratorConfig& add_output(const Tensor& output);
+  TensorIteratorConfig& add_input(const Tensor& input);
+
+  // by default all operands must share one dtype
+  TensorIteratorConfig& check_all_same_dtype(bool check) {
+    check_all_same_dtype_ = check;
+    return *this;
+  }
+
+  // dtype of allocated outputs when it differs from the inputs' dtype
+  TensorIteratorConfig& declare_output_dtype(ScalarType dtype) {
+    output_dtype_ = dtype;
+    return *this;
+  }
+
+  // the outputs are reduction results, see TensorIterator::reduce_op; their
+  // zero strides are not rejected as overlapping
+  TensorIteratorConfig& is_reduction(bool is_reduction) {
+    is_reduction_ = is_reduction;
+    return *this;
+  }
+
+  // Iterate in the order of a C-contiguous tensor, last dim fastest,
+  // instead of the order that walks the operands' memory sequentially, for
+  // kernels whose result depends on the order in which elements are
+  // visited (e.g. the index returned by argmax).
+  TensorIteratorConfig& enforce_linear_iteration(bool enforce = true) {
+    enforce_linear_iteration_ = enforce;
+    return *this;
+  }
+
+  TensorIterator build() {
+    TensorIterator iter;
+    iter.build(*this);
+    return iter;
+  }
+
+ private:
+  friend class TensorIterator;
+
+  std::vector<Tensor> tensors_;
+  int num_outputs_ = 0;
+  int num_inputs_ = 0;
+  bool check_all_same_dtype_ = true;
+  ScalarType output_dtype_ = ScalarType::Undefined;
+  bool is_reduction_ = false;
+  bool enforce_linear_iteration_ = false;
+};
+
+template <typename loop1d_t>
+auto TensorIterator::loop_2d_from_1d(const loop1d_t& loop, int ntensors) {
+  return [loop, ntensors](
+             char** base,
+             const int64_t* strides,
+             int64_t size0,
+             int64_t size1) {
+    if (size1 == 1) {
+      loop(base, strides, size0);
+      return;
+    }
+    std::array<char*, 8> inline_data;
+    std::vector<char*> heap_data;
+    char** data = inline_data.data();
+    if (ntensors > static_cast<int>(inline_data.size())) {
+      heap_data.resize(ntensors);
+      data = heap_data.data();
+    }
+    std::copy(base, base + ntensors, data);
+    const int64_t* outer_strides = &strides[ntensors];
+    for (int64_t i = 0; i < size1; ++i) {
+      if (i > 0) {
+        for (int arg = 0; arg < ntensors; ++arg) {
+          data[arg] += outer_strides[arg];
+        }
+      }
+      loop(data, strides, size0);
+    }
+  };
+}
+
+} // namespace at
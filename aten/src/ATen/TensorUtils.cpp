@@ -0,0 +1,77 @@
+#include <ATen/TensorUtils.h>
+
+#include <algorithm>
+
+namespace at::detail {
+
+std::optional<std::vector<int64_t>> computeStride(
+    c10::IntArrayRef oldshape,
+    c10::IntArrayRef oldstride,
+    c10::IntArrayRef newshape) {
+  if (oldshape.empty()) {
+    return std::vector<int64_t>(newshape.size(), 1);
+  }
+
+  int64_t numel = 1;
+  for (int64_t size : oldshape) {
+    numel *= size;
+  }
+  if (numel == 0 and oldshape == newshape) {
+    return std::vector<int64_t>(oldstride.begin(), oldstride.end());
+  }
+
+  std::vector<int64_t> newstride(newshape.size());
+  // the strides of an empty tensor are arbitrary, give the view contiguous
+  // ones
+  if (numel == 0) {
+    for (int64_t view_d = static_cast<int64_t>(newshape.size()) - 1;
+         view_d >= 0;
+         --view_d) {
+      if (view_d == static_cast<int64_t>(newshape.size()) - 1) {
+        newstride[view_d] = 1;
+      } else {
+        newstride[view_d] = std::max<int64_t>(newshape[view_d + 1], 1) *
+            newstride[view_d + 1];
+      }
+    }
+    return newstride;
+  }
+
+  // Walk the old dims from the innermost out, grouping them into chunks that
+  // are contiguous among themselves; each chunk can be re-split into any run
+  // of new dims with the same number of elements.
+  int64_t view_d = static_cast<int64_t>(newshape.size()) - 1;
+  int64_t chunk_base_stride = oldstride.back();
+  int64_t tensor_numel = 1;
+  int64_t view_numel = 1;
+  for (int64_t tensor_d = static_cast<int64_t>(oldshape.size()) - 1;
+       tensor_d >= 0;
+       --tensor_d) {
+    tensor_numel *= oldshape[tensor_d];
+    // if end of tensor size chunk, check view
+    if (tensor_d == 0 or
+        (oldshape[tensor_d - 1] != 1 and
+         oldstride[tensor_d - 1] != tensor_numel * chunk_base_stride)) {
+      while (view_d >= 0 and
+             (view_numel < tensor_numel or newshape[view_d] == 1)) {
+        newstride[view_d] = view_numel * chunk_base_stride;
+        view_numel *= newshape[view_d];
+        --view_d;
+      }
+      if (view_numel != tensor_numel) {
+        return std::nullopt;
+      }
+      if (tensor_d > 0) {
+        chunk_base_stride = oldstride[tensor_d - 1];
+        tensor_numel = 1;
+        view_numel = 1;
+      }
+    }
+  }
+  if (view_d != -1) {
+    return std::nullopt;
+  }
+  return newstride;
+}
+
+} // namespace at::detail
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <c10/util/ArrayRef.h>
+#include <c10/util/Macros.h>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace at::detail {
+
+// Strides that let a tensor of `oldshape`/`oldstride` be viewed as
+// `newshape` without copying, or nullopt if no such strides exist (the
+// elements of a merged dim would not be evenly spaced in memory).
+TORCH_API std::optional<std::vector<int64_t>> computeStride(
+    c10::IntArrayRef oldshape,
+    c10::IntArrayRef oldstride,
+    c10::IntArrayRef newshape);
+
+} // namespace at::detail
@@ -2,17 +2,217 @@
 
 #include <c10/core/Device.h>
 #include <c10/core/DeviceType.h>
+#include <c10/core/Layout.h>
+#include <c10/core/MemoryFormat.h>
+#include <c10/core/ScalarType.h>
+#include <c10/core/Storage.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/core/UndefinedTensorImpl.h>
+#include <c10/util/ArrayRef.h>
 #include <c10/util/Exception.h>
 #include <c10/util/IntrusivePtr.h>
 #include <c10/util/MaybeOwned.h>
-#include <c10/util/TensorImpl.h>
-#include <c10/util/UndefinedTensorImpl.h>
+#include <c10/util/typeid.h>
+
+#include <utility>
 
 namespace at {
 
+using c10::Device;
+using c10::DeviceType;
+using c10::IntArrayRef;
+using c10::kCPU;
+using c10::kSparse;
+using c10::kSparseCsc;
+using c10::kSparseCsr;
+using c10::kStrided;
+using c10::Layout;
+using c10::MemoryFormat;
+using c10::ScalarType;
+using c10::Storage;
+using c10::TensorImpl;
+
+// Reference-counted handle to a TensorImpl. Copying a TensorBase shares the
+// impl; views share the storage but own their TensorImpl.
 class TORCH_API TensorBase {
+ public:
+  TensorBase() = default;
+
+  explicit TensorBase(c10::intrusive_ptr<TensorImpl> tensor_impl)
+      : impl_(std::move(tensor_impl)) {}
+
+  TensorBase(const TensorBase&) = default;
+  TensorBase(TensorBase&&) noexcept = default;
+  TensorBase& operator=(const TensorBase&) = default;
+  TensorBase& operator=(TensorBase&&) noexcept = default;
+
+  bool defined() const {
+    return static_cast<bool>(impl_);
+  }
+
+  void reset() {
+    impl_.reset();
+  }
+
+  TensorImpl* unsafeGetTensorImpl() const {
+    return impl_.get();
+  }
+
+  const c10::intrusive_ptr<TensorImpl>& getIntrusivePtr() const {
+    return impl_;
+  }
+
+  size_t use_count() const noexcept {
+    return impl_.ref_use_count();
+  }
+
+  bool is_same(const TensorBase& other) const noexcept {
+    return impl_ == other.impl_;
+  }
+
+  int64_t dim() const {
+    return impl_->dim();
+  }
+
+  int64_t ndimension() const {
+    return dim();
+  }
+
+  IntArrayRef sizes() const {
+    return impl_->sizes();
+  }
+
+  IntArrayRef strides() const {
+    return impl_->strides();
+  }
+
+  int64_t size(int64_t dim) const {
+    return impl_->size(dim);
+  }
+
+  int64_t stride(int64_t dim) const {
+    return impl_->stride(dim);
+  }
+
+  int64_t numel() const {
+    return impl_->numel();
+  }
+
+  int64_t storage_offset() const {
+    return impl_->storage_offset();
+  }
+
+  bool is_contiguous(MemoryFormat memory_format = MemoryFormat::Contiguous)
+      const {
+    return impl_->is_contiguous(memory_format);
+  }
+
+  bool is_non_overlapping_and_dense() const {
+    return impl_->is_non_overlapping_and_dense();
+  }
+
+  const TypeMeta dtype() const {
+    return impl_->dtype();
+  }
+
+  ScalarType scalar_type() const {
+    return impl_->dtype().toScalarType();
+  }
+
+  size_t itemsize() const {
+    return impl_->itemsize();
+  }
+
+  Layout layout() const {
+    return impl_->layout();
+  }
+
+  // whether the tensor is COO, and so has a SparseTensorImpl
+  bool is_sparse() const {
+    return layout() == kSparse;
+  }
+
+  // whether the tensor is CSR or CSC, and so has a SparseCsrTensorImpl
+  bool is_sparse_csr() const {
+    return layout() == kSparseCsr or layout() == kSparseCsc;
+  }
+
+  // whether the tensor has a quantized dtype, and so a QTensorImpl
+  bool is_quantized() const {
+    return c10::isQIntType(scalar_type());
+  }
+
+  int64_t element_size() const {
+    return static_cast<int64_t>(impl_->itemsize());
+  }
+
+  // the bytes the elements take, half a byte each for the 4-bit types
+  size_t nbytes() const {
+    return c10::storageNbytes(scalar_type(), impl_->numel());
+  }
+
+  Device device() const {
+    return impl_->device();
+  }
+
+  bool is_cpu() const {
+    return impl_->device().is_cpu();
+  }
+
+  bool has_storage() const {
+    return defined() and impl_->has_storage();
+  }
+
+  const Storage& storage() const {
+    return impl_->storage();
+  }
+
+  // whether the two tensors share memory, e.g. one is a view of the other
+  bool is_alias_of(const TensorBase& other) const {
+    return impl_->storage().is_alias_of(other.storage());
+  }
+
+  const void* const_data_ptr() const {
+    return impl_->data();
+  }
+
+  void* mutable_data_ptr() const {
+    return impl_->mutable_data();
+  }
+
+  void* data_ptr() const {
+    return mutable_data_ptr();
+  }
+
+  template <typename T>
+  const T* const_data_ptr() const {
+    check_data_type<T>();
+    return static_cast<const T*>(impl_->data());
+  }
+
+  template <typename T>
+  T* mutable_data_ptr() const {
+    check_data_type<T>();
+    return static_cast<T*>(impl_->mutable_data());
+  }
+
+  template <typename T>
+  T* data_ptr() const {
+    return mutable_data_ptr<T>();
+  }
+
  protected:
-  c10::intrusive_ptr<c10::TensorImpl> impl_;
+  template <typename T>
+  void check_data_type() const {
+    TORCH_CHECK(
+        scalar_type() == c10::CPPTypeToScalarType<T>::value,
+        "expected scalar type ",
+        c10::CPPTypeToScalarType<T>::value,
+        " but found ",
+        scalar_type());
+  }
+
+  c10::intrusive_ptr<TensorImpl> impl_;
 };
 
 } // namespace at
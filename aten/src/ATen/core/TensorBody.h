@@ -1,3 +1,121 @@
 #pragma once
 
 #include <ATen/core/TensorBase.h>
+#include <c10/core/QScheme.h>
+
+#include <cstdint>
+#include <optional>
+
+namespace at {
+
+using c10::kPerChannelAffine;
+using c10::kPerTensorAffine;
+using c10::QScheme;
+
+struct Quantizer;
+using QuantizerPtr = c10::intrusive_ptr<Quantizer>;
+
+class TORCH_API Tensor : public TensorBase {
+ public:
+  Tensor() = default;
+
+  explicit Tensor(c10::intrusive_ptr<TensorImpl> tensor_impl)
+      : TensorBase(std::move(tensor_impl)) {}
+
+  explicit Tensor(const TensorBase& base) : TensorBase(base) {}
+
+  Tensor(const Tensor&) = default;
+  Tensor(Tensor&&) noexcept = default;
+  Tensor& operator=(const Tensor&) = default;
+  Tensor& operator=(Tensor&&) noexcept = default;
+
+  // set every element to `value`, converted to the tensor's dtype
+  const Tensor& fill_(double value) const;
+
+  // Conversions between any two dtypes, vectorized for contiguous data;
+  // Half and BFloat16 go through float and nonzero values become true in
+  // Bool. copy_ broadcasts src to this tensor's sizes. to() returns this
+  // tensor if it already has dtype, unless copy is set, else a new tensor
+  // laid out like this one.
+  const Tensor& copy_(const Tensor& src) const;
+  Tensor to(ScalarType dtype, bool copy = false) const;
+  // this tensor if it is contiguous in memory_format, else a copy that is;
+  // transposed and permuted layouts are copied a tile at a time
+  Tensor contiguous(
+      MemoryFormat memory_format = MemoryFormat::Contiguous) const;
+
+  // matrix product of this m x k matrix and the k x n mat2; strided
+  // (e.g. transposed) operands are read in place
+  Tensor mm(const Tensor& mat2) const;
+
+  // Reductions over `dim`, all dims if empty; keepdim keeps the reduced
+  // dims as size 1. The results do not depend on the number of threads.
+  Tensor sum(IntArrayRef dim = {}, bool keepdim = false) const;
+  Tensor mean(IntArrayRef dim = {}, bool keepdim = false) const;
+  Tensor amax(IntArrayRef dim = {}, bool keepdim = false) const;
+  Tensor amin(IntArrayRef dim = {}, bool keepdim = false) const;
+  Tensor max() const;
+  Tensor min() const;
+  Tensor argmax(
+      std::optional<int64_t> dim = std::nullopt,
+      bool keepdim = false) const;
+  Tensor argmin(
+      std::optional<int64_t> dim = std::nullopt,
+      bool keepdim = false) const;
+  Tensor norm(double p = 2, IntArrayRef dim = {}, bool keepdim = false) const;
+
+  // The quantization parameters of a quantized tensor, see
+  // ATen/quantized/Quantizer.h: q_scale() and q_zero_point() per tensor,
+  // the q_per_channel_*() per channel.
+  QuantizerPtr quantizer() const;
+  QScheme qscheme() const;
+  double q_scale() const;
+  int64_t q_zero_point() const;
+  Tensor q_per_channel_scales() const;
+  Tensor q_per_channel_zero_points() const;
+  int64_t q_per_channel_axis() const;
+  // the stored integers of a quantized tensor as a new (Char, Byte or Int)
+  // tensor, and its real values as a new Float tensor
+  Tensor int_repr() const;
+  Tensor dequantize() const;
+
+  // Sparse layouts, see at::sparse_coo_tensor() and the functions after it.
+  Tensor to_dense() const;
+  Tensor to_sparse() const;
+  Tensor to_sparse_csr() const;
+  Tensor to_sparse_csc() const;
+  Tensor coalesce() const;
+  bool is_coalesced() const;
+  int64_t _nnz() const;
+  Tensor indices() const;
+  Tensor values() const;
+  Tensor crow_indices() const;
+  Tensor col_indices() const;
+  Tensor ccol_indices() const;
+  Tensor row_indices() const;
+
+  // exp(x) / sum(exp(x)) along dim
+  Tensor softmax(int64_t dim) const;
+  const Tensor& softmax_(int64_t dim) const;
+
+  // Views: the result shares this tensor's storage, nothing is copied.
+  Tensor as_strided(
+      IntArrayRef size,
+      IntArrayRef stride,
+      std::optional<int64_t> storage_offset = std::nullopt) const;
+  Tensor slice(
+      int64_t dim = 0,
+      std::optional<int64_t> start = std::nullopt,
+      std::optional<int64_t> end = std::nullopt,
+      int64_t step = 1) const;
+  Tensor select(int64_t dim, int64_t index) const;
+  Tensor transpose(int64_t dim0, int64_t dim1) const;
+  Tensor t() const;
+  Tensor permute(IntArrayRef dims) const;
+  Tensor expand(IntArrayRef size) const;
+  Tensor expand_as(const Tensor& other) const;
+  Tensor view(IntArrayRef size) const;
+  Tensor unsqueeze(int64_t dim) const;
+};
+
+} // namespace at
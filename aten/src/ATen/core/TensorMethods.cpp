@@ -0,0 +1,206 @@
+#include <ATen/Functions.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/quantized/QTensorImpl.h>
+
+namespace at {
+
+const Tensor& Tensor::fill_(double value) const {
+  return at::fill_(*this, value);
+}
+
+const Tensor& Tensor::copy_(const Tensor& src) const {
+  return at::copy_(*this, src);
+}
+
+Tensor Tensor::to(ScalarType dtype, bool copy) const {
+  return at::to(*this, dtype, copy);
+}
+
+Tensor Tensor::contiguous(MemoryFormat memory_format) const {
+  return at::contiguous(*this, memory_format);
+}
+
+Tensor Tensor::mm(const Tensor& mat2) const {
+  return at::mm(*this, mat2);
+}
+
+Tensor Tensor::sum(IntArrayRef dim, bool keepdim) const {
+  return at::sum(*this, dim, keepdim);
+}
+
+Tensor Tensor::mean(IntArrayRef dim, bool keepdim) const {
+  return at::mean(*this, dim, keepdim);
+}
+
+Tensor Tensor::amax(IntArrayRef dim, bool keepdim) const {
+  return at::amax(*this, dim, keepdim);
+}
+
+Tensor Tensor::amin(IntArrayRef dim, bool keepdim) const {
+  return at::amin(*this, dim, keepdim);
+}
+
+Tensor Tensor::max() const {
+  return at::max(*this);
+}
+
+Tensor Tensor::min() const {
+  return at::min(*this);
+}
+
+Tensor Tensor::argmax(std::optional<int64_t> dim, bool keepdim) const {
+  return at::argmax(*this, dim, keepdim);
+}
+
+Tensor Tensor::argmin(std::optional<int64_t> dim, bool keepdim) const {
+  return at::argmin(*this, dim, keepdim);
+}
+
+Tensor Tensor::norm(double p, IntArrayRef dim, bool keepdim) const {
+  return at::norm(*this, p, dim, keepdim);
+}
+
+QuantizerPtr Tensor::quantizer() const {
+  return get_qtensorimpl(*this)->quantizer();
+}
+
+QScheme Tensor::qscheme() const {
+  return at::qscheme(*this);
+}
+
+double Tensor::q_scale() const {
+  return at::q_scale(*this);
+}
+
+int64_t Tensor::q_zero_point() const {
+  return at::q_zero_point(*this);
+}
+
+Tensor Tensor::q_per_channel_scales() const {
+  return at::q_per_channel_scales(*this);
+}
+
+Tensor Tensor::q_per_channel_zero_points() const {
+  return at::q_per_channel_zero_points(*this);
+}
+
+int64_t Tensor::q_per_channel_axis() const {
+  return at::q_per_channel_axis(*this);
+}
+
+Tensor Tensor::int_repr() const {
+  return at::int_repr(*this);
+}
+
+Tensor Tensor::dequantize() const {
+  return at::dequantize(*this);
+}
+
+Tensor Tensor::to_dense() const {
+  return at::to_dense(*this);
+}
+
+Tensor Tensor::to_sparse() const {
+  return at::to_sparse(*this);
+}
+
+Tensor Tensor::to_sparse_csr() const {
+  return at::to_sparse_csr(*this);
+}
+
+Tensor Tensor::to_sparse_csc() const {
+  return at::to_sparse_csc(*this);
+}
+
+Tensor Tensor::coalesce() const {
+  return at::coalesce(*this);
+}
+
+bool Tensor::is_coalesced() const {
+  return at::is_coalesced(*this);
+}
+
+int64_t Tensor::_nnz() const {
+  return at::_nnz(*this);
+}
+
+Tensor Tensor::indices() const {
+  return at::indices(*this);
+}
+
+Tensor Tensor::values() const {
+  return at::values(*this);
+}
+
+Tensor Tensor::crow_indices() const {
+  return at::crow_indices(*this);
+}
+
+Tensor Tensor::col_indices() const {
+  return at::col_indices(*this);
+}
+
+Tensor Tensor::ccol_indices() const {
+  return at::ccol_indices(*this);
+}
+
+Tensor Tensor::row_indices() const {
+  return at::row_indices(*this);
+}
+
+Tensor Tensor::softmax(int64_t dim) const {
+  return at::softmax(*this, dim);
+}
+
+const Tensor& Tensor::softmax_(int64_t dim) const {
+  return at::softmax_(*this, dim);
+}
+
+Tensor Tensor::as_strided(
+    IntArrayRef size,
+    IntArrayRef stride,
+    std::optional<int64_t> storage_offset) const {
+  return at::as_strided(*this, size, stride, storage_offset);
+}
+
+Tensor Tensor::slice(
+    int64_t dim,
+    std::optional<int64_t> start,
+    std::optional<int64_t> end,
+    int64_t step) const {
+  return at::slice(*this, dim, start, end, step);
+}
+
+Tensor Tensor::select(int64_t dim, int64_t index) const {
+  return at::select(*this, dim, index);
+}
+
+Tensor Tensor::transpose(int64_t dim0, int64_t dim1) const {
+  return at::transpose(*this, dim0, dim1);
+}
+
+Tensor Tensor::t() const {
+  return at::t(*this);
+}
+
+Tensor Tensor::permute(IntArrayRef dims) const {
+  return at::permute(*this, dims);
+}
+
+Tensor Tensor::expand(IntArrayRef size) const {
+  return at::expand(*this, size);
+}
+
+Tensor Tensor::expand_as(const Tensor& other) const {
+  return at::expand(*this, other.sizes());
+}
+
+Tensor Tensor::view(IntArrayRef size) const {
+  return at::view(*this, size);
+}
+
+Tensor Tensor::unsqueeze(int64_t dim) const {
+  return at::unsqueeze(*this, dim);
+}
+
+} // namespace at
@@ -0,0 +1,298 @@
+#pragma once
+
+// Loop helpers over contiguous buffers built on Vectorized<T>. Each handles
+// the tail that does not fill a whole vector with a partial load/store, so
+// callers never need a scalar epilogue. Half buffers are computed in
+// float, see the overloads at the end.
+
+#include <ATen/cpu/vec/vec.h>
+
+#include <tuple>
+
+namespace at::vec {
+inline namespace CPU_CAPABILITY {
+
+// Reduces the first `size` lanes of acc_vec to a scalar with vec_fun. The
+// lanes are combined pairwise (lane i with lane i + w for halving w), so the
+// association order is fixed and the result deterministic.
+template <typename scalar_t, typename Op>
+inline scalar_t vec_reduce_all(
+    const Op& vec_fun,
+    Vectorized<scalar_t> acc_vec,
+    int64_t size = Vectorized<scalar_t>::size()) {
+  using Vec = Vectorized<scalar_t>;
+  __at_align__ scalar_t acc_arr[Vec::size()];
+  acc_vec.store(acc_arr);
+  while (size > 1) {
+    int64_t half = size / 2;
+    int64_t upper = size - half;
+    // fold lanes [upper, size) onto [0, half); for odd sizes the middle
+    // lane is carried over unchanged
+    Vec lo = Vec::loadu(acc_arr, half);
+    Vec hi = Vec::loadu(acc_arr + upper, half);
+    vec_fun(lo, hi).store(acc_arr, half);
+    size = upper;
+  }
+  return acc_arr[0];
+}
+
+// Reduces data[0, size) to a scalar: full vectors are accumulated
+// lane-wise, the tail is combined into the lanes it occupies, then the lanes
+// are reduced with vec_reduce_all.
+template <typename scalar_t, typename Op>
+inline scalar_t reduce_all(
+    const Op& vec_fun,
+    const scalar_t* data,
+    int64_t size) {
+  using Vec = Vectorized<scalar_t>;
+  if (size < Vec::size()) {
+    return vec_reduce_all(vec_fun, Vec::loadu(data, size), size);
+  }
+  int64_t d = Vec::size();
+  Vec acc_vec = Vec::loadu(data);
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    Vec data_vec = Vec::loadu(data + d);
+    acc_vec = vec_fun(acc_vec, data_vec);
+  }
+  if (size - d > 0) {
+    Vec data_vec = Vec::loadu(data + d, size - d);
+    acc_vec = Vec::set(acc_vec, vec_fun(acc_vec, data_vec), size - d);
+  }
+  return vec_reduce_all(vec_fun, acc_vec);
+}
+
+// Reduces map_fun(data[i]) over [0, size) with red_fun, in the order of
+// reduce_all, without materializing the mapped values.
+template <typename scalar_t, typename MapOp, typename ReduceOp>
+inline scalar_t map_reduce_all(
+    const MapOp& map_fun,
+    const ReduceOp& red_fun,
+    const scalar_t* data,
+    int64_t size) {
+  using Vec = Vectorized<scalar_t>;
+  if (size < Vec::size()) {
+    return vec_reduce_all(red_fun, map_fun(Vec::loadu(data, size)), size);
+  }
+  int64_t d = Vec::size();
+  Vec acc_vec = map_fun(Vec::loadu(data));
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    Vec data_vec = map_fun(Vec::loadu(data + d));
+    acc_vec = red_fun(acc_vec, data_vec);
+  }
+  if (size - d > 0) {
+    Vec data_vec = map_fun(Vec::loadu(data + d, size - d));
+    acc_vec = Vec::set(acc_vec, red_fun(acc_vec, data_vec), size - d);
+  }
+  return vec_reduce_all(red_fun, acc_vec);
+}
+
+// output[i] = vec_fun(input[i])
+template <typename scalar_t, typename Op>
+inline void map(
+    const Op& vec_fun,
+    scalar_t* output_data,
+    const scalar_t* input_data,
+    int64_t size) {
+  using Vec = Vectorized<scalar_t>;
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    Vec output_vec = vec_fun(Vec::loadu(input_data + d));
+    output_vec.store(output_data + d);
+  }
+  if (size - d > 0) {
+    Vec output_vec = vec_fun(Vec::loadu(input_data + d, size - d));
+    output_vec.store(output_data + d, size - d);
+  }
+}
+
+// output[i] = vec_fun(input[i], input2[i])
+template <typename scalar_t, typename Op>
+inline void map2(
+    const Op& vec_fun,
+    scalar_t* output_data,
+    const scalar_t* input_data,
+    const scalar_t* input_data2,
+    int64_t size) {
+  using Vec = Vectorized<scalar_t>;
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    Vec data_vec = Vec::loadu(input_data + d);
+    Vec data_vec2 = Vec::loadu(input_data2 + d);
+    Vec output_vec = vec_fun(data_vec, data_vec2);
+    output_vec.store(output_data + d);
+  }
+  if (size - d > 0) {
+    Vec data_vec = Vec::loadu(input_data + d, size - d);
+    Vec data_vec2 = Vec::loadu(input_data2 + d, size - d);
+    Vec output_vec = vec_fun(data_vec, data_vec2);
+    output_vec.store(output_data + d, size - d);
+  }
+}
+
+// output[i] = vec_fun(input[i], input2[i], input3[i])
+template <typename scalar_t, typename Op>
+inline void map3(
+    const Op& vec_fun,
+    scalar_t* output_data,
+    const scalar_t* input_data1,
+    const scalar_t* input_data2,
+    const scalar_t* input_data3,
+    int64_t size) {
+  using Vec = Vectorized<scalar_t>;
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    Vec data_vec1 = Vec::loadu(input_data1 + d);
+    Vec data_vec2 = Vec::loadu(input_data2 + d);
+    Vec data_vec3 = Vec::loadu(input_data3 + d);
+    Vec output_vec = vec_fun(data_vec1, data_vec2, data_vec3);
+    output_vec.store(output_data + d);
+  }
+  if (size - d > 0) {
+    Vec data_vec1 = Vec::loadu(input_data1 + d, size - d);
+    Vec data_vec2 = Vec::loadu(input_data2 + d, size - d);
+    Vec data_vec3 = Vec::loadu(input_data3 + d, size - d);
+    Vec output_vec = vec_fun(data_vec1, data_vec2, data_vec3);
+    output_vec.store(output_data + d, size - d);
+  }
+}
+
+// Half buffers. The overloads below take a vec_fun over Vectorized<float>
+// rather than Vectorized<Half>: each vector of halves is widened to float
+// once, the whole of vec_fun is computed in float and only its result is
+// narrowed, on store. Chained Vectorized<Half> arithmetic, like c10::Half's
+// scalar operators, rounds to half after every operation; here an
+// expression rounds once, and intermediates may leave the range of half.
+// The conversions are F16C instructions on AVX2 and AVX-512 builds.
+
+// the first `count` of Vectorized<float>::size() halves at data, widened to
+// float, and zeros
+inline Vectorized<float> load_fp32_from_fp16(
+    const c10::Half* data,
+    int64_t count) {
+  return std::get<0>(
+      convert_half_float(Vectorized<c10::Half>::loadu(data, count)));
+}
+
+// Reduces data[0, size) in float, in the order of reduce_all over the
+// widened values. The result is not narrowed back to half.
+template <typename Op>
+inline float reduce_all(
+    const Op& vec_fun,
+    const c10::Half* data,
+    int64_t size) {
+  using Vec = Vectorized<float>;
+  if (size < Vec::size()) {
+    return vec_reduce_all(vec_fun, load_fp32_from_fp16(data, size), size);
+  }
+  int64_t d = Vec::size();
+  Vec acc_vec = load_fp32_from_fp16(data);
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    acc_vec = vec_fun(acc_vec, load_fp32_from_fp16(data + d));
+  }
+  if (size - d > 0) {
+    Vec data_vec = load_fp32_from_fp16(data + d, size - d);
+    acc_vec = Vec::set(acc_vec, vec_fun(acc_vec, data_vec), size - d);
+  }
+  return vec_reduce_all(vec_fun, acc_vec);
+}
+
+// Reduces map_fun(data[i]) over [0, size) with red_fun, both in float, in
+// the order of reduce_all. The result is not narrowed back to half.
+template <typename MapOp, typename ReduceOp>
+inline float map_reduce_all(
+    const MapOp& map_fun,
+    const ReduceOp& red_fun,
+    const c10::Half* data,
+    int64_t size) {
+  using Vec = Vectorized<float>;
+  if (size < Vec::size()) {
+    return vec_reduce_all(
+        red_fun, map_fun(load_fp32_from_fp16(data, size)), size);
+  }
+  int64_t d = Vec::size();
+  Vec acc_vec = map_fun(load_fp32_from_fp16(data));
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    acc_vec = red_fun(acc_vec, map_fun(load_fp32_from_fp16(data + d)));
+  }
+  if (size - d > 0) {
+    Vec data_vec = map_fun(load_fp32_from_fp16(data + d, size - d));
+    acc_vec = Vec::set(acc_vec, red_fun(acc_vec, data_vec), size - d);
+  }
+  return vec_reduce_all(red_fun, acc_vec);
+}
+
+// output[i] = vec_fun(input[i]), rounded to half once
+template <typename Op>
+inline void map(
+    const Op& vec_fun,
+    c10::Half* output_data,
+    const c10::Half* input_data,
+    int64_t size) {
+  using Vec = Vectorized<c10::Half>;
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    auto [lo, hi] = convert_half_float(Vec::loadu(input_data + d));
+    convert_float_half(vec_fun(lo), vec_fun(hi)).store(output_data + d);
+  }
+  if (size - d > 0) {
+    auto [lo, hi] = convert_half_float(Vec::loadu(input_data + d, size - d));
+    convert_float_half(vec_fun(lo), vec_fun(hi))
+        .store(output_data + d, size - d);
+  }
+}
+
+// output[i] = vec_fun(input[i], input2[i]), rounded to half once
+template <typename Op>
+inline void map2(
+    const Op& vec_fun,
+    c10::Half* output_data,
+    const c10::Half* input_data,
+    const c10::Half* input_data2,
+    int64_t size) {
+  using Vec = Vectorized<c10::Half>;
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    auto [lo, hi] = convert_half_float(Vec::loadu(input_data + d));
+    auto [lo2, hi2] = convert_half_float(Vec::loadu(input_data2 + d));
+    convert_float_half(vec_fun(lo, lo2), vec_fun(hi, hi2))
+        .store(output_data + d);
+  }
+  if (size - d > 0) {
+    auto [lo, hi] = convert_half_float(Vec::loadu(input_data + d, size - d));
+    auto [lo2, hi2] =
+        convert_half_float(Vec::loadu(input_data2 + d, size - d));
+    convert_float_half(vec_fun(lo, lo2), vec_fun(hi, hi2))
+        .store(output_data + d, size - d);
+  }
+}
+
+// output[i] = vec_fun(input[i], input2[i], input3[i]), rounded to half once
+template <typename Op>
+inline void map3(
+    const Op& vec_fun,
+    c10::Half* output_data,
+    const c10::Half* input_data1,
+    const c10::Half* input_data2,
+    const c10::Half* input_data3,
+    int64_t size) {
+  using Vec = Vectorized<c10::Half>;
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    auto [lo1, hi1] = convert_half_float(Vec::loadu(input_data1 + d));
+    auto [lo2, hi2] = convert_half_float(Vec::loadu(input_data2 + d));
+    auto [lo3, hi3] = convert_half_float(Vec::loadu(input_data3 + d));
+    convert_float_half(vec_fun(lo1, lo2, lo3), vec_fun(hi1, hi2, hi3))
+        .store(output_data + d);
+  }
+  if (size - d > 0) {
+    const int64_t count = size - d;
+    auto [lo1, hi1] = convert_half_float(Vec::loadu(input_data1 + d, count));
+    auto [lo2, hi2] = convert_half_float(Vec::loadu(input_data2 + d, count));
+    auto [lo3, hi3] = convert_half_float(Vec::loadu(input_data3 + d, count));
+    convert_float_half(vec_fun(lo1, lo2, lo3), vec_fun(hi1, hi2, hi3))
+        .store(output_data + d, count);
+  }
+}
+
+} // namespace CPU_CAPABILITY
+} // namespace at::vec
@@ -0,0 +1,12 @@
+#pragma once
+
+// Entry point for kernels: Vectorized<T> for the capability the including
+// file is compiled for (see vec_base.h).
+
+#if defined(CPU_CAPABILITY_AVX512)
+#include <ATen/cpu/vec/vec512/vec512.h>
+#elif defined(CPU_CAPABILITY_AVX2)
+#include <ATen/cpu/vec/vec256/vec256.h>
+#else
+#include <ATen/cpu/vec/vec_base.h>
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+// AVX2 (with FMA and F16C) specializations of Vectorized<T>, used when the
+// including file is built with CPU_CAPABILITY_AVX2. Types without a
+// specialization here keep the generic implementation.
+
+#include <ATen/cpu/vec/intrinsics.h>
+#include <ATen/cpu/vec/vec_base.h>
+
+#include <ATen/cpu/vec/vec256/vec256_bfloat16.h>
+#include <ATen/cpu/vec/vec256/vec256_double.h>
+#include <ATen/cpu/vec/vec256/vec256_float.h>
+#include <ATen/cpu/vec/vec256/vec256_float8.h>
+#include <ATen/cpu/vec/vec256/vec256_half.h>
+#include <ATen/cpu/vec/vec256/vec256_int.h>
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <ATen/cpu/vec/intrinsics.h>
+#include <ATen/cpu/vec/vec256/vec256_float.h>
+#include <ATen/cpu/vec/vec_base.h>
+#include <c10/util/BFloat16.h>
+
+namespace at::vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX2)
+
+// BFloat16 is computed in float, so only its conversions are vectorized:
+// widening is a shift into the upper half of each float, narrowing rounds
+// to nearest even with integer arithmetic, like c10::BFloat16's scalar
+// conversion.
+
+inline __m256 cvt_bf16_to_float(__m128i a) {
+  return _mm256_castsi256_ps(
+      _mm256_slli_epi32(_mm256_cvtepu16_epi32(a), 16));
+}
+
+inline __m128i cvt_float_to_bf16(__m256 a) {
+  const __m256i bits = _mm256_castps_si256(a);
+  const __m256i lsb =
+      _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+  __m256i rounded = _mm256_srli_epi32(
+      _mm256_add_epi32(
+          bits, _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7FFF))),
+      16);
+  const __m256 nan = _mm256_cmp_ps(a, a, _CMP_UNORD_Q);
+  rounded = _mm256_blendv_epi8(
+      rounded, _mm256_set1_epi32(0x7FC0), _mm256_castps_si256(nan));
+  // every lane fits in 16 bits, so the saturating pack is exact; it works
+  // within 128-bit lanes, restore the element order
+  const __m256i packed = _mm256_permute4x64_epi64(
+      _mm256_packus_epi32(rounded, rounded), 0xd8);
+  return _mm256_castsi256_si128(packed);
+}
+
+inline Vectorized<float> load_fp32_from_bf16(const c10::BFloat16* data) {
+  return cvt_bf16_to_float(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+}
+
+template <>
+inline void convert(const c10::BFloat16* src, float* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i <= n - Vectorized<float>::size(); i += Vectorized<float>::size()) {
+    _mm256_storeu_ps(dst + i, load_fp32_from_bf16(src + i));
+  }
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const float* src, c10::BFloat16* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i <= n - Vectorized<float>::size(); i += Vectorized<float>::size()) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + i),
+        cvt_float_to_bf16(_mm256_loadu_ps(src + i)));
+  }
+  for (; i < n; i++) {
+    dst[i] = c10::BFloat16(src[i]);
+  }
+}
+
+#endif // defined(CPU_CAPABILITY_AVX2)
+
+} // namespace CPU_CAPABILITY
+} // namespace at::vec
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <ATen/cpu/vec/intrinsics.h>
+#include <ATen/cpu/vec/vec256/vec256_float.h>
+#include <ATen/cpu/vec/vec_base.h>
+#include <c10/util/Float8_e4m3fn.h>
+#include <c10/util/Float8_e5m2.h>
+
+namespace at::vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX2)
+
+// Float8 conversions, eight values at a time, with the integer arithmetic of
+// c10::detail::fp8e4m3fn_{to,from}_fp32_value() and their e5m2 versions:
+// both branches of the scalar code are computed and blended.
+
+// the layout of a Float8 format, see c10/util/Float8_*.h
+template <typename T>
+struct Float8Format;
+
+template <>
+struct Float8Format<c10::Float8_e4m3fn> {
+  static constexpr int kMantissaBits = 3;
+  static constexpr int kBias = 7;
+  // the largest finite value and the smallest normal one, as floats
+  static constexpr uint32_t kMaxBits = 0x43E00000;
+  static constexpr uint32_t kMinNormalBits = 121u << 23;
+  static constexpr uint32_t kDenormMask = 141u << 23;
+  static constexpr uint32_t kMaxFinite = 0x7E;
+  static constexpr bool kHasInfinity = false;
+};
+
+template <>
+struct Float8Format<c10::Float8_e5m2> {
+  static constexpr int kMantissaBits = 2;
+  static constexpr int kBias = 15;
+  static constexpr uint32_t kMaxBits = 0x47600000;
+  static constexpr uint32_t kMinNormalBits = 113u << 23;
+  static constexpr uint32_t kDenormMask = 134u << 23;
+  static constexpr uint32_t kMaxFinite = 0x7B;
+  static constexpr bool kHasInfinity = true;
+};
+
+template <typename T>
+inline __m256 cvt_fp8_to_float(__m128i a) {
+  using F = Float8Format<T>;
+  constexpr int kShift = 23 - F::kMantissaBits;
+  const __m256i bits = _mm256_cvtepu8_epi32(a);
+  const __m256i nonsign = _mm256_and_si256(bits, _mm256_set1_epi32(0x7F));
+  const __m256i sign =
+      _mm256_slli_epi32(_mm256_and_si256(bits, _mm256_set1_epi32(0x80)), 24);
+  const __m256 magnitude = _mm256_mul_ps(
+      _mm256_castsi256_ps(_mm256_slli_epi32(nonsign, kShift)),
+      _mm256_castsi256_ps(_mm256_set1_epi32((254 - F::kBias) << 23)));
+  __m256i result = _mm256_castps_si256(magnitude);
+  if constexpr (F::kHasInfinity) {
+    // all-ones exponent: infinity, or NaN with its payload
+    const __m256i special =
+        _mm256_cmpgt_epi32(nonsign, _mm256_set1_epi32(0x7B));
+    const __m256i inf_nan = _mm256_or_si256(
+        _mm256_set1_epi32(0x7F800000),
+        _mm256_slli_epi32(
+            _mm256_and_si256(nonsign, _mm256_set1_epi32(3)), kShift));
+    result = _mm256_blendv_epi8(result, inf_nan, special);
+  } else {
+    const __m256i nan = _mm256_cmpeq_epi32(nonsign, _mm256_set1_epi32(0x7F));
+    result =
+        _mm256_blendv_epi8(result, _mm256_set1_epi32(0x7FC00000), nan);
+  }
+  return _mm256_castsi256_ps(_mm256_or_si256(result, sign));
+}
+
+template <typename T>
+inline __m128i cvt_float_to_fp8(__m256 a) {
+  using F = Float8Format<T>;
+  constexpr int kShift = 23 - F::kMantissaBits;
+  const __m256i bits = _mm256_castps_si256(a);
+  const __m256i sign =
+      _mm256_and_si256(bits, _mm256_set1_epi32(int32_t(0x80000000)));
+  const __m256i abs = _mm256_xor_si256(bits, sign);
+  // below the smallest normal: rounded by a float addition
+  const __m256i denorm_mask = _mm256_set1_epi32(F::kDenormMask);
+  const __m256i denormal = _mm256_sub_epi32(
+      _mm256_castps_si256(_mm256_add_ps(
+          _mm256_castsi256_ps(abs), _mm256_castsi256_ps(denorm_mask))),
+      denorm_mask);
+  // normal: rebiased and rounded to nearest even in integer arithmetic
+  const __m256i mant_odd = _mm256_and_si256(
+      _mm256_srli_epi32(abs, kShift), _mm256_set1_epi32(1));
+  const __m256i normal = _mm256_srli_epi32(
+      _mm256_add_epi32(
+          _mm256_add_epi32(
+              abs,
+              _mm256_set1_epi32(
+                  int32_t(uint32_t(F::kBias - 127) << 23) +
+                  ((1 << (kShift - 1)) - 1))),
+          mant_odd),
+      kShift);
+  __m256i result = _mm256_blendv_epi8(
+      normal,
+      denormal,
+      _mm256_cmpgt_epi32(_mm256_set1_epi32(F::kMinNormalBits), abs));
+  // saturate, keeping infinities if the format has them, and NaNs
+  result = _mm256_blendv_epi8(
+      result,
+      _mm256_set1_epi32(F::kMaxFinite),
+      _mm256_cmpgt_epi32(abs, _mm256_set1_epi32(F::kMaxBits - 1)));
+  if constexpr (F::kHasInfinity) {
+    result = _mm256_blendv_epi8(
+        result,
+        _mm256_set1_epi32(0x7C),
+        _mm256_cmpeq_epi32(abs, _mm256_set1_epi32(0x7F800000)));
+  }
+  result = _mm256_blendv_epi8(
+      result,
+      _mm256_set1_epi32(0x7F),
+      _mm256_cmpgt_epi32(abs, _mm256_set1_epi32(0x7F800000)));
+  result = _mm256_or_si256(result, _mm256_srli_epi32(sign, 24));
+  // the low byte of each lane, in order: the packs work within 128-bit
+  // lanes, leaving elements 0-3 and 4-7 at the bottom of each
+  const __m256i packed = _mm256_packus_epi16(
+      _mm256_packus_epi32(result, result), _mm256_setzero_si256());
+  return _mm_unpacklo_epi32(
+      _mm256_castsi256_si128(packed), _mm256_extracti128_si256(packed, 1));
+}
+
+#define DEFINE_FLOAT8_CONVERT(T)                                            \
+  template <>                                                               \
+  inline void convert(const T* src, float* dst, int64_t n) {                \
+    int64_t i = 0;                                                          \
+    for (; i <= n - Vectorized<float>::size();                              \
+         i += Vectorized<float>::size()) {                                  \
+      _mm256_storeu_ps(                                                     \
+          dst + i,                                                          \
+          cvt_fp8_to_float<T>(                                              \
+              _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)))); \
+    }                                                                       \
+    for (; i < n; i++) {                                                    \
+      dst[i] = static_cast<float>(src[i]);                                  \
+    }                                                                       \
+  }                                                                         \
+                                                                            \
+  template <>                                                               \
+  inline void convert(const float* src, T* dst, int64_t n) {                \
+    int64_t i = 0;                                                          \
+    for (; i <= n - Vectorized<float>::size();                              \
+         i += Vectorized<float>::size()) {                                  \
+      _mm_storel_epi64(                                                     \
+          reinterpret_cast<__m128i*>(dst + i),                              \
+          cvt_float_to_fp8<T>(_mm256_loadu_ps(src + i)));                   \
+    }                                                                       \
+    for (; i < n; i++) {                                                    \
+      dst[i] = T(src[i]);                                                   \
+    }                                                                       \
+  }
+
+DEFINE_FLOAT8_CONVERT(c10::Float8_e4m3fn)
+DEFINE_FLOAT8_CONVERT(c10::Float8_e5m2)
+
+#undef DEFINE_FLOAT8_CONVERT
+
+#endif // defined(CPU_CAPABILITY_AVX2)
+
+} // namespace CPU_CAPABILITY
+} // namespace at::vec
@@ -0,0 +1,377 @@
+#pragma once
+
+#include <ATen/cpu/vec/intrinsics.h>
+#include <ATen/cpu/vec/vec256/vec256_float.h>
+#include <ATen/cpu/vec/vec_base.h>
+
+namespace at::vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX2)
+
+// Vectorized<Half> stores 16 halves in a __m256i. There is no half precision
+// arithmetic in AVX2, so every computation widens both halves of the vector
+// to float with F16C, runs the float kernel and narrows the result again
+// (rounding to nearest even, like c10::Half's scalar conversion).
+
+inline __m256 cvt_half_lo_to_float(__m256i a) {
+  return _mm256_cvtph_ps(_mm256_castsi256_si128(a));
+}
+
+inline __m256 cvt_half_hi_to_float(__m256i a) {
+  return _mm256_cvtph_ps(_mm256_extracti128_si256(a, 1));
+}
+
+inline __m256i cvt_float_to_half(__m256 lo, __m256 hi) {
+  __m128i lo_h = _mm256_cvtps_ph(lo, _MM_FROUND_TO_NEAREST_INT);
+  __m128i hi_h = _mm256_cvtps_ph(hi, _MM_FROUND_TO_NEAREST_INT);
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo_h), hi_h, 1);
+}
+
+// narrow two float masks (all bits set or zero per lane) to a 16-bit mask
+inline __m256i cvt_float_mask_to_half(__m256 lo, __m256 hi) {
+  __m256i packed =
+      _mm256_packs_epi32(_mm256_castps_si256(lo), _mm256_castps_si256(hi));
+  // packs works within 128-bit lanes, restore the element order
+  return _mm256_permute4x64_epi64(packed, 0xd8);
+}
+
+template <>
+class Vectorized<c10::Half> {
+ private:
+  __m256i values;
+
+  template <typename Op>
+  Vectorized<c10::Half> unary_op_as_fp32(const Op& op) const {
+    __m256 lo = cvt_half_lo_to_float(values);
+    __m256 hi = cvt_half_hi_to_float(values);
+    return cvt_float_to_half(
+        op(Vectorized<float>(lo)), op(Vectorized<float>(hi)));
+  }
+
+  template <typename Op>
+  Vectorized<c10::Half> compare_as_fp32(
+      const Vectorized<c10::Half>& other,
+      const Op& op) const {
+    __m256 a_lo = cvt_half_lo_to_float(values);
+    __m256 a_hi = cvt_half_hi_to_float(values);
+    __m256 b_lo = cvt_half_lo_to_float(other.values);
+    __m256 b_hi = cvt_half_hi_to_float(other.values);
+    return cvt_float_mask_to_half(op(a_lo, b_lo), op(a_hi, b_hi));
+  }
+
+ public:
+  using value_type = c10::Half;
+  using size_type = int;
+
+  static constexpr size_type size() {
+    return 16;
+  }
+
+  Vectorized() {}
+  Vectorized(__m256i v) : values(v) {}
+  Vectorized(c10::Half val) {
+    values = _mm256_set1_epi16(static_cast<short>(val.x));
+  }
+  template <
+      typename... Args,
+      typename = std::enable_if_t<(sizeof...(Args) == size())>>
+  Vectorized(Args... vals) {
+    __at_align__ c10::Half tmp[size()] = {static_cast<c10::Half>(vals)...};
+    values = _mm256_load_si256(reinterpret_cast<const __m256i*>(tmp));
+  }
+
+  operator __m256i() const {
+    return values;
+  }
+
+  template <int64_t mask>
+  static Vectorized<c10::Half> blend(
+      const Vectorized<c10::Half>& a,
+      const Vectorized<c10::Half>& b) {
+    __at_align__ int16_t mask_values[size()];
+    for (int64_t i = 0; i < size(); ++i) {
+      mask_values[i] = (mask & (int64_t(1) << i)) ? -1 : 0;
+    }
+    return blendv(a, b, loadu(mask_values));
+  }
+
+  static Vectorized<c10::Half> blendv(
+      const Vectorized<c10::Half>& a,
+      const Vectorized<c10::Half>& b,
+      const Vectorized<c10::Half>& mask) {
+    return _mm256_blendv_epi8(a.values, b.values, mask.values);
+  }
+
+  template <typename step_t>
+  static Vectorized<c10::Half> arange(
+      c10::Half base = 0.f,
+      step_t step = static_cast<step_t>(1)) {
+    __at_align__ c10::Half tmp[size()];
+    for (int64_t i = 0; i < size(); ++i) {
+      tmp[i] = static_cast<float>(base) + i * step;
+    }
+    return loadu(tmp);
+  }
+
+  static Vectorized<c10::Half> set(
+      const Vectorized<c10::Half>& a,
+      const Vectorized<c10::Half>& b,
+      int64_t count = size()) {
+    __at_align__ c10::Half tmp[size()];
+    a.store(tmp);
+    b.store(tmp, count);
+    return loadu(tmp);
+  }
+
+  static Vectorized<c10::Half> loadu(
+      const void* ptr,
+      int64_t count = size()) {
+    if (count == size()) {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    }
+    __at_align__ int16_t tmp_values[size()] = {};
+    std::memcpy(tmp_values, ptr, count * sizeof(int16_t));
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(tmp_values));
+  }
+
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), values);
+    } else if (count > 0) {
+      __at_align__ int16_t tmp_values[size()];
+      _mm256_store_si256(reinterpret_cast<__m256i*>(tmp_values), values);
+      std::memcpy(ptr, tmp_values, count * sizeof(int16_t));
+    }
+  }
+
+  const c10::Half& operator[](int idx) const = delete;
+  c10::Half& operator[](int idx) = delete;
+
+  int zero_mask() const {
+    // +0 and -0 both compare equal to zero
+    __m256i magnitude = _mm256_and_si256(values, _mm256_set1_epi16(0x7fff));
+    __m256i cmp = _mm256_cmpeq_epi16(magnitude, _mm256_setzero_si256());
+    // movemask_epi8 yields two bits per element, keep every other one
+    uint32_t bytes = static_cast<uint32_t>(_mm256_movemask_epi8(cmp));
+    int mask = 0;
+    for (int i = 0; i < size(); ++i) {
+      mask |= ((bytes >> (2 * i)) & 1) << i;
+    }
+    return mask;
+  }
+
+  Vectorized<c10::Half> isnan() const {
+    __m256i magnitude = _mm256_and_si256(values, _mm256_set1_epi16(0x7fff));
+    return _mm256_cmpgt_epi16(magnitude, _mm256_set1_epi16(0x7c00));
+  }
+
+  Vectorized<c10::Half> map(c10::Half (*const f)(c10::Half)) const {
+    __at_align__ c10::Half tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); ++i) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+
+  Vectorized<c10::Half> abs() const {
+    return _mm256_and_si256(values, _mm256_set1_epi16(0x7fff));
+  }
+
+  Vectorized<c10::Half> neg() const {
+    return _mm256_xor_si256(
+        values, _mm256_set1_epi16(static_cast<short>(0x8000)));
+  }
+
+#define DEFINE_UNARY_OP(name)                                            \
+  Vectorized<c10::Half> name() const {                                   \
+    return unary_op_as_fp32(                                             \
+        [](const Vectorized<float>& x) { return x.name(); });            \
+  }
+
+  DEFINE_UNARY_OP(sqrt)
+  DEFINE_UNARY_OP(rsqrt)
+  DEFINE_UNARY_OP(reciprocal)
+  DEFINE_UNARY_OP(floor)
+  DEFINE_UNARY_OP(ceil)
+  DEFINE_UNARY_OP(round)
+  DEFINE_UNARY_OP(trunc)
+  DEFINE_UNARY_OP(exp)
+  DEFINE_UNARY_OP(log)
+  DEFINE_UNARY_OP(tanh)
+#undef DEFINE_UNARY_OP
+
+#define DEFINE_COMPARISON_OP(op, cmp)                                    \
+  Vectorized<c10::Half> operator op(const Vectorized<c10::Half>& other)  \
+      const {                                                            \
+    return compare_as_fp32(                                              \
+        other, [](__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, cmp); }); \
+  }
+
+  DEFINE_COMPARISON_OP(==, _CMP_EQ_OQ)
+  DEFINE_COMPARISON_OP(!=, _CMP_NEQ_UQ)
+  DEFINE_COMPARISON_OP(<, _CMP_LT_OQ)
+  DEFINE_COMPARISON_OP(<=, _CMP_LE_OQ)
+  DEFINE_COMPARISON_OP(>, _CMP_GT_OQ)
+  DEFINE_COMPARISON_OP(>=, _CMP_GE_OQ)
+#undef DEFINE_COMPARISON_OP
+
+#define DEFINE_BINARY_PREDICATE(name, op)                                \
+  Vectorized<c10::Half> name(const Vectorized<c10::Half>& other) const { \
+    /* 0x3c00 is 1.0 in half precision */                               \
+    return _mm256_and_si256(                                             \
+        (*this op other).values, _mm256_set1_epi16(0x3c00));             \
+  }
+
+  DEFINE_BINARY_PREDICATE(eq, ==)
+  DEFINE_BINARY_PREDICATE(ne, !=)
+  DEFINE_BINARY_PREDICATE(lt, <)
+  DEFINE_BINARY_PREDICATE(le, <=)
+  DEFINE_BINARY_PREDICATE(gt, >)
+  DEFINE_BINARY_PREDICATE(ge, >=)
+#undef DEFINE_BINARY_PREDICATE
+};
+
+template <typename Op>
+inline Vectorized<c10::Half> binary_op_as_fp32(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& b,
+    const Op& op) {
+  __m256 a_lo = cvt_half_lo_to_float(a);
+  __m256 a_hi = cvt_half_hi_to_float(a);
+  __m256 b_lo = cvt_half_lo_to_float(b);
+  __m256 b_hi = cvt_half_hi_to_float(b);
+  return cvt_float_to_half(
+      op(Vectorized<float>(a_lo), Vectorized<float>(b_lo)),
+      op(Vectorized<float>(a_hi), Vectorized<float>(b_hi)));
+}
+
+#define DEFINE_HALF_BINARY_OP(op_decl, expr)                             \
+  template <>                                                            \
+  Vectorized<c10::Half> inline op_decl(                                  \
+      const Vectorized<c10::Half>& a, const Vectorized<c10::Half>& b) {  \
+    return binary_op_as_fp32(                                            \
+        a, b, [](const Vectorized<float>& x, const Vectorized<float>& y) { \
+          return expr;                                                   \
+        });                                                              \
+  }
+
+DEFINE_HALF_BINARY_OP(operator+, x + y)
+DEFINE_HALF_BINARY_OP(operator-, x - y)
+DEFINE_HALF_BINARY_OP(operator*, x * y)
+DEFINE_HALF_BINARY_OP(operator/, x / y)
+DEFINE_HALF_BINARY_OP(maximum, maximum(x, y))
+DEFINE_HALF_BINARY_OP(minimum, minimum(x, y))
+DEFINE_HALF_BINARY_OP(clamp_min, clamp_min(x, y))
+DEFINE_HALF_BINARY_OP(clamp_max, clamp_max(x, y))
+#undef DEFINE_HALF_BINARY_OP
+
+template <>
+Vectorized<c10::Half> inline operator&(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& b) {
+  return _mm256_and_si256(a, b);
+}
+
+template <>
+Vectorized<c10::Half> inline operator|(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& b) {
+  return _mm256_or_si256(a, b);
+}
+
+template <>
+Vectorized<c10::Half> inline operator^(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& b) {
+  return _mm256_xor_si256(a, b);
+}
+
+template <>
+Vectorized<c10::Half> inline clamp(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& min,
+    const Vectorized<c10::Half>& max) {
+  return clamp_max(clamp_min(a, min), max);
+}
+
+// fused in float, so only the final result is rounded to half
+template <>
+Vectorized<c10::Half> inline fmadd(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& b,
+    const Vectorized<c10::Half>& c) {
+  return cvt_float_to_half(
+      _mm256_fmadd_ps(
+          cvt_half_lo_to_float(a),
+          cvt_half_lo_to_float(b),
+          cvt_half_lo_to_float(c)),
+      _mm256_fmadd_ps(
+          cvt_half_hi_to_float(a),
+          cvt_half_hi_to_float(b),
+          cvt_half_hi_to_float(c)));
+}
+
+template <>
+Vectorized<c10::Half> inline fmsub(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& b,
+    const Vectorized<c10::Half>& c) {
+  return cvt_float_to_half(
+      _mm256_fmsub_ps(
+          cvt_half_lo_to_float(a),
+          cvt_half_lo_to_float(b),
+          cvt_half_lo_to_float(c)),
+      _mm256_fmsub_ps(
+          cvt_half_hi_to_float(a),
+          cvt_half_hi_to_float(b),
+          cvt_half_hi_to_float(c)));
+}
+
+inline std::tuple<Vectorized<float>, Vectorized<float>> convert_half_float(
+    const Vectorized<c10::Half>& a) {
+  return std::make_tuple(
+      Vectorized<float>(cvt_half_lo_to_float(a)),
+      Vectorized<float>(cvt_half_hi_to_float(a)));
+}
+
+inline Vectorized<c10::Half> convert_float_half(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b) {
+  return cvt_float_to_half(a, b);
+}
+
+inline Vectorized<float> load_fp32_from_fp16(const c10::Half* data) {
+  return _mm256_cvtph_ps(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+}
+
+template <>
+inline void convert(const c10::Half* src, float* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i <= n - Vectorized<float>::size(); i += Vectorized<float>::size()) {
+    _mm256_storeu_ps(dst + i, load_fp32_from_fp16(src + i));
+  }
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const float* src, c10::Half* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i <= n - Vectorized<float>::size(); i += Vectorized<float>::size()) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + i),
+        _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+  }
+  for (; i < n; i++) {
+    dst[i] = c10::Half(src[i]);
+  }
+}
+
+#endif // defined(CPU_CAPABILITY_AVX2)
+
+} // namespace CPU_CAPABILITY
+} // namespace at::vec
@@ -0,0 +1,417 @@
+#pragma once
+
+#include <ATen/cpu/vec/intrinsics.h>
+#include <ATen/cpu/vec/vec_base.h>
+
+namespace at::vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX2)
+
+// Shared implementation of the signed integer vectors and of uint8, all of
+// which are a single __m256i. Operations without an AVX2 instruction for the
+// element width (64-bit min/max/abs, 8- and 64-bit multiplication, integer
+// division) fall back to per-lane code.
+template <typename T>
+class Vectorized256i {
+  static_assert(
+      std::is_same_v<T, int64_t> || std::is_same_v<T, int32_t> ||
+      std::is_same_v<T, int16_t> || std::is_same_v<T, int8_t> ||
+      std::is_same_v<T, uint8_t>);
+
+ protected:
+  __m256i values;
+
+  static constexpr T kAllBits = static_cast<T>(~T(0));
+
+ public:
+  using value_type = T;
+  using size_type = int;
+
+  static constexpr size_type size() {
+    return 32 / sizeof(T);
+  }
+
+  Vectorized256i() {}
+  Vectorized256i(__m256i v) : values(v) {}
+  Vectorized256i(T val) {
+    if constexpr (sizeof(T) == 8) {
+      values = _mm256_set1_epi64x(val);
+    } else if constexpr (sizeof(T) == 4) {
+      values = _mm256_set1_epi32(val);
+    } else if constexpr (sizeof(T) == 2) {
+      values = _mm256_set1_epi16(val);
+    } else {
+      values = _mm256_set1_epi8(static_cast<char>(val));
+    }
+  }
+  template <
+      typename... Args,
+      typename = std::enable_if_t<(sizeof...(Args) == size())>>
+  Vectorized256i(Args... vals) {
+    __at_align__ T tmp[size()] = {static_cast<T>(vals)...};
+    values = _mm256_load_si256(reinterpret_cast<const __m256i*>(tmp));
+  }
+
+  operator __m256i() const {
+    return values;
+  }
+
+  template <int64_t mask>
+  static Vectorized<T> blend(const Vectorized<T>& a, const Vectorized<T>& b) {
+    if constexpr (sizeof(T) == 4) {
+      return _mm256_blend_epi32(a, b, mask);
+    } else if constexpr (sizeof(T) == 8) {
+      // every 64-bit lane is two 32-bit lanes
+      constexpr int mask32 = ((mask & 1) ? 0x03 : 0) |
+          ((mask & 2) ? 0x0c : 0) | ((mask & 4) ? 0x30 : 0) |
+          ((mask & 8) ? 0xc0 : 0);
+      return _mm256_blend_epi32(a, b, mask32);
+    } else {
+      __at_align__ T mask_values[size()];
+      for (int64_t i = 0; i < size(); ++i) {
+        mask_values[i] = (mask & (int64_t(1) << i)) ? kAllBits : T(0);
+      }
+      return blendv(a, b, loadu(mask_values));
+    }
+  }
+
+  static Vectorized<T> blendv(
+      const Vectorized<T>& a,
+      const Vectorized<T>& b,
+      const Vectorized<T>& mask) {
+    return _mm256_blendv_epi8(a, b, mask);
+  }
+
+  template <typename step_t>
+  static Vectorized<T> arange(
+      T base = 0,
+      step_t step = static_cast<step_t>(1)) {
+    __at_align__ T tmp[size()];
+    for (int64_t i = 0; i < size(); ++i) {
+      tmp[i] = static_cast<T>(base + i * step);
+    }
+    return loadu(tmp);
+  }
+
+  static Vectorized<T> set(
+      const Vectorized<T>& a,
+      const Vectorized<T>& b,
+      int64_t count = size()) {
+    __at_align__ T tmp[size()];
+    a.store(tmp);
+    b.store(tmp, count);
+    return loadu(tmp);
+  }
+
+  static Vectorized<T> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size()) {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    }
+    __at_align__ T tmp_values[size()] = {};
+    std::memcpy(tmp_values, ptr, count * sizeof(T));
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(tmp_values));
+  }
+
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), values);
+    } else if (count > 0) {
+      __at_align__ T tmp_values[size()];
+      _mm256_store_si256(reinterpret_cast<__m256i*>(tmp_values), values);
+      std::memcpy(ptr, tmp_values, count * sizeof(T));
+    }
+  }
+
+  const T& operator[](int idx) const = delete;
+  T& operator[](int idx) = delete;
+
+  int zero_mask() const {
+    __at_align__ T tmp[size()];
+    store(tmp);
+    uint64_t mask = 0;
+    for (int i = 0; i < size(); ++i) {
+      if (tmp[i] == 0) {
+        mask |= (uint64_t(1) << i);
+      }
+    }
+    return static_cast<int>(mask);
+  }
+
+  Vectorized<T> isnan() const {
+    return _mm256_setzero_si256();
+  }
+
+  Vectorized<T> map(T (*const f)(T)) const {
+    __at_align__ T tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); ++i) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+
+  Vectorized<T> abs() const {
+    if constexpr (std::is_same_v<T, uint8_t>) {
+      return values;
+    } else if constexpr (sizeof(T) == 8) {
+      __m256i zero = _mm256_setzero_si256();
+      __m256i is_neg = _mm256_cmpgt_epi64(zero, values);
+      return _mm256_blendv_epi8(
+          values, _mm256_sub_epi64(zero, values), is_neg);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm256_abs_epi32(values);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm256_abs_epi16(values);
+    } else {
+      return _mm256_abs_epi8(values);
+    }
+  }
+
+  Vectorized<T> neg() const {
+    return sub(_mm256_setzero_si256(), values);
+  }
+
+  Vectorized<T> reciprocal() const {
+    return map([](T x) -> T { return static_cast<T>(1) / x; });
+  }
+
+  Vectorized<T> operator==(const Vectorized<T>& other) const {
+    if constexpr (sizeof(T) == 8) {
+      return _mm256_cmpeq_epi64(values, other);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm256_cmpeq_epi32(values, other);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm256_cmpeq_epi16(values, other);
+    } else {
+      return _mm256_cmpeq_epi8(values, other);
+    }
+  }
+
+  Vectorized<T> operator!=(const Vectorized<T>& other) const {
+    return invert(*this == other);
+  }
+
+  Vectorized<T> operator<(const Vectorized<T>& other) const {
+    return cmpgt(other, values);
+  }
+
+  Vectorized<T> operator<=(const Vectorized<T>& other) const {
+    return invert(cmpgt(values, other));
+  }
+
+  Vectorized<T> operator>(const Vectorized<T>& other) const {
+    return cmpgt(values, other);
+  }
+
+  Vectorized<T> operator>=(const Vectorized<T>& other) const {
+    return invert(cmpgt(other, values));
+  }
+
+#define DEFINE_BINARY_PREDICATE(name, op)                                \
+  Vectorized<T> name(const Vectorized<T>& other) const {                 \
+    return _mm256_and_si256(                                             \
+        (*this op other), static_cast<__m256i>(Vectorized<T>(T(1))));    \
+  }
+
+  DEFINE_BINARY_PREDICATE(eq, ==)
+  DEFINE_BINARY_PREDICATE(ne, !=)
+  DEFINE_BINARY_PREDICATE(lt, <)
+  DEFINE_BINARY_PREDICATE(le, <=)
+  DEFINE_BINARY_PREDICATE(gt, >)
+  DEFINE_BINARY_PREDICATE(ge, >=)
+#undef DEFINE_BINARY_PREDICATE
+
+  static __m256i add(__m256i a, __m256i b) {
+    if constexpr (sizeof(T) == 8) {
+      return _mm256_add_epi64(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm256_add_epi32(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm256_add_epi16(a, b);
+    } else {
+      return _mm256_add_epi8(a, b);
+    }
+  }
+
+  static __m256i sub(__m256i a, __m256i b) {
+    if constexpr (sizeof(T) == 8) {
+      return _mm256_sub_epi64(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm256_sub_epi32(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm256_sub_epi16(a, b);
+    } else {
+      return _mm256_sub_epi8(a, b);
+    }
+  }
+
+  static __m256i mul(__m256i a, __m256i b) {
+    if constexpr (sizeof(T) == 4) {
+      return _mm256_mullo_epi32(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm256_mullo_epi16(a, b);
+    } else {
+      return binary_map(a, b, [](T x, T y) -> T { return x * y; });
+    }
+  }
+
+  static __m256i max(__m256i a, __m256i b) {
+    if constexpr (std::is_same_v<T, uint8_t>) {
+      return _mm256_max_epu8(a, b);
+    } else if constexpr (sizeof(T) == 8) {
+      return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm256_max_epi32(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm256_max_epi16(a, b);
+    } else {
+      return _mm256_max_epi8(a, b);
+    }
+  }
+
+  static __m256i min(__m256i a, __m256i b) {
+    if constexpr (std::is_same_v<T, uint8_t>) {
+      return _mm256_min_epu8(a, b);
+    } else if constexpr (sizeof(T) == 8) {
+      return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm256_min_epi32(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm256_min_epi16(a, b);
+    } else {
+      return _mm256_min_epi8(a, b);
+    }
+  }
+
+  template <typename Op>
+  static __m256i binary_map(__m256i a, __m256i b, const Op& op) {
+    __at_align__ T a_values[size()];
+    __at_align__ T b_values[size()];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(a_values), a);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(b_values), b);
+    for (int64_t i = 0; i < size(); ++i) {
+      a_values[i] = op(a_values[i], b_values[i]);
+    }
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(a_values));
+  }
+
+ private:
+  static __m256i invert(__m256i v) {
+    return _mm256_xor_si256(v, _mm256_set1_epi32(-1));
+  }
+
+  static __m256i cmpgt(__m256i a, __m256i b) {
+    if constexpr (std::is_same_v<T, uint8_t>) {
+      // AVX2 only compares signed bytes, flip the sign bits to compare
+      // unsigned ones
+      const __m256i sign = _mm256_set1_epi8(static_cast<char>(0x80));
+      return _mm256_cmpgt_epi8(
+          _mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+    } else if constexpr (sizeof(T) == 8) {
+      return _mm256_cmpgt_epi64(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm256_cmpgt_epi32(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm256_cmpgt_epi16(a, b);
+    } else {
+      return _mm256_cmpgt_epi8(a, b);
+    }
+  }
+};
+
+#define DEFINE_VEC256_INT(T)                                               \
+  template <>                                                              \
+  class Vectorized<T> : public Vectorized256i<T> {                         \
+   public:                                                                 \
+    using Vectorized256i<T>::Vectorized256i;                               \
+    Vectorized() {}                                                        \
+  };                                                                       \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator+(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return Vectorized256i<T>::add(a, b);                                   \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator-(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return Vectorized256i<T>::sub(a, b);                                   \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator*(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return Vectorized256i<T>::mul(a, b);                                   \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator/(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return Vectorized256i<T>::binary_map(                                  \
+        a, b, [](T x, T y) -> T { return x / y; });                        \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator&(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return _mm256_and_si256(a, b);                                         \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator|(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return _mm256_or_si256(a, b);                                          \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator^(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return _mm256_xor_si256(a, b);                                         \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline maximum(                                            \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return Vectorized256i<T>::max(a, b);                                   \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline minimum(                                            \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return Vectorized256i<T>::min(a, b);                                   \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline clamp(                                              \
+      const Vectorized<T>& a,                                              \
+      const Vectorized<T>& min_vec,                                        \
+      const Vectorized<T>& max_vec) {                                      \
+    return Vectorized256i<T>::min(                                         \
+        max_vec, Vectorized256i<T>::max(min_vec, a));                      \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline clamp_min(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& min_vec) {              \
+    return Vectorized256i<T>::max(min_vec, a);                             \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline clamp_max(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& max_vec) {              \
+    return Vectorized256i<T>::min(max_vec, a);                             \
+  }
+
+DEFINE_VEC256_INT(int64_t)
+DEFINE_VEC256_INT(int32_t)
+DEFINE_VEC256_INT(int16_t)
+DEFINE_VEC256_INT(int8_t)
+DEFINE_VEC256_INT(uint8_t)
+#undef DEFINE_VEC256_INT
+
+#endif // defined(CPU_CAPABILITY_AVX2)
+
+} // namespace CPU_CAPABILITY
+} // namespace at::vec
@@ -0,0 +1,16 @@
+#pragma once
+
+// AVX-512 (F, BW, VL, DQ with FMA and F16C) specializations of
+// Vectorized<T>, used when the including file is built with
+// CPU_CAPABILITY_AVX512. Types without a specialization here keep the
+// generic implementation, which is 64 bytes wide under this capability.
+
+#include <ATen/cpu/vec/intrinsics.h>
+#include <ATen/cpu/vec/vec_base.h>
+
+#include <ATen/cpu/vec/vec512/vec512_bfloat16.h>
+#include <ATen/cpu/vec/vec512/vec512_double.h>
+#include <ATen/cpu/vec/vec512/vec512_float.h>
+#include <ATen/cpu/vec/vec512/vec512_float8.h>
+#include <ATen/cpu/vec/vec512/vec512_half.h>
+#include <ATen/cpu/vec/vec512/vec512_int.h>
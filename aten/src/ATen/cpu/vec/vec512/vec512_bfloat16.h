@@ -0,0 +1,65 @@
+#pragma once
+
+#include <ATen/cpu/vec/intrinsics.h>
+#include <ATen/cpu/vec/vec512/vec512_float.h>
+#include <ATen/cpu/vec/vec_base.h>
+#include <c10/util/BFloat16.h>
+
+namespace at::vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+// BFloat16 conversions as in vec256_bfloat16.h, 16 lanes at a time.
+
+inline __m512 cvt_bf16_to_float(__m256i a) {
+  return _mm512_castsi512_ps(
+      _mm512_slli_epi32(_mm512_cvtepu16_epi32(a), 16));
+}
+
+inline __m256i cvt_float_to_bf16(__m512 a) {
+  const __m512i bits = _mm512_castps_si512(a);
+  const __m512i lsb =
+      _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+  const __m512i rounded = _mm512_srli_epi32(
+      _mm512_add_epi32(
+          bits, _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7FFF))),
+      16);
+  const __mmask16 nan = _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q);
+  return _mm512_cvtepi32_epi16(
+      _mm512_mask_blend_epi32(nan, rounded, _mm512_set1_epi32(0x7FC0)));
+}
+
+inline Vectorized<float> load_fp32_from_bf16(const c10::BFloat16* data) {
+  return cvt_bf16_to_float(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)));
+}
+
+template <>
+inline void convert(const c10::BFloat16* src, float* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i <= n - Vectorized<float>::size(); i += Vectorized<float>::size()) {
+    _mm512_storeu_ps(dst + i, load_fp32_from_bf16(src + i));
+  }
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const float* src, c10::BFloat16* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i <= n - Vectorized<float>::size(); i += Vectorized<float>::size()) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i),
+        cvt_float_to_bf16(_mm512_loadu_ps(src + i)));
+  }
+  for (; i < n; i++) {
+    dst[i] = c10::BFloat16(src[i]);
+  }
+}
+
+#endif // defined(CPU_CAPABILITY_AVX512)
+
+} // namespace CPU_CAPABILITY
+} // namespace at::vec
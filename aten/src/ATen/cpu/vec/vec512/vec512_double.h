@@ -0,0 +1,316 @@
+#pragma once
+
+#include <ATen/cpu/vec/intrinsics.h>
+#include <ATen/cpu/vec/vec_base.h>
+
+namespace at::vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+template <>
+class Vectorized<double> {
+ private:
+  __m512d values;
+
+  static __m512d mask_to_vector(__mmask8 mask) {
+    return _mm512_castsi512_pd(
+        _mm512_maskz_set1_epi64(mask, -1));
+  }
+
+ public:
+  using value_type = double;
+  using size_type = int;
+
+  static constexpr size_type size() {
+    return 8;
+  }
+
+  Vectorized() {}
+  Vectorized(__m512d v) : values(v) {}
+  Vectorized(double val) {
+    values = _mm512_set1_pd(val);
+  }
+  Vectorized(
+      double val1,
+      double val2,
+      double val3,
+      double val4,
+      double val5,
+      double val6,
+      double val7,
+      double val8) {
+    values = _mm512_setr_pd(val1, val2, val3, val4, val5, val6, val7, val8);
+  }
+
+  operator __m512d() const {
+    return values;
+  }
+
+  template <int64_t mask>
+  static Vectorized<double> blend(
+      const Vectorized<double>& a,
+      const Vectorized<double>& b) {
+    return _mm512_mask_blend_pd(mask, a.values, b.values);
+  }
+
+  static Vectorized<double> blendv(
+      const Vectorized<double>& a,
+      const Vectorized<double>& b,
+      const Vectorized<double>& mask) {
+    __mmask8 k = _mm512_test_epi64_mask(
+        _mm512_castpd_si512(mask.values), _mm512_castpd_si512(mask.values));
+    return _mm512_mask_blend_pd(k, a.values, b.values);
+  }
+
+  template <typename step_t>
+  static Vectorized<double> arange(
+      double base = 0.0,
+      step_t step = static_cast<step_t>(1)) {
+    __at_align__ double tmp[size()];
+    for (int64_t i = 0; i < size(); ++i) {
+      tmp[i] = base + i * step;
+    }
+    return _mm512_load_pd(tmp);
+  }
+
+  static Vectorized<double> set(
+      const Vectorized<double>& a,
+      const Vectorized<double>& b,
+      int64_t count = size()) {
+    __mmask8 mask = static_cast<__mmask8>((1ULL << count) - 1);
+    return _mm512_mask_blend_pd(mask, a.values, b.values);
+  }
+
+  // masked loads and stores do not touch memory past `count`
+  static Vectorized<double> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size()) {
+      return _mm512_loadu_pd(reinterpret_cast<const double*>(ptr));
+    }
+    __mmask8 mask = static_cast<__mmask8>((1ULL << count) - 1);
+    return _mm512_maskz_loadu_pd(mask, ptr);
+  }
+
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm512_storeu_pd(reinterpret_cast<double*>(ptr), values);
+    } else if (count > 0) {
+      __mmask8 mask = static_cast<__mmask8>((1ULL << count) - 1);
+      _mm512_mask_storeu_pd(reinterpret_cast<double*>(ptr), mask, values);
+    }
+  }
+
+  const double& operator[](int idx) const = delete;
+  double& operator[](int idx) = delete;
+
+  int zero_mask() const {
+    return _mm512_cmp_pd_mask(values, _mm512_setzero_pd(), _CMP_EQ_OQ);
+  }
+
+  Vectorized<double> isnan() const {
+    return mask_to_vector(_mm512_cmp_pd_mask(values, values, _CMP_UNORD_Q));
+  }
+
+  Vectorized<double> map(double (*const f)(double)) const {
+    __at_align__ double tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); ++i) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+
+  Vectorized<double> abs() const {
+    return _mm512_abs_pd(values);
+  }
+
+  Vectorized<double> neg() const {
+    return _mm512_xor_pd(_mm512_set1_pd(-0.0), values);
+  }
+
+  Vectorized<double> sqrt() const {
+    return _mm512_sqrt_pd(values);
+  }
+
+  Vectorized<double> rsqrt() const {
+    return _mm512_div_pd(_mm512_set1_pd(1.0), _mm512_sqrt_pd(values));
+  }
+
+  Vectorized<double> reciprocal() const {
+    return _mm512_div_pd(_mm512_set1_pd(1.0), values);
+  }
+
+  Vectorized<double> floor() const {
+    return _mm512_roundscale_pd(
+        values, (_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+  }
+
+  Vectorized<double> ceil() const {
+    return _mm512_roundscale_pd(
+        values, (_MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+  }
+
+  Vectorized<double> round() const {
+    return _mm512_roundscale_pd(
+        values, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+
+  Vectorized<double> trunc() const {
+    return _mm512_roundscale_pd(
+        values, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+  }
+
+  Vectorized<double> exp() const {
+    return map(std::exp);
+  }
+
+  Vectorized<double> log() const {
+    return map(std::log);
+  }
+
+  Vectorized<double> tanh() const {
+    return map(std::tanh);
+  }
+
+#define DEFINE_COMPARISON_OP(op, cmp)                                    \
+  Vectorized<double> operator op(const Vectorized<double>& other) const {  \
+    return mask_to_vector(_mm512_cmp_pd_mask(values, other.values, cmp)); \
+  }
+
+  DEFINE_COMPARISON_OP(==, _CMP_EQ_OQ)
+  DEFINE_COMPARISON_OP(!=, _CMP_NEQ_UQ)
+  DEFINE_COMPARISON_OP(<, _CMP_LT_OQ)
+  DEFINE_COMPARISON_OP(<=, _CMP_LE_OQ)
+  DEFINE_COMPARISON_OP(>, _CMP_GT_OQ)
+  DEFINE_COMPARISON_OP(>=, _CMP_GE_OQ)
+#undef DEFINE_COMPARISON_OP
+
+#define DEFINE_BINARY_PREDICATE(name, cmp)                               \
+  Vectorized<double> name(const Vectorized<double>& other) const {         \
+    return _mm512_maskz_mov_pd(                                          \
+        _mm512_cmp_pd_mask(values, other.values, cmp),                   \
+        _mm512_set1_pd(1.0));                                           \
+  }
+
+  DEFINE_BINARY_PREDICATE(eq, _CMP_EQ_OQ)
+  DEFINE_BINARY_PREDICATE(ne, _CMP_NEQ_UQ)
+  DEFINE_BINARY_PREDICATE(lt, _CMP_LT_OQ)
+  DEFINE_BINARY_PREDICATE(le, _CMP_LE_OQ)
+  DEFINE_BINARY_PREDICATE(gt, _CMP_GT_OQ)
+  DEFINE_BINARY_PREDICATE(ge, _CMP_GE_OQ)
+#undef DEFINE_BINARY_PREDICATE
+};
+
+template <>
+Vectorized<double> inline operator+(
+    const Vectorized<double>& a,
+    const Vectorized<double>& b) {
+  return _mm512_add_pd(a, b);
+}
+
+template <>
+Vectorized<double> inline operator-(
+    const Vectorized<double>& a,
+    const Vectorized<double>& b) {
+  return _mm512_sub_pd(a, b);
+}
+
+template <>
+Vectorized<double> inline operator*(
+    const Vectorized<double>& a,
+    const Vectorized<double>& b) {
+  return _mm512_mul_pd(a, b);
+}
+
+template <>
+Vectorized<double> inline operator/(
+    const Vectorized<double>& a,
+    const Vectorized<double>& b) {
+  return _mm512_div_pd(a, b);
+}
+
+template <>
+Vectorized<double> inline operator&(
+    const Vectorized<double>& a,
+    const Vectorized<double>& b) {
+  return _mm512_and_pd(a, b);
+}
+
+template <>
+Vectorized<double> inline operator|(
+    const Vectorized<double>& a,
+    const Vectorized<double>& b) {
+  return _mm512_or_pd(a, b);
+}
+
+template <>
+Vectorized<double> inline operator^(
+    const Vectorized<double>& a,
+    const Vectorized<double>& b) {
+  return _mm512_xor_pd(a, b);
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vectorized<double> inline maximum(
+    const Vectorized<double>& a,
+    const Vectorized<double>& b) {
+  __mmask8 isnan = _mm512_cmp_pd_mask(a, b, _CMP_UNORD_Q);
+  __m512d max = _mm512_max_pd(a, b);
+  return _mm512_mask_blend_pd(isnan, max, _mm512_set1_pd(NAN));
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vectorized<double> inline minimum(
+    const Vectorized<double>& a,
+    const Vectorized<double>& b) {
+  __mmask8 isnan = _mm512_cmp_pd_mask(a, b, _CMP_UNORD_Q);
+  __m512d min = _mm512_min_pd(a, b);
+  return _mm512_mask_blend_pd(isnan, min, _mm512_set1_pd(NAN));
+}
+
+template <>
+Vectorized<double> inline clamp(
+    const Vectorized<double>& a,
+    const Vectorized<double>& min,
+    const Vectorized<double>& max) {
+  return _mm512_min_pd(max, _mm512_max_pd(min, a));
+}
+
+template <>
+Vectorized<double> inline clamp_min(
+    const Vectorized<double>& a,
+    const Vectorized<double>& min) {
+  return _mm512_max_pd(min, a);
+}
+
+template <>
+Vectorized<double> inline clamp_max(
+    const Vectorized<double>& a,
+    const Vectorized<double>& max) {
+  return _mm512_min_pd(max, a);
+}
+
+template <>
+Vectorized<double> inline fmadd(
+    const Vectorized<double>& a,
+    const Vectorized<double>& b,
+    const Vectorized<double>& c) {
+  return _mm512_fmadd_pd(a, b, c);
+}
+
+template <>
+Vectorized<double> inline fmsub(
+    const Vectorized<double>& a,
+    const Vectorized<double>& b,
+    const Vectorized<double>& c) {
+  return _mm512_fmsub_pd(a, b, c);
+}
+
+#endif // defined(CPU_CAPABILITY_AVX512)
+
+} // namespace CPU_CAPABILITY
+} // namespace at::vec
@@ -0,0 +1,373 @@
+#pragma once
+
+#include <ATen/cpu/vec/intrinsics.h>
+#include <ATen/cpu/vec/vec_base.h>
+
+namespace at::vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+template <>
+class Vectorized<float> {
+ private:
+  __m512 values;
+
+  static __m512 mask_to_vector(__mmask16 mask) {
+    return _mm512_castsi512_ps(
+        _mm512_maskz_set1_epi32(mask, static_cast<int>(0xffffffff)));
+  }
+
+ public:
+  using value_type = float;
+  using size_type = int;
+
+  static constexpr size_type size() {
+    return 16;
+  }
+
+  Vectorized() {}
+  Vectorized(__m512 v) : values(v) {}
+  Vectorized(float val) {
+    values = _mm512_set1_ps(val);
+  }
+  Vectorized(
+      float val1,
+      float val2,
+      float val3,
+      float val4,
+      float val5,
+      float val6,
+      float val7,
+      float val8,
+      float val9,
+      float val10,
+      float val11,
+      float val12,
+      float val13,
+      float val14,
+      float val15,
+      float val16) {
+    values = _mm512_setr_ps(
+        val1,
+        val2,
+        val3,
+        val4,
+        val5,
+        val6,
+        val7,
+        val8,
+        val9,
+        val10,
+        val11,
+        val12,
+        val13,
+        val14,
+        val15,
+        val16);
+  }
+
+  operator __m512() const {
+    return values;
+  }
+
+  template <int64_t mask>
+  static Vectorized<float> blend(
+      const Vectorized<float>& a,
+      const Vectorized<float>& b) {
+    return _mm512_mask_blend_ps(mask, a.values, b.values);
+  }
+
+  static Vectorized<float> blendv(
+      const Vectorized<float>& a,
+      const Vectorized<float>& b,
+      const Vectorized<float>& mask) {
+    __mmask16 k = _mm512_test_epi32_mask(
+        _mm512_castps_si512(mask.values), _mm512_castps_si512(mask.values));
+    return _mm512_mask_blend_ps(k, a.values, b.values);
+  }
+
+  template <typename step_t>
+  static Vectorized<float> arange(
+      float base = 0.f,
+      step_t step = static_cast<step_t>(1)) {
+    __at_align__ float tmp[size()];
+    for (int64_t i = 0; i < size(); ++i) {
+      tmp[i] = base + i * step;
+    }
+    return _mm512_load_ps(tmp);
+  }
+
+  static Vectorized<float> set(
+      const Vectorized<float>& a,
+      const Vectorized<float>& b,
+      int64_t count = size()) {
+    __mmask16 mask = static_cast<__mmask16>((1ULL << count) - 1);
+    return _mm512_mask_blend_ps(mask, a.values, b.values);
+  }
+
+  // masked loads and stores do not touch memory past `count`
+  static Vectorized<float> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size()) {
+      return _mm512_loadu_ps(reinterpret_cast<const float*>(ptr));
+    }
+    __mmask16 mask = static_cast<__mmask16>((1ULL << count) - 1);
+    return _mm512_maskz_loadu_ps(mask, ptr);
+  }
+
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm512_storeu_ps(reinterpret_cast<float*>(ptr), values);
+    } else if (count > 0) {
+      __mmask16 mask = static_cast<__mmask16>((1ULL << count) - 1);
+      _mm512_mask_storeu_ps(reinterpret_cast<float*>(ptr), mask, values);
+    }
+  }
+
+  const float& operator[](int idx) const = delete;
+  float& operator[](int idx) = delete;
+
+  int zero_mask() const {
+    return _mm512_cmp_ps_mask(values, _mm512_setzero_ps(), _CMP_EQ_OQ);
+  }
+
+  Vectorized<float> isnan() const {
+    return mask_to_vector(_mm512_cmp_ps_mask(values, values, _CMP_UNORD_Q));
+  }
+
+  Vectorized<float> map(float (*const f)(float)) const {
+    __at_align__ float tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); ++i) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+
+  Vectorized<float> abs() const {
+    return _mm512_abs_ps(values);
+  }
+
+  Vectorized<float> neg() const {
+    return _mm512_xor_ps(_mm512_set1_ps(-0.f), values);
+  }
+
+  Vectorized<float> sqrt() const {
+    return _mm512_sqrt_ps(values);
+  }
+
+  Vectorized<float> rsqrt() const {
+    return _mm512_div_ps(_mm512_set1_ps(1), _mm512_sqrt_ps(values));
+  }
+
+  Vectorized<float> reciprocal() const {
+    return _mm512_div_ps(_mm512_set1_ps(1), values);
+  }
+
+  Vectorized<float> floor() const {
+    return _mm512_roundscale_ps(
+        values, (_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+  }
+
+  Vectorized<float> ceil() const {
+    return _mm512_roundscale_ps(
+        values, (_MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+  }
+
+  Vectorized<float> round() const {
+    return _mm512_roundscale_ps(
+        values, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+
+  Vectorized<float> trunc() const {
+    return _mm512_roundscale_ps(
+        values, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+  }
+
+  // same algorithm as the AVX2 version, see vec256_float.h
+  Vectorized<float> exp() const {
+    const __m512 log2e = _mm512_set1_ps(1.44269504088896341f);
+    const __m512 ln2_hi = _mm512_set1_ps(0.693359375f);
+    const __m512 ln2_lo = _mm512_set1_ps(-2.12194440e-4f);
+
+    __m512 x = _mm512_min_ps(values, _mm512_set1_ps(89.f));
+    x = _mm512_max_ps(x, _mm512_set1_ps(-104.f));
+
+    __m512 fx = _mm512_fmadd_ps(x, log2e, _mm512_set1_ps(0.5f));
+    fx = _mm512_roundscale_ps(fx, (_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+    x = _mm512_fnmadd_ps(fx, ln2_hi, x);
+    x = _mm512_fnmadd_ps(fx, ln2_lo, x);
+
+    __m512 y = _mm512_set1_ps(1.9875691500e-4f);
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(1.3981999507e-3f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(8.3334519073e-3f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(4.1665795894e-2f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(1.6666665459e-1f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(5.0000001201e-1f));
+    y = _mm512_fmadd_ps(y, _mm512_mul_ps(x, x), x);
+    y = _mm512_add_ps(y, _mm512_set1_ps(1.f));
+
+    const __m512i bias = _mm512_set1_epi32(127);
+    __m512i n = _mm512_cvttps_epi32(fx);
+    __m512i n1 = _mm512_srai_epi32(n, 1);
+    __m512i n2 = _mm512_sub_epi32(n, n1);
+    __m512 p1 = _mm512_castsi512_ps(
+        _mm512_slli_epi32(_mm512_add_epi32(n1, bias), 23));
+    __m512 p2 = _mm512_castsi512_ps(
+        _mm512_slli_epi32(_mm512_add_epi32(n2, bias), 23));
+    y = _mm512_mul_ps(_mm512_mul_ps(y, p1), p2);
+
+    __mmask16 nan_mask = _mm512_cmp_ps_mask(values, values, _CMP_UNORD_Q);
+    return _mm512_mask_blend_ps(nan_mask, y, values);
+  }
+
+  Vectorized<float> log() const {
+    return map(std::log);
+  }
+
+  Vectorized<float> tanh() const {
+    return map(std::tanh);
+  }
+
+#define DEFINE_COMPARISON_OP(op, cmp)                                    \
+  Vectorized<float> operator op(const Vectorized<float>& other) const {  \
+    return mask_to_vector(_mm512_cmp_ps_mask(values, other.values, cmp)); \
+  }
+
+  DEFINE_COMPARISON_OP(==, _CMP_EQ_OQ)
+  DEFINE_COMPARISON_OP(!=, _CMP_NEQ_UQ)
+  DEFINE_COMPARISON_OP(<, _CMP_LT_OQ)
+  DEFINE_COMPARISON_OP(<=, _CMP_LE_OQ)
+  DEFINE_COMPARISON_OP(>, _CMP_GT_OQ)
+  DEFINE_COMPARISON_OP(>=, _CMP_GE_OQ)
+#undef DEFINE_COMPARISON_OP
+
+#define DEFINE_BINARY_PREDICATE(name, cmp)                               \
+  Vectorized<float> name(const Vectorized<float>& other) const {         \
+    return _mm512_maskz_mov_ps(                                          \
+        _mm512_cmp_ps_mask(values, other.values, cmp),                   \
+        _mm512_set1_ps(1.0f));                                           \
+  }
+
+  DEFINE_BINARY_PREDICATE(eq, _CMP_EQ_OQ)
+  DEFINE_BINARY_PREDICATE(ne, _CMP_NEQ_UQ)
+  DEFINE_BINARY_PREDICATE(lt, _CMP_LT_OQ)
+  DEFINE_BINARY_PREDICATE(le, _CMP_LE_OQ)
+  DEFINE_BINARY_PREDICATE(gt, _CMP_GT_OQ)
+  DEFINE_BINARY_PREDICATE(ge, _CMP_GE_OQ)
+#undef DEFINE_BINARY_PREDICATE
+};
+
+template <>
+Vectorized<float> inline operator+(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b) {
+  return _mm512_add_ps(a, b);
+}
+
+template <>
+Vectorized<float> inline operator-(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b) {
+  return _mm512_sub_ps(a, b);
+}
+
+template <>
+Vectorized<float> inline operator*(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b) {
+  return _mm512_mul_ps(a, b);
+}
+
+template <>
+Vectorized<float> inline operator/(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b) {
+  return _mm512_div_ps(a, b);
+}
+
+template <>
+Vectorized<float> inline operator&(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b) {
+  return _mm512_and_ps(a, b);
+}
+
+template <>
+Vectorized<float> inline operator|(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b) {
+  return _mm512_or_ps(a, b);
+}
+
+template <>
+Vectorized<float> inline operator^(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b) {
+  return _mm512_xor_ps(a, b);
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vectorized<float> inline maximum(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b) {
+  __mmask16 isnan = _mm512_cmp_ps_mask(a, b, _CMP_UNORD_Q);
+  __m512 max = _mm512_max_ps(a, b);
+  return _mm512_mask_blend_ps(isnan, max, _mm512_set1_ps(NAN));
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vectorized<float> inline minimum(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b) {
+  __mmask16 isnan = _mm512_cmp_ps_mask(a, b, _CMP_UNORD_Q);
+  __m512 min = _mm512_min_ps(a, b);
+  return _mm512_mask_blend_ps(isnan, min, _mm512_set1_ps(NAN));
+}
+
+template <>
+Vectorized<float> inline clamp(
+    const Vectorized<float>& a,
+    const Vectorized<float>& min,
+    const Vectorized<float>& max) {
+  return _mm512_min_ps(max, _mm512_max_ps(min, a));
+}
+
+template <>
+Vectorized<float> inline clamp_min(
+    const Vectorized<float>& a,
+    const Vectorized<float>& min) {
+  return _mm512_max_ps(min, a);
+}
+
+template <>
+Vectorized<float> inline clamp_max(
+    const Vectorized<float>& a,
+    const Vectorized<float>& max) {
+  return _mm512_min_ps(max, a);
+}
+
+template <>
+Vectorized<float> inline fmadd(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b,
+    const Vectorized<float>& c) {
+  return _mm512_fmadd_ps(a, b, c);
+}
+
+template <>
+Vectorized<float> inline fmsub(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b,
+    const Vectorized<float>& c) {
+  return _mm512_fmsub_ps(a, b, c);
+}
+
+#endif // defined(CPU_CAPABILITY_AVX512)
+
+} // namespace CPU_CAPABILITY
+} // namespace at::vec
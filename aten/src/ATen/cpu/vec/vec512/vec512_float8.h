@@ -0,0 +1,154 @@
+#pragma once
+
+#include <ATen/cpu/vec/intrinsics.h>
+#include <ATen/cpu/vec/vec512/vec512_float.h>
+#include <ATen/cpu/vec/vec_base.h>
+#include <c10/util/Float8_e4m3fn.h>
+#include <c10/util/Float8_e5m2.h>
+
+namespace at::vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+// Float8 conversions as in vec256_float8.h, 16 lanes at a time.
+
+template <typename T>
+struct Float8Format;
+
+template <>
+struct Float8Format<c10::Float8_e4m3fn> {
+  static constexpr int kMantissaBits = 3;
+  static constexpr int kBias = 7;
+  static constexpr uint32_t kMaxBits = 0x43E00000;
+  static constexpr uint32_t kMinNormalBits = 121u << 23;
+  static constexpr uint32_t kDenormMask = 141u << 23;
+  static constexpr uint32_t kMaxFinite = 0x7E;
+  static constexpr bool kHasInfinity = false;
+};
+
+template <>
+struct Float8Format<c10::Float8_e5m2> {
+  static constexpr int kMantissaBits = 2;
+  static constexpr int kBias = 15;
+  static constexpr uint32_t kMaxBits = 0x47600000;
+  static constexpr uint32_t kMinNormalBits = 113u << 23;
+  static constexpr uint32_t kDenormMask = 134u << 23;
+  static constexpr uint32_t kMaxFinite = 0x7B;
+  static constexpr bool kHasInfinity = true;
+};
+
+template <typename T>
+inline __m512 cvt_fp8_to_float(__m128i a) {
+  using F = Float8Format<T>;
+  constexpr int kShift = 23 - F::kMantissaBits;
+  const __m512i bits = _mm512_cvtepu8_epi32(a);
+  const __m512i nonsign = _mm512_and_si512(bits, _mm512_set1_epi32(0x7F));
+  const __m512i sign =
+      _mm512_slli_epi32(_mm512_and_si512(bits, _mm512_set1_epi32(0x80)), 24);
+  const __m512 magnitude = _mm512_mul_ps(
+      _mm512_castsi512_ps(_mm512_slli_epi32(nonsign, kShift)),
+      _mm512_castsi512_ps(_mm512_set1_epi32((254 - F::kBias) << 23)));
+  __m512i result = _mm512_castps_si512(magnitude);
+  if constexpr (F::kHasInfinity) {
+    const __mmask16 special =
+        _mm512_cmpgt_epi32_mask(nonsign, _mm512_set1_epi32(0x7B));
+    const __m512i inf_nan = _mm512_or_si512(
+        _mm512_set1_epi32(0x7F800000),
+        _mm512_slli_epi32(
+            _mm512_and_si512(nonsign, _mm512_set1_epi32(3)), kShift));
+    result = _mm512_mask_blend_epi32(special, result, inf_nan);
+  } else {
+    const __mmask16 nan =
+        _mm512_cmpeq_epi32_mask(nonsign, _mm512_set1_epi32(0x7F));
+    result =
+        _mm512_mask_blend_epi32(nan, result, _mm512_set1_epi32(0x7FC00000));
+  }
+  return _mm512_castsi512_ps(_mm512_or_si512(result, sign));
+}
+
+template <typename T>
+inline __m128i cvt_float_to_fp8(__m512 a) {
+  using F = Float8Format<T>;
+  constexpr int kShift = 23 - F::kMantissaBits;
+  const __m512i bits = _mm512_castps_si512(a);
+  const __m512i sign =
+      _mm512_and_si512(bits, _mm512_set1_epi32(int32_t(0x80000000)));
+  const __m512i abs = _mm512_xor_si512(bits, sign);
+  const __m512i denorm_mask = _mm512_set1_epi32(F::kDenormMask);
+  const __m512i denormal = _mm512_sub_epi32(
+      _mm512_castps_si512(_mm512_add_ps(
+          _mm512_castsi512_ps(abs), _mm512_castsi512_ps(denorm_mask))),
+      denorm_mask);
+  const __m512i mant_odd = _mm512_and_si512(
+      _mm512_srli_epi32(abs, kShift), _mm512_set1_epi32(1));
+  const __m512i normal = _mm512_srli_epi32(
+      _mm512_add_epi32(
+          _mm512_add_epi32(
+              abs,
+              _mm512_set1_epi32(
+                  int32_t(uint32_t(F::kBias - 127) << 23) +
+                  ((1 << (kShift - 1)) - 1))),
+          mant_odd),
+      kShift);
+  __m512i result = _mm512_mask_blend_epi32(
+      _mm512_cmplt_epi32_mask(abs, _mm512_set1_epi32(F::kMinNormalBits)),
+      normal,
+      denormal);
+  result = _mm512_mask_blend_epi32(
+      _mm512_cmpge_epi32_mask(abs, _mm512_set1_epi32(F::kMaxBits)),
+      result,
+      _mm512_set1_epi32(F::kMaxFinite));
+  if constexpr (F::kHasInfinity) {
+    result = _mm512_mask_blend_epi32(
+        _mm512_cmpeq_epi32_mask(abs, _mm512_set1_epi32(0x7F800000)),
+        result,
+        _mm512_set1_epi32(0x7C));
+  }
+  result = _mm512_mask_blend_epi32(
+      _mm512_cmpgt_epi32_mask(abs, _mm512_set1_epi32(0x7F800000)),
+      result,
+      _mm512_set1_epi32(0x7F));
+  return _mm512_cvtepi32_epi8(
+      _mm512_or_si512(result, _mm512_srli_epi32(sign, 24)));
+}
+
+#define DEFINE_FLOAT8_CONVERT(T)                                            \
+  template <>                                                               \
+  inline void convert(const T* src, float* dst, int64_t n) {                \
+    int64_t i = 0;                                                          \
+    for (; i <= n - Vectorized<float>::size();                              \
+         i += Vectorized<float>::size()) {                                  \
+      _mm512_storeu_ps(                                                     \
+          dst + i,                                                          \
+          cvt_fp8_to_float<T>(                                              \
+              _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)))); \
+    }                                                                       \
+    for (; i < n; i++) {                                                    \
+      dst[i] = static_cast<float>(src[i]);                                  \
+    }                                                                       \
+  }                                                                         \
+                                                                            \
+  template <>                                                               \
+  inline void convert(const float* src, T* dst, int64_t n) {                \
+    int64_t i = 0;                                                          \
+    for (; i <= n - Vectorized<float>::size();                              \
+         i += Vectorized<float>::size()) {                                  \
+      _mm_storeu_si128(                                                     \
+          reinterpret_cast<__m128i*>(dst + i),                              \
+          cvt_float_to_fp8<T>(_mm512_loadu_ps(src + i)));                   \
+    }                                                                       \
+    for (; i < n; i++) {                                                    \
+      dst[i] = T(src[i]);                                                   \
+    }                                                                       \
+  }
+
+DEFINE_FLOAT8_CONVERT(c10::Float8_e4m3fn)
+DEFINE_FLOAT8_CONVERT(c10::Float8_e5m2)
+
+#undef DEFINE_FLOAT8_CONVERT
+
+#endif // defined(CPU_CAPABILITY_AVX512)
+
+} // namespace CPU_CAPABILITY
+} // namespace at::vec
@@ -0,0 +1,365 @@
+#pragma once
+
+#include <ATen/cpu/vec/intrinsics.h>
+#include <ATen/cpu/vec/vec512/vec512_float.h>
+#include <ATen/cpu/vec/vec_base.h>
+
+namespace at::vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+// Vectorized<Half> stores 32 halves in a __m512i and computes in float like
+// the AVX2 version, see vec256_half.h.
+
+inline __m512 cvt_half_lo_to_float(__m512i a) {
+  return _mm512_cvtph_ps(_mm512_castsi512_si256(a));
+}
+
+inline __m512 cvt_half_hi_to_float(__m512i a) {
+  return _mm512_cvtph_ps(_mm512_extracti64x4_epi64(a, 1));
+}
+
+inline __m512i cvt_float_to_half(__m512 lo, __m512 hi) {
+  __m256i lo_h =
+      _mm512_cvtps_ph(lo, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  __m256i hi_h =
+      _mm512_cvtps_ph(hi, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  return _mm512_inserti64x4(_mm512_castsi256_si512(lo_h), hi_h, 1);
+}
+
+template <>
+class Vectorized<c10::Half> {
+ private:
+  __m512i values;
+
+  template <typename Op>
+  Vectorized<c10::Half> unary_op_as_fp32(const Op& op) const {
+    __m512 lo = cvt_half_lo_to_float(values);
+    __m512 hi = cvt_half_hi_to_float(values);
+    return cvt_float_to_half(
+        op(Vectorized<float>(lo)), op(Vectorized<float>(hi)));
+  }
+
+  template <typename Op>
+  Vectorized<c10::Half> compare_as_fp32(
+      const Vectorized<c10::Half>& other,
+      const Op& op) const {
+    __m512 a_lo = cvt_half_lo_to_float(values);
+    __m512 a_hi = cvt_half_hi_to_float(values);
+    __m512 b_lo = cvt_half_lo_to_float(other.values);
+    __m512 b_hi = cvt_half_hi_to_float(other.values);
+    __mmask32 mask = static_cast<__mmask32>(op(a_lo, b_lo)) |
+        (static_cast<__mmask32>(op(a_hi, b_hi)) << 16);
+    return _mm512_movm_epi16(mask);
+  }
+
+ public:
+  using value_type = c10::Half;
+  using size_type = int;
+
+  static constexpr size_type size() {
+    return 32;
+  }
+
+  Vectorized() {}
+  Vectorized(__m512i v) : values(v) {}
+  Vectorized(c10::Half val) {
+    values = _mm512_set1_epi16(static_cast<short>(val.x));
+  }
+  template <
+      typename... Args,
+      typename = std::enable_if_t<(sizeof...(Args) == size())>>
+  Vectorized(Args... vals) {
+    __at_align__ c10::Half tmp[size()] = {static_cast<c10::Half>(vals)...};
+    values = _mm512_load_si512(reinterpret_cast<const __m512i*>(tmp));
+  }
+
+  operator __m512i() const {
+    return values;
+  }
+
+  template <int64_t mask>
+  static Vectorized<c10::Half> blend(
+      const Vectorized<c10::Half>& a,
+      const Vectorized<c10::Half>& b) {
+    return _mm512_mask_blend_epi16(
+        static_cast<__mmask32>(mask), a.values, b.values);
+  }
+
+  static Vectorized<c10::Half> blendv(
+      const Vectorized<c10::Half>& a,
+      const Vectorized<c10::Half>& b,
+      const Vectorized<c10::Half>& mask) {
+    __mmask32 k = _mm512_test_epi16_mask(mask.values, mask.values);
+    return _mm512_mask_blend_epi16(k, a.values, b.values);
+  }
+
+  template <typename step_t>
+  static Vectorized<c10::Half> arange(
+      c10::Half base = 0.f,
+      step_t step = static_cast<step_t>(1)) {
+    __at_align__ c10::Half tmp[size()];
+    for (int64_t i = 0; i < size(); ++i) {
+      tmp[i] = static_cast<float>(base) + i * step;
+    }
+    return loadu(tmp);
+  }
+
+  static Vectorized<c10::Half> set(
+      const Vectorized<c10::Half>& a,
+      const Vectorized<c10::Half>& b,
+      int64_t count = size()) {
+    __at_align__ c10::Half tmp[size()];
+    a.store(tmp);
+    b.store(tmp, count);
+    return loadu(tmp);
+  }
+
+  static Vectorized<c10::Half> loadu(
+      const void* ptr,
+      int64_t count = size()) {
+    if (count == size()) {
+      return _mm512_loadu_si512(ptr);
+    }
+    __mmask32 mask = static_cast<__mmask32>((1ULL << count) - 1);
+    return _mm512_maskz_loadu_epi16(mask, ptr);
+  }
+
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm512_storeu_si512(ptr, values);
+    } else if (count > 0) {
+      __mmask32 mask = static_cast<__mmask32>((1ULL << count) - 1);
+      _mm512_mask_storeu_epi16(ptr, mask, values);
+    }
+  }
+
+  const c10::Half& operator[](int idx) const = delete;
+  c10::Half& operator[](int idx) = delete;
+
+  int zero_mask() const {
+    // +0 and -0 both compare equal to zero
+    __m512i magnitude = _mm512_and_si512(values, _mm512_set1_epi16(0x7fff));
+    return static_cast<int>(
+        _mm512_cmpeq_epi16_mask(magnitude, _mm512_setzero_si512()));
+  }
+
+  Vectorized<c10::Half> isnan() const {
+    __m512i magnitude = _mm512_and_si512(values, _mm512_set1_epi16(0x7fff));
+    return _mm512_movm_epi16(
+        _mm512_cmpgt_epi16_mask(magnitude, _mm512_set1_epi16(0x7c00)));
+  }
+
+  Vectorized<c10::Half> map(c10::Half (*const f)(c10::Half)) const {
+    __at_align__ c10::Half tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); ++i) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+
+  Vectorized<c10::Half> abs() const {
+    return _mm512_and_si512(values, _mm512_set1_epi16(0x7fff));
+  }
+
+  Vectorized<c10::Half> neg() const {
+    return _mm512_xor_si512(
+        values, _mm512_set1_epi16(static_cast<short>(0x8000)));
+  }
+
+#define DEFINE_UNARY_OP(name)                                            \
+  Vectorized<c10::Half> name() const {                                   \
+    return unary_op_as_fp32(                                             \
+        [](const Vectorized<float>& x) { return x.name(); });            \
+  }
+
+  DEFINE_UNARY_OP(sqrt)
+  DEFINE_UNARY_OP(rsqrt)
+  DEFINE_UNARY_OP(reciprocal)
+  DEFINE_UNARY_OP(floor)
+  DEFINE_UNARY_OP(ceil)
+  DEFINE_UNARY_OP(round)
+  DEFINE_UNARY_OP(trunc)
+  DEFINE_UNARY_OP(exp)
+  DEFINE_UNARY_OP(log)
+  DEFINE_UNARY_OP(tanh)
+#undef DEFINE_UNARY_OP
+
+#define DEFINE_COMPARISON_OP(op, cmp)                                    \
+  Vectorized<c10::Half> operator op(const Vectorized<c10::Half>& other)  \
+      const {                                                            \
+    return compare_as_fp32(other, [](__m512 a, __m512 b) {               \
+      return _mm512_cmp_ps_mask(a, b, cmp);                              \
+    });                                                                  \
+  }
+
+  DEFINE_COMPARISON_OP(==, _CMP_EQ_OQ)
+  DEFINE_COMPARISON_OP(!=, _CMP_NEQ_UQ)
+  DEFINE_COMPARISON_OP(<, _CMP_LT_OQ)
+  DEFINE_COMPARISON_OP(<=, _CMP_LE_OQ)
+  DEFINE_COMPARISON_OP(>, _CMP_GT_OQ)
+  DEFINE_COMPARISON_OP(>=, _CMP_GE_OQ)
+#undef DEFINE_COMPARISON_OP
+
+#define DEFINE_BINARY_PREDICATE(name, op)                                \
+  Vectorized<c10::Half> name(const Vectorized<c10::Half>& other) const { \
+    /* 0x3c00 is 1.0 in half precision */                               \
+    return _mm512_and_si512(                                             \
+        (*this op other).values, _mm512_set1_epi16(0x3c00));             \
+  }
+
+  DEFINE_BINARY_PREDICATE(eq, ==)
+  DEFINE_BINARY_PREDICATE(ne, !=)
+  DEFINE_BINARY_PREDICATE(lt, <)
+  DEFINE_BINARY_PREDICATE(le, <=)
+  DEFINE_BINARY_PREDICATE(gt, >)
+  DEFINE_BINARY_PREDICATE(ge, >=)
+#undef DEFINE_BINARY_PREDICATE
+};
+
+template <typename Op>
+inline Vectorized<c10::Half> binary_op_as_fp32(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& b,
+    const Op& op) {
+  __m512 a_lo = cvt_half_lo_to_float(a);
+  __m512 a_hi = cvt_half_hi_to_float(a);
+  __m512 b_lo = cvt_half_lo_to_float(b);
+  __m512 b_hi = cvt_half_hi_to_float(b);
+  return cvt_float_to_half(
+      op(Vectorized<float>(a_lo), Vectorized<float>(b_lo)),
+      op(Vectorized<float>(a_hi), Vectorized<float>(b_hi)));
+}
+
+#define DEFINE_HALF_BINARY_OP(op_decl, expr)                             \
+  template <>                                                            \
+  Vectorized<c10::Half> inline op_decl(                                  \
+      const Vectorized<c10::Half>& a, const Vectorized<c10::Half>& b) {  \
+    return binary_op_as_fp32(                                            \
+        a, b, [](const Vectorized<float>& x, const Vectorized<float>& y) { \
+          return expr;                                                   \
+        });                                                              \
+  }
+
+DEFINE_HALF_BINARY_OP(operator+, x + y)
+DEFINE_HALF_BINARY_OP(operator-, x - y)
+DEFINE_HALF_BINARY_OP(operator*, x * y)
+DEFINE_HALF_BINARY_OP(operator/, x / y)
+DEFINE_HALF_BINARY_OP(maximum, maximum(x, y))
+DEFINE_HALF_BINARY_OP(minimum, minimum(x, y))
+DEFINE_HALF_BINARY_OP(clamp_min, clamp_min(x, y))
+DEFINE_HALF_BINARY_OP(clamp_max, clamp_max(x, y))
+#undef DEFINE_HALF_BINARY_OP
+
+template <>
+Vectorized<c10::Half> inline operator&(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& b) {
+  return _mm512_and_si512(a, b);
+}
+
+template <>
+Vectorized<c10::Half> inline operator|(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& b) {
+  return _mm512_or_si512(a, b);
+}
+
+template <>
+Vectorized<c10::Half> inline operator^(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& b) {
+  return _mm512_xor_si512(a, b);
+}
+
+template <>
+Vectorized<c10::Half> inline clamp(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& min,
+    const Vectorized<c10::Half>& max) {
+  return clamp_max(clamp_min(a, min), max);
+}
+
+// fused in float, so only the final result is rounded to half
+template <>
+Vectorized<c10::Half> inline fmadd(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& b,
+    const Vectorized<c10::Half>& c) {
+  return cvt_float_to_half(
+      _mm512_fmadd_ps(
+          cvt_half_lo_to_float(a),
+          cvt_half_lo_to_float(b),
+          cvt_half_lo_to_float(c)),
+      _mm512_fmadd_ps(
+          cvt_half_hi_to_float(a),
+          cvt_half_hi_to_float(b),
+          cvt_half_hi_to_float(c)));
+}
+
+template <>
+Vectorized<c10::Half> inline fmsub(
+    const Vectorized<c10::Half>& a,
+    const Vectorized<c10::Half>& b,
+    const Vectorized<c10::Half>& c) {
+  return cvt_float_to_half(
+      _mm512_fmsub_ps(
+          cvt_half_lo_to_float(a),
+          cvt_half_lo_to_float(b),
+          cvt_half_lo_to_float(c)),
+      _mm512_fmsub_ps(
+          cvt_half_hi_to_float(a),
+          cvt_half_hi_to_float(b),
+          cvt_half_hi_to_float(c)));
+}
+
+inline std::tuple<Vectorized<float>, Vectorized<float>> convert_half_float(
+    const Vectorized<c10::Half>& a) {
+  return std::make_tuple(
+      Vectorized<float>(cvt_half_lo_to_float(a)),
+      Vectorized<float>(cvt_half_hi_to_float(a)));
+}
+
+inline Vectorized<c10::Half> convert_float_half(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b) {
+  return cvt_float_to_half(a, b);
+}
+
+inline Vectorized<float> load_fp32_from_fp16(const c10::Half* data) {
+  return _mm512_cvtph_ps(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)));
+}
+
+template <>
+inline void convert(const c10::Half* src, float* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i <= n - Vectorized<float>::size(); i += Vectorized<float>::size()) {
+    _mm512_storeu_ps(dst + i, load_fp32_from_fp16(src + i));
+  }
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const float* src, c10::Half* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i <= n - Vectorized<float>::size(); i += Vectorized<float>::size()) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i),
+        _mm512_cvtps_ph(
+            _mm512_loadu_ps(src + i),
+            (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)));
+  }
+  for (; i < n; i++) {
+    dst[i] = c10::Half(src[i]);
+  }
+}
+
+#endif // defined(CPU_CAPABILITY_AVX512)
+
+} // namespace CPU_CAPABILITY
+} // namespace at::vec
@@ -0,0 +1,435 @@
+#pragma once
+
+#include <ATen/cpu/vec/intrinsics.h>
+#include <ATen/cpu/vec/vec_base.h>
+
+namespace at::vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+// Shared implementation of the signed integer vectors and of uint8, all of
+// which are a single __m512i. Comparisons produce mask registers which are
+// expanded to all-bits vectors; only 8-bit multiplication and integer
+// division fall back to per-lane code.
+template <typename T>
+class Vectorized512i {
+  static_assert(
+      std::is_same_v<T, int64_t> || std::is_same_v<T, int32_t> ||
+      std::is_same_v<T, int16_t> || std::is_same_v<T, int8_t> ||
+      std::is_same_v<T, uint8_t>);
+
+ protected:
+  __m512i values;
+
+ public:
+  using value_type = T;
+  using size_type = int;
+  // one bit per element
+  using mask_t = std::conditional_t<
+      sizeof(T) == 1,
+      __mmask64,
+      std::conditional_t<
+          sizeof(T) == 2,
+          __mmask32,
+          std::conditional_t<sizeof(T) == 4, __mmask16, __mmask8>>>;
+
+  static constexpr size_type size() {
+    return 64 / sizeof(T);
+  }
+
+  Vectorized512i() {}
+  Vectorized512i(__m512i v) : values(v) {}
+  Vectorized512i(T val) {
+    if constexpr (sizeof(T) == 8) {
+      values = _mm512_set1_epi64(val);
+    } else if constexpr (sizeof(T) == 4) {
+      values = _mm512_set1_epi32(val);
+    } else if constexpr (sizeof(T) == 2) {
+      values = _mm512_set1_epi16(val);
+    } else {
+      values = _mm512_set1_epi8(static_cast<char>(val));
+    }
+  }
+  template <
+      typename... Args,
+      typename = std::enable_if_t<(sizeof...(Args) == size())>>
+  Vectorized512i(Args... vals) {
+    __at_align__ T tmp[size()] = {static_cast<T>(vals)...};
+    values = _mm512_load_si512(tmp);
+  }
+
+  operator __m512i() const {
+    return values;
+  }
+
+  static mask_t first_n_mask(int64_t count) {
+    return count >= size() ? static_cast<mask_t>(~mask_t(0))
+                           : static_cast<mask_t>((1ULL << count) - 1);
+  }
+
+  static __m512i mask_blend(mask_t mask, __m512i a, __m512i b) {
+    if constexpr (sizeof(T) == 8) {
+      return _mm512_mask_blend_epi64(mask, a, b);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm512_mask_blend_epi32(mask, a, b);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm512_mask_blend_epi16(mask, a, b);
+    } else {
+      return _mm512_mask_blend_epi8(mask, a, b);
+    }
+  }
+
+  static __m512i mask_to_vector(mask_t mask) {
+    if constexpr (sizeof(T) == 8) {
+      return _mm512_movm_epi64(mask);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm512_movm_epi32(mask);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm512_movm_epi16(mask);
+    } else {
+      return _mm512_movm_epi8(mask);
+    }
+  }
+
+  static mask_t vector_to_mask(__m512i v) {
+    if constexpr (sizeof(T) == 8) {
+      return _mm512_test_epi64_mask(v, v);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm512_test_epi32_mask(v, v);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm512_test_epi16_mask(v, v);
+    } else {
+      return _mm512_test_epi8_mask(v, v);
+    }
+  }
+
+  template <int64_t mask>
+  static Vectorized<T> blend(const Vectorized<T>& a, const Vectorized<T>& b) {
+    return mask_blend(static_cast<mask_t>(mask), a, b);
+  }
+
+  static Vectorized<T> blendv(
+      const Vectorized<T>& a,
+      const Vectorized<T>& b,
+      const Vectorized<T>& mask) {
+    return mask_blend(vector_to_mask(mask), a, b);
+  }
+
+  template <typename step_t>
+  static Vectorized<T> arange(
+      T base = 0,
+      step_t step = static_cast<step_t>(1)) {
+    __at_align__ T tmp[size()];
+    for (int64_t i = 0; i < size(); ++i) {
+      tmp[i] = static_cast<T>(base + i * step);
+    }
+    return loadu(tmp);
+  }
+
+  static Vectorized<T> set(
+      const Vectorized<T>& a,
+      const Vectorized<T>& b,
+      int64_t count = size()) {
+    return mask_blend(first_n_mask(count), a, b);
+  }
+
+  // masked loads and stores do not touch memory past `count`
+  static Vectorized<T> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size()) {
+      return _mm512_loadu_si512(ptr);
+    }
+    mask_t mask = first_n_mask(count);
+    if constexpr (sizeof(T) == 8) {
+      return _mm512_maskz_loadu_epi64(mask, ptr);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm512_maskz_loadu_epi32(mask, ptr);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm512_maskz_loadu_epi16(mask, ptr);
+    } else {
+      return _mm512_maskz_loadu_epi8(mask, ptr);
+    }
+  }
+
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm512_storeu_si512(ptr, values);
+      return;
+    }
+    if (count <= 0) {
+      return;
+    }
+    mask_t mask = first_n_mask(count);
+    if constexpr (sizeof(T) == 8) {
+      _mm512_mask_storeu_epi64(ptr, mask, values);
+    } else if constexpr (sizeof(T) == 4) {
+      _mm512_mask_storeu_epi32(ptr, mask, values);
+    } else if constexpr (sizeof(T) == 2) {
+      _mm512_mask_storeu_epi16(ptr, mask, values);
+    } else {
+      _mm512_mask_storeu_epi8(ptr, mask, values);
+    }
+  }
+
+  const T& operator[](int idx) const = delete;
+  T& operator[](int idx) = delete;
+
+  // like the generic version, only the first 32 elements are reported
+  int zero_mask() const {
+    return static_cast<int>(
+        cmp_mask<_MM_CMPINT_EQ>(values, _mm512_setzero_si512()));
+  }
+
+  Vectorized<T> isnan() const {
+    return _mm512_setzero_si512();
+  }
+
+  Vectorized<T> map(T (*const f)(T)) const {
+    __at_align__ T tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); ++i) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+
+  Vectorized<T> abs() const {
+    if constexpr (std::is_same_v<T, uint8_t>) {
+      return values;
+    } else if constexpr (sizeof(T) == 8) {
+      return _mm512_abs_epi64(values);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm512_abs_epi32(values);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm512_abs_epi16(values);
+    } else {
+      return _mm512_abs_epi8(values);
+    }
+  }
+
+  Vectorized<T> neg() const {
+    return sub(_mm512_setzero_si512(), values);
+  }
+
+  Vectorized<T> reciprocal() const {
+    return map([](T x) -> T { return static_cast<T>(1) / x; });
+  }
+
+#define DEFINE_COMPARISON_OP(op, cmp)                                    \
+  Vectorized<T> operator op(const Vectorized<T>& other) const {          \
+    return mask_to_vector(cmp_mask<cmp>(values, other));                 \
+  }
+
+  DEFINE_COMPARISON_OP(==, _MM_CMPINT_EQ)
+  DEFINE_COMPARISON_OP(!=, _MM_CMPINT_NE)
+  DEFINE_COMPARISON_OP(<, _MM_CMPINT_LT)
+  DEFINE_COMPARISON_OP(<=, _MM_CMPINT_LE)
+  DEFINE_COMPARISON_OP(>, _MM_CMPINT_NLE)
+  DEFINE_COMPARISON_OP(>=, _MM_CMPINT_NLT)
+#undef DEFINE_COMPARISON_OP
+
+#define DEFINE_BINARY_PREDICATE(name, cmp)                               \
+  Vectorized<T> name(const Vectorized<T>& other) const {                 \
+    return mask_blend(                                                   \
+        cmp_mask<cmp>(values, other),                                    \
+        _mm512_setzero_si512(),                                          \
+        static_cast<__m512i>(Vectorized<T>(T(1))));                      \
+  }
+
+  DEFINE_BINARY_PREDICATE(eq, _MM_CMPINT_EQ)
+  DEFINE_BINARY_PREDICATE(ne, _MM_CMPINT_NE)
+  DEFINE_BINARY_PREDICATE(lt, _MM_CMPINT_LT)
+  DEFINE_BINARY_PREDICATE(le, _MM_CMPINT_LE)
+  DEFINE_BINARY_PREDICATE(gt, _MM_CMPINT_NLE)
+  DEFINE_BINARY_PREDICATE(ge, _MM_CMPINT_NLT)
+#undef DEFINE_BINARY_PREDICATE
+
+  static __m512i add(__m512i a, __m512i b) {
+    if constexpr (sizeof(T) == 8) {
+      return _mm512_add_epi64(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm512_add_epi32(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm512_add_epi16(a, b);
+    } else {
+      return _mm512_add_epi8(a, b);
+    }
+  }
+
+  static __m512i sub(__m512i a, __m512i b) {
+    if constexpr (sizeof(T) == 8) {
+      return _mm512_sub_epi64(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm512_sub_epi32(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm512_sub_epi16(a, b);
+    } else {
+      return _mm512_sub_epi8(a, b);
+    }
+  }
+
+  static __m512i mul(__m512i a, __m512i b) {
+    if constexpr (sizeof(T) == 8) {
+      return _mm512_mullo_epi64(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm512_mullo_epi32(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm512_mullo_epi16(a, b);
+    } else {
+      return binary_map(a, b, [](T x, T y) -> T { return x * y; });
+    }
+  }
+
+  static __m512i max(__m512i a, __m512i b) {
+    if constexpr (std::is_same_v<T, uint8_t>) {
+      return _mm512_max_epu8(a, b);
+    } else if constexpr (sizeof(T) == 8) {
+      return _mm512_max_epi64(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm512_max_epi32(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm512_max_epi16(a, b);
+    } else {
+      return _mm512_max_epi8(a, b);
+    }
+  }
+
+  static __m512i min(__m512i a, __m512i b) {
+    if constexpr (std::is_same_v<T, uint8_t>) {
+      return _mm512_min_epu8(a, b);
+    } else if constexpr (sizeof(T) == 8) {
+      return _mm512_min_epi64(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm512_min_epi32(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm512_min_epi16(a, b);
+    } else {
+      return _mm512_min_epi8(a, b);
+    }
+  }
+
+  template <typename Op>
+  static __m512i binary_map(__m512i a, __m512i b, const Op& op) {
+    __at_align__ T a_values[size()];
+    __at_align__ T b_values[size()];
+    _mm512_store_si512(a_values, a);
+    _mm512_store_si512(b_values, b);
+    for (int64_t i = 0; i < size(); ++i) {
+      a_values[i] = op(a_values[i], b_values[i]);
+    }
+    return _mm512_load_si512(a_values);
+  }
+
+ private:
+  // the predicate is an immediate operand, hence the template
+  template <int cmp>
+  static mask_t cmp_mask(__m512i a, __m512i b) {
+    if constexpr (std::is_same_v<T, uint8_t>) {
+      return _mm512_cmp_epu8_mask(a, b, cmp);
+    } else if constexpr (sizeof(T) == 8) {
+      return _mm512_cmp_epi64_mask(a, b, cmp);
+    } else if constexpr (sizeof(T) == 4) {
+      return _mm512_cmp_epi32_mask(a, b, cmp);
+    } else if constexpr (sizeof(T) == 2) {
+      return _mm512_cmp_epi16_mask(a, b, cmp);
+    } else {
+      return _mm512_cmp_epi8_mask(a, b, cmp);
+    }
+  }
+};
+
+#define DEFINE_VEC512_INT(T)                                               \
+  template <>                                                              \
+  class Vectorized<T> : public Vectorized512i<T> {                         \
+   public:                                                                 \
+    using Vectorized512i<T>::Vectorized512i;                               \
+    Vectorized() {}                                                        \
+  };                                                                       \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator+(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return Vectorized512i<T>::add(a, b);                                   \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator-(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return Vectorized512i<T>::sub(a, b);                                   \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator*(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return Vectorized512i<T>::mul(a, b);                                   \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator/(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return Vectorized512i<T>::binary_map(                                  \
+        a, b, [](T x, T y) -> T { return x / y; });                        \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator&(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return _mm512_and_si512(a, b);                                         \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator|(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return _mm512_or_si512(a, b);                                          \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline operator^(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return _mm512_xor_si512(a, b);                                         \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline maximum(                                            \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return Vectorized512i<T>::max(a, b);                                   \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline minimum(                                            \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return Vectorized512i<T>::min(a, b);                                   \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline clamp(                                              \
+      const Vectorized<T>& a,                                              \
+      const Vectorized<T>& min_vec,                                        \
+      const Vectorized<T>& max_vec) {                                      \
+    return Vectorized512i<T>::min(                                         \
+        max_vec, Vectorized512i<T>::max(min_vec, a));                      \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline clamp_min(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& min_vec) {              \
+    return Vectorized512i<T>::max(min_vec, a);                             \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  Vectorized<T> inline clamp_max(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& max_vec) {              \
+    return Vectorized512i<T>::min(max_vec, a);                             \
+  }
+
+DEFINE_VEC512_INT(int64_t)
+DEFINE_VEC512_INT(int32_t)
+DEFINE_VEC512_INT(int16_t)
+DEFINE_VEC512_INT(int8_t)
+DEFINE_VEC512_INT(uint8_t)
+#undef DEFINE_VEC512_INT
+
+#endif // defined(CPU_CAPABILITY_AVX512)
+
+} // namespace CPU_CAPABILITY
+} // namespace at::vec
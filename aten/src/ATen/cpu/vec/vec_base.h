@@ -0,0 +1,488 @@
+#pragma once
+
+// Generic Vectorized<T>: a fixed-width vector of T implemented with plain
+// arrays and loops. It defines the interface that the ISA specializations in
+// vec256/ and vec512/ implement with intrinsics, and it is what every
+// kernel uses on capabilities (or element types) without a specialization;
+// the compiler is usually able to auto-vectorize its loops.
+//
+// Everything lives in the inline namespace CPU_CAPABILITY, which is DEFAULT,
+// AVX2 or AVX512 depending on the flags the including file is built with,
+// so that the same kernel source can be compiled once per ISA and linked
+// into one binary without ODR clashes.
+
+#include <ATen/cpu/vec/intrinsics.h>
+#include <c10/core/ScalarType.h>
+#include <c10/util/BFloat16.h>
+#include <c10/util/Half.h>
+#include <c10/util/Macros.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+
+#ifndef CPU_CAPABILITY
+#define CPU_CAPABILITY DEFAULT
+#endif
+
+#if defined(CPU_CAPABILITY_AVX512)
+#define VECTOR_WIDTH 64
+#else
+#define VECTOR_WIDTH 32
+#endif
+
+#define __at_align__ alignas(64)
+
+namespace at::vec {
+
+inline namespace CPU_CAPABILITY {
+
+template <typename T>
+struct is_floating_point
+    : std::integral_constant<
+          bool,
+          std::is_floating_point_v<T> || std::is_same_v<T, c10::Half>> {};
+
+template <typename T>
+constexpr bool is_floating_point_v = is_floating_point<T>::value;
+
+template <class T>
+struct Vectorized {
+ private:
+  __at_align__ T values[VECTOR_WIDTH / sizeof(T)];
+
+ public:
+  using value_type = T;
+  using size_type = int;
+
+  static constexpr size_type size() {
+    return VECTOR_WIDTH / sizeof(T);
+  }
+
+  Vectorized() : values{static_cast<T>(0)} {}
+
+  Vectorized(T val) {
+    for (int i = 0; i < size(); ++i) {
+      values[i] = val;
+    }
+  }
+
+  template <
+      typename... Args,
+      typename = std::enable_if_t<(sizeof...(Args) == size())>>
+  Vectorized(Args... vals) : values{vals...} {}
+
+  // bit i of mask selects b[i] over a[i]
+  template <int64_t mask>
+  static Vectorized<T> blend(const Vectorized<T>& a, const Vectorized<T>& b) {
+    Vectorized vector;
+    for (int64_t i = 0; i < size(); ++i) {
+      vector.values[i] = (mask & (int64_t(1) << i)) ? b[i] : a[i];
+    }
+    return vector;
+  }
+
+  // picks b[i] where mask[i] has all bits set (as produced by the
+  // comparison operators) and a[i] where it is zero
+  static Vectorized<T> blendv(
+      const Vectorized<T>& a,
+      const Vectorized<T>& b,
+      const Vectorized<T>& mask) {
+    Vectorized vector;
+    int_same_size_t<T> buffer[size()];
+    mask.store(buffer);
+    for (int64_t i = 0; i < size(); ++i) {
+      vector.values[i] = buffer[i] != 0 ? b[i] : a[i];
+    }
+    return vector;
+  }
+
+  // base, base + step, base + 2 * step, ...
+  template <typename step_t>
+  static Vectorized<T> arange(
+      T base = static_cast<T>(0),
+      step_t step = static_cast<step_t>(1)) {
+    Vectorized vector;
+    for (int64_t i = 0; i < size(); ++i) {
+      vector.values[i] = static_cast<T>(base + static_cast<T>(i * step));
+    }
+    return vector;
+  }
+
+  // the first `count` elements of b followed by the rest of a
+  static Vectorized<T> set(
+      const Vectorized<T>& a,
+      const Vectorized<T>& b,
+      int64_t count = size()) {
+    Vectorized vector;
+    for (int64_t i = 0; i < size(); ++i) {
+      vector.values[i] = i < count ? b[i] : a[i];
+    }
+    return vector;
+  }
+
+  static Vectorized<T> loadu(const void* ptr) {
+    Vectorized vector;
+    std::memcpy(vector.values, ptr, VECTOR_WIDTH);
+    return vector;
+  }
+
+  // loads `count` elements, the remaining lanes are zero
+  static Vectorized<T> loadu(const void* ptr, int64_t count) {
+    Vectorized vector;
+    std::memcpy(vector.values, ptr, count * sizeof(T));
+    return vector;
+  }
+
+  void store(void* ptr, int count = size()) const {
+    std::memcpy(ptr, values, count * sizeof(T));
+  }
+
+  const T& operator[](int idx) const {
+    return values[idx];
+  }
+
+  T& operator[](int idx) {
+    return values[idx];
+  }
+
+  // bit i is set if element i is zero; vectors of more than 32 elements
+  // only report the first 32
+  int zero_mask() const {
+    uint64_t mask = 0;
+    for (int i = 0; i < size(); ++i) {
+      if (values[i] == static_cast<T>(0)) {
+        mask |= (uint64_t(1) << i);
+      }
+    }
+    return static_cast<int>(mask);
+  }
+
+  Vectorized<T> isnan() const {
+    Vectorized<T> vector;
+    for (int64_t i = 0; i < size(); ++i) {
+      if (_isnan(values[i])) {
+        std::memset(static_cast<void*>(vector.values + i), 0xFF, sizeof(T));
+      } else {
+        std::memset(static_cast<void*>(vector.values + i), 0, sizeof(T));
+      }
+    }
+    return vector;
+  }
+
+  Vectorized<T> map(T (*const f)(T)) const {
+    Vectorized<T> ret;
+    for (int64_t i = 0; i < size(); ++i) {
+      ret[i] = f(values[i]);
+    }
+    return ret;
+  }
+
+  Vectorized<T> map(T (*const f)(const T&)) const {
+    Vectorized<T> ret;
+    for (int64_t i = 0; i < size(); ++i) {
+      ret[i] = f(values[i]);
+    }
+    return ret;
+  }
+
+  Vectorized<T> abs() const {
+    if constexpr (std::is_unsigned_v<T> || std::is_same_v<T, bool>) {
+      return *this;
+    } else {
+      return map([](T x) -> T {
+        return x < static_cast<T>(0) ? static_cast<T>(-x) : x;
+      });
+    }
+  }
+
+  Vectorized<T> neg() const {
+    return map([](T x) -> T { return -x; });
+  }
+
+  // unary math functions, computed in float (double for double)
+#define DEFINE_UNARY_MATH_OP(name, fn)                             \
+  Vectorized<T> name() const {                                     \
+    return map([](T x) -> T { return fn(static_cast<compute_t<T>>(x)); }); \
+  }
+
+  DEFINE_UNARY_MATH_OP(sqrt, std::sqrt)
+  DEFINE_UNARY_MATH_OP(exp, std::exp)
+  DEFINE_UNARY_MATH_OP(log, std::log)
+  DEFINE_UNARY_MATH_OP(tanh, std::tanh)
+  DEFINE_UNARY_MATH_OP(floor, std::floor)
+  DEFINE_UNARY_MATH_OP(ceil, std::ceil)
+  // rounds half to even, like the SIMD rounding instructions
+  DEFINE_UNARY_MATH_OP(round, std::nearbyint)
+  DEFINE_UNARY_MATH_OP(trunc, std::trunc)
+#undef DEFINE_UNARY_MATH_OP
+
+  Vectorized<T> rsqrt() const {
+    return map([](T x) -> T {
+      return 1 / std::sqrt(static_cast<compute_t<T>>(x));
+    });
+  }
+
+  Vectorized<T> reciprocal() const {
+    return map([](T x) -> T { return static_cast<T>(1) / x; });
+  }
+
+#define DEFINE_COMPARISON_OP(op)                                   \
+  Vectorized<T> operator op(const Vectorized<T>& other) const {    \
+    Vectorized<T> vector;                                          \
+    for (int64_t i = 0; i < size(); ++i) {                         \
+      std::memset(                                                 \
+          static_cast<void*>(vector.values + i),                   \
+          values[i] op other.values[i] ? 0xFF : 0,                 \
+          sizeof(T));                                              \
+    }                                                              \
+    return vector;                                                 \
+  }
+
+  // comparisons return masks: all bits set where true, zero where false
+  DEFINE_COMPARISON_OP(==)
+  DEFINE_COMPARISON_OP(!=)
+  DEFINE_COMPARISON_OP(<)
+  DEFINE_COMPARISON_OP(<=)
+  DEFINE_COMPARISON_OP(>)
+  DEFINE_COMPARISON_OP(>=)
+#undef DEFINE_COMPARISON_OP
+
+  // Going through the mask rather than converting the bool directly also
+  // sidesteps a GCC 12 AVX-512 miscompilation of constant-folded unsigned
+  // 64-bit comparisons.
+#define DEFINE_BINARY_PREDICATE(name, op)                          \
+  Vectorized<T> name(const Vectorized<T>& other) const {           \
+    return (*this op other) & Vectorized<T>(static_cast<T>(1));    \
+  }
+
+  // element-wise predicates returning 1 or 0
+  DEFINE_BINARY_PREDICATE(eq, ==)
+  DEFINE_BINARY_PREDICATE(ne, !=)
+  DEFINE_BINARY_PREDICATE(lt, <)
+  DEFINE_BINARY_PREDICATE(le, <=)
+  DEFINE_BINARY_PREDICATE(gt, >)
+  DEFINE_BINARY_PREDICATE(ge, >=)
+#undef DEFINE_BINARY_PREDICATE
+
+ private:
+  // an integer type of the same width as T, for reading masks
+  template <typename U>
+  using int_same_size_t = std::conditional_t<
+      sizeof(U) == 1,
+      int8_t,
+      std::conditional_t<
+          sizeof(U) == 2,
+          int16_t,
+          std::conditional_t<sizeof(U) == 4, int32_t, int64_t>>>;
+
+  // the type transcendental functions are computed in
+  template <typename U>
+  using compute_t =
+      std::conditional_t<std::is_same_v<U, double>, double, float>;
+
+  static bool _isnan(T val) {
+    if constexpr (is_floating_point_v<T>) {
+      return std::isnan(static_cast<compute_t<T>>(val));
+    } else {
+      return false;
+    }
+  }
+};
+
+#define DEFINE_ELEMENTWISE_OP(op)                                   \
+  template <class T>                                                \
+  Vectorized<T> inline operator op(                                 \
+      const Vectorized<T>& a, const Vectorized<T>& b) {             \
+    Vectorized<T> c;                                                \
+    for (int i = 0; i != Vectorized<T>::size(); i++) {              \
+      c[i] = a[i] op b[i];                                          \
+    }                                                               \
+    return c;                                                       \
+  }
+
+DEFINE_ELEMENTWISE_OP(+)
+DEFINE_ELEMENTWISE_OP(-)
+DEFINE_ELEMENTWISE_OP(*)
+DEFINE_ELEMENTWISE_OP(/)
+#undef DEFINE_ELEMENTWISE_OP
+
+// bitwise operations on the raw bytes, also for floating point vectors (where
+// they are used with masks)
+#define DEFINE_BITWISE_OP(op)                                       \
+  template <class T>                                                \
+  Vectorized<T> inline operator op(                                 \
+      const Vectorized<T>& a, const Vectorized<T>& b) {             \
+    constexpr int kWords = VECTOR_WIDTH / sizeof(uint32_t);         \
+    uint32_t a_words[kWords];                                       \
+    uint32_t b_words[kWords];                                       \
+    a.store(a_words);                                               \
+    b.store(b_words);                                               \
+    for (int i = 0; i < kWords; ++i) {                              \
+      a_words[i] = a_words[i] op b_words[i];                        \
+    }                                                               \
+    return Vectorized<T>::loadu(a_words);                           \
+  }
+
+DEFINE_BITWISE_OP(&)
+DEFINE_BITWISE_OP(|)
+DEFINE_BITWISE_OP(^)
+#undef DEFINE_BITWISE_OP
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN.
+template <class T>
+Vectorized<T> inline maximum(const Vectorized<T>& a, const Vectorized<T>& b) {
+  Vectorized<T> c;
+  for (int i = 0; i != Vectorized<T>::size(); i++) {
+    c[i] = (a[i] > b[i]) ? a[i] : b[i];
+    if constexpr (is_floating_point_v<T>) {
+      if (std::isnan(static_cast<float>(a[i]))) {
+        c[i] = a[i];
+      }
+    }
+  }
+  return c;
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN.
+template <class T>
+Vectorized<T> inline minimum(const Vectorized<T>& a, const Vectorized<T>& b) {
+  Vectorized<T> c;
+  for (int i = 0; i != Vectorized<T>::size(); i++) {
+    c[i] = (a[i] < b[i]) ? a[i] : b[i];
+    if constexpr (is_floating_point_v<T>) {
+      if (std::isnan(static_cast<float>(a[i]))) {
+        c[i] = a[i];
+      }
+    }
+  }
+  return c;
+}
+
+template <class T>
+Vectorized<T> inline clamp(
+    const Vectorized<T>& a,
+    const Vectorized<T>& min_vec,
+    const Vectorized<T>& max_vec) {
+  Vectorized<T> c;
+  for (int i = 0; i != Vectorized<T>::size(); i++) {
+    c[i] = std::min(std::max(a[i], min_vec[i]), max_vec[i]);
+  }
+  return c;
+}
+
+template <class T>
+Vectorized<T> inline clamp_min(
+    const Vectorized<T>& a,
+    const Vectorized<T>& min_vec) {
+  Vectorized<T> c;
+  for (int i = 0; i != Vectorized<T>::size(); i++) {
+    c[i] = a[i] < min_vec[i] ? min_vec[i] : a[i];
+  }
+  return c;
+}
+
+template <class T>
+Vectorized<T> inline clamp_max(
+    const Vectorized<T>& a,
+    const Vectorized<T>& max_vec) {
+  Vectorized<T> c;
+  for (int i = 0; i != Vectorized<T>::size(); i++) {
+    c[i] = a[i] > max_vec[i] ? max_vec[i] : a[i];
+  }
+  return c;
+}
+
+// a * b + c
+template <typename T>
+inline Vectorized<T> fmadd(
+    const Vectorized<T>& a,
+    const Vectorized<T>& b,
+    const Vectorized<T>& c) {
+  return a * b + c;
+}
+
+// a * b - c
+template <typename T>
+inline Vectorized<T> fmsub(
+    const Vectorized<T>& a,
+    const Vectorized<T>& b,
+    const Vectorized<T>& c) {
+  return a * b - c;
+}
+
+// element-wise conversion of n values, e.g. Half to float
+template <typename src_T, typename dst_T>
+inline void convert(const src_T* src, dst_T* dst, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    dst[i] = static_cast<dst_T>(src[i]);
+  }
+}
+
+// reinterpret the bits of a vector as another element type of the same width
+template <typename dst_t, typename src_t>
+inline Vectorized<dst_t> cast(const Vectorized<src_t>& src) {
+  static_assert(sizeof(Vectorized<dst_t>) == sizeof(Vectorized<src_t>));
+  __at_align__ char buffer[VECTOR_WIDTH];
+  src.store(buffer);
+  return Vectorized<dst_t>::loadu(buffer);
+}
+
+// A Vectorized<Half> holds twice as many lanes as a Vectorized<float>; the
+// conversions below split it into (and build it from) its lower and upper
+// half. The AVX2 and AVX-512 headers provide F16C versions, and vectorized
+// versions of the BFloat16 loads.
+#if !defined(CPU_CAPABILITY_AVX2) && !defined(CPU_CAPABILITY_AVX512)
+
+inline std::tuple<Vectorized<float>, Vectorized<float>> convert_half_float(
+    const Vectorized<c10::Half>& a) {
+  constexpr int64_t kSize = Vectorized<float>::size();
+  __at_align__ float arr[2 * kSize];
+  for (int64_t i = 0; i < 2 * kSize; ++i) {
+    arr[i] = static_cast<float>(a[i]);
+  }
+  return std::make_tuple(
+      Vectorized<float>::loadu(arr), Vectorized<float>::loadu(arr + kSize));
+}
+
+inline Vectorized<c10::Half> convert_float_half(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b) {
+  constexpr int64_t kSize = Vectorized<float>::size();
+  Vectorized<c10::Half> result;
+  for (int64_t i = 0; i < kSize; ++i) {
+    result[i] = c10::Half(a[i]);
+    result[i + kSize] = c10::Half(b[i]);
+  }
+  return result;
+}
+
+// loads Vectorized<float>::size() halves widened to float
+inline Vectorized<float> load_fp32_from_fp16(const c10::Half* data) {
+  Vectorized<float> result;
+  for (int64_t i = 0; i < Vectorized<float>::size(); ++i) {
+    result[i] = static_cast<float>(data[i]);
+  }
+  return result;
+}
+
+// loads Vectorized<float>::size() bfloat16s widened to float
+inline Vectorized<float> load_fp32_from_bf16(const c10::BFloat16* data) {
+  Vectorized<float> result;
+  for (int64_t i = 0; i < Vectorized<float>::size(); ++i) {
+    result[i] = static_cast<float>(data[i]);
+  }
+  return result;
+}
+
+#endif
+
+} // namespace CPU_CAPABILITY
+
+} // namespace at::vec
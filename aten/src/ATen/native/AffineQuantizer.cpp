@@ -0,0 +1,132 @@
+#include <ATen/native/AffineQuantizer.h>
+
+namespace at::native {
+
+DEFINE_DISPATCH(quantize_tensor_per_tensor_affine_stub);
+DEFINE_DISPATCH(quantize_tensor_per_channel_affine_stub);
+DEFINE_DISPATCH(dequantize_tensor_per_tensor_affine_stub);
+DEFINE_DISPATCH(dequantize_tensor_per_channel_affine_stub);
+
+namespace {
+
+void check_operands(
+    const char* name,
+    const Tensor& rtensor,
+    const Tensor& qtensor) {
+  TORCH_CHECK(
+      rtensor.scalar_type() == ScalarType::Float,
+      name,
+      ": expected a Float tensor, got ",
+      rtensor.scalar_type());
+  TORCH_CHECK(
+      qtensor.is_quantized(),
+      name,
+      ": expected a quantized tensor, got ",
+      qtensor.scalar_type());
+  TORCH_CHECK(
+      rtensor.sizes() == qtensor.sizes(),
+      name,
+      ": the tensors differ in sizes, ",
+      rtensor.sizes(),
+      " and ",
+      qtensor.sizes());
+  TORCH_CHECK(
+      rtensor.is_contiguous() and qtensor.is_contiguous(),
+      name,
+      ": expected contiguous tensors");
+}
+
+void check_channels(
+    const char* name,
+    const Tensor& qtensor,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis) {
+  TORCH_CHECK(
+      axis >= 0 and axis < qtensor.dim(),
+      name,
+      ": axis ",
+      axis,
+      " is out of range for a tensor of ",
+      qtensor.dim(),
+      " dims");
+  TORCH_CHECK(
+      scales.scalar_type() == ScalarType::Double and
+          zero_points.scalar_type() == ScalarType::Long,
+      name,
+      ": expected Double scales and Long zero points");
+  TORCH_CHECK(
+      scales.is_contiguous() and zero_points.is_contiguous() and
+          scales.numel() == qtensor.size(axis) and
+          zero_points.numel() == qtensor.size(axis),
+      name,
+      ": expected ",
+      qtensor.size(axis),
+      " contiguous scales and zero points");
+}
+
+} // namespace
+
+void quantize_tensor_per_tensor_affine(
+    const Tensor& rtensor,
+    const Tensor& qtensor,
+    double scale,
+    int64_t zero_point) {
+  check_operands("quantize_tensor_per_tensor_affine", rtensor, qtensor);
+  if (rtensor.numel() > 0) {
+    quantize_tensor_per_tensor_affine_stub(
+        kCPU, rtensor, qtensor, scale, zero_point);
+  }
+}
+
+void quantize_tensor_per_channel_affine(
+    const Tensor& rtensor,
+    const Tensor& qtensor,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis) {
+  check_operands("quantize_tensor_per_channel_affine", rtensor, qtensor);
+  check_channels(
+      "quantize_tensor_per_channel_affine",
+      qtensor,
+      scales,
+      zero_points,
+      axis);
+  if (rtensor.numel() > 0) {
+    quantize_tensor_per_channel_affine_stub(
+        kCPU, rtensor, qtensor, scales, zero_points, axis);
+  }
+}
+
+void dequantize_tensor_per_tensor_affine(
+    const Tensor& qtensor,
+    const Tensor& rtensor,
+    double scale,
+    int64_t zero_point) {
+  check_operands("dequantize_tensor_per_tensor_affine", rtensor, qtensor);
+  if (rtensor.numel() > 0) {
+    dequantize_tensor_per_tensor_affine_stub(
+        kCPU, qtensor, rtensor, scale, zero_point);
+  }
+}
+
+void dequantize_tensor_per_channel_affine(
+    const Tensor& qtensor,
+    const Tensor& rtensor,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis) {
+  check_operands("dequantize_tensor_per_channel_affine", rtensor, qtensor);
+  check_channels(
+      "dequantize_tensor_per_channel_affine",
+      qtensor,
+      scales,
+      zero_points,
+      axis);
+  if (rtensor.numel() > 0) {
+    dequantize_tensor_per_channel_affine_stub(
+        kCPU, qtensor, rtensor, scales, zero_points, axis);
+  }
+}
+
+} // namespace at::native
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <ATen/native/DispatchStub.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// Affine quantization of Float values to a quantized dtype T and back:
+//
+//   q = clamp(zero_point + round(x / scale), qmin, qmax)
+//   x = (q - zero_point) * scale
+//
+// with [qmin, qmax] the range of T::underlying and rounding half to even.
+// Like FBGEMM it is computed in float, multiplying by the float inverse of
+// the scale; quantize_val() and dequantize_val() are the reference the
+// vectorized kernels agree with to the bit. NaN quantizes to an unspecified
+// value.
+
+namespace at::native {
+
+template <typename T>
+T quantize_val(double scale, int64_t zero_point, float value) {
+  using underlying_t = typename T::underlying;
+  constexpr int64_t qmin = std::numeric_limits<underlying_t>::min();
+  constexpr int64_t qmax = std::numeric_limits<underlying_t>::max();
+  const float inv_scale = 1.0f / static_cast<float>(scale);
+  // clamped before the conversion to an integer, which must not overflow
+  const double rounded = std::clamp<double>(
+      std::nearbyint(value * inv_scale),
+      static_cast<double>(qmin - zero_point),
+      static_cast<double>(qmax - zero_point));
+  return T(static_cast<underlying_t>(
+      static_cast<int64_t>(rounded) + zero_point));
+}
+
+template <typename T>
+float dequantize_val(double scale, int64_t zero_point, T value) {
+  return static_cast<float>(static_cast<int64_t>(value.val_) - zero_point) *
+      static_cast<float>(scale);
+}
+
+// The kernels below fill qtensor (rtensor) from rtensor (qtensor), both
+// contiguous and of the same sizes, rtensor Float. Per channel, scales
+// (Double) and zero_points (Long) are contiguous with one value per index
+// along axis.
+
+TORCH_API void quantize_tensor_per_tensor_affine(
+    const Tensor& rtensor,
+    const Tensor& qtensor,
+    double scale,
+    int64_t zero_point);
+TORCH_API void quantize_tensor_per_channel_affine(
+    const Tensor& rtensor,
+    const Tensor& qtensor,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis);
+TORCH_API void dequantize_tensor_per_tensor_affine(
+    const Tensor& qtensor,
+    const Tensor& rtensor,
+    double scale,
+    int64_t zero_point);
+TORCH_API void dequantize_tensor_per_channel_affine(
+    const Tensor& qtensor,
+    const Tensor& rtensor,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis);
+
+using quantize_tensor_per_tensor_affine_fn = void (*)(
+    const Tensor& rtensor,
+    const Tensor& qtensor,
+    double scale,
+    int64_t zero_point);
+using quantize_tensor_per_channel_affine_fn = void (*)(
+    const Tensor& rtensor,
+    const Tensor& qtensor,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis);
+using dequantize_tensor_per_tensor_affine_fn = void (*)(
+    const Tensor& qtensor,
+    const Tensor& rtensor,
+    double scale,
+    int64_t zero_point);
+using dequantize_tensor_per_channel_affine_fn = void (*)(
+    const Tensor& qtensor,
+    const Tensor& rtensor,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis);
+
+DECLARE_DISPATCH(
+    quantize_tensor_per_tensor_affine_fn,
+    quantize_tensor_per_tensor_affine_stub);
+DECLARE_DISPATCH(
+    quantize_tensor_per_channel_affine_fn,
+    quantize_tensor_per_channel_affine_stub);
+DECLARE_DISPATCH(
+    dequantize_tensor_per_tensor_affine_fn,
+    dequantize_tensor_per_tensor_affine_stub);
+DECLARE_DISPATCH(
+    dequantize_tensor_per_channel_affine_fn,
+    dequantize_tensor_per_channel_affine_stub);
+
+} // namespace at::native
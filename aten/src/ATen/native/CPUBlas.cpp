@@ -0,0 +1,140 @@
+#include <ATen/Dispatch.h>
+#include <ATen/native/CPUBlas.h>
+#include <c10/cpu/CPUAllocator.h>
+
+namespace at::native::cpublas {
+
+DEFINE_DISPATCH(gemm_stub);
+DEFINE_DISPATCH(pack_b_stub);
+DEFINE_DISPATCH(qgemm_stub);
+
+namespace {
+
+// C = beta * C, without reading C if beta == 0
+template <typename scalar_t>
+void scale_c(const GemmParams& p) {
+  auto* c = static_cast<scalar_t*>(p.c);
+  for (int64_t i = 0; i < p.m; ++i) {
+    for (int64_t j = 0; j < p.n; ++j) {
+      scalar_t& x = c[i * p.c_row_stride + j * p.c_col_stride];
+      x = p.beta == 0 ? scalar_t(0)
+                      : static_cast<scalar_t>(p.beta * static_cast<double>(x));
+    }
+  }
+}
+
+void check_dtype(const char* name, c10::ScalarType dtype) {
+  TORCH_CHECK(
+      c10::isFloatingType(dtype),
+      name,
+      ": unsupported dtype ",
+      dtype);
+}
+
+} // namespace
+
+void gemm(const GemmParams& params) {
+  check_dtype("gemm", params.dtype);
+  TORCH_CHECK(
+      params.m >= 0 and params.n >= 0 and params.k >= 0,
+      "gemm: negative dimension in m = ",
+      params.m,
+      ", n = ",
+      params.n,
+      ", k = ",
+      params.k);
+  if (params.b_dtype != c10::ScalarType::Undefined) {
+    TORCH_CHECK(
+        c10::isFloat8Type(params.b_dtype) and !params.b_packed,
+        "gemm: B can only have a dtype of its own if it is a Float8 one and "
+        "not packed, got ",
+        params.b_dtype);
+  }
+  if (params.b_packed) {
+    const PackedB& b = *params.b_packed;
+    TORCH_CHECK(
+        b.dtype == params.dtype and b.k == params.k and b.n == params.n,
+        "gemm: B was packed as ",
+        b.dtype,
+        " ",
+        b.k,
+        "x",
+        b.n,
+        ", expected ",
+        params.dtype,
+        " ",
+        params.k,
+        "x",
+        params.n);
+  }
+  if (params.m == 0 or params.n == 0) {
+    return;
+  }
+  if (params.k == 0 or params.alpha == 0) {
+    AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+        params.dtype, "gemm_scale", [&] { scale_c<scalar_t>(params); });
+    return;
+  }
+  gemm_stub(c10::kCPU, params);
+}
+
+PackedB pack_b(const GemmParams& params) {
+  check_dtype("pack_b", params.dtype);
+  TORCH_CHECK(
+      params.b_dtype == c10::ScalarType::Undefined,
+      "pack_b: B must have the dtype of the product, got ",
+      params.b_dtype);
+  TORCH_CHECK(
+      params.k >= 0 and params.n >= 0,
+      "pack_b: negative dimension in k = ",
+      params.k,
+      ", n = ",
+      params.n);
+  PackedB packed;
+  packed.dtype = params.dtype;
+  packed.k = params.k;
+  packed.n = params.n;
+  packed.storage = params.k == 0 or params.n == 0
+      ? c10::Storage(
+            c10::Storage::use_byte_size_t{}, 0, c10::GetCPUAllocator())
+      : pack_b_stub(c10::kCPU, params);
+  return packed;
+}
+
+void qgemm(const QGemmParams& params) {
+  TORCH_CHECK(
+      params.m >= 0 and params.n >= 0 and params.k >= 0,
+      "qgemm: negative dimension in m = ",
+      params.m,
+      ", n = ",
+      params.n,
+      ", k = ",
+      params.k);
+  TORCH_CHECK(
+      params.k <= kQGemmMaxK,
+      "qgemm: k = ",
+      params.k,
+      " could overflow the int32 sums, at most ",
+      kQGemmMaxK,
+      " is supported");
+  TORCH_CHECK(
+      params.c_dtype == c10::ScalarType::Int or
+          params.c_dtype == c10::ScalarType::Byte,
+      "qgemm: C must be Int or Byte, got ",
+      params.c_dtype);
+  TORCH_CHECK(
+      params.a_zero_point >= 0 and params.a_zero_point <= 255,
+      "qgemm: the zero point of A is out of the range of uint8: ",
+      params.a_zero_point);
+  if (params.c_dtype == c10::ScalarType::Byte) {
+    TORCH_CHECK(
+        params.scales != nullptr and params.c_scale > 0,
+        "qgemm: a Byte C needs scales and a positive c_scale");
+  }
+  if (params.m == 0 or params.n == 0) {
+    return;
+  }
+  qgemm_stub(c10::kCPU, params);
+}
+
+} // namespace at::native::cpublas
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <ATen/native/DispatchStub.h>
+#include <c10/core/ScalarType.h>
+#include <c10/core/Storage.h>
+
+#include <cstdint>
+#include <limits>
+
+namespace at::native::cpublas {
+
+// C = alpha * A B + beta * C, with A m x k, B k x n and C m x n, each matrix
+// given by its data and the element strides of its rows and columns, so
+// that transposed and sliced views are read in place. With beta == 0, C is
+// only written and may hold anything (NaN included) beforehand.
+//
+// Supports Float, Double, Half and BFloat16; the latter two are multiplied
+// and accumulated in float and rounded once when C is written.
+//
+// B may also be stored in a Float8 type, b_dtype, and scaled by b_scale;
+// it is widened a block at a time while being packed, never as a whole.
+//
+// B may instead be given packed by pack_b(), see PackedB.
+struct PackedB;
+
+struct GemmParams {
+  c10::ScalarType dtype = c10::ScalarType::Float;
+  int64_t m = 0;
+  int64_t n = 0;
+  int64_t k = 0;
+  double alpha = 1;
+  double beta = 0;
+  const void* a = nullptr;
+  int64_t a_row_stride = 0;
+  int64_t a_col_stride = 0;
+  const void* b = nullptr;
+  int64_t b_row_stride = 0;
+  int64_t b_col_stride = 0;
+  // B's dtype if it is a Float8 one, Undefined for dtype
+  c10::ScalarType b_dtype = c10::ScalarType::Undefined;
+  // B's values are multiplied by it
+  double b_scale = 1;
+  // if set, used instead of b and its strides
+  const PackedB* b_packed = nullptr;
+  void* c = nullptr;
+  int64_t c_row_stride = 0;
+  int64_t c_col_stride = 0;
+};
+
+TORCH_API void gemm(const GemmParams& params);
+
+// A k x n B already in the blocked layout the gemm kernel packs B into
+// internally, so that products with a constant B (the weights of a layer)
+// skip packing it on every call. The layout belongs to the kernel of the
+// capability DispatchStub selected, and the storage is opaque.
+struct PackedB {
+  c10::ScalarType dtype = c10::ScalarType::Float;
+  int64_t k = 0;
+  int64_t n = 0;
+  c10::Storage storage;
+};
+
+// packs the B described by params.dtype, k, n, b and its strides, which
+// has dtype (b_dtype is Undefined)
+TORCH_API PackedB pack_b(const GemmParams& params);
+
+// called with k > 0 and alpha != 0, the other cases are handled by gemm()
+using gemm_fn = void (*)(const GemmParams& params);
+
+// called with k > 0 and n > 0
+using pack_b_fn = c10::Storage (*)(const GemmParams& params);
+
+DECLARE_DISPATCH(gemm_fn, gemm_stub);
+DECLARE_DISPATCH(pack_b_fn, pack_b_stub);
+
+// The 8-bit product of quantized tensors: A m x k of uint8 with zero point
+// a_zero_point, B k x n of int8 with a zero point per column, strided like
+// in GemmParams. The sums of (A - a_zero_point) (B - b_zero_points) are
+// computed exactly in int32, for k up to kQGemmMaxK, and then
+//
+// - with c_dtype Int, stored in C as they are;
+// - with c_dtype Byte, requantized: y = sum * scales[j] + bias[j] is
+//   quantized to uint8 with c_scale and c_zero_point (see quantize_val() in
+//   native/AffineQuantizer.h). scales[j] is the product of the scales of A
+//   and of column j of B; bias may be null.
+struct QGemmParams {
+  int64_t m = 0;
+  int64_t n = 0;
+  int64_t k = 0;
+  const uint8_t* a = nullptr;
+  int64_t a_row_stride = 0;
+  int64_t a_col_stride = 0;
+  int32_t a_zero_point = 0;
+  const int8_t* b = nullptr;
+  int64_t b_row_stride = 0;
+  int64_t b_col_stride = 0;
+  // n values
+  const int32_t* b_zero_points = nullptr;
+  c10::ScalarType c_dtype = c10::ScalarType::Int;
+  // n values each, for a Byte C
+  const float* scales = nullptr;
+  const float* bias = nullptr;
+  double c_scale = 1;
+  int32_t c_zero_point = 0;
+  void* c = nullptr;
+  int64_t c_row_stride = 0;
+  int64_t c_col_stride = 0;
+};
+
+// the largest k whose sums cannot overflow int32: each product of values
+// less the zero points is at most 255 * 255 in magnitude
+constexpr int64_t kQGemmMaxK = std::numeric_limits<int32_t>::max() / 65025;
+
+TORCH_API void qgemm(const QGemmParams& params);
+
+// called with m > 0 and n > 0
+using qgemm_fn = void (*)(const QGemmParams& params);
+
+DECLARE_DISPATCH(qgemm_fn, qgemm_stub);
+
+} // namespace at::native::cpublas
@@ -0,0 +1,815 @@
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/CPUBlas.h>
+#include <ATen/native/Convolution.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+namespace at::native {
+
+DEFINE_DISPATCH(depthwise_conv_stub);
+DEFINE_DISPATCH(winograd_conv_stub);
+
+const char* toString(ConvAlgorithm algorithm) {
+  switch (algorithm) {
+    case ConvAlgorithm::Im2col:
+      return "Im2col";
+    case ConvAlgorithm::Direct:
+      return "Direct";
+    case ConvAlgorithm::Winograd2x3:
+      return "Winograd2x3";
+    case ConvAlgorithm::Winograd4x3:
+      return "Winograd4x3";
+  }
+  return "UNKNOWN";
+}
+
+namespace {
+
+// im2col builds its patch matrix in blocks of about this many elements
+constexpr int64_t kMaxColumnElements = int64_t(1) << 21;
+
+// a patch matrix block has at least this many rows (channels-last) or
+// columns (contiguous), so that its GEMM is not too skinny
+constexpr int64_t kMinColumnBlock = 64;
+
+// the fewest 4x4 output tiles for which Winograd is picked
+constexpr int64_t kMinWinogradTiles = 128;
+
+// The operands of a convolution as 5-D tensors, see ConvParams.
+struct Conv5d {
+  Tensor input;
+  Tensor weight;
+  Tensor bias;
+  ConvParams params;
+  // of the caller's tensors: 1, 2 or 3
+  int64_t spatial_dims = 0;
+  bool channels_last = false;
+
+  int64_t batch() const {
+    return input.size(0);
+  }
+
+  int64_t in_channels() const {
+    return input.size(1);
+  }
+
+  int64_t out_channels() const {
+    return weight.size(0);
+  }
+
+  std::array<int64_t, 3> output_size() const {
+    std::array<int64_t, 3> size{};
+    for (int64_t d = 0; d < 3; ++d) {
+      size[d] = (input.size(d + 2) + 2 * params.padding[d] -
+                 params.dilation[d] * (weight.size(d + 2) - 1) - 1) /
+              params.stride[d] +
+          1;
+    }
+    return size;
+  }
+};
+
+// expands a per-dim argument given once or per spatial dim, right aligned
+// into the three dims of ConvParams
+std::array<int64_t, 3> expand_param(
+    IntArrayRef value,
+    int64_t spatial_dims,
+    int64_t fill,
+    const char* name) {
+  TORCH_CHECK(
+      value.size() == 1 or static_cast<int64_t>(value.size()) == spatial_dims,
+      "convolution: expected ",
+      name,
+      " to have 1 or ",
+      spatial_dims,
+      " elements, got ",
+      value.size());
+  std::array<int64_t, 3> result{fill, fill, fill};
+  for (int64_t d = 0; d < spatial_dims; ++d) {
+    result[3 - spatial_dims + d] = value.size() == 1 ? value[0] : value[d];
+  }
+  return result;
+}
+
+Conv5d prepare(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  TORCH_CHECK(
+      input.dim() >= 3 and input.dim() <= 5,
+      "convolution: expected a 3-D, 4-D or 5-D input, got ",
+      input.dim(),
+      "-D");
+  TORCH_CHECK(
+      weight.dim() == input.dim(),
+      "convolution: expected a ",
+      input.dim(),
+      "-D weight for a ",
+      input.dim(),
+      "-D input, got ",
+      weight.dim(),
+      "-D");
+  const ScalarType dtype = input.scalar_type();
+  TORCH_CHECK(
+      isFloatingType(dtype),
+      "convolution: unsupported dtype ",
+      dtype);
+  TORCH_CHECK(
+      weight.scalar_type() == dtype,
+      "convolution: expected input and weight to have the same dtype, but "
+      "got ",
+      dtype,
+      " != ",
+      weight.scalar_type());
+  TORCH_CHECK(groups > 0, "convolution: groups must be positive");
+  TORCH_CHECK(
+      weight.size(0) % groups == 0,
+      "convolution: ",
+      weight.size(0),
+      " output channels are not divisible by ",
+      groups,
+      " groups");
+  TORCH_CHECK(
+      input.size(1) == weight.size(1) * groups,
+      "convolution: expected input with ",
+      weight.size(1) * groups,
+      " channels for weight of size ",
+      weight.sizes(),
+      " and ",
+      groups,
+      " groups, got ",
+      input.size(1));
+
+  Conv5d conv;
+  conv.spatial_dims = input.dim() - 2;
+  conv.params.stride = expand_param(stride, conv.spatial_dims, 1, "stride");
+  conv.params.padding =
+      expand_param(padding, conv.spatial_dims, 0, "padding");
+  conv.params.dilation =
+      expand_param(dilation, conv.spatial_dims, 1, "dilation");
+  conv.params.groups = groups;
+  for (int64_t d = 0; d < 3; ++d) {
+    TORCH_CHECK(
+        conv.params.stride[d] > 0 and conv.params.dilation[d] > 0 and
+            conv.params.padding[d] >= 0,
+        "convolution: stride and dilation must be positive and padding "
+        "non-negative");
+  }
+  conv.input = input;
+  conv.weight = weight;
+  for (int64_t d = conv.spatial_dims; d < 3; ++d) {
+    conv.input = conv.input.unsqueeze(2);
+    conv.weight = conv.weight.unsqueeze(2);
+  }
+  for (int64_t d = 0; d < 3; ++d) {
+    TORCH_CHECK(
+        conv.output_size()[d] > 0 and
+            conv.input.size(d + 2) + 2 * conv.params.padding[d] >=
+                conv.params.dilation[d] * (conv.weight.size(d + 2) - 1) + 1,
+        "convolution: input of size ",
+        input.sizes(),
+        " (padded) is smaller than the kernel of size ",
+        weight.sizes());
+  }
+  if (bias.has_value() and bias->defined()) {
+    TORCH_CHECK(
+        bias->dim() == 1 and bias->size(0) == weight.size(0) and
+            bias->scalar_type() == dtype,
+        "convolution: expected a bias of ",
+        weight.size(0),
+        " ",
+        dtype,
+        " elements, got ",
+        bias->sizes(),
+        " ",
+        bias->scalar_type());
+    conv.bias = *bias;
+  }
+  conv.channels_last = !conv.input.is_contiguous() and
+      conv.input.is_contiguous(MemoryFormat::ChannelsLast3d);
+  return conv;
+}
+
+// The stride between consecutive pixels of the 5-D t if its spatial dims
+// (and its batch dim too, with `with_batch`) can be walked as one dim.
+std::optional<int64_t> pixel_stride(const Tensor& t, bool with_batch) {
+  std::optional<int64_t> stride;
+  int64_t expected = 0;
+  for (int64_t d : {4, 3, 2, 0}) {
+    if ((d == 0 and !with_batch) or t.size(d) == 1) {
+      continue;
+    }
+    if (!stride.has_value()) {
+      stride = t.stride(d);
+    } else if (t.stride(d) != expected) {
+      return std::nullopt;
+    }
+    expected = t.stride(d) * t.size(d);
+  }
+  return stride.value_or(1);
+}
+
+bool is_pointwise(const Conv5d& conv) {
+  for (int64_t d = 0; d < 3; ++d) {
+    if (conv.weight.size(d + 2) != 1 or conv.params.stride[d] != 1 or
+        conv.params.padding[d] != 0) {
+      return false;
+    }
+  }
+  return pixel_stride(conv.input, conv.channels_last).has_value();
+}
+
+bool is_depthwise(const Conv5d& conv) {
+  return conv.params.groups > 1 and conv.params.groups == conv.in_channels();
+}
+
+bool supports_winograd(const Conv5d& conv) {
+  const ConvParams& p = conv.params;
+  return !isReducedFloatingType(conv.input.scalar_type()) and p.groups == 1 and
+      conv.input.size(2) == 1 and conv.weight.size(2) == 1 and
+      p.padding[0] == 0 and conv.weight.size(3) == 3 and
+      conv.weight.size(4) == 3 and p.stride[1] == 1 and p.stride[2] == 1 and
+      p.dilation[1] == 1 and p.dilation[2] == 1;
+}
+
+bool supports(const Conv5d& conv, ConvAlgorithm algorithm) {
+  switch (algorithm) {
+    case ConvAlgorithm::Im2col:
+      return true;
+    case ConvAlgorithm::Direct:
+      return is_depthwise(conv) or is_pointwise(conv);
+    case ConvAlgorithm::Winograd2x3:
+    case ConvAlgorithm::Winograd4x3:
+      return supports_winograd(conv);
+  }
+  return false;
+}
+
+ConvAlgorithm choose_algorithm(const Conv5d& conv) {
+  if (is_depthwise(conv) or is_pointwise(conv)) {
+    return ConvAlgorithm::Direct;
+  }
+  // Winograd transforms the whole weight on every call and runs its GEMMs
+  // over blocks of tiles: with few channels or few tiles the GEMMs are too
+  // small to pay for that. Where it does pay F(4x4) measured faster than
+  // F(2x2), which is left to convolution_with_algorithm().
+  if (supports_winograd(conv) and conv.in_channels() >= 16 and
+      conv.out_channels() >= 16) {
+    const std::array<int64_t, 3> output_size = conv.output_size();
+    const int64_t tiles = conv.batch() * divup(output_size[1], 4) *
+        divup(output_size[2], 4);
+    if (tiles >= kMinWinogradTiles) {
+      return ConvAlgorithm::Winograd4x3;
+    }
+  }
+  return ConvAlgorithm::Im2col;
+}
+
+// choose_algorithm() remembered per dtype, layout, shapes and geometry
+ConvAlgorithm cached_algorithm(const Conv5d& conv) {
+  using Key = std::array<int64_t, 23>;
+  static std::mutex mutex;
+  static std::map<Key, ConvAlgorithm> cache;
+  Key key{};
+  auto it = key.begin();
+  *it++ = static_cast<int64_t>(conv.input.scalar_type());
+  *it++ = conv.channels_last;
+  // whether pointwise can read the input in place
+  *it++ = pixel_stride(conv.input, conv.channels_last).has_value();
+  for (int64_t d = 0; d < 5; ++d) {
+    *it++ = conv.input.size(d);
+    *it++ = conv.weight.size(d);
+  }
+  for (int64_t d = 0; d < 3; ++d) {
+    *it++ = conv.params.stride[d];
+    *it++ = conv.params.padding[d];
+    *it++ = conv.params.dilation[d];
+  }
+  *it++ = conv.params.groups;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto found = cache.find(key);
+  if (found == cache.end()) {
+    found = cache.emplace(key, choose_algorithm(conv)).first;
+  }
+  return found->second;
+}
+
+Tensor empty_output(const Conv5d& conv) {
+  const auto [od, oh, ow] = conv.output_size();
+  return empty(
+      {conv.batch(), conv.out_channels(), od, oh, ow},
+      conv.input.scalar_type(),
+      conv.channels_last ? MemoryFormat::ChannelsLast3d
+                         : MemoryFormat::Contiguous);
+}
+
+// a contiguous copy of the 5-D t, or t if it already is
+Tensor contiguous_copy(const Tensor& t) {
+  if (t.is_contiguous()) {
+    return t;
+  }
+  Tensor result = empty(t.sizes(), t.scalar_type());
+  AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+      t.scalar_type(), "conv_copy", [&] {
+        const scalar_t* src = t.const_data_ptr<scalar_t>();
+        scalar_t* dst = result.mutable_data_ptr<scalar_t>();
+        const int64_t s0 = t.stride(0), s1 = t.stride(1), s2 = t.stride(2);
+        const int64_t s3 = t.stride(3), s4 = t.stride(4);
+        for (int64_t i0 = 0; i0 < t.size(0); ++i0) {
+          for (int64_t i1 = 0; i1 < t.size(1); ++i1) {
+            for (int64_t i2 = 0; i2 < t.size(2); ++i2) {
+              for (int64_t i3 = 0; i3 < t.size(3); ++i3) {
+                const scalar_t* row =
+                    src + i0 * s0 + i1 * s1 + i2 * s2 + i3 * s3;
+                for (int64_t i4 = 0; i4 < t.size(4); ++i4) {
+                  *dst++ = row[i4 * s4];
+                }
+              }
+            }
+          }
+        }
+      });
+  return result;
+}
+
+// output[n, c, ...] = bias[c] for the GEMM based algorithms, which then
+// accumulate into the output; without a bias they overwrite it instead,
+// see gemm_params()
+void fill_bias(const Conv5d& conv, const Tensor& output) {
+  if (!conv.bias.defined()) {
+    return;
+  }
+  AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+      output.scalar_type(), "conv_bias", [&] {
+        const int64_t channels = output.size(1);
+        const int64_t pixels = output.size(2) * output.size(3) * output.size(4);
+        scalar_t* out = output.mutable_data_ptr<scalar_t>();
+        const scalar_t* b = conv.bias.const_data_ptr<scalar_t>();
+        const int64_t b_stride = conv.bias.stride(0);
+        if (conv.channels_last) {
+          parallel_for(
+              0,
+              output.size(0) * pixels,
+              1 + 4096 / channels,
+              [&](int64_t begin, int64_t end) {
+                for (int64_t r = begin; r < end; ++r) {
+                  for (int64_t c = 0; c < channels; ++c) {
+                    out[r * channels + c] = b[c * b_stride];
+                  }
+                }
+              });
+          return;
+        }
+        parallel_for(
+            0,
+            output.size(0) * channels,
+            1 + 4096 / pixels,
+            [&](int64_t begin, int64_t end) {
+              for (int64_t r = begin; r < end; ++r) {
+                std::fill(
+                    out + r * pixels,
+                    out + (r + 1) * pixels,
+                    b[(r % channels) * b_stride]);
+              }
+            });
+      });
+}
+
+cpublas::GemmParams gemm_params(const Conv5d& conv) {
+  cpublas::GemmParams params;
+  params.dtype = conv.input.scalar_type();
+  params.beta = conv.bias.defined() ? 1 : 0;
+  return params;
+}
+
+// The weight of the im2col GEMM as C_out rows of K = C / groups * kernel
+// entries, in the order they are in memory: channel-major (ci, z, y, x) for
+// a contiguous weight, tap-major (z, y, x, ci) for a channels-last one. The
+// patch matrix follows the same order, so neither layout is copied.
+struct PatchWeight {
+  Tensor weight;
+  // between consecutive input channels, kernel offsets within a row of K
+  int64_t channel_stride;
+  int64_t tap_stride;
+};
+
+PatchWeight patch_weight(const Conv5d& conv) {
+  const Tensor& weight = conv.weight;
+  const int64_t taps = weight.size(2) * weight.size(3) * weight.size(4);
+  if (!weight.is_contiguous() and
+      weight.is_contiguous(MemoryFormat::ChannelsLast3d)) {
+    return {weight, 1, weight.size(1)};
+  }
+  return {contiguous_copy(weight), taps, 1};
+}
+
+// Contiguous input and output: per image and group, output (C_out / groups
+// x pixels) = weight (C_out / groups x C / groups * kernel) @ patches, the
+// patch matrix built in blocks of columns.
+template <typename scalar_t>
+void im2col_conv_contiguous(const Conv5d& conv, const Tensor& output) {
+  const PatchWeight patch = patch_weight(conv);
+  const Tensor& weight = patch.weight;
+  const int64_t channel_stride = patch.channel_stride;
+  const int64_t tap_stride = patch.tap_stride;
+  const Tensor& input = conv.input;
+  const ConvParams& p = conv.params;
+  const int64_t groups = p.groups;
+  const int64_t cin_g = conv.in_channels() / groups;
+  const int64_t cout_g = conv.out_channels() / groups;
+  // not structured bindings, which lambdas cannot capture before C++20
+  const int64_t kd = weight.size(2);
+  const int64_t kh = weight.size(3);
+  const int64_t kw = weight.size(4);
+  const std::array<int64_t, 3> output_size = conv.output_size();
+  const int64_t od = output_size[0];
+  const int64_t oh = output_size[1];
+  const int64_t ow = output_size[2];
+  const int64_t id = input.size(2);
+  const int64_t ih = input.size(3);
+  const int64_t iw = input.size(4);
+  const std::array<int64_t, 5> in_stride{
+      input.stride(0),
+      input.stride(1),
+      input.stride(2),
+      input.stride(3),
+      input.stride(4)};
+  const int64_t k = cin_g * kd * kh * kw;
+  const int64_t pixels = od * oh * ow;
+  const int64_t block =
+      std::min(pixels, std::max(kMinColumnBlock, kMaxColumnElements / k));
+  Tensor columns = empty({k, block}, input.scalar_type());
+  scalar_t* col = columns.mutable_data_ptr<scalar_t>();
+  const scalar_t* in = input.const_data_ptr<scalar_t>();
+  const scalar_t* w = weight.const_data_ptr<scalar_t>();
+  scalar_t* out = output.mutable_data_ptr<scalar_t>();
+  for (int64_t n = 0; n < conv.batch(); ++n) {
+    for (int64_t g = 0; g < groups; ++g) {
+      for (int64_t p0 = 0; p0 < pixels; p0 += block) {
+        const int64_t pc = std::min(block, pixels - p0);
+        // row r of the patch matrix is input channel ci at kernel offset
+        // (z, y, x), column q output pixel p0 + q; a row is filled in runs
+        // along the output width
+        parallel_for(0, k, 1 + 4096 / pc, [&](int64_t begin, int64_t end) {
+          for (int64_t r = begin; r < end; ++r) {
+            const int64_t tap = r / tap_stride % (kd * kh * kw);
+            const int64_t x = tap % kw;
+            const int64_t y = (tap / kw) % kh;
+            const int64_t z = tap / (kw * kh);
+            const int64_t ci = g * cin_g + r / channel_stride % cin_g;
+            const scalar_t* src = in + n * in_stride[0] + ci * in_stride[1];
+            scalar_t* dst = col + r * pc;
+            for (int64_t q = 0; q < pc;) {
+              const int64_t pixel = p0 + q;
+              const int64_t ox = pixel % ow;
+              const int64_t run = std::min(ow - ox, pc - q);
+              const int64_t i = (pixel / (oh * ow)) * p.stride[0] -
+                  p.padding[0] + z * p.dilation[0];
+              const int64_t j = (pixel / ow % oh) * p.stride[1] -
+                  p.padding[1] + y * p.dilation[1];
+              if (i < 0 or i >= id or j < 0 or j >= ih) {
+                std::fill(dst + q, dst + q + run, scalar_t(0));
+                q += run;
+                continue;
+              }
+              const scalar_t* src_row =
+                  src + i * in_stride[2] + j * in_stride[3];
+              // the run's outputs [t0, t1) read inside the input row
+              const int64_t l0 =
+                  ox * p.stride[2] - p.padding[2] + x * p.dilation[2];
+              const int64_t t0 =
+                  std::min(run, l0 >= 0 ? 0 : divup(-l0, p.stride[2]));
+              const int64_t t1 =
+                  std::max(t0, std::min(run, divup(iw - l0, p.stride[2])));
+              std::fill(dst + q, dst + q + t0, scalar_t(0));
+              if (p.stride[2] == 1 and in_stride[4] == 1) {
+                std::copy(src_row + l0 + t0, src_row + l0 + t1, dst + q + t0);
+              } else {
+                for (int64_t t = t0; t < t1; ++t) {
+                  dst[q + t] =
+                      src_row[(l0 + t * p.stride[2]) * in_stride[4]];
+                }
+              }
+              std::fill(dst + q + t1, dst + q + run, scalar_t(0));
+              q += run;
+            }
+          }
+        });
+        cpublas::GemmParams params = gemm_params(conv);
+        params.m = cout_g;
+        params.n = pc;
+        params.k = k;
+        params.a = w + g * cout_g * k;
+        params.a_row_stride = k;
+        params.a_col_stride = 1;
+        params.b = col;
+        params.b_row_stride = pc;
+        params.b_col_stride = 1;
+        params.c = out + (n * conv.out_channels() + g * cout_g) * pixels + p0;
+        params.c_row_stride = pixels;
+        params.c_col_stride = 1;
+        cpublas::gemm(params);
+      }
+    }
+  }
+}
+
+// Channels-last input and output: the output pixels of the whole batch are
+// the rows of one matrix, output (pixels x C_out / groups) = patches @
+// weight^T per group, the patch matrix built in blocks of rows, each the
+// kernel window of one output pixel gathered from runs of C / groups
+// contiguous input channels.
+template <typename scalar_t>
+void im2col_conv_channels_last(const Conv5d& conv, const Tensor& output) {
+  const PatchWeight patch = patch_weight(conv);
+  const Tensor& weight = patch.weight;
+  const int64_t channel_stride = patch.channel_stride;
+  const int64_t tap_stride = patch.tap_stride;
+  const Tensor& input = conv.input;
+  const ConvParams& p = conv.params;
+  const int64_t groups = p.groups;
+  const int64_t cin_g = conv.in_channels() / groups;
+  const int64_t cout_g = conv.out_channels() / groups;
+  const int64_t kd = weight.size(2);
+  const int64_t kh = weight.size(3);
+  const int64_t kw = weight.size(4);
+  const std::array<int64_t, 3> output_size = conv.output_size();
+  const int64_t od = output_size[0];
+  const int64_t oh = output_size[1];
+  const int64_t ow = output_size[2];
+  const int64_t id = input.size(2);
+  const int64_t ih = input.size(3);
+  const int64_t iw = input.size(4);
+  // channels are contiguous
+  const std::array<int64_t, 5> in_stride{
+      input.stride(0), 1, input.stride(2), input.stride(3), input.stride(4)};
+  const int64_t k = kd * kh * kw * cin_g;
+  const int64_t rows = conv.batch() * od * oh * ow;
+  const int64_t block =
+      std::min(rows, std::max(kMinColumnBlock, kMaxColumnElements / k));
+  Tensor columns = empty({block, k}, input.scalar_type());
+  scalar_t* col = columns.mutable_data_ptr<scalar_t>();
+  const scalar_t* in = input.const_data_ptr<scalar_t>();
+  const scalar_t* w = weight.const_data_ptr<scalar_t>();
+  scalar_t* out = output.mutable_data_ptr<scalar_t>();
+  for (int64_t g = 0; g < groups; ++g) {
+    for (int64_t r0 = 0; r0 < rows; r0 += block) {
+      const int64_t rc = std::min(block, rows - r0);
+      parallel_for(0, rc, 1 + 4096 / k, [&](int64_t begin, int64_t end) {
+        for (int64_t q = begin; q < end; ++q) {
+          const int64_t row = r0 + q;
+          const int64_t n = row / (od * oh * ow);
+          const int64_t pixel = row % (od * oh * ow);
+          const int64_t i0 = (pixel / (oh * ow)) * p.stride[0] - p.padding[0];
+          const int64_t j0 = (pixel / ow % oh) * p.stride[1] - p.padding[1];
+          const int64_t l0 = (pixel % ow) * p.stride[2] - p.padding[2];
+          const scalar_t* src = in + n * in_stride[0] + g * cin_g;
+          scalar_t* dst = col + q * k;
+          for (int64_t z = 0; z < kd; ++z) {
+            const int64_t i = i0 + z * p.dilation[0];
+            for (int64_t y = 0; y < kh; ++y) {
+              const int64_t j = j0 + y * p.dilation[1];
+              for (int64_t x = 0; x < kw; ++x, dst += tap_stride) {
+                const int64_t l = l0 + x * p.dilation[2];
+                const bool inside = i >= 0 and i < id and j >= 0 and
+                    j < ih and l >= 0 and l < iw;
+                const scalar_t* pixel_src = inside
+                    ? src + i * in_stride[2] + j * in_stride[3] +
+                        l * in_stride[4]
+                    : nullptr;
+                if (channel_stride == 1) {
+                  if (inside) {
+                    std::copy(pixel_src, pixel_src + cin_g, dst);
+                  } else {
+                    std::fill(dst, dst + cin_g, scalar_t(0));
+                  }
+                  continue;
+                }
+                for (int64_t c = 0; c < cin_g; ++c) {
+                  dst[c * channel_stride] = inside ? pixel_src[c] : scalar_t(0);
+                }
+              }
+            }
+          }
+        }
+      });
+      cpublas::GemmParams params = gemm_params(conv);
+      params.m = rc;
+      params.n = cout_g;
+      params.k = k;
+      params.a = col;
+      params.a_row_stride = k;
+      params.a_col_stride = 1;
+      params.b = w + g * cout_g * k;
+      params.b_row_stride = 1;
+      params.b_col_stride = k;
+      params.c = out + r0 * conv.out_channels() + g * cout_g;
+      params.c_row_stride = conv.out_channels();
+      params.c_col_stride = 1;
+      cpublas::gemm(params);
+    }
+  }
+}
+
+// 1x1 kernel, stride 1, no padding: the input is the patch matrix already,
+// read in place with its strides
+void pointwise_conv(const Conv5d& conv, const Tensor& output) {
+  const Tensor& input = conv.input;
+  const Tensor& weight = conv.weight;
+  const int64_t groups = conv.params.groups;
+  const int64_t cin_g = conv.in_channels() / groups;
+  const int64_t cout_g = conv.out_channels() / groups;
+  const int64_t pixels = input.size(2) * input.size(3) * input.size(4);
+  const int64_t in_pixel_stride = *pixel_stride(input, conv.channels_last);
+  const auto* in = static_cast<const char*>(input.const_data_ptr());
+  const auto* w = static_cast<const char*>(weight.const_data_ptr());
+  auto* out = static_cast<char*>(output.mutable_data_ptr());
+  const int64_t itemsize = static_cast<int64_t>(input.itemsize());
+  for (int64_t g = 0; g < groups; ++g) {
+    cpublas::GemmParams params = gemm_params(conv);
+    if (conv.channels_last) {
+      // (pixels of the batch x C / groups) @ weight^T
+      params.m = conv.batch() * pixels;
+      params.n = cout_g;
+      params.k = cin_g;
+      params.a = in + g * cin_g * input.stride(1) * itemsize;
+      params.a_row_stride = in_pixel_stride;
+      params.a_col_stride = input.stride(1);
+      params.b = w + g * cout_g * weight.stride(0) * itemsize;
+      params.b_row_stride = weight.stride(1);
+      params.b_col_stride = weight.stride(0);
+      params.c = out + g * cout_g * itemsize;
+      params.c_row_stride = conv.out_channels();
+      params.c_col_stride = 1;
+      cpublas::gemm(params);
+      continue;
+    }
+    // per image, weight @ (C / groups x pixels)
+    for (int64_t n = 0; n < conv.batch(); ++n) {
+      params.m = cout_g;
+      params.n = pixels;
+      params.k = cin_g;
+      params.a = w + g * cout_g * weight.stride(0) * itemsize;
+      params.a_row_stride = weight.stride(0);
+      params.a_col_stride = weight.stride(1);
+      params.b = in +
+          (n * input.stride(0) + g * cin_g * input.stride(1)) * itemsize;
+      params.b_row_stride = input.stride(1);
+      params.b_col_stride = in_pixel_stride;
+      params.c = out +
+          (n * conv.out_channels() + g * cout_g) * pixels * itemsize;
+      params.c_row_stride = pixels;
+      params.c_col_stride = 1;
+      cpublas::gemm(params);
+    }
+  }
+}
+
+Tensor run(const Conv5d& conv, ConvAlgorithm algorithm) {
+  TORCH_CHECK(
+      supports(conv, algorithm),
+      "convolution: the ",
+      toString(algorithm),
+      " algorithm does not support input of size ",
+      conv.input.sizes(),
+      " and weight of size ",
+      conv.weight.sizes());
+  Tensor output = empty_output(conv);
+  if (output.numel() > 0) {
+    switch (algorithm) {
+      case ConvAlgorithm::Im2col:
+        fill_bias(conv, output);
+        AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+            output.scalar_type(), "im2col_conv", [&] {
+              if (conv.channels_last) {
+                im2col_conv_channels_last<scalar_t>(conv, output);
+              } else {
+                im2col_conv_contiguous<scalar_t>(conv, output);
+              }
+            });
+        break;
+      case ConvAlgorithm::Direct:
+        if (is_depthwise(conv)) {
+          depthwise_conv_stub(
+              kCPU, output, conv.input, conv.weight, conv.bias, conv.params);
+        } else {
+          fill_bias(conv, output);
+          pointwise_conv(conv, output);
+        }
+        break;
+      case ConvAlgorithm::Winograd2x3:
+      case ConvAlgorithm::Winograd4x3:
+        winograd_conv_stub(
+            kCPU,
+            output,
+            conv.input,
+            conv.weight,
+            conv.bias,
+            conv.params,
+            algorithm == ConvAlgorithm::Winograd2x3 ? 2 : 4);
+        break;
+    }
+  }
+  for (int64_t d = conv.spatial_dims; d < 3; ++d) {
+    output = output.select(2, 0);
+  }
+  return output;
+}
+
+} // namespace
+
+ConvAlgorithm select_conv_algorithm(
+    const Tensor& input,
+    const Tensor& weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  return cached_algorithm(
+      prepare(input, weight, std::nullopt, stride, padding, dilation, groups));
+}
+
+Tensor convolution_with_algorithm(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    ConvAlgorithm algorithm) {
+  return run(
+      prepare(input, weight, bias, stride, padding, dilation, groups),
+      algorithm);
+}
+
+Tensor convolution(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  const Conv5d conv =
+      prepare(input, weight, bias, stride, padding, dilation, groups);
+  return run(conv, cached_algorithm(conv));
+}
+
+Tensor conv1d(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  TORCH_CHECK(
+      input.dim() == 3,
+      "conv1d: expected a 3-D input, got ",
+      input.dim(),
+      "-D");
+  return convolution(input, weight, bias, stride, padding, dilation, groups);
+}
+
+Tensor conv2d(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  TORCH_CHECK(
+      input.dim() == 4,
+      "conv2d: expected a 4-D input, got ",
+      input.dim(),
+      "-D");
+  return convolution(input, weight, bias, stride, padding, dilation, groups);
+}
+
+Tensor conv3d(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  TORCH_CHECK(
+      input.dim() == 5,
+      "conv3d: expected a 5-D input, got ",
+      input.dim(),
+      "-D");
+  return convolution(input, weight, bias, stride, padding, dilation, groups);
+}
+
+} // namespace at::native
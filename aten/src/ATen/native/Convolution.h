@@ -0,0 +1,84 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <ATen/native/DispatchStub.h>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace at::native {
+
+// The geometry of a convolution over three spatial dims (depth, height,
+// width). 1-D and 2-D convolutions are run as 3-D ones whose leading
+// spatial dims have size 1, stride 1 and no padding.
+struct ConvParams {
+  std::array<int64_t, 3> stride{1, 1, 1};
+  std::array<int64_t, 3> padding{0, 0, 0};
+  std::array<int64_t, 3> dilation{1, 1, 1};
+  int64_t groups = 1;
+};
+
+// How a convolution is computed:
+//   Im2col       gathers the input patches into a matrix and multiplies it
+//                with the weights in one GEMM; any shape
+//   Direct       pointwise (1x1, stride 1, no padding) as one GEMM on the
+//                input in place, depthwise (one input channel per group)
+//                as vectorized loops over the input
+//   Winograd2x3  F(2x2, 3x3) and F(4x4, 3x3) (Lavin and Gray, "Fast
+//   Winograd4x3  Algorithms for Convolutional Neural Networks"): 3x3,
+//                stride 1, no dilation, 2-D, one group, Float or Double.
+//                F(4x4) does 2.25 times fewer multiplications than F(2x2)
+//                but its transforms lose more precision.
+enum class ConvAlgorithm { Im2col, Direct, Winograd2x3, Winograd4x3 };
+
+TORCH_API const char* toString(ConvAlgorithm algorithm);
+
+// The algorithm convolution() uses for these operands, picked from their
+// shapes, dtype and layout; the choice is remembered per configuration.
+// Winograd2x3 is never picked, it is there for convolution_with_algorithm().
+TORCH_API ConvAlgorithm select_conv_algorithm(
+    const Tensor& input,
+    const Tensor& weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups);
+
+// convolution() with the given algorithm, which must support the operands
+TORCH_API Tensor convolution_with_algorithm(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    ConvAlgorithm algorithm);
+
+// The kernels below take 5-D tensors: input N x C x D x H x W, weight
+// C_out x C / groups x KD x KH x KW, output N x C_out x OD x OH x OW laid
+// out like the input (contiguous or channels-last), and an undefined bias
+// for none. They write every element of the output, bias included.
+
+// groups == C, weight.size(1) == 1
+using depthwise_conv_fn = void (*)(
+    const Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const ConvParams& params);
+
+// 3x3 kernel, stride 1, no dilation, D == 1, one group; tile is 2 or 4
+using winograd_conv_fn = void (*)(
+    const Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const ConvParams& params,
+    int64_t tile);
+
+DECLARE_DISPATCH(depthwise_conv_fn, depthwise_conv_stub);
+DECLARE_DISPATCH(winograd_conv_fn, winograd_conv_stub);
+
+} // namespace at::native
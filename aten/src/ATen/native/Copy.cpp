@@ -0,0 +1,151 @@
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/TensorIterator.h>
+#include <ATen/native/Copy.h>
+#include <ATen/native/InPlace.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace at::native {
+
+DEFINE_DISPATCH(convert_stub);
+DEFINE_DISPATCH(copy_stub);
+DEFINE_DISPATCH(scaled_copy_stub);
+
+namespace {
+
+// self converted to dtype and multiplied by scale, laid out like self
+Tensor scaled_to(const Tensor& self, ScalarType dtype, double scale) {
+  auto iter = TensorIteratorConfig()
+                  .add_output(Tensor())
+                  .add_input(self)
+                  .check_all_same_dtype(false)
+                  .declare_output_dtype(dtype)
+                  .build();
+  if (iter.numel() > 0) {
+    scaled_copy_stub(kCPU, iter, scale);
+  }
+  return iter.output();
+}
+
+void check_scale(const char* name, double scale) {
+  TORCH_CHECK(
+      scale > 0 and std::isfinite(scale),
+      name,
+      ": expected a positive finite scale, got ",
+      scale);
+}
+
+} // namespace
+
+void convert(
+    const void* src,
+    ScalarType src_dtype,
+    void* dst,
+    ScalarType dst_dtype,
+    int64_t n) {
+  const int64_t src_size = static_cast<int64_t>(elementSize(src_dtype));
+  const int64_t dst_size = static_cast<int64_t>(elementSize(dst_dtype));
+  parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    convert_stub(
+        kCPU,
+        static_cast<const char*>(src) + begin * src_size,
+        src_dtype,
+        static_cast<char*>(dst) + begin * dst_size,
+        dst_dtype,
+        end - begin);
+  });
+}
+
+const Tensor& copy_(const Tensor& self, const Tensor& src) {
+  if (self.numel() == 0) {
+    return self;
+  }
+  if (self.is_same(src)) {
+    return self;
+  }
+  // the iterator takes its shape from the inputs
+  auto iter = TensorIteratorConfig()
+                  .add_output(self)
+                  .add_input(src.expand(self.sizes()))
+                  .check_all_same_dtype(false)
+                  .build();
+  copy_stub(kCPU, iter);
+  increment_version(self);
+  return self;
+}
+
+Tensor to(const Tensor& self, ScalarType dtype, bool copy) {
+  if (self.scalar_type() == dtype and !copy) {
+    return self;
+  }
+  // the result is laid out like self, e.g. channels-last stays channels-last
+  auto iter = TensorIteratorConfig()
+                  .add_output(Tensor())
+                  .add_input(self)
+                  .check_all_same_dtype(false)
+                  .declare_output_dtype(dtype)
+                  .build();
+  if (iter.numel() > 0) {
+    copy_stub(kCPU, iter);
+  }
+  return iter.output();
+}
+
+Tensor contiguous(const Tensor& self, MemoryFormat memory_format) {
+  if (self.is_contiguous(memory_format)) {
+    return self;
+  }
+  return empty(self.sizes(), self.scalar_type(), memory_format).copy_(self);
+}
+
+Tensor to_float8(const Tensor& self, ScalarType dtype, double scale) {
+  TORCH_CHECK(
+      isFloat8Type(dtype), "to_float8: expected a Float8 dtype, got ", dtype);
+  TORCH_CHECK(
+      isFloatingType(self.scalar_type()),
+      "to_float8: expected a floating input, got ",
+      self.scalar_type());
+  check_scale("to_float8", scale);
+  return scaled_to(self, dtype, 1 / scale);
+}
+
+Tensor from_float8(const Tensor& self, double scale, ScalarType dtype) {
+  TORCH_CHECK(
+      isFloat8Type(self.scalar_type()),
+      "from_float8: expected a Float8 input, got ",
+      self.scalar_type());
+  TORCH_CHECK(
+      isFloatingType(dtype),
+      "from_float8: expected a floating dtype, got ",
+      dtype);
+  check_scale("from_float8", scale);
+  return scaled_to(self, dtype, scale);
+}
+
+double float8_scale(const Tensor& self, ScalarType dtype) {
+  TORCH_CHECK(
+      isFloat8Type(dtype),
+      "float8_scale: expected a Float8 dtype, got ",
+      dtype);
+  const double fp8_max = AT_DISPATCH_FLOAT8_TYPES(dtype, "float8_scale", [&] {
+    return static_cast<double>(std::numeric_limits<scalar_t>::max());
+  });
+  if (self.numel() == 0) {
+    return 1;
+  }
+  const double max = std::max(
+      self.amax().to(ScalarType::Double).const_data_ptr<double>()[0],
+      -self.amin().to(ScalarType::Double).const_data_ptr<double>()[0]);
+  TORCH_CHECK(
+      std::isfinite(max),
+      "float8_scale: expected finite values, the largest magnitude is ",
+      max);
+  // an all-zero tensor converts exactly with any scale
+  return max == 0 ? 1 : max / fp8_max;
+}
+
+} // namespace at::native
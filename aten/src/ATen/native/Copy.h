@@ -0,0 +1,44 @@
+#pragma once
+
+#include <ATen/native/DispatchStub.h>
+#include <c10/core/ScalarType.h>
+
+namespace at {
+class TensorIterator;
+}
+
+namespace at::native {
+
+// Conversions follow static_cast, except that any nonzero value becomes
+// true in Bool and Half, BFloat16 and the Float8 types convert through
+// float; Float8 saturates, see c10/util/Float8_*.h.
+
+// converts the n contiguous elements of src to dst_dtype into dst, which
+// does not overlap src
+using convert_fn = void (*)(
+    const void* src,
+    ScalarType src_dtype,
+    void* dst,
+    ScalarType dst_dtype,
+    int64_t n);
+
+// writes the input of iter, converted to the output's dtype, to its output
+using copy_fn = void (*)(TensorIterator& iter);
+
+// copy_fn for a Float8 input or output, the other being floating, which
+// multiplies the values by scale in float on the way
+using scaled_copy_fn = void (*)(TensorIterator& iter, double scale);
+
+DECLARE_DISPATCH(convert_fn, convert_stub);
+DECLARE_DISPATCH(copy_fn, copy_stub);
+DECLARE_DISPATCH(scaled_copy_fn, scaled_copy_stub);
+
+// convert_stub, split across threads for large n
+TORCH_API void convert(
+    const void* src,
+    ScalarType src_dtype,
+    void* dst,
+    ScalarType dst_dtype,
+    int64_t n);
+
+} // namespace at::native
@@ -0,0 +1,112 @@
+#include <ATen/native/DispatchStub.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <strings.h>
+
+namespace at::native {
+
+namespace {
+
+// the ATEN_CPU_CAPABILITY value of AVX512 with VNNI
+[[maybe_unused]] constexpr const char* kAvx512Vnni = "AVX512_VNNI";
+
+} // namespace
+
+const char* toString(CPUCapability capability) {
+  switch (capability) {
+    case CPUCapability::DEFAULT:
+      return "DEFAULT";
+#if defined(HAVE_AVX2_CPU_DEFINITION)
+    case CPUCapability::AVX2:
+      return "AVX2";
+#endif
+#if defined(HAVE_AVX512_CPU_DEFINITION)
+    case CPUCapability::AVX512:
+      return "AVX512";
+#endif
+    default:
+      return "UNKNOWN";
+  }
+}
+
+CPUCapability detect_cpu_capability() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  // __builtin_cpu_supports checks CPUID and, for AVX and AVX-512, that the
+  // OS saves the wider registers (XGETBV)
+  __builtin_cpu_init();
+#if defined(HAVE_AVX512_CPU_DEFINITION)
+  if (__builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512vl") &&
+      __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("fma") &&
+      __builtin_cpu_supports("f16c")) {
+    return CPUCapability::AVX512;
+  }
+#endif
+#if defined(HAVE_AVX2_CPU_DEFINITION)
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+      __builtin_cpu_supports("f16c")) {
+    return CPUCapability::AVX2;
+  }
+#endif
+#endif
+  return CPUCapability::DEFAULT;
+}
+
+CPUCapability compute_cpu_capability() {
+  CPUCapability supported = detect_cpu_capability();
+  const char* envar = std::getenv("ATEN_CPU_CAPABILITY");
+  if (envar == nullptr || *envar == '\0') {
+    return supported;
+  }
+  CPUCapability requested = CPUCapability::NUM_OPTIONS;
+  for (int i = 0; i < static_cast<int>(CPUCapability::NUM_OPTIONS); ++i) {
+    auto capability = static_cast<CPUCapability>(i);
+    if (strcasecmp(envar, toString(capability)) == 0) {
+      requested = capability;
+    }
+  }
+#if defined(HAVE_AVX512_CPU_DEFINITION)
+  if (strcasecmp(envar, kAvx512Vnni) == 0) {
+    requested = CPUCapability::AVX512;
+  }
+#endif
+  TORCH_CHECK(
+      requested != CPUCapability::NUM_OPTIONS,
+      "Invalid ATEN_CPU_CAPABILITY '",
+      envar,
+      "', expected one of default, avx2, avx512 or avx512_vnni (as far as ",
+      "this build supports them)");
+  return std::min(requested, supported);
+}
+
+CPUCapability get_cpu_capability() {
+  static CPUCapability capability = compute_cpu_capability();
+  return capability;
+}
+
+bool compute_cpu_vnni() {
+#if defined(HAVE_AVX512_CPU_DEFINITION) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+  // also validates the environment and initializes __builtin_cpu_supports
+  if (compute_cpu_capability() != CPUCapability::AVX512 ||
+      !__builtin_cpu_supports("avx512vnni")) {
+    return false;
+  }
+  const char* envar = std::getenv("ATEN_CPU_CAPABILITY");
+  return envar == nullptr || *envar == '\0' ||
+      strcasecmp(envar, kAvx512Vnni) == 0;
+#else
+  return false;
+#endif
+}
+
+bool get_cpu_vnni() {
+  static bool vnni = compute_cpu_vnni();
+  return vnni;
+}
+
+} // namespace at::native
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <c10/core/DeviceType.h>
+#include <c10/util/Exception.h>
+#include <c10/util/Macros.h>
+
+#include <atomic>
+#include <ostream>
+#include <utility>
+
+// Implements instruction set specific function dispatch.
+//
+// Kernels in native/cpu/ are compiled once per CPU capability (DEFAULT,
+// AVX2, AVX512) with the matching -m flags and CPU_CAPABILITY macros, see
+// aten/CMakeLists.txt. Each compilation registers its version of the kernel
+// with a DispatchStub; the first call through the stub picks the best
+// version the machine supports and caches the function pointer, so every
+// later call costs one atomic load and one indirect call.
+//
+// Example:
+//
+// In native/MyKernel.h:
+//   using fn_type = void(*)(const Tensor& x);
+//   DECLARE_DISPATCH(fn_type, stub);
+//
+// In native/MyKernel.cpp
+//   DEFINE_DISPATCH(stub);
+//
+// In native/cpu/MyKernel.cpp:
+//   namespace {
+//     // use anonymous namespace so that different cpu versions won't
+//     // conflict
+//     void kernel(const Tensor& x) { ... }
+//   }
+//   REGISTER_DISPATCH(stub, &kernel);
+//
+// To call:
+//   stub(kCPU, tensor);
+//
+// The capability is detected with CPUID. Setting ATEN_CPU_CAPABILITY to
+// "default", "avx2" or "avx512" lowers it, e.g. to A/B test kernels on one
+// machine; requests above what the CPU supports are capped. Kernels of a
+// capability may also use extensions the CPU has, which get no dispatch
+// slot of their own: AVX-512 VNNI, which "avx512" turns off and
+// "avx512_vnni" leaves on.
+
+namespace at::native {
+
+enum class CPUCapability {
+  DEFAULT = 0,
+#if defined(HAVE_AVX2_CPU_DEFINITION)
+  AVX2 = 1,
+#endif
+#if defined(HAVE_AVX512_CPU_DEFINITION)
+  AVX512 = 2,
+#endif
+  NUM_OPTIONS
+};
+
+TORCH_API const char* toString(CPUCapability capability);
+
+inline std::ostream& operator<<(std::ostream& stream, CPUCapability c) {
+  return stream << toString(c);
+}
+
+// the capability kernels are dispatched to, computed once per process
+TORCH_API CPUCapability get_cpu_capability();
+
+// the best capability the CPU (and the OS) supports, ignoring
+// ATEN_CPU_CAPABILITY
+TORCH_API CPUCapability detect_cpu_capability();
+
+// detect_cpu_capability() lowered by ATEN_CPU_CAPABILITY if set; reads the
+// environment on every call, get_cpu_capability() caches the first result
+TORCH_API CPUCapability compute_cpu_capability();
+
+// whether AVX512 kernels may use AVX-512 VNNI: the capability is AVX512,
+// the CPU supports VNNI and ATEN_CPU_CAPABILITY, if set, is "avx512_vnni";
+// computed once per process
+TORCH_API bool get_cpu_vnni();
+
+// get_cpu_vnni() from the environment at the time of the call
+TORCH_API bool compute_cpu_vnni();
+
+template <typename FnPtr, typename T>
+struct DispatchStub;
+
+template <typename rT, typename T, typename... Args>
+struct DispatchStub<rT (*)(Args...), T> {
+  using FnPtr = rT (*)(Args...);
+
+  DispatchStub() = default;
+  DispatchStub(const DispatchStub&) = delete;
+  DispatchStub& operator=(const DispatchStub&) = delete;
+
+  template <typename... ArgTypes>
+  rT operator()(c10::DeviceType device_type, ArgTypes&&... args) {
+    FnPtr call_ptr = get_call_ptr(device_type);
+    return (*call_ptr)(std::forward<ArgTypes>(args)...);
+  }
+
+ private:
+  FnPtr get_call_ptr(c10::DeviceType device_type) {
+    TORCH_CHECK(
+        device_type == c10::DeviceType::CPU,
+        "DispatchStub: unsupported device type ",
+        device_type);
+    // Relaxed is enough: racing first calls all compute the same pointer,
+    // and the kernels it points to are immutable code.
+    FnPtr fn = cpu_dispatch_ptr_.load(std::memory_order_relaxed);
+    if (UNLIKELY(fn == nullptr)) {
+      fn = choose_cpu_impl();
+      cpu_dispatch_ptr_.store(fn, std::memory_order_relaxed);
+    }
+    return fn;
+  }
+
+  // the best registered kernel the capability allows; a kernel may opt out
+  // of a capability, in which case the next lower one is used
+  static FnPtr choose_cpu_impl() {
+    [[maybe_unused]] int capability = static_cast<int>(get_cpu_capability());
+#if defined(HAVE_AVX512_CPU_DEFINITION)
+    if (capability >= static_cast<int>(CPUCapability::AVX512) && AVX512) {
+      return AVX512;
+    }
+#endif
+#if defined(HAVE_AVX2_CPU_DEFINITION)
+    if (capability >= static_cast<int>(CPUCapability::AVX2) && AVX2) {
+      return AVX2;
+    }
+#endif
+    TORCH_INTERNAL_ASSERT(DEFAULT, "DispatchStub: missing default kernel");
+    return DEFAULT;
+  }
+
+  std::atomic<FnPtr> cpu_dispatch_ptr_{nullptr};
+
+ public:
+  // one per capability, defined by REGISTER_*_DISPATCH
+  static TORCH_API FnPtr DEFAULT;
+#if defined(HAVE_AVX2_CPU_DEFINITION)
+  static TORCH_API FnPtr AVX2;
+#endif
+#if defined(HAVE_AVX512_CPU_DEFINITION)
+  static TORCH_API FnPtr AVX512;
+#endif
+};
+
+} // namespace at::native
+
+// declares the kernel pointer of one capability, which REGISTER_*_DISPATCH
+// defines in exactly one translation unit
+#define DECLARE_ARCH_DISPATCH(name, arch)                                  \
+  template <>                                                              \
+  name##_DECLARE_DISPATCH_type::FnPtr TORCH_API at::native::DispatchStub<  \
+      name##_DECLARE_DISPATCH_type::FnPtr,                                 \
+      struct name##_DECLARE_DISPATCH_type>::arch;
+
+#if defined(HAVE_AVX2_CPU_DEFINITION)
+#define DECLARE_AVX2_DISPATCH(name) DECLARE_ARCH_DISPATCH(name, AVX2)
+#else
+#define DECLARE_AVX2_DISPATCH(name)
+#endif
+
+#if defined(HAVE_AVX512_CPU_DEFINITION)
+#define DECLARE_AVX512_DISPATCH(name) DECLARE_ARCH_DISPATCH(name, AVX512)
+#else
+#define DECLARE_AVX512_DISPATCH(name)
+#endif
+
+#define DECLARE_DISPATCH(fn, name)                                         \
+  struct name##_DECLARE_DISPATCH_type                                      \
+      : at::native::DispatchStub<fn, name##_DECLARE_DISPATCH_type> {       \
+    name##_DECLARE_DISPATCH_type() = default;                              \
+    name##_DECLARE_DISPATCH_type(const name##_DECLARE_DISPATCH_type&) =    \
+        delete;                                                            \
+    name##_DECLARE_DISPATCH_type& operator=(                               \
+        const name##_DECLARE_DISPATCH_type&) = delete;                     \
+  };                                                                       \
+  extern TORCH_API struct name##_DECLARE_DISPATCH_type name;             \
+  DECLARE_ARCH_DISPATCH(name, DEFAULT)                                     \
+  DECLARE_AVX2_DISPATCH(name)                                              \
+  DECLARE_AVX512_DISPATCH(name)
+
+#define DEFINE_DISPATCH(name) struct name##_DECLARE_DISPATCH_type name
+
+#define REGISTER_ARCH_DISPATCH(name, arch, fn)                             \
+  template <>                                                              \
+  name##_DECLARE_DISPATCH_type::FnPtr TORCH_API at::native::DispatchStub<  \
+      name##_DECLARE_DISPATCH_type::FnPtr,                                 \
+      struct name##_DECLARE_DISPATCH_type>::arch = fn;
+
+#if defined(HAVE_AVX2_CPU_DEFINITION)
+#define REGISTER_AVX2_DISPATCH(name, fn) REGISTER_ARCH_DISPATCH(name, AVX2, fn)
+#else
+#define REGISTER_AVX2_DISPATCH(name, fn)
+#endif
+
+#if defined(HAVE_AVX512_CPU_DEFINITION)
+#define REGISTER_AVX512_DISPATCH(name, fn) \
+  REGISTER_ARCH_DISPATCH(name, AVX512, fn)
+#else
+#define REGISTER_AVX512_DISPATCH(name, fn)
+#endif
+
+// register `fn` for every capability, for kernels outside native/cpu/
+// that are not worth specializing
+#define REGISTER_ALL_CPU_DISPATCH(name, fn) \
+  REGISTER_ARCH_DISPATCH(name, DEFAULT, fn) \
+  REGISTER_AVX2_DISPATCH(name, fn)          \
+  REGISTER_AVX512_DISPATCH(name, fn)
+
+// In native/cpu/ kernels, which are compiled with CPU_CAPABILITY set to the
+// capability being built: register `fn` as that capability's kernel.
+// REGISTER_NO_CPU_DISPATCH lets a kernel opt out of the current capability
+// (the stub then falls back to a lower one).
+#if defined(CPU_CAPABILITY)
+#define REGISTER_DISPATCH(name, fn) \
+  REGISTER_ARCH_DISPATCH(name, CPU_CAPABILITY, fn)
+#define REGISTER_NO_CPU_DISPATCH(name) \
+  REGISTER_ARCH_DISPATCH(name, CPU_CAPABILITY, nullptr)
+#endif
@@ -0,0 +1,20 @@
+#include <ATen/NativeFunctions.h>
+#include <ATen/TensorIterator.h>
+#include <ATen/native/Fill.h>
+#include <ATen/native/InPlace.h>
+
+namespace at::native {
+
+DEFINE_DISPATCH(fill_stub);
+
+const Tensor& fill_(const Tensor& self, double value) {
+  if (self.numel() == 0) {
+    return self;
+  }
+  auto iter = TensorIterator::nullary_op(self);
+  fill_stub(kCPU, iter, value);
+  increment_version(self);
+  return self;
+}
+
+} // namespace at::native
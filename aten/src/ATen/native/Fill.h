@@ -0,0 +1,15 @@
+#pragma once
+
+#include <ATen/native/DispatchStub.h>
+
+namespace at {
+class TensorIterator;
+}
+
+namespace at::native {
+
+using fill_fn = void (*)(TensorIterator& iter, double value);
+
+DECLARE_DISPATCH(fill_fn, fill_stub);
+
+} // namespace at::native
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+
+namespace at::native {
+
+// Marks the writes of an in-place op to self as done. Taking the mutable
+// pointer bumped the storage version before the op wrote anything, so a
+// cache filled from self in between (see PrepackCache.h) would otherwise
+// keep the old values. Every op that writes to self calls this once it
+// returns.
+inline void increment_version(const Tensor& self) {
+  self.storage().bump_version();
+}
+
+} // namespace at::native
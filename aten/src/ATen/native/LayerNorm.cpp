@@ -0,0 +1,158 @@
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/InPlace.h>
+#include <ATen/native/LayerNorm.h>
+
+#include <limits>
+
+namespace at::native {
+
+DEFINE_DISPATCH(layer_norm_stub);
+DEFINE_DISPATCH(rms_norm_stub);
+
+namespace {
+
+// checks the operands of a norm over the trailing dims normalized_shape of
+// input
+void check_norm_operands(
+    const char* name,
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias) {
+  const ScalarType dtype = input.scalar_type();
+  TORCH_CHECK(
+      isFloatingType(dtype),
+      name,
+      "(): expected a Float, Double, Half or BFloat16 input, got ",
+      dtype);
+  const int64_t normalized_dims =
+      static_cast<int64_t>(normalized_shape.size());
+  TORCH_CHECK(
+      normalized_dims >= 1,
+      name,
+      "(): expected normalized_shape to be at least 1-dimensional");
+  TORCH_CHECK(
+      input.dim() >= normalized_dims and
+          input.sizes().slice(input.dim() - normalized_dims) ==
+              normalized_shape,
+      name,
+      "(): expected an input whose trailing dims are ",
+      normalized_shape,
+      ", got an input of size ",
+      input.sizes());
+  for (const std::optional<Tensor>& t : {weight, bias}) {
+    if (!t.has_value() or !t->defined()) {
+      continue;
+    }
+    TORCH_CHECK(
+        t->sizes() == normalized_shape and t->scalar_type() == dtype,
+        name,
+        "(): expected a ",
+        dtype,
+        " weight and bias of size ",
+        normalized_shape,
+        ", got ",
+        t->scalar_type(),
+        " ",
+        t->sizes());
+  }
+}
+
+Tensor defined_or_none(const std::optional<Tensor>& t) {
+  return t.has_value() ? *t : Tensor();
+}
+
+void layer_norm_into(
+    const Tensor& result,
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias,
+    double eps) {
+  check_norm_operands("layer_norm", input, normalized_shape, weight, bias);
+  if (input.numel() == 0) {
+    return;
+  }
+  layer_norm_stub(
+      kCPU,
+      result,
+      input,
+      static_cast<int64_t>(normalized_shape.size()),
+      defined_or_none(weight),
+      defined_or_none(bias),
+      eps);
+}
+
+void rms_norm_into(
+    const Tensor& result,
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight,
+    std::optional<double> eps) {
+  check_norm_operands(
+      "rms_norm", input, normalized_shape, weight, std::nullopt);
+  if (input.numel() == 0) {
+    return;
+  }
+  double default_eps = std::numeric_limits<float>::epsilon();
+  if (input.scalar_type() == ScalarType::Double) {
+    default_eps = std::numeric_limits<double>::epsilon();
+  } else if (input.scalar_type() == ScalarType::Half) {
+    default_eps = 0.0009765625; // 2^-10, the machine epsilon of Half
+  } else if (input.scalar_type() == ScalarType::BFloat16) {
+    default_eps = std::numeric_limits<c10::BFloat16>::epsilon();
+  }
+  rms_norm_stub(
+      kCPU,
+      result,
+      input,
+      static_cast<int64_t>(normalized_shape.size()),
+      defined_or_none(weight),
+      eps.value_or(default_eps));
+}
+
+} // namespace
+
+Tensor layer_norm(
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias,
+    double eps) {
+  Tensor result = empty(input.sizes(), input.scalar_type());
+  layer_norm_into(result, input, normalized_shape, weight, bias, eps);
+  return result;
+}
+
+const Tensor& layer_norm_(
+    const Tensor& self,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight,
+    const std::optional<Tensor>& bias,
+    double eps) {
+  layer_norm_into(self, self, normalized_shape, weight, bias, eps);
+  increment_version(self);
+  return self;
+}
+
+Tensor rms_norm(
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight,
+    std::optional<double> eps) {
+  Tensor result = empty(input.sizes(), input.scalar_type());
+  rms_norm_into(result, input, normalized_shape, weight, eps);
+  return result;
+}
+
+const Tensor& rms_norm_(
+    const Tensor& self,
+    IntArrayRef normalized_shape,
+    const std::optional<Tensor>& weight,
+    std::optional<double> eps) {
+  rms_norm_into(self, self, normalized_shape, weight, eps);
+  increment_version(self);
+  return self;
+}
+
+} // namespace at::native
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at::native {
+
+// Both normalize each row of input, the elements of its trailing
+// normalized_dims dims, into output, which has the sizes and dtype of input
+// and may be input itself. weight and bias have the sizes of a row, or are
+// undefined for none.
+
+// (x - mean) / sqrt(var + eps) * weight + bias, var biased
+using layer_norm_fn = void (*)(
+    const Tensor& output,
+    const Tensor& input,
+    int64_t normalized_dims,
+    const Tensor& weight,
+    const Tensor& bias,
+    double eps);
+
+// x / sqrt(mean(x^2) + eps) * weight
+using rms_norm_fn = void (*)(
+    const Tensor& output,
+    const Tensor& input,
+    int64_t normalized_dims,
+    const Tensor& weight,
+    double eps);
+
+DECLARE_DISPATCH(layer_norm_fn, layer_norm_stub);
+DECLARE_DISPATCH(rms_norm_fn, rms_norm_stub);
+
+} // namespace at::native
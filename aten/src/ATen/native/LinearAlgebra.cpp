@@ -0,0 +1,190 @@
+#include <ATen/Functions.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/CPUBlas.h>
+#include <ATen/native/PrepackCache.h>
+#include <ATen/native/SparseBlas.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace at::native {
+
+namespace {
+
+void check_mm_shapes(const Tensor& self, const Tensor& mat2) {
+  TORCH_CHECK(self.dim() == 2, "self must be a matrix, got ", self.dim(), "-D");
+  TORCH_CHECK(mat2.dim() == 2, "mat2 must be a matrix, got ", mat2.dim(), "-D");
+  TORCH_CHECK(
+      self.size(1) == mat2.size(0),
+      "mat1 and mat2 shapes cannot be multiplied (",
+      self.size(0),
+      "x",
+      self.size(1),
+      " and ",
+      mat2.size(0),
+      "x",
+      mat2.size(1),
+      ")");
+}
+
+// the product of self and mat2 as a GEMM, without C
+cpublas::GemmParams mm_params(const Tensor& self, const Tensor& mat2) {
+  cpublas::GemmParams params;
+  params.dtype = self.scalar_type();
+  params.m = self.size(0);
+  params.n = mat2.size(1);
+  params.k = self.size(1);
+  params.a = self.const_data_ptr();
+  params.a_row_stride = self.stride(0);
+  params.a_col_stride = self.stride(1);
+  params.b = mat2.const_data_ptr();
+  params.b_row_stride = mat2.stride(0);
+  params.b_col_stride = mat2.stride(1);
+  return params;
+}
+
+} // namespace
+
+Tensor mm(const Tensor& self, const Tensor& mat2) {
+  check_mm_shapes(self, mat2);
+  if (self.layout() != kStrided) {
+    return sparse_mm(self, mat2);
+  }
+  TORCH_CHECK(
+      mat2.layout() == kStrided,
+      "mm: expected a strided mat2 for a strided self, got ",
+      mat2.layout(),
+      "; densify it with to_dense() or make self the sparse operand");
+  TORCH_CHECK(
+      self.scalar_type() == mat2.scalar_type(),
+      "expected mat1 and mat2 to have the same dtype, but got: ",
+      self.scalar_type(),
+      " != ",
+      mat2.scalar_type());
+  Tensor result = empty({self.size(0), mat2.size(1)}, self.scalar_type());
+  cpublas::GemmParams params = mm_params(self, mat2);
+  const std::optional<cpublas::PackedB> packed =
+      find_prepacked_mm_weight(mat2);
+  if (packed) {
+    params.b_packed = &*packed;
+  }
+  params.c = result.mutable_data_ptr();
+  params.c_row_stride = result.stride(0);
+  params.c_col_stride = result.stride(1);
+  cpublas::gemm(params);
+  return result;
+}
+
+Tensor scaled_mm(const Tensor& self, const Tensor& mat2, double scale) {
+  check_mm_shapes(self, mat2);
+  TORCH_CHECK(
+      self.layout() == kStrided and mat2.layout() == kStrided,
+      "scaled_mm: expected strided operands, got ",
+      self.layout(),
+      " and ",
+      mat2.layout());
+  TORCH_CHECK(
+      isFloat8Type(mat2.scalar_type()),
+      "scaled_mm: expected a Float8 mat2, got ",
+      mat2.scalar_type());
+  TORCH_CHECK(
+      std::isfinite(scale), "scaled_mm: expected a finite scale, got ", scale);
+  Tensor result = empty({self.size(0), mat2.size(1)}, self.scalar_type());
+  cpublas::GemmParams params = mm_params(self, mat2);
+  params.b_dtype = mat2.scalar_type();
+  params.b_scale = scale;
+  params.c = result.mutable_data_ptr();
+  params.c_row_stride = result.stride(0);
+  params.c_col_stride = result.stride(1);
+  cpublas::gemm(params);
+  return result;
+}
+
+Tensor quantized_linear(
+    const Tensor& input,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    double output_scale,
+    int64_t output_zero_point) {
+  TORCH_CHECK(
+      input.scalar_type() == ScalarType::QUInt8 and input.dim() == 2 and
+          input.qscheme() == kPerTensorAffine,
+      "quantized_linear: expected a 2-D QUInt8 input quantized per tensor");
+  TORCH_CHECK(
+      weight.scalar_type() == ScalarType::QInt8 and weight.dim() == 2,
+      "quantized_linear: expected a 2-D QInt8 weight");
+  TORCH_CHECK(
+      input.size(1) == weight.size(1),
+      "quantized_linear: input of size ",
+      input.sizes(),
+      " and weight of size ",
+      weight.sizes(),
+      " differ in the number of input features");
+  const int64_t n = weight.size(0);
+  const bool per_channel = weight.qscheme() == kPerChannelAffine;
+  TORCH_CHECK(
+      !per_channel or weight.q_per_channel_axis() == 0,
+      "quantized_linear: a weight quantized per channel must be so along "
+      "its output features, dim 0");
+  // the scale of each output feature's sums, and its weight zero point
+  std::vector<float> scales(n);
+  std::vector<int32_t> zero_points(n);
+  if (per_channel) {
+    const Tensor w_scales = weight.q_per_channel_scales();
+    const Tensor w_zero_points = weight.q_per_channel_zero_points();
+    for (int64_t j = 0; j < n; ++j) {
+      scales[j] = static_cast<float>(
+          input.q_scale() * w_scales.const_data_ptr<double>()[j]);
+      zero_points[j] =
+          static_cast<int32_t>(w_zero_points.const_data_ptr<int64_t>()[j]);
+    }
+  } else {
+    std::fill(
+        scales.begin(),
+        scales.end(),
+        static_cast<float>(input.q_scale() * weight.q_scale()));
+    std::fill(
+        zero_points.begin(),
+        zero_points.end(),
+        static_cast<int32_t>(weight.q_zero_point()));
+  }
+  Tensor bias_data;
+  if (bias.has_value() and bias->defined()) {
+    TORCH_CHECK(
+        bias->scalar_type() == ScalarType::Float and bias->dim() == 1 and
+            bias->size(0) == n,
+        "quantized_linear: expected a Float bias of ",
+        n,
+        " values");
+    bias_data = bias->is_contiguous() ? *bias : empty({n}).copy_(*bias);
+  }
+  Tensor result = _empty_affine_quantized(
+      {input.size(0), n}, ScalarType::QUInt8, output_scale, output_zero_point);
+  cpublas::QGemmParams params;
+  params.m = input.size(0);
+  params.n = n;
+  params.k = input.size(1);
+  params.a = static_cast<const uint8_t*>(input.const_data_ptr());
+  params.a_row_stride = input.stride(0);
+  params.a_col_stride = input.stride(1);
+  params.a_zero_point = static_cast<int32_t>(input.q_zero_point());
+  // B is the transposed weight
+  params.b = static_cast<const int8_t*>(weight.const_data_ptr());
+  params.b_row_stride = weight.stride(1);
+  params.b_col_stride = weight.stride(0);
+  params.b_zero_points = zero_points.data();
+  params.c_dtype = ScalarType::Byte;
+  params.scales = scales.data();
+  params.bias = bias_data.defined() ? bias_data.const_data_ptr<float>()
+                                    : nullptr;
+  params.c_scale = output_scale;
+  params.c_zero_point = static_cast<int32_t>(output_zero_point);
+  params.c = result.mutable_data_ptr();
+  params.c_row_stride = result.stride(0);
+  params.c_col_stride = result.stride(1);
+  cpublas::qgemm(params);
+  return result;
+}
+
+} // namespace at::native
@@ -0,0 +1,281 @@
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/CPUBlas.h>
+#include <ATen/native/Packed4Bit.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace at::native {
+
+DEFINE_DISPATCH(linear_4bit_stub);
+
+namespace {
+
+// Inputs of at least this many rows rather decode the weight to Float once
+// and multiply it with the blocked GEMM, which reuses it from cache across
+// rows; the kernel of linear_4bit_stub decodes it for every few rows.
+constexpr int64_t kDecodeMinRows = 128;
+
+void check_4bit_dtype(const char* name, ScalarType dtype) {
+  TORCH_CHECK(
+      isSubByteType(dtype),
+      name,
+      ": expected an Int4 or NF4 dtype, got ",
+      dtype);
+}
+
+// the largest magnitude a scale of 1 encodes
+float max_code_value(ScalarType dtype) {
+  return dtype == ScalarType::Int4 ? 7.0f : 1.0f;
+}
+
+// self as a contiguous Float tensor
+Tensor contiguous_float(const char* name, const Tensor& self) {
+  TORCH_CHECK(
+      isFloatingType(self.scalar_type()),
+      name,
+      ": expected a floating tensor, got ",
+      self.scalar_type());
+  if (self.scalar_type() == ScalarType::Float and self.is_contiguous()) {
+    return self;
+  }
+  return empty(self.sizes(), ScalarType::Float).copy_(self);
+}
+
+// Checks the scales of a [n, k] weight, returns the group size.
+int64_t check_scales(
+    const char* name,
+    IntArrayRef weight_sizes,
+    const Tensor& scales) {
+  TORCH_CHECK(
+      scales.scalar_type() == ScalarType::Half and scales.dim() == 2 and
+          scales.size(0) == weight_sizes[0],
+      name,
+      ": expected Half scales with a row per weight row, ",
+      weight_sizes[0],
+      ", got ",
+      scales.scalar_type(),
+      " scales of size ",
+      scales.sizes());
+  const int64_t k = weight_sizes[1];
+  const int64_t groups = scales.size(1);
+  const int64_t group_size = groups > 0 ? k / groups : 0;
+  TORCH_CHECK(
+      group_size * groups == k and group_size % 2 == 0,
+      name,
+      ": ",
+      groups,
+      " groups do not split rows of ",
+      k,
+      " elements into groups of an even size");
+  return group_size;
+}
+
+// the scales contiguous, as kernels read them
+Tensor contiguous_scales(const Tensor& scales) {
+  if (scales.is_contiguous()) {
+    return scales;
+  }
+  return empty(scales.sizes(), ScalarType::Half).copy_(scales);
+}
+
+} // namespace
+
+Tensor scales_4bit(const Tensor& weight, ScalarType dtype, int64_t group_size) {
+  check_4bit_dtype("scales_4bit", dtype);
+  TORCH_CHECK(
+      weight.dim() == 2,
+      "scales_4bit: expected a 2-D weight, got ",
+      weight.dim(),
+      " dims");
+  TORCH_CHECK(
+      group_size > 0 and group_size % 2 == 0 and
+          weight.size(1) % group_size == 0,
+      "scales_4bit: expected an even group size that divides the ",
+      weight.size(1),
+      " columns, got ",
+      group_size);
+  const Tensor w = contiguous_float("scales_4bit", weight);
+  const int64_t n = w.size(0);
+  const int64_t k = w.size(1);
+  const int64_t groups = k / group_size;
+  Tensor scales = empty({n, groups}, ScalarType::Half);
+  const float* w_data = w.const_data_ptr<float>();
+  c10::Half* scale_data = scales.mutable_data_ptr<c10::Half>();
+  const float max_code = max_code_value(dtype);
+  parallel_for(
+      0,
+      n * groups,
+      std::max<int64_t>(1, internal::GRAIN_SIZE / group_size),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t g = begin; g < end; ++g) {
+          const float* x = w_data + g * group_size;
+          float max = 0;
+          for (int64_t i = 0; i < group_size; ++i) {
+            max = std::max(max, std::abs(x[i]));
+          }
+          // an all-zero group encodes to zeros whatever its scale
+          const c10::Half scale(max / max_code);
+          TORCH_CHECK(
+              std::isfinite(static_cast<float>(scale)),
+              "scales_4bit: the largest magnitude ",
+              max,
+              " of a group has no finite Half scale");
+          scale_data[g] = scale;
+        }
+      });
+  return scales;
+}
+
+Tensor to_4bit(const Tensor& weight, ScalarType dtype, const Tensor& scales) {
+  check_4bit_dtype("to_4bit", dtype);
+  TORCH_CHECK(
+      weight.dim() == 2,
+      "to_4bit: expected a 2-D weight, got ",
+      weight.dim(),
+      " dims");
+  const int64_t group_size = check_scales("to_4bit", weight.sizes(), scales);
+  const Tensor w = contiguous_float("to_4bit", weight);
+  const Tensor s = contiguous_scales(scales);
+  Tensor packed = empty(w.sizes(), dtype);
+  if (packed.numel() == 0) {
+    return packed;
+  }
+  const float* w_data = w.const_data_ptr<float>();
+  const c10::Half* scale_data = s.const_data_ptr<c10::Half>();
+  auto* out = static_cast<uint8_t*>(packed.mutable_data_ptr());
+  const bool int4 = dtype == ScalarType::Int4;
+  // the code of x, a value already divided by its scale
+  const auto encode = [int4](float x) -> uint8_t {
+    if (int4) {
+      const float q = std::clamp(std::nearbyint(x), -8.0f, 7.0f);
+      return static_cast<uint8_t>(static_cast<int>(q) & 0xF);
+    }
+    return c10::nf4_code(x);
+  };
+  parallel_for(
+      0,
+      w.numel() / group_size,
+      std::max<int64_t>(1, internal::GRAIN_SIZE / group_size),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t g = begin; g < end; ++g) {
+          const float scale = static_cast<float>(scale_data[g]);
+          const float inv_scale = scale == 0 ? 0 : 1 / scale;
+          const float* x = w_data + g * group_size;
+          uint8_t* codes = out + g * group_size / 2;
+          for (int64_t i = 0; i < group_size; i += 2) {
+            codes[i / 2] = static_cast<uint8_t>(
+                encode(x[i] * inv_scale) | encode(x[i + 1] * inv_scale) << 4);
+          }
+        }
+      });
+  return packed;
+}
+
+Tensor from_4bit(const Tensor& self, const Tensor& scales) {
+  check_4bit_dtype("from_4bit", self.scalar_type());
+  TORCH_CHECK(
+      self.dim() == 2,
+      "from_4bit: expected a 2-D weight, got ",
+      self.dim(),
+      " dims");
+  const int64_t group_size = check_scales("from_4bit", self.sizes(), scales);
+  const Tensor s = contiguous_scales(scales);
+  Tensor result = empty(self.sizes(), ScalarType::Float);
+  if (result.numel() == 0) {
+    return result;
+  }
+  const auto* codes = static_cast<const uint8_t*>(self.const_data_ptr());
+  const c10::Half* scale_data = s.const_data_ptr<c10::Half>();
+  float* out = result.mutable_data_ptr<float>();
+  float values[16];
+  for (int code = 0; code < 16; ++code) {
+    values[code] = self.scalar_type() == ScalarType::Int4
+        ? static_cast<float>(c10::int4x2(static_cast<uint8_t>(code)).lo())
+        : c10::kNF4Values[code];
+  }
+  parallel_for(
+      0,
+      result.numel() / group_size,
+      std::max<int64_t>(1, internal::GRAIN_SIZE / group_size),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t g = begin; g < end; ++g) {
+          const float scale = static_cast<float>(scale_data[g]);
+          const uint8_t* in = codes + g * group_size / 2;
+          float* x = out + g * group_size;
+          for (int64_t i = 0; i < group_size; i += 2) {
+            x[i] = values[in[i / 2] & 0xF] * scale;
+            x[i + 1] = values[in[i / 2] >> 4] * scale;
+          }
+        }
+      });
+  return result;
+}
+
+Tensor linear_4bit(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& scales,
+    const std::optional<Tensor>& bias) {
+  check_4bit_dtype("linear_4bit", weight.scalar_type());
+  TORCH_CHECK(
+      input.dim() == 2 and weight.dim() == 2,
+      "linear_4bit: expected a 2-D input and weight, got ",
+      input.dim(),
+      " and ",
+      weight.dim(),
+      " dims");
+  TORCH_CHECK(
+      input.size(1) == weight.size(1),
+      "linear_4bit: input of size ",
+      input.sizes(),
+      " and weight of size ",
+      weight.sizes(),
+      " differ in the number of input features");
+  check_scales("linear_4bit", weight.sizes(), scales);
+  const int64_t n = weight.size(0);
+  Tensor b;
+  if (bias.has_value() and bias->defined()) {
+    TORCH_CHECK(
+        bias->dim() == 1 and bias->size(0) == n,
+        "linear_4bit: expected a bias of size [",
+        n,
+        "], got ",
+        bias->sizes());
+    b = contiguous_float("linear_4bit", *bias);
+  }
+  const Tensor x = contiguous_float("linear_4bit", input);
+  const int64_t m = x.size(0);
+  Tensor result = empty({m, n}, ScalarType::Float);
+  if (result.numel() == 0) {
+    return result;
+  }
+  if (m < kDecodeMinRows) {
+    linear_4bit_stub(kCPU, result, x, weight, contiguous_scales(scales), b);
+    return result;
+  }
+  const Tensor w = from_4bit(weight, scales);
+  cpublas::GemmParams params;
+  params.m = m;
+  params.n = n;
+  params.k = x.size(1);
+  params.a = x.const_data_ptr();
+  params.a_row_stride = x.stride(0);
+  params.a_col_stride = x.stride(1);
+  // w^T
+  params.b = w.const_data_ptr();
+  params.b_row_stride = w.stride(1);
+  params.b_col_stride = w.stride(0);
+  if (b.defined()) {
+    result.copy_(b.expand({m, n}));
+    params.beta = 1;
+  }
+  params.c = result.mutable_data_ptr();
+  params.c_row_stride = result.stride(0);
+  params.c_col_stride = result.stride(1);
+  cpublas::gemm(params);
+  return result;
+}
+
+} // namespace at::native
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <ATen/native/DispatchStub.h>
+
+// Weights quantized to 4 bits in groups: an Int4 or NF4 weight of sizes
+// [n, k] holds codes, two per byte (see c10/util/int4x2.h and nf4x2.h), and
+// Half scales of sizes [n, k / group_size] one scale per group of
+// group_size consecutive elements of a row. An element stands for
+//
+//   decode(code) * scales[j][i / group_size]
+//
+// with decode() the integer itself for Int4 and the NF4 value of the code
+// for NF4. group_size is even, so no byte straddles two groups or rows.
+
+namespace at::native {
+
+// output[i][j] = sum_l input[i][l] * w[j][l] + bias[j], with w the decoded
+// and scaled weight; output is Float [m, n], input Float [m, k], bias Float
+// [n] or undefined for none, all contiguous like weight and scales
+using linear_4bit_fn = void (*)(
+    const Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& scales,
+    const Tensor& bias);
+
+DECLARE_DISPATCH(linear_4bit_fn, linear_4bit_stub);
+
+} // namespace at::native
@@ -0,0 +1,209 @@
+#include <ATen/native/PrepackCache.h>
+#include <c10/cpu/impl/alloc.h>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace at::native {
+
+namespace {
+
+// what mm reads of its second operand
+struct Key {
+  const c10::StorageImpl* storage;
+  int64_t storage_offset;
+  std::array<int64_t, 2> sizes;
+  std::array<int64_t, 2> strides;
+  ScalarType dtype;
+
+  explicit Key(const Tensor& t)
+      : storage(t.storage().unsafeGetStorageImpl()),
+        storage_offset(t.storage_offset()),
+        sizes{t.size(0), t.size(1)},
+        strides{t.stride(0), t.stride(1)},
+        dtype(t.scalar_type()) {}
+
+  bool operator==(const Key& other) const {
+    return storage == other.storage and
+        storage_offset == other.storage_offset and sizes == other.sizes and
+        strides == other.strides and dtype == other.dtype;
+  }
+};
+
+struct KeyHash {
+  size_t operator()(const Key& key) const {
+    size_t hash = std::hash<const void*>()(key.storage);
+    for (int64_t x : {key.storage_offset,
+                      key.sizes[0],
+                      key.sizes[1],
+                      key.strides[0],
+                      key.strides[1],
+                      static_cast<int64_t>(key.dtype)}) {
+      hash = hash * 31 + std::hash<int64_t>()(x);
+    }
+    return hash;
+  }
+};
+
+struct Entry {
+  Key key;
+  // keeps key.storage from being reused for another storage while the
+  // entry exists, and tells whether the weight was freed
+  c10::weak_intrusive_ptr<c10::StorageImpl> storage;
+  uint64_t version;
+  cpublas::PackedB packed;
+};
+
+// Nothing allocates with the CPU allocator while holding mutex_ (packing
+// happens before insert()), so that the allocator may call release_all()
+// from any thread.
+class PrepackCache {
+ public:
+  static PrepackCache& get() {
+    static PrepackCache cache;
+    return cache;
+  }
+
+  void insert(Entry entry) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      it = it->storage.expire() or it->key == entry.key ? erase(it)
+                                                        : std::next(it);
+    }
+    if (entry.packed.storage.nbytes() > limit_) {
+      return;
+    }
+    nbytes_ += entry.packed.storage.nbytes();
+    entries_.push_front(std::move(entry));
+    index_.emplace(entries_.front().key, entries_.begin());
+    count_.store(entries_.size(), std::memory_order_relaxed);
+    evict();
+  }
+
+  std::optional<cpublas::PackedB> find(const Key& key, uint64_t version) {
+    if (count_.load(std::memory_order_relaxed) == 0) {
+      return std::nullopt;
+    }
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+      return std::nullopt;
+    }
+    auto it = found->second;
+    if (it->version != version) {
+      erase(it);
+      return std::nullopt;
+    }
+    entries_.splice(entries_.begin(), entries_, it);
+    return it->packed;
+  }
+
+  void set_limit(size_t nbytes) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    limit_ = nbytes;
+    evict();
+  }
+
+  size_t nbytes() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return nbytes_;
+  }
+
+  bool release_all() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    const bool released = nbytes_ > 0;
+    while (!entries_.empty()) {
+      erase(entries_.begin());
+    }
+    return released;
+  }
+
+ private:
+  PrepackCache() = default;
+
+  std::list<Entry>::iterator erase(std::list<Entry>::iterator it) {
+    nbytes_ -= it->packed.storage.nbytes();
+    index_.erase(it->key);
+    auto next = entries_.erase(it);
+    count_.store(entries_.size(), std::memory_order_relaxed);
+    return next;
+  }
+
+  // least recently used entries first, down to the limit
+  void evict() {
+    while (nbytes_ > limit_) {
+      erase(std::prev(entries_.end()));
+    }
+  }
+
+  std::mutex mutex_;
+  // most recently used first
+  std::list<Entry> entries_;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+  size_t nbytes_ = 0;
+  size_t limit_ = std::numeric_limits<size_t>::max();
+  // entries_.size(), read without the lock so that mm skips the lookup
+  // while the cache is unused
+  std::atomic<size_t> count_{0};
+};
+
+bool release_prepack_cache() {
+  return PrepackCache::get().release_all();
+}
+
+const bool registered_free_memory_callback =
+    (c10::add_free_memory_callback(&release_prepack_cache), true);
+
+void check_mm_weight(const char* name, const Tensor& weight) {
+  // the cache keys on the storage, which sparse tensors don't have
+  TORCH_CHECK(
+      weight.layout() == kStrided,
+      name,
+      ": expected a strided weight, got ",
+      weight.layout());
+  TORCH_CHECK(
+      weight.dim() == 2, name, ": expected a matrix, got ", weight.dim(), "-D");
+}
+
+} // namespace
+
+void prepack_mm_weight(const Tensor& weight) {
+  check_mm_weight("prepack_mm_weight", weight);
+  Entry entry{Key(weight), weight.storage().getWeakStorageImpl()};
+  // read before packing: a concurrent write leaves the entry stale
+  entry.version = weight.storage().version();
+  cpublas::GemmParams params;
+  params.dtype = weight.scalar_type();
+  params.k = weight.size(0);
+  params.n = weight.size(1);
+  params.b = weight.const_data_ptr();
+  params.b_row_stride = weight.stride(0);
+  params.b_col_stride = weight.stride(1);
+  entry.packed = cpublas::pack_b(params);
+  PrepackCache::get().insert(std::move(entry));
+}
+
+std::optional<cpublas::PackedB> find_prepacked_mm_weight(
+    const Tensor& weight) {
+  check_mm_weight("find_prepacked_mm_weight", weight);
+  return PrepackCache::get().find(Key(weight), weight.storage().version());
+}
+
+void empty_prepack_cache() {
+  PrepackCache::get().release_all();
+}
+
+size_t prepack_cache_nbytes() {
+  return PrepackCache::get().nbytes();
+}
+
+void set_prepack_cache_limit(size_t nbytes) {
+  PrepackCache::get().set_limit(nbytes);
+}
+
+} // namespace at::native
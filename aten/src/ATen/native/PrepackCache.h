@@ -0,0 +1,45 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <ATen/native/CPUBlas.h>
+
+#include <cstddef>
+#include <optional>
+
+namespace at::native {
+
+// Weights packed for mm once and kept across calls.
+//
+// prepack_mm_weight(weight) packs `weight`, the k x n right operand of mm,
+// into the blocked layout of the gemm kernel (cpublas::pack_b) and caches
+// it. mm(x, w) then reads the packed copy for any w with the storage,
+// storage offset, sizes, strides and dtype of `weight` (e.g. another
+// `linear.t()` of the same parameter) instead of packing w on every call.
+//
+// An entry remembers the version of the storage it was packed from (see
+// c10::StorageImpl::version()): once the weight may have been written to,
+// the entry is stale and dropped on its next lookup. The version counts
+// mutable accesses and in-place ops, not writes: after writing through a
+// pointer obtained before the weight was packed, e.g. from
+// mutable_data_ptr(), call weight.storage().bump_version(), pack the weight
+// again or empty_prepack_cache(), or mm keeps reading the old values.
+//
+// Entries of storages that were freed are dropped when another weight is
+// packed. The cache evicts least recently used entries beyond its byte
+// limit, and all of them when the CPU allocator runs out of memory.
+TORCH_API void prepack_mm_weight(const Tensor& weight);
+
+// the packed copy of `weight` if the cache holds an up to date one
+TORCH_API std::optional<cpublas::PackedB> find_prepacked_mm_weight(
+    const Tensor& weight);
+
+TORCH_API void empty_prepack_cache();
+
+// bytes of packed data the cache holds
+TORCH_API size_t prepack_cache_nbytes();
+
+// the most bytes of packed data the cache holds, unlimited by default; a
+// lower limit evicts right away
+TORCH_API void set_prepack_cache_limit(size_t nbytes);
+
+} // namespace at::native
@@ -0,0 +1,153 @@
+#include <ATen/Functions.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/quantized/QTensorImpl.h>
+#include <ATen/quantized/Quantizer.h>
+#include <c10/core/WrapDimMinimal.h>
+
+namespace at::native {
+
+namespace {
+
+// a plain tensor of the integers of the quantized self, sharing its storage
+Tensor int_view(const Tensor& self) {
+  auto impl = c10::make_intrusive<TensorImpl>(
+      TensorImpl::VIEW,
+      Storage(self.storage()),
+      TypeMeta(toUnderlying(self.scalar_type())));
+  impl->set_sizes_and_strides(
+      self.sizes(), self.strides(), self.storage_offset());
+  return Tensor(std::move(impl));
+}
+
+// the quantized dtype holding the integers of dtype
+ScalarType quantized_type_of(const char* name, ScalarType dtype) {
+  switch (dtype) {
+    case ScalarType::Char:
+      return ScalarType::QInt8;
+    case ScalarType::Byte:
+      return ScalarType::QUInt8;
+    case ScalarType::Int:
+      return ScalarType::QInt32;
+    default:
+      TORCH_CHECK(
+          false, name, ": expected a Char, Byte or Int tensor, got ", dtype);
+  }
+}
+
+// a copy of the integers of self, as a tensor quantized by quantizer
+Tensor make_quantized_tensor(const Tensor& self, QuantizerPtr quantizer) {
+  Tensor qtensor = new_qtensor(self.sizes(), std::move(quantizer));
+  if (self.numel() > 0) {
+    int_view(qtensor).copy_(self);
+  }
+  return qtensor;
+}
+
+const PerTensorAffineQuantizer& per_tensor_quantizer(
+    const Tensor& self,
+    const char* name) {
+  const auto& quantizer = get_qtensorimpl(self)->quantizer();
+  TORCH_CHECK(
+      quantizer->qscheme() == kPerTensorAffine,
+      name,
+      "(): expected a tensor quantized per tensor, got ",
+      quantizer->qscheme());
+  return static_cast<const PerTensorAffineQuantizer&>(*quantizer);
+}
+
+const PerChannelAffineQuantizer& per_channel_quantizer(
+    const Tensor& self,
+    const char* name) {
+  const auto& quantizer = get_qtensorimpl(self)->quantizer();
+  TORCH_CHECK(
+      quantizer->qscheme() == kPerChannelAffine,
+      name,
+      "(): expected a tensor quantized per channel, got ",
+      quantizer->qscheme());
+  return static_cast<const PerChannelAffineQuantizer&>(*quantizer);
+}
+
+} // namespace
+
+Tensor quantize_per_tensor(
+    const Tensor& self,
+    double scale,
+    int64_t zero_point,
+    ScalarType dtype) {
+  return make_per_tensor_affine_quantizer(scale, zero_point, dtype)
+      ->quantize(self);
+}
+
+Tensor quantize_per_channel(
+    const Tensor& self,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis,
+    ScalarType dtype) {
+  axis = c10::maybe_wrap_dim(axis, self.dim());
+  return make_per_channel_affine_quantizer(scales, zero_points, axis, dtype)
+      ->quantize(self);
+}
+
+Tensor dequantize(const Tensor& self) {
+  return get_qtensorimpl(self)->quantizer()->dequantize(self);
+}
+
+Tensor int_repr(const Tensor& self) {
+  get_qtensorimpl(self);
+  return int_view(self).to(toUnderlying(self.scalar_type()), true);
+}
+
+Tensor _make_per_tensor_quantized_tensor(
+    const Tensor& self,
+    double scale,
+    int64_t zero_point) {
+  const ScalarType dtype = quantized_type_of(
+      "_make_per_tensor_quantized_tensor", self.scalar_type());
+  return make_quantized_tensor(
+      self, make_per_tensor_affine_quantizer(scale, zero_point, dtype));
+}
+
+Tensor _make_per_channel_quantized_tensor(
+    const Tensor& self,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis) {
+  const ScalarType dtype = quantized_type_of(
+      "_make_per_channel_quantized_tensor", self.scalar_type());
+  axis = c10::maybe_wrap_dim(axis, self.dim());
+  return make_quantized_tensor(
+      self,
+      make_per_channel_affine_quantizer(scales, zero_points, axis, dtype));
+}
+
+QScheme qscheme(const Tensor& self) {
+  return get_qtensorimpl(self)->quantizer()->qscheme();
+}
+
+double q_scale(const Tensor& self) {
+  return per_tensor_quantizer(self, "q_scale").scale();
+}
+
+int64_t q_zero_point(const Tensor& self) {
+  return per_tensor_quantizer(self, "q_zero_point").zero_point();
+}
+
+Tensor q_per_channel_scales(const Tensor& self) {
+  // a copy, the quantizer's own never changes
+  return per_channel_quantizer(self, "q_per_channel_scales")
+      .scales()
+      .to(ScalarType::Double, true);
+}
+
+Tensor q_per_channel_zero_points(const Tensor& self) {
+  return per_channel_quantizer(self, "q_per_channel_zero_points")
+      .zero_points()
+      .to(ScalarType::Long, true);
+}
+
+int64_t q_per_channel_axis(const Tensor& self) {
+  return per_channel_quantizer(self, "q_per_channel_axis").axis();
+}
+
+} // namespace at::native
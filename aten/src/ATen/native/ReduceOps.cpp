@@ -0,0 +1,244 @@
+#include <ATen/NativeFunctions.h>
+#include <ATen/TensorIterator.h>
+#include <ATen/native/ReduceOps.h>
+#include <c10/core/WrapDimMinimal.h>
+
+#include <bitset>
+#include <cmath>
+#include <vector>
+
+namespace at::native {
+
+DEFINE_DISPATCH(sum_stub);
+DEFINE_DISPATCH(mean_stub);
+DEFINE_DISPATCH(max_values_stub);
+DEFINE_DISPATCH(min_values_stub);
+DEFINE_DISPATCH(argmax_stub);
+DEFINE_DISPATCH(argmin_stub);
+DEFINE_DISPATCH(norm_stub);
+
+namespace {
+
+constexpr size_t kMaxReduceDims = 64;
+using DimMask = std::bitset<kMaxReduceDims>;
+
+// the dims to reduce over; no dims means all of them
+DimMask make_dim_mask(IntArrayRef dims, int64_t ndim) {
+  TORCH_CHECK(
+      ndim <= static_cast<int64_t>(kMaxReduceDims),
+      "reductions support at most ",
+      kMaxReduceDims,
+      " dims, got a tensor with ",
+      ndim);
+  DimMask mask;
+  if (dims.empty()) {
+    mask.flip();
+    return mask;
+  }
+  for (int64_t dim : dims) {
+    const int64_t wrapped = c10::maybe_wrap_dim(dim, ndim);
+    TORCH_CHECK(
+        !mask[wrapped],
+        "dim ",
+        wrapped,
+        " appears multiple times in the list of dims");
+    mask.set(wrapped);
+  }
+  return mask;
+}
+
+void check_nonempty_reduction(
+    const char* name,
+    const Tensor& self,
+    const DimMask& mask) {
+  for (int64_t dim = 0; dim < self.dim(); ++dim) {
+    TORCH_CHECK(
+        !mask[dim] or self.size(dim) != 0,
+        name,
+        "(): Expected reduction dim ",
+        dim,
+        " to have non-zero size.");
+  }
+}
+
+// The result of reducing `self` over the dims in `mask` with those dims kept
+// as size 1, and the iterator that computes it from `self`.
+struct Reduction {
+  Reduction(
+      const Tensor& self,
+      const DimMask& mask,
+      ScalarType dtype,
+      bool linear = false)
+      : result(make_result(self, mask, dtype)),
+        iter(make_iterator(result, self, mask, linear)) {}
+
+  static Tensor make_result(
+      const Tensor& self,
+      const DimMask& mask,
+      ScalarType dtype) {
+    std::vector<int64_t> shape(self.sizes().begin(), self.sizes().end());
+    for (int64_t dim = 0; dim < self.dim(); ++dim) {
+      if (mask[dim]) {
+        shape[dim] = 1;
+      }
+    }
+    return empty(shape, dtype);
+  }
+
+  // the iterator's output is `result` viewed with the shape of `self` and
+  // stride 0 in the reduced dims
+  static TensorIterator make_iterator(
+      const Tensor& result,
+      const Tensor& self,
+      const DimMask& mask,
+      bool linear) {
+    std::vector<int64_t> strides(
+        result.strides().begin(), result.strides().end());
+    for (int64_t dim = 0; dim < self.dim(); ++dim) {
+      if (mask[dim]) {
+        strides[dim] = 0;
+      }
+    }
+    Tensor restrided = result.as_strided(self.sizes(), strides);
+    if (!linear) {
+      return TensorIterator::reduce_op(restrided, self);
+    }
+    return TensorIteratorConfig()
+        .add_output(restrided)
+        .add_input(self)
+        .check_all_same_dtype(false)
+        .is_reduction(true)
+        .enforce_linear_iteration()
+        .build();
+  }
+
+  // the result, without the reduced dims unless keepdim
+  Tensor finish(const DimMask& mask, bool keepdim) const {
+    if (keepdim) {
+      return result;
+    }
+    std::vector<int64_t> shape;
+    for (int64_t dim = 0; dim < result.dim(); ++dim) {
+      if (!mask[dim]) {
+        shape.push_back(result.size(dim));
+      }
+    }
+    return result.view(shape);
+  }
+
+  Tensor result;
+  TensorIterator iter;
+};
+
+ScalarType sum_dtype(ScalarType dtype) {
+  if (dtype == ScalarType::UInt16 or dtype == ScalarType::UInt32 or
+      dtype == ScalarType::UInt64) {
+    return ScalarType::UInt64;
+  }
+  if (isIntegralType(dtype, /*includeBool=*/true)) {
+    return ScalarType::Long;
+  }
+  return dtype;
+}
+
+void check_floating(const char* name, const Tensor& self) {
+  TORCH_CHECK(
+      isFloatingType(self.scalar_type()),
+      name,
+      "(): input dtype should be a floating point dtype, got ",
+      self.scalar_type());
+}
+
+Tensor arg_reduce(
+    const char* name,
+    const Tensor& self,
+    std::optional<int64_t> dim,
+    bool keepdim,
+    bool is_max) {
+  DimMask mask;
+  if (dim.has_value()) {
+    mask = make_dim_mask(*dim, self.dim());
+  } else {
+    TORCH_CHECK(
+        self.numel() != 0,
+        name,
+        "(): Expected reduction dim to be specified for input.numel() == 0.");
+    // the index into the flattened tensor
+    mask = make_dim_mask({}, self.dim());
+  }
+  check_nonempty_reduction(name, self, mask);
+  Reduction reduction(self, mask, ScalarType::Long, /*linear=*/true);
+  if (is_max) {
+    argmax_stub(kCPU, reduction.iter);
+  } else {
+    argmin_stub(kCPU, reduction.iter);
+  }
+  return reduction.finish(mask, keepdim);
+}
+
+} // namespace
+
+Tensor sum(const Tensor& self, IntArrayRef dim, bool keepdim) {
+  const DimMask mask = make_dim_mask(dim, self.dim());
+  Reduction reduction(self, mask, sum_dtype(self.scalar_type()));
+  sum_stub(kCPU, reduction.iter);
+  return reduction.finish(mask, keepdim);
+}
+
+Tensor mean(const Tensor& self, IntArrayRef dim, bool keepdim) {
+  check_floating("mean", self);
+  const DimMask mask = make_dim_mask(dim, self.dim());
+  Reduction reduction(self, mask, self.scalar_type());
+  mean_stub(kCPU, reduction.iter);
+  return reduction.finish(mask, keepdim);
+}
+
+Tensor amax(const Tensor& self, IntArrayRef dim, bool keepdim) {
+  const DimMask mask = make_dim_mask(dim, self.dim());
+  check_nonempty_reduction("amax", self, mask);
+  Reduction reduction(self, mask, self.scalar_type());
+  max_values_stub(kCPU, reduction.iter);
+  return reduction.finish(mask, keepdim);
+}
+
+Tensor amin(const Tensor& self, IntArrayRef dim, bool keepdim) {
+  const DimMask mask = make_dim_mask(dim, self.dim());
+  check_nonempty_reduction("amin", self, mask);
+  Reduction reduction(self, mask, self.scalar_type());
+  min_values_stub(kCPU, reduction.iter);
+  return reduction.finish(mask, keepdim);
+}
+
+Tensor max(const Tensor& self) {
+  TORCH_CHECK(
+      self.numel() > 0,
+      "max(): Expected reduction dim to be specified for input.numel() == 0. "
+      "Specify the reduction dim with the 'dim' argument.");
+  return amax(self, {}, /*keepdim=*/false);
+}
+
+Tensor min(const Tensor& self) {
+  TORCH_CHECK(
+      self.numel() > 0,
+      "min(): Expected reduction dim to be specified for input.numel() == 0. "
+      "Specify the reduction dim with the 'dim' argument.");
+  return amin(self, {}, /*keepdim=*/false);
+}
+
+Tensor argmax(const Tensor& self, std::optional<int64_t> dim, bool keepdim) {
+  return arg_reduce("argmax", self, dim, keepdim, /*is_max=*/true);
+}
+
+Tensor argmin(const Tensor& self, std::optional<int64_t> dim, bool keepdim) {
+  return arg_reduce("argmin", self, dim, keepdim, /*is_max=*/false);
+}
+
+Tensor norm(const Tensor& self, double p, IntArrayRef dim, bool keepdim) {
+  check_floating("norm", self);
+  const DimMask mask = make_dim_mask(dim, self.dim());
+  Reduction reduction(self, mask, self.scalar_type());
+  norm_stub(kCPU, reduction.iter, p);
+  return reduction.finish(mask, keepdim);
+}
+
+} // namespace at::native
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ATen/native/DispatchStub.h>
+
+namespace at {
+class TensorIterator;
+}
+
+namespace at::native {
+
+// All reduce the input of a TensorIterator::reduce_op iterator into its
+// output, see native/cpu/Reduce.h.
+using reduce_fn = void (*)(TensorIterator& iter);
+using reduce_norm_fn = void (*)(TensorIterator& iter, double p);
+
+DECLARE_DISPATCH(reduce_fn, sum_stub);
+DECLARE_DISPATCH(reduce_fn, mean_stub);
+DECLARE_DISPATCH(reduce_fn, max_values_stub);
+DECLARE_DISPATCH(reduce_fn, min_values_stub);
+// the iterator must enforce linear iteration, the index is row-major over
+// the reduced dims
+DECLARE_DISPATCH(reduce_fn, argmax_stub);
+DECLARE_DISPATCH(reduce_fn, argmin_stub);
+DECLARE_DISPATCH(reduce_norm_fn, norm_stub);
+
+} // namespace at::native
@@ -0,0 +1,51 @@
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/InPlace.h>
+#include <ATen/native/SoftMax.h>
+#include <c10/core/WrapDimMinimal.h>
+
+namespace at::native {
+
+DEFINE_DISPATCH(softmax_stub);
+
+namespace {
+
+void check_softmax_input(const char* name, const Tensor& self) {
+  const ScalarType dtype = self.scalar_type();
+  TORCH_CHECK(
+      isFloatingType(dtype),
+      name,
+      "(): expected a Float, Double, Half or BFloat16 input, got ",
+      dtype);
+}
+
+// softmax of self along dim into result
+void softmax_into(const Tensor& result, const Tensor& self, int64_t dim) {
+  dim = c10::maybe_wrap_dim(dim, self.dim());
+  if (self.numel() == 0) {
+    return;
+  }
+  // a 0-dim tensor as one row of one element
+  if (self.dim() == 0) {
+    softmax_stub(kCPU, result.view({1}), self.view({1}), 0);
+    return;
+  }
+  softmax_stub(kCPU, result, self, dim);
+}
+
+} // namespace
+
+Tensor softmax(const Tensor& self, int64_t dim) {
+  check_softmax_input("softmax", self);
+  Tensor result = empty(self.sizes(), self.scalar_type());
+  softmax_into(result, self, dim);
+  return result;
+}
+
+const Tensor& softmax_(const Tensor& self, int64_t dim) {
+  check_softmax_input("softmax_", self);
+  softmax_into(self, self, dim);
+  increment_version(self);
+  return self;
+}
+
+} // namespace at::native
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at::native {
+
+// Writes the softmax of input along dim into output, which has the sizes
+// and dtype of input and may be input itself.
+using softmax_fn =
+    void (*)(const Tensor& output, const Tensor& input, int64_t dim);
+
+DECLARE_DISPATCH(softmax_fn, softmax_stub);
+
+} // namespace at::native
@@ -0,0 +1,98 @@
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/native/SparseBlas.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace at::native {
+
+DEFINE_DISPATCH(spmm_csr_stub);
+
+namespace {
+
+// The first row of each of `parts` ranges of rows, and m after the last.
+// Each range gets about the same share of the work, which is a term per
+// element (a multiply-add with a row of the dense operand) plus a term per
+// row (writing it out) rather than the same number of rows: the rows of
+// real sparse matrices are skewed, a few of them holding most of the
+// elements, and equal numbers of rows would leave most threads idle.
+// crow_indices[i] + i, the work before row i, is increasing, so the
+// boundaries are found by binary search.
+std::vector<int64_t> balanced_row_ranges(
+    const int64_t* crow_indices,
+    int64_t m,
+    int64_t parts) {
+  const int64_t total = crow_indices[m] + m;
+  std::vector<int64_t> bounds(parts + 1);
+  for (int64_t p = 0; p <= parts; ++p) {
+    const int64_t work = total / parts * p + total % parts * p / parts;
+    int64_t lo = 0;
+    int64_t hi = m;
+    // the first row i with crow_indices[i] + i >= work
+    while (lo < hi) {
+      const int64_t mid = lo + (hi - lo) / 2;
+      if (crow_indices[mid] + mid < work) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    bounds[p] = lo;
+  }
+  bounds[parts] = m;
+  return bounds;
+}
+
+} // namespace
+
+Tensor sparse_mm(const Tensor& self, const Tensor& mat2) {
+  TORCH_CHECK(
+      mat2.layout() == kStrided,
+      "mm: expected a strided mat2 for a sparse self, got ",
+      mat2.layout());
+  TORCH_CHECK(
+      self.scalar_type() == mat2.scalar_type() and
+          (self.scalar_type() == ScalarType::Float or
+           self.scalar_type() == ScalarType::Double),
+      "mm: expected Float or Double operands of the same dtype, got ",
+      self.scalar_type(),
+      " and ",
+      mat2.scalar_type());
+  const Tensor csr = to_sparse_csr(self);
+  const auto* impl = get_sparse_csr_impl(csr);
+  const Tensor dense = contiguous(mat2);
+  const int64_t m = csr.size(0);
+  const int64_t n = dense.size(1);
+  Tensor result = empty({m, n}, self.scalar_type());
+  if (result.numel() == 0) {
+    return result;
+  }
+  const Tensor& crow_indices = impl->compressed_indices();
+  const int64_t* crow = crow_indices.const_data_ptr<int64_t>();
+  // a few ranges per thread, so that threads that finish early steal the
+  // rest of the work
+  const int64_t work = (crow[m] + m) * n;
+  const int64_t parts = work < internal::GRAIN_SIZE
+      ? 1
+      : std::min<int64_t>(
+            m, get_num_threads() * internal::CHUNKS_PER_THREAD);
+  const std::vector<int64_t> bounds = balanced_row_ranges(crow, m, parts);
+  parallel_for(0, parts, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; ++p) {
+      spmm_csr_stub(
+          kCPU,
+          result,
+          crow_indices,
+          impl->plain_indices(),
+          impl->values(),
+          dense,
+          bounds[p],
+          bounds[p + 1]);
+    }
+  });
+  return result;
+}
+
+} // namespace at::native
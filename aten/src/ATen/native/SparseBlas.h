@@ -0,0 +1,32 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <ATen/native/DispatchStub.h>
+
+// Products of sparse and dense matrices. The sparse operand is read as CSR:
+// a row of the result is the sum of the rows of the dense operand that the
+// elements of the matching sparse row select, each times its value.
+
+namespace at::native {
+
+// result[i] = sum_j values[j] * dense[col_indices[j]] over j =
+// crow_indices[i] up to crow_indices[i + 1], for the rows i in [row_begin,
+// row_end); result is a contiguous [m, n] matrix of the dtype of values,
+// Float or Double, dense a contiguous [k, n] one and crow_indices and
+// col_indices are contiguous Long
+using spmm_csr_fn = void (*)(
+    const Tensor& result,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense,
+    int64_t row_begin,
+    int64_t row_end);
+
+DECLARE_DISPATCH(spmm_csr_fn, spmm_csr_stub);
+
+// self @ mat2 for a sparse (COO, CSR or CSC) self and a strided mat2, as a
+// strided matrix
+Tensor sparse_mm(const Tensor& self, const Tensor& mat2);
+
+} // namespace at::native
@@ -0,0 +1,289 @@
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/OpMathType.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseTensorImpl.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace at::native {
+
+namespace {
+
+const char* layout_name(Layout layout) {
+  return layout == kSparseCsr ? "sparse_csr_tensor" : "sparse_csc_tensor";
+}
+
+Tensor make_compressed(
+    Layout layout,
+    IntArrayRef size,
+    Tensor compressed_indices,
+    Tensor plain_indices,
+    Tensor values) {
+  return Tensor(c10::make_intrusive<SparseCsrTensorImpl>(
+      layout,
+      size,
+      std::move(compressed_indices),
+      std::move(plain_indices),
+      std::move(values)));
+}
+
+// Checks the arrays of a compressed matrix of the given layout and sizes
+// and makes it of their contiguous versions.
+Tensor checked_compressed(
+    Layout layout,
+    const Tensor& compressed_indices,
+    const Tensor& plain_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  const char* name = layout_name(layout);
+  TORCH_CHECK(
+      size.size() == 2 and size[0] >= 0 and size[1] >= 0,
+      name,
+      ": expected the sizes of a matrix, got ",
+      size);
+  const bool csr = layout == kSparseCsr;
+  const int64_t slices = csr ? size[0] : size[1];
+  const int64_t plain_size = csr ? size[1] : size[0];
+  TORCH_CHECK(
+      compressed_indices.scalar_type() == ScalarType::Long and
+          compressed_indices.dim() == 1 and
+          compressed_indices.size(0) == slices + 1,
+      name,
+      ": expected Long compressed indices of size [",
+      slices + 1,
+      "], got ",
+      compressed_indices.scalar_type(),
+      " indices of size ",
+      compressed_indices.sizes());
+  TORCH_CHECK(
+      plain_indices.scalar_type() == ScalarType::Long and
+          plain_indices.dim() == 1,
+      name,
+      ": expected 1-D Long plain indices, got ",
+      plain_indices.scalar_type(),
+      " indices of size ",
+      plain_indices.sizes());
+  const int64_t nnz = plain_indices.size(0);
+  TORCH_CHECK(
+      values.dim() == 1 and values.size(0) == nnz,
+      name,
+      ": expected values of size [",
+      nnz,
+      "], got ",
+      values.sizes());
+  Tensor compressed = contiguous(compressed_indices);
+  Tensor plain = contiguous(plain_indices);
+  const int64_t* offsets = compressed.const_data_ptr<int64_t>();
+  TORCH_CHECK(
+      offsets[0] == 0 and offsets[slices] == nnz,
+      name,
+      ": expected compressed indices from 0 to nnz = ",
+      nnz,
+      ", got ",
+      offsets[0],
+      " to ",
+      offsets[slices]);
+  for (int64_t i = 0; i < slices; ++i) {
+    TORCH_CHECK(
+        offsets[i] <= offsets[i + 1],
+        name,
+        ": expected nondecreasing compressed indices, got ",
+        offsets[i],
+        " before ",
+        offsets[i + 1]);
+  }
+  const int64_t* idx = plain.const_data_ptr<int64_t>();
+  for (int64_t j = 0; j < nnz; ++j) {
+    TORCH_CHECK(
+        idx[j] >= 0 and idx[j] < plain_size,
+        name,
+        ": plain index ",
+        idx[j],
+        " of element ",
+        j,
+        " is out of bounds for size ",
+        plain_size);
+  }
+  return make_compressed(
+      layout,
+      size,
+      std::move(compressed),
+      std::move(plain),
+      contiguous(values));
+}
+
+// The CSR matrix of the strided matrix self, or the CSC one when by_column:
+// the CSC arrays of a matrix are the CSR arrays of its transpose.
+Tensor compress_strided(const Tensor& self, bool by_column) {
+  TORCH_CHECK(
+      self.dim() == 2,
+      by_column ? "to_sparse_csc" : "to_sparse_csr",
+      ": expected a matrix, got ",
+      self.dim(),
+      " dims");
+  const int64_t slices = self.size(by_column ? 1 : 0);
+  const int64_t length = self.size(by_column ? 0 : 1);
+  // the strides of the compressed and the plain dim
+  const int64_t slice_stride = self.stride(by_column ? 1 : 0);
+  const int64_t plain_stride = self.stride(by_column ? 0 : 1);
+  Tensor compressed = empty({slices + 1}, ScalarType::Long);
+  int64_t* offsets = compressed.mutable_data_ptr<int64_t>();
+  return AT_DISPATCH_ALL_TYPES(self.scalar_type(), "to_sparse_csr", [&] {
+    using acc_t = opmath_type<scalar_t>;
+    const scalar_t* in = self.const_data_ptr<scalar_t>();
+    const auto element = [&](int64_t i, int64_t j) {
+      return in[i * slice_stride + j * plain_stride];
+    };
+    offsets[0] = 0;
+    for (int64_t i = 0; i < slices; ++i) {
+      int64_t count = 0;
+      for (int64_t j = 0; j < length; ++j) {
+        count += static_cast<acc_t>(element(i, j)) != acc_t(0);
+      }
+      offsets[i + 1] = offsets[i] + count;
+    }
+    const int64_t nnz = offsets[slices];
+    Tensor plain = empty({nnz}, ScalarType::Long);
+    Tensor values = empty({nnz}, self.scalar_type());
+    int64_t* idx = plain.mutable_data_ptr<int64_t>();
+    scalar_t* out = values.mutable_data_ptr<scalar_t>();
+    int64_t e = 0;
+    for (int64_t i = 0; i < slices; ++i) {
+      for (int64_t j = 0; j < length; ++j) {
+        if (static_cast<acc_t>(element(i, j)) != acc_t(0)) {
+          idx[e] = j;
+          out[e++] = element(i, j);
+        }
+      }
+    }
+    return make_compressed(
+        by_column ? kSparseCsc : kSparseCsr,
+        self.sizes(),
+        compressed,
+        plain,
+        values);
+  });
+}
+
+// The CSR matrix of the COO matrix self, or the CSC one when by_column. The
+// elements are coalesced in the order of the compressed dim first.
+Tensor compress_coo(const Tensor& self, bool by_column) {
+  TORCH_CHECK(
+      self.dim() == 2,
+      by_column ? "to_sparse_csc" : "to_sparse_csr",
+      ": expected a matrix, got ",
+      self.dim(),
+      " dims");
+  Tensor coo = self;
+  if (by_column) {
+    // coalescing the transpose sorts by column
+    const auto* impl = get_sparse_impl(self);
+    const int64_t nnz = impl->nnz();
+    Tensor swapped = empty({2, nnz}, ScalarType::Long);
+    const int64_t* in = impl->indices().const_data_ptr<int64_t>();
+    int64_t* out = swapped.mutable_data_ptr<int64_t>();
+    std::copy_n(in, nnz, out + nnz);
+    std::copy_n(in + nnz, nnz, out);
+    coo = sparse_coo_tensor(
+        swapped, impl->values(), {self.size(1), self.size(0)});
+  }
+  coo = coalesce(coo);
+  const auto* impl = get_sparse_impl(coo);
+  const int64_t nnz = impl->nnz();
+  const int64_t slices = coo.size(0);
+  Tensor compressed = empty({slices + 1}, ScalarType::Long);
+  int64_t* offsets = compressed.mutable_data_ptr<int64_t>();
+  const int64_t* rows = impl->indices().const_data_ptr<int64_t>();
+  std::fill_n(offsets, slices + 1, 0);
+  for (int64_t j = 0; j < nnz; ++j) {
+    ++offsets[rows[j] + 1];
+  }
+  for (int64_t i = 0; i < slices; ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+  // the second row of the indices, as a tensor of its own
+  Tensor plain = empty({nnz}, ScalarType::Long);
+  std::copy_n(rows + nnz, nnz, plain.mutable_data_ptr<int64_t>());
+  return make_compressed(
+      by_column ? kSparseCsc : kSparseCsr,
+      self.sizes(),
+      compressed,
+      plain,
+      impl->values());
+}
+
+Tensor compress(const Tensor& self, Layout layout) {
+  if (self.layout() == layout) {
+    return self;
+  }
+  const bool by_column = layout == kSparseCsc;
+  if (self.layout() == kStrided) {
+    return compress_strided(self, by_column);
+  }
+  // from COO, or from the other compressed layout through COO
+  return compress_coo(to_sparse(self), by_column);
+}
+
+} // namespace
+
+Tensor sparse_csr_tensor(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  return checked_compressed(
+      kSparseCsr, crow_indices, col_indices, values, size);
+}
+
+Tensor sparse_csc_tensor(
+    const Tensor& ccol_indices,
+    const Tensor& row_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  return checked_compressed(
+      kSparseCsc, ccol_indices, row_indices, values, size);
+}
+
+Tensor crow_indices(const Tensor& self) {
+  TORCH_CHECK(
+      self.layout() == kSparseCsr,
+      "crow_indices: expected a SparseCsr tensor, got ",
+      self.layout());
+  return get_sparse_csr_impl(self)->compressed_indices();
+}
+
+Tensor col_indices(const Tensor& self) {
+  TORCH_CHECK(
+      self.layout() == kSparseCsr,
+      "col_indices: expected a SparseCsr tensor, got ",
+      self.layout());
+  return get_sparse_csr_impl(self)->plain_indices();
+}
+
+Tensor ccol_indices(const Tensor& self) {
+  TORCH_CHECK(
+      self.layout() == kSparseCsc,
+      "ccol_indices: expected a SparseCsc tensor, got ",
+      self.layout());
+  return get_sparse_csr_impl(self)->compressed_indices();
+}
+
+Tensor row_indices(const Tensor& self) {
+  TORCH_CHECK(
+      self.layout() == kSparseCsc,
+      "row_indices: expected a SparseCsc tensor, got ",
+      self.layout());
+  return get_sparse_csr_impl(self)->plain_indices();
+}
+
+Tensor to_sparse_csr(const Tensor& self) {
+  return compress(self, kSparseCsr);
+}
+
+Tensor to_sparse_csc(const Tensor& self) {
+  return compress(self, kSparseCsc);
+}
+
+} // namespace at::native
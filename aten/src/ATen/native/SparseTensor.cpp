@@ -0,0 +1,268 @@
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/OpMathType.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseTensorImpl.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace at::native {
+
+namespace {
+
+// the row-major strides of a dense tensor of the given sizes
+std::vector<int64_t> dense_strides(IntArrayRef size) {
+  std::vector<int64_t> strides(size.size());
+  int64_t stride = 1;
+  for (int64_t d = static_cast<int64_t>(size.size()) - 1; d >= 0; --d) {
+    strides[d] = stride;
+    stride *= size[d];
+  }
+  return strides;
+}
+
+// the row-major position of each of the nnz elements of the Long
+// [dim, nnz] indices in a dense tensor of the given sizes
+std::vector<int64_t> linear_indices(const Tensor& indices, IntArrayRef size) {
+  const int64_t nnz = indices.size(1);
+  const int64_t* idx = indices.const_data_ptr<int64_t>();
+  const std::vector<int64_t> strides = dense_strides(size);
+  std::vector<int64_t> positions(nnz, 0);
+  for (size_t d = 0; d < size.size(); ++d) {
+    for (int64_t i = 0; i < nnz; ++i) {
+      positions[i] += idx[d * nnz + i] * strides[d];
+    }
+  }
+  return positions;
+}
+
+Tensor make_sparse(
+    IntArrayRef size,
+    Tensor indices,
+    Tensor values,
+    bool coalesced) {
+  return Tensor(c10::make_intrusive<SparseTensorImpl>(
+      size, std::move(indices), std::move(values), coalesced));
+}
+
+// the COO tensor of the compressed matrix self
+Tensor expand_compressed(const Tensor& self) {
+  const auto* impl = get_sparse_csr_impl(self);
+  const bool csr = self.layout() == kSparseCsr;
+  const int64_t nnz = impl->nnz();
+  Tensor indices = empty({2, nnz}, ScalarType::Long);
+  const int64_t* compressed =
+      impl->compressed_indices().const_data_ptr<int64_t>();
+  const int64_t* plain = impl->plain_indices().const_data_ptr<int64_t>();
+  int64_t* rows = indices.mutable_data_ptr<int64_t>();
+  int64_t* cols = rows + nnz;
+  // the elements come in row-major order, and so coalesced, if they are
+  // in every row of a CSR matrix
+  bool coalesced = true;
+  const int64_t slices = impl->compressed_indices().size(0) - 1;
+  for (int64_t i = 0; i < slices; ++i) {
+    for (int64_t j = compressed[i]; j < compressed[i + 1]; ++j) {
+      rows[j] = csr ? i : plain[j];
+      cols[j] = csr ? plain[j] : i;
+      if (j > compressed[i] and plain[j] <= plain[j - 1]) {
+        coalesced = false;
+      }
+    }
+  }
+  return make_sparse(
+      self.sizes(), indices, impl->values(), coalesced and (csr or nnz <= 1));
+}
+
+} // namespace
+
+Tensor sparse_coo_tensor(
+    const Tensor& indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  const int64_t dim = static_cast<int64_t>(size.size());
+  TORCH_CHECK(dim > 0, "sparse_coo_tensor: expected at least one dim");
+  for (int64_t s : size) {
+    TORCH_CHECK(
+        s >= 0, "sparse_coo_tensor: expected nonnegative sizes, got ", size);
+  }
+  TORCH_CHECK(
+      indices.scalar_type() == ScalarType::Long and indices.dim() == 2 and
+          indices.size(0) == dim,
+      "sparse_coo_tensor: expected Long indices of size [",
+      dim,
+      ", nnz], got ",
+      indices.scalar_type(),
+      " indices of size ",
+      indices.sizes());
+  TORCH_CHECK(
+      values.dim() == 1 and values.size(0) == indices.size(1),
+      "sparse_coo_tensor: expected values of size [",
+      indices.size(1),
+      "], got ",
+      values.sizes());
+  Tensor idx = contiguous(indices);
+  const int64_t nnz = idx.size(1);
+  const int64_t* data = idx.const_data_ptr<int64_t>();
+  for (int64_t d = 0; d < dim; ++d) {
+    for (int64_t i = 0; i < nnz; ++i) {
+      const int64_t index = data[d * nnz + i];
+      TORCH_CHECK(
+          index >= 0 and index < size[d],
+          "sparse_coo_tensor: index ",
+          index,
+          " of element ",
+          i,
+          " is out of bounds for dim ",
+          d,
+          " of size ",
+          size[d]);
+    }
+  }
+  return make_sparse(size, std::move(idx), contiguous(values), nnz <= 1);
+}
+
+Tensor coalesce(const Tensor& self) {
+  const auto* impl = get_sparse_impl(self);
+  if (impl->coalesced()) {
+    return self;
+  }
+  const int64_t dim = self.dim();
+  const int64_t nnz = impl->nnz();
+  const std::vector<int64_t> positions =
+      linear_indices(impl->indices(), self.sizes());
+  // stable, so that duplicates add up in the order they were given
+  std::vector<int64_t> order(nnz);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+    return positions[a] < positions[b];
+  });
+  int64_t unique = 0;
+  for (int64_t i = 0; i < nnz; ++i) {
+    if (i == 0 or positions[order[i]] != positions[order[i - 1]]) {
+      ++unique;
+    }
+  }
+  Tensor indices = empty({dim, unique}, ScalarType::Long);
+  Tensor values = empty({unique}, self.scalar_type());
+  const int64_t* in_idx = impl->indices().const_data_ptr<int64_t>();
+  int64_t* out_idx = indices.mutable_data_ptr<int64_t>();
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "coalesce", [&] {
+    using acc_t = opmath_type<scalar_t>;
+    const scalar_t* in = impl->values().const_data_ptr<scalar_t>();
+    scalar_t* out = values.mutable_data_ptr<scalar_t>();
+    int64_t u = -1;
+    acc_t sum = 0;
+    for (int64_t i = 0; i < nnz; ++i) {
+      const int64_t e = order[i];
+      if (i == 0 or positions[e] != positions[order[i - 1]]) {
+        if (u >= 0) {
+          out[u] = static_cast<scalar_t>(sum);
+        }
+        ++u;
+        for (int64_t d = 0; d < dim; ++d) {
+          out_idx[d * unique + u] = in_idx[d * nnz + e];
+        }
+        sum = 0;
+      }
+      sum = static_cast<acc_t>(sum + static_cast<acc_t>(in[e]));
+    }
+    if (u >= 0) {
+      out[u] = static_cast<scalar_t>(sum);
+    }
+  });
+  return make_sparse(self.sizes(), indices, values, true);
+}
+
+bool is_coalesced(const Tensor& self) {
+  return get_sparse_impl(self)->coalesced();
+}
+
+int64_t _nnz(const Tensor& self) {
+  if (self.is_sparse_csr()) {
+    return get_sparse_csr_impl(self)->nnz();
+  }
+  return get_sparse_impl(self)->nnz();
+}
+
+Tensor indices(const Tensor& self) {
+  return get_sparse_impl(self)->indices();
+}
+
+Tensor values(const Tensor& self) {
+  if (self.is_sparse_csr()) {
+    return get_sparse_csr_impl(self)->values();
+  }
+  return get_sparse_impl(self)->values();
+}
+
+Tensor to_dense(const Tensor& self) {
+  if (self.layout() == kStrided) {
+    return self;
+  }
+  if (self.is_sparse_csr()) {
+    return to_dense(expand_compressed(self));
+  }
+  const auto* impl = get_sparse_impl(self);
+  Tensor result = empty(self.sizes(), self.scalar_type());
+  result.fill_(0);
+  const int64_t nnz = impl->nnz();
+  const std::vector<int64_t> positions =
+      linear_indices(impl->indices(), self.sizes());
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "to_dense", [&] {
+    using acc_t = opmath_type<scalar_t>;
+    const scalar_t* in = impl->values().const_data_ptr<scalar_t>();
+    scalar_t* out = result.mutable_data_ptr<scalar_t>();
+    for (int64_t i = 0; i < nnz; ++i) {
+      scalar_t& element = out[positions[i]];
+      element = static_cast<scalar_t>(
+          static_cast<acc_t>(element) + static_cast<acc_t>(in[i]));
+    }
+  });
+  return result;
+}
+
+Tensor to_sparse(const Tensor& self) {
+  if (self.is_sparse()) {
+    return self;
+  }
+  if (self.is_sparse_csr()) {
+    return expand_compressed(self);
+  }
+  TORCH_CHECK(self.dim() > 0, "to_sparse: expected at least one dim");
+  const Tensor dense = contiguous(self);
+  const int64_t dim = dense.dim();
+  const int64_t numel = dense.numel();
+  return AT_DISPATCH_ALL_TYPES(self.scalar_type(), "to_sparse", [&] {
+    using acc_t = opmath_type<scalar_t>;
+    const scalar_t* in = dense.const_data_ptr<scalar_t>();
+    const auto nonzero = [&](int64_t i) {
+      return static_cast<acc_t>(in[i]) != acc_t(0);
+    };
+    int64_t nnz = 0;
+    for (int64_t i = 0; i < numel; ++i) {
+      nnz += nonzero(i);
+    }
+    Tensor indices = empty({dim, nnz}, ScalarType::Long);
+    Tensor values = empty({nnz}, self.scalar_type());
+    int64_t* idx = indices.mutable_data_ptr<int64_t>();
+    scalar_t* out = values.mutable_data_ptr<scalar_t>();
+    const std::vector<int64_t> strides = dense_strides(self.sizes());
+    int64_t e = 0;
+    for (int64_t i = 0; i < numel; ++i) {
+      if (!nonzero(i)) {
+        continue;
+      }
+      int64_t position = i;
+      for (int64_t d = 0; d < dim; ++d) {
+        idx[d * nnz + e] = position / strides[d];
+        position %= strides[d];
+      }
+      out[e++] = in[i];
+    }
+    return make_sparse(self.sizes(), indices, values, true);
+  });
+}
+
+} // namespace at::native
@@ -0,0 +1,66 @@
+#include <ATen/EmptyTensor.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/quantized/Quantizer.h>
+
+namespace at::native {
+
+namespace {
+
+void check_not_quantized(const char* name, ScalarType dtype) {
+  TORCH_CHECK(
+      !isQIntType(dtype),
+      name,
+      ": quantized dtype ",
+      dtype,
+      " needs quantization parameters, use _empty_affine_quantized or "
+      "_empty_per_channel_affine_quantized");
+}
+
+} // namespace
+
+Tensor empty(
+    IntArrayRef size,
+    ScalarType dtype,
+    std::optional<MemoryFormat> memory_format) {
+  check_not_quantized("empty", dtype);
+  // elements of the 4-bit types share bytes, so they only come contiguous
+  TORCH_CHECK(
+      !isSubByteType(dtype) or !memory_format.has_value() or
+          *memory_format == MemoryFormat::Contiguous,
+      "empty: ",
+      dtype,
+      " tensors are always contiguous");
+  return Tensor(detail::empty_cpu(size, dtype, memory_format));
+}
+
+Tensor empty_strided(IntArrayRef size, IntArrayRef stride, ScalarType dtype) {
+  check_not_quantized("empty_strided", dtype);
+  TORCH_CHECK(
+      !isSubByteType(dtype),
+      "empty_strided: ",
+      dtype,
+      " tensors are always contiguous, use empty");
+  return Tensor(detail::empty_strided_cpu(size, stride, dtype));
+}
+
+Tensor _empty_affine_quantized(
+    IntArrayRef size,
+    ScalarType dtype,
+    double scale,
+    int64_t zero_point) {
+  return new_qtensor(
+      size, make_per_tensor_affine_quantizer(scale, zero_point, dtype));
+}
+
+Tensor _empty_per_channel_affine_quantized(
+    IntArrayRef size,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis,
+    ScalarType dtype) {
+  return new_qtensor(
+      size,
+      make_per_channel_affine_quantizer(scales, zero_points, axis, dtype));
+}
+
+} // namespace at::native
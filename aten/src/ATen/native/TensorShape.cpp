@@ -0,0 +1,360 @@
+#include <ATen/EmptyTensor.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/InferSize.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/TensorUtils.h>
+#include <ATen/quantized/QTensorImpl.h>
+#include <c10/core/WrapDimMinimal.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace at::native {
+
+namespace {
+
+void checkInBoundsForStorage(
+    IntArrayRef size,
+    IntArrayRef stride,
+    int64_t storage_offset,
+    size_t itemsize,
+    const Storage& storage) {
+  const size_t storage_size_bytes =
+      detail::computeStorageNbytes(size, stride, itemsize, storage_offset);
+  if (storage_size_bytes == 0) {
+    // NB: this is only possible for empty tensors, which never touch memory
+    return;
+  }
+  TORCH_CHECK(
+      storage_size_bytes <= storage.nbytes(),
+      "setStorage: sizes ",
+      size,
+      ", strides ",
+      stride,
+      ", storage offset ",
+      storage_offset,
+      ", and itemsize ",
+      itemsize,
+      " requiring a storage size of ",
+      storage_size_bytes,
+      " are out of bounds for storage of size ",
+      storage.nbytes());
+}
+
+// The elements of a 4-bit tensor share bytes, which strides and storage
+// offsets count whole elements of, so it has no views.
+void check_viewable(const Tensor& self) {
+  TORCH_CHECK(
+      !isSubByteType(self.scalar_type()),
+      "views of ",
+      self.scalar_type(),
+      " tensors are unsupported");
+  // sparse tensors have no storage to view
+  TORCH_CHECK(
+      self.layout() == kStrided,
+      "views of ",
+      self.layout(),
+      " tensors are unsupported");
+}
+
+// A view is a new TensorImpl over the same storage; only its sizes, strides
+// and offset differ from the base. The view of a quantized tensor is a
+// QTensorImpl with the quantizer of the view, see view_quantizer().
+Tensor make_view(
+    const Tensor& self,
+    IntArrayRef size,
+    IntArrayRef stride,
+    int64_t storage_offset,
+    QuantizerPtr quantizer) {
+  check_viewable(self);
+  c10::intrusive_ptr<TensorImpl> impl;
+  if (quantizer) {
+    impl = c10::make_intrusive<QTensorImpl>(
+        TensorImpl::VIEW,
+        Storage(self.storage()),
+        self.dtype(),
+        std::move(quantizer));
+  } else {
+    impl = c10::make_intrusive<TensorImpl>(
+        TensorImpl::VIEW, Storage(self.storage()), self.dtype());
+  }
+  impl->set_sizes_and_strides(size, stride, storage_offset);
+  return Tensor(std::move(impl));
+}
+
+// the per-channel quantizer of self, or null
+const PerChannelAffineQuantizer* per_channel_quantizer(const Tensor& self) {
+  if (!self.is_quantized() or self.qscheme() != kPerChannelAffine) {
+    return nullptr;
+  }
+  return static_cast<const PerChannelAffineQuantizer*>(
+      get_qtensorimpl(self)->quantizer().get());
+}
+
+// The quantizer of a view of self whose dim `axis` holds the channels of a
+// per-channel self; self's own if the channels did not move. Null for a
+// tensor that is not quantized.
+QuantizerPtr view_quantizer(const Tensor& self, int64_t axis) {
+  if (!self.is_quantized()) {
+    return QuantizerPtr();
+  }
+  const auto* channels = per_channel_quantizer(self);
+  if (channels == nullptr or channels->axis() == axis) {
+    return get_qtensorimpl(self)->quantizer();
+  }
+  return c10::make_intrusive<PerChannelAffineQuantizer>(
+      channels->scalar_type(),
+      channels->scales(),
+      channels->zero_points(),
+      axis);
+}
+
+// the quantizer of a view that keeps the dims of self
+QuantizerPtr view_quantizer(const Tensor& self) {
+  const auto* channels = per_channel_quantizer(self);
+  return view_quantizer(self, channels ? channels->axis() : 0);
+}
+
+// for the views that do not keep track of the channels
+void check_not_per_channel(const Tensor& self, const char* name) {
+  TORCH_CHECK(
+      per_channel_quantizer(self) == nullptr,
+      name,
+      "() is unsupported for tensors quantized per channel");
+}
+
+} // namespace
+
+Tensor as_strided(
+    const Tensor& self,
+    IntArrayRef size,
+    IntArrayRef stride,
+    std::optional<int64_t> storage_offset_) {
+  TORCH_CHECK(
+      self.device().support_as_strided(),
+      "as_strided is not supported on device ",
+      self.device());
+  TORCH_CHECK(
+      size.size() == stride.size(), "mismatch in length of strides and shape");
+  for (size_t i = 0; i < size.size(); ++i) {
+    TORCH_CHECK(
+        size[i] >= 0,
+        "Trying to create tensor with negative dimension ",
+        size[i],
+        ": ",
+        size);
+    TORCH_CHECK(
+        stride[i] >= 0,
+        "as_strided: Negative strides are not supported at the moment, got "
+        "strides: ",
+        stride);
+  }
+  const int64_t storage_offset =
+      storage_offset_.value_or(self.storage_offset());
+  TORCH_CHECK(
+      storage_offset >= 0, "Tensor: invalid storage offset ", storage_offset);
+  check_viewable(self);
+  checkInBoundsForStorage(
+      size, stride, storage_offset, self.itemsize(), self.storage());
+  check_not_per_channel(self, "as_strided");
+  return make_view(self, size, stride, storage_offset, view_quantizer(self));
+}
+
+Tensor slice(
+    const Tensor& self,
+    int64_t dim,
+    std::optional<int64_t> start,
+    std::optional<int64_t> end,
+    int64_t step) {
+  const int64_t ndim = self.dim();
+  TORCH_CHECK(ndim != 0, "slice() cannot be applied to a 0-dim tensor.");
+  dim = c10::maybe_wrap_dim(dim, ndim);
+  TORCH_CHECK(step > 0, "slice step must be positive");
+
+  const int64_t dim_size = self.size(dim);
+  int64_t start_val = start.value_or(0);
+  int64_t end_val = end.value_or(dim_size);
+  // clamp negative and out of range indices like Python slicing does
+  if (start_val < 0) {
+    start_val += dim_size;
+  }
+  if (end_val < 0) {
+    end_val += dim_size;
+  }
+  start_val = std::clamp<int64_t>(start_val, 0, dim_size);
+  end_val = std::clamp<int64_t>(end_val, start_val, dim_size);
+
+  std::vector<int64_t> sizes(self.sizes().begin(), self.sizes().end());
+  std::vector<int64_t> strides(self.strides().begin(), self.strides().end());
+  const int64_t storage_offset =
+      self.storage_offset() + start_val * strides[dim];
+  sizes[dim] = (end_val - start_val + step - 1) / step;
+  strides[dim] *= step;
+  QuantizerPtr quantizer = view_quantizer(self);
+  const auto* channels = per_channel_quantizer(self);
+  if (channels != nullptr and channels->axis() == dim) {
+    // the parameters of the channels that remain
+    quantizer = make_per_channel_affine_quantizer(
+        channels->scales().slice(0, start_val, end_val, step),
+        channels->zero_points().slice(0, start_val, end_val, step),
+        dim,
+        channels->scalar_type());
+  }
+  return make_view(self, sizes, strides, storage_offset, quantizer);
+}
+
+Tensor select(const Tensor& self, int64_t dim, int64_t index) {
+  const int64_t ndim = self.dim();
+  TORCH_CHECK(ndim != 0, "select() cannot be applied to a 0-dim tensor.");
+  dim = c10::maybe_wrap_dim(dim, ndim);
+  const int64_t size = self.size(dim);
+  TORCH_CHECK(
+      index >= -size and index < size,
+      "select(): index ",
+      index,
+      " out of range for tensor of size ",
+      self.sizes(),
+      " at dimension ",
+      dim);
+  if (index < 0) {
+    index += size;
+  }
+  std::vector<int64_t> sizes(self.sizes().begin(), self.sizes().end());
+  std::vector<int64_t> strides(self.strides().begin(), self.strides().end());
+  const int64_t storage_offset = self.storage_offset() + index * strides[dim];
+  sizes.erase(sizes.begin() + dim);
+  strides.erase(strides.begin() + dim);
+  QuantizerPtr quantizer = view_quantizer(self);
+  if (const auto* channels = per_channel_quantizer(self)) {
+    if (channels->axis() == dim) {
+      // a single channel: quantized per tensor
+      quantizer = make_per_tensor_affine_quantizer(
+          channels->scales().const_data_ptr<double>()[index],
+          channels->zero_points().const_data_ptr<int64_t>()[index],
+          channels->scalar_type());
+    } else if (channels->axis() > dim) {
+      quantizer = view_quantizer(self, channels->axis() - 1);
+    }
+  }
+  return make_view(self, sizes, strides, storage_offset, quantizer);
+}
+
+Tensor transpose(const Tensor& self, int64_t dim0, int64_t dim1) {
+  const int64_t ndim = self.dim();
+  dim0 = c10::maybe_wrap_dim(dim0, ndim);
+  dim1 = c10::maybe_wrap_dim(dim1, ndim);
+  std::vector<int64_t> sizes(self.sizes().begin(), self.sizes().end());
+  std::vector<int64_t> strides(self.strides().begin(), self.strides().end());
+  if (ndim > 0) {
+    std::swap(sizes[dim0], sizes[dim1]);
+    std::swap(strides[dim0], strides[dim1]);
+  }
+  QuantizerPtr quantizer = view_quantizer(self);
+  if (const auto* channels = per_channel_quantizer(self)) {
+    const int64_t axis = channels->axis();
+    quantizer = view_quantizer(
+        self, axis == dim0 ? dim1 : (axis == dim1 ? dim0 : axis));
+  }
+  return make_view(
+      self, sizes, strides, self.storage_offset(), std::move(quantizer));
+}
+
+Tensor t(const Tensor& self) {
+  TORCH_CHECK(
+      self.dim() <= 2,
+      "t() expects a tensor with <= 2 dimensions, but self is ",
+      self.dim(),
+      "D");
+  return transpose(self, 0, self.dim() < 2 ? 0 : 1);
+}
+
+Tensor permute(const Tensor& self, IntArrayRef dims) {
+  const int64_t ndim = self.dim();
+  TORCH_CHECK(
+      static_cast<int64_t>(dims.size()) == ndim,
+      "permute(): number of dimensions in the tensor input does not "
+      "match the length of the desired ordering of dimensions i.e. input.dim() "
+      "= ",
+      ndim,
+      " is not equal to len(dims) = ",
+      dims.size());
+  std::vector<int64_t> sizes(ndim);
+  std::vector<int64_t> strides(ndim);
+  std::vector<bool> seen(ndim);
+  for (int64_t i = 0; i < ndim; ++i) {
+    const int64_t dim = c10::maybe_wrap_dim(dims[i], ndim);
+    TORCH_CHECK(!seen[dim], "permute(): duplicate dims are not allowed.");
+    seen[dim] = true;
+    sizes[i] = self.size(dim);
+    strides[i] = self.stride(dim);
+  }
+  QuantizerPtr quantizer = view_quantizer(self);
+  if (const auto* channels = per_channel_quantizer(self)) {
+    for (int64_t i = 0; i < ndim; ++i) {
+      if (c10::maybe_wrap_dim(dims[i], ndim) == channels->axis()) {
+        quantizer = view_quantizer(self, i);
+      }
+    }
+  }
+  return make_view(
+      self, sizes, strides, self.storage_offset(), std::move(quantizer));
+}
+
+Tensor expand(const Tensor& self, IntArrayRef size) {
+  auto geometry = inferExpandGeometry(self.sizes(), self.strides(), size);
+  QuantizerPtr quantizer = view_quantizer(self);
+  if (const auto* channels = per_channel_quantizer(self)) {
+    // the new leading dims shift the channels
+    const int64_t axis = channels->axis() +
+        static_cast<int64_t>(geometry.sizes.size()) - self.dim();
+    TORCH_CHECK(
+        geometry.sizes[axis] == self.size(channels->axis()),
+        "expand() cannot broadcast the channel dim of a tensor quantized "
+        "per channel");
+    quantizer = view_quantizer(self, axis);
+  }
+  return make_view(
+      self,
+      geometry.sizes,
+      geometry.strides,
+      self.storage_offset(),
+      std::move(quantizer));
+}
+
+Tensor view(const Tensor& self, IntArrayRef size) {
+  const std::vector<int64_t> inferred_size = infer_size(size, self.numel());
+  const auto stride =
+      detail::computeStride(self.sizes(), self.strides(), inferred_size);
+  TORCH_CHECK(
+      stride.has_value(),
+      "view size is not compatible with input tensor's size and stride (at "
+      "least one dimension spans across two contiguous subspaces). Use "
+      ".reshape(...) instead.");
+  check_not_per_channel(self, "view");
+  return make_view(
+      self,
+      inferred_size,
+      *stride,
+      self.storage_offset(),
+      view_quantizer(self));
+}
+
+Tensor unsqueeze(const Tensor& self, int64_t dim) {
+  const int64_t ndim = self.dim();
+  dim = c10::maybe_wrap_dim(dim, ndim + 1);
+  std::vector<int64_t> sizes(self.sizes().begin(), self.sizes().end());
+  std::vector<int64_t> strides(self.strides().begin(), self.strides().end());
+  const int64_t new_stride = dim >= ndim ? 1 : sizes[dim] * strides[dim];
+  sizes.insert(sizes.begin() + dim, 1);
+  strides.insert(strides.begin() + dim, new_stride);
+  QuantizerPtr quantizer = view_quantizer(self);
+  if (const auto* channels = per_channel_quantizer(self)) {
+    if (channels->axis() >= dim) {
+      quantizer = view_quantizer(self, channels->axis() + 1);
+    }
+  }
+  return make_view(
+      self, sizes, strides, self.storage_offset(), std::move(quantizer));
+}
+
+} // namespace at::native
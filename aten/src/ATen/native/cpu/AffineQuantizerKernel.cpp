@@ -0,0 +1,269 @@
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/native/AffineQuantizer.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace at::native {
+namespace {
+
+using Vec = vec::Vectorized<float>;
+
+// The integers pass through float buffers of this many elements, converted
+// with plain loops the compiler vectorizes.
+constexpr int64_t kStage = 256;
+
+// 8-bit values and their differences to the zero point are exact in float,
+// so these types quantize and dequantize a vector at a time; QInt32 goes
+// through quantize_val() and dequantize_val().
+template <typename T>
+constexpr bool kVectorized = sizeof(typename T::underlying) == 1;
+
+template <typename T>
+void quantize_run(
+    const float* src,
+    T* dst,
+    int64_t n,
+    double scale,
+    int64_t zero_point) {
+  using underlying_t = typename T::underlying;
+  if constexpr (kVectorized<T>) {
+    constexpr int64_t qmin = std::numeric_limits<underlying_t>::min();
+    constexpr int64_t qmax = std::numeric_limits<underlying_t>::max();
+    // the float rounding of quantize_val()
+    const Vec inv_scale(1.0f / static_cast<float>(scale));
+    const Vec lo(static_cast<float>(qmin - zero_point));
+    const Vec hi(static_cast<float>(qmax - zero_point));
+    const Vec zp(static_cast<float>(zero_point));
+    auto* out = reinterpret_cast<underlying_t*>(dst);
+    __at_align__ float stage[kStage];
+    for (int64_t i0 = 0; i0 < n; i0 += kStage) {
+      const int64_t len = std::min(kStage, n - i0);
+      int64_t i = 0;
+      for (; i + Vec::size() <= len; i += Vec::size()) {
+        const Vec q =
+            vec::clamp((Vec::loadu(src + i0 + i) * inv_scale).round(), lo, hi);
+        (q + zp).store(stage + i);
+      }
+      if (i < len) {
+        const Vec x = Vec::loadu(src + i0 + i, len - i);
+        const Vec q = vec::clamp((x * inv_scale).round(), lo, hi);
+        (q + zp).store(stage + i, len - i);
+      }
+      for (int64_t j = 0; j < len; ++j) {
+        out[i0 + j] = static_cast<underlying_t>(stage[j]);
+      }
+    }
+  } else {
+    for (int64_t i = 0; i < n; ++i) {
+      dst[i] = quantize_val<T>(scale, zero_point, src[i]);
+    }
+  }
+}
+
+template <typename T>
+void dequantize_run(
+    const T* src,
+    float* dst,
+    int64_t n,
+    double scale,
+    int64_t zero_point) {
+  using underlying_t = typename T::underlying;
+  if constexpr (kVectorized<T>) {
+    const Vec scale_vec(static_cast<float>(scale));
+    const Vec zp(static_cast<float>(zero_point));
+    const auto* in = reinterpret_cast<const underlying_t*>(src);
+    __at_align__ float stage[kStage];
+    for (int64_t i0 = 0; i0 < n; i0 += kStage) {
+      const int64_t len = std::min(kStage, n - i0);
+      for (int64_t j = 0; j < len; ++j) {
+        stage[j] = static_cast<float>(in[i0 + j]);
+      }
+      int64_t i = 0;
+      for (; i + Vec::size() <= len; i += Vec::size()) {
+        ((Vec::loadu(stage + i) - zp) * scale_vec).store(dst + i0 + i);
+      }
+      if (i < len) {
+        ((Vec::loadu(stage + i, len - i) - zp) * scale_vec)
+            .store(dst + i0 + i, len - i);
+      }
+    }
+  } else {
+    for (int64_t i = 0; i < n; ++i) {
+      dst[i] = dequantize_val<T>(scale, zero_point, src[i]);
+    }
+  }
+}
+
+// A per-channel tensor as [outer, channels, inner] with axis in the middle.
+struct ChannelGeometry {
+  int64_t outer;
+  int64_t channels;
+  int64_t inner;
+};
+
+ChannelGeometry channel_geometry(const Tensor& self, int64_t axis) {
+  ChannelGeometry g{1, self.size(axis), 1};
+  for (int64_t d = 0; d < axis; ++d) {
+    g.outer *= self.size(d);
+  }
+  for (int64_t d = axis + 1; d < self.dim(); ++d) {
+    g.inner *= self.size(d);
+  }
+  return g;
+}
+
+// Calls f(scale, zero_point, begin, inner) on each row of inner elements,
+// all of one channel, in parallel.
+template <typename F>
+void for_each_channel_row(
+    const ChannelGeometry& g,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    const F& f) {
+  const double* scale_data = scales.const_data_ptr<double>();
+  const int64_t* zero_point_data = zero_points.const_data_ptr<int64_t>();
+  const int64_t rows = g.outer * g.channels;
+  const int64_t grain = std::max<int64_t>(1, internal::GRAIN_SIZE / g.inner);
+  parallel_for(0, rows, grain, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; ++row) {
+      const int64_t c = row % g.channels;
+      f(scale_data[c], zero_point_data[c], row * g.inner, g.inner);
+    }
+  });
+}
+
+void quantize_tensor_per_tensor_affine_kernel(
+    const Tensor& rtensor,
+    const Tensor& qtensor,
+    double scale,
+    int64_t zero_point) {
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "quantize_tensor_per_tensor_affine", [&] {
+        const float* src = rtensor.const_data_ptr<float>();
+        scalar_t* dst = qtensor.mutable_data_ptr<scalar_t>();
+        parallel_for(
+            0,
+            rtensor.numel(),
+            internal::GRAIN_SIZE,
+            [&](int64_t begin, int64_t end) {
+              quantize_run(
+                  src + begin, dst + begin, end - begin, scale, zero_point);
+            });
+      });
+}
+
+void dequantize_tensor_per_tensor_affine_kernel(
+    const Tensor& qtensor,
+    const Tensor& rtensor,
+    double scale,
+    int64_t zero_point) {
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "dequantize_tensor_per_tensor_affine", [&] {
+        const scalar_t* src = qtensor.const_data_ptr<scalar_t>();
+        float* dst = rtensor.mutable_data_ptr<float>();
+        parallel_for(
+            0,
+            rtensor.numel(),
+            internal::GRAIN_SIZE,
+            [&](int64_t begin, int64_t end) {
+              dequantize_run(
+                  src + begin, dst + begin, end - begin, scale, zero_point);
+            });
+      });
+}
+
+void quantize_tensor_per_channel_affine_kernel(
+    const Tensor& rtensor,
+    const Tensor& qtensor,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis) {
+  const ChannelGeometry g = channel_geometry(rtensor, axis);
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "quantize_tensor_per_channel_affine", [&] {
+        const float* src = rtensor.const_data_ptr<float>();
+        scalar_t* dst = qtensor.mutable_data_ptr<scalar_t>();
+        if (g.inner >= Vec::size()) {
+          for_each_channel_row(
+              g,
+              scales,
+              zero_points,
+              [&](double scale, int64_t zero_point, int64_t i, int64_t n) {
+                quantize_run(src + i, dst + i, n, scale, zero_point);
+              });
+          return;
+        }
+        const double* scale_data = scales.const_data_ptr<double>();
+        const int64_t* zero_point_data = zero_points.const_data_ptr<int64_t>();
+        parallel_for(
+            0,
+            rtensor.numel(),
+            internal::GRAIN_SIZE,
+            [&](int64_t begin, int64_t end) {
+              for (int64_t i = begin; i < end; ++i) {
+                const int64_t c = (i / g.inner) % g.channels;
+                dst[i] = quantize_val<scalar_t>(
+                    scale_data[c], zero_point_data[c], src[i]);
+              }
+            });
+      });
+}
+
+void dequantize_tensor_per_channel_affine_kernel(
+    const Tensor& qtensor,
+    const Tensor& rtensor,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis) {
+  const ChannelGeometry g = channel_geometry(rtensor, axis);
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "dequantize_tensor_per_channel_affine", [&] {
+        const scalar_t* src = qtensor.const_data_ptr<scalar_t>();
+        float* dst = rtensor.mutable_data_ptr<float>();
+        if (g.inner >= Vec::size()) {
+          for_each_channel_row(
+              g,
+              scales,
+              zero_points,
+              [&](double scale, int64_t zero_point, int64_t i, int64_t n) {
+                dequantize_run(src + i, dst + i, n, scale, zero_point);
+              });
+          return;
+        }
+        const double* scale_data = scales.const_data_ptr<double>();
+        const int64_t* zero_point_data = zero_points.const_data_ptr<int64_t>();
+        parallel_for(
+            0,
+            rtensor.numel(),
+            internal::GRAIN_SIZE,
+            [&](int64_t begin, int64_t end) {
+              for (int64_t i = begin; i < end; ++i) {
+                const int64_t c = (i / g.inner) % g.channels;
+                dst[i] = dequantize_val<scalar_t>(
+                    scale_data[c], zero_point_data[c], src[i]);
+              }
+            });
+      });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(
+    quantize_tensor_per_tensor_affine_stub,
+    &quantize_tensor_per_tensor_affine_kernel)
+REGISTER_DISPATCH(
+    quantize_tensor_per_channel_affine_stub,
+    &quantize_tensor_per_channel_affine_kernel)
+REGISTER_DISPATCH(
+    dequantize_tensor_per_tensor_affine_stub,
+    &dequantize_tensor_per_tensor_affine_kernel)
+REGISTER_DISPATCH(
+    dequantize_tensor_per_channel_affine_stub,
+    &dequantize_tensor_per_channel_affine_kernel)
+
+} // namespace at::native
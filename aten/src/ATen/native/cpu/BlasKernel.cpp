@@ -0,0 +1,1066 @@
+#include <ATen/Dispatch.h>
+#include <ATen/OpMathType.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/native/CPUBlas.h>
+#include <c10/cpu/CPUAllocator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+// GEMM in the BLIS layering (Van Zee and van de Geijn, "BLIS: A Framework
+// for Rapidly Instantiating BLAS Functionality"):
+//
+//   for each block of kNc columns of C:
+//     for each block of kKc along k:
+//       pack that k x n block of B into panels of kNr columns
+//       for each block of kMc rows of C:
+//         pack that m x k block of A into panels of kMr rows
+//         for each kMr x kNr tile of the block:
+//           micro-kernel: tile (+)= A panel * B panel, in registers
+//
+// A packed B panel (kKc x kNr) stays in L1 while the micro-kernel sweeps
+// the A block (kMc x kKc) held in L2; the micro-kernel then only does
+// unit-stride loads. Packing is the only code that sees the strides of A
+// and B, so transposed views cost nothing extra, and it widens Half and
+// BFloat16 to float, the type they are computed in, as well as a Float8 B,
+// whose scale is folded into alpha.
+//
+// A product of at most kMr rows reuses nothing from B, so instead of packing
+// B it streams B once: row by row into accumulator rows (axpy) if B is
+// row-major, column by column into dot products if B is transposed, as
+// weights often are.
+//
+// A B that is multiplied many times can be packed once up front, see
+// pack_b_impl(); the loops above then read their B panels from it.
+//
+// Threads split C into a 2-D grid of tiles, each running the loops above
+// on its own tile with its own packing buffers. Every element of C is
+// computed by the same sequence of operations whatever the grid, so the
+// result does not depend on the number of threads.
+
+namespace at::native::cpublas {
+namespace {
+
+template <typename scalar_t>
+using acc_type = opmath_type<scalar_t>;
+
+template <typename acc_t>
+struct Blocking {
+  using Vec = vec::Vectorized<acc_t>;
+  // kMr x 2 vectors of accumulators plus two B vectors and an A broadcast
+  // fit the 32 AVX-512 registers, or the 16 of AVX2
+#if defined(CPU_CAPABILITY_AVX512)
+  static constexpr int64_t kMr = 12;
+#else
+  static constexpr int64_t kMr = 6;
+#endif
+  static constexpr int64_t kNr = 2 * Vec::size();
+  static constexpr int64_t kKc = 256;
+  static constexpr int64_t kMc = 24 * kMr;
+  static constexpr int64_t kNc = 4096;
+  // C rows per pass over a column block when C is not updated in place,
+  // which bounds the float workspace
+  static constexpr int64_t kPanelRows = 4 * kMc;
+  // columns per accumulator block of the skinny row-major B path
+  static constexpr int64_t kSkinnyNc = 4096;
+};
+
+// c[0, kRows) x [0, kNr), row stride ldc, = alpha * a b + beta * c, where
+// a is (the first kRows rows of) a packed A panel and b a packed B panel of
+// depth kc; c is not read if beta == 0
+template <typename acc_t, int64_t kRows = Blocking<acc_t>::kMr>
+void micro_kernel(
+    int64_t kc,
+    const acc_t* a,
+    const acc_t* b,
+    acc_t alpha,
+    acc_t beta,
+    acc_t* c,
+    int64_t ldc) {
+  using Vec = vec::Vectorized<acc_t>;
+  constexpr int64_t kMr = Blocking<acc_t>::kMr;
+  constexpr int64_t kW = Vec::size();
+  // The loops over kMr are unrolled by hand (#pragma) so that GCC keeps
+  // the accumulators in registers; left to itself it stores them to the
+  // stack on every step.
+  Vec acc0[kRows];
+  Vec acc1[kRows];
+#pragma GCC unroll 16
+  for (int64_t i = 0; i < kRows; ++i) {
+    acc0[i] = Vec(acc_t(0));
+    acc1[i] = Vec(acc_t(0));
+  }
+  for (int64_t p = 0; p < kc; ++p) {
+    const Vec b0 = Vec::loadu(b);
+    const Vec b1 = Vec::loadu(b + kW);
+#pragma GCC unroll 16
+    for (int64_t i = 0; i < kRows; ++i) {
+      const Vec ai(a[i]);
+      acc0[i] = vec::fmadd(ai, b0, acc0[i]);
+      acc1[i] = vec::fmadd(ai, b1, acc1[i]);
+    }
+    a += kMr;
+    b += 2 * kW;
+  }
+  const Vec alpha_vec(alpha);
+  const Vec beta_vec(beta);
+#pragma GCC unroll 16
+  for (int64_t i = 0; i < kRows; ++i) {
+    Vec r0 = acc0[i] * alpha_vec;
+    Vec r1 = acc1[i] * alpha_vec;
+    if (beta != acc_t(0)) {
+      r0 = vec::fmadd(beta_vec, Vec::loadu(c + i * ldc), r0);
+      r1 = vec::fmadd(beta_vec, Vec::loadu(c + i * ldc + kW), r1);
+    }
+    r0.store(c + i * ldc);
+    r1.store(c + i * ldc + kW);
+  }
+}
+
+// micro_kernel() on the first `rows` rows of the tile only, which computes
+// each of them exactly as the full tile would
+template <typename acc_t, int64_t kRows = 1>
+void micro_kernel_rows(
+    int64_t rows,
+    int64_t kc,
+    const acc_t* a,
+    const acc_t* b,
+    acc_t alpha,
+    acc_t beta,
+    acc_t* c,
+    int64_t ldc) {
+  if constexpr (kRows < Blocking<acc_t>::kMr) {
+    if (rows > kRows) {
+      micro_kernel_rows<acc_t, kRows + 1>(
+          rows, kc, a, b, alpha, beta, c, ldc);
+      return;
+    }
+  }
+  micro_kernel<acc_t, kRows>(kc, a, b, alpha, beta, c, ldc);
+}
+
+// b_t is the type B is stored in, scalar_t or a Float8 type
+template <typename scalar_t, typename b_t = scalar_t>
+class GemmTile {
+  using acc_t = acc_type<scalar_t>;
+  using B = Blocking<acc_t>;
+
+ public:
+  explicit GemmTile(const GemmParams& p)
+      : p_(p),
+        a_(static_cast<const scalar_t*>(p.a)),
+        b_(static_cast<const b_t*>(p.b)),
+        c_(static_cast<scalar_t*>(p.c)),
+        alpha_(static_cast<acc_t>(p.alpha * p.b_scale)),
+        beta_(static_cast<acc_t>(p.beta)),
+        in_place_(std::is_same_v<scalar_t, acc_t> and p.c_col_stride == 1),
+        b_packed_(
+            p.b_packed ? static_cast<const acc_t*>(p.b_packed->storage.data())
+                       : nullptr) {}
+
+  // whether C is computed by the skinny path, see the top of the file; a
+  // property of the whole product, so that the grid of tiles does not change
+  // how an element is computed
+  static bool is_skinny(const GemmParams& p) {
+    return p.m <= B::kMr and !p.b_packed and
+        (p.b_col_stride == 1 or p.b_row_stride == 1);
+  }
+
+  // The whole of B packed, for pack_b(): B[p0, p0 + kKc) over all n
+  // columns is packed as in run_panel() at p0 * round_up(n, kNr), so the
+  // panels of that block from column j on start at p0 * round_up(n, kNr) +
+  // j * kc.
+  static int64_t packed_b_size(const GemmParams& p) {
+    return p.k * round_up(p.n, B::kNr);
+  }
+
+  // the block of the packed B starting at row p0, see packed_b_size()
+  void pack_b_block(acc_t* packed, int64_t p0) const {
+    pack_b(
+        packed + p0 * round_up(p_.n, B::kNr),
+        p0,
+        std::min(B::kKc, p_.k - p0),
+        0,
+        p_.n);
+  }
+
+  // computes rows [m0, m1) x columns [n0, n1) of C
+  void run(int64_t m0, int64_t m1, int64_t n0, int64_t n1) {
+    if (is_skinny(p_)) {
+      run_skinny(m0, m1, n0, n1);
+      return;
+    }
+    const int64_t kc_max = std::min(p_.k, B::kKc);
+    const int64_t nc_max = std::min(n1 - n0, B::kNc);
+    const int64_t mc_max = std::min(m1 - m0, B::kMc);
+    a_pack_ = allocate(round_up(mc_max, B::kMr) * kc_max);
+    if (!b_packed_) {
+      b_pack_ = allocate(round_up(nc_max, B::kNr) * kc_max);
+    }
+    if (!in_place_) {
+      workspace_ = allocate(std::min(m1 - m0, B::kPanelRows) * nc_max);
+    }
+    for (int64_t jc = n0; jc < n1; jc += B::kNc) {
+      const int64_t nc = std::min(B::kNc, n1 - jc);
+      for (int64_t ip = m0; ip < m1; ip += B::kPanelRows) {
+        run_panel(ip, std::min(B::kPanelRows, m1 - ip), jc, nc);
+      }
+    }
+  }
+
+  static int64_t round_up(int64_t x, int64_t multiple) {
+    return divup(x, multiple) * multiple;
+  }
+
+  static c10::DataPtr allocate(int64_t count) {
+    return c10::GetCPUAllocator()->allocate(count * sizeof(acc_t));
+  }
+
+ private:
+
+  // rows [ip, ip + mp) x columns [jc, jc + nc) of C
+  void run_panel(int64_t ip, int64_t mp, int64_t jc, int64_t nc) {
+    acc_t* c = static_cast<acc_t*>(workspace_.get());
+    int64_t ldc = nc;
+    if constexpr (std::is_same_v<scalar_t, acc_t>) {
+      if (in_place_) {
+        c = c_ + ip * p_.c_row_stride + jc;
+        ldc = p_.c_row_stride;
+      }
+    }
+    if (!in_place_ and beta_ != acc_t(0)) {
+      copy_c(ip, mp, jc, nc, /*to_workspace=*/true);
+    }
+    auto* a_pack = static_cast<acc_t*>(a_pack_.get());
+    for (int64_t pc = 0; pc < p_.k; pc += B::kKc) {
+      const int64_t kc = std::min(B::kKc, p_.k - pc);
+      const acc_t* b_pack = nullptr;
+      if (b_packed_) {
+        b_pack = b_packed_ + pc * round_up(p_.n, B::kNr) + jc * kc;
+      } else {
+        pack_b(static_cast<acc_t*>(b_pack_.get()), pc, kc, jc, nc);
+        b_pack = static_cast<const acc_t*>(b_pack_.get());
+      }
+      const acc_t beta = pc == 0 ? beta_ : acc_t(1);
+      for (int64_t ic = 0; ic < mp; ic += B::kMc) {
+        const int64_t mc = std::min(B::kMc, mp - ic);
+        pack_a(a_pack, ip + ic, mc, pc, kc);
+        for (int64_t jr = 0; jr < nc; jr += B::kNr) {
+          macro_kernel(
+              a_pack,
+              b_pack + jr * kc,
+              mc,
+              std::min(B::kNr, nc - jr),
+              kc,
+              beta,
+              c + ic * ldc + jr,
+              ldc);
+        }
+      }
+    }
+    if (!in_place_) {
+      copy_c(ip, mp, jc, nc, /*to_workspace=*/false);
+    }
+  }
+
+  // A[i0, i0 + mc) x [p0, p0 + kc) into panels of kMr rows, each stored
+  // column by column; rows past mc are zero
+  void pack_a(acc_t* dst, int64_t i0, int64_t mc, int64_t p0, int64_t kc)
+      const {
+    for (int64_t ir = 0; ir < mc; ir += B::kMr) {
+      const int64_t mr = std::min(B::kMr, mc - ir);
+      const scalar_t* src =
+          a_ + (i0 + ir) * p_.a_row_stride + p0 * p_.a_col_stride;
+      for (int64_t p = 0; p < kc; ++p) {
+        for (int64_t i = 0; i < B::kMr; ++i) {
+          dst[i] = i < mr ? static_cast<acc_t>(
+                                src[i * p_.a_row_stride + p * p_.a_col_stride])
+                          : acc_t(0);
+        }
+        dst += B::kMr;
+      }
+    }
+  }
+
+  // B[p0, p0 + kc) x [j0, j0 + nc) into panels of kNr columns, each stored
+  // row by row; columns past nc are zero
+  void pack_b(acc_t* dst, int64_t p0, int64_t kc, int64_t j0, int64_t nc)
+      const {
+    for (int64_t jr = 0; jr < nc; jr += B::kNr) {
+      const int64_t nr = std::min(B::kNr, nc - jr);
+      const b_t* src =
+          b_ + p0 * p_.b_row_stride + (j0 + jr) * p_.b_col_stride;
+      if (p_.b_col_stride == 1) {
+        for (int64_t p = 0; p < kc; ++p) {
+          acc_t* row = dst + p * B::kNr;
+          vec::convert(src + p * p_.b_row_stride, row, nr);
+          std::fill(row + nr, row + B::kNr, acc_t(0));
+        }
+      } else {
+        // read each column of B contiguously if it is (B transposed)
+        for (int64_t j = 0; j < B::kNr; ++j) {
+          for (int64_t p = 0; p < kc; ++p) {
+            dst[p * B::kNr + j] = j < nr
+                ? static_cast<acc_t>(
+                      src[p * p_.b_row_stride + j * p_.b_col_stride])
+                : acc_t(0);
+          }
+        }
+      }
+      dst += kc * B::kNr;
+    }
+  }
+
+  // c[0, mc) x [0, nr) (+)= the A block times one B panel
+  void macro_kernel(
+      const acc_t* a_pack,
+      const acc_t* b_panel,
+      int64_t mc,
+      int64_t nr,
+      int64_t kc,
+      acc_t beta,
+      acc_t* c,
+      int64_t ldc) const {
+    for (int64_t ir = 0; ir < mc; ir += B::kMr) {
+      const int64_t mr = std::min(B::kMr, mc - ir);
+      const acc_t* a = a_pack + ir * kc;
+      acc_t* tile = c + ir * ldc;
+      if (nr == B::kNr) {
+        micro_kernel_rows(mr, kc, a, b_panel, alpha_, beta, tile, ldc);
+        continue;
+      }
+      // a tile cut by the edge of C goes through a full-width buffer,
+      // computed the same way as an inner tile
+      __at_align__ acc_t buffer[B::kMr * B::kNr];
+      if (beta != acc_t(0)) {
+        for (int64_t i = 0; i < mr; ++i) {
+          std::copy(tile + i * ldc, tile + i * ldc + nr, buffer + i * B::kNr);
+          std::fill(
+              buffer + i * B::kNr + nr, buffer + (i + 1) * B::kNr, acc_t(0));
+        }
+      }
+      micro_kernel_rows(mr, kc, a, b_panel, alpha_, beta, buffer, B::kNr);
+      for (int64_t i = 0; i < mr; ++i) {
+        std::copy(
+            buffer + i * B::kNr, buffer + i * B::kNr + nr, tile + i * ldc);
+      }
+    }
+  }
+
+  void run_skinny(int64_t m0, int64_t m1, int64_t n0, int64_t n1) {
+    // the rows of A as contiguous acc_t
+    const int64_t mr = m1 - m0;
+    const int64_t k = p_.k;
+    a_pack_ = allocate(mr * k);
+    auto* a = static_cast<acc_t*>(a_pack_.get());
+    for (int64_t i = 0; i < mr; ++i) {
+      for (int64_t p = 0; p < k; ++p) {
+        a[i * k + p] = static_cast<acc_t>(
+            a_[(m0 + i) * p_.a_row_stride + p * p_.a_col_stride]);
+      }
+    }
+    if (p_.b_col_stride == 1) {
+      skinny_rows(a, m0, mr, n0, n1);
+    } else {
+      skinny_columns(a, m0, mr, n0, n1);
+    }
+  }
+
+  // Row-major B: acc[i] += a[i][p] * B[p] for each row p of B, over blocks
+  // of kSkinnyNc columns.
+  void skinny_rows(
+      const acc_t* a,
+      int64_t m0,
+      int64_t mr,
+      int64_t n0,
+      int64_t n1) {
+    using Vec = vec::Vectorized<acc_t>;
+    const int64_t k = p_.k;
+    const int64_t nc_max = std::min(n1 - n0, B::kSkinnyNc);
+    // the accumulators, then a row of B converted to acc_t
+    workspace_ = allocate((mr + 1) * nc_max);
+    auto* acc = static_cast<acc_t*>(workspace_.get());
+    acc_t* b_buffer = acc + mr * nc_max;
+    for (int64_t jc = n0; jc < n1; jc += B::kSkinnyNc) {
+      const int64_t nc = std::min(B::kSkinnyNc, n1 - jc);
+      std::fill(acc, acc + mr * nc, acc_t(0));
+      for (int64_t p = 0; p < k; ++p) {
+        const b_t* src = b_ + p * p_.b_row_stride + jc;
+        const acc_t* b_row = b_buffer;
+        if constexpr (std::is_same_v<b_t, acc_t>) {
+          b_row = src;
+        } else {
+          vec::convert(src, b_buffer, nc);
+        }
+        for (int64_t i = 0; i < mr; ++i) {
+          const Vec ai(a[i * k + p]);
+          acc_t* acc_row = acc + i * nc;
+          int64_t j = 0;
+          for (; j + Vec::size() <= nc; j += Vec::size()) {
+            vec::fmadd(ai, Vec::loadu(b_row + j), Vec::loadu(acc_row + j))
+                .store(acc_row + j);
+          }
+          if (j < nc) {
+            const int64_t count = nc - j;
+            vec::fmadd(
+                ai,
+                Vec::loadu(b_row + j, count),
+                Vec::loadu(acc_row + j, count))
+                .store(acc_row + j, count);
+          }
+        }
+      }
+      for (int64_t i = 0; i < mr; ++i) {
+        for (int64_t j = 0; j < nc; ++j) {
+          store_c(m0 + i, jc + j, acc[i * nc + j]);
+        }
+      }
+    }
+  }
+
+  // Transposed B: each column of B, contiguous, dotted with the rows of A.
+  void skinny_columns(
+      const acc_t* a,
+      int64_t m0,
+      int64_t mr,
+      int64_t n0,
+      int64_t n1) {
+    using Vec = vec::Vectorized<acc_t>;
+    const int64_t k = p_.k;
+    if constexpr (!std::is_same_v<b_t, acc_t>) {
+      workspace_ = allocate(k);
+    }
+    auto* b_buffer = static_cast<acc_t*>(workspace_.get());
+    for (int64_t j = n0; j < n1; ++j) {
+      const b_t* src = b_ + j * p_.b_col_stride;
+      const acc_t* b_col = b_buffer;
+      if constexpr (std::is_same_v<b_t, acc_t>) {
+        b_col = src;
+      } else {
+        vec::convert(src, b_buffer, k);
+      }
+      Vec acc[B::kMr];
+      for (int64_t i = 0; i < mr; ++i) {
+        acc[i] = Vec(acc_t(0));
+      }
+      int64_t p = 0;
+      for (; p + Vec::size() <= k; p += Vec::size()) {
+        const Vec b = Vec::loadu(b_col + p);
+        for (int64_t i = 0; i < mr; ++i) {
+          acc[i] = vec::fmadd(Vec::loadu(a + i * k + p), b, acc[i]);
+        }
+      }
+      if (p < k) {
+        const Vec b = Vec::loadu(b_col + p, k - p);
+        for (int64_t i = 0; i < mr; ++i) {
+          acc[i] = vec::fmadd(Vec::loadu(a + i * k + p, k - p), b, acc[i]);
+        }
+      }
+      for (int64_t i = 0; i < mr; ++i) {
+        __at_align__ acc_t lanes[Vec::size()];
+        acc[i].store(lanes);
+        acc_t sum = 0;
+        for (int64_t l = 0; l < Vec::size(); ++l) {
+          sum += lanes[l];
+        }
+        store_c(m0 + i, j, sum);
+      }
+    }
+  }
+
+  // C[i, j] = alpha * value + beta * C[i, j]
+  void store_c(int64_t i, int64_t j, acc_t value) {
+    scalar_t& c = c_[i * p_.c_row_stride + j * p_.c_col_stride];
+    acc_t result = alpha_ * value;
+    if (beta_ != acc_t(0)) {
+      result += beta_ * static_cast<acc_t>(c);
+    }
+    c = static_cast<scalar_t>(result);
+  }
+
+  // C[ip, ip + mp) x [jc, jc + nc) to or from the workspace
+  void copy_c(
+      int64_t ip,
+      int64_t mp,
+      int64_t jc,
+      int64_t nc,
+      bool to_workspace) {
+    auto* ws = static_cast<acc_t*>(workspace_.get());
+    for (int64_t i = 0; i < mp; ++i) {
+      scalar_t* row = c_ + (ip + i) * p_.c_row_stride + jc * p_.c_col_stride;
+      acc_t* ws_row = ws + i * nc;
+      if (p_.c_col_stride == 1) {
+        if (to_workspace) {
+          vec::convert(row, ws_row, nc);
+        } else {
+          vec::convert(ws_row, row, nc);
+        }
+        continue;
+      }
+      for (int64_t j = 0; j < nc; ++j) {
+        scalar_t& x = row[j * p_.c_col_stride];
+        if (to_workspace) {
+          ws_row[j] = static_cast<acc_t>(x);
+        } else {
+          x = static_cast<scalar_t>(ws_row[j]);
+        }
+      }
+    }
+  }
+
+  const GemmParams& p_;
+  const scalar_t* a_;
+  const b_t* b_;
+  scalar_t* c_;
+  const acc_t alpha_;
+  const acc_t beta_;
+  // whether C is accumulated into directly, or through a workspace in
+  // acc_t
+  const bool in_place_;
+  // B packed up front, or null
+  const acc_t* b_packed_;
+  c10::DataPtr a_pack_;
+  c10::DataPtr b_pack_;
+  c10::DataPtr workspace_;
+};
+
+// below this many multiply-adds a GEMM runs on the calling thread
+constexpr int64_t kMinParallelMacs = int64_t(1) << 18;
+
+// The grid of rows x cols tiles C is split into for `threads` threads:
+// the one minimizing the per-thread tile's compute plus packing.
+std::pair<int64_t, int64_t> choose_grid(
+    int64_t m,
+    int64_t n,
+    int64_t mr,
+    int64_t nr,
+    int64_t threads) {
+  std::pair<int64_t, int64_t> best{1, 1};
+  double best_cost = std::numeric_limits<double>::infinity();
+  for (int64_t rows = 1; rows <= std::min(threads, divup(m, mr)); ++rows) {
+    const int64_t cols = std::min(threads / rows, divup(n, nr));
+    const double tile_m = static_cast<double>(divup(divup(m, mr), rows) * mr);
+    const double tile_n = static_cast<double>(divup(divup(n, nr), cols) * nr);
+    // packing an element is worth a few dozen multiply-adds
+    const double cost = tile_m * tile_n + 32 * (tile_m + tile_n);
+    if (cost < best_cost) {
+      best_cost = cost;
+      best = {rows, cols};
+    }
+  }
+  return best;
+}
+
+template <typename scalar_t, typename b_t = scalar_t>
+void gemm_impl(const GemmParams& p) {
+  using B = Blocking<acc_type<scalar_t>>;
+  const int64_t threads = p.m * p.n * p.k < kMinParallelMacs
+      ? 1
+      : static_cast<int64_t>(get_num_threads());
+  const auto [rows, cols] = choose_grid(p.m, p.n, B::kMr, B::kNr, threads);
+  // tile boundaries on whole micro-tiles
+  const int64_t tile_m = divup(divup(p.m, B::kMr), rows) * B::kMr;
+  const int64_t tile_n = divup(divup(p.n, B::kNr), cols) * B::kNr;
+  parallel_for(0, rows * cols, 1, [&](int64_t begin, int64_t end) {
+    GemmTile<scalar_t, b_t> tile(p);
+    for (int64_t t = begin; t < end; ++t) {
+      const int64_t m0 = (t / cols) * tile_m;
+      const int64_t n0 = (t % cols) * tile_n;
+      if (m0 < p.m and n0 < p.n) {
+        tile.run(
+            m0, std::min(m0 + tile_m, p.m), n0, std::min(n0 + tile_n, p.n));
+      }
+    }
+  });
+}
+
+void gemm_kernel(const GemmParams& params) {
+  if (c10::isFloat8Type(params.b_dtype)) {
+    AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+        params.dtype, "gemm_cpu", [&] {
+          using a_t = scalar_t;
+          AT_DISPATCH_FLOAT8_TYPES(params.b_dtype, "gemm_cpu", [&] {
+            gemm_impl<a_t, scalar_t>(params);
+          });
+        });
+    return;
+  }
+  AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+      params.dtype, "gemm_cpu", [&] { gemm_impl<scalar_t>(params); });
+}
+
+template <typename scalar_t>
+c10::Storage pack_b_impl(const GemmParams& p) {
+  using Tile = GemmTile<scalar_t>;
+  using B = Blocking<acc_type<scalar_t>>;
+  const int64_t count = Tile::packed_b_size(p);
+  c10::Storage storage(
+      c10::Storage::use_byte_size_t{},
+      count * sizeof(acc_type<scalar_t>),
+      Tile::allocate(count),
+      c10::GetCPUAllocator());
+  auto* packed = static_cast<acc_type<scalar_t>*>(storage.mutable_data());
+  const Tile tile(p);
+  parallel_for(0, divup(p.k, B::kKc), 1, [&](int64_t begin, int64_t end) {
+    for (int64_t block = begin; block < end; ++block) {
+      tile.pack_b_block(packed, block * B::kKc);
+    }
+  });
+  return storage;
+}
+
+c10::Storage pack_b_kernel(const GemmParams& params) {
+  c10::Storage storage;
+  AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+      params.dtype, "pack_b_cpu", [&] {
+        storage = pack_b_impl<scalar_t>(params);
+      });
+  return storage;
+}
+
+// Quantized GEMM, see QGemmParams: the loops of GemmTile on integers.
+//
+// A and B are packed with their zero points subtracted, as int16 values,
+// which lie in [-255, 255], and two steps along k share a 32-bit lane: an A
+// panel holds, for each pair of steps, one int32 per row (both values of
+// the row), a B panel one int32 per column. pmaddwd (_mm*_madd_epi16) of a
+// broadcast A word and a B vector then does two exact multiply-adds per
+// lane; with AVX-512 VNNI, vpdpwssd also adds them to the accumulator. The
+// pmaddubsw usual for uint8 x int8 does as many per instruction but
+// saturates its int16 pair sums, which this layout cannot.
+//
+// C is accumulated in an int32 workspace over the whole of k, a panel of
+// kMc rows at a time, then stored or requantized. Odd k and the edges of
+// C are padded with zeros in the packed panels, which add nothing.
+struct QBlocking {
+#if defined(CPU_CAPABILITY_AVX512)
+  static constexpr int64_t kMr = 12;
+  static constexpr int64_t kLanes = 16;
+#elif defined(CPU_CAPABILITY_AVX2)
+  static constexpr int64_t kMr = 6;
+  static constexpr int64_t kLanes = 8;
+#else
+  static constexpr int64_t kMr = 4;
+  static constexpr int64_t kLanes = 8;
+#endif
+  // two vectors of int32 columns per tile, as in Blocking
+  static constexpr int64_t kNr = 2 * kLanes;
+  // along k, in steps; even
+  static constexpr int64_t kKc = 256;
+  static constexpr int64_t kMc = 24 * kMr;
+  static constexpr int64_t kNc = 1024;
+};
+
+// The micro-kernel: c[0, kMr) x [0, kNr), row stride ldc, (+)= the A panel
+// times the B panel, over kc2 pairs of steps along k.
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
+
+#if defined(CPU_CAPABILITY_AVX512)
+using QVec = __m512i;
+#define QVEC_ZERO _mm512_setzero_si512
+#define QVEC_LOAD _mm512_loadu_si512
+#define QVEC_STORE _mm512_storeu_si512
+#define QVEC_SET1 _mm512_set1_epi32
+#define QVEC_MADD(acc, a, b) _mm512_add_epi32(acc, _mm512_madd_epi16(a, b))
+#else
+using QVec = __m256i;
+#define QVEC_ZERO _mm256_setzero_si256
+#define QVEC_LOAD(p) _mm256_loadu_si256(reinterpret_cast<const QVec*>(p))
+#define QVEC_STORE(p, v) _mm256_storeu_si256(reinterpret_cast<QVec*>(p), v)
+#define QVEC_SET1 _mm256_set1_epi32
+#define QVEC_MADD(acc, a, b) _mm256_add_epi32(acc, _mm256_madd_epi16(a, b))
+#endif
+
+// the body of the micro-kernels below, for each multiply-add instruction
+#define DEFINE_QGEMM_MICRO_KERNEL(NAME, ATTRIBUTES, MADD)             \
+  ATTRIBUTES void NAME(                                               \
+      int64_t kc2,                                                    \
+      const int32_t* a,                                               \
+      const int16_t* b,                                               \
+      bool accumulate,                                                \
+      int32_t* c,                                                     \
+      int64_t ldc) {                                                  \
+    constexpr int64_t kMr = QBlocking::kMr;                           \
+    constexpr int64_t kLanes = QBlocking::kLanes;                     \
+    QVec acc0[kMr];                                                   \
+    QVec acc1[kMr];                                                   \
+    _Pragma("GCC unroll 16") for (int64_t i = 0; i < kMr; ++i) {      \
+      acc0[i] = accumulate ? QVEC_LOAD(c + i * ldc) : QVEC_ZERO();    \
+      acc1[i] =                                                       \
+          accumulate ? QVEC_LOAD(c + i * ldc + kLanes) : QVEC_ZERO(); \
+    }                                                                 \
+    for (int64_t p = 0; p < kc2; ++p) {                               \
+      const QVec b0 = QVEC_LOAD(b);                                   \
+      const QVec b1 = QVEC_LOAD(b + 2 * kLanes);                      \
+      _Pragma("GCC unroll 16") for (int64_t i = 0; i < kMr; ++i) {    \
+        const QVec ai = QVEC_SET1(a[i]);                              \
+        acc0[i] = MADD(acc0[i], ai, b0);                              \
+        acc1[i] = MADD(acc1[i], ai, b1);                              \
+      }                                                               \
+      a += kMr;                                                       \
+      b += 4 * kLanes;                                                \
+    }                                                                 \
+    _Pragma("GCC unroll 16") for (int64_t i = 0; i < kMr; ++i) {      \
+      QVEC_STORE(c + i * ldc, acc0[i]);                               \
+      QVEC_STORE(c + i * ldc + kLanes, acc1[i]);                      \
+    }                                                                 \
+  }
+
+DEFINE_QGEMM_MICRO_KERNEL(qgemm_micro_kernel, , QVEC_MADD)
+
+#if defined(CPU_CAPABILITY_AVX512)
+// VNNI is not part of the AVX512 capability, so this variant is compiled
+// for it alone and chosen at runtime, see get_cpu_vnni()
+#define QVEC_DPWSSD(acc, a, b) _mm512_dpwssd_epi32(acc, a, b)
+DEFINE_QGEMM_MICRO_KERNEL(
+    qgemm_micro_kernel_vnni,
+    __attribute__((target("avx512vnni"))),
+    QVEC_DPWSSD)
+#undef QVEC_DPWSSD
+#endif
+
+#undef DEFINE_QGEMM_MICRO_KERNEL
+#undef QVEC_ZERO
+#undef QVEC_LOAD
+#undef QVEC_STORE
+#undef QVEC_SET1
+#undef QVEC_MADD
+
+#else
+
+void qgemm_micro_kernel(
+    int64_t kc2,
+    const int32_t* a,
+    const int16_t* b,
+    bool accumulate,
+    int32_t* c,
+    int64_t ldc) {
+  constexpr int64_t kMr = QBlocking::kMr;
+  constexpr int64_t kNr = QBlocking::kNr;
+  int32_t acc[kMr][kNr];
+  for (int64_t i = 0; i < kMr; ++i) {
+    for (int64_t j = 0; j < kNr; ++j) {
+      acc[i][j] = accumulate ? c[i * ldc + j] : 0;
+    }
+  }
+  for (int64_t p = 0; p < kc2; ++p) {
+    for (int64_t i = 0; i < kMr; ++i) {
+      const auto a0 = static_cast<int16_t>(a[i] & 0xFFFF);
+      const auto a1 = static_cast<int16_t>(a[i] >> 16);
+      for (int64_t j = 0; j < kNr; ++j) {
+        acc[i][j] += a0 * b[2 * j] + a1 * b[2 * j + 1];
+      }
+    }
+    a += kMr;
+    b += 2 * kNr;
+  }
+  for (int64_t i = 0; i < kMr; ++i) {
+    std::copy(acc[i], acc[i] + kNr, c + i * ldc);
+  }
+}
+
+#endif
+
+using qgemm_micro_kernel_fn = void (*)(
+    int64_t kc2,
+    const int32_t* a,
+    const int16_t* b,
+    bool accumulate,
+    int32_t* c,
+    int64_t ldc);
+
+qgemm_micro_kernel_fn select_qgemm_micro_kernel() {
+#if defined(CPU_CAPABILITY_AVX512)
+  if (get_cpu_vnni()) {
+    return &qgemm_micro_kernel_vnni;
+  }
+#endif
+  return &qgemm_micro_kernel;
+}
+
+class QGemmTile {
+  using B = QBlocking;
+
+ public:
+  explicit QGemmTile(const QGemmParams& p)
+      : p_(p),
+        micro_kernel_(select_qgemm_micro_kernel()),
+        inv_c_scale_(1.0f / static_cast<float>(p.c_scale)) {}
+
+  // computes rows [m0, m1) x columns [n0, n1) of C
+  void run(int64_t m0, int64_t m1, int64_t n0, int64_t n1) {
+    const int64_t kc2_max = divup(std::min(p_.k, B::kKc), int64_t(2));
+    const int64_t nc_max = round_up(std::min(n1 - n0, B::kNc), B::kNr);
+    const int64_t mc_max = round_up(std::min(m1 - m0, B::kMc), B::kMr);
+    a_pack_ = allocate(mc_max * kc2_max * sizeof(int32_t));
+    b_pack_ = allocate(nc_max * kc2_max * 2 * sizeof(int16_t));
+    workspace_ = allocate(mc_max * nc_max * sizeof(int32_t));
+    for (int64_t jc = n0; jc < n1; jc += B::kNc) {
+      const int64_t nc = std::min(B::kNc, n1 - jc);
+      for (int64_t ic = m0; ic < m1; ic += B::kMc) {
+        run_block(ic, std::min(B::kMc, m1 - ic), jc, nc);
+      }
+    }
+  }
+
+  // C[i, j] from its sum, stored or requantized
+  void store_c(int64_t i, int64_t j, int32_t sum) const {
+    const int64_t offset = i * p_.c_row_stride + j * p_.c_col_stride;
+    if (p_.c_dtype == c10::ScalarType::Int) {
+      static_cast<int32_t*>(p_.c)[offset] = sum;
+      return;
+    }
+    float y = static_cast<float>(sum) * p_.scales[j];
+    if (p_.bias) {
+      y += p_.bias[j];
+    }
+    // quantize_val<quint8>() with the inverse scale computed once
+    const float q = std::clamp(
+        std::nearbyint(y * inv_c_scale_),
+        static_cast<float>(-p_.c_zero_point),
+        static_cast<float>(255 - p_.c_zero_point));
+    static_cast<uint8_t*>(p_.c)[offset] =
+        static_cast<uint8_t>(static_cast<int32_t>(q) + p_.c_zero_point);
+  }
+
+ private:
+  static int64_t round_up(int64_t x, int64_t multiple) {
+    return divup(x, multiple) * multiple;
+  }
+
+  static c10::DataPtr allocate(int64_t nbytes) {
+    return c10::GetCPUAllocator()->allocate(nbytes);
+  }
+
+  // rows [ic, ic + mc) x columns [jc, jc + nc) of C
+  void run_block(int64_t ic, int64_t mc, int64_t jc, int64_t nc) {
+    auto* ws = static_cast<int32_t*>(workspace_.get());
+    const int64_t ldw = round_up(nc, B::kNr);
+    if (p_.k == 0) {
+      std::fill(ws, ws + round_up(mc, B::kMr) * ldw, 0);
+    }
+    auto* a_pack = static_cast<int32_t*>(a_pack_.get());
+    auto* b_pack = static_cast<int16_t*>(b_pack_.get());
+    for (int64_t pc = 0; pc < p_.k; pc += B::kKc) {
+      const int64_t kc = std::min(B::kKc, p_.k - pc);
+      const int64_t kc2 = divup(kc, int64_t(2));
+      pack_b(b_pack, pc, kc, jc, nc);
+      pack_a(a_pack, ic, mc, pc, kc);
+      for (int64_t jr = 0; jr < nc; jr += B::kNr) {
+        for (int64_t ir = 0; ir < mc; ir += B::kMr) {
+          micro_kernel_(
+              kc2,
+              a_pack + ir * kc2,
+              b_pack + jr * kc2 * 2,
+              pc > 0,
+              ws + ir * ldw + jr,
+              ldw);
+        }
+      }
+    }
+    for (int64_t i = 0; i < mc; ++i) {
+      for (int64_t j = 0; j < nc; ++j) {
+        store_c(ic + i, jc + j, ws[i * ldw + j]);
+      }
+    }
+  }
+
+  // A[i0, i0 + mc) x [p0, p0 + kc) less its zero point into panels of kMr
+  // rows, each a word of two int16 per row and pair of steps; padded with
+  // zeros to whole panels and pairs
+  void pack_a(int32_t* dst, int64_t i0, int64_t mc, int64_t p0, int64_t kc)
+      const {
+    const int64_t kc2 = divup(kc, int64_t(2));
+    for (int64_t ir = 0; ir < mc; ir += B::kMr) {
+      const int64_t mr = std::min(B::kMr, mc - ir);
+      const uint8_t* src =
+          p_.a + (i0 + ir) * p_.a_row_stride + p0 * p_.a_col_stride;
+      for (int64_t i = 0; i < B::kMr; ++i) {
+        const uint8_t* row = src + i * p_.a_row_stride;
+        for (int64_t p = 0; p < kc2; ++p) {
+          int32_t lo = 0;
+          int32_t hi = 0;
+          if (i < mr) {
+            lo = row[2 * p * p_.a_col_stride] - p_.a_zero_point;
+            if (2 * p + 1 < kc) {
+              hi = row[(2 * p + 1) * p_.a_col_stride] - p_.a_zero_point;
+            }
+          }
+          dst[p * B::kMr + i] = static_cast<int32_t>(
+              static_cast<uint32_t>(static_cast<uint16_t>(lo)) |
+              static_cast<uint32_t>(hi) << 16);
+        }
+      }
+      dst += kc2 * B::kMr;
+    }
+  }
+
+  // B[p0, p0 + kc) x [j0, j0 + nc) less its zero points into panels of kNr
+  // columns, each a pair of int16 per column and pair of steps; padded with
+  // zeros to whole panels and pairs
+  void pack_b(int16_t* dst, int64_t p0, int64_t kc, int64_t j0, int64_t nc)
+      const {
+    const int64_t kc2 = divup(kc, int64_t(2));
+    for (int64_t jr = 0; jr < nc; jr += B::kNr) {
+      const int64_t nr = std::min(B::kNr, nc - jr);
+      const int8_t* src =
+          p_.b + p0 * p_.b_row_stride + (j0 + jr) * p_.b_col_stride;
+      // column by column, which reads a transposed B (weights) contiguously
+      for (int64_t j = 0; j < B::kNr; ++j) {
+        int16_t* col = dst + 2 * j;
+        if (j >= nr) {
+          for (int64_t p = 0; p < kc2; ++p) {
+            col[p * 2 * B::kNr] = 0;
+            col[p * 2 * B::kNr + 1] = 0;
+          }
+          continue;
+        }
+        const int8_t* b_col = src + j * p_.b_col_stride;
+        const int32_t zero_point = p_.b_zero_points[j0 + jr + j];
+        for (int64_t p = 0; p < kc; ++p) {
+          col[(p / 2) * 2 * B::kNr + (p % 2)] = static_cast<int16_t>(
+              b_col[p * p_.b_row_stride] - zero_point);
+        }
+        if (kc % 2 != 0) {
+          col[(kc2 - 1) * 2 * B::kNr + 1] = 0;
+        }
+      }
+      dst += kc2 * 2 * B::kNr;
+    }
+  }
+
+  const QGemmParams& p_;
+  const qgemm_micro_kernel_fn micro_kernel_;
+  const float inv_c_scale_;
+  c10::DataPtr a_pack_;
+  c10::DataPtr b_pack_;
+  c10::DataPtr workspace_;
+};
+
+// A product of at most kMr rows with a transposed B (weights) reuses
+// nothing from B, so as in GemmTile it streams B instead of packing it: each
+// column, contiguous along k, is widened to int16 and dotted with the rows
+// of A, converted once.
+bool qgemm_is_skinny(const QGemmParams& p) {
+  return p.m <= QBlocking::kMr and p.b_row_stride == 1;
+}
+
+void qgemm_skinny(const QGemmParams& p, int64_t n0, int64_t n1) {
+  const int64_t m = p.m;
+  const int64_t k = p.k;
+  std::vector<int16_t> a(m * k);
+  for (int64_t i = 0; i < m; ++i) {
+    for (int64_t l = 0; l < k; ++l) {
+      a[i * k + l] = static_cast<int16_t>(
+          p.a[i * p.a_row_stride + l * p.a_col_stride] - p.a_zero_point);
+    }
+  }
+  const QGemmTile tile(p);
+  for (int64_t j = n0; j < n1; ++j) {
+    const int8_t* col = p.b + j * p.b_col_stride;
+    const int32_t zero_point = p.b_zero_points[j];
+    int32_t sums[QBlocking::kMr] = {};
+    int64_t l = 0;
+#if defined(CPU_CAPABILITY_AVX512)
+    const __m512i zp = _mm512_set1_epi16(static_cast<int16_t>(zero_point));
+    __m512i acc[QBlocking::kMr];
+    for (int64_t i = 0; i < m; ++i) {
+      acc[i] = _mm512_setzero_si512();
+    }
+    for (; l + 32 <= k; l += 32) {
+      const __m512i b = _mm512_sub_epi16(
+          _mm512_cvtepi8_epi16(_mm256_loadu_si256(
+              reinterpret_cast<const __m256i*>(col + l))),
+          zp);
+      for (int64_t i = 0; i < m; ++i) {
+        acc[i] = _mm512_add_epi32(
+            acc[i],
+            _mm512_madd_epi16(_mm512_loadu_si512(a.data() + i * k + l), b));
+      }
+    }
+    for (int64_t i = 0; i < m; ++i) {
+      sums[i] = _mm512_reduce_add_epi32(acc[i]);
+    }
+#elif defined(CPU_CAPABILITY_AVX2)
+    const __m256i zp = _mm256_set1_epi16(static_cast<int16_t>(zero_point));
+    __m256i acc[QBlocking::kMr];
+    for (int64_t i = 0; i < m; ++i) {
+      acc[i] = _mm256_setzero_si256();
+    }
+    for (; l + 16 <= k; l += 16) {
+      const __m256i b = _mm256_sub_epi16(
+          _mm256_cvtepi8_epi16(
+              _mm_loadu_si128(reinterpret_cast<const __m128i*>(col + l))),
+          zp);
+      for (int64_t i = 0; i < m; ++i) {
+        acc[i] = _mm256_add_epi32(
+            acc[i],
+            _mm256_madd_epi16(
+                _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(a.data() + i * k + l)),
+                b));
+      }
+    }
+    for (int64_t i = 0; i < m; ++i) {
+      __at_align__ int32_t lanes[8];
+      _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc[i]);
+      for (int32_t lane : lanes) {
+        sums[i] += lane;
+      }
+    }
+#endif
+    for (; l < k; ++l) {
+      const int32_t b = col[l] - zero_point;
+      for (int64_t i = 0; i < m; ++i) {
+        sums[i] += a[i * k + l] * b;
+      }
+    }
+    for (int64_t i = 0; i < m; ++i) {
+      tile.store_c(i, j, sums[i]);
+    }
+  }
+}
+
+void qgemm_kernel(const QGemmParams& p) {
+  using B = QBlocking;
+  if (qgemm_is_skinny(p)) {
+    const int64_t grain = std::max<int64_t>(
+        1, kMinParallelMacs / std::max<int64_t>(p.m * p.k, 1));
+    parallel_for(0, p.n, grain, [&](int64_t begin, int64_t end) {
+      qgemm_skinny(p, begin, end);
+    });
+    return;
+  }
+  const int64_t threads = p.m * p.n * p.k < kMinParallelMacs
+      ? 1
+      : static_cast<int64_t>(get_num_threads());
+  const auto [rows, cols] = choose_grid(p.m, p.n, B::kMr, B::kNr, threads);
+  const int64_t tile_m = divup(divup(p.m, B::kMr), rows) * B::kMr;
+  const int64_t tile_n = divup(divup(p.n, B::kNr), cols) * B::kNr;
+  parallel_for(0, rows * cols, 1, [&](int64_t begin, int64_t end) {
+    QGemmTile tile(p);
+    for (int64_t t = begin; t < end; ++t) {
+      const int64_t m0 = (t / cols) * tile_m;
+      const int64_t n0 = (t % cols) * tile_n;
+      if (m0 < p.m and n0 < p.n) {
+        tile.run(
+            m0, std::min(m0 + tile_m, p.m), n0, std::min(n0 + tile_n, p.n));
+      }
+    }
+  });
+}
+
+} // namespace
+} // namespace at::native::cpublas
+
+namespace at::native {
+
+REGISTER_DISPATCH(cpublas::gemm_stub, &cpublas::gemm_kernel)
+REGISTER_DISPATCH(cpublas::pack_b_stub, &cpublas::pack_b_kernel)
+REGISTER_DISPATCH(cpublas::qgemm_stub, &cpublas::qgemm_kernel)
+
+} // namespace at::native
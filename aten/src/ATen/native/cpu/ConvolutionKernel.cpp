@@ -0,0 +1,489 @@
+#include <ATen/Dispatch.h>
+#include <ATen/OpMathType.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/native/CPUBlas.h>
+#include <ATen/native/Convolution.h>
+#include <c10/cpu/CPUAllocator.h>
+
+#include <algorithm>
+#include <type_traits>
+
+// The convolution kernels that are not a GEMM over an im2col matrix, see
+// ConvAlgorithm. Tensors are 5-D as described in Convolution.h.
+
+namespace at::native {
+namespace {
+
+template <typename scalar_t>
+using acc_type = opmath_type<scalar_t>;
+
+template <typename T>
+c10::DataPtr allocate(int64_t count) {
+  return c10::GetCPUAllocator()->allocate(count * sizeof(T));
+}
+
+template <typename scalar_t>
+acc_type<scalar_t> bias_at(const Tensor& bias, int64_t c) {
+  if (!bias.defined()) {
+    return 0;
+  }
+  return bias.const_data_ptr<scalar_t>()[c * bias.stride(0)];
+}
+
+// Depthwise over channels-last tensors with one output channel per input
+// channel: each output pixel accumulates its taps over all channels at
+// once, vectorized along the contiguous channels.
+template <typename scalar_t>
+void depthwise_channels_last(
+    const Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const ConvParams& p) {
+  using acc_t = acc_type<scalar_t>;
+  using Vec = vec::Vectorized<acc_t>;
+  const int64_t channels = input.size(1);
+  const int64_t kd = weight.size(2), kh = weight.size(3), kw = weight.size(4);
+  const int64_t od = output.size(2), oh = output.size(3), ow = output.size(4);
+  const int64_t taps = kd * kh * kw;
+  const int64_t id = input.size(2), ih = input.size(3), iw = input.size(4);
+  const int64_t in_n = input.stride(0), in_z = input.stride(2);
+  const int64_t in_y = input.stride(3), in_x = input.stride(4);
+  // the weights tap by tap, each a row of channels, and the bias
+  c10::DataPtr weight_buffer = allocate<acc_t>((taps + 1) * channels);
+  auto* w = static_cast<acc_t*>(weight_buffer.get());
+  const scalar_t* weight_data = weight.const_data_ptr<scalar_t>();
+  for (int64_t c = 0; c < channels; ++c) {
+    for (int64_t t = 0; t < taps; ++t) {
+      w[t * channels + c] = static_cast<acc_t>(weight_data
+          [c * weight.stride(0) + (t / (kh * kw)) * weight.stride(2) +
+           (t / kw % kh) * weight.stride(3) + (t % kw) * weight.stride(4)]);
+    }
+    w[taps * channels + c] = bias_at<scalar_t>(bias, c);
+  }
+  const scalar_t* in = input.const_data_ptr<scalar_t>();
+  scalar_t* out = output.mutable_data_ptr<scalar_t>();
+  const int64_t pixels = output.size(0) * od * oh * ow;
+  parallel_for(0, pixels, 1 + 4096 / channels, [&](int64_t begin, int64_t end) {
+    // the accumulators, then a tap converted to acc_t
+    c10::DataPtr buffer = allocate<acc_t>(2 * channels);
+    auto* acc = static_cast<acc_t*>(buffer.get());
+    acc_t* tap = acc + channels;
+    for (int64_t r = begin; r < end; ++r) {
+      const int64_t n = r / (od * oh * ow);
+      const int64_t i0 = (r / (oh * ow) % od) * p.stride[0] - p.padding[0];
+      const int64_t j0 = (r / ow % oh) * p.stride[1] - p.padding[1];
+      const int64_t l0 = (r % ow) * p.stride[2] - p.padding[2];
+      std::copy(w + taps * channels, w + (taps + 1) * channels, acc);
+      for (int64_t t = 0; t < taps; ++t) {
+        const int64_t i = i0 + (t / (kh * kw)) * p.dilation[0];
+        const int64_t j = j0 + (t / kw % kh) * p.dilation[1];
+        const int64_t l = l0 + (t % kw) * p.dilation[2];
+        if (i < 0 or i >= id or j < 0 or j >= ih or l < 0 or l >= iw) {
+          continue;
+        }
+        const scalar_t* src = in + n * in_n + i * in_z + j * in_y + l * in_x;
+        const acc_t* x = tap;
+        if constexpr (std::is_same_v<scalar_t, acc_t>) {
+          x = src;
+        } else {
+          vec::convert(src, tap, channels);
+        }
+        const acc_t* wt = w + t * channels;
+        int64_t c = 0;
+        for (; c + Vec::size() <= channels; c += Vec::size()) {
+          vec::fmadd(Vec::loadu(x + c), Vec::loadu(wt + c), Vec::loadu(acc + c))
+              .store(acc + c);
+        }
+        for (; c < channels; ++c) {
+          acc[c] += x[c] * wt[c];
+        }
+      }
+      vec::convert(acc, out + r * channels, channels);
+    }
+  });
+}
+
+// Depthwise over any layout: each output row of a channel accumulates the
+// matching input rows tap by tap, vectorized along the row when the width
+// stride is 1.
+template <typename scalar_t>
+void depthwise_rows(
+    const Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const ConvParams& p) {
+  using acc_t = acc_type<scalar_t>;
+  using Vec = vec::Vectorized<acc_t>;
+  const int64_t multiplier = output.size(1) / input.size(1);
+  const int64_t kd = weight.size(2), kh = weight.size(3), kw = weight.size(4);
+  const int64_t od = output.size(2), oh = output.size(3), ow = output.size(4);
+  const int64_t id = input.size(2), ih = input.size(3), iw = input.size(4);
+  const int64_t in_n = input.stride(0), in_c = input.stride(1);
+  const int64_t in_z = input.stride(2), in_y = input.stride(3);
+  const int64_t in_x = input.stride(4);
+  const int64_t w_c = weight.stride(0), w_z = weight.stride(2);
+  const int64_t w_y = weight.stride(3), w_x = weight.stride(4);
+  const bool unit_stride = p.stride[2] == 1 and in_x == 1;
+  const scalar_t* in = input.const_data_ptr<scalar_t>();
+  const scalar_t* weight_data = weight.const_data_ptr<scalar_t>();
+  scalar_t* out = output.mutable_data_ptr<scalar_t>();
+  const int64_t channels = output.size(1);
+  const int64_t out_n = output.stride(0), out_c = output.stride(1);
+  const int64_t out_z = output.stride(2), out_y = output.stride(3);
+  const int64_t out_x = output.stride(4);
+  const int64_t rows = output.size(0) * channels * od * oh;
+  parallel_for(0, rows, 1 + 4096 / (ow * kd * kh * kw), [&](int64_t begin,
+                                                           int64_t end) {
+    // the accumulators, then an input row converted to acc_t
+    c10::DataPtr buffer = allocate<acc_t>(ow + iw);
+    auto* acc = static_cast<acc_t*>(buffer.get());
+    acc_t* row = acc + ow;
+    for (int64_t r = begin; r < end; ++r) {
+      const int64_t y = r % oh;
+      const int64_t z = r / oh % od;
+      const int64_t co = r / (oh * od) % channels;
+      const int64_t n = r / (oh * od * channels);
+      const scalar_t* src = in + n * in_n + (co / multiplier) * in_c;
+      std::fill(acc, acc + ow, bias_at<scalar_t>(bias, co));
+      for (int64_t a = 0; a < kd; ++a) {
+        const int64_t i = z * p.stride[0] - p.padding[0] + a * p.dilation[0];
+        for (int64_t b = 0; b < kh; ++b) {
+          const int64_t j =
+              y * p.stride[1] - p.padding[1] + b * p.dilation[1];
+          if (i < 0 or i >= id or j < 0 or j >= ih) {
+            continue;
+          }
+          const scalar_t* src_row = src + i * in_z + j * in_y;
+          const acc_t* x_row = row;
+          if constexpr (std::is_same_v<scalar_t, acc_t>) {
+            if (unit_stride) {
+              x_row = src_row;
+            }
+          }
+          if (x_row == row) {
+            for (int64_t l = 0; l < iw; ++l) {
+              row[l] = static_cast<acc_t>(src_row[l * in_x]);
+            }
+          }
+          for (int64_t c = 0; c < kw; ++c) {
+            const acc_t w = static_cast<acc_t>(
+                weight_data[co * w_c + a * w_z + b * w_y + c * w_x]);
+            const int64_t offset = c * p.dilation[2] - p.padding[2];
+            // the outputs [x0, x1) whose tap falls inside the row
+            const int64_t x0 = std::min(
+                ow, offset >= 0 ? 0 : divup(-offset, p.stride[2]));
+            const int64_t x1 = std::max(
+                x0,
+                std::min(ow, divup(iw - offset, p.stride[2])));
+            int64_t x = x0;
+            if (p.stride[2] == 1) {
+              const Vec wv(w);
+              for (; x + Vec::size() <= x1; x += Vec::size()) {
+                vec::fmadd(
+                    Vec::loadu(x_row + x + offset), wv, Vec::loadu(acc + x))
+                    .store(acc + x);
+              }
+            }
+            for (; x < x1; ++x) {
+              acc[x] += x_row[x * p.stride[2] + offset] * w;
+            }
+          }
+        }
+      }
+      scalar_t* dst = out + n * out_n + co * out_c + z * out_z + y * out_y;
+      for (int64_t x = 0; x < ow; ++x) {
+        dst[x * out_x] = static_cast<scalar_t>(acc[x]);
+      }
+    }
+  });
+}
+
+void depthwise_conv_kernel(
+    const Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const ConvParams& params) {
+  AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+      input.scalar_type(), "depthwise_conv", [&] {
+        if (output.size(1) == input.size(1) and input.stride(1) == 1 and
+            output.stride(1) == 1) {
+          depthwise_channels_last<scalar_t>(
+              output, input, weight, bias, params);
+        } else {
+          depthwise_rows<scalar_t>(output, input, weight, bias, params);
+        }
+      });
+}
+
+// The transform matrices of F(kTile x kTile, 3x3), from Lavin and Gray:
+// input tiles d become B^T d B, kernels g become G g G^T, and products m
+// become outputs A^T m A.
+template <int64_t kTile>
+struct WinogradMatrices;
+
+template <>
+struct WinogradMatrices<2> {
+  static constexpr int64_t kAlpha = 4;
+  static constexpr double BT[4][4] = {
+      {1, 0, -1, 0}, {0, 1, 1, 0}, {0, -1, 1, 0}, {0, 1, 0, -1}};
+  static constexpr double G[4][3] = {
+      {1, 0, 0}, {0.5, 0.5, 0.5}, {0.5, -0.5, 0.5}, {0, 0, 1}};
+  static constexpr double AT[2][4] = {{1, 1, 1, 0}, {0, 1, -1, -1}};
+};
+
+template <>
+struct WinogradMatrices<4> {
+  static constexpr int64_t kAlpha = 6;
+  static constexpr double BT[6][6] = {
+      {4, 0, -5, 0, 1, 0},
+      {0, -4, -4, 1, 1, 0},
+      {0, 4, -4, -1, 1, 0},
+      {0, -2, -1, 2, 1, 0},
+      {0, 2, -1, -2, 1, 0},
+      {0, 4, 0, -5, 0, 1}};
+  static constexpr double G[6][3] = {
+      {1. / 4, 0, 0},
+      {-1. / 6, -1. / 6, -1. / 6},
+      {-1. / 6, 1. / 6, -1. / 6},
+      {1. / 24, 1. / 12, 1. / 6},
+      {1. / 24, -1. / 12, 1. / 6},
+      {0, 0, 1}};
+  static constexpr double AT[4][6] = {
+      {1, 1, 1, 1, 1, 0},
+      {0, 1, -1, 2, -2, 0},
+      {0, 1, 1, 4, 4, 0},
+      {0, 1, -1, 8, -8, 1}};
+};
+
+// The transformed elements of a block of tiles are laid out as kAlpha^2
+// matrices, one per element position, of channels x tiles, so that the
+// products of all tiles at one position are one GEMM. The input and output
+// transforms run on Vec::size() tiles at once, along the tiles.
+//
+// Tiles are numbered over (image, tile row, tile column) and processed in
+// blocks of a size that depends only on the shapes; each block runs on one
+// thread, so the result does not depend on the number of threads.
+template <typename scalar_t, int64_t kTile>
+void winograd_conv_impl(
+    const Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const ConvParams& p) {
+  using W = WinogradMatrices<kTile>;
+  using Vec = vec::Vectorized<scalar_t>;
+  constexpr int64_t kAlpha = W::kAlpha;
+  constexpr int64_t kPositions = kAlpha * kAlpha;
+  constexpr int64_t kLanes = Vec::size();
+  const int64_t cin = input.size(1);
+  const int64_t cout = output.size(1);
+  const int64_t ih = input.size(3), iw = input.size(4);
+  const int64_t oh = output.size(3), ow = output.size(4);
+  const int64_t tiles_h = divup(oh, kTile), tiles_w = divup(ow, kTile);
+  const int64_t tiles = output.size(0) * tiles_h * tiles_w;
+
+  // U[position][co][ci] = (G g G^T)[position] of the kernel g of (co, ci)
+  c10::DataPtr u_buffer = allocate<scalar_t>(kPositions * cout * cin);
+  auto* u = static_cast<scalar_t*>(u_buffer.get());
+  const scalar_t* weight_data = weight.const_data_ptr<scalar_t>();
+  const int64_t w_co = weight.stride(0), w_ci = weight.stride(1);
+  const int64_t w_y = weight.stride(3), w_x = weight.stride(4);
+  parallel_for(0, cout, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t co = begin; co < end; ++co) {
+      for (int64_t ci = 0; ci < cin; ++ci) {
+        const scalar_t* g = weight_data + co * w_co + ci * w_ci;
+        double gg[kAlpha][3] = {};
+        for (int64_t a = 0; a < kAlpha; ++a) {
+          for (int64_t x = 0; x < 3; ++x) {
+            for (int64_t y = 0; y < 3; ++y) {
+              gg[a][x] +=
+                  W::G[a][y] * static_cast<double>(g[y * w_y + x * w_x]);
+            }
+          }
+        }
+        for (int64_t a = 0; a < kAlpha; ++a) {
+          for (int64_t b = 0; b < kAlpha; ++b) {
+            double sum = 0;
+            for (int64_t x = 0; x < 3; ++x) {
+              sum += gg[a][x] * W::G[b][x];
+            }
+            u[((a * kAlpha + b) * cout + co) * cin + ci] =
+                static_cast<scalar_t>(sum);
+          }
+        }
+      }
+    }
+  });
+
+  // a few MiB of transformed inputs and products per block, a whole number
+  // of vectors of tiles
+  const int64_t block = kLanes *
+      divup(std::clamp<int64_t>(
+                (int64_t(1) << 20) / (kPositions * (cin + cout)), 32, 512),
+            kLanes);
+  const scalar_t* in = input.const_data_ptr<scalar_t>();
+  scalar_t* out = output.mutable_data_ptr<scalar_t>();
+  const int64_t in_n = input.stride(0), in_c = input.stride(1);
+  const int64_t in_y = input.stride(3), in_x = input.stride(4);
+  const int64_t out_n = output.stride(0), out_c = output.stride(1);
+  const int64_t out_y = output.stride(3), out_x = output.stride(4);
+  parallel_for(0, divup(tiles, block), 1, [&](int64_t begin, int64_t end) {
+    c10::DataPtr buffer = allocate<scalar_t>(kPositions * (cin + cout) * block);
+    auto* v = static_cast<scalar_t*>(buffer.get());
+    scalar_t* m = v + kPositions * cin * block;
+    for (int64_t b = begin; b < end; ++b) {
+      const int64_t t0 = b * block;
+      const int64_t count = std::min(block, tiles - t0);
+      // V[position][ci][t] = (B^T d B)[position] of the input tile d
+      for (int64_t ci = 0; ci < cin; ++ci) {
+        for (int64_t t = 0; t < count; t += kLanes) {
+          const int64_t lanes = std::min(kLanes, count - t);
+          // element (y, x) of the tile in lane l at d[y][x][l]
+          scalar_t d[kAlpha][kAlpha][kLanes] = {};
+          for (int64_t l = 0; l < lanes; ++l) {
+            const int64_t tile = t0 + t + l;
+            const int64_t n = tile / (tiles_h * tiles_w);
+            const int64_t y0 =
+                (tile / tiles_w % tiles_h) * kTile - p.padding[1];
+            const int64_t x0 = (tile % tiles_w) * kTile - p.padding[2];
+            const scalar_t* src = in + n * in_n + ci * in_c;
+            for (int64_t y = 0; y < kAlpha; ++y) {
+              const int64_t j = y0 + y;
+              if (j < 0 or j >= ih) {
+                continue;
+              }
+              for (int64_t x = 0; x < kAlpha; ++x) {
+                const int64_t i = x0 + x;
+                if (i >= 0 and i < iw) {
+                  d[y][x][l] = src[j * in_y + i * in_x];
+                }
+              }
+            }
+          }
+          Vec bd[kAlpha][kAlpha];
+          for (int64_t a = 0; a < kAlpha; ++a) {
+            for (int64_t x = 0; x < kAlpha; ++x) {
+              Vec sum(0);
+              for (int64_t y = 0; y < kAlpha; ++y) {
+                if (W::BT[a][y] != 0) {
+                  sum = vec::fmadd(
+                      Vec(static_cast<scalar_t>(W::BT[a][y])),
+                      Vec::loadu(d[y][x]),
+                      sum);
+                }
+              }
+              bd[a][x] = sum;
+            }
+          }
+          for (int64_t a = 0; a < kAlpha; ++a) {
+            for (int64_t c = 0; c < kAlpha; ++c) {
+              Vec sum(0);
+              for (int64_t x = 0; x < kAlpha; ++x) {
+                if (W::BT[c][x] != 0) {
+                  sum = vec::fmadd(
+                      bd[a][x], Vec(static_cast<scalar_t>(W::BT[c][x])), sum);
+                }
+              }
+              sum.store(v + ((a * kAlpha + c) * cin + ci) * block + t);
+            }
+          }
+        }
+      }
+      // M[position] = U[position] @ V[position]
+      for (int64_t position = 0; position < kPositions; ++position) {
+        cpublas::GemmParams params;
+        params.dtype = input.scalar_type();
+        params.m = cout;
+        params.n = count;
+        params.k = cin;
+        params.a = u + position * cout * cin;
+        params.a_row_stride = cin;
+        params.a_col_stride = 1;
+        params.b = v + position * cin * block;
+        params.b_row_stride = block;
+        params.b_col_stride = 1;
+        params.c = m + position * cout * block;
+        params.c_row_stride = block;
+        params.c_col_stride = 1;
+        cpublas::gemm(params);
+      }
+      // output tile = A^T M A + bias; the lanes past count hold garbage
+      // and are not written
+      for (int64_t co = 0; co < cout; ++co) {
+        const Vec bias_value(bias_at<scalar_t>(bias, co));
+        for (int64_t t = 0; t < count; t += kLanes) {
+          const int64_t lanes = std::min(kLanes, count - t);
+          Vec am[kTile][kAlpha];
+          for (int64_t a = 0; a < kTile; ++a) {
+            for (int64_t x = 0; x < kAlpha; ++x) {
+              Vec sum(0);
+              for (int64_t y = 0; y < kAlpha; ++y) {
+                if (W::AT[a][y] != 0) {
+                  const scalar_t* product =
+                      m + ((y * kAlpha + x) * cout + co) * block + t;
+                  sum = vec::fmadd(
+                      Vec(static_cast<scalar_t>(W::AT[a][y])),
+                      Vec::loadu(product),
+                      sum);
+                }
+              }
+              am[a][x] = sum;
+            }
+          }
+          scalar_t result[kTile][kTile][kLanes];
+          for (int64_t a = 0; a < kTile; ++a) {
+            for (int64_t c = 0; c < kTile; ++c) {
+              Vec sum = bias_value;
+              for (int64_t x = 0; x < kAlpha; ++x) {
+                if (W::AT[c][x] != 0) {
+                  sum = vec::fmadd(
+                      am[a][x], Vec(static_cast<scalar_t>(W::AT[c][x])), sum);
+                }
+              }
+              sum.store(result[a][c]);
+            }
+          }
+          for (int64_t l = 0; l < lanes; ++l) {
+            const int64_t tile = t0 + t + l;
+            const int64_t n = tile / (tiles_h * tiles_w);
+            const int64_t y0 = (tile / tiles_w % tiles_h) * kTile;
+            const int64_t x0 = (tile % tiles_w) * kTile;
+            scalar_t* dst = out + n * out_n + co * out_c;
+            for (int64_t a = 0; a < kTile and y0 + a < oh; ++a) {
+              for (int64_t c = 0; c < kTile and x0 + c < ow; ++c) {
+                dst[(y0 + a) * out_y + (x0 + c) * out_x] = result[a][c][l];
+              }
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+void winograd_conv_kernel(
+    const Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const ConvParams& params,
+    int64_t tile) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "winograd_conv", [&] {
+    if (tile == 2) {
+      winograd_conv_impl<scalar_t, 2>(output, input, weight, bias, params);
+    } else {
+      winograd_conv_impl<scalar_t, 4>(output, input, weight, bias, params);
+    }
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(depthwise_conv_stub, &depthwise_conv_kernel)
+REGISTER_DISPATCH(winograd_conv_stub, &winograd_conv_kernel)
+
+} // namespace at::native
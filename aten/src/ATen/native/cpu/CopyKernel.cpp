@@ -0,0 +1,441 @@
+#include <ATen/Dispatch.h>
+#include <ATen/TensorIterator.h>
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/native/Copy.h>
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace at::native {
+namespace {
+
+// Conversions that go through an intermediate type (float for Half,
+// BFloat16 and the Float8 types) or a contiguous copy (strided rows) do so
+// this many elements at a time, in buffers that stay in L1.
+constexpr int64_t kStage = 256;
+
+// the types converted through float
+template <typename T>
+constexpr bool is_reduced_v =
+    c10::is_reduced_floating_point_v<T> or c10::is_float8_v<T>;
+
+template <typename dst_t, typename src_t>
+inline dst_t convert_value(src_t value) {
+  if constexpr (std::is_same_v<dst_t, bool>) {
+    if constexpr (is_reduced_v<src_t>) {
+      return static_cast<float>(value) != 0.f;
+    } else {
+      return value != src_t(0);
+    }
+  } else if constexpr (is_reduced_v<src_t>) {
+    return static_cast<dst_t>(static_cast<float>(value));
+  } else if constexpr (is_reduced_v<dst_t>) {
+    return dst_t(static_cast<float>(value));
+  } else {
+    return static_cast<dst_t>(value);
+  }
+}
+
+// dst[i] = convert_value(src[i]) for n contiguous elements. Half, BFloat16
+// and Float8 convert to and from float with vec::convert (F16C, or integer
+// rounding for the others), staging other types through float; every other
+// pair is a plain loop, which the compiler vectorizes with the instruction
+// set of the CPU_CAPABILITY it is built for.
+template <typename dst_t, typename src_t>
+void convert_contiguous(const src_t* src, dst_t* dst, int64_t n) {
+  if constexpr (std::is_same_v<dst_t, src_t>) {
+    std::memcpy(dst, src, n * sizeof(dst_t));
+  } else if constexpr (std::is_same_v<src_t, bool>) {
+    // a bool is stored as the byte 0 or 1, which as uint8_t converts the
+    // same and, unlike bool, vectorizes
+    convert_contiguous(reinterpret_cast<const uint8_t*>(src), dst, n);
+  } else if constexpr (
+      (is_reduced_v<src_t> and std::is_same_v<dst_t, float>) or
+      (is_reduced_v<dst_t> and std::is_same_v<src_t, float>)) {
+    vec::convert(src, dst, n);
+  } else if constexpr (is_reduced_v<src_t>) {
+    float buffer[kStage];
+    for (int64_t i = 0; i < n; i += kStage) {
+      const int64_t len = std::min(kStage, n - i);
+      vec::convert(src + i, buffer, len);
+      convert_contiguous(buffer, dst + i, len);
+    }
+  } else if constexpr (is_reduced_v<dst_t>) {
+    float buffer[kStage];
+    for (int64_t i = 0; i < n; i += kStage) {
+      const int64_t len = std::min(kStage, n - i);
+      convert_contiguous(src + i, buffer, len);
+      vec::convert(buffer, dst + i, len);
+    }
+  } else {
+    for (int64_t i = 0; i < n; ++i) {
+      dst[i] = convert_value<dst_t>(src[i]);
+    }
+  }
+}
+
+// converts n elements from src to dst, both with the given byte strides
+template <typename dst_t, typename src_t>
+void convert_strided(
+    const char* src,
+    int64_t src_stride,
+    char* dst,
+    int64_t dst_stride,
+    int64_t n) {
+  const bool src_contiguous = src_stride == sizeof(src_t);
+  const bool dst_contiguous = dst_stride == sizeof(dst_t);
+  if (src_contiguous and dst_contiguous) {
+    convert_contiguous(
+        reinterpret_cast<const src_t*>(src),
+        reinterpret_cast<dst_t*>(dst),
+        n);
+    return;
+  }
+  if (src_stride == 0) {
+    const dst_t value =
+        convert_value<dst_t>(*reinterpret_cast<const src_t*>(src));
+    for (int64_t i = 0; i < n; ++i) {
+      *reinterpret_cast<dst_t*>(dst + i * dst_stride) = value;
+    }
+    return;
+  }
+  // gather, convert and scatter a stage at a time, so the conversion itself
+  // still runs over contiguous buffers
+  src_t src_buffer[kStage];
+  dst_t dst_buffer[kStage];
+  for (int64_t i0 = 0; i0 < n; i0 += kStage) {
+    const int64_t len = std::min(kStage, n - i0);
+    const src_t* s = reinterpret_cast<const src_t*>(src + i0 * src_stride);
+    if (!src_contiguous) {
+      for (int64_t i = 0; i < len; ++i) {
+        src_buffer[i] = *reinterpret_cast<const src_t*>(
+            src + (i0 + i) * src_stride);
+      }
+      s = src_buffer;
+    }
+    if (dst_contiguous) {
+      convert_contiguous(
+          s, reinterpret_cast<dst_t*>(dst + i0 * dst_stride), len);
+      continue;
+    }
+    convert_contiguous(s, dst_buffer, len);
+    for (int64_t i = 0; i < len; ++i) {
+      *reinterpret_cast<dst_t*>(dst + (i0 + i) * dst_stride) = dst_buffer[i];
+    }
+  }
+}
+
+// A copy between layouts that disagree on the fastest dim, e.g. a
+// transposed or channels-last view into a contiguous tensor, reads one side
+// a column at a time. The 2-d loop instead copies it a square tile at a
+// time, so the cache lines of a tile's source rows are loaded once and used
+// by all of its destination rows; full 8 x 8 (4-byte) and 4 x 4 (8-byte)
+// blocks of a tile are transposed in registers. Tiles run along the source
+// rows, which the hardware prefetches, and threads take bands of the
+// destination's rows, as for_each splits the 2-d loop.
+constexpr int64_t kTile = 32;
+
+// dst[j * dst_ld + i] = src[i * src_ld + j], the leading dims in bytes, for
+// the rows x cols matrix src of elements of type T
+template <typename T>
+void transpose_scalar(
+    const char* src,
+    int64_t src_ld,
+    char* dst,
+    int64_t dst_ld,
+    int64_t rows,
+    int64_t cols) {
+  for (int64_t j = 0; j < cols; ++j) {
+    T* out = reinterpret_cast<T*>(dst + j * dst_ld);
+    for (int64_t i = 0; i < rows; ++i) {
+      out[i] = reinterpret_cast<const T*>(src + i * src_ld)[j];
+    }
+  }
+}
+
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
+
+// an 8 x 8 block of 4-byte elements; the shuffles move bits, whatever type
+// they are
+inline void transpose_8x8(
+    const char* src,
+    int64_t src_ld,
+    char* dst,
+    int64_t dst_ld) {
+  __m256 r[8];
+  for (int i = 0; i < 8; ++i) {
+    r[i] = _mm256_loadu_ps(reinterpret_cast<const float*>(src + i * src_ld));
+  }
+  __m256 t[8];
+  for (int i = 0; i < 8; i += 2) {
+    t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+    t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+  }
+  __m256 s[8];
+  for (int i = 0; i < 8; i += 4) {
+    s[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+    s[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+    s[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+    s[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+  }
+  for (int j = 0; j < 4; ++j) {
+    _mm256_storeu_ps(
+        reinterpret_cast<float*>(dst + j * dst_ld),
+        _mm256_permute2f128_ps(s[j], s[j + 4], 0x20));
+    _mm256_storeu_ps(
+        reinterpret_cast<float*>(dst + (j + 4) * dst_ld),
+        _mm256_permute2f128_ps(s[j], s[j + 4], 0x31));
+  }
+}
+
+// a 4 x 4 block of 8-byte elements
+inline void transpose_4x4(
+    const char* src,
+    int64_t src_ld,
+    char* dst,
+    int64_t dst_ld) {
+  __m256d r[4];
+  for (int i = 0; i < 4; ++i) {
+    r[i] = _mm256_loadu_pd(reinterpret_cast<const double*>(src + i * src_ld));
+  }
+  const __m256d t0 = _mm256_unpacklo_pd(r[0], r[1]);
+  const __m256d t1 = _mm256_unpackhi_pd(r[0], r[1]);
+  const __m256d t2 = _mm256_unpacklo_pd(r[2], r[3]);
+  const __m256d t3 = _mm256_unpackhi_pd(r[2], r[3]);
+  const auto store = [&](int j, __m256d v) {
+    _mm256_storeu_pd(reinterpret_cast<double*>(dst + j * dst_ld), v);
+  };
+  store(0, _mm256_permute2f128_pd(t0, t2, 0x20));
+  store(1, _mm256_permute2f128_pd(t1, t3, 0x20));
+  store(2, _mm256_permute2f128_pd(t0, t2, 0x31));
+  store(3, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+#endif
+
+// transpose_scalar of a tile, its full blocks in registers
+template <typename T>
+void transpose_tile(
+    const char* src,
+    int64_t src_ld,
+    char* dst,
+    int64_t dst_ld,
+    int64_t rows,
+    int64_t cols) {
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
+  if constexpr (sizeof(T) == 4 or sizeof(T) == 8) {
+    constexpr int64_t kBlock = sizeof(T) == 4 ? 8 : 4;
+    const int64_t full_rows = rows - rows % kBlock;
+    const int64_t full_cols = cols - cols % kBlock;
+    for (int64_t j = 0; j < full_cols; j += kBlock) {
+      for (int64_t i = 0; i < full_rows; i += kBlock) {
+        const char* s = src + i * src_ld + j * sizeof(T);
+        char* d = dst + j * dst_ld + i * sizeof(T);
+        if constexpr (sizeof(T) == 4) {
+          transpose_8x8(s, src_ld, d, dst_ld);
+        } else {
+          transpose_4x4(s, src_ld, d, dst_ld);
+        }
+      }
+    }
+    // the right and bottom edges
+    transpose_scalar<T>(
+        src + full_cols * sizeof(T),
+        src_ld,
+        dst + full_cols * dst_ld,
+        dst_ld,
+        rows,
+        cols - full_cols);
+    transpose_scalar<T>(
+        src + full_rows * src_ld,
+        src_ld,
+        dst + full_rows * sizeof(T),
+        dst_ld,
+        rows - full_rows,
+        full_cols);
+    return;
+  }
+#endif
+  transpose_scalar<T>(src, src_ld, dst, dst_ld, rows, cols);
+}
+
+// the unsigned type of the size of T, which the transposes move
+template <typename T>
+using bits_t = std::conditional_t<
+    sizeof(T) == 1,
+    uint8_t,
+    std::conditional_t<
+        sizeof(T) == 2,
+        uint16_t,
+        std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+
+// Converts the transpose of the rows x cols matrix src, whose rows are
+// src_ld bytes apart and contiguous, into the contiguous rows of dst,
+// dst_ld bytes apart, a tile at a time. Tiles of a conversion are
+// transposed into a buffer and converted from there, a row at a time.
+template <typename dst_t, typename src_t>
+void convert_transposed(
+    const char* src,
+    int64_t src_ld,
+    char* dst,
+    int64_t dst_ld,
+    int64_t rows,
+    int64_t cols) {
+  using bits = bits_t<src_t>;
+  for (int64_t i0 = 0; i0 < rows; i0 += kTile) {
+    const int64_t tile_rows = std::min(kTile, rows - i0);
+    for (int64_t j0 = 0; j0 < cols; j0 += kTile) {
+      const int64_t tile_cols = std::min(kTile, cols - j0);
+      const char* s = src + i0 * src_ld + j0 * sizeof(src_t);
+      char* d = dst + j0 * dst_ld + i0 * sizeof(dst_t);
+      if constexpr (std::is_same_v<dst_t, src_t>) {
+        transpose_tile<bits>(s, src_ld, d, dst_ld, tile_rows, tile_cols);
+      } else {
+        src_t buffer[kTile * kTile];
+        transpose_tile<bits>(
+            s,
+            src_ld,
+            reinterpret_cast<char*>(buffer),
+            kTile * sizeof(src_t),
+            tile_rows,
+            tile_cols);
+        for (int64_t j = 0; j < tile_cols; ++j) {
+          convert_contiguous(
+              buffer + j * kTile,
+              reinterpret_cast<dst_t*>(d + j * dst_ld),
+              tile_rows);
+        }
+      }
+    }
+  }
+}
+
+void convert_kernel(
+    const void* src,
+    ScalarType src_dtype,
+    void* dst,
+    ScalarType dst_dtype,
+    int64_t n) {
+  AT_DISPATCH_ALL_TYPES_AND_FLOAT8(dst_dtype, "convert", [&] {
+    using dst_t = scalar_t;
+    AT_DISPATCH_ALL_TYPES_AND_FLOAT8(src_dtype, "convert", [&] {
+      convert_contiguous(
+          static_cast<const scalar_t*>(src), static_cast<dst_t*>(dst), n);
+    });
+  });
+}
+
+void copy_kernel(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES_AND_FLOAT8(iter.dtype(0), "copy_", [&] {
+    using dst_t = scalar_t;
+    AT_DISPATCH_ALL_TYPES_AND_FLOAT8(iter.dtype(1), "copy_", [&] {
+      using src_t = scalar_t;
+      iter.for_each([](char** data,
+                       const int64_t* strides,
+                       int64_t size0,
+                       int64_t size1) {
+        // the destination is read along dim 0 and the source along dim 1
+        // (the destination decides the order of the dims)
+        const bool transposed = size1 > 1 and
+            strides[0] == sizeof(dst_t) and strides[3] == sizeof(src_t) and
+            strides[1] != sizeof(src_t) and strides[1] != 0;
+        if (transposed) {
+          convert_transposed<dst_t, src_t>(
+              data[1], strides[1], data[0], strides[2], size0, size1);
+          return;
+        }
+        for (int64_t j = 0; j < size1; ++j) {
+          convert_strided<dst_t, src_t>(
+              data[1] + j * strides[3],
+              strides[1],
+              data[0] + j * strides[2],
+              strides[0],
+              size0);
+        }
+      });
+    });
+  });
+}
+
+// dst[i] = src[i] * scale, computed in float, for n elements with the given
+// byte strides
+template <typename dst_t, typename src_t>
+void scaled_convert_strided(
+    const char* src,
+    int64_t src_stride,
+    char* dst,
+    int64_t dst_stride,
+    int64_t n,
+    float scale) {
+  using Vec = vec::Vectorized<float>;
+  if (src_stride != sizeof(src_t) or dst_stride != sizeof(dst_t)) {
+    for (int64_t i = 0; i < n; ++i) {
+      const float value = static_cast<float>(
+          *reinterpret_cast<const src_t*>(src + i * src_stride));
+      *reinterpret_cast<dst_t*>(dst + i * dst_stride) =
+          convert_value<dst_t>(value * scale);
+    }
+    return;
+  }
+  const auto* s = reinterpret_cast<const src_t*>(src);
+  auto* d = reinterpret_cast<dst_t*>(dst);
+  const Vec scale_vec(scale);
+  float in[kStage];
+  float out[kStage];
+  for (int64_t i = 0; i < n; i += kStage) {
+    const int64_t len = std::min(kStage, n - i);
+    convert_contiguous(s + i, in, len);
+    vec::map([&](const Vec& x) { return x * scale_vec; }, out, in, len);
+    convert_contiguous(out, d + i, len);
+  }
+}
+
+template <typename dst_t, typename src_t>
+void scaled_copy_loop(TensorIterator& iter, float scale) {
+  iter.for_each([&](char** data,
+                    const int64_t* strides,
+                    int64_t size0,
+                    int64_t size1) {
+    for (int64_t j = 0; j < size1; ++j) {
+      scaled_convert_strided<dst_t, src_t>(
+          data[1] + j * strides[3],
+          strides[1],
+          data[0] + j * strides[2],
+          strides[0],
+          size0,
+          scale);
+    }
+  });
+}
+
+void scaled_copy_kernel(TensorIterator& iter, double scale) {
+  const float s = static_cast<float>(scale);
+  // one side is a Float8 type, the other a floating one
+  if (isFloat8Type(iter.dtype(0))) {
+    AT_DISPATCH_FLOAT8_TYPES(iter.dtype(0), "scaled_copy", [&] {
+      using dst_t = scalar_t;
+      AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+          iter.dtype(1), "scaled_copy", [&] {
+            scaled_copy_loop<dst_t, scalar_t>(iter, s);
+          });
+    });
+  } else {
+    AT_DISPATCH_FLOAT8_TYPES(iter.dtype(1), "scaled_copy", [&] {
+      using src_t = scalar_t;
+      AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+          iter.dtype(0), "scaled_copy", [&] {
+            scaled_copy_loop<scalar_t, src_t>(iter, s);
+          });
+    });
+  }
+}
+
+} // namespace
+
+REGISTER_DISPATCH(convert_stub, &convert_kernel)
+REGISTER_DISPATCH(copy_stub, &copy_kernel)
+REGISTER_DISPATCH(scaled_copy_stub, &scaled_copy_kernel)
+
+} // namespace at::native
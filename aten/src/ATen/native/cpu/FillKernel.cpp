@@ -0,0 +1,41 @@
+#include <ATen/Dispatch.h>
+#include <ATen/TensorIterator.h>
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/native/Fill.h>
+
+namespace at::native {
+namespace {
+
+void fill_kernel(TensorIterator& iter, double value) {
+  AT_DISPATCH_ALL_TYPES_AND_FLOAT8(iter.dtype(), "fill_cpu", [&] {
+    using Vec = vec::Vectorized<scalar_t>;
+    const scalar_t scalar = static_cast<scalar_t>(value);
+    const Vec vector(scalar);
+    iter.for_each([&](char** data,
+                      const int64_t* strides,
+                      int64_t size0,
+                      int64_t size1) {
+      for (int64_t j = 0; j < size1; ++j) {
+        char* out = data[0] + j * strides[1];
+        if (strides[0] == sizeof(scalar_t)) {
+          auto* out_ptr = reinterpret_cast<scalar_t*>(out);
+          int64_t i = 0;
+          for (; i + Vec::size() <= size0; i += Vec::size()) {
+            vector.store(out_ptr + i);
+          }
+          vector.store(out_ptr + i, size0 - i);
+        } else {
+          for (int64_t i = 0; i < size0; ++i) {
+            *reinterpret_cast<scalar_t*>(out + i * strides[0]) = scalar;
+          }
+        }
+      }
+    });
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(fill_stub, &fill_kernel)
+
+} // namespace at::native
@@ -0,0 +1,245 @@
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/native/LayerNorm.h>
+#include <ATen/native/cpu/Rowwise.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace at::native {
+namespace {
+
+// The moments of a row are accumulated a chunk of this many elements at a
+// time, which stays in L1 between its mean and its squared deviations.
+constexpr int64_t kChunk = 1024;
+
+template <typename acc_t>
+acc_t row_sum(const acc_t* x, int64_t n) {
+  using Vec = vec::Vectorized<acc_t>;
+  return vec::reduce_all<acc_t>(
+      [](const Vec& a, const Vec& b) { return a + b; }, x, n);
+}
+
+// sum((x - mean)^2)
+template <typename acc_t>
+acc_t squared_deviations(const acc_t* x, acc_t mean, int64_t n) {
+  using Vec = vec::Vectorized<acc_t>;
+  return vec::map_reduce_all<acc_t>(
+      [mean](const Vec& v) {
+        const Vec d = v - Vec(mean);
+        return d * d;
+      },
+      [](const Vec& a, const Vec& b) { return a + b; },
+      x,
+      n);
+}
+
+// the mean and biased variance of a row of n elements, from the moments of
+// its chunks merged with the pairwise formula of Chan, Golub and LeVeque,
+// which stays accurate when the mean is large against the spread
+template <typename acc_t>
+std::pair<acc_t, acc_t> row_moments(const acc_t* x, int64_t n) {
+  acc_t mean = 0;
+  acc_t m2 = 0;
+  for (int64_t c0 = 0; c0 < n; c0 += kChunk) {
+    const int64_t len = std::min(kChunk, n - c0);
+    const acc_t chunk_mean = row_sum(x + c0, len) / acc_t(len);
+    const acc_t chunk_m2 = squared_deviations(x + c0, chunk_mean, len);
+    const acc_t delta = chunk_mean - mean;
+    const acc_t total = acc_t(c0 + len);
+    mean += delta * (acc_t(len) / total);
+    m2 += chunk_m2 + delta * delta * (acc_t(c0) * acc_t(len) / total);
+  }
+  return {mean, m2 / acc_t(n)};
+}
+
+// y = (x - mean) * rstd * weight + bias, weight and bias may be null
+template <typename acc_t>
+void layer_norm_row(
+    acc_t* y,
+    const acc_t* x,
+    int64_t n,
+    const acc_t* weight,
+    const acc_t* bias,
+    acc_t eps) {
+  using Vec = vec::Vectorized<acc_t>;
+  const auto moments = row_moments(x, n);
+  const acc_t rstd = acc_t(1) / std::sqrt(moments.second + eps);
+  // y = x * scale + shift, folding the mean into shift
+  const Vec scale(rstd);
+  const Vec shift(-moments.first * rstd);
+  if (weight and bias) {
+    vec::map3(
+        [&](const Vec& v, const Vec& w, const Vec& b) {
+          return vec::fmadd(vec::fmadd(v, scale, shift), w, b);
+        },
+        y,
+        x,
+        weight,
+        bias,
+        n);
+  } else if (weight) {
+    vec::map2(
+        [&](const Vec& v, const Vec& w) {
+          return vec::fmadd(v, scale, shift) * w;
+        },
+        y,
+        x,
+        weight,
+        n);
+  } else if (bias) {
+    vec::map2(
+        [&](const Vec& v, const Vec& b) {
+          return vec::fmadd(v, scale, shift) + b;
+        },
+        y,
+        x,
+        bias,
+        n);
+  } else {
+    vec::map(
+        [&](const Vec& v) { return vec::fmadd(v, scale, shift); }, y, x, n);
+  }
+}
+
+// y = x / sqrt(mean(x^2) + eps) * weight, weight may be null
+template <typename acc_t>
+void rms_norm_row(
+    acc_t* y,
+    const acc_t* x,
+    int64_t n,
+    const acc_t* weight,
+    acc_t eps) {
+  using Vec = vec::Vectorized<acc_t>;
+  const acc_t sum_squares = vec::map_reduce_all<acc_t>(
+      [](const Vec& v) { return v * v; },
+      [](const Vec& a, const Vec& b) { return a + b; },
+      x,
+      n);
+  const acc_t mean_square = sum_squares / acc_t(n);
+  const Vec rstd(acc_t(1) / std::sqrt(mean_square + eps));
+  if (weight) {
+    vec::map2(
+        [&](const Vec& v, const Vec& w) { return v * rstd * w; },
+        y,
+        x,
+        weight,
+        n);
+  } else {
+    vec::map([&](const Vec& v) { return v * rstd; }, y, x, n);
+  }
+}
+
+// the elements of a weight or bias as a contiguous array of acc_t, empty if
+// t is undefined
+template <typename acc_t, typename scalar_t>
+std::vector<acc_t> row_parameter(const Tensor& t) {
+  if (!t.defined()) {
+    return {};
+  }
+  std::vector<int64_t> dims(t.dim());
+  std::iota(dims.begin(), dims.end(), 0);
+  const RowLayout layout(t, dims);
+  std::vector<acc_t> values(layout.size());
+  const acc_t* row =
+      load_row(layout, t.const_data_ptr<scalar_t>(), 0, values.data());
+  if (row != values.data()) {
+    std::copy(row, row + layout.size(), values.begin());
+  }
+  return values;
+}
+
+// runs row_fn(y, x) on each row of the trailing normalized_dims dims of
+// input, writing it to the same row of output
+template <typename acc_t, typename scalar_t, typename row_fn_t>
+void for_each_norm_row(
+    const Tensor& output,
+    const Tensor& input,
+    int64_t normalized_dims,
+    const row_fn_t& row_fn) {
+  std::vector<int64_t> dims(normalized_dims);
+  std::iota(dims.begin(), dims.end(), input.dim() - normalized_dims);
+  const RowLayout in_rows(input, dims);
+  const RowLayout out_rows(output, dims);
+  const int64_t n = in_rows.size();
+  const scalar_t* in = input.const_data_ptr<scalar_t>();
+  scalar_t* out = output.mutable_data_ptr<scalar_t>();
+  parallel_for(
+      0,
+      in_rows.rows(),
+      1 + internal::GRAIN_SIZE / n,
+      [&](int64_t begin, int64_t end) {
+        std::vector<acc_t> buffer(
+            in_place_rows<acc_t, scalar_t>(in_rows) ? 0 : n);
+        std::vector<acc_t> out_buffer(
+            in_place_rows<acc_t, scalar_t>(out_rows) ? 0 : n);
+        for (int64_t row = begin; row < end; ++row) {
+          const acc_t* x = load_row(in_rows, in, row, buffer.data());
+          acc_t* y = row_destination(out_rows, out, row, out_buffer.data());
+          row_fn(y, x, n);
+          store_row(out_rows, out, row, y);
+        }
+      });
+}
+
+template <typename acc_t>
+const acc_t* data_or_null(const std::vector<acc_t>& values) {
+  return values.empty() ? nullptr : values.data();
+}
+
+void layer_norm_kernel(
+    const Tensor& output,
+    const Tensor& input,
+    int64_t normalized_dims,
+    const Tensor& weight,
+    const Tensor& bias,
+    double eps) {
+  AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+      input.scalar_type(), "layer_norm", [&] {
+        using acc_t = row_acc_t<scalar_t>;
+        const std::vector<acc_t> w = row_parameter<acc_t, scalar_t>(weight);
+        const std::vector<acc_t> b = row_parameter<acc_t, scalar_t>(bias);
+        const acc_t* w_data = data_or_null(w);
+        const acc_t* b_data = data_or_null(b);
+        for_each_norm_row<acc_t, scalar_t>(
+            output,
+            input,
+            normalized_dims,
+            [&](acc_t* y, const acc_t* x, int64_t n) {
+              layer_norm_row(y, x, n, w_data, b_data, static_cast<acc_t>(eps));
+            });
+      });
+}
+
+void rms_norm_kernel(
+    const Tensor& output,
+    const Tensor& input,
+    int64_t normalized_dims,
+    const Tensor& weight,
+    double eps) {
+  AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+      input.scalar_type(), "rms_norm", [&] {
+        using acc_t = row_acc_t<scalar_t>;
+        const std::vector<acc_t> w = row_parameter<acc_t, scalar_t>(weight);
+        const acc_t* w_data = data_or_null(w);
+        for_each_norm_row<acc_t, scalar_t>(
+            output,
+            input,
+            normalized_dims,
+            [&](acc_t* y, const acc_t* x, int64_t n) {
+              rms_norm_row(y, x, n, w_data, static_cast<acc_t>(eps));
+            });
+      });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(layer_norm_stub, &layer_norm_kernel)
+REGISTER_DISPATCH(rms_norm_stub, &rms_norm_kernel)
+
+} // namespace at::native
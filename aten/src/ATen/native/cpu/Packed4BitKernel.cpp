@@ -0,0 +1,221 @@
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/native/Packed4Bit.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// The product with a 4-bit weight is bound by reading the weight, a fourth
+// of the bytes of a Float one. The kernel reads the packed codes straight
+// from the weight and decodes them in registers: the nibbles of a few bytes
+// are spread to one lane each and looked up in a table of the 16 code
+// values held in registers (a permute), so no decoded copy of the weight is
+// ever written. Each group is accumulated unscaled and then added, times
+// its scale, to the accumulators of the row.
+
+namespace at::native {
+namespace {
+
+using Vec = vec::Vectorized<float>;
+
+// the values of the Int4 codes, two's complement nibbles
+constexpr float kInt4Values[16] =
+    {0, 1, 2, 3, 4, 5, 6, 7, -8, -7, -6, -5, -4, -3, -2, -1};
+
+// input rows sharing each decoded vector of the weight
+constexpr int64_t kRows = 4;
+
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2)
+// the codes of the bytes in the low half of `bytes`, one per byte, in
+// element order: the low nibble of a byte before its high nibble
+inline __m128i unpack_nibbles(__m128i bytes) {
+  const __m128i mask = _mm_set1_epi8(0xF);
+  return _mm_unpacklo_epi8(
+      _mm_and_si128(bytes, mask),
+      _mm_and_si128(_mm_srli_epi16(bytes, 4), mask));
+}
+#endif
+
+// Decodes the Vec::size() elements of Vec::size() / 2 bytes of codes.
+class Decoder {
+ public:
+  explicit Decoder(const float* values) : values_(values) {
+#if defined(CPU_CAPABILITY_AVX512)
+    table_ = _mm512_loadu_ps(values);
+#elif defined(CPU_CAPABILITY_AVX2)
+    table_lo_ = _mm256_loadu_ps(values);
+    table_hi_ = _mm256_loadu_ps(values + 8);
+#endif
+  }
+
+  Vec operator()(const uint8_t* codes) const {
+#if defined(CPU_CAPABILITY_AVX512)
+    const __m128i bytes =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(codes));
+    return _mm512_permutexvar_ps(
+        _mm512_cvtepu8_epi32(unpack_nibbles(bytes)), table_);
+#elif defined(CPU_CAPABILITY_AVX2)
+    int32_t word;
+    std::memcpy(&word, codes, sizeof(word));
+    const __m256i index =
+        _mm256_cvtepu8_epi32(unpack_nibbles(_mm_cvtsi32_si128(word)));
+    // the permutes use the low 3 bits of the code, bit 3 picks the half
+    return _mm256_blendv_ps(
+        _mm256_permutevar8x32_ps(table_lo_, index),
+        _mm256_permutevar8x32_ps(table_hi_, index),
+        _mm256_castsi256_ps(_mm256_slli_epi32(index, 28)));
+#else
+    return partial(codes, Vec::size());
+#endif
+  }
+
+  // the first n elements, n even, and zeros
+  Vec partial(const uint8_t* codes, int64_t n) const {
+    __at_align__ float values[Vec::size()] = {};
+    for (int64_t i = 0; i < n; i += 2) {
+      values[i] = values_[codes[i / 2] & 0xF];
+      values[i + 1] = values_[codes[i / 2] >> 4];
+    }
+    return Vec::loadu(values);
+  }
+
+ private:
+  const float* values_;
+#if defined(CPU_CAPABILITY_AVX512)
+  __m512 table_;
+#elif defined(CPU_CAPABILITY_AVX2)
+  __m256 table_lo_;
+  __m256 table_hi_;
+#endif
+};
+
+// out[r * ldo] = x[r] . w + bias for the kCount rows x[r] = x + r * ldx,
+// w the weight row of codes w_codes and scales w_scales
+template <int64_t kCount>
+void dot_rows(
+    const Decoder& decode,
+    const uint8_t* w_codes,
+    const c10::Half* w_scales,
+    const float* x,
+    int64_t ldx,
+    int64_t groups,
+    int64_t group_size,
+    float bias,
+    float* out,
+    int64_t ldo) {
+  Vec acc[kCount];
+  std::fill_n(acc, kCount, Vec(0.0f));
+  for (int64_t g = 0; g < groups; ++g) {
+    // two chains of accumulators, so that the latency of the fmadds does
+    // not bound a single input row
+    Vec even[kCount];
+    Vec odd[kCount];
+    std::fill_n(even, kCount, Vec(0.0f));
+    std::fill_n(odd, kCount, Vec(0.0f));
+    const int64_t begin = g * group_size;
+    const int64_t end = begin + group_size;
+    int64_t i = begin;
+    for (; i + 2 * Vec::size() <= end; i += 2 * Vec::size()) {
+      const Vec w0 = decode(w_codes + i / 2);
+      const Vec w1 = decode(w_codes + (i + Vec::size()) / 2);
+      for (int64_t r = 0; r < kCount; ++r) {
+        const float* row = x + r * ldx + i;
+        even[r] = vec::fmadd(w0, Vec::loadu(row), even[r]);
+        odd[r] = vec::fmadd(w1, Vec::loadu(row + Vec::size()), odd[r]);
+      }
+    }
+    if (i + Vec::size() <= end) {
+      const Vec w = decode(w_codes + i / 2);
+      for (int64_t r = 0; r < kCount; ++r) {
+        even[r] = vec::fmadd(w, Vec::loadu(x + r * ldx + i), even[r]);
+      }
+      i += Vec::size();
+    }
+    if (i < end) {
+      const Vec w = decode.partial(w_codes + i / 2, end - i);
+      for (int64_t r = 0; r < kCount; ++r) {
+        odd[r] =
+            vec::fmadd(w, Vec::loadu(x + r * ldx + i, end - i), odd[r]);
+      }
+    }
+    const Vec scale(static_cast<float>(w_scales[g]));
+    for (int64_t r = 0; r < kCount; ++r) {
+      acc[r] = vec::fmadd(even[r] + odd[r], scale, acc[r]);
+    }
+  }
+  for (int64_t r = 0; r < kCount; ++r) {
+    out[r * ldo] = vec::vec_reduce_all<float>(
+                       [](const Vec& a, const Vec& b) { return a + b; },
+                       acc[r]) +
+        bias;
+  }
+}
+
+void linear_4bit_kernel(
+    const Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& scales,
+    const Tensor& bias) {
+  const int64_t m = input.size(0);
+  const int64_t k = input.size(1);
+  const int64_t n = weight.size(0);
+  const int64_t groups = scales.size(1);
+  const int64_t group_size = groups > 0 ? k / groups : 0;
+  const Decoder decode(
+      weight.scalar_type() == ScalarType::Int4 ? kInt4Values
+                                               : c10::kNF4Values);
+  const auto* codes = static_cast<const uint8_t*>(weight.const_data_ptr());
+  const c10::Half* scale_data = scales.const_data_ptr<c10::Half>();
+  const float* x = input.const_data_ptr<float>();
+  const float* bias_data =
+      bias.defined() ? bias.const_data_ptr<float>() : nullptr;
+  float* out = output.mutable_data_ptr<float>();
+  const int64_t grain =
+      std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, m * k));
+  parallel_for(0, n, grain, [&](int64_t begin, int64_t end) {
+    for (int64_t j = begin; j < end; ++j) {
+      const uint8_t* w_codes = codes + j * (k / 2);
+      const c10::Half* w_scales = scale_data + j * groups;
+      const float b = bias_data ? bias_data[j] : 0.0f;
+      // the weight row stays in L1 while the input rows stream past it
+      for (int64_t i = 0; i < m; i += kRows) {
+        const auto rows = [&](auto count) {
+          dot_rows<decltype(count)::value>(
+              decode,
+              w_codes,
+              w_scales,
+              x + i * k,
+              k,
+              groups,
+              group_size,
+              b,
+              out + i * n + j,
+              n);
+        };
+        switch (std::min(kRows, m - i)) {
+          case 1:
+            rows(std::integral_constant<int64_t, 1>());
+            break;
+          case 2:
+            rows(std::integral_constant<int64_t, 2>());
+            break;
+          case 3:
+            rows(std::integral_constant<int64_t, 3>());
+            break;
+          default:
+            rows(std::integral_constant<int64_t, kRows>());
+        }
+      }
+    }
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(linear_4bit_stub, &linear_4bit_kernel)
+
+} // namespace at::native
@@ -0,0 +1,505 @@
+#pragma once
+
+#include <ATen/Parallel.h>
+#include <ATen/TensorIterator.h>
+#include <ATen/cpu/vec/vec.h>
+#include <c10/core/ScalarType.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Reduction engine for the kernels in native/cpu, driven by a
+// TensorIterator built with TensorIterator::reduce_op.
+//
+// Results are bit-identical for any number of threads: the elements reduced
+// into one output are split into chunks of kChunkSize elements, and each
+// chunk is reduced by a single thread the same way wherever it runs.
+// Threads share out whole (output, chunk) units, and the partials of an
+// output's chunks are always combined in the same pairwise tree, so the
+// thread count changes which thread computes a chunk but never how. That
+// rules out the usual per-thread partials, whose number and extent depend
+// on the thread count.
+//
+// Within a chunk:
+//  - when the fastest moving input dim is reduced and unit-stride ("inner"
+//    reduction, e.g. summing the rows of a row-major matrix), element j of
+//    each contiguous run goes to accumulator lane j % kNumLanes, the lanes
+//    being held in Vectorized registers; lane i then absorbs lane
+//    i + kNumLanes / 2, and so on halving down to lane 0. kNumLanes does not
+//    depend on the vector width, so neither does the order of the additions.
+//  - when the fastest moving input dim is kept ("outer" reduction, e.g.
+//    summing the columns), kOuterVecs * Vectorized<acc_t>::size() adjacent
+//    outputs are reduced at once, a row of them per step so that each input
+//    row is read in long contiguous pieces, each output sequentially over
+//    the chunk.
+//  - otherwise (strided inner dim, ops without vectorized form) every
+//    output is reduced sequentially over the chunk.
+//
+// An ops_t for binary_kernel_reduce provides
+//
+//   using value_t;  // elements are converted to it before being reduced
+//   using acc_t;    // partial result
+//   using out_t;    // the output's C++ type
+//   static constexpr bool vectorized;
+//   acc_t identity() const;
+//   acc_t reduce(acc_t acc, value_t x, int64_t index) const;
+//   acc_t combine(acc_t a, acc_t b) const;  // a precedes b
+//   out_t project(acc_t acc) const;
+//
+// and, if vectorized (which requires acc_t == value_t),
+//
+//   Vectorized<acc_t> reduce(Vectorized<acc_t> acc, Vectorized<acc_t> x)
+//   Vectorized<acc_t> combine(Vectorized<acc_t> a, Vectorized<acc_t> b)
+//
+// with the same per-lane semantics as the scalar forms; reducing
+// identity() into an accumulator must leave it unchanged. `index` is the
+// linear index of x among the elements reduced into its output, in the
+// iterator's dim order (row-major over the reduced dims if the iterator was
+// built with enforce_linear_iteration).
+
+namespace at::native {
+inline namespace CPU_CAPABILITY {
+
+namespace reduce_detail {
+
+constexpr int64_t kChunkSize = internal::GRAIN_SIZE;
+
+template <typename acc_t>
+constexpr int64_t kNumLanes = 256 / sizeof(acc_t);
+
+// the number of vectors of outputs an outer reduction task covers
+constexpr int64_t kOuterVecs = 8;
+
+// TensorIterator dims are limited to the dims of a reduced tensor
+constexpr size_t kMaxDims = 64;
+
+// Walks a multi-dim index space, dim 0 fastest, in runs along dim 0,
+// tracking the byte offsets of NARGS operands.
+template <int NARGS>
+struct StridedCounter {
+  using strides_t = std::array<IntArrayRef, NARGS>;
+
+  StridedCounter(IntArrayRef sizes, strides_t strides, int64_t linear)
+      : sizes_(sizes), strides_(strides) {
+    TORCH_INTERNAL_ASSERT(sizes.size() <= kMaxDims);
+    std::fill(index_.begin(), index_.begin() + sizes.size(), 0);
+    offsets.fill(0);
+    for (size_t dim = 0; dim < sizes.size() and linear > 0; ++dim) {
+      index_[dim] = linear % sizes[dim];
+      linear /= sizes[dim];
+      for (int arg = 0; arg < NARGS; ++arg) {
+        offsets[arg] += index_[dim] * strides[arg][dim];
+      }
+    }
+  }
+
+  // positions left in the current run along dim 0
+  int64_t run_remaining() const {
+    return sizes_.empty() ? 1 : sizes_[0] - index_[0];
+  }
+
+  // moves n <= run_remaining() positions ahead
+  void advance(int64_t n) {
+    if (sizes_.empty()) {
+      return;
+    }
+    index_[0] += n;
+    for (int arg = 0; arg < NARGS; ++arg) {
+      offsets[arg] += n * strides_[arg][0];
+    }
+    for (size_t dim = 0;
+         index_[dim] == sizes_[dim] and dim + 1 < sizes_.size();
+         ++dim) {
+      index_[dim] = 0;
+      index_[dim + 1]++;
+      for (int arg = 0; arg < NARGS; ++arg) {
+        offsets[arg] +=
+            strides_[arg][dim + 1] - sizes_[dim] * strides_[arg][dim];
+      }
+    }
+  }
+
+  std::array<int64_t, NARGS> offsets;
+
+ private:
+  IntArrayRef sizes_;
+  strides_t strides_;
+  // not a std::vector, which would allocate for every unit of work
+  std::array<int64_t, kMaxDims> index_;
+};
+
+// The iterator's dims split into reduced dims (output stride 0) and kept
+// dims, each fastest moving first.
+struct ReduceGeometry {
+  explicit ReduceGeometry(const TensorIterator& iter) {
+    const IntArrayRef shape = iter.shape();
+    const IntArrayRef out_strides = iter.strides(0);
+    const IntArrayRef in_strides = iter.strides(1);
+    for (int dim = 0; dim < iter.ndim(); ++dim) {
+      if (out_strides[dim] == 0) {
+        inner = inner or dim == 0;
+        reduced_sizes.push_back(shape[dim]);
+        reduced_strides.push_back(in_strides[dim]);
+        num_reduced *= shape[dim];
+      } else {
+        kept_sizes.push_back(shape[dim]);
+        kept_in_strides.push_back(in_strides[dim]);
+        kept_out_strides.push_back(out_strides[dim]);
+        num_outputs *= shape[dim];
+      }
+    }
+  }
+
+  std::vector<int64_t> reduced_sizes;
+  // input byte strides
+  std::vector<int64_t> reduced_strides;
+  std::vector<int64_t> kept_sizes;
+  std::vector<int64_t> kept_in_strides;
+  std::vector<int64_t> kept_out_strides;
+  int64_t num_reduced = 1;
+  int64_t num_outputs = 1;
+  // whether the fastest moving dim is reduced
+  bool inner = false;
+};
+
+// combines values[0, n) pairwise: neighbours first, then pairs of pairs...
+template <typename acc_t, typename combine_t>
+acc_t tree_combine(acc_t* values, int64_t n, const combine_t& combine) {
+  for (int64_t step = 1; step < n; step *= 2) {
+    for (int64_t i = 0; i + step < n; i += 2 * step) {
+      values[i] = combine(values[i], values[i + step]);
+    }
+  }
+  return values[0];
+}
+
+template <typename scalar_t, typename value_t>
+constexpr bool can_load_vec_v = std::is_same_v<scalar_t, value_t> or
+    (c10::is_reduced_floating_point_v<scalar_t> and
+     std::is_same_v<value_t, float>);
+
+// loads Vectorized<float>::size() reduced floating point values widened to
+// float
+template <typename scalar_t>
+vec::Vectorized<float> load_fp32(const scalar_t* ptr) {
+  if constexpr (std::is_same_v<scalar_t, c10::Half>) {
+    return vec::load_fp32_from_fp16(ptr);
+  } else {
+    return vec::load_fp32_from_bf16(ptr);
+  }
+}
+
+// loads Vectorized<value_t>::size() elements, converting them to value_t;
+// with count < size() the other lanes are unspecified
+template <typename value_t, typename scalar_t>
+vec::Vectorized<value_t> load_vec(
+    const scalar_t* ptr,
+    int64_t count = vec::Vectorized<value_t>::size()) {
+  using Vec = vec::Vectorized<value_t>;
+  if constexpr (std::is_same_v<scalar_t, value_t>) {
+    return Vec::loadu(ptr, count);
+  } else {
+    if (count == Vec::size()) {
+      return load_fp32(ptr);
+    }
+    __at_align__ scalar_t tmp[Vec::size()] = {};
+    std::copy(ptr, ptr + count, tmp);
+    return load_fp32(tmp);
+  }
+}
+
+template <typename scalar_t, typename ops_t>
+class ReduceRunner {
+  using value_t = typename ops_t::value_t;
+  using acc_t = typename ops_t::acc_t;
+  using out_t = typename ops_t::out_t;
+  using Vec = vec::Vectorized<value_t>;
+  // outputs per unit of work
+  static constexpr int64_t kUnitOutputs = kOuterVecs * Vec::size();
+  using unit_partials_t = std::array<acc_t, kUnitOutputs>;
+
+ public:
+  ReduceRunner(const TensorIterator& iter, const ops_t& ops)
+      : ops_(ops), geom_(iter),
+        in_(static_cast<const char*>(iter.data_ptr(1))),
+        out_(static_cast<char*>(iter.data_ptr(0))) {
+    if constexpr (ops_t::vectorized and can_load_vec_v<scalar_t, value_t>) {
+      static_assert(std::is_same_v<acc_t, value_t>);
+      const auto element_size = static_cast<int64_t>(sizeof(scalar_t));
+      if (geom_.inner and geom_.reduced_strides[0] == element_size) {
+        mode_ = Mode::Inner;
+      } else if (
+          !geom_.inner and !geom_.kept_sizes.empty() and
+          geom_.kept_in_strides[0] == element_size) {
+        mode_ = Mode::Outer;
+      }
+    }
+    num_chunks_ =
+        std::max<int64_t>(divup(geom_.num_reduced, kChunkSize), 1);
+    // An outer task reduces a group of adjacent outputs along kept dim 0,
+    // the others a single output.
+    task_sizes_ = geom_.kept_sizes;
+    task_in_strides_ = geom_.kept_in_strides;
+    task_out_strides_ = geom_.kept_out_strides;
+    if (mode_ == Mode::Outer) {
+      task_sizes_[0] = divup(geom_.kept_sizes[0], kUnitOutputs);
+      task_in_strides_[0] *= kUnitOutputs;
+      task_out_strides_[0] *= kUnitOutputs;
+    }
+    num_tasks_ = 1;
+    for (int64_t size : task_sizes_) {
+      num_tasks_ *= size;
+    }
+  }
+
+  void run() {
+    if (geom_.num_outputs == 0) {
+      return;
+    }
+    const int64_t elements_per_unit =
+        std::min(geom_.num_reduced, kChunkSize) *
+        (mode_ == Mode::Outer ? kUnitOutputs : 1);
+    const int64_t grain_size = std::max<int64_t>(
+        internal::GRAIN_SIZE / std::max<int64_t>(elements_per_unit, 1), 1);
+
+    if (num_chunks_ == 1) {
+      parallel_for(0, num_tasks_, grain_size, [&](int64_t begin, int64_t end) {
+        StridedCounter<2> task(
+            task_sizes_, {task_in_strides_, task_out_strides_}, begin);
+        for (int64_t t = begin; t < end; ++t) {
+          unit_partials_t partials;
+          const int64_t n = reduce_unit(t, task.offsets[0], 0, partials);
+          for (int64_t i = 0; i < n; ++i) {
+            store(task.offsets[1], i, ops_.project(partials[i]));
+          }
+          task.advance(1);
+        }
+      });
+      return;
+    }
+
+    // partials[output * num_chunks_ + chunk]; not a std::vector, which
+    // packs bools
+    auto partials =
+        std::make_unique<acc_t[]>(geom_.num_outputs * num_chunks_);
+    const int64_t num_units = num_tasks_ * num_chunks_;
+    parallel_for(0, num_units, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t u = begin; u < end; ++u) {
+        const int64_t t = u / num_chunks_;
+        const int64_t chunk = u % num_chunks_;
+        StridedCounter<1> task(task_sizes_, {task_in_strides_}, t);
+        unit_partials_t unit_partials;
+        const int64_t n =
+            reduce_unit(t, task.offsets[0], chunk, unit_partials);
+        const int64_t first_output = first_output_of_task(t);
+        for (int64_t i = 0; i < n; ++i) {
+          partials[(first_output + i) * num_chunks_ + chunk] =
+              unit_partials[i];
+        }
+      }
+    });
+    const int64_t combine_grain =
+        std::max<int64_t>(internal::GRAIN_SIZE / num_chunks_, 1);
+    parallel_for(
+        0, geom_.num_outputs, combine_grain, [&](int64_t begin, int64_t end) {
+          StridedCounter<1> output(
+              geom_.kept_sizes, {geom_.kept_out_strides}, begin);
+          for (int64_t o = begin; o < end; ++o) {
+            const acc_t acc = tree_combine(
+                &partials[o * num_chunks_],
+                num_chunks_,
+                [&](acc_t a, acc_t b) { return ops_.combine(a, b); });
+            store(output.offsets[0], 0, ops_.project(acc));
+            output.advance(1);
+          }
+        });
+  }
+
+ private:
+  enum class Mode { Scalar, Inner, Outer };
+
+  void store(int64_t offset, int64_t i, out_t value) const {
+    const int64_t stride = geom_.kept_out_strides.empty()
+        ? 0
+        : geom_.kept_out_strides[0];
+    *reinterpret_cast<out_t*>(out_ + offset + i * stride) = value;
+  }
+
+  int64_t first_output_of_task(int64_t t) const {
+    if (mode_ != Mode::Outer) {
+      return t;
+    }
+    const int64_t row = t / task_sizes_[0];
+    const int64_t group = t % task_sizes_[0];
+    return row * geom_.kept_sizes[0] + group * kUnitOutputs;
+  }
+
+  // Reduces chunk `chunk` of the outputs of task t, whose first input
+  // element is at byte offset in_offset, into partials; returns the number
+  // of outputs.
+  int64_t reduce_unit(
+      int64_t t,
+      int64_t in_offset,
+      int64_t chunk,
+      unit_partials_t& partials) const {
+    const int64_t begin = chunk * kChunkSize;
+    const int64_t end = std::min(begin + kChunkSize, geom_.num_reduced);
+    const char* in = in_ + in_offset;
+    if constexpr (ops_t::vectorized and can_load_vec_v<scalar_t, value_t>) {
+      if (mode_ == Mode::Inner) {
+        partials[0] = reduce_inner(in, begin, end);
+        return 1;
+      }
+      if (mode_ == Mode::Outer) {
+        const int64_t group = t % task_sizes_[0];
+        const int64_t count = std::min<int64_t>(
+            kUnitOutputs, geom_.kept_sizes[0] - group * kUnitOutputs);
+        reduce_outer(in, begin, end, count, partials.data());
+        return count;
+      }
+    }
+    partials[0] = reduce_scalar(in, begin, end);
+    return 1;
+  }
+
+  acc_t reduce_scalar(const char* in, int64_t begin, int64_t end) const {
+    acc_t acc = ops_.identity();
+    StridedCounter<1> r(geom_.reduced_sizes, {geom_.reduced_strides}, begin);
+    const int64_t stride =
+        geom_.reduced_strides.empty() ? 0 : geom_.reduced_strides[0];
+    for (int64_t index = begin; index < end;) {
+      const int64_t n = std::min(r.run_remaining(), end - index);
+      const char* ptr = in + r.offsets[0];
+      for (int64_t j = 0; j < n; ++j) {
+        const auto x = *reinterpret_cast<const scalar_t*>(ptr + j * stride);
+        acc = ops_.reduce(acc, static_cast<value_t>(x), index + j);
+      }
+      index += n;
+      r.advance(n);
+    }
+    return acc;
+  }
+
+  acc_t reduce_inner(const char* in, int64_t begin, int64_t end) const {
+    constexpr int64_t kLanes = kNumLanes<acc_t>;
+    constexpr int64_t kVecs = kLanes / Vec::size();
+    static_assert(kLanes % Vec::size() == 0);
+    const Vec identity(ops_.identity());
+    std::array<Vec, kVecs> acc;
+    acc.fill(identity);
+    StridedCounter<1> r(geom_.reduced_sizes, {geom_.reduced_strides}, begin);
+    for (int64_t index = begin; index < end;) {
+      const int64_t n = std::min(r.run_remaining(), end - index);
+      const auto* ptr = reinterpret_cast<const scalar_t*>(in + r.offsets[0]);
+      int64_t j = 0;
+      for (; j + kLanes <= n; j += kLanes) {
+        for (int64_t k = 0; k < kVecs; ++k) {
+          acc[k] = ops_.reduce(
+              acc[k], load_vec<value_t>(ptr + j + k * Vec::size()));
+        }
+      }
+      // the rest of the run goes to the first lanes, padded with identity
+      for (int64_t k = 0; j < n; ++k, j += Vec::size()) {
+        const int64_t count = std::min<int64_t>(Vec::size(), n - j);
+        Vec x = load_vec<value_t>(ptr + j, count);
+        if (count < Vec::size()) {
+          x = Vec::set(identity, x, count);
+        }
+        acc[k] = ops_.reduce(acc[k], x);
+      }
+      index += n;
+      r.advance(n);
+    }
+    // halving steps of at least a vector combine whole vectors, the
+    // remaining ones single lanes
+    for (int64_t half = kVecs / 2; half >= 1; half /= 2) {
+      for (int64_t k = 0; k < half; ++k) {
+        acc[k] = ops_.combine(acc[k], acc[k + half]);
+      }
+    }
+    __at_align__ acc_t lanes[Vec::size()];
+    acc[0].store(lanes);
+    for (int64_t half = Vec::size() / 2; half >= 1; half /= 2) {
+      for (int64_t i = 0; i < half; ++i) {
+        lanes[i] = ops_.combine(lanes[i], lanes[i + half]);
+      }
+    }
+    return lanes[0];
+  }
+
+  // reduces `count` <= kUnitOutputs adjacent outputs into partials
+  void reduce_outer(
+      const char* in,
+      int64_t begin,
+      int64_t end,
+      int64_t count,
+      acc_t* partials) const {
+    const int64_t full_vecs = count / Vec::size();
+    const int64_t tail = count % Vec::size();
+    std::array<Vec, kOuterVecs> acc;
+    acc.fill(Vec(ops_.identity()));
+    StridedCounter<1> r(geom_.reduced_sizes, {geom_.reduced_strides}, begin);
+    const int64_t stride =
+        geom_.reduced_strides.empty() ? 0 : geom_.reduced_strides[0];
+    for (int64_t index = begin; index < end;) {
+      const int64_t n = std::min(r.run_remaining(), end - index);
+      const char* ptr = in + r.offsets[0];
+      if (full_vecs == kOuterVecs) {
+        for (int64_t j = 0; j < n; ++j) {
+          const auto* row = reinterpret_cast<const scalar_t*>(ptr + j * stride);
+          for (int64_t k = 0; k < kOuterVecs; ++k) {
+            acc[k] =
+                ops_.reduce(acc[k], load_vec<value_t>(row + k * Vec::size()));
+          }
+        }
+      } else {
+        for (int64_t j = 0; j < n; ++j) {
+          const auto* row = reinterpret_cast<const scalar_t*>(ptr + j * stride);
+          for (int64_t k = 0; k < full_vecs; ++k) {
+            acc[k] =
+                ops_.reduce(acc[k], load_vec<value_t>(row + k * Vec::size()));
+          }
+          if (tail > 0) {
+            acc[full_vecs] = ops_.reduce(
+                acc[full_vecs],
+                load_vec<value_t>(row + full_vecs * Vec::size(), tail));
+          }
+        }
+      }
+      index += n;
+      r.advance(n);
+    }
+    __at_align__ acc_t lanes[kUnitOutputs];
+    for (int64_t k = 0; k < kOuterVecs; ++k) {
+      acc[k].store(lanes + k * Vec::size());
+    }
+    std::copy(lanes, lanes + count, partials);
+  }
+
+  const ops_t& ops_;
+  const ReduceGeometry geom_;
+  const char* in_;
+  char* out_;
+  Mode mode_ = Mode::Scalar;
+  int64_t num_chunks_ = 1;
+  // the space of tasks, laid out like the kept dims
+  std::vector<int64_t> task_sizes_;
+  std::vector<int64_t> task_in_strides_;
+  std::vector<int64_t> task_out_strides_;
+  int64_t num_tasks_ = 1;
+};
+
+} // namespace reduce_detail
+
+// Reduces the input of `iter` (built with TensorIterator::reduce_op) into
+// its output, scalar_t being the input's C++ type.
+template <typename scalar_t, typename ops_t>
+void binary_kernel_reduce(TensorIterator& iter, const ops_t& ops) {
+  reduce_detail::ReduceRunner<scalar_t, ops_t>(iter, ops).run();
+}
+
+} // namespace CPU_CAPABILITY
+} // namespace at::native
@@ -0,0 +1,342 @@
+#include <ATen/Dispatch.h>
+#include <ATen/OpMathType.h>
+#include <ATen/TensorIterator.h>
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/native/ReduceOps.h>
+#include <ATen/native/cpu/Reduce.h>
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace at::native {
+namespace {
+
+// Half and BFloat16 are reduced in float
+template <typename scalar_t>
+using reduce_value_t = opmath_type<scalar_t>;
+
+template <typename T>
+bool is_nan(T x) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return std::isnan(x);
+  } else {
+    return false;
+  }
+}
+
+template <typename acc_t_, typename out_t_>
+struct SumOps {
+  using value_t = acc_t_;
+  using acc_t = acc_t_;
+  using out_t = out_t_;
+  using Vec = vec::Vectorized<acc_t>;
+  static constexpr bool vectorized = true;
+
+  acc_t identity() const {
+    return acc_t(0);
+  }
+  acc_t reduce(acc_t acc, value_t x, int64_t /*index*/) const {
+    return acc + x;
+  }
+  Vec reduce(const Vec& acc, const Vec& x) const {
+    return acc + x;
+  }
+  acc_t combine(acc_t a, acc_t b) const {
+    return a + b;
+  }
+  Vec combine(const Vec& a, const Vec& b) const {
+    return a + b;
+  }
+  out_t project(acc_t acc) const {
+    return static_cast<out_t>(acc);
+  }
+};
+
+template <typename acc_t, typename out_t>
+struct MeanOps : SumOps<acc_t, out_t> {
+  explicit MeanOps(int64_t num) : num(static_cast<acc_t>(num)) {}
+
+  out_t project(acc_t acc) const {
+    return static_cast<out_t>(acc / num);
+  }
+
+  acc_t num;
+};
+
+// NaN propagating, like vec::maximum
+template <typename value_t_, typename out_t_>
+struct MaxOps {
+  using value_t = value_t_;
+  using acc_t = value_t_;
+  using out_t = out_t_;
+  using Vec = vec::Vectorized<acc_t>;
+  static constexpr bool vectorized = true;
+
+  acc_t identity() const {
+    if constexpr (std::numeric_limits<acc_t>::has_infinity) {
+      return -std::numeric_limits<acc_t>::infinity();
+    } else {
+      return std::numeric_limits<acc_t>::lowest();
+    }
+  }
+  acc_t reduce(acc_t acc, value_t x, int64_t /*index*/) const {
+    return combine(acc, x);
+  }
+  Vec reduce(const Vec& acc, const Vec& x) const {
+    return vec::maximum(acc, x);
+  }
+  acc_t combine(acc_t a, acc_t b) const {
+    return (is_nan(a) or a > b) ? a : b;
+  }
+  Vec combine(const Vec& a, const Vec& b) const {
+    return vec::maximum(a, b);
+  }
+  out_t project(acc_t acc) const {
+    return static_cast<out_t>(acc);
+  }
+};
+
+// NaN propagating, like vec::minimum
+template <typename value_t_, typename out_t_>
+struct MinOps {
+  using value_t = value_t_;
+  using acc_t = value_t_;
+  using out_t = out_t_;
+  using Vec = vec::Vectorized<acc_t>;
+  static constexpr bool vectorized = true;
+
+  acc_t identity() const {
+    if constexpr (std::numeric_limits<acc_t>::has_infinity) {
+      return std::numeric_limits<acc_t>::infinity();
+    } else {
+      return std::numeric_limits<acc_t>::max();
+    }
+  }
+  acc_t reduce(acc_t acc, value_t x, int64_t /*index*/) const {
+    return combine(acc, x);
+  }
+  Vec reduce(const Vec& acc, const Vec& x) const {
+    return vec::minimum(acc, x);
+  }
+  acc_t combine(acc_t a, acc_t b) const {
+    return (is_nan(a) or a < b) ? a : b;
+  }
+  Vec combine(const Vec& a, const Vec& b) const {
+    return vec::minimum(a, b);
+  }
+  out_t project(acc_t acc) const {
+    return static_cast<out_t>(acc);
+  }
+};
+
+// The index of the first maximum (is_max) or minimum; NaN counts as both.
+// An index of -1 marks the identity.
+template <typename value_t_, bool is_max>
+struct ArgOps {
+  using value_t = value_t_;
+  using acc_t = std::pair<value_t, int64_t>;
+  using out_t = int64_t;
+  static constexpr bool vectorized = false;
+
+  acc_t identity() const {
+    return {value_t(), -1};
+  }
+  acc_t reduce(acc_t acc, value_t x, int64_t index) const {
+    return combine(acc, {x, index});
+  }
+  acc_t combine(acc_t a, acc_t b) const {
+    if (a.second < 0 or b.second < 0) {
+      return a.second < 0 ? b : a;
+    }
+    if (is_nan(a.first)) {
+      return a;
+    }
+    if (is_nan(b.first)) {
+      return b;
+    }
+    const bool b_wins = is_max ? b.first > a.first : b.first < a.first;
+    return b_wins ? b : a;
+  }
+  out_t project(acc_t acc) const {
+    return acc.second;
+  }
+};
+
+// Norms: sum of |x|^p then the p-th root, with the usual special cases for
+// p = 0 (number of non-zeros), 1, 2 and +-inf (largest / smallest |x|).
+template <typename acc_t_, typename out_t_>
+struct NormOps {
+  using value_t = acc_t_;
+  using acc_t = acc_t_;
+  using out_t = out_t_;
+  static constexpr bool vectorized = false;
+
+  acc_t identity() const {
+    return acc_t(0);
+  }
+  acc_t reduce(acc_t acc, value_t x, int64_t /*index*/) const {
+    return acc + std::pow(std::abs(x), p);
+  }
+  acc_t combine(acc_t a, acc_t b) const {
+    return a + b;
+  }
+  out_t project(acc_t acc) const {
+    return static_cast<out_t>(std::pow(acc, acc_t(1) / p));
+  }
+
+  acc_t p;
+};
+
+template <typename acc_t, typename out_t>
+struct NormZeroOps : SumOps<acc_t, out_t> {
+  using Vec = vec::Vectorized<acc_t>;
+
+  acc_t reduce(acc_t acc, acc_t x, int64_t /*index*/) const {
+    return acc + (x != acc_t(0) ? acc_t(1) : acc_t(0));
+  }
+  Vec reduce(const Vec& acc, const Vec& x) const {
+    return acc + x.ne(Vec(acc_t(0)));
+  }
+};
+
+template <typename acc_t, typename out_t>
+struct NormOneOps : SumOps<acc_t, out_t> {
+  using Vec = vec::Vectorized<acc_t>;
+
+  acc_t reduce(acc_t acc, acc_t x, int64_t /*index*/) const {
+    return acc + std::abs(x);
+  }
+  Vec reduce(const Vec& acc, const Vec& x) const {
+    return acc + x.abs();
+  }
+};
+
+template <typename acc_t, typename out_t>
+struct NormTwoOps : SumOps<acc_t, out_t> {
+  using Vec = vec::Vectorized<acc_t>;
+
+  acc_t reduce(acc_t acc, acc_t x, int64_t /*index*/) const {
+    return acc + x * x;
+  }
+  Vec reduce(const Vec& acc, const Vec& x) const {
+    return acc + x * x;
+  }
+  out_t project(acc_t acc) const {
+    return static_cast<out_t>(std::sqrt(acc));
+  }
+};
+
+template <typename acc_t, typename out_t>
+struct AbsMaxOps : MaxOps<acc_t, out_t> {
+  using Vec = vec::Vectorized<acc_t>;
+
+  acc_t identity() const {
+    return acc_t(0);
+  }
+  acc_t reduce(acc_t acc, acc_t x, int64_t /*index*/) const {
+    return this->combine(acc, std::abs(x));
+  }
+  Vec reduce(const Vec& acc, const Vec& x) const {
+    return vec::maximum(acc, x.abs());
+  }
+};
+
+template <typename acc_t, typename out_t>
+struct AbsMinOps : MinOps<acc_t, out_t> {
+  using Vec = vec::Vectorized<acc_t>;
+
+  acc_t reduce(acc_t acc, acc_t x, int64_t /*index*/) const {
+    return this->combine(acc, std::abs(x));
+  }
+  Vec reduce(const Vec& acc, const Vec& x) const {
+    return vec::minimum(acc, x.abs());
+  }
+};
+
+void sum_kernel(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.input_dtype(), "sum_cpu", [&] {
+    if constexpr (std::is_integral_v<scalar_t>) {
+      if (iter.dtype() == ScalarType::UInt64) {
+        binary_kernel_reduce<scalar_t>(iter, SumOps<uint64_t, uint64_t>());
+      } else {
+        binary_kernel_reduce<scalar_t>(iter, SumOps<int64_t, int64_t>());
+      }
+    } else {
+      binary_kernel_reduce<scalar_t>(
+          iter, SumOps<reduce_value_t<scalar_t>, scalar_t>());
+    }
+  });
+}
+
+void mean_kernel(TensorIterator& iter) {
+  AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+      iter.input_dtype(), "mean_cpu", [&] {
+        binary_kernel_reduce<scalar_t>(
+            iter,
+            MeanOps<reduce_value_t<scalar_t>, scalar_t>(
+                iter.num_reduce_elements()));
+      });
+}
+
+void max_values_kernel(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.input_dtype(), "max_values_cpu", [&] {
+    binary_kernel_reduce<scalar_t>(
+        iter, MaxOps<reduce_value_t<scalar_t>, scalar_t>());
+  });
+}
+
+void min_values_kernel(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.input_dtype(), "min_values_cpu", [&] {
+    binary_kernel_reduce<scalar_t>(
+        iter, MinOps<reduce_value_t<scalar_t>, scalar_t>());
+  });
+}
+
+void argmax_kernel(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.input_dtype(), "argmax_cpu", [&] {
+    binary_kernel_reduce<scalar_t>(
+        iter, ArgOps<reduce_value_t<scalar_t>, /*is_max=*/true>());
+  });
+}
+
+void argmin_kernel(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.input_dtype(), "argmin_cpu", [&] {
+    binary_kernel_reduce<scalar_t>(
+        iter, ArgOps<reduce_value_t<scalar_t>, /*is_max=*/false>());
+  });
+}
+
+void norm_kernel(TensorIterator& iter, double p) {
+  AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+      iter.input_dtype(), "norm_cpu", [&] {
+        using acc_t = reduce_value_t<scalar_t>;
+        if (p == 0) {
+          binary_kernel_reduce<scalar_t>(iter, NormZeroOps<acc_t, scalar_t>());
+        } else if (p == 1) {
+          binary_kernel_reduce<scalar_t>(iter, NormOneOps<acc_t, scalar_t>());
+        } else if (p == 2) {
+          binary_kernel_reduce<scalar_t>(iter, NormTwoOps<acc_t, scalar_t>());
+        } else if (p == std::numeric_limits<double>::infinity()) {
+          binary_kernel_reduce<scalar_t>(iter, AbsMaxOps<acc_t, scalar_t>());
+        } else if (p == -std::numeric_limits<double>::infinity()) {
+          binary_kernel_reduce<scalar_t>(iter, AbsMinOps<acc_t, scalar_t>());
+        } else {
+          binary_kernel_reduce<scalar_t>(
+              iter, NormOps<acc_t, scalar_t>{static_cast<acc_t>(p)});
+        }
+      });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(sum_stub, &sum_kernel)
+REGISTER_DISPATCH(mean_stub, &mean_kernel)
+REGISTER_DISPATCH(max_values_stub, &max_values_kernel)
+REGISTER_DISPATCH(min_values_stub, &min_values_kernel)
+REGISTER_DISPATCH(argmax_stub, &argmax_kernel)
+REGISTER_DISPATCH(argmin_stub, &argmin_kernel)
+REGISTER_DISPATCH(norm_stub, &norm_kernel)
+
+} // namespace at::native
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <ATen/OpMathType.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/cpu/vec/vec.h>
+
+#include <type_traits>
+#include <vector>
+
+// Row access for the row-wise kernels in native/cpu (softmax, layer norm):
+// a tensor seen as rows of the elements along some of its dims, one row per
+// index of the others. A kernel computes on a row as a contiguous array of
+// acc_t: rows of unit-stride elements are used in place, other rows, and
+// Half and BFloat16 rows (computed on in float), are copied through a
+// buffer.
+
+namespace at::native {
+inline namespace CPU_CAPABILITY {
+
+template <typename scalar_t>
+using row_acc_t = opmath_type<scalar_t>;
+
+class RowLayout {
+ public:
+  // the rows of t along row_dims, which are in increasing order; elements
+  // and rows are numbered row-major
+  RowLayout(const Tensor& t, IntArrayRef row_dims) {
+    size_t next = 0;
+    for (int64_t d = 0; d < t.dim(); ++d) {
+      if (next < row_dims.size() and row_dims[next] == d) {
+        ++next;
+        size_ *= t.size(d);
+        row_sizes_.push_back(t.size(d));
+        row_strides_.push_back(t.stride(d));
+      } else {
+        rows_ *= t.size(d);
+        outer_sizes_.push_back(t.size(d));
+        outer_strides_.push_back(t.stride(d));
+      }
+    }
+    int64_t expected = 1;
+    for (int64_t i = static_cast<int64_t>(row_sizes_.size()) - 1; i >= 0;
+         --i) {
+      if (row_sizes_[i] != 1 and row_strides_[i] != expected) {
+        contiguous_ = false;
+      }
+      expected *= row_sizes_[i];
+    }
+    if (!contiguous_) {
+      offsets_.assign(size_, 0);
+      int64_t repeat = size_;
+      for (size_t i = 0; i < row_sizes_.size(); ++i) {
+        repeat /= row_sizes_[i];
+        for (int64_t e = 0; e < size_; ++e) {
+          offsets_[e] += (e / repeat % row_sizes_[i]) * row_strides_[i];
+        }
+      }
+    }
+  }
+
+  int64_t rows() const {
+    return rows_;
+  }
+
+  // elements per row
+  int64_t size() const {
+    return size_;
+  }
+
+  // whether the elements of a row are unit-stride
+  bool contiguous() const {
+    return contiguous_;
+  }
+
+  // the offset of the first element of a row
+  int64_t offset(int64_t row) const {
+    int64_t offset = 0;
+    for (int64_t i = static_cast<int64_t>(outer_sizes_.size()) - 1; i >= 0;
+         --i) {
+      offset += (row % outer_sizes_[i]) * outer_strides_[i];
+      row /= outer_sizes_[i];
+    }
+    return offset;
+  }
+
+  // the offsets of the elements of a row from its first, if not contiguous
+  const std::vector<int64_t>& offsets() const {
+    return offsets_;
+  }
+
+ private:
+  int64_t rows_ = 1;
+  int64_t size_ = 1;
+  bool contiguous_ = true;
+  std::vector<int64_t> row_sizes_, row_strides_;
+  std::vector<int64_t> outer_sizes_, outer_strides_;
+  std::vector<int64_t> offsets_;
+};
+
+// whether a kernel on rows of layout reads and writes them in place
+template <typename acc_t, typename scalar_t>
+bool in_place_rows(const RowLayout& layout) {
+  return std::is_same_v<acc_t, scalar_t> and layout.contiguous();
+}
+
+// the elements of a row as acc_t: the row itself if in_place_rows(), else
+// a copy in buffer, which holds layout.size() elements
+template <typename acc_t, typename scalar_t>
+const acc_t* load_row(
+    const RowLayout& layout,
+    const scalar_t* data,
+    int64_t row,
+    acc_t* buffer) {
+  const scalar_t* src = data + layout.offset(row);
+  if constexpr (std::is_same_v<acc_t, scalar_t>) {
+    if (layout.contiguous()) {
+      return src;
+    }
+  }
+  if (layout.contiguous()) {
+    vec::convert(src, buffer, layout.size());
+    return buffer;
+  }
+  const std::vector<int64_t>& offsets = layout.offsets();
+  for (int64_t i = 0; i < layout.size(); ++i) {
+    buffer[i] = static_cast<acc_t>(src[offsets[i]]);
+  }
+  return buffer;
+}
+
+// where a kernel writes a row: the row itself if in_place_rows(), else
+// buffer, to be written back with store_row()
+template <typename acc_t, typename scalar_t>
+acc_t* row_destination(
+    const RowLayout& layout,
+    scalar_t* data,
+    int64_t row,
+    acc_t* buffer) {
+  if constexpr (std::is_same_v<acc_t, scalar_t>) {
+    if (layout.contiguous()) {
+      return data + layout.offset(row);
+    }
+  }
+  return buffer;
+}
+
+// writes back a row computed into the row_destination() buffer
+template <typename acc_t, typename scalar_t>
+void store_row(
+    const RowLayout& layout,
+    scalar_t* data,
+    int64_t row,
+    const acc_t* values) {
+  if (in_place_rows<acc_t, scalar_t>(layout)) {
+    return;
+  }
+  scalar_t* dst = data + layout.offset(row);
+  if (layout.contiguous()) {
+    vec::convert(values, dst, layout.size());
+    return;
+  }
+  const std::vector<int64_t>& offsets = layout.offsets();
+  for (int64_t i = 0; i < layout.size(); ++i) {
+    dst[offsets[i]] = static_cast<scalar_t>(values[i]);
+  }
+}
+
+} // namespace CPU_CAPABILITY
+} // namespace at::native
@@ -0,0 +1,93 @@
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/native/SoftMax.h>
+#include <ATen/native/cpu/Rowwise.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace at::native {
+namespace {
+
+// The running maximum is updated once per chunk of this many elements,
+// which stays in L1 between finding its maximum and summing its
+// exponentials.
+constexpr int64_t kChunk = 1024;
+
+// y = softmax(x) over a row of n elements in two reads of x: the first
+// finds the maximum and the sum of exponentials together ("online
+// softmax", Milakov and Gimelshein), rescaling the partial sum whenever the
+// maximum grows, the second writes the normalized exponentials. y may be x.
+template <typename acc_t>
+void softmax_row(acc_t* y, const acc_t* x, int64_t n) {
+  using Vec = vec::Vectorized<acc_t>;
+  acc_t max = std::numeric_limits<acc_t>::lowest();
+  Vec sum(0);
+  for (int64_t c0 = 0; c0 < n; c0 += kChunk) {
+    const int64_t len = std::min(kChunk, n - c0);
+    const acc_t* chunk = x + c0;
+    const acc_t chunk_max = vec::reduce_all<acc_t>(
+        [](const Vec& a, const Vec& b) { return vec::maximum(a, b); },
+        chunk,
+        len);
+    // a NaN makes the maximum, and so the whole row, NaN
+    if (chunk_max > max or std::isnan(chunk_max)) {
+      sum = sum * Vec(std::exp(max - chunk_max));
+      max = chunk_max;
+    }
+    const Vec max_vec(max);
+    int64_t i = 0;
+    for (; i + Vec::size() <= len; i += Vec::size()) {
+      sum = sum + (Vec::loadu(chunk + i) - max_vec).exp();
+    }
+    if (i < len) {
+      sum = Vec::set(
+          sum, sum + (Vec::loadu(chunk + i, len - i) - max_vec).exp(), len - i);
+    }
+  }
+  const acc_t total = vec::vec_reduce_all<acc_t>(
+      [](const Vec& a, const Vec& b) { return a + b; }, sum);
+  const Vec max_vec(max);
+  const Vec scale(acc_t(1) / total);
+  vec::map(
+      [&](const Vec& v) { return (v - max_vec).exp() * scale; }, y, x, n);
+}
+
+void softmax_kernel(const Tensor& output, const Tensor& input, int64_t dim) {
+  AT_DISPATCH_FLOATING_AND_REDUCED_FLOATING_TYPES(
+      input.scalar_type(), "softmax", [&] {
+        using acc_t = row_acc_t<scalar_t>;
+        const RowLayout in_rows(input, {dim});
+        const RowLayout out_rows(output, {dim});
+        const int64_t n = in_rows.size();
+        const scalar_t* in = input.const_data_ptr<scalar_t>();
+        scalar_t* out = output.mutable_data_ptr<scalar_t>();
+        parallel_for(
+            0,
+            in_rows.rows(),
+            1 + internal::GRAIN_SIZE / n,
+            [&](int64_t begin, int64_t end) {
+              std::vector<acc_t> buffer(
+                  in_place_rows<acc_t, scalar_t>(in_rows) ? 0 : n);
+              std::vector<acc_t> out_buffer(
+                  in_place_rows<acc_t, scalar_t>(out_rows) ? 0 : n);
+              for (int64_t row = begin; row < end; ++row) {
+                const acc_t* x = load_row(in_rows, in, row, buffer.data());
+                acc_t* y =
+                    row_destination(out_rows, out, row, out_buffer.data());
+                softmax_row(y, x, n);
+                store_row(out_rows, out, row, y);
+              }
+            });
+      });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(softmax_stub, &softmax_kernel)
+
+} // namespace at::native
@@ -0,0 +1,95 @@
+#include <ATen/Dispatch.h>
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/native/SparseBlas.h>
+
+#include <algorithm>
+
+// A row of the product is accumulated a tile of columns at a time, in
+// registers: the tile of every dense row the sparse row selects is loaded
+// and added in, times the value, and the tile is stored once. Each element
+// of the result is a sum in the order of the elements of its sparse row,
+// whatever the partition of the rows, so results do not depend on the
+// number of threads.
+
+namespace at::native {
+namespace {
+
+template <typename scalar_t>
+void spmm_csr_rows(
+    scalar_t* out,
+    const int64_t* crow,
+    const int64_t* col,
+    const scalar_t* values,
+    const scalar_t* dense,
+    int64_t n,
+    int64_t row_begin,
+    int64_t row_end) {
+  using Vec = vec::Vectorized<scalar_t>;
+  // vectors of accumulators per tile
+  constexpr int64_t kTile = 4;
+  for (int64_t i = row_begin; i < row_end; ++i) {
+    const int64_t begin = crow[i];
+    const int64_t end = crow[i + 1];
+    scalar_t* out_row = out + i * n;
+    int64_t j = 0;
+    for (; j + kTile * Vec::size() <= n; j += kTile * Vec::size()) {
+      Vec acc[kTile];
+      std::fill_n(acc, kTile, Vec(scalar_t(0)));
+      for (int64_t e = begin; e < end; ++e) {
+        const Vec value(values[e]);
+        const scalar_t* row = dense + col[e] * n + j;
+        for (int64_t t = 0; t < kTile; ++t) {
+          acc[t] =
+              vec::fmadd(value, Vec::loadu(row + t * Vec::size()), acc[t]);
+        }
+      }
+      for (int64_t t = 0; t < kTile; ++t) {
+        acc[t].store(out_row + j + t * Vec::size());
+      }
+    }
+    for (; j + Vec::size() <= n; j += Vec::size()) {
+      Vec acc(scalar_t(0));
+      for (int64_t e = begin; e < end; ++e) {
+        acc = vec::fmadd(
+            Vec(values[e]), Vec::loadu(dense + col[e] * n + j), acc);
+      }
+      acc.store(out_row + j);
+    }
+    // columns short of a vector, e.g. the only one of a matrix-vector
+    // product
+    for (; j < n; ++j) {
+      scalar_t acc = 0;
+      for (int64_t e = begin; e < end; ++e) {
+        acc += values[e] * dense[col[e] * n + j];
+      }
+      out_row[j] = acc;
+    }
+  }
+}
+
+void spmm_csr_kernel(
+    const Tensor& result,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense,
+    int64_t row_begin,
+    int64_t row_end) {
+  AT_DISPATCH_FLOATING_TYPES(result.scalar_type(), "spmm_csr", [&] {
+    spmm_csr_rows(
+        result.mutable_data_ptr<scalar_t>(),
+        crow_indices.const_data_ptr<int64_t>(),
+        col_indices.const_data_ptr<int64_t>(),
+        values.const_data_ptr<scalar_t>(),
+        dense.const_data_ptr<scalar_t>(),
+        result.size(1),
+        row_begin,
+        row_end);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(spmm_csr_stub, &spmm_csr_kernel)
+
+} // namespace at::native
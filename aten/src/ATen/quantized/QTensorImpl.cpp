@@ -0,0 +1,28 @@
+#include <ATen/quantized/QTensorImpl.h>
+
+namespace at {
+
+QTensorImpl::QTensorImpl(
+    Storage&& storage,
+    const TypeMeta data_type,
+    QuantizerPtr quantizer)
+    : TensorImpl(std::move(storage), data_type),
+      quantizer_(std::move(quantizer)) {}
+
+QTensorImpl::QTensorImpl(
+    ImplType type,
+    Storage&& storage,
+    const TypeMeta data_type,
+    QuantizerPtr quantizer)
+    : TensorImpl(type, std::move(storage), data_type),
+      quantizer_(std::move(quantizer)) {}
+
+QTensorImpl* get_qtensorimpl(const TensorBase& self) {
+  TORCH_CHECK(
+      self.is_quantized(),
+      "expected a quantized tensor, got one of dtype ",
+      self.scalar_type());
+  return static_cast<QTensorImpl*>(self.unsafeGetTensorImpl());
+}
+
+} // namespace at
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <ATen/quantized/Quantizer.h>
+#include <c10/core/TensorImpl.h>
+
+namespace at {
+
+// The TensorImpl of every tensor of a quantized dtype: a plain TensorImpl
+// of the integers plus the Quantizer that gives them their real values.
+struct TORCH_API QTensorImpl : public c10::TensorImpl {
+  QTensorImpl(
+      Storage&& storage,
+      const TypeMeta data_type,
+      QuantizerPtr quantizer);
+
+  // a view, see TensorImpl
+  QTensorImpl(
+      ImplType,
+      Storage&& storage,
+      const TypeMeta data_type,
+      QuantizerPtr quantizer);
+
+  const QuantizerPtr& quantizer() const {
+    return quantizer_;
+  }
+
+ private:
+  QuantizerPtr quantizer_;
+};
+
+// the QTensorImpl of a quantized tensor
+TORCH_API QTensorImpl* get_qtensorimpl(const TensorBase& self);
+
+} // namespace at
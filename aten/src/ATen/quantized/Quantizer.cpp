@@ -0,0 +1,237 @@
+#include <ATen/Dispatch.h>
+#include <ATen/EmptyTensor.h>
+#include <ATen/Functions.h>
+#include <ATen/native/AffineQuantizer.h>
+#include <ATen/quantized/QTensorImpl.h>
+#include <ATen/quantized/Quantizer.h>
+#include <c10/cpu/CPUAllocator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace at {
+
+namespace {
+
+void check_scalar_type(ScalarType scalar_type) {
+  TORCH_CHECK(
+      isQIntType(scalar_type),
+      "expected a quantized dtype (QInt8, QUInt8 or QInt32), got ",
+      scalar_type);
+}
+
+void check_scale(double scale) {
+  TORCH_CHECK(
+      scale > 0 and std::isfinite(scale),
+      "expected a positive finite quantization scale, got ",
+      scale);
+}
+
+void check_zero_point(int64_t zero_point, ScalarType scalar_type) {
+  AT_DISPATCH_QINT_TYPES(scalar_type, "check_zero_point", [&] {
+    constexpr int64_t qmin = std::numeric_limits<underlying_t>::min();
+    constexpr int64_t qmax = std::numeric_limits<underlying_t>::max();
+    TORCH_CHECK(
+        zero_point >= qmin and zero_point <= qmax,
+        "zero point ",
+        zero_point,
+        " is out of the range [",
+        qmin,
+        ", ",
+        qmax,
+        "] of ",
+        scalar_type);
+  });
+}
+
+// rtensor as a contiguous Float tensor
+Tensor contiguous_float(const Tensor& rtensor) {
+  TORCH_CHECK(
+      rtensor.scalar_type() == ScalarType::Float,
+      "quantize: expected a Float tensor, got ",
+      rtensor.scalar_type());
+  if (rtensor.is_contiguous()) {
+    return rtensor;
+  }
+  return at::empty(rtensor.sizes()).copy_(rtensor);
+}
+
+// the integers of qtensor, contiguous
+Tensor contiguous_int_repr(const Tensor& qtensor) {
+  const Tensor ints = at::int_repr(qtensor);
+  if (ints.is_contiguous()) {
+    return ints;
+  }
+  return at::empty(ints.sizes(), ints.scalar_type()).copy_(ints);
+}
+
+// a new quantized tensor holding the contiguous integers ints
+Tensor wrap_ints(const Tensor& ints, QuantizerPtr quantizer) {
+  Tensor qtensor = new_qtensor(ints.sizes(), std::move(quantizer));
+  if (ints.numel() > 0) {
+    std::memcpy(
+        qtensor.mutable_data_ptr(), ints.const_data_ptr(), ints.nbytes());
+  }
+  return qtensor;
+}
+
+} // namespace
+
+Quantizer::~Quantizer() = default;
+
+Tensor PerTensorAffineQuantizer::quantize(const Tensor& rtensor) {
+  const Tensor src = contiguous_float(rtensor);
+  Tensor qtensor = new_qtensor(src.sizes(), intrusive_from_this());
+  native::quantize_tensor_per_tensor_affine(
+      src, qtensor, scale_, zero_point_);
+  return qtensor;
+}
+
+Tensor PerTensorAffineQuantizer::dequantize(const Tensor& qtensor) {
+  Tensor src = qtensor;
+  if (!qtensor.is_contiguous()) {
+    src = wrap_ints(contiguous_int_repr(qtensor), intrusive_from_this());
+  }
+  Tensor rtensor = at::empty(qtensor.sizes());
+  native::dequantize_tensor_per_tensor_affine(
+      src, rtensor, scale_, zero_point_);
+  return rtensor;
+}
+
+bool PerTensorAffineQuantizer::equalTo(const QuantizerPtr& other) const {
+  if (!other or other->qscheme() != kPerTensorAffine or
+      other->scalar_type() != scalar_type()) {
+    return false;
+  }
+  const auto* that = static_cast<const PerTensorAffineQuantizer*>(other.get());
+  return scale_ == that->scale_ and zero_point_ == that->zero_point_;
+}
+
+Tensor PerChannelAffineQuantizer::quantize(const Tensor& rtensor) {
+  const Tensor src = contiguous_float(rtensor);
+  Tensor qtensor = new_qtensor(src.sizes(), intrusive_from_this());
+  native::quantize_tensor_per_channel_affine(
+      src, qtensor, scales_, zero_points_, axis_);
+  return qtensor;
+}
+
+Tensor PerChannelAffineQuantizer::dequantize(const Tensor& qtensor) {
+  Tensor src = qtensor;
+  if (!qtensor.is_contiguous()) {
+    src = wrap_ints(contiguous_int_repr(qtensor), intrusive_from_this());
+  }
+  Tensor rtensor = at::empty(qtensor.sizes());
+  native::dequantize_tensor_per_channel_affine(
+      src, rtensor, scales_, zero_points_, axis_);
+  return rtensor;
+}
+
+bool PerChannelAffineQuantizer::equalTo(const QuantizerPtr& other) const {
+  if (!other or other->qscheme() != kPerChannelAffine or
+      other->scalar_type() != scalar_type()) {
+    return false;
+  }
+  const auto* that =
+      static_cast<const PerChannelAffineQuantizer*>(other.get());
+  const int64_t n = scales_.numel();
+  if (axis_ != that->axis_ or n != that->scales_.numel()) {
+    return false;
+  }
+  return std::equal(
+             scales_.const_data_ptr<double>(),
+             scales_.const_data_ptr<double>() + n,
+             that->scales_.const_data_ptr<double>()) and
+      std::equal(
+             zero_points_.const_data_ptr<int64_t>(),
+             zero_points_.const_data_ptr<int64_t>() + n,
+             that->zero_points_.const_data_ptr<int64_t>());
+}
+
+QuantizerPtr make_per_tensor_affine_quantizer(
+    double scale,
+    int64_t zero_point,
+    ScalarType scalar_type) {
+  check_scalar_type(scalar_type);
+  check_scale(scale);
+  check_zero_point(zero_point, scalar_type);
+  return c10::make_intrusive<PerTensorAffineQuantizer>(
+      scalar_type, scale, zero_point);
+}
+
+QuantizerPtr make_per_channel_affine_quantizer(
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis,
+    ScalarType scalar_type) {
+  check_scalar_type(scalar_type);
+  TORCH_CHECK(
+      scales.dim() == 1 and zero_points.dim() == 1,
+      "expected 1-dim scales and zero points, got ",
+      scales.dim(),
+      " and ",
+      zero_points.dim(),
+      " dims");
+  TORCH_CHECK(
+      scales.numel() == zero_points.numel(),
+      "expected as many scales as zero points, got ",
+      scales.numel(),
+      " and ",
+      zero_points.numel());
+  TORCH_CHECK(axis >= 0, "expected a non-negative axis, got ", axis);
+  // copies, which the quantizer owns and never changes
+  Tensor scales_copy = at::empty(scales.sizes(), ScalarType::Double);
+  scales_copy.copy_(scales);
+  Tensor zero_points_copy = at::empty(zero_points.sizes(), ScalarType::Long);
+  zero_points_copy.copy_(zero_points);
+  const double* scale_data = scales_copy.const_data_ptr<double>();
+  const int64_t* zero_point_data = zero_points_copy.const_data_ptr<int64_t>();
+  for (int64_t c = 0; c < scales_copy.numel(); ++c) {
+    check_scale(scale_data[c]);
+    check_zero_point(zero_point_data[c], scalar_type);
+  }
+  return c10::make_intrusive<PerChannelAffineQuantizer>(
+      scalar_type, std::move(scales_copy), std::move(zero_points_copy), axis);
+}
+
+Tensor new_qtensor(IntArrayRef sizes, QuantizerPtr quantizer) {
+  for (const int64_t size : sizes) {
+    TORCH_CHECK(
+        size >= 0,
+        "Trying to create tensor with negative dimension ",
+        size,
+        ": ",
+        sizes);
+  }
+  if (quantizer->qscheme() == kPerChannelAffine) {
+    const auto* channels =
+        static_cast<const PerChannelAffineQuantizer*>(quantizer.get());
+    const int64_t axis = channels->axis();
+    TORCH_CHECK(
+        axis < static_cast<int64_t>(sizes.size()),
+        "channel axis ",
+        axis,
+        " is out of range for a tensor of ",
+        sizes.size(),
+        " dims");
+    TORCH_CHECK(
+        channels->scales().numel() == sizes[axis],
+        "expected one scale and zero point per channel, got ",
+        channels->scales().numel(),
+        " for ",
+        sizes[axis],
+        " channels");
+  }
+  const ScalarType scalar_type = quantizer->scalar_type();
+  const size_t nbytes = detail::computeStorageNbytesContiguous(
+      sizes, c10::elementSize(scalar_type));
+  Storage storage(
+      Storage::use_byte_size_t{}, nbytes, c10::GetCPUAllocator(), false);
+  auto impl = c10::make_intrusive<QTensorImpl>(
+      std::move(storage), TypeMeta(scalar_type), std::move(quantizer));
+  impl->set_sizes_contiguous(sizes);
+  return Tensor(std::move(impl));
+}
+
+} // namespace at
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <c10/core/QScheme.h>
+#include <c10/util/IntrusivePtr.h>
+
+#include <cstdint>
+
+// Quantized tensors store integers q of a quantized dtype (QInt8, QUInt8,
+// QInt32) that stand for the real values (q - zero_point) * scale. The
+// scale and zero point live in the Quantizer of the tensor's QTensorImpl
+// (see QTensorImpl.h), which views share; quantizers are immutable.
+//
+// Per tensor, one scale and zero point cover every element. Per channel,
+// the slices along `axis` (the output channels of a weight) each have their
+// own, held by a Double tensor of scales and a Long tensor of zero points.
+
+namespace at {
+
+struct Quantizer;
+using QuantizerPtr = c10::intrusive_ptr<Quantizer>;
+
+struct TORCH_API Quantizer : public c10::intrusive_ptr_target {
+  explicit Quantizer(ScalarType scalar_type) : scalar_type_(scalar_type) {}
+  ~Quantizer() override;
+
+  virtual QScheme qscheme() const = 0;
+
+  // the quantized dtype of the tensors this quantizer applies to
+  ScalarType scalar_type() const {
+    return scalar_type_;
+  }
+
+  // a new contiguous quantized tensor of the values of the Float rtensor
+  virtual Tensor quantize(const Tensor& rtensor) = 0;
+
+  // a new contiguous Float tensor of the real values of qtensor
+  virtual Tensor dequantize(const Tensor& qtensor) = 0;
+
+  // whether both map integers to the same real values
+  virtual bool equalTo(const QuantizerPtr& other) const = 0;
+
+ protected:
+  QuantizerPtr intrusive_from_this() {
+    return QuantizerPtr::reclaim_copy(this);
+  }
+
+ private:
+  const ScalarType scalar_type_;
+};
+
+struct TORCH_API PerTensorAffineQuantizer : public Quantizer {
+  PerTensorAffineQuantizer(
+      ScalarType scalar_type,
+      double scale,
+      int64_t zero_point)
+      : Quantizer(scalar_type), scale_(scale), zero_point_(zero_point) {}
+
+  QScheme qscheme() const override {
+    return kPerTensorAffine;
+  }
+
+  double scale() const {
+    return scale_;
+  }
+
+  int64_t zero_point() const {
+    return zero_point_;
+  }
+
+  Tensor quantize(const Tensor& rtensor) override;
+  Tensor dequantize(const Tensor& qtensor) override;
+  bool equalTo(const QuantizerPtr& other) const override;
+
+ private:
+  const double scale_;
+  const int64_t zero_point_;
+};
+
+struct TORCH_API PerChannelAffineQuantizer : public Quantizer {
+  // scales (Double) and zero_points (Long) are 1-dim and contiguous, with
+  // one value per index along axis
+  PerChannelAffineQuantizer(
+      ScalarType scalar_type,
+      Tensor scales,
+      Tensor zero_points,
+      int64_t axis)
+      : Quantizer(scalar_type),
+        scales_(std::move(scales)),
+        zero_points_(std::move(zero_points)),
+        axis_(axis) {}
+
+  QScheme qscheme() const override {
+    return kPerChannelAffine;
+  }
+
+  const Tensor& scales() const {
+    return scales_;
+  }
+
+  const Tensor& zero_points() const {
+    return zero_points_;
+  }
+
+  int64_t axis() const {
+    return axis_;
+  }
+
+  Tensor quantize(const Tensor& rtensor) override;
+  Tensor dequantize(const Tensor& qtensor) override;
+  bool equalTo(const QuantizerPtr& other) const override;
+
+ private:
+  const Tensor scales_;
+  const Tensor zero_points_;
+  const int64_t axis_;
+};
+
+// Check that the scale is positive and finite and that the zero point is in
+// the range of scalar_type.
+TORCH_API QuantizerPtr make_per_tensor_affine_quantizer(
+    double scale,
+    int64_t zero_point,
+    ScalarType scalar_type);
+
+// Same checks for every channel; scales and zero_points are copied.
+TORCH_API QuantizerPtr make_per_channel_affine_quantizer(
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis,
+    ScalarType scalar_type);
+
+// an uninitialized contiguous tensor of the given sizes, quantized by
+// quantizer
+TORCH_API Tensor new_qtensor(IntArrayRef sizes, QuantizerPtr quantizer);
+
+} // namespace at
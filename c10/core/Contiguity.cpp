@@ -0,0 +1,134 @@
+#include <c10/core/Contiguity.h>
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <vector>
+
+namespace c10 {
+
+namespace {
+
+constexpr std::array<size_t, 4> kChannelsLastOrder = {1, 3, 2, 0};
+constexpr std::array<size_t, 5> kChannelsLast3dOrder = {1, 4, 3, 2, 0};
+
+struct ChannelsLastFlags {
+  bool contiguous;
+  bool strides_like;
+};
+
+// Walk the dims from innermost to outermost in channels-last order and
+// derive both whether the strides are dense in that order and whether they
+// merely rank like it.
+template <size_t N>
+ChannelsLastFlags channels_last_flags(
+    const int64_t* sizes,
+    const int64_t* strides,
+    const std::array<size_t, N>& order) {
+  bool contiguous = true;
+  bool strides_like = strides[1] != 0;
+  int64_t expected = 1;
+  int64_t min = 0;
+  for (size_t d : order) {
+    const int64_t size = sizes[d];
+    const int64_t stride = strides[d];
+    if (size != 1) {
+      contiguous &= stride == expected;
+      expected *= size;
+    }
+    // An N111 tensor has identical strides for its size-1 dims and is
+    // ambiguous, as is a permuted 1C1W tensor; in both cases fall back to
+    // NCHW, which is why min grows by the size of the visited dim.
+    if (size == 0 or stride < min or (d == 0 and min == strides[1])) {
+      strides_like = false;
+    }
+    min = size > 1 ? stride * size : stride;
+  }
+  return {contiguous, strides_like};
+}
+
+bool non_overlapping_and_dense_slow(
+    const int64_t* sizes,
+    const int64_t* strides,
+    size_t ndim) {
+  if (ndim == 1) {
+    return sizes[0] < 2 or strides[0] == 1;
+  }
+  std::array<size_t, 16> inline_perm;
+  std::vector<size_t> heap_perm;
+  size_t* perm = inline_perm.data();
+  if (ndim > inline_perm.size()) {
+    heap_perm.resize(ndim);
+    perm = heap_perm.data();
+  }
+  std::iota(perm, perm + ndim, size_t(0));
+  // sort by stride, size-1 dims last since their stride is meaningless
+  std::sort(perm, perm + ndim, [&](size_t a, size_t b) {
+    if (sizes[a] < 2) {
+      return false;
+    } else if (sizes[b] < 2) {
+      return true;
+    }
+    return strides[a] < strides[b];
+  });
+  int64_t expected = 1;
+  for (size_t i = 0; i < ndim; ++i) {
+    const int64_t size = sizes[perm[i]];
+    if (size < 2) {
+      return true;
+    }
+    if (strides[perm[i]] != expected) {
+      return false;
+    }
+    expected *= size;
+  }
+  return true;
+}
+
+} // namespace
+
+ContiguityFlags compute_contiguity_flags(
+    IntArrayRef sizes,
+    IntArrayRef strides) {
+  TORCH_INTERNAL_ASSERT(sizes.size() == strides.size());
+  const size_t ndim = sizes.size();
+  const int64_t* size_data = sizes.data();
+  const int64_t* stride_data = strides.data();
+
+  ContiguityFlags flags{};
+
+  bool contiguous = true;
+  bool empty = false;
+  int64_t expected = 1;
+  for (size_t i = ndim; i-- > 0;) {
+    const int64_t size = size_data[i];
+    empty |= size == 0;
+    if (size != 1) {
+      contiguous &= stride_data[i] == expected;
+      expected *= size;
+    }
+  }
+  flags.is_contiguous = contiguous or empty;
+
+  if (ndim == 4) {
+    const auto cl =
+        channels_last_flags(size_data, stride_data, kChannelsLastOrder);
+    flags.is_channels_last_contiguous = cl.contiguous;
+    flags.is_channels_last = cl.strides_like;
+  } else if (ndim == 5) {
+    const auto cl =
+        channels_last_flags(size_data, stride_data, kChannelsLast3dOrder);
+    flags.is_channels_last_3d_contiguous = cl.contiguous;
+    flags.is_channels_last_3d = cl.strides_like;
+  }
+
+  flags.is_non_overlapping_and_dense = flags.is_contiguous or
+      flags.is_channels_last_contiguous or
+      flags.is_channels_last_3d_contiguous or
+      (ndim > 0 and
+       non_overlapping_and_dense_slow(size_data, stride_data, ndim));
+  return flags;
+}
+
+} // namespace c10
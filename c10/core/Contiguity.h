@@ -0,0 +1,36 @@
+#pragma once
+
+#include <c10/util/ArrayRef.h>
+#include <c10/util/Macros.h>
+
+#include <cstdint>
+
+namespace c10 {
+
+// Layout properties of a (sizes, strides) pair that TensorImpl caches so that
+// the per-op layout queries are a bit test.
+struct ContiguityFlags {
+  // dense with C-contiguous (row-major) strides; size-1 dims and empty
+  // tensors are ignored
+  bool is_contiguous : 1;
+  // 4-dim, dense with NHWC strides
+  bool is_channels_last_contiguous : 1;
+  // 5-dim, dense with NDHWC strides
+  bool is_channels_last_3d_contiguous : 1;
+  // 4-dim, strides ordered like NHWC (may have gaps)
+  bool is_channels_last : 1;
+  // 5-dim, strides ordered like NDHWC (may have gaps)
+  bool is_channels_last_3d : 1;
+  // some permutation of the dims is C-contiguous
+  bool is_non_overlapping_and_dense : 1;
+};
+
+// Computes all of the flags above together. sizes and strides are read once
+// into registers by a single reverse walk that derives contiguity; the
+// channels-last flags share a second walk over the 4 or 5 dims in NHWC
+// order, and the permutation search for non-overlapping-and-dense only runs
+// when none of the cheap layouts matched.
+C10_API ContiguityFlags
+compute_contiguity_flags(IntArrayRef sizes, IntArrayRef strides);
+
+} // namespace c10
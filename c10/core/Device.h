@@ -51,8 +51,10 @@ struct Device final {
     return type_ == DeviceType::CPU;
   }
 
+  // whether tensors on this device may be viewed with arbitrary strides
+  // into a shared storage (as_strided and the views built on it)
   constexpr bool support_as_strided() const noexcept {
-    return false; // [TODO]
+    return type_ == DeviceType::CPU or type_ == DeviceType::CUDA;
   }
 
   std::string str() const;
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <c10/util/Exception.h>
+
+#include <cstdint>
+#include <ostream>
+
+namespace c10 {
+
+// How the elements of a tensor are stored. A Strided tensor keeps every
+// element in its storage at the position its strides give. The sparse
+// layouts keep only the specified (nonzero) elements, as ordinary index and
+// value tensors: Sparse is COO, see ATen/SparseTensorImpl.h, and SparseCsr
+// and SparseCsc are the compressed row and column formats of matrices, see
+// ATen/SparseCsrTensorImpl.h.
+enum class Layout : int8_t {
+  Strided,
+  Sparse,
+  SparseCsr,
+  SparseCsc,
+  NumOptions
+};
+
+constexpr auto kStrided = Layout::Strided;
+constexpr auto kSparse = Layout::Sparse;
+constexpr auto kSparseCsr = Layout::SparseCsr;
+constexpr auto kSparseCsc = Layout::SparseCsc;
+
+inline std::ostream& operator<<(std::ostream& stream, Layout layout) {
+  switch (layout) {
+    case kStrided:
+      return stream << "Strided";
+    case kSparse:
+      return stream << "Sparse";
+    case kSparseCsr:
+      return stream << "SparseCsr";
+    case kSparseCsc:
+      return stream << "SparseCsc";
+    default:
+      TORCH_CHECK(false, "Unknown layout ", static_cast<int>(layout));
+  }
+}
+
+} // namespace c10
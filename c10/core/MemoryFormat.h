@@ -0,0 +1,67 @@
+#pragma once
+
+#include <c10/util/ArrayRef.h>
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace c10 {
+
+// Physical order of the dimensions of a dense tensor. ChannelsLast (NHWC)
+// applies to 4-dim tensors, ChannelsLast3d (NDHWC) to 5-dim tensors. Preserve
+// asks an op to keep the memory format of its input.
+enum class MemoryFormat : int8_t {
+  Contiguous,
+  Preserve,
+  ChannelsLast,
+  ChannelsLast3d,
+  NumOptions
+};
+
+inline std::ostream& operator<<(
+    std::ostream& stream,
+    c10::MemoryFormat memory_format) {
+  switch (memory_format) {
+    case MemoryFormat::Preserve:
+      return stream << "Preserve";
+    case MemoryFormat::Contiguous:
+      return stream << "Contiguous";
+    case MemoryFormat::ChannelsLast:
+      return stream << "ChannelsLast";
+    case MemoryFormat::ChannelsLast3d:
+      return stream << "ChannelsLast3d";
+    default:
+      TORCH_CHECK(
+          false, "Unknown memory format ", static_cast<int>(memory_format));
+  }
+}
+
+// strides of a dense NCHW-sized tensor stored as NHWC
+inline std::vector<int64_t> get_channels_last_strides_2d(IntArrayRef sizes) {
+  TORCH_CHECK(
+      sizes.size() == 4, "ChannelsLast2d doesn't support size ", sizes.size());
+  std::vector<int64_t> strides(4);
+  strides[1] = 1;
+  strides[3] = sizes[1];
+  strides[2] = strides[3] * std::max<int64_t>(sizes[3], 1);
+  strides[0] = strides[2] * std::max<int64_t>(sizes[2], 1);
+  return strides;
+}
+
+// strides of a dense NCDHW-sized tensor stored as NDHWC
+inline std::vector<int64_t> get_channels_last_strides_3d(IntArrayRef sizes) {
+  TORCH_CHECK(
+      sizes.size() == 5, "ChannelsLast3d doesn't support size ", sizes.size());
+  std::vector<int64_t> strides(5);
+  strides[1] = 1;
+  strides[4] = sizes[1];
+  strides[3] = strides[4] * std::max<int64_t>(sizes[4], 1);
+  strides[2] = strides[3] * std::max<int64_t>(sizes[3], 1);
+  strides[0] = strides[2] * std::max<int64_t>(sizes[2], 1);
+  return strides;
+}
+
+} // namespace c10
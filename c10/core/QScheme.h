@@ -0,0 +1,37 @@
+#pragma once
+
+#include <c10/util/Exception.h>
+
+#include <cstdint>
+#include <ostream>
+
+namespace c10 {
+
+// How the integers of a quantized tensor map to real values, see
+// ATen/quantized/Quantizer.h: one scale and zero point for the whole tensor,
+// or one per slice along an axis (per output channel for weights).
+enum class QScheme : uint8_t {
+  PER_TENSOR_AFFINE,
+  PER_CHANNEL_AFFINE,
+  COMPILE_TIME_NUM_QSCHEMES
+};
+
+constexpr auto kPerTensorAffine = QScheme::PER_TENSOR_AFFINE;
+constexpr auto kPerChannelAffine = QScheme::PER_CHANNEL_AFFINE;
+
+inline const char* toString(QScheme qscheme) {
+  switch (qscheme) {
+    case kPerTensorAffine:
+      return "per_tensor_affine";
+    case kPerChannelAffine:
+      return "per_channel_affine";
+    default:
+      TORCH_CHECK(false, "Unknown qscheme ", static_cast<int>(qscheme));
+  }
+}
+
+inline std::ostream& operator<<(std::ostream& stream, QScheme qscheme) {
+  return stream << toString(qscheme);
+}
+
+} // namespace c10
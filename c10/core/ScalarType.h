@@ -1,7 +1,15 @@
 #pragma once
 
+#include <c10/util/BFloat16.h>
 #include <c10/util/Exception.h>
+#include <c10/util/Float8_e4m3fn.h>
+#include <c10/util/Float8_e5m2.h>
 #include <c10/util/Half.h>
+#include <c10/util/int4x2.h>
+#include <c10/util/nf4x2.h>
+#include <c10/util/qint32.h>
+#include <c10/util/qint8.h>
+#include <c10/util/quint8.h>
 
 #include <cstddef>
 #include <cstdint>
@@ -10,19 +18,27 @@
 
 namespace c10 {
 
-#define AT_FORALL_SCALAR_TYPES(_) \
-  _(uint8_t, Byte)                \
-  _(int8_t, Char)                 \
-  _(int16_t, Short)               \
-  _(int, Int)                     \
-  _(int64_t, Long)                \
-  _(c10::Half, Half)              \
-  _(float, Float)                 \
-  _(double, Double)               \
-  _(bool, Bool)                   \
-  _(uint16_t, UInt16)             \
-  _(uint32_t, UInt32)             \
-  _(uint64_t, UInt64)
+#define AT_FORALL_SCALAR_TYPES(_)      \
+  _(uint8_t, Byte)                     \
+  _(int8_t, Char)                      \
+  _(int16_t, Short)                    \
+  _(int, Int)                          \
+  _(int64_t, Long)                     \
+  _(c10::Half, Half)                   \
+  _(float, Float)                      \
+  _(double, Double)                    \
+  _(bool, Bool)                        \
+  _(c10::BFloat16, BFloat16)           \
+  _(uint16_t, UInt16)                  \
+  _(uint32_t, UInt32)                  \
+  _(uint64_t, UInt64)                  \
+  _(c10::Float8_e5m2, Float8_e5m2)     \
+  _(c10::Float8_e4m3fn, Float8_e4m3fn) \
+  _(c10::qint8, QInt8)                 \
+  _(c10::quint8, QUInt8)               \
+  _(c10::qint32, QInt32)               \
+  _(c10::int4x2, Int4)                 \
+  _(c10::nf4x2, NF4)
 
 enum class ScalarType : int8_t {
 #define DEFINE_ENUM(_1, n) n,
@@ -82,11 +98,21 @@ inline const char* toString(ScalarType t) {
 #undef DEFINE_CASE
 }
 
+// the 4-bit types, two elements to a byte of their C++ type (see
+// int4x2.h); they have no element size in bytes, only elementBits()
+inline bool isSubByteType(ScalarType t) {
+  return t == ScalarType::Int4 || t == ScalarType::NF4;
+}
+
 inline size_t elementSize(ScalarType t) {
 #define DEFINE_ELEMENT_SIZE_CASE(ctype, name) \
   case ScalarType::name:                      \
     return sizeof(ctype);
 
+  TORCH_CHECK(
+      !isSubByteType(t),
+      toString(t),
+      " has no element size in bytes, it packs two elements per byte");
   switch (t) {
     AT_FORALL_SCALAR_TYPES(DEFINE_ELEMENT_SIZE_CASE)
     default:
@@ -95,6 +121,16 @@ inline size_t elementSize(ScalarType t) {
 #undef DEFINE_ELEMENT_SIZE_CASE
 }
 
+inline size_t elementBits(ScalarType t) {
+  return isSubByteType(t) ? 4 : 8 * elementSize(t);
+}
+
+// the bytes numel elements of type t take, a partly used last byte
+// included
+inline size_t storageNbytes(ScalarType t, size_t numel) {
+  return isSubByteType(t) ? (numel + 1) / 2 : numel * elementSize(t);
+}
+
 inline bool isIntegralType(ScalarType t, bool includeBool = false) {
   bool is_integral =
       (t == ScalarType::Byte || t == ScalarType::Char || t == ScalarType::Int ||
@@ -104,15 +140,52 @@ inline bool isIntegralType(ScalarType t, bool includeBool = false) {
   return is_integral || (includeBool && t == ScalarType::Bool);
 }
 
+// the 16-bit floating types, which kernels compute on in float
 inline bool isReducedFloatingType(ScalarType t) {
-  return t == ScalarType::Half;
+  return t == ScalarType::Half || t == ScalarType::BFloat16;
 }
 
+// the types the floating kernels compute on; the Float8 types are only
+// stored, see isFloat8Type()
 inline bool isFloatingType(ScalarType t) {
   return t == ScalarType::Float || t == ScalarType::Double ||
       isReducedFloatingType(t);
 }
 
+// the 8-bit floating types, converted to float to compute on
+inline bool isFloat8Type(ScalarType t) {
+  return t == ScalarType::Float8_e5m2 || t == ScalarType::Float8_e4m3fn;
+}
+
+// the quantized types, whose values only mean something together with the
+// quantizer of their tensor
+inline bool isQIntType(ScalarType t) {
+  return t == ScalarType::QInt8 || t == ScalarType::QUInt8 ||
+      t == ScalarType::QInt32;
+}
+
+// the integer type a quantized type holds
+inline ScalarType toUnderlying(ScalarType t) {
+  switch (t) {
+    case ScalarType::QInt8:
+      return ScalarType::Char;
+    case ScalarType::QUInt8:
+      return ScalarType::Byte;
+    case ScalarType::QInt32:
+      return ScalarType::Int;
+    default:
+      return t;
+  }
+}
+
+template <typename T>
+constexpr bool is_reduced_floating_point_v =
+    std::is_same_v<T, c10::Half> || std::is_same_v<T, c10::BFloat16>;
+
+template <typename T>
+constexpr bool is_float8_v = std::is_same_v<T, c10::Float8_e5m2> ||
+    std::is_same_v<T, c10::Float8_e4m3fn>;
+
 inline std::ostream& operator<<(std::ostream& stream, ScalarType scalar_type) {
   return stream << toString(scalar_type);
 }
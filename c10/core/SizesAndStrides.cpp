@@ -0,0 +1,64 @@
+#include <c10/core/SizesAndStrides.h>
+
+namespace c10::impl {
+
+void SizesAndStrides::resizeSlowPath(
+    const size_t new_size,
+    const size_t old_size) {
+  if (new_size <= C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE) {
+    TORCH_INTERNAL_ASSERT(
+        !isInline(),
+        "resizeSlowPath called when fast path should have been hit!");
+    int64_t* tempStorage = outOfLineStorage_;
+    memcpy(
+        &inlineStorage_[0],
+        &tempStorage[0],
+        C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE * sizeof(inlineStorage_[0]));
+    memcpy(
+        &inlineStorage_[C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE],
+        &tempStorage[old_size],
+        C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE * sizeof(inlineStorage_[0]));
+    // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+    free(tempStorage);
+  } else {
+    if (isInline()) {
+      // copy before allocating, outOfLineStorage_ aliases inlineStorage_
+      // NOLINTNEXTLINE(*c-arrays*)
+      int64_t tempStorage[C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE * 2];
+      memcpy(tempStorage, &inlineStorage_[0], sizeof(inlineStorage_));
+      allocateOutOfLineStorage(new_size);
+      memcpy(
+          &outOfLineStorage_[0],
+          &tempStorage[0],
+          old_size * sizeof(inlineStorage_[0]));
+      memcpy(
+          &outOfLineStorage_[new_size],
+          &tempStorage[C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE],
+          old_size * sizeof(inlineStorage_[0]));
+      const auto bytes_to_zero = (new_size - old_size) * sizeof(int64_t);
+      memset(&outOfLineStorage_[old_size], 0, bytes_to_zero);
+      memset(&outOfLineStorage_[new_size + old_size], 0, bytes_to_zero);
+    } else {
+      const bool is_growing = new_size > old_size;
+      if (is_growing) {
+        // grow before moving the strides up
+        resizeOutOfLineStorage(new_size);
+      }
+      memmove(
+          &outOfLineStorage_[new_size],
+          &outOfLineStorage_[old_size],
+          std::min(old_size, new_size) * sizeof(outOfLineStorage_[0]));
+      if (is_growing) {
+        const auto bytes_to_zero = (new_size - old_size) * sizeof(int64_t);
+        memset(&outOfLineStorage_[old_size], 0, bytes_to_zero);
+        memset(&outOfLineStorage_[new_size + old_size], 0, bytes_to_zero);
+      } else {
+        // shrink after the strides moved down
+        resizeOutOfLineStorage(new_size);
+      }
+    }
+  }
+  size_ = new_size;
+}
+
+} // namespace c10::impl
@@ -3,15 +3,22 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 
 #include <c10/util/ArrayRef.h>
+#include <c10/util/Exception.h>
 #include <c10/util/Macros.h>
 
-#define C10_SIZES_AND_STRIDES_MAX_SIZE 10
+#define C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE 5
 
 namespace c10::impl {
 
+// Packed container for the sizes and strides of a tensor. Up to
+// C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE dims are stored inline (sizes
+// followed by strides); larger ranks spill into a single heap block laid out
+// the same way, so there is no limit on the number of dimensions. Moving a
+// spilled instance steals its heap block.
 class C10_API SizesAndStrides {
  public:
   using sizes_iterator = int64_t*;
@@ -24,31 +31,70 @@ class C10_API SizesAndStrides {
     stride_at_unchecked(0) = 1;
   }
 
-  ~SizesAndStrides() = default;
+  ~SizesAndStrides() {
+    if (UNLIKELY(!isInline())) {
+      // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+      free(outOfLineStorage_);
+    }
+  }
 
   SizesAndStrides(const SizesAndStrides& rhs) : size_(rhs.size_) {
-    copy_data(rhs);
+    if (LIKELY(rhs.isInline())) {
+      copyDataInline(rhs);
+    } else {
+      allocateOutOfLineStorage(size_);
+      copyDataOutline(rhs);
+    }
   }
 
   SizesAndStrides& operator=(const SizesAndStrides& rhs) {
-    if (this != &rhs) {
-      size_ = rhs.size_;
-      copy_data(rhs);
+    if (this == &rhs) {
+      return *this;
     }
+    if (LIKELY(rhs.isInline())) {
+      if (UNLIKELY(!isInline())) {
+        // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+        free(outOfLineStorage_);
+      }
+      copyDataInline(rhs);
+    } else {
+      if (isInline()) {
+        allocateOutOfLineStorage(rhs.size_);
+      } else {
+        resizeOutOfLineStorage(rhs.size_);
+      }
+      copyDataOutline(rhs);
+    }
+    size_ = rhs.size_;
     return *this;
   }
 
   SizesAndStrides(SizesAndStrides&& rhs) noexcept : size_(rhs.size_) {
-    copy_data(rhs);
+    if (LIKELY(isInline())) {
+      memcpy(inlineStorage_, rhs.inlineStorage_, sizeof(inlineStorage_));
+    } else {
+      outOfLineStorage_ = rhs.outOfLineStorage_;
+      rhs.outOfLineStorage_ = nullptr;
+    }
     rhs.size_ = 0;
   }
 
   SizesAndStrides& operator=(SizesAndStrides&& rhs) noexcept {
-    if (this != &rhs) {
-      size_ = rhs.size_;
-      copy_data(rhs);
-      rhs.size_ = 0;
+    if (this == &rhs) {
+      return *this;
+    }
+    if (UNLIKELY(!isInline())) {
+      // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+      free(outOfLineStorage_);
     }
+    if (LIKELY(rhs.isInline())) {
+      memcpy(inlineStorage_, rhs.inlineStorage_, sizeof(inlineStorage_));
+    } else {
+      outOfLineStorage_ = rhs.outOfLineStorage_;
+      rhs.outOfLineStorage_ = nullptr;
+    }
+    size_ = rhs.size_;
+    rhs.size_ = 0;
     return *this;
   }
 
@@ -57,11 +103,19 @@ class C10_API SizesAndStrides {
   }
 
   const int64_t* sizes_data() const noexcept {
-    return &storage_[0];
+    if (LIKELY(isInline())) {
+      return &inlineStorage_[0];
+    } else {
+      return &outOfLineStorage_[0];
+    }
   }
 
   int64_t* sizes_data() noexcept {
-    return &storage_[0];
+    if (LIKELY(isInline())) {
+      return &inlineStorage_[0];
+    } else {
+      return &outOfLineStorage_[0];
+    }
   }
 
   sizes_const_iterator sizes_begin() const noexcept {
@@ -90,11 +144,19 @@ class C10_API SizesAndStrides {
   }
 
   const int64_t* strides_data() const noexcept {
-    return &storage_[C10_SIZES_AND_STRIDES_MAX_SIZE];
+    if (LIKELY(isInline())) {
+      return &inlineStorage_[C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE];
+    } else {
+      return &outOfLineStorage_[size()];
+    }
   }
 
   int64_t* strides_data() noexcept {
-    return &storage_[C10_SIZES_AND_STRIDES_MAX_SIZE];
+    if (LIKELY(isInline())) {
+      return &inlineStorage_[C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE];
+    } else {
+      return &outOfLineStorage_[size()];
+    }
   }
 
   strides_const_iterator strides_begin() const noexcept {
@@ -163,27 +225,69 @@ class C10_API SizesAndStrides {
     if (new_size == old_size) {
       return;
     }
-    assert(new_size <= C10_SIZES_AND_STRIDES_MAX_SIZE);
-    if (old_size < new_size) {
-      const auto bytes_to_zero = (new_size - old_size) * sizeof(storage_[0]);
-      memset(&storage_[old_size], 0, bytes_to_zero);
-      memset(
-          &storage_[old_size + C10_SIZES_AND_STRIDES_MAX_SIZE],
-          0,
-          bytes_to_zero);
+    if (LIKELY(
+            new_size <= C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE and
+            isInline())) {
+      if (old_size < new_size) {
+        const auto bytes_to_zero =
+            (new_size - old_size) * sizeof(inlineStorage_[0]);
+        memset(&inlineStorage_[old_size], 0, bytes_to_zero);
+        memset(
+            &inlineStorage_[C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE + old_size],
+            0,
+            bytes_to_zero);
+      }
+      size_ = new_size;
+    } else {
+      resizeSlowPath(new_size, old_size);
     }
-    size_ = new_size;
   }
 
  private:
-  void copy_data(const SizesAndStrides& rhs) {
-    memcpy(storage_, rhs.storage_, sizeof(storage_));
+  bool isInline() const noexcept {
+    return size_ <= C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE;
   }
 
+  void copyDataInline(const SizesAndStrides& rhs) {
+    TORCH_INTERNAL_ASSERT(rhs.isInline());
+    memcpy(inlineStorage_, rhs.inlineStorage_, sizeof(inlineStorage_));
+  }
+
+  void copyDataOutline(const SizesAndStrides& rhs) noexcept {
+    memcpy(outOfLineStorage_, rhs.outOfLineStorage_, storageBytes(rhs.size_));
+  }
+
+  static size_t storageBytes(size_t size) noexcept {
+    return size * 2 * sizeof(int64_t);
+  }
+
+  void allocateOutOfLineStorage(size_t size) {
+    // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+    outOfLineStorage_ = static_cast<int64_t*>(malloc(storageBytes(size)));
+    TORCH_CHECK(
+        outOfLineStorage_,
+        "Could not allocate memory for Tensor SizesAndStrides!");
+  }
+
+  void resizeOutOfLineStorage(size_t new_size) {
+    TORCH_INTERNAL_ASSERT(!isInline());
+    outOfLineStorage_ = static_cast<int64_t*>(
+        // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+        realloc(outOfLineStorage_, storageBytes(new_size)));
+    TORCH_CHECK(
+        outOfLineStorage_,
+        "Could not allocate memory for Tensor SizesAndStrides!");
+  }
+
+  void resizeSlowPath(size_t new_size, size_t old_size);
+
   size_t size_{1};
 
-  // NOLINTNEXTLINE(*c-arrays*)
-  int64_t storage_[C10_SIZES_AND_STRIDES_MAX_SIZE * 2]{};
+  union {
+    int64_t* outOfLineStorage_;
+    // NOLINTNEXTLINE(*c-arrays*)
+    int64_t inlineStorage_[C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE * 2]{};
+  };
 };
 
 } // namespace c10::impl
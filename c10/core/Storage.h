@@ -32,12 +32,11 @@ struct C10_API Storage {
       const size_t size_bytes,
       Allocator* allocator = nullptr,
       bool resizable = false)
-      : storage_impl_(
-            c10::make_intrusive<StorageImpl>(
-                StorageImpl::use_byte_size_t{},
-                size_bytes,
-                allocator,
-                resizable)) {}
+      : storage_impl_(make_storage_impl(
+            StorageImpl::use_byte_size_t{},
+            size_bytes,
+            allocator,
+            resizable)) {}
   Storage(
       use_byte_size_t,
       const size_t size_bytes,
@@ -95,6 +94,15 @@ struct C10_API Storage {
     storage_impl_->set_data_ptr_noswap(std::move(data_ptr));
   }
 
+  // see StorageImpl::version()
+  uint64_t version() const {
+    return storage_impl_->version();
+  }
+
+  void bump_version() const {
+    storage_impl_->bump_version();
+  }
+
   DeviceType device_type() const {
     return storage_impl_->device_type();
   }
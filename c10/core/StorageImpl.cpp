@@ -1,8 +1,44 @@
 #include <c10/core/StorageImpl.h>
+#include <c10/cpu/CPUAllocator.h>
 
 namespace c10 {
 void StorageImpl::throw_data_ptr_access_error() const {
   TORCH_CHECK(false, "Cannot access data pointer of Storage that is invalid.");
 }
 
+namespace {
+
+template <size_t N>
+c10::intrusive_ptr<StorageImpl> make_inline(
+    size_t size_bytes,
+    Allocator* allocator) {
+  return c10::make_intrusive<InlineStorageImpl<N>>(size_bytes, allocator);
+}
+
+} // namespace
+
+c10::intrusive_ptr<StorageImpl> make_storage_impl(
+    StorageImpl::use_byte_size_t,
+    size_t size_bytes,
+    Allocator* allocator,
+    bool resizable) {
+  // the inline buffer only honours the default CPU allocator's contract, a
+  // custom allocator (e.g. one that tracks or pins memory) must see every
+  // request
+  if (!resizable and size_bytes > 0 and
+      size_bytes <= kMaxInlineStorageBytes and
+      allocator == GetCPUAllocator()) {
+    if (size_bytes <= 32) {
+      return make_inline<32>(size_bytes, allocator);
+    } else if (size_bytes <= 64) {
+      return make_inline<64>(size_bytes, allocator);
+    } else if (size_bytes <= 128) {
+      return make_inline<128>(size_bytes, allocator);
+    }
+    return make_inline<kMaxInlineStorageBytes>(size_bytes, allocator);
+  }
+  return c10::make_intrusive<StorageImpl>(
+      StorageImpl::use_byte_size_t{}, size_bytes, allocator, resizable);
+}
+
 } // namespace c10
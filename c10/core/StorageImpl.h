@@ -8,7 +8,10 @@
 #include <c10/util/IntrusivePtr.h>
 #include <c10/util/Macros.h>
 #include <c10/util/MaybeOwned.h>
+#include <c10/util/SlabPool.h>
 
+#include <atomic>
+#include <cstdint>
 #include <utility>
 
 namespace c10 {
@@ -16,6 +19,9 @@ struct C10_API StorageImpl : public c10::intrusive_ptr_target {
  public:
   struct use_byte_size_t {};
 
+  // every Storage allocates one of these, keep them out of the general heap
+  C10_SLAB_POOLED_ALLOCATION
+
   StorageImpl(
       use_byte_size_t,
       const size_t size_bytes,
@@ -52,6 +58,7 @@ struct C10_API StorageImpl : public c10::intrusive_ptr_target {
   ~StorageImpl() override = default;
 
   void reset() {
+    bump_version();
     data_ptr_.clear();
     size_bytes_ = 0;
   }
@@ -87,24 +94,42 @@ struct C10_API StorageImpl : public c10::intrusive_ptr_target {
         throw_data_ptr_access_error();
       }
     }
+    bump_version();
     return data_ptr_;
   }
 
   DataPtr& _mutable_data_ptr_unsafe() {
+    bump_version();
     return data_ptr_;
   }
 
+  // Counts the times the bytes may have changed: every mutable access to
+  // the data bumps it, as does replacing the data pointer, and in-place ops
+  // bump it again once they are done writing. Caches of data derived from
+  // a storage, such as packed GEMM weights, record it to detect later
+  // writes. The access is counted, not the write: whoever writes through a
+  // mutable pointer taken earlier must call bump_version() afterwards.
+  uint64_t version() const {
+    return version_.load(std::memory_order_relaxed);
+  }
+
+  void bump_version() {
+    version_.fetch_add(1, std::memory_order_relaxed);
+  }
+
   DataPtr set_data_ptr(DataPtr&& data_ptr) {
   return set_data_ptr_no_materialize_cow(std::move(data_ptr));
   }
 
   void set_data_ptr_noswap(DataPtr&& data_ptr) {
+    bump_version();
     data_ptr_ = std::move(data_ptr);
     refresh_has_data_ptr_check();
   }
 
   // [TODO] cow
   DataPtr set_data_ptr_no_materialize_cow(DataPtr&& data_ptr) {
+    bump_version();
     DataPtr old_data_ptr(std::move(data_ptr_));
     data_ptr_ = std::move(data_ptr);
     refresh_has_data_ptr_check();
@@ -166,6 +191,42 @@ struct C10_API StorageImpl : public c10::intrusive_ptr_target {
   bool throw_on_mutable_data_ptr_ = false;
   bool throw_on_immutable_data_ptr_ = false;
   Allocator* allocator_;
+  std::atomic<uint64_t> version_{0};
+};
+
+// A StorageImpl whose data lives in the same allocation, directly after the
+// object header, so that a small storage costs a single (pooled) allocation
+// and its bytes share cache lines with the metadata. The buffer cannot grow:
+// these storages are never resizable, and swapping in another DataPtr simply
+// leaves the inline bytes unused.
+template <size_t N>
+struct InlineStorageImpl final : public StorageImpl {
+  static constexpr size_t kCapacity = N;
+
+  InlineStorageImpl(size_t size_bytes, Allocator* allocator)
+      : StorageImpl(
+            use_byte_size_t{},
+            size_bytes,
+            DataPtr(inline_data_, Device(DeviceType::CPU)),
+            allocator,
+            /*resizable=*/false) {
+    TORCH_INTERNAL_ASSERT(size_bytes <= N);
+  }
+
+ private:
+  alignas(16) char inline_data_[N];
 };
 
+// largest storage that is co-allocated with its StorageImpl
+constexpr size_t kMaxInlineStorageBytes = 256;
+
+// Create the StorageImpl for `size_bytes` fresh bytes from `allocator`.
+// Non-resizable CPU storages of at most kMaxInlineStorageBytes bytes
+// allocated from the default CPU allocator are placed inline.
+C10_API c10::intrusive_ptr<StorageImpl> make_storage_impl(
+    StorageImpl::use_byte_size_t,
+    size_t size_bytes,
+    Allocator* allocator,
+    bool resizable);
+
 } // namespace c10
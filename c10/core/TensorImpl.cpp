@@ -0,0 +1,173 @@
+#include <c10/core/TensorImpl.h>
+
+#include <cstddef>
+
+namespace c10 {
+
+AutogradMetaInterface::~AutogradMetaInterface() = default;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+struct TensorImplLayoutCheck {
+  static constexpr size_t kCacheLine = 64;
+
+  // the whole object (vptr, refcounts, hot metadata, extra_meta_) fits in
+  // two cache lines plus the tail of a 5-dim stride array
+  static_assert(
+      sizeof(TensorImpl) <= 144,
+      "TensorImpl grew, keep the hot fields within the first two cache lines");
+
+  static_assert(
+      offsetof(TensorImpl, device_opt_) + sizeof(std::optional<Device>) <=
+          offsetof(TensorImpl, sizes_and_strides_),
+      "scalar metadata must precede sizes and strides");
+
+  // sizes and strides of tensors with up to 4 dims end within 128 bytes
+  static_assert(
+      offsetof(TensorImpl, sizes_and_strides_) + sizeof(size_t) +
+              (C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE + 4) * sizeof(int64_t) <=
+          2 * kCacheLine,
+      "sizes/strides of a 4-dim tensor must fit in two cache lines");
+
+  static_assert(
+      offsetof(TensorImpl, extra_meta_) >=
+          offsetof(TensorImpl, sizes_and_strides_) +
+              sizeof(c10::impl::SizesAndStrides),
+      "cold state goes last");
+};
+#pragma GCC diagnostic pop
+
+TensorImpl::TensorImpl(Storage&& storage, const TypeMeta data_type)
+    : TensorImpl(VIEW, std::move(storage), data_type) {
+  TORCH_CHECK(storage_, "TensorImpl requires a defined storage");
+  device_opt_ = storage_.device();
+}
+
+TensorImpl::TensorImpl(ImplType, Storage&& storage, const TypeMeta data_type)
+    : storage_(std::move(storage)),
+      numel_(0),
+      data_type_(data_type),
+      is_contiguous_(true),
+      is_channels_last_(false),
+      is_channels_last_contiguous_(false),
+      is_channels_last_3d_(false),
+      is_channels_last_3d_contiguous_(false),
+      is_non_overlapping_and_dense_(true) {
+  if (storage_) {
+    device_opt_ = storage_.device();
+  }
+}
+
+TensorImpl::~TensorImpl() = default;
+
+void TensorImpl::release_resources() {
+  extra_meta_.reset();
+  storage_ = Storage();
+}
+
+ExtraMeta& TensorImpl::get_extra_meta() {
+  if (!extra_meta_) {
+    extra_meta_ = std::make_unique<ExtraMeta>();
+  }
+  return *extra_meta_;
+}
+
+void TensorImpl::set_autograd_meta(
+    std::unique_ptr<c10::AutogradMetaInterface> autograd_meta) {
+  if (!autograd_meta and !extra_meta_) {
+    return;
+  }
+  get_extra_meta().autograd_meta_ = std::move(autograd_meta);
+}
+
+void TensorImpl::set_named_tensor_meta(
+    std::unique_ptr<c10::NamedTensorMetaInterface> named_tensor_meta) {
+  if (!named_tensor_meta and !extra_meta_) {
+    return;
+  }
+  get_extra_meta().named_tensor_meta_ = std::move(named_tensor_meta);
+}
+
+void TensorImpl::set_backend_meta(
+    c10::intrusive_ptr<c10::BackendMeta> backend_meta) {
+  if (!backend_meta and !extra_meta_) {
+    return;
+  }
+  get_extra_meta().backend_meta_ = std::move(backend_meta);
+}
+
+void TensorImpl::set_sizes_contiguous(IntArrayRef new_size) {
+  sizes_and_strides_.set_sizes(new_size);
+  empty_tensor_restride_contiguous();
+}
+
+void TensorImpl::set_sizes_and_strides(
+    IntArrayRef new_size,
+    IntArrayRef new_stride,
+    std::optional<int64_t> storage_offset) {
+  TORCH_CHECK(
+      new_size.size() == new_stride.size(),
+      "dimensionality of sizes (",
+      new_size.size(),
+      ") must match dimensionality of strides (",
+      new_stride.size(),
+      ")");
+  sizes_and_strides_.set_sizes(new_size);
+  sizes_and_strides_.set_strides(new_stride);
+  if (storage_offset.has_value()) {
+    set_storage_offset(*storage_offset);
+  }
+  refresh_numel();
+  refresh_contiguous();
+}
+
+void TensorImpl::empty_tensor_restride(MemoryFormat memory_format) {
+  switch (memory_format) {
+    case MemoryFormat::Contiguous:
+      empty_tensor_restride_contiguous();
+      return;
+    case MemoryFormat::ChannelsLast:
+      sizes_and_strides_.set_strides(get_channels_last_strides_2d(sizes()));
+      break;
+    case MemoryFormat::ChannelsLast3d:
+      sizes_and_strides_.set_strides(get_channels_last_strides_3d(sizes()));
+      break;
+    default:
+      TORCH_CHECK(false, "unsupported memory format ", memory_format);
+  }
+  refresh_numel();
+  refresh_contiguous();
+}
+
+void TensorImpl::empty_tensor_restride_contiguous() {
+  const int64_t ndim = dim();
+  int64_t numel = 1;
+  for (int64_t i = ndim - 1; i >= 0; --i) {
+    sizes_and_strides_.stride_at_unchecked(i) = numel;
+    // a size-0 dimension would zero out every outer stride, follow the
+    // "stride is at least 1" convention instead
+    numel *= std::max<int64_t>(sizes_and_strides_.size_at_unchecked(i), 1);
+  }
+  refresh_numel();
+  refresh_contiguous();
+}
+
+void TensorImpl::refresh_numel() {
+  int64_t numel = 1;
+  for (int64_t size : sizes()) {
+    numel *= size;
+  }
+  numel_ = numel;
+}
+
+void TensorImpl::refresh_contiguous() {
+  const ContiguityFlags flags = compute_contiguity_flags(sizes(), strides());
+  is_contiguous_ = flags.is_contiguous;
+  is_channels_last_contiguous_ = flags.is_channels_last_contiguous;
+  is_channels_last_3d_contiguous_ = flags.is_channels_last_3d_contiguous;
+  is_channels_last_ = flags.is_channels_last;
+  is_channels_last_3d_ = flags.is_channels_last_3d;
+  is_non_overlapping_and_dense_ = flags.is_non_overlapping_and_dense;
+}
+
+} // namespace c10
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <c10/core/Contiguity.h>
 #include <c10/core/Device.h>
 #include <c10/core/DeviceType.h>
+#include <c10/core/Layout.h>
+#include <c10/core/MemoryFormat.h>
 #include <c10/core/SizesAndStrides.h>
 #include <c10/core/Storage.h>
+#include <c10/core/WrapDimMinimal.h>
 #include <c10/util/Exception.h>
 #include <c10/util/IntrusivePtr.h>
+#include <c10/util/SlabPool.h>
+#include <c10/util/typeid.h>
 
 #include <algorithm>
 #include <atomic>
@@ -25,6 +31,7 @@ namespace c10 {
 
 struct C10_API AutogradMetaInterface {
   // TODO
+  virtual ~AutogradMetaInterface();
 };
 
 namespace impl {
@@ -40,8 +47,23 @@ struct C10_API AutogradMetaFactoryRegisterer {
 };
 } // namespace impl
 
-// BackendMeta
-// ExtraMeta
+// Opaque per-tensor state owned by a backend, shared between shallow copies
+struct C10_API BackendMeta : intrusive_ptr_target {
+  ~BackendMeta() override = default;
+};
+
+struct C10_API NamedTensorMetaInterface {
+  virtual ~NamedTensorMetaInterface() = default;
+};
+
+// State most tensors never have. It lives behind a single pointer allocated
+// on first use so that TensorImpl itself only carries what kernels touch.
+struct C10_API ExtraMeta {
+  std::unique_ptr<c10::AutogradMetaInterface> autograd_meta_;
+  std::unique_ptr<c10::NamedTensorMetaInterface> named_tensor_meta_;
+  c10::intrusive_ptr<c10::BackendMeta> backend_meta_;
+};
+
 // VariableVersion
 
 struct C10_API TensorImpl : public c10::intrusive_ptr_target {
@@ -50,20 +72,208 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
 
   enum ImplType { VIEW };
 
- protected:
-  Storage storage_;
+  // a tensor is a handful of small objects created per op, pool them
+  C10_SLAB_POOLED_ALLOCATION
+
+  // construct a 1-dim, 0-size tensor backed by the given storage
+  TensorImpl(Storage&& storage, const TypeMeta data_type);
+
+  // construct a view: unlike the constructor above, the storage may be
+  // empty (the caller sets it up afterwards)
+  TensorImpl(ImplType, Storage&& storage, const TypeMeta data_type);
+
+  TensorImpl(const TensorImpl&) = delete;
+  TensorImpl& operator=(const TensorImpl&) = delete;
+  TensorImpl(TensorImpl&&) = delete;
+  TensorImpl& operator=(TensorImpl&&) = delete;
+
+  void release_resources() override;
+
+  IntArrayRef sizes() const {
+    return sizes_and_strides_.sizes_arrayref();
+  }
+
+  IntArrayRef strides() const {
+    return sizes_and_strides_.strides_arrayref();
+  }
+
+  int64_t dim() const {
+    return static_cast<int64_t>(sizes_and_strides_.size());
+  }
+
+  int64_t size(int64_t d) const {
+    return sizes_and_strides_.size_at_unchecked(wrap_dim(d));
+  }
+
+  int64_t stride(int64_t d) const {
+    return sizes_and_strides_.stride_at_unchecked(wrap_dim(d));
+  }
+
+  int64_t numel() const {
+    return numel_;
+  }
+
+  // The layout queries below read flags cached by refresh_contiguous()
+  // whenever sizes or strides change, they never walk the strides.
+  bool is_contiguous(
+      MemoryFormat memory_format = MemoryFormat::Contiguous) const {
+    switch (memory_format) {
+      case MemoryFormat::ChannelsLast:
+        return is_channels_last_contiguous_;
+      case MemoryFormat::ChannelsLast3d:
+        return is_channels_last_3d_contiguous_;
+      default:
+        return is_contiguous_;
+    }
+  }
+
+  // whether the strides are ordered like `memory_format`, possibly with gaps
+  bool is_strides_like(MemoryFormat memory_format) const {
+    switch (memory_format) {
+      case MemoryFormat::ChannelsLast:
+        return is_channels_last_;
+      case MemoryFormat::ChannelsLast3d:
+        return is_channels_last_3d_;
+      default:
+        return false;
+    }
+  }
+
+  bool is_non_overlapping_and_dense() const {
+    return is_non_overlapping_and_dense_;
+  }
+
+  bool has_storage() const {
+    return static_cast<bool>(storage_);
+  }
+
+  const Storage& storage() const {
+    return storage_;
+  }
+
+  const Storage& unsafe_storage() const {
+    return storage_;
+  }
+
+  int64_t storage_offset() const {
+    return storage_offset_;
+  }
+
+  const TypeMeta dtype() const {
+    return data_type_;
+  }
+
+  // Strided unless this is the impl of a sparse tensor, which has no
+  // storage; see Layout.h
+  Layout layout() const {
+    return layout_;
+  }
+
+  size_t itemsize() const {
+    return data_type_.itemsize();
+  }
+
+  Device device() const {
+    TORCH_CHECK(device_opt_.has_value(), "tensor does not have a device");
+    return *device_opt_;
+  }
+
+  const void* data() const {
+    return data_impl<const void>(
+        [this] { return static_cast<const char*>(storage_.data()); });
+  }
+
+  void* mutable_data() {
+    return data_impl<void>(
+        [this] { return static_cast<char*>(storage_.mutable_data()); });
+  }
+
+  // resize to `new_size` with C-contiguous strides; the storage is not
+  // touched and must be large enough for the caller's purposes
+  void set_sizes_contiguous(IntArrayRef new_size);
+
+  // set arbitrary sizes and strides (and optionally the storage offset),
+  // e.g. for views; the storage is not touched
+  void set_sizes_and_strides(
+      IntArrayRef new_size,
+      IntArrayRef new_stride,
+      std::optional<int64_t> storage_offset = std::nullopt);
+
+  void set_storage_offset(int64_t storage_offset) {
+    TORCH_CHECK(
+        storage_offset >= 0,
+        "storage_offset must be non-negative, got ",
+        storage_offset);
+    storage_offset_ = storage_offset;
+  }
+
+  // give the current sizes dense strides in the given memory format
+  void empty_tensor_restride(MemoryFormat memory_format);
+
+  c10::AutogradMetaInterface* autograd_meta() const {
+    return extra_meta_ ? extra_meta_->autograd_meta_.get() : nullptr;
+  }
+
+  void set_autograd_meta(
+      std::unique_ptr<c10::AutogradMetaInterface> autograd_meta);
+
+  c10::NamedTensorMetaInterface* named_tensor_meta() const {
+    return extra_meta_ ? extra_meta_->named_tensor_meta_.get() : nullptr;
+  }
+
+  void set_named_tensor_meta(
+      std::unique_ptr<c10::NamedTensorMetaInterface> named_tensor_meta);
+
+  c10::intrusive_ptr<c10::BackendMeta> get_backend_meta_intrusive_ptr() const {
+    return extra_meta_ ? extra_meta_->backend_meta_
+                       : c10::intrusive_ptr<c10::BackendMeta>();
+  }
+
+  void set_backend_meta(c10::intrusive_ptr<c10::BackendMeta> backend_meta);
 
  private:
-  std::unique_ptr<c10::AutogradMetaInterface> autograd_meta_;
+  size_t wrap_dim(int64_t d) const {
+    return static_cast<size_t>(maybe_wrap_dim(d, dim(), false));
+  }
 
+  template <typename Void, typename Func>
+  Void* data_impl(const Func& get_data) const {
+    TORCH_CHECK(
+        has_storage(),
+        "Cannot access data pointer of Tensor that doesn't have storage");
+    auto* data = get_data();
+    // 4-bit tensors, which have no itemsize, have no views and so always
+    // take this early return
+    if (data == nullptr || storage_offset_ == 0) {
+      return data;
+    }
+    return data + data_type_.itemsize() * storage_offset_;
+  }
+
+  void empty_tensor_restride_contiguous();
+
+  void refresh_numel();
+
+  // recompute every cached layout flag in one pass over sizes and strides,
+  // must be called after any change to either
+  void refresh_contiguous();
+
+ private:
+  ExtraMeta& get_extra_meta();
+
+  // Field order is part of the design: everything a kernel reads to launch
+  // (storage, offset, numel, dtype, contiguity, sizes and strides of up to
+  // 4-dim tensors) sits in the first 128 bytes, i.e. two cache lines, with
+  // the rarely used state behind extra_meta_ at the very end. The size
+  // budget is enforced by static_asserts in TensorImpl.cpp.
  protected:
-  c10::impl::SizesAndStrides sizes_and_strides_;
+  Storage storage_;
 
   int64_t storage_offset_ = 0;
 
   int64_t numel_ = 1;
 
-  // data_type_
+  TypeMeta data_type_;
 
   std::optional<c10::Device> device_opt_;
 
@@ -78,6 +288,15 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
   bool is_channels_last_3d_contiguous_ : 1;
 
   bool is_non_overlapping_and_dense_ : 1;
+
+  Layout layout_ = Layout::Strided;
+
+  c10::impl::SizesAndStrides sizes_and_strides_;
+
+ private:
+  std::unique_ptr<ExtraMeta> extra_meta_;
+
+  friend struct TensorImplLayoutCheck;
 };
 
 } // namespace c10
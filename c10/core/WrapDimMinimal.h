@@ -0,0 +1,35 @@
+#pragma once
+
+#include <c10/util/Exception.h>
+
+#include <cstdint>
+
+namespace c10 {
+
+// Wraps a possibly negative dim index into [0, dim_post_expr). A 0-dim
+// tensor accepts dims 0 and -1 when wrap_scalar is set, as if it were 1-dim.
+inline int64_t maybe_wrap_dim(
+    int64_t dim,
+    int64_t dim_post_expr,
+    bool wrap_scalar = true) {
+  if (dim_post_expr <= 0) {
+    TORCH_CHECK(
+        wrap_scalar,
+        "Dimension specified as ",
+        dim,
+        " but tensor has no dimensions");
+    dim_post_expr = 1;
+  }
+  TORCH_CHECK(
+      dim >= -dim_post_expr and dim < dim_post_expr,
+      "Dimension out of range (expected to be in range of [",
+      -dim_post_expr,
+      ", ",
+      dim_post_expr - 1,
+      "], but got ",
+      dim,
+      ")");
+  return dim < 0 ? dim + dim_post_expr : dim;
+}
+
+} // namespace c10
@@ -0,0 +1,260 @@
+#include <c10/core/thread_pool.h>
+#include <c10/util/Exception.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace c10 {
+
+namespace {
+
+// Iterations an idle worker polls for a new region before going to sleep;
+// the first kPauseIterations busy-wait, the rest yield the core.
+constexpr int kSpinIterations = 256;
+constexpr int kPauseIterations = 64;
+
+thread_local bool tls_in_parallel_region = false;
+thread_local int tls_thread_num = 0;
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#endif
+}
+
+inline void spin_wait(int iteration) {
+  if (iteration < kPauseIterations) {
+    cpu_relax();
+  } else {
+    std::this_thread::yield();
+  }
+}
+
+// a share of chunks [begin, end) packed into one word
+inline uint64_t pack_range(uint64_t begin, uint64_t end) {
+  return (begin << 32) | end;
+}
+
+inline uint64_t range_begin(uint64_t range) {
+  return range >> 32;
+}
+
+inline uint64_t range_end(uint64_t range) {
+  return range & 0xffffffffu;
+}
+
+inline bool is_open(uint64_t epoch) {
+  return (epoch & 1) != 0;
+}
+
+void pin_current_thread(int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  // best effort: an invalid or offline cpu leaves the thread unpinned
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(int num_threads, std::vector<int> cpus) {
+  start_workers(num_threads, std::move(cpus));
+}
+
+ThreadPool::~ThreadPool() {
+  std::lock_guard<std::mutex> guard(region_mutex_);
+  stop_workers();
+}
+
+void ThreadPool::resize(int num_threads, std::vector<int> cpus) {
+  std::lock_guard<std::mutex> guard(region_mutex_);
+  stop_workers();
+  start_workers(num_threads, std::move(cpus));
+}
+
+void ThreadPool::start_workers(int num_threads, std::vector<int> cpus) {
+  TORCH_CHECK(num_threads > 0, "Expected positive number of threads");
+  num_threads_ = num_threads;
+  shares_ = std::make_unique<Share[]>(num_threads);
+  workers_.reserve(num_threads - 1);
+  for (int id = 1; id < num_threads; ++id) {
+    const int cpu = cpus.empty() ? -1 : cpus[(id - 1) % cpus.size()];
+    workers_.emplace_back([this, id, cpu] { worker_main(id, cpu); });
+  }
+}
+
+void ThreadPool::stop_workers() {
+  {
+    std::lock_guard<std::mutex> guard(sleep_mutex_);
+    stop_ = true;
+  }
+  sleep_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  stop_ = false;
+}
+
+void ThreadPool::worker_main(int id, int cpu) {
+  if (cpu >= 0) {
+    pin_current_thread(cpu);
+  }
+  uint64_t seen = epoch_.load(std::memory_order_acquire);
+  while (true) {
+    uint64_t epoch = 0;
+    bool ready = false;
+    for (int i = 0; i < kSpinIterations and !ready; ++i) {
+      epoch = epoch_.load(std::memory_order_acquire);
+      ready = is_open(epoch) and epoch != seen;
+      if (!ready) {
+        spin_wait(i);
+      }
+    }
+    if (!ready) {
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      sleepers_.fetch_add(1);
+      sleep_cv_.wait(lock, [&] {
+        epoch = epoch_.load();
+        return stop_ or (is_open(epoch) and epoch != seen);
+      });
+      sleepers_.fetch_sub(1);
+      if (stop_) {
+        return;
+      }
+    }
+    seen = epoch;
+    active_.fetch_add(1);
+    // the caller may have closed the region while we were waking up
+    if (epoch_.load() == epoch) {
+      run_region(id);
+    }
+    active_.fetch_sub(1, std::memory_order_release);
+  }
+}
+
+bool ThreadPool::take_chunk(int id, int64_t& chunk) {
+  // own share, from the front
+  Share& own = shares_[id];
+  uint64_t range = own.range.load(std::memory_order_relaxed);
+  while (range_begin(range) < range_end(range)) {
+    if (own.range.compare_exchange_weak(
+            range,
+            pack_range(range_begin(range) + 1, range_end(range)),
+            std::memory_order_acq_rel,
+            std::memory_order_relaxed)) {
+      chunk = static_cast<int64_t>(range_begin(range));
+      return true;
+    }
+  }
+  // steal from the back of the other shares
+  for (int i = 1; i < num_threads_; ++i) {
+    Share& victim = shares_[(id + i) % num_threads_];
+    range = victim.range.load(std::memory_order_relaxed);
+    while (range_begin(range) < range_end(range)) {
+      if (victim.range.compare_exchange_weak(
+              range,
+              pack_range(range_begin(range), range_end(range) - 1),
+              std::memory_order_acq_rel,
+              std::memory_order_relaxed)) {
+        chunk = static_cast<int64_t>(range_end(range) - 1);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void ThreadPool::run_region(int id) {
+  tls_in_parallel_region = true;
+  tls_thread_num = id;
+  int64_t chunk = 0;
+  while (take_chunk(id, chunk)) {
+    try {
+      fn_(chunk);
+    } catch (...) {
+      if (!error_flag_.test_and_set()) {
+        error_ = std::current_exception();
+      }
+    }
+    done_chunks_.fetch_add(1, std::memory_order_release);
+  }
+  tls_in_parallel_region = false;
+  tls_thread_num = 0;
+}
+
+void ThreadPool::run(int64_t num_chunks, c10::function_ref<void(int64_t)> fn) {
+  if (num_chunks <= 0) {
+    return;
+  }
+  auto run_inline = [&] {
+    for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+      fn(chunk);
+    }
+  };
+  // a nested region must not touch region_mutex_, the calling thread may
+  // already hold it
+  if (num_chunks == 1 or tls_in_parallel_region) {
+    run_inline();
+    return;
+  }
+  std::unique_lock<std::mutex> lock(region_mutex_, std::try_to_lock);
+  if (!lock.owns_lock() or num_threads_ == 1) {
+    run_inline();
+    return;
+  }
+  TORCH_CHECK(
+      num_chunks <= static_cast<int64_t>(0xffffffffu),
+      "ThreadPool: too many chunks in one region: ",
+      num_chunks);
+
+  fn_ = fn;
+  done_chunks_.store(0, std::memory_order_relaxed);
+  error_flag_.clear();
+  error_ = nullptr;
+  for (int i = 0; i < num_threads_; ++i) {
+    const uint64_t begin = num_chunks * i / num_threads_;
+    const uint64_t end = num_chunks * (i + 1) / num_threads_;
+    shares_[i].range.store(pack_range(begin, end), std::memory_order_relaxed);
+  }
+
+  // open the region and wake up sleeping workers
+  const uint64_t epoch = epoch_.fetch_add(1) + 1;
+  if (sleepers_.load() > 0) {
+    std::lock_guard<std::mutex> guard(sleep_mutex_);
+    sleep_cv_.notify_all();
+  }
+
+  run_region(0);
+
+  // every chunk is taken by now, wait for those still executing elsewhere
+  for (int i = 0; done_chunks_.load(std::memory_order_acquire) != num_chunks;
+       ++i) {
+    spin_wait(i);
+  }
+  epoch_.store(epoch + 1);
+  for (int i = 0; active_.load(std::memory_order_acquire) != 0; ++i) {
+    spin_wait(i);
+  }
+  fn_ = nullptr;
+
+  if (error_) {
+    std::exception_ptr error = std::move(error_);
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+bool ThreadPool::in_parallel_region() {
+  return tls_in_parallel_region;
+}
+
+int ThreadPool::current_thread_num() {
+  return tls_thread_num;
+}
+
+} // namespace c10
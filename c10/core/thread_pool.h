@@ -0,0 +1,104 @@
+#pragma once
+
+#include <c10/util/FunctionRef.h>
+#include <c10/util/Macros.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace c10 {
+
+// A persistent pool of threads that execute parallel regions: a region is a
+// range of `num_chunks` independent chunks, handed out with work stealing.
+//
+// The thread that calls run() takes part in the region as participant 0, the
+// pool's size() - 1 worker threads are participants 1 and up. Every
+// participant starts with a contiguous share of the chunks, which it consumes
+// from the front; a participant that runs out steals single chunks from the
+// back of the other shares. Shares are a packed [begin, end) pair in one
+// atomic word, so taking or stealing a chunk is a single CAS and no locks are
+// taken while a region runs.
+//
+// Idle workers spin briefly and then sleep on a condition variable. The
+// caller never waits for a sleeping worker: it steals whatever was assigned
+// to participants that have not shown up, and only waits for chunks that are
+// already executing.
+//
+// Only one region runs at a time. A run() that finds the pool busy, e.g. from
+// a second application thread, runs its chunks on the calling thread instead
+// of queueing. Code running inside a region sees in_parallel_region() and
+// should not start nested regions.
+class C10_API ThreadPool final {
+ public:
+  // num_threads counts the calling thread, so num_threads - 1 workers are
+  // started. If cpus is non-empty, worker i is pinned to cpus[i % size].
+  explicit ThreadPool(int num_threads, std::vector<int> cpus = {});
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // number of participants of a region, including the calling thread
+  int size() const {
+    return num_threads_;
+  }
+
+  // Restarts the workers with a new size or affinity. Blocks until the
+  // region in progress, if any, has finished.
+  void resize(int num_threads, std::vector<int> cpus = {});
+
+  // Calls fn(chunk) for every chunk in [0, num_chunks) and returns when all
+  // of them have completed. The first exception thrown by fn is rethrown
+  // here once the region is done.
+  void run(int64_t num_chunks, c10::function_ref<void(int64_t)> fn);
+
+  // whether the calling thread is executing a chunk of a region
+  static bool in_parallel_region();
+
+  // participant number of the calling thread in the current region, 0
+  // outside of regions
+  static int current_thread_num();
+
+ private:
+  struct alignas(64) Share {
+    std::atomic<uint64_t> range{0};
+  };
+
+  void start_workers(int num_threads, std::vector<int> cpus);
+  void stop_workers();
+  void worker_main(int id, int cpu);
+  void run_region(int id);
+  bool take_chunk(int id, int64_t& chunk);
+
+  int num_threads_ = 1;
+  std::vector<std::thread> workers_;
+  std::unique_ptr<Share[]> shares_;
+
+  // Odd while a region is open. Workers join the region of the epoch they
+  // observed only if it is still open after announcing themselves in
+  // active_, so the caller may reuse the region state once it has closed
+  // the epoch and seen active_ drop to zero.
+  std::atomic<uint64_t> epoch_{0};
+  std::atomic<int> active_{0};
+  std::atomic<int> sleepers_{0};
+  bool stop_ = false;
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+
+  // serializes regions and resizing
+  std::mutex region_mutex_;
+
+  // state of the current region
+  c10::function_ref<void(int64_t)> fn_;
+  std::atomic<int64_t> done_chunks_{0};
+  std::atomic_flag error_flag_ = ATOMIC_FLAG_INIT;
+  std::exception_ptr error_;
+};
+
+} // namespace c10
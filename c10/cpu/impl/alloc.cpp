@@ -1,18 +1,45 @@
 #include <c10/cpu/impl/alloc.h>
 #include <c10/util/Exception.h>
 #include <cstdlib>
+#include <mutex>
 #include <new>
+#include <vector>
 
 namespace c10 {
 
+namespace {
+
+std::mutex& free_memory_callbacks_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::vector<FreeMemoryCallback>& free_memory_callbacks() {
+  static std::vector<FreeMemoryCallback> callbacks;
+  return callbacks;
+}
+
+bool run_free_memory_callbacks() {
+  std::lock_guard<std::mutex> guard(free_memory_callbacks_mutex());
+  bool freed = false;
+  for (FreeMemoryCallback callback : free_memory_callbacks()) {
+    freed = callback() or freed;
+  }
+  return freed;
+}
+
+} // namespace
+
 void* alloc_cpu(size_t nbytes) {
   if (nbytes == 0) {
     return nullptr;
   }
 
   TORCH_INTERNAL_ASSERT(nbytes >= 0);
-  void* data = std::malloc(nbytes); //NOLINT(cppcoreguidelines-no-malloc)
-  if (!data) {
+  void* data = nullptr;
+  if (posix_memalign(&data, gAlignment, nbytes) != 0 and
+      (!run_free_memory_callbacks() or
+       posix_memalign(&data, gAlignment, nbytes) != 0)) {
     throw std::bad_alloc();
   }
   return data;
@@ -22,4 +49,9 @@ void free_cpu(void* data) {
   std::free(data); // NOLINT(cppcoreguidelines-no-malloc)
 }
 
+void add_free_memory_callback(FreeMemoryCallback callback) {
+  std::lock_guard<std::mutex> guard(free_memory_callbacks_mutex());
+  free_memory_callbacks().push_back(callback);
+}
+
 } // namespace c10
@@ -4,7 +4,18 @@
 #include <cstddef>
 namespace c10 {
 
+// Alignment of the memory alloc_cpu returns: a cache line, which is also
+// the widest vector load (AVX-512) kernels issue.
+constexpr size_t gAlignment = 64;
+
 C10_API void* alloc_cpu(size_t nbytes);
 C10_API void free_cpu(void* data);
 
+// Called by alloc_cpu when an allocation fails, which then retries once if
+// any callback returns true (it released memory). Caches of data that can
+// be recomputed, e.g. packed GEMM weights, register one to give their
+// memory back under pressure. A callback must not allocate with alloc_cpu.
+using FreeMemoryCallback = bool (*)();
+C10_API void add_free_memory_callback(FreeMemoryCallback callback);
+
 } // namespace c10
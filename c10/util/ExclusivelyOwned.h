@@ -0,0 +1,121 @@
+#pragma once
+
+#include <c10/util/Macros.h>
+#include <c10/util/MaybeOwned.h>
+
+#include <type_traits>
+#include <utility>
+
+namespace c10 {
+
+// ExclusivelyOwned<T> holds a T that is known to have exactly one owner for
+// its whole lifetime, which lets the representation skip the bookkeeping a
+// shared T pays for. For c10::intrusive_ptr this means no atomic
+// read-modify-write on the refcount at all: the object is created with a
+// refcount of one, destroyed directly, and only turned into a regular shared
+// intrusive_ptr by take() when it escapes.
+//
+// The representation is chosen by ExclusivelyOwnedTraits<T>, which must
+// provide:
+//   repr_type, pointer_type, const_pointer_type
+//   static repr_type nullRepr();
+//   template <class... Args> static repr_type createInPlace(Args&&...);
+//   static repr_type moveToRepr(T&&);
+//   static void destroyOwned(repr_type&);
+//   static T take(repr_type&);
+//   static pointer_type getImpl(repr_type&);
+//   static const_pointer_type getImpl(const repr_type&);
+// and optionally, to lend the object to code expecting a T,
+//   static MaybeOwned<T> borrow(const repr_type&);
+template <typename T>
+struct ExclusivelyOwnedTraits;
+
+template <typename T>
+class ExclusivelyOwned final {
+  using EOT = ExclusivelyOwnedTraits<T>;
+  using repr_type = typename EOT::repr_type;
+
+  repr_type repr_;
+
+ public:
+  ExclusivelyOwned() : repr_(EOT::nullRepr()) {}
+
+  explicit ExclusivelyOwned(T&& t) : repr_(EOT::moveToRepr(std::move(t))) {}
+
+  template <class... Args>
+  explicit ExclusivelyOwned(std::in_place_t, Args&&... args)
+      : repr_(EOT::createInPlace(std::forward<Args>(args)...)) {}
+
+  ExclusivelyOwned(const ExclusivelyOwned&) = delete;
+  ExclusivelyOwned& operator=(const ExclusivelyOwned&) = delete;
+
+  ExclusivelyOwned(ExclusivelyOwned&& rhs) noexcept
+      : repr_(std::move(rhs.repr_)) {
+    rhs.repr_ = EOT::nullRepr();
+  }
+
+  ExclusivelyOwned& operator=(ExclusivelyOwned&& rhs) noexcept {
+    if (this != &rhs) {
+      EOT::destroyOwned(repr_);
+      repr_ = std::move(rhs.repr_);
+      rhs.repr_ = EOT::nullRepr();
+    }
+    return *this;
+  }
+
+  ExclusivelyOwned& operator=(T&& rhs) {
+    EOT::destroyOwned(repr_);
+    repr_ = EOT::moveToRepr(std::move(rhs));
+    return *this;
+  }
+
+  ~ExclusivelyOwned() {
+    EOT::destroyOwned(repr_);
+  }
+
+  // give up exclusive ownership, e.g. when the object escapes into shared
+  // state; *this is left empty
+  T take() && {
+    return EOT::take(repr_);
+  }
+
+  // lend the object to code that expects a `const T&`
+  MaybeOwned<T> borrow() const {
+    return EOT::borrow(repr_);
+  }
+
+  typename EOT::pointer_type get() {
+    return EOT::getImpl(repr_);
+  }
+
+  typename EOT::const_pointer_type get() const {
+    return EOT::getImpl(repr_);
+  }
+
+  typename EOT::pointer_type operator->() {
+    return get();
+  }
+
+  typename EOT::const_pointer_type operator->() const {
+    return get();
+  }
+
+  std::remove_pointer_t<typename EOT::pointer_type>& operator*() {
+    return *get();
+  }
+
+  std::remove_pointer_t<typename EOT::const_pointer_type>& operator*() const {
+    return *get();
+  }
+
+  explicit operator bool() const {
+    return get() != nullptr;
+  }
+};
+
+template <typename T, class... Args>
+inline ExclusivelyOwned<T> make_exclusively_owned(Args&&... args) {
+  return ExclusivelyOwned<T>(std::in_place, std::forward<Args>(args)...);
+}
+
+} // namespace c10
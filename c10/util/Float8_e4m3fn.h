@@ -0,0 +1,151 @@
+#pragma once
+
+#include <c10/util/FloatingPointUtils.h>
+#include <c10/util/Macros.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+
+// Float8_e4m3fn: 1 sign, 4 exponent (bias 7) and 3 mantissa bits, the
+// "E4M3" format of the OCP 8-bit floating point specification. There are
+// no infinities ("fn": finite) and only S.1111.111 is NaN, which makes
+// 448 the largest value. A storage type: values are computed on in float.
+//
+// Narrowing rounds to nearest even and saturates: finite values and
+// infinities beyond 448 in magnitude become +-448.
+
+namespace c10 {
+namespace detail {
+
+inline float fp8e4m3fn_to_fp32_value(uint8_t input) {
+  // the exponent and mantissa bits placed in the low bits of those of a
+  // float read as 2^(e - 127) * 1.m, or m * 2^-149 when e == 0; scaling by
+  // 2^(127 - 7) rebiases both normals and subnormals exactly
+  const uint32_t nonsign = static_cast<uint32_t>(input & 0x7F);
+  const uint32_t sign = static_cast<uint32_t>(input & 0x80) << 24;
+  if (nonsign == 0x7F) {
+    return fp32_from_bits(sign | UINT32_C(0x7FC00000));
+  }
+  const float magnitude =
+      fp32_from_bits(nonsign << 20) * fp32_from_bits(UINT32_C(247) << 23);
+  return fp32_from_bits(sign | fp32_to_bits(magnitude));
+}
+
+inline uint8_t fp8e4m3fn_from_fp32_value(float f) {
+  // 448, the largest finite value, as a float
+  constexpr uint32_t fp8_max = UINT32_C(0x43E00000);
+  // 2^-6, the smallest normal value, as a float
+  constexpr uint32_t fp8_min_normal = UINT32_C(121) << 23;
+  // 2^14: added to a value below 2^-6, it makes the last bit of the float
+  // mantissa worth 2^-9, the subnormal step, so that the addition rounds
+  constexpr uint32_t denorm_mask = UINT32_C(141) << 23;
+
+  uint32_t f_bits = fp32_to_bits(f);
+  const uint32_t sign = f_bits & UINT32_C(0x80000000);
+  f_bits ^= sign;
+  uint8_t result;
+  if (f_bits > UINT32_C(0x7F800000)) {
+    result = 0x7F;
+  } else if (f_bits >= fp8_max) {
+    result = 0x7E;
+  } else if (f_bits < fp8_min_normal) {
+    f = fp32_from_bits(f_bits) + fp32_from_bits(denorm_mask);
+    result = static_cast<uint8_t>(fp32_to_bits(f) - denorm_mask);
+  } else {
+    // rebias the exponent and round to nearest even as in BFloat16
+    const uint32_t mant_odd = (f_bits >> 20) & 1;
+    f_bits += (static_cast<uint32_t>(7 - 127) << 23) + UINT32_C(0x7FFFF);
+    f_bits += mant_odd;
+    result = static_cast<uint8_t>(f_bits >> 20);
+  }
+  return result | static_cast<uint8_t>(sign >> 24);
+}
+
+} // namespace detail
+
+struct alignas(1) Float8_e4m3fn {
+  uint8_t x;
+
+  struct from_bits_t {};
+  C10_HOST_DEVICE static constexpr from_bits_t from_bits() {
+    return from_bits_t();
+  }
+
+  C10_HOST_DEVICE Float8_e4m3fn() = default;
+
+  constexpr C10_HOST_DEVICE Float8_e4m3fn(uint8_t bits, from_bits_t)
+      : x(bits) {}
+
+  inline C10_HOST_DEVICE Float8_e4m3fn(float value);
+  inline C10_HOST_DEVICE operator float() const;
+};
+
+C10_API inline std::ostream& operator<<(
+    std::ostream& stream,
+    const Float8_e4m3fn& value) {
+  return stream << static_cast<float>(value);
+}
+
+inline C10_HOST_DEVICE Float8_e4m3fn::Float8_e4m3fn(float value)
+    : x(detail::fp8e4m3fn_from_fp32_value(value)) {}
+
+inline C10_HOST_DEVICE Float8_e4m3fn::operator float() const {
+  return detail::fp8e4m3fn_to_fp32_value(x);
+}
+
+} // namespace c10
+
+namespace std {
+
+template <>
+class numeric_limits<c10::Float8_e4m3fn> {
+ public:
+  static constexpr bool is_specialized = true;
+  static constexpr bool is_signed = true;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_exact = false;
+  static constexpr bool has_infinity = false;
+  static constexpr bool has_quiet_NaN = true;
+  static constexpr bool has_signaling_NaN = false;
+  static constexpr auto has_denorm = numeric_limits<float>::has_denorm;
+  static constexpr auto round_style = numeric_limits<float>::round_style;
+  static constexpr bool is_iec559 = false;
+  static constexpr bool is_bounded = true;
+  static constexpr bool is_modulo = false;
+  static constexpr int digits = 4;
+  static constexpr int digits10 = 0;
+  static constexpr int max_digits10 = 3;
+  static constexpr int radix = 2;
+  static constexpr int min_exponent = -5;
+  static constexpr int min_exponent10 = -1;
+  static constexpr int max_exponent = 9;
+  static constexpr int max_exponent10 = 2;
+  static constexpr auto traps = numeric_limits<float>::traps;
+  static constexpr auto tinyness_before = false;
+
+  static constexpr c10::Float8_e4m3fn min() {
+    return c10::Float8_e4m3fn(0x08, c10::Float8_e4m3fn::from_bits());
+  }
+  static constexpr c10::Float8_e4m3fn lowest() {
+    return c10::Float8_e4m3fn(0xFE, c10::Float8_e4m3fn::from_bits());
+  }
+  static constexpr c10::Float8_e4m3fn max() {
+    return c10::Float8_e4m3fn(0x7E, c10::Float8_e4m3fn::from_bits());
+  }
+  static constexpr c10::Float8_e4m3fn epsilon() {
+    return c10::Float8_e4m3fn(0x20, c10::Float8_e4m3fn::from_bits());
+  }
+  static constexpr c10::Float8_e4m3fn round_error() {
+    return c10::Float8_e4m3fn(0x30, c10::Float8_e4m3fn::from_bits());
+  }
+  static constexpr c10::Float8_e4m3fn quiet_NaN() {
+    return c10::Float8_e4m3fn(0x7F, c10::Float8_e4m3fn::from_bits());
+  }
+  static constexpr c10::Float8_e4m3fn denorm_min() {
+    return c10::Float8_e4m3fn(0x01, c10::Float8_e4m3fn::from_bits());
+  }
+};
+
+} // namespace std
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <c10/util/FloatingPointUtils.h>
+#include <c10/util/Macros.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+
+// Float8_e5m2: 1 sign, 5 exponent (bias 15) and 2 mantissa bits, the
+// "E5M2" format of the OCP 8-bit floating point specification: the upper
+// byte of a Half, with its infinities and NaNs, and 57344 the largest
+// finite value. A storage type: values are computed on in float.
+//
+// Narrowing rounds to nearest even and saturates: finite values beyond
+// 57344 in magnitude become +-57344, infinities stay infinite.
+
+namespace c10 {
+namespace detail {
+
+inline float fp8e5m2_to_fp32_value(uint8_t input) {
+  // as in fp8e4m3fn_to_fp32_value(), rebiasing by 2^(127 - 15)
+  const uint32_t nonsign = static_cast<uint32_t>(input & 0x7F);
+  const uint32_t sign = static_cast<uint32_t>(input & 0x80) << 24;
+  if (nonsign >= 0x7C) {
+    // infinity, or NaN with its payload
+    return fp32_from_bits(sign | UINT32_C(0x7F800000) | (nonsign & 3) << 21);
+  }
+  const float magnitude =
+      fp32_from_bits(nonsign << 21) * fp32_from_bits(UINT32_C(239) << 23);
+  return fp32_from_bits(sign | fp32_to_bits(magnitude));
+}
+
+inline uint8_t fp8e5m2_from_fp32_value(float f) {
+  // 57344, the largest finite value, as a float
+  constexpr uint32_t fp8_max = UINT32_C(0x47600000);
+  // 2^-14, the smallest normal value, as a float
+  constexpr uint32_t fp8_min_normal = UINT32_C(113) << 23;
+  // 2^7: added to a value below 2^-14, it makes the last bit of the float
+  // mantissa worth 2^-16, the subnormal step, so that the addition rounds
+  constexpr uint32_t denorm_mask = UINT32_C(134) << 23;
+
+  uint32_t f_bits = fp32_to_bits(f);
+  const uint32_t sign = f_bits & UINT32_C(0x80000000);
+  f_bits ^= sign;
+  uint8_t result;
+  if (f_bits > UINT32_C(0x7F800000)) {
+    result = 0x7F;
+  } else if (f_bits == UINT32_C(0x7F800000)) {
+    result = 0x7C;
+  } else if (f_bits >= fp8_max) {
+    result = 0x7B;
+  } else if (f_bits < fp8_min_normal) {
+    f = fp32_from_bits(f_bits) + fp32_from_bits(denorm_mask);
+    result = static_cast<uint8_t>(fp32_to_bits(f) - denorm_mask);
+  } else {
+    // rebias the exponent and round to nearest even as in BFloat16
+    const uint32_t mant_odd = (f_bits >> 21) & 1;
+    f_bits += (static_cast<uint32_t>(15 - 127) << 23) + UINT32_C(0xFFFFF);
+    f_bits += mant_odd;
+    result = static_cast<uint8_t>(f_bits >> 21);
+  }
+  return result | static_cast<uint8_t>(sign >> 24);
+}
+
+} // namespace detail
+
+struct alignas(1) Float8_e5m2 {
+  uint8_t x;
+
+  struct from_bits_t {};
+  C10_HOST_DEVICE static constexpr from_bits_t from_bits() {
+    return from_bits_t();
+  }
+
+  C10_HOST_DEVICE Float8_e5m2() = default;
+
+  constexpr C10_HOST_DEVICE Float8_e5m2(uint8_t bits, from_bits_t)
+      : x(bits) {}
+
+  inline C10_HOST_DEVICE Float8_e5m2(float value);
+  inline C10_HOST_DEVICE operator float() const;
+};
+
+C10_API inline std::ostream& operator<<(
+    std::ostream& stream,
+    const Float8_e5m2& value) {
+  return stream << static_cast<float>(value);
+}
+
+inline C10_HOST_DEVICE Float8_e5m2::Float8_e5m2(float value)
+    : x(detail::fp8e5m2_from_fp32_value(value)) {}
+
+inline C10_HOST_DEVICE Float8_e5m2::operator float() const {
+  return detail::fp8e5m2_to_fp32_value(x);
+}
+
+} // namespace c10
+
+namespace std {
+
+template <>
+class numeric_limits<c10::Float8_e5m2> {
+ public:
+  static constexpr bool is_specialized = true;
+  static constexpr bool is_signed = true;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_exact = false;
+  static constexpr bool has_infinity = true;
+  static constexpr bool has_quiet_NaN = true;
+  static constexpr bool has_signaling_NaN = false;
+  static constexpr auto has_denorm = numeric_limits<float>::has_denorm;
+  static constexpr auto round_style = numeric_limits<float>::round_style;
+  static constexpr bool is_iec559 = false;
+  static constexpr bool is_bounded = true;
+  static constexpr bool is_modulo = false;
+  static constexpr int digits = 3;
+  static constexpr int digits10 = 0;
+  static constexpr int max_digits10 = 2;
+  static constexpr int radix = 2;
+  static constexpr int min_exponent = -13;
+  static constexpr int min_exponent10 = -4;
+  static constexpr int max_exponent = 16;
+  static constexpr int max_exponent10 = 4;
+  static constexpr auto traps = numeric_limits<float>::traps;
+  static constexpr auto tinyness_before = false;
+
+  static constexpr c10::Float8_e5m2 min() {
+    return c10::Float8_e5m2(0x04, c10::Float8_e5m2::from_bits());
+  }
+  static constexpr c10::Float8_e5m2 lowest() {
+    return c10::Float8_e5m2(0xFB, c10::Float8_e5m2::from_bits());
+  }
+  static constexpr c10::Float8_e5m2 max() {
+    return c10::Float8_e5m2(0x7B, c10::Float8_e5m2::from_bits());
+  }
+  static constexpr c10::Float8_e5m2 epsilon() {
+    return c10::Float8_e5m2(0x34, c10::Float8_e5m2::from_bits());
+  }
+  static constexpr c10::Float8_e5m2 round_error() {
+    return c10::Float8_e5m2(0x38, c10::Float8_e5m2::from_bits());
+  }
+  static constexpr c10::Float8_e5m2 infinity() {
+    return c10::Float8_e5m2(0x7C, c10::Float8_e5m2::from_bits());
+  }
+  static constexpr c10::Float8_e5m2 quiet_NaN() {
+    return c10::Float8_e5m2(0x7F, c10::Float8_e5m2::from_bits());
+  }
+  static constexpr c10::Float8_e5m2 denorm_min() {
+    return c10::Float8_e5m2(0x01, c10::Float8_e5m2::from_bits());
+  }
+};
+
+} // namespace std
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <c10/util/Exception.h>
+#include <c10/util/ExclusivelyOwned.h>
 #include <c10/util/Macros.h>
 #include <c10/util/MaybeOwned.h>
 
@@ -23,6 +24,27 @@ inline void incref(intrusive_ptr_target* self);
 }
 } // namespace raw
 
+namespace detail {
+// Set in refcount_ once the last strong reference of a target is gone. Zero
+// is "sticky" from then on: weak lock()s increment the count unconditionally
+// and back off when they see this bit, so lock() is a single wait-free
+// fetch_add instead of a CAS retry loop that collapses under contention.
+// Increments by failed lock()s are garbage below the bit and never
+// observable.
+//
+// The owner that takes the count to a plain 0 must seal it with a CAS
+// before it touches the target again, unless no weak_ptr is left to call
+// lock() (weakcount_ == 1). A lock() that gets in between revives the
+// target, and as that owner no longer holds a reference which keeps the
+// target alive, the lock() also takes a weak reference on its behalf; the
+// owner's seal fails and it drops that weak reference, and nothing else.
+constexpr uint32_t kRefcountDead = UINT32_C(1) << 31;
+
+inline uint32_t strong_refcount(uint32_t refcount) {
+  return (refcount & kRefcountDead) ? 0 : refcount;
+}
+} // namespace detail
+
 // NOLINTNEXTLINE(cppcoreguidelines-virtual-class-destructor)
 class C10_API intrusive_ptr_target {
   mutable std::atomic<uint32_t> refcount_;
@@ -34,13 +56,16 @@ class C10_API intrusive_ptr_target {
   template <class TTarget, class NullType>
   friend class weak_intrusive_ptr;
 
+  template <typename T>
+  friend struct ExclusivelyOwnedTraits;
+
   friend inline void raw::intrusive_ptr::incref(intrusive_ptr_target* self);
   friend inline void raw::weak_intrusive_ptr::incref(
       intrusive_ptr_target* self);
 
  protected:
   virtual ~intrusive_ptr_target() {
-    assert(refcount_.load() == 0);
+    assert(detail::strong_refcount(refcount_.load()) == 0);
     assert(weakcount_.load() == 0 or weakcount_.load() == 1);
   }
 
@@ -128,11 +153,29 @@ class intrusive_ptr final {
   void reset_() {
     if (target_ != NullType::null() and
         detail::atomic_refcount_decrement(target_->refcount_) == 0) {
+      // A weakcount of 1 is the strong references' own: no weak_ptr is left
+      // to lock() the target, and none can be made, so it needs no seal.
+      // The acquire pairs with the release of the last weak_ptr, including
+      // any lock() it did.
+      if (target_->weakcount_.load(std::memory_order_acquire) == 1) {
+        delete target_;
+        return;
+      }
+      // Seal the zero first, see kRefcountDead. If a concurrent lock() got
+      // in, it owns the target now and left us a weak reference to drop.
+      uint32_t expected = 0;
+      if (!target_->refcount_.compare_exchange_strong(
+              expected, detail::kRefcountDead, std::memory_order_acq_rel)) {
+        if (detail::atomic_weakcount_decrement(target_->weakcount_) == 0) {
+          delete target_;
+        }
+        return;
+      }
+      // no lock() can revive the target anymore, nor create weak_ptrs
       bool should_delete =
           target_->weakcount_.load(std::memory_order_acquire) == 1;
       if (!should_delete) {
-        // refcount is 0, weakcount > 1, so there is still other weak_ptrs, we
-        // should release resources
+        // refcount is 0, weakcount > 1, so there is still other weak_ptrs.
         const_cast<std::remove_const_t<TTarget>*>(target_)->release_resources();
         should_delete =
             detail::atomic_weakcount_decrement(target_->weakcount_) == 0;
@@ -276,7 +319,8 @@ class intrusive_ptr final {
     // 2. refcount > 0
     TORCH_CHECK(
         owning_ptr == NullType::null() or
-            owning_ptr->refcount_.load(std::memory_order_acquire) == 0 or
+            detail::strong_refcount(owning_ptr->refcount_.load(
+                std::memory_order_acquire)) == 0 or
             owning_ptr->weakcount_.load(std::memory_order_acquire) > 0,
         "reclaim() received a invalid pointer that refcout > 0 and weakcount == 0");
     return intrusive_ptr(owning_ptr, raw::DontIncreaseRefcount{});
@@ -297,7 +341,8 @@ class intrusive_ptr final {
     if (target_ == NullType::null()) {
       return 0;
     } else {
-      return target_->refcount_.load(std::memory_order_acquire);
+      return detail::strong_refcount(
+          target_->refcount_.load(std::memory_order_acquire));
     }
   }
 
@@ -409,6 +454,71 @@ struct MaybeOwnedTraits<c10::intrusive_ptr<T>> {
   }
 };
 
+// An exclusively owned intrusive_ptr is represented by the raw target whose
+// refcount and weakcount are both one, set up with plain stores. As long as
+// nobody else took a reference (through borrow()), destruction can skip the
+// atomic decrements and delete the target directly.
+template <typename T>
+struct ExclusivelyOwnedTraits<c10::intrusive_ptr<T>> {
+  using repr_type = T*;
+  using pointer_type = T*;
+  using const_pointer_type = const T*;
+
+  static repr_type nullRepr() {
+    return nullptr;
+  }
+
+  template <class... Args>
+  static repr_type createInPlace(Args&&... args) {
+    return c10::intrusive_ptr<T>::make(std::forward<Args>(args)...).release();
+  }
+
+  static repr_type moveToRepr(c10::intrusive_ptr<T>&& x) {
+    TORCH_CHECK(
+        !x.defined() or (x.unique() and x.weak_use_count() == 1),
+        "ExclusivelyOwned requires an intrusive_ptr without other strong or weak references");
+    return x.release();
+  }
+
+  static void destroyOwned(repr_type& x) {
+    if (x == nullptr) {
+      return;
+    }
+    if (LIKELY(
+            x->refcount_.load(std::memory_order_acquire) == 1 and
+            x->weakcount_.load(std::memory_order_acquire) == 1)) {
+      x->refcount_.store(0, std::memory_order_relaxed);
+      x->weakcount_.store(0, std::memory_order_relaxed);
+      delete x;
+    } else {
+      // someone copied a borrow, release our reference the shared way
+      c10::intrusive_ptr<T>::reclaim(x);
+    }
+    x = nullptr;
+  }
+
+  static c10::intrusive_ptr<T> take(repr_type& x) {
+    auto result = c10::intrusive_ptr<T>::reclaim(x);
+    x = nullptr;
+    return result;
+  }
+
+  static c10::MaybeOwned<c10::intrusive_ptr<T>> borrow(const repr_type& x) {
+    auto owner = c10::intrusive_ptr<T>::reclaim(x);
+    auto result = c10::MaybeOwned<c10::intrusive_ptr<T>>::borrowed(owner);
+    owner.release();
+    return result;
+  }
+
+  static pointer_type getImpl(repr_type& x) {
+    return x;
+  }
+
+  static const_pointer_type getImpl(const repr_type& x) {
+    return x;
+  }
+};
+
 template <
     class TTarget,
     class NullType = detail::intrusive_default_null<TTarget>>
@@ -522,6 +632,7 @@ class weak_intrusive_ptr final {
 
   void reset() noexcept {
     reset_();
+    target_ = NullType::null();
   }
 
   void swap(weak_intrusive_ptr& rhs) noexcept {
@@ -536,7 +647,8 @@ class weak_intrusive_ptr final {
     if (target_ == NullType::null()) {
       return 0;
     } else {
-      return target_->refcount_.load(std::memory_order_acquire);
+      return detail::strong_refcount(
+          target_->refcount_.load(std::memory_order_acquire));
     }
   }
 
@@ -553,19 +665,27 @@ class weak_intrusive_ptr final {
   }
 
   intrusive_ptr<TTarget, NullType> lock() const noexcept {
-    if (expire()) {
+    // a dead target stays dead, don't write to its cache line
+    if (target_ == NullType::null() or
+        (target_->refcount_.load(std::memory_order_relaxed) &
+         detail::kRefcountDead)) {
       return intrusive_ptr<TTarget, NullType>();
-    } else {
-      auto refcount = target_->refcount_.load(std::memory_order_seq_cst);
-      do {
-        if (refcount == 0) {
-          return intrusive_ptr<TTarget, NullType>();
-        }
-      } while (
-          !target_->refcount_.compare_exchange_weak(refcount, refcount + 1));
-      return intrusive_ptr<TTarget, NullType>(
-          target_, raw::DontIncreaseRefcount{});
     }
+    // Wait-free: a plain 0 means the last strong reference is being dropped
+    // but its owner has not sealed the count yet, in which case we revive
+    // the target and its owner backs off (see kRefcountDead).
+    const uint32_t old_refcount =
+        target_->refcount_.fetch_add(1, std::memory_order_acq_rel);
+    if (old_refcount & detail::kRefcountDead) {
+      return intrusive_ptr<TTarget, NullType>();
+    }
+    if (old_refcount == 0) {
+      // for the owner whose seal now fails; our own weak reference keeps
+      // the target alive until this is taken
+      detail::atomic_weakcount_increment(target_->weakcount_);
+    }
+    return intrusive_ptr<TTarget, NullType>(
+        target_, raw::DontIncreaseRefcount{});
   }
 
   TTarget* release() noexcept {
@@ -586,7 +706,7 @@ class weak_intrusive_ptr final {
     // owning pointer without weak references (refcount == xx, weakcount == 1)
     TORCH_CHECK(
         owning_ptr == NullType::null() or owning_ptr->weakcount_.load() > 1 or
-            owning_ptr->refcount_.load() == 0 and
+            detail::strong_refcount(owning_ptr->refcount_.load()) == 0 and
                 owning_ptr->weakcount_.load() > 0,
         "weak_intrusive_ptr: reclaim() received a invalid pointer");
     return weak_intrusive_ptr(owning_ptr);
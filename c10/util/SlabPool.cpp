@@ -0,0 +1,187 @@
+#include <c10/util/Exception.h>
+#include <c10/util/SlabPool.h>
+
+#include <array>
+#include <mutex>
+
+namespace c10 {
+
+namespace {
+
+constexpr size_t kRefillSlots = 64;
+constexpr size_t kSlabAlignment = 64;
+
+struct FreeSlot {
+  FreeSlot* next;
+};
+
+// singly linked list of free slots threaded through the slots themselves
+struct FreeList {
+  FreeSlot* head = nullptr;
+  size_t count = 0;
+
+  void push(void* ptr) noexcept {
+    auto* slot = static_cast<FreeSlot*>(ptr);
+    slot->next = head;
+    head = slot;
+    ++count;
+  }
+
+  void* pop() noexcept {
+    FreeSlot* slot = head;
+    head = slot->next;
+    --count;
+    return slot;
+  }
+
+  // move up to n slots from the front of this list to the front of `dst`
+  void transfer_to(FreeList& dst, size_t n) noexcept {
+    while (n-- > 0 and head != nullptr) {
+      dst.push(pop());
+    }
+  }
+};
+
+inline size_t size_class_index(size_t nbytes) {
+  return nbytes == 0 ? 0 : (nbytes - 1) / SlabPool::kSlotAlignment;
+}
+
+inline size_t slot_size(size_t index) {
+  return (index + 1) * SlabPool::kSlotAlignment;
+}
+
+// Process-wide reserve of free slots, one locked list per size class. It is
+// intentionally leaked so that objects destroyed during static destruction
+// can still be returned to it.
+class Depot final {
+ public:
+  static Depot& get() {
+    static Depot* depot = new Depot();
+    return *depot;
+  }
+
+  // hand `n` slots of size class `index` to `dst`, carving a new slab if the
+  // depot runs dry
+  void refill(size_t index, FreeList& dst, size_t n) {
+    std::lock_guard<std::mutex> guard(mutexes_[index]);
+    FreeList& list = lists_[index];
+    if (list.head == nullptr) {
+      carve_slab(index, list);
+    }
+    list.transfer_to(dst, n);
+  }
+
+  void give_back(size_t index, FreeList& src, size_t n) noexcept {
+    std::lock_guard<std::mutex> guard(mutexes_[index]);
+    src.transfer_to(lists_[index], n);
+  }
+
+  void give_back(size_t index, void* ptr) noexcept {
+    std::lock_guard<std::mutex> guard(mutexes_[index]);
+    lists_[index].push(ptr);
+  }
+
+ private:
+  Depot() = default;
+
+  static void carve_slab(size_t index, FreeList& list) {
+    const size_t size = slot_size(index);
+    auto* slab = static_cast<char*>(::operator new(
+        SlabPool::kSlabSize, std::align_val_t(kSlabAlignment)));
+    const size_t num_slots = SlabPool::kSlabSize / size;
+    // push in reverse so that the slots are handed out in address order
+    for (size_t i = num_slots; i-- > 0;) {
+      list.push(slab + i * size);
+    }
+  }
+
+  std::array<std::mutex, SlabPool::kNumSizeClasses> mutexes_;
+  std::array<FreeList, SlabPool::kNumSizeClasses> lists_;
+};
+
+enum class CacheState : uint8_t { Unregistered, Live, Dead };
+
+// The per-thread free lists are trivially destructible so that reaching them
+// on the fast path is a plain TLS access without a lazy-init guard. A separate
+// thread_local with a destructor (registered on first use) hands the cached
+// slots to the depot when the thread exits; deallocations that happen after
+// that go straight to the depot.
+struct ThreadCache {
+  std::array<FreeList, SlabPool::kNumSizeClasses> lists;
+  CacheState state;
+};
+
+thread_local ThreadCache tls_cache{};
+
+struct ThreadCacheFlusher final {
+  ~ThreadCacheFlusher() {
+    tls_cache.state = CacheState::Dead;
+    auto& depot = Depot::get();
+    for (size_t i = 0; i < tls_cache.lists.size(); ++i) {
+      FreeList& list = tls_cache.lists[i];
+      if (list.count > 0) {
+        depot.give_back(i, list, list.count);
+      }
+    }
+  }
+};
+
+void register_thread_cache() {
+  thread_local ThreadCacheFlusher flusher;
+  (void)flusher;
+  tls_cache.state = CacheState::Live;
+}
+
+} // namespace
+
+void* SlabPool::allocate(size_t nbytes) {
+  if (UNLIKELY(nbytes > kMaxSlotSize)) {
+    return ::operator new(nbytes);
+  }
+  const size_t index = size_class_index(nbytes);
+  FreeList& list = tls_cache.lists[index];
+  if (UNLIKELY(list.head == nullptr)) {
+    if (tls_cache.state == CacheState::Dead) {
+      FreeList single;
+      Depot::get().refill(index, single, 1);
+      return single.pop();
+    }
+    if (tls_cache.state == CacheState::Unregistered) {
+      register_thread_cache();
+    }
+    Depot::get().refill(index, list, kRefillSlots);
+  }
+  return list.pop();
+}
+
+void SlabPool::deallocate(void* ptr, size_t nbytes) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  if (UNLIKELY(nbytes > kMaxSlotSize)) {
+    ::operator delete(ptr);
+    return;
+  }
+  const size_t index = size_class_index(nbytes);
+  if (UNLIKELY(tls_cache.state != CacheState::Live)) {
+    if (tls_cache.state == CacheState::Dead) {
+      Depot::get().give_back(index, ptr);
+      return;
+    }
+    register_thread_cache();
+  }
+  FreeList& list = tls_cache.lists[index];
+  list.push(ptr);
+  if (UNLIKELY(list.count > kMaxCachedSlots)) {
+    Depot::get().give_back(index, list, kMaxCachedSlots / 2);
+  }
+}
+
+size_t SlabPool::cached_slots(size_t nbytes) noexcept {
+  if (nbytes > kMaxSlotSize) {
+    return 0;
+  }
+  return tls_cache.lists[size_class_index(nbytes)].count;
+}
+
+} // namespace c10
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <c10/util/Macros.h>
+
+#include <cstddef>
+#include <new>
+
+namespace c10 {
+
+// A size-classed pool for small objects that are created and destroyed at a
+// high rate (StorageImpl, TensorImpl, ...).
+//
+// Memory is carved out of 64KB slabs into fixed-size slots, one size class per
+// 16 bytes up to kMaxSlotSize. Every thread keeps its own free list per size
+// class, so the common allocate/deallocate pair is a pointer pop/push without
+// any locking. A slot freed on another thread simply lands in that thread's
+// cache; caches that grow past kMaxCachedSlots hand half of their slots back to
+// a global depot, which also adopts the whole cache when a thread exits.
+//
+// Slabs are never returned to the system: the pool retains its peak size.
+// Requests larger than kMaxSlotSize fall through to the global operator new.
+class C10_API SlabPool final {
+ public:
+  static constexpr size_t kSlotAlignment = 16;
+  static constexpr size_t kMaxSlotSize = 1024;
+  static constexpr size_t kSlabSize = 64 * 1024;
+  static constexpr size_t kNumSizeClasses = kMaxSlotSize / kSlotAlignment;
+  static constexpr size_t kMaxCachedSlots = 512;
+
+  static void* allocate(size_t nbytes);
+  static void deallocate(void* ptr, size_t nbytes) noexcept;
+
+  // number of slots of the size class serving `nbytes` that sit in the
+  // calling thread's cache, exposed for tests
+  static size_t cached_slots(size_t nbytes) noexcept;
+};
+
+} // namespace c10
+
+// Route `new T(...)` (and therefore c10::make_intrusive<T>) and the final
+// `delete` issued by intrusive_ptr through c10::SlabPool. The sized operator
+// delete receives sizeof() of the dynamic type thanks to the virtual
+// destructor of intrusive_ptr_target, so subclasses are pooled by their own
+// size class without redeclaring anything.
+#define C10_SLAB_POOLED_ALLOCATION                          \
+  static void* operator new(size_t nbytes) {                \
+    return ::c10::SlabPool::allocate(nbytes);               \
+  }                                                         \
+  static void operator delete(void* ptr, size_t nbytes) {   \
+    ::c10::SlabPool::deallocate(ptr, nbytes);               \
+  }
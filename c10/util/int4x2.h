@@ -0,0 +1,31 @@
+#pragma once
+
+#include <c10/util/Macros.h>
+
+#include <cstdint>
+
+namespace c10 {
+
+// The storage unit of Int4 tensors: two signed 4-bit integers in [-8, 7],
+// two's complement, packed in one byte with the element of even index in
+// the low nibble. An Int4 tensor of numel elements is stored in
+// (numel + 1) / 2 bytes (see elementBits() in ScalarType.h). Like the
+// Float8 types it is only stored; kernels decode the nibbles.
+struct alignas(1) int4x2 {
+  uint8_t val_;
+
+  int4x2() = default;
+  C10_HOST_DEVICE explicit int4x2(uint8_t val) : val_(val) {}
+
+  // the element of even index
+  C10_HOST_DEVICE int8_t lo() const {
+    return static_cast<int8_t>(static_cast<uint8_t>(val_ << 4)) >> 4;
+  }
+
+  // the element of odd index
+  C10_HOST_DEVICE int8_t hi() const {
+    return static_cast<int8_t>(val_) >> 4;
+  }
+};
+
+} // namespace c10
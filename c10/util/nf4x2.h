@@ -0,0 +1,66 @@
+#pragma once
+
+#include <c10/util/Macros.h>
+
+#include <cstdint>
+
+// NF4, the 4-bit NormalFloat of QLoRA (Dettmers et al., "QLoRA: Efficient
+// Finetuning of Quantized LLMs"): a code in [0, 16) stands for one of the
+// 16 values below, the quantiles of a standard normal distribution scaled
+// to [-1, 1] with an exact zero. Weights, roughly normal, use the codes
+// evenly once divided by the largest magnitude of their group, the scale
+// the code is multiplied by again when decoding.
+
+namespace c10 {
+
+constexpr float kNF4Values[16] = {
+    -1.0f,
+    -0.6961928009986877f,
+    -0.5250730514526367f,
+    -0.39491748809814453f,
+    -0.28444138169288635f,
+    -0.18477343022823334f,
+    -0.09105003625154495f,
+    0.0f,
+    0.07958029955625534f,
+    0.16093020141124725f,
+    0.24611230194568634f,
+    0.33791524171829224f,
+    0.44070982933044434f,
+    0.5626170039176941f,
+    0.7229568362236023f,
+    1.0f,
+};
+
+// the code of the value nearest to x, which is clamped to [-1, 1]; NaN
+// encodes to an unspecified code
+inline uint8_t nf4_code(float x) {
+  uint8_t code = 0;
+  for (int i = 0; i < 15; ++i) {
+    // the midpoint between values i and i + 1
+    code += x > 0.5f * (kNF4Values[i] + kNF4Values[i + 1]);
+  }
+  return code;
+}
+
+// The storage unit of NF4 tensors: two codes packed in one byte with the
+// element of even index in the low nibble, stored like int4x2 (see
+// int4x2.h).
+struct alignas(1) nf4x2 {
+  uint8_t val_;
+
+  nf4x2() = default;
+  C10_HOST_DEVICE explicit nf4x2(uint8_t val) : val_(val) {}
+
+  // the code of the element of even index
+  C10_HOST_DEVICE uint8_t lo() const {
+    return val_ & 0xF;
+  }
+
+  // the code of the element of odd index
+  C10_HOST_DEVICE uint8_t hi() const {
+    return val_ >> 4;
+  }
+};
+
+} // namespace c10
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <c10/util/Macros.h>
+
+#include <cstdint>
+
+namespace c10 {
+
+// The element type of QInt32 tensors, a 32-bit qint8 (see qint8.h), e.g.
+// the accumulators of an int8 product or its bias.
+struct alignas(4) qint32 {
+  using underlying = int32_t;
+  int32_t val_;
+
+  qint32() = default;
+  C10_HOST_DEVICE explicit qint32(int32_t val) : val_(val) {}
+};
+
+} // namespace c10
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <c10/util/Macros.h>
+
+#include <cstdint>
+
+namespace c10 {
+
+// The element type of QInt8 tensors: a signed 8-bit integer q standing for
+// the real value (q - zero_point) * scale, with the scale and zero point
+// held by the tensor's quantizer (see ATen/quantized/Quantizer.h). There is
+// no arithmetic on it, kernels work on `underlying`.
+struct alignas(1) qint8 {
+  using underlying = int8_t;
+  int8_t val_;
+
+  qint8() = default;
+  C10_HOST_DEVICE explicit qint8(int8_t val) : val_(val) {}
+};
+
+} // namespace c10
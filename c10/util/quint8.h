@@ -0,0 +1,18 @@
+#pragma once
+
+#include <c10/util/Macros.h>
+
+#include <cstdint>
+
+namespace c10 {
+
+// The element type of QUInt8 tensors, an unsigned qint8 (see qint8.h).
+struct alignas(1) quint8 {
+  using underlying = uint8_t;
+  uint8_t val_;
+
+  quint8() = default;
+  C10_HOST_DEVICE explicit quint8(uint8_t val) : val_(val) {}
+};
+
+} // namespace c10
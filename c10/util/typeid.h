@@ -8,5 +8,22 @@ class C10_API TypeMeta final {
   TypeMeta() : type(c10::ScalarType::Undefined) {}
 
   TypeMeta(c10::ScalarType scalar_type) : type(scalar_type) {}
+
+  size_t itemsize() const {
+    return c10::elementSize(type);
+  }
+
+  c10::ScalarType toScalarType() const noexcept {
+    return type;
+  }
+
+  bool operator==(const TypeMeta& rhs) const noexcept {
+    return type == rhs.type;
+  }
+
+  bool operator!=(const TypeMeta& rhs) const noexcept {
+    return type != rhs.type;
+  }
+
   c10::ScalarType type;
 };
@@ -0,0 +1,245 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/CPUBlas.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "test_helpers.h"
+
+using at::test::at_index;
+using at::test::bitwise_equal;
+using at::test::randu;
+
+namespace {
+
+void expect_mm_near(const at::Tensor& a, const at::Tensor& b, double tol) {
+  at::Tensor c = a.mm(b);
+  ASSERT_EQ(c.size(0), a.size(0));
+  ASSERT_EQ(c.size(1), b.size(1));
+  ASSERT_EQ(c.scalar_type(), a.scalar_type());
+  for (int64_t i = 0; i < a.size(0); ++i) {
+    for (int64_t j = 0; j < b.size(1); ++j) {
+      double expected = 0;
+      for (int64_t p = 0; p < a.size(1); ++p) {
+        expected += at_index(a, {i, p}) * at_index(b, {p, j});
+      }
+      ASSERT_NEAR(at_index(c, {i, j}), expected, tol)
+          << "at (" << i << ", " << j << ") of " << a.size(0) << "x"
+          << a.size(1) << " @ " << b.size(0) << "x" << b.size(1);
+    }
+  }
+}
+
+} // namespace
+
+TEST(BlasTest, mm_matches_reference) {
+  // {m, k, n}: single elements, edge tiles, several blocks along k, more
+  // than a panel of rows, more than a block of columns
+  const std::vector<std::array<int64_t, 3>> shapes = {
+      {1, 1, 1},
+      {5, 7, 3},
+      {13, 300, 37},
+      {600, 10, 20},
+      {14, 3, 4100},
+      {64, 70, 50}};
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float, at::ScalarType::Double}) {
+    for (const auto& [m, k, n] : shapes) {
+      expect_mm_near(randu({m, k}, dtype, 1), randu({k, n}, dtype, 2), 1e-4);
+    }
+  }
+}
+
+TEST(BlasTest, mm_reads_strided_operands_in_place) {
+  at::Tensor a = randu({40, 30}, at::ScalarType::Float, 1);
+  at::Tensor b = randu({50, 40}, at::ScalarType::Float, 2);
+  // transposed, sliced with a step, and both
+  expect_mm_near(a.t(), b.t(), 1e-4);
+  expect_mm_near(
+      a.slice(1, 0, 30, 2), b.slice(0, 0, 15).slice(1, 5, 45), 1e-4);
+  expect_mm_near(
+      b.slice(0, 10, 40, 3).t().slice(1, 0, 8), a.slice(0, 0, 8), 1e-4);
+}
+
+TEST(BlasTest, skinny_products) {
+  // few rows of A stream B instead of packing it, by rows or by columns
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float,
+        at::ScalarType::Half,
+        at::ScalarType::BFloat16}) {
+    const double tol = dtype == at::ScalarType::Half ? 1e-2
+        : dtype == at::ScalarType::BFloat16          ? 1e-1
+                                                     : 1e-4;
+    at::Tensor b = randu({300, 70}, dtype, 2);
+    at::Tensor b_t = randu({70, 300}, dtype, 3);
+    for (int64_t m : {1, 5, 12}) {
+      at::Tensor a = randu({m, 300}, dtype, 1);
+      expect_mm_near(a, b, tol);
+      expect_mm_near(a, b_t.t(), tol);
+      expect_mm_near(randu({300, m}, dtype, 4).t(), b, tol);
+    }
+  }
+}
+
+TEST(BlasTest, half_accumulates_in_float) {
+  constexpr int64_t k = 3000;
+  at::Tensor a = at::empty({2, k}, at::ScalarType::Half);
+  a.fill_(1);
+  at::Tensor b = at::empty({k, 3}, at::ScalarType::Half);
+  b.fill_(1);
+  at::Tensor c = a.mm(b);
+  ASSERT_EQ(c.scalar_type(), at::ScalarType::Half);
+  for (int64_t i = 0; i < c.numel(); ++i) {
+    // a Half accumulator would get stuck at 2048
+    ASSERT_EQ(static_cast<float>(c.const_data_ptr<c10::Half>()[i]), 3000.f);
+  }
+  expect_mm_near(
+      randu({9, 40}, at::ScalarType::Half, 1).t(),
+      randu({9, 70}, at::ScalarType::Half, 2),
+      1e-2);
+}
+
+TEST(BlasTest, bfloat16_accumulates_in_float) {
+  constexpr int64_t k = 3000;
+  at::Tensor a = at::empty({2, k}, at::ScalarType::BFloat16);
+  a.fill_(1);
+  at::Tensor b = at::empty({k, 3}, at::ScalarType::BFloat16);
+  b.fill_(1);
+  at::Tensor c = a.mm(b);
+  ASSERT_EQ(c.scalar_type(), at::ScalarType::BFloat16);
+  for (int64_t i = 0; i < c.numel(); ++i) {
+    // a BFloat16 accumulator would get stuck at 256, 3000 rounds to 3008
+    ASSERT_EQ(
+        static_cast<float>(c.const_data_ptr<c10::BFloat16>()[i]), 3008.f);
+  }
+}
+
+TEST(BlasTest, gemm_alpha_beta_and_strided_c) {
+  constexpr int64_t m = 7, n = 33, k = 260;
+  at::Tensor a = randu({m, k}, at::ScalarType::Float, 1);
+  at::Tensor b = randu({k, n}, at::ScalarType::Float, 2);
+  at::Tensor ab = a.mm(b);
+  for (double beta : {0., 0.5}) {
+    // column-major C
+    at::Tensor c = randu({n, m}, at::ScalarType::Float, 3).t();
+    at::Tensor c0 = randu({n, m}, at::ScalarType::Float, 3).t();
+    if (beta == 0) {
+      c.fill_(std::numeric_limits<double>::quiet_NaN());
+    }
+    at::native::cpublas::GemmParams params;
+    params.m = m;
+    params.n = n;
+    params.k = k;
+    params.alpha = 2;
+    params.beta = beta;
+    params.a = a.const_data_ptr();
+    params.a_row_stride = a.stride(0);
+    params.a_col_stride = a.stride(1);
+    params.b = b.const_data_ptr();
+    params.b_row_stride = b.stride(0);
+    params.b_col_stride = b.stride(1);
+    params.c = c.mutable_data_ptr();
+    params.c_row_stride = c.stride(0);
+    params.c_col_stride = c.stride(1);
+    at::native::cpublas::gemm(params);
+    for (int64_t i = 0; i < m; ++i) {
+      for (int64_t j = 0; j < n; ++j) {
+        ASSERT_NEAR(
+            at_index(c, {i, j}),
+            2 * at_index(ab, {i, j}) + beta * at_index(c0, {i, j}),
+            1e-4);
+      }
+    }
+  }
+}
+
+TEST(BlasTest, empty_and_degenerate_shapes) {
+  at::Tensor c = at::empty({3, 0}).mm(at::empty({0, 4}));
+  ASSERT_EQ(c.size(0), 3);
+  ASSERT_EQ(c.size(1), 4);
+  for (int64_t i = 0; i < c.numel(); ++i) {
+    ASSERT_EQ(c.const_data_ptr<float>()[i], 0.f);
+  }
+  ASSERT_EQ(at::empty({0, 5}).mm(at::empty({5, 2})).numel(), 0);
+}
+
+TEST(BlasTest, results_do_not_depend_on_thread_count) {
+  // {m, k, n}, the second one skinny
+  for (const auto& [m, k, n] : {std::array<int64_t, 3>{100, 90, 80},
+                                std::array<int64_t, 3>{4, 300, 2000}}) {
+    at::Tensor a = randu({m, k}, at::ScalarType::Float, 1);
+    at::Tensor b = randu({k, n}, at::ScalarType::Float, 2);
+    at::set_num_threads(1);
+    at::Tensor expected = a.mm(b);
+    for (int threads : {2, 3, 8}) {
+      at::set_num_threads(threads);
+      ASSERT_TRUE(bitwise_equal(a.mm(b), expected)) << threads << " threads";
+    }
+  }
+  at::set_num_threads(1);
+}
+
+TEST(BlasTest, mm_checks_arguments) {
+  ASSERT_THROW(at::empty({2, 3}).mm(at::empty({4, 2})), c10::Error);
+  ASSERT_THROW(at::empty({2, 3, 1}).mm(at::empty({3, 2})), c10::Error);
+  ASSERT_THROW(
+      at::empty({2, 3}).mm(at::empty({3, 2}, at::ScalarType::Double)),
+      c10::Error);
+  ASSERT_THROW(
+      at::empty({2, 3}, at::ScalarType::Int)
+          .mm(at::empty({3, 2}, at::ScalarType::Int)),
+      c10::Error);
+}
+
+TEST(BlasTest, scaled_mm_matches_dequantized_reference) {
+  // {m, k, n}: skinny and packed paths, edge tiles
+  const std::vector<std::array<int64_t, 3>> shapes = {
+      {1, 300, 70}, {5, 64, 33}, {40, 90, 50}};
+  for (at::ScalarType b_dtype :
+       {at::ScalarType::Float8_e4m3fn, at::ScalarType::Float8_e5m2}) {
+    for (at::ScalarType dtype :
+         {at::ScalarType::Float, at::ScalarType::Half}) {
+      const double tol = dtype == at::ScalarType::Half ? 1e-2 : 1e-4;
+      for (const auto& [m, k, n] : shapes) {
+        at::Tensor b = randu({k, n}, at::ScalarType::Float, 2);
+        const double scale = at::float8_scale(b, b_dtype);
+        at::Tensor q = at::to_float8(b, b_dtype, scale);
+        // contiguous, so that q_t.t() is B read by columns
+        at::Tensor q_t = at::to_float8(b.t(), b_dtype, scale);
+        at::Tensor a = randu({m, k}, dtype, 1);
+        // the reference multiplies by exactly the values scaled_mm reads
+        at::Tensor expected = at::from_float8(q, scale, dtype);
+        at::Tensor c = at::scaled_mm(a, q, scale);
+        at::Tensor c_t = at::scaled_mm(a, q_t.t(), scale);
+        at::Tensor reference = a.mm(expected);
+        ASSERT_EQ(c.scalar_type(), dtype);
+        for (int64_t i = 0; i < m; ++i) {
+          for (int64_t j = 0; j < n; ++j) {
+            ASSERT_NEAR(at_index(c, {i, j}), at_index(reference, {i, j}), tol)
+                << b_dtype << " " << m << "x" << k << "x" << n;
+            ASSERT_NEAR(at_index(c_t, {i, j}), at_index(reference, {i, j}), tol)
+                << b_dtype << " " << m << "x" << k << "x" << n;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(BlasTest, scaled_mm_checks_arguments) {
+  at::Tensor a = at::empty({2, 3});
+  at::Tensor q = at::to_float8(
+      at::empty({3, 2}).fill_(1), at::ScalarType::Float8_e4m3fn, 1);
+  ASSERT_THROW(at::scaled_mm(a, at::empty({3, 2}), 1), c10::Error);
+  ASSERT_THROW(at::scaled_mm(a, q.t(), 1), c10::Error);
+  ASSERT_THROW(
+      at::scaled_mm(a, q, std::numeric_limits<double>::infinity()),
+      c10::Error);
+  ASSERT_THROW(
+      at::scaled_mm(at::empty({2, 3}, at::ScalarType::Int), q, 1),
+      c10::Error);
+}
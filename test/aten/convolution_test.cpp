@@ -0,0 +1,426 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/Convolution.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include "test_helpers.h"
+
+using at::native::ConvAlgorithm;
+using at::test::at_index;
+using at::test::bitwise_equal;
+using at::test::randu;
+
+namespace {
+
+at::Tensor as_5d(at::Tensor t) {
+  while (t.dim() < 5) {
+    t = t.unsqueeze(2);
+  }
+  return t;
+}
+
+struct Conv {
+  std::vector<int64_t> stride{1};
+  std::vector<int64_t> padding{0};
+  std::vector<int64_t> dilation{1};
+  int64_t groups = 1;
+};
+
+// stride, padding or dilation for dim d of the 5-D view of a convolution
+// with the given number of spatial dims; d is one of the trailing ones
+int64_t param(const std::vector<int64_t>& value, int64_t spatial, int64_t d) {
+  return value.size() == 1 ? value[0] : value[d - (3 - spatial)];
+}
+
+// checks the output against a direct evaluation in double
+void expect_conv_near(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const std::optional<at::Tensor>& bias,
+    const Conv& conv,
+    std::optional<ConvAlgorithm> algorithm,
+    double tol) {
+  const at::Tensor output = algorithm.has_value()
+      ? at::native::convolution_with_algorithm(
+            input,
+            weight,
+            bias,
+            conv.stride,
+            conv.padding,
+            conv.dilation,
+            conv.groups,
+            *algorithm)
+      : at::convolution(
+            input,
+            weight,
+            bias,
+            conv.stride,
+            conv.padding,
+            conv.dilation,
+            conv.groups);
+  ASSERT_EQ(output.dim(), input.dim());
+  ASSERT_EQ(output.scalar_type(), input.scalar_type());
+  const int64_t spatial = input.dim() - 2;
+  const at::Tensor in = as_5d(input);
+  const at::Tensor w = as_5d(weight);
+  const at::Tensor out = as_5d(output);
+  std::array<int64_t, 3> stride{1, 1, 1}, padding{0, 0, 0};
+  std::array<int64_t, 3> dilation{1, 1, 1};
+  for (int64_t d = 3 - spatial; d < 3; ++d) {
+    stride[d] = param(conv.stride, spatial, d);
+    padding[d] = param(conv.padding, spatial, d);
+    dilation[d] = param(conv.dilation, spatial, d);
+  }
+  ASSERT_EQ(out.size(0), in.size(0));
+  ASSERT_EQ(out.size(1), w.size(0));
+  for (int64_t d = 0; d < 3; ++d) {
+    ASSERT_EQ(
+        out.size(d + 2),
+        (in.size(d + 2) + 2 * padding[d] - dilation[d] * (w.size(d + 2) - 1) -
+         1) / stride[d] +
+            1);
+  }
+  const int64_t cin_g = w.size(1);
+  const int64_t cout_g = w.size(0) / conv.groups;
+  for (int64_t n = 0; n < out.size(0); ++n) {
+    for (int64_t co = 0; co < out.size(1); ++co) {
+      const int64_t g = co / cout_g;
+      for (int64_t z = 0; z < out.size(2); ++z) {
+        for (int64_t y = 0; y < out.size(3); ++y) {
+          for (int64_t x = 0; x < out.size(4); ++x) {
+            double expected = bias.has_value()
+                ? at_index(bias->view({1, -1, 1, 1, 1}), {0, co, 0, 0, 0})
+                : 0;
+            for (int64_t ci = 0; ci < cin_g; ++ci) {
+              for (int64_t a = 0; a < w.size(2); ++a) {
+                for (int64_t b = 0; b < w.size(3); ++b) {
+                  for (int64_t c = 0; c < w.size(4); ++c) {
+                    const int64_t i = z * stride[0] - padding[0] +
+                        a * dilation[0];
+                    const int64_t j = y * stride[1] - padding[1] +
+                        b * dilation[1];
+                    const int64_t l = x * stride[2] - padding[2] +
+                        c * dilation[2];
+                    if (i < 0 or i >= in.size(2) or j < 0 or
+                        j >= in.size(3) or l < 0 or l >= in.size(4)) {
+                      continue;
+                    }
+                    expected += at_index(in, {n, g * cin_g + ci, i, j, l}) *
+                        at_index(w, {co, ci, a, b, c});
+                  }
+                }
+              }
+            }
+            ASSERT_NEAR(at_index(out, {n, co, z, y, x}), expected, tol)
+                << "at (" << n << ", " << co << ", " << z << ", " << y
+                << ", " << x << ")";
+          }
+        }
+      }
+    }
+  }
+}
+
+double tolerance(at::ScalarType dtype) {
+  return dtype == at::ScalarType::Half ? 2e-2 : 1e-4;
+}
+
+at::MemoryFormat channels_last(int64_t dim) {
+  return dim == 5 ? at::MemoryFormat::ChannelsLast3d
+                  : at::MemoryFormat::ChannelsLast;
+}
+
+// an N x C x L input laid out N x L x C
+at::Tensor channels_last_1d(int64_t n, int64_t c, int64_t l, uint32_t seed) {
+  return randu({n, l, c}, at::ScalarType::Float, seed).transpose(1, 2);
+}
+
+} // namespace
+
+TEST(ConvolutionTest, im2col_matches_reference) {
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float, at::ScalarType::Double, at::ScalarType::Half}) {
+    const double tol = tolerance(dtype);
+    for (bool cl : {false, true}) {
+      auto layout = [&](int64_t dim) {
+        return cl ? channels_last(dim) : at::MemoryFormat::Contiguous;
+      };
+      // 2-D: strided, padded, dilated, grouped, with a bias
+      expect_conv_near(
+          randu({2, 6, 11, 9}, dtype, 1, layout(4)),
+          randu({4, 3, 3, 2}, dtype, 2),
+          randu({4}, dtype, 3),
+          {{2, 1}, {1, 2}, {1, 2}, 2},
+          ConvAlgorithm::Im2col,
+          tol);
+      // 3-D
+      expect_conv_near(
+          randu({1, 3, 5, 6, 7}, dtype, 1, layout(5)),
+          randu({5, 3, 2, 3, 3}, dtype, 2),
+          std::nullopt,
+          {{1, 2, 1}, {1}, {1}, 1},
+          ConvAlgorithm::Im2col,
+          tol);
+      // 1-D
+      expect_conv_near(
+          randu({3, 4, 20}, dtype, 1),
+          randu({8, 4, 5}, dtype, 2),
+          randu({8}, dtype, 3),
+          {{3}, {2}, {1}, 1},
+          ConvAlgorithm::Im2col,
+          tol);
+      // 1x1 with a stride, which is not pointwise
+      expect_conv_near(
+          randu({2, 6, 9, 8}, dtype, 1, layout(4)),
+          randu({5, 6, 1, 1}, dtype, 2),
+          randu({5}, dtype, 3),
+          {{2}, {0}, {1}, 1},
+          ConvAlgorithm::Im2col,
+          tol);
+      // a channels-last weight
+      expect_conv_near(
+          randu({2, 8, 7, 7}, dtype, 1, layout(4)),
+          randu({16, 8, 3, 3}, dtype, 2, channels_last(4)),
+          std::nullopt,
+          {{1}, {1}, {1}, 1},
+          ConvAlgorithm::Im2col,
+          tol);
+    }
+  }
+  expect_conv_near(
+      channels_last_1d(2, 6, 15, 1),
+      randu({4, 3, 3}, at::ScalarType::Float, 2),
+      std::nullopt,
+      {{2}, {1}, {2}, 2},
+      ConvAlgorithm::Im2col,
+      1e-4);
+}
+
+TEST(ConvolutionTest, direct_depthwise_matches_reference) {
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float, at::ScalarType::Double, at::ScalarType::Half}) {
+    const double tol = tolerance(dtype);
+    for (at::MemoryFormat layout :
+         {at::MemoryFormat::Contiguous, at::MemoryFormat::ChannelsLast}) {
+      // one and two output channels per input channel
+      for (int64_t multiplier : {1, 2}) {
+        expect_conv_near(
+            randu({2, 20, 13, 30}, dtype, 1, layout),
+            randu({20 * multiplier, 1, 3, 3}, dtype, 2),
+            randu({20 * multiplier}, dtype, 3),
+            {{1}, {1}, {1}, 20},
+            ConvAlgorithm::Direct,
+            tol);
+        expect_conv_near(
+            randu({1, 12, 17, 19}, dtype, 1, layout),
+            randu({12 * multiplier, 1, 5, 3}, dtype, 2),
+            std::nullopt,
+            {{2, 3}, {2, 0}, {1, 2}, 12},
+            ConvAlgorithm::Direct,
+            tol);
+      }
+    }
+  }
+  expect_conv_near(
+      channels_last_1d(2, 9, 40, 1),
+      randu({9, 1, 7}, at::ScalarType::Float, 2),
+      std::nullopt,
+      {{1}, {3}, {1}, 9},
+      ConvAlgorithm::Direct,
+      1e-4);
+  expect_conv_near(
+      randu({1, 4, 4, 5, 6}, at::ScalarType::Float, 1, channels_last(5)),
+      randu({4, 1, 3, 3, 3}, at::ScalarType::Float, 2),
+      std::nullopt,
+      {{1}, {1}, {1}, 4},
+      ConvAlgorithm::Direct,
+      1e-4);
+}
+
+TEST(ConvolutionTest, direct_pointwise_matches_reference) {
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float, at::ScalarType::Double, at::ScalarType::Half}) {
+    const double tol = tolerance(dtype);
+    for (at::MemoryFormat layout :
+         {at::MemoryFormat::Contiguous, at::MemoryFormat::ChannelsLast}) {
+      for (int64_t groups : {1, 2}) {
+        expect_conv_near(
+            randu({3, 16, 9, 10}, dtype, 1, layout),
+            randu({24, 16 / groups, 1, 1}, dtype, 2),
+            randu({24}, dtype, 3),
+            {{1}, {0}, {1}, groups},
+            ConvAlgorithm::Direct,
+            tol);
+      }
+    }
+  }
+  expect_conv_near(
+      channels_last_1d(2, 8, 30, 1),
+      randu({5, 8, 1}, at::ScalarType::Float, 2),
+      std::nullopt,
+      {{1}, {0}, {1}, 1},
+      ConvAlgorithm::Direct,
+      1e-4);
+}
+
+TEST(ConvolutionTest, winograd_matches_reference) {
+  for (ConvAlgorithm algorithm :
+       {ConvAlgorithm::Winograd2x3, ConvAlgorithm::Winograd4x3}) {
+    for (at::ScalarType dtype :
+         {at::ScalarType::Float, at::ScalarType::Double}) {
+      // F(4x4) in float loses a few more bits in its transforms
+      const double tol = dtype == at::ScalarType::Float ? 1e-3 : 1e-9;
+      for (at::MemoryFormat layout :
+           {at::MemoryFormat::Contiguous, at::MemoryFormat::ChannelsLast}) {
+        // sizes that are not a multiple of the tile, with and without
+        // padding
+        expect_conv_near(
+            randu({2, 7, 13, 10}, dtype, 1, layout),
+            randu({9, 7, 3, 3}, dtype, 2),
+            randu({9}, dtype, 3),
+            {{1}, {1}, {1}, 1},
+            algorithm,
+            tol);
+        expect_conv_near(
+            randu({1, 20, 9, 15}, dtype, 1, layout),
+            randu({17, 20, 3, 3}, dtype, 2),
+            std::nullopt,
+            {{1}, {0, 2}, {1}, 1},
+            algorithm,
+            tol);
+      }
+    }
+  }
+}
+
+TEST(ConvolutionTest, output_follows_the_input_layout) {
+  at::Tensor input =
+      randu({2, 16, 12, 12}, at::ScalarType::Float, 1,
+            at::MemoryFormat::ChannelsLast);
+  for (const at::Tensor& weight :
+       {randu({32, 16, 3, 3}), randu({32, 16, 1, 1}), randu({16, 1, 3, 3})}) {
+    const int64_t groups = weight.size(1) == 1 ? 16 : 1;
+    at::Tensor output =
+        at::conv2d(input, weight, std::nullopt, 1, 1, 1, groups);
+    ASSERT_TRUE(output.is_contiguous(at::MemoryFormat::ChannelsLast));
+    output = at::conv2d(
+        randu({2, 16, 12, 12}), weight, std::nullopt, 1, 1, 1, groups);
+    ASSERT_TRUE(output.is_contiguous());
+  }
+}
+
+TEST(ConvolutionTest, selects_the_algorithm_from_the_shapes) {
+  auto select = [](const at::Tensor& input,
+                   const at::Tensor& weight,
+                   int64_t stride,
+                   int64_t groups) {
+    return at::native::select_conv_algorithm(
+        input, weight, stride, 1, 1, groups);
+  };
+  const at::Tensor input = randu({1, 32, 56, 56});
+  EXPECT_EQ(select(input, randu({32, 1, 3, 3}), 1, 32), ConvAlgorithm::Direct);
+  EXPECT_EQ(
+      at::native::select_conv_algorithm(
+          input, randu({64, 32, 1, 1}), 1, 0, 1, 1),
+      ConvAlgorithm::Direct);
+  EXPECT_EQ(
+      select(input, randu({64, 32, 3, 3}), 1, 1), ConvAlgorithm::Winograd4x3);
+  // too few tiles, unless batched
+  EXPECT_EQ(
+      select(randu({1, 32, 28, 28}), randu({64, 32, 3, 3}), 1, 1),
+      ConvAlgorithm::Im2col);
+  EXPECT_EQ(
+      select(randu({4, 32, 28, 28}), randu({64, 32, 3, 3}), 1, 1),
+      ConvAlgorithm::Winograd4x3);
+  EXPECT_EQ(
+      select(input, randu({64, 32, 3, 3}), 2, 1), ConvAlgorithm::Im2col);
+  EXPECT_EQ(
+      select(randu({1, 3, 56, 56}), randu({64, 3, 3, 3}), 1, 1),
+      ConvAlgorithm::Im2col);
+  EXPECT_EQ(
+      select(
+          randu({1, 32, 56, 56}, at::ScalarType::Half),
+          randu({64, 32, 3, 3}, at::ScalarType::Half),
+          1,
+          1),
+      ConvAlgorithm::Im2col);
+  // remembered
+  EXPECT_EQ(
+      select(input, randu({64, 32, 3, 3}), 1, 1), ConvAlgorithm::Winograd4x3);
+}
+
+TEST(ConvolutionTest, reads_strided_inputs) {
+  // neither contiguous nor channels-last
+  at::Tensor input = randu({2, 8, 20, 20}).slice(2, 0, 20, 2).slice(3, 1, 19);
+  for (int64_t groups : {1, 8}) {
+    expect_conv_near(
+        input,
+        randu({8, 8 / groups, 3, 3}, at::ScalarType::Float, 2),
+        std::nullopt,
+        {{1}, {1}, {1}, groups},
+        std::nullopt,
+        1e-4);
+  }
+  expect_conv_near(
+      input,
+      randu({6, 8, 1, 1}, at::ScalarType::Float, 2),
+      std::nullopt,
+      {{1}, {0}, {1}, 1},
+      std::nullopt,
+      1e-4);
+}
+
+TEST(ConvolutionTest, results_do_not_depend_on_thread_count) {
+  const at::Tensor input = randu({2, 32, 30, 30}, at::ScalarType::Float, 1);
+  const at::Tensor weight = randu({48, 32, 3, 3}, at::ScalarType::Float, 2);
+  for (ConvAlgorithm algorithm :
+       {ConvAlgorithm::Im2col,
+        ConvAlgorithm::Winograd2x3,
+        ConvAlgorithm::Winograd4x3}) {
+    at::set_num_threads(1);
+    const at::Tensor expected = at::native::convolution_with_algorithm(
+        input, weight, std::nullopt, 1, 1, 1, 1, algorithm);
+    for (int threads : {2, 3, 8}) {
+      at::set_num_threads(threads);
+      ASSERT_TRUE(bitwise_equal(
+          at::native::convolution_with_algorithm(
+              input, weight, std::nullopt, 1, 1, 1, 1, algorithm),
+          expected))
+          << at::native::toString(algorithm) << ", " << threads
+          << " threads";
+    }
+  }
+  at::set_num_threads(1);
+}
+
+TEST(ConvolutionTest, checks_arguments) {
+  const at::Tensor input = randu({1, 4, 8, 8});
+  // channels, groups, kernel larger than the input, bias
+  ASSERT_THROW(at::conv2d(input, randu({2, 3, 3, 3})), c10::Error);
+  ASSERT_THROW(
+      at::conv2d(input, randu({3, 2, 3, 3}), std::nullopt, 1, 0, 1, 2),
+      c10::Error);
+  ASSERT_THROW(at::conv2d(input, randu({2, 4, 9, 3})), c10::Error);
+  ASSERT_THROW(at::conv2d(input, randu({2, 4, 3, 3}), randu({3})), c10::Error);
+  ASSERT_THROW(
+      at::conv2d(input, randu({2, 4, 3, 3}), std::nullopt, {1, 1, 1}),
+      c10::Error);
+  ASSERT_THROW(at::conv1d(input, randu({2, 4, 3, 3})), c10::Error);
+  ASSERT_THROW(
+      at::native::convolution_with_algorithm(
+          input,
+          randu({2, 4, 3, 3}),
+          std::nullopt,
+          2,
+          0,
+          1,
+          1,
+          ConvAlgorithm::Winograd2x3),
+      c10::Error);
+}
@@ -0,0 +1,425 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/Copy.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "test_helpers.h"
+
+using at::test::at_flat;
+using at::test::bitwise_equal;
+
+namespace {
+
+constexpr at::ScalarType kAllTypes[] = {
+    at::ScalarType::Byte,
+    at::ScalarType::Char,
+    at::ScalarType::Short,
+    at::ScalarType::Int,
+    at::ScalarType::Long,
+    at::ScalarType::Half,
+    at::ScalarType::BFloat16,
+    at::ScalarType::Float,
+    at::ScalarType::Double,
+    at::ScalarType::Bool,
+    at::ScalarType::UInt16,
+    at::ScalarType::UInt32,
+    at::ScalarType::UInt64,
+};
+
+// a tensor holding 0, 1, ..., 99, 0, 1, ... (0 and 1 for Bool), which
+// every dtype represents exactly
+at::Tensor small_integers(c10::IntArrayRef sizes, at::ScalarType dtype) {
+  at::Tensor t = at::empty(sizes, dtype);
+  AT_DISPATCH_ALL_TYPES(dtype, "small_integers", [&] {
+    scalar_t* data = t.mutable_data_ptr<scalar_t>();
+    for (int64_t i = 0; i < t.numel(); ++i) {
+      const int64_t value =
+          dtype == at::ScalarType::Bool ? i % 3 == 0 : (i * 7) % 100;
+      data[i] = static_cast<scalar_t>(static_cast<float>(value));
+    }
+  });
+  return t;
+}
+
+double expected_value(double value, at::ScalarType dtype) {
+  return dtype == at::ScalarType::Bool ? value != 0 : value;
+}
+
+} // namespace
+
+TEST(CopyTest, converts_between_all_dtypes) {
+  // lengths with vector tails and with several conversion stages
+  for (int64_t n : {1, 7, 33, 1000}) {
+    for (at::ScalarType from : kAllTypes) {
+      at::Tensor src = small_integers({n}, from);
+      for (at::ScalarType to : kAllTypes) {
+        at::Tensor dst = at::empty({n}, to);
+        at::native::convert(
+            src.const_data_ptr(), from, dst.mutable_data_ptr(), to, n);
+        at::Tensor converted = src.to(to);
+        ASSERT_EQ(converted.scalar_type(), to);
+        for (int64_t i = 0; i < n; ++i) {
+          const double expected = expected_value(at_flat(src, i), to);
+          ASSERT_EQ(at_flat(dst, i), expected)
+              << c10::toString(from) << " -> " << c10::toString(to) << " at "
+              << i;
+          ASSERT_EQ(at_flat(converted, i), expected);
+        }
+      }
+    }
+  }
+}
+
+TEST(CopyTest, half_rounds_like_scalar_conversions) {
+  const float inf = std::numeric_limits<float>::infinity();
+  std::vector<float> values = {
+      0.f, -0.f, 1e-8f, 6e-5f, 65504.f, 65520.f, 1e6f, inf, -inf};
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-100.f, 100.f);
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(dist(gen));
+  }
+  const int64_t n = static_cast<int64_t>(values.size());
+  at::Tensor floats = at::empty({n});
+  std::memcpy(floats.mutable_data_ptr(), values.data(), n * sizeof(float));
+  at::Tensor halves = floats.to(at::ScalarType::Half);
+  at::Tensor doubles = floats.to(at::ScalarType::Double);
+  at::Tensor halves_from_double = doubles.to(at::ScalarType::Half);
+  at::Tensor back = halves.to(at::ScalarType::Float);
+  for (int64_t i = 0; i < n; ++i) {
+    const c10::Half expected(values[i]);
+    ASSERT_EQ(halves.const_data_ptr<c10::Half>()[i].x, expected.x) << i;
+    ASSERT_EQ(halves_from_double.const_data_ptr<c10::Half>()[i].x, expected.x);
+    ASSERT_EQ(back.const_data_ptr<float>()[i], static_cast<float>(expected));
+  }
+  at::Tensor nan = at::empty({1});
+  nan.fill_(std::nan(""));
+  EXPECT_TRUE(std::isnan(at_flat(nan.to(at::ScalarType::Half), 0)));
+}
+
+TEST(CopyTest, bfloat16_rounds_like_scalar_conversions) {
+  const float inf = std::numeric_limits<float>::infinity();
+  std::vector<float> values = {
+      0.f, -0.f, 1e-40f, 1.00390625f, 1.01171875f, 3.4e38f, inf, -inf};
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-100.f, 100.f);
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(dist(gen));
+  }
+  const int64_t n = static_cast<int64_t>(values.size());
+  at::Tensor floats = at::empty({n});
+  std::memcpy(floats.mutable_data_ptr(), values.data(), n * sizeof(float));
+  at::Tensor bf16 = floats.to(at::ScalarType::BFloat16);
+  at::Tensor back = bf16.to(at::ScalarType::Float);
+  for (int64_t i = 0; i < n; ++i) {
+    const c10::BFloat16 expected(values[i]);
+    ASSERT_EQ(bf16.const_data_ptr<c10::BFloat16>()[i].x, expected.x) << i;
+    ASSERT_EQ(back.const_data_ptr<float>()[i], static_cast<float>(expected));
+  }
+  at::Tensor nan = at::empty({1});
+  nan.fill_(std::nan(""));
+  EXPECT_TRUE(std::isnan(at_flat(nan.to(at::ScalarType::BFloat16), 0)));
+}
+
+TEST(CopyTest, float8_rounds_like_scalar_conversions) {
+  const float inf = std::numeric_limits<float>::infinity();
+  std::vector<float> values = {
+      0.f, -0.f, 1e-7f, 0.001f, 1.0625f, 448.f, 500.f, 60000.f, 1e6f, inf,
+      -inf, std::nanf("")};
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-600.f, 600.f);
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(dist(gen));
+  }
+  const int64_t n = static_cast<int64_t>(values.size());
+  at::Tensor floats = at::empty({n});
+  std::memcpy(floats.mutable_data_ptr(), values.data(), n * sizeof(float));
+  at::Tensor halves = floats.to(at::ScalarType::Half);
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float8_e4m3fn, at::ScalarType::Float8_e5m2}) {
+    at::Tensor fp8 = floats.to(dtype);
+    at::Tensor from_half = halves.to(dtype);
+    at::Tensor back = fp8.to(at::ScalarType::Float);
+    AT_DISPATCH_FLOAT8_TYPES(dtype, "test", [&] {
+      for (int64_t i = 0; i < n; ++i) {
+        const scalar_t expected(values[i]);
+        ASSERT_EQ(fp8.const_data_ptr<scalar_t>()[i].x, expected.x) << i;
+        ASSERT_EQ(
+            from_half.const_data_ptr<scalar_t>()[i].x,
+            scalar_t(static_cast<float>(halves.const_data_ptr<c10::Half>()[i]))
+                .x);
+        const float widened = back.const_data_ptr<float>()[i];
+        ASSERT_TRUE(
+            widened == static_cast<float>(expected) or
+            (std::isnan(widened) and std::isnan(values[i])));
+      }
+    });
+    // through strided views, of the random values
+    at::Tensor matrix = floats.slice(0, n - 1000, n).view({40, 25});
+    at::Tensor transposed = at::empty({25, 40}, dtype);
+    transposed.copy_(matrix.t());
+    for (int64_t i = 0; i < transposed.numel(); ++i) {
+      ASSERT_EQ(at_flat(transposed, i), at_flat(matrix.t().to(dtype), i));
+    }
+  }
+}
+
+TEST(CopyTest, scaled_float8_round_trip) {
+  at::Tensor x = at::empty({64, 50});
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-3000.f, 3000.f);
+  float* data = x.mutable_data_ptr<float>();
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    data[i] = dist(gen);
+  }
+  data[17] = -4000.f;
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float8_e4m3fn, at::ScalarType::Float8_e5m2}) {
+    const double scale = at::float8_scale(x, dtype);
+    at::Tensor q = at::to_float8(x, dtype, scale);
+    ASSERT_EQ(q.scalar_type(), dtype);
+    at::Tensor deq = at::from_float8(q, scale);
+    at::Tensor deq_half = at::from_float8(q, scale, at::ScalarType::Half);
+    AT_DISPATCH_FLOAT8_TYPES(dtype, "test", [&] {
+      using limits = std::numeric_limits<scalar_t>;
+      // the largest magnitude maps to the largest value
+      EXPECT_EQ(
+          static_cast<float>(q.const_data_ptr<scalar_t>()[17]),
+          -static_cast<float>(limits::max()));
+      const float inverse = static_cast<float>(1 / scale);
+      // half the relative spacing of the format
+      const double tol = static_cast<float>(limits::epsilon()) / 2;
+      for (int64_t i = 0; i < x.numel(); ++i) {
+        const scalar_t stored = q.const_data_ptr<scalar_t>()[i];
+        ASSERT_EQ(stored.x, scalar_t(data[i] * inverse).x) << i;
+        const float expected =
+            static_cast<float>(stored) * static_cast<float>(scale);
+        ASSERT_EQ(deq.const_data_ptr<float>()[i], expected);
+        ASSERT_EQ(
+            deq_half.const_data_ptr<c10::Half>()[i].x,
+            c10::Half(expected).x);
+        ASSERT_NEAR(expected, data[i], tol * std::abs(data[i]) + 1e-3);
+      }
+    });
+    // strided input
+    at::Tensor qt = at::to_float8(x.t(), dtype, scale);
+    for (int64_t i = 0; i < qt.numel(); ++i) {
+      ASSERT_EQ(at_flat(qt, i), at_flat(q.t(), i));
+    }
+  }
+  at::Tensor zeros = at::empty({3});
+  zeros.fill_(0);
+  EXPECT_EQ(at::float8_scale(zeros, at::ScalarType::Float8_e4m3fn), 1);
+  ASSERT_THROW(at::to_float8(x, at::ScalarType::Half, 1), c10::Error);
+  ASSERT_THROW(at::to_float8(x, at::ScalarType::Float8_e5m2, 0), c10::Error);
+  ASSERT_THROW(at::from_float8(x, 1), c10::Error);
+  ASSERT_THROW(at::float8_scale(x, at::ScalarType::Float), c10::Error);
+}
+
+TEST(CopyTest, nonzero_values_become_true) {
+  at::Tensor t = at::empty({5});
+  const float values[] = {0.f, 0.5f, -2.f, std::nanf(""), -0.f};
+  std::memcpy(t.mutable_data_ptr(), values, sizeof(values));
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float, at::ScalarType::Half, at::ScalarType::Double}) {
+    at::Tensor b = t.to(dtype).to(at::ScalarType::Bool);
+    const bool* data = b.const_data_ptr<bool>();
+    EXPECT_FALSE(data[0]);
+    EXPECT_TRUE(data[1]);
+    EXPECT_TRUE(data[2]);
+    EXPECT_TRUE(data[3]);
+    EXPECT_FALSE(data[4]);
+  }
+}
+
+TEST(CopyTest, copies_strided_and_broadcast_operands) {
+  at::Tensor src = small_integers({40, 30}, at::ScalarType::Int);
+  for (at::ScalarType to :
+       {at::ScalarType::Float, at::ScalarType::Half, at::ScalarType::Long}) {
+    // transposed source into a contiguous destination
+    at::Tensor dst = at::empty({30, 40}, to);
+    dst.copy_(src.t());
+    for (int64_t i = 0; i < dst.numel(); ++i) {
+      ASSERT_EQ(at_flat(dst, i), at_flat(src.t(), i));
+    }
+    // into a strided destination, broadcasting a row
+    at::Tensor base = at::empty({30, 80}, to);
+    base.fill_(-1);
+    at::Tensor strided = base.slice(1, 0, 80, 2);
+    at::Tensor row = src.select(1, 3);
+    strided.copy_(row);
+    for (int64_t i = 0; i < strided.numel(); ++i) {
+      ASSERT_EQ(at_flat(strided, i), at_flat(row, i % 40));
+      ASSERT_EQ(at_flat(base.slice(1, 1, 80, 2), i), -1);
+    }
+    // a broadcast scalar
+    at::Tensor scalar = at::empty({}, at::ScalarType::Double);
+    scalar.fill_(7);
+    dst.copy_(scalar);
+    for (int64_t i = 0; i < dst.numel(); ++i) {
+      ASSERT_EQ(at_flat(dst, i), 7);
+    }
+  }
+}
+
+TEST(CopyTest, transposed_copies_cover_tiles_and_edges) {
+  // sizes inside one register block, across tile edges and across tiles,
+  // for each element size and for conversions
+  const std::pair<int64_t, int64_t> shapes[] = {
+      {3, 5}, {8, 8}, {9, 7}, {64, 64}, {130, 67}, {67, 200}};
+  const std::pair<at::ScalarType, at::ScalarType> pairs[] = {
+      {at::ScalarType::Byte, at::ScalarType::Byte},
+      {at::ScalarType::Bool, at::ScalarType::Bool},
+      {at::ScalarType::Half, at::ScalarType::Half},
+      {at::ScalarType::Float, at::ScalarType::Float},
+      {at::ScalarType::Int, at::ScalarType::Int},
+      {at::ScalarType::Double, at::ScalarType::Double},
+      {at::ScalarType::Long, at::ScalarType::Long},
+      {at::ScalarType::Int, at::ScalarType::Float},
+      {at::ScalarType::Float, at::ScalarType::Half},
+      {at::ScalarType::Half, at::ScalarType::Double},
+      {at::ScalarType::Byte, at::ScalarType::Long},
+  };
+  for (const auto& [rows, cols] : shapes) {
+    for (const auto& [from, to] : pairs) {
+      at::Tensor src = small_integers({rows, cols}, from);
+      at::Tensor dst = at::empty({cols, rows}, to);
+      dst.copy_(src.t());
+      for (int64_t i = 0; i < dst.numel(); ++i) {
+        ASSERT_EQ(at_flat(dst, i), at_flat(src.t(), i))
+            << rows << " x " << cols << ", " << c10::toString(from)
+            << " -> " << c10::toString(to) << " at " << i;
+      }
+    }
+  }
+}
+
+TEST(CopyTest, contiguous_copies_only_other_layouts) {
+  at::Tensor x = small_integers({3, 20, 9, 11}, at::ScalarType::Float);
+  EXPECT_TRUE(x.contiguous().is_same(x));
+
+  at::Tensor nhwc = x.contiguous(at::MemoryFormat::ChannelsLast);
+  EXPECT_TRUE(nhwc.is_contiguous(at::MemoryFormat::ChannelsLast));
+  EXPECT_TRUE(nhwc.contiguous(at::MemoryFormat::ChannelsLast).is_same(nhwc));
+  at::Tensor nchw = nhwc.contiguous();
+  EXPECT_TRUE(nchw.is_contiguous());
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    ASSERT_EQ(at_flat(nhwc, i), at_flat(x, i));
+  }
+  EXPECT_TRUE(bitwise_equal(nchw, x));
+
+  // a permutation that moves every dim
+  at::Tensor permuted = x.permute({2, 3, 0, 1});
+  at::Tensor copy = permuted.contiguous();
+  EXPECT_TRUE(copy.is_contiguous());
+  for (int64_t i = 0; i < copy.numel(); ++i) {
+    ASSERT_EQ(at_flat(copy, i), at_flat(permuted, i));
+  }
+}
+
+TEST(CopyTest, transposed_copies_do_not_depend_on_thread_count) {
+  at::Tensor src = small_integers({700, 900}, at::ScalarType::Double);
+  at::set_num_threads(1);
+  at::Tensor one = src.t().contiguous();
+  at::Tensor one_half = at::empty({900, 700}, at::ScalarType::Half);
+  one_half.copy_(src.t());
+  at::set_num_threads(4);
+  at::Tensor four = src.t().contiguous();
+  at::Tensor four_half = at::empty({900, 700}, at::ScalarType::Half);
+  four_half.copy_(src.t());
+  at::set_num_threads(1);
+  ASSERT_TRUE(bitwise_equal(one, four));
+  ASSERT_TRUE(bitwise_equal(one_half, four_half));
+  for (int64_t i = 0; i < one.numel(); ++i) {
+    ASSERT_EQ(at_flat(one, i), at_flat(src.t(), i));
+  }
+}
+
+TEST(CopyTest, to_keeps_the_layout) {
+  at::Tensor x = small_integers({2, 3, 4, 5}, at::ScalarType::Float);
+  EXPECT_TRUE(x.to(at::ScalarType::Float).is_same(x));
+  at::Tensor copy = x.to(at::ScalarType::Float, /*copy=*/true);
+  EXPECT_FALSE(copy.is_same(x));
+  EXPECT_TRUE(bitwise_equal(copy, x));
+
+  at::Tensor nhwc = at::empty(
+      {2, 3, 4, 5}, at::ScalarType::Float, at::MemoryFormat::ChannelsLast);
+  nhwc.copy_(x);
+  at::Tensor half = nhwc.to(at::ScalarType::Half);
+  EXPECT_EQ(half.strides(), nhwc.strides());
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    ASSERT_EQ(at_flat(half, i), at_flat(x, i));
+  }
+  EXPECT_EQ(at::empty({0, 3}).to(at::ScalarType::Half).numel(), 0);
+}
+
+TEST(CopyTest, results_do_not_depend_on_thread_count) {
+  const int64_t n = 1 << 20;
+  at::Tensor src = at::empty({n});
+  float* data = src.mutable_data_ptr<float>();
+  for (int64_t i = 0; i < n; ++i) {
+    data[i] = static_cast<float>(i) * 0.37f;
+  }
+  at::set_num_threads(1);
+  at::Tensor one = src.to(at::ScalarType::Half);
+  at::Tensor one_converted = at::empty({n}, at::ScalarType::Half);
+  at::native::convert(
+      data, at::ScalarType::Float, one_converted.mutable_data_ptr(),
+      at::ScalarType::Half, n);
+  at::set_num_threads(4);
+  at::Tensor four = src.to(at::ScalarType::Half);
+  at::Tensor four_converted = at::empty({n}, at::ScalarType::Half);
+  at::native::convert(
+      data, at::ScalarType::Float, four_converted.mutable_data_ptr(),
+      at::ScalarType::Half, n);
+  at::set_num_threads(1);
+  ASSERT_TRUE(bitwise_equal(one, four));
+  ASSERT_TRUE(bitwise_equal(one, one_converted));
+  ASSERT_TRUE(bitwise_equal(one, four_converted));
+}
+
+TEST(CopyTest, rejects_partially_overlapping_operands) {
+  at::Tensor a = small_integers({8, 8}, at::ScalarType::Float);
+  const at::Tensor expected = a.to(at::ScalarType::Float, /*copy=*/true);
+  // the transpose covers the same bytes in another order
+  ASSERT_THROW(a.copy_(a.t()), c10::Error);
+  // shifted by a row
+  ASSERT_THROW(a.slice(0, 0, 7).copy_(a.slice(0, 1, 8)), c10::Error);
+  ASSERT_THROW(
+      a.view({64}).slice(0, 0, 60).copy_(a.view({64}).slice(0, 4, 64)),
+      c10::Error);
+  EXPECT_TRUE(bitwise_equal(a, expected));
+
+  // the same elements through another view, and disjoint parts of one
+  // storage, are fine
+  a.copy_(a.view({64}).view({8, 8}));
+  EXPECT_TRUE(bitwise_equal(a, expected));
+  a.slice(0, 0, 4).copy_(a.slice(0, 4, 8));
+  for (int64_t i = 0; i < 32; ++i) {
+    ASSERT_EQ(at_flat(a, i), at_flat(expected, i + 32));
+    ASSERT_EQ(at_flat(a, i + 32), at_flat(expected, i + 32));
+  }
+  // a transposed copy that does not alias
+  at::Tensor b = at::empty({8, 8});
+  b.copy_(a.t());
+  for (int64_t i = 0; i < b.numel(); ++i) {
+    ASSERT_EQ(at_flat(b, i), at_flat(a.t(), i));
+  }
+}
+
+TEST(CopyTest, checks_arguments) {
+  at::Tensor dst = at::empty({2, 3});
+  ASSERT_THROW(dst.copy_(at::empty({3, 2})), c10::Error);
+  ASSERT_THROW(at::empty({3}).copy_(at::empty({2, 3})), c10::Error);
+  // overlapping destination elements
+  ASSERT_THROW(
+      at::empty({1, 3}).expand({2, 3}).copy_(at::empty({2, 3})), c10::Error);
+}
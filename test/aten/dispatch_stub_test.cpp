@@ -0,0 +1,218 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/native/DispatchStub.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <strings.h>
+
+namespace at::native {
+
+using capability_fn = CPUCapability (*)();
+DECLARE_DISPATCH(capability_fn, capability_stub);
+DEFINE_DISPATCH(capability_stub);
+
+namespace {
+
+CPUCapability default_kernel() {
+  return CPUCapability::DEFAULT;
+}
+
+#if defined(HAVE_AVX2_CPU_DEFINITION)
+CPUCapability avx2_kernel() {
+  return CPUCapability::AVX2;
+}
+#endif
+
+#if defined(HAVE_AVX512_CPU_DEFINITION)
+CPUCapability avx512_kernel() {
+  return CPUCapability::AVX512;
+}
+#endif
+
+} // namespace
+
+REGISTER_ARCH_DISPATCH(capability_stub, DEFAULT, &default_kernel)
+REGISTER_AVX2_DISPATCH(capability_stub, &avx2_kernel)
+REGISTER_AVX512_DISPATCH(capability_stub, &avx512_kernel)
+
+} // namespace at::native
+
+namespace {
+
+using at::native::CPUCapability;
+
+// sets an environment variable for the lifetime of the guard
+class EnvGuard {
+ public:
+  EnvGuard(const char* name, const char* value) : name_(name) {
+    const char* old = std::getenv(name);
+    had_value_ = old != nullptr;
+    if (had_value_) {
+      old_value_ = old;
+    }
+    setenv(name, value, 1);
+  }
+
+  ~EnvGuard() {
+    if (had_value_) {
+      setenv(name_, old_value_.c_str(), 1);
+    } else {
+      unsetenv(name_);
+    }
+  }
+
+ private:
+  const char* name_;
+  bool had_value_;
+  std::string old_value_;
+};
+
+int64_t count_equal(const at::Tensor& t, float value) {
+  int64_t count = 0;
+  const float* data = static_cast<const float*>(t.storage().data());
+  for (int64_t i = 0; i < t.storage().nbytes() / 4; ++i) {
+    count += data[i] == value;
+  }
+  return count;
+}
+
+} // namespace
+
+TEST(DispatchStubTest, capability_is_at_most_detected) {
+  CPUCapability detected = at::native::detect_cpu_capability();
+  CPUCapability current = at::native::get_cpu_capability();
+  ASSERT_LE(static_cast<int>(current), static_cast<int>(detected));
+
+  const char* env = std::getenv("ATEN_CPU_CAPABILITY");
+  if (env == nullptr) {
+    ASSERT_EQ(current, detected);
+  } else if (strcasecmp(env, "default") == 0) {
+    ASSERT_EQ(current, CPUCapability::DEFAULT);
+  }
+}
+
+TEST(DispatchStubTest, env_lowers_capability) {
+  {
+    EnvGuard guard("ATEN_CPU_CAPABILITY", "default");
+    ASSERT_EQ(at::native::compute_cpu_capability(), CPUCapability::DEFAULT);
+  }
+  {
+    EnvGuard guard("ATEN_CPU_CAPABILITY", "");
+    ASSERT_EQ(
+        at::native::compute_cpu_capability(),
+        at::native::detect_cpu_capability());
+  }
+#if defined(HAVE_AVX512_CPU_DEFINITION)
+  {
+    // requests above the hardware are capped
+    EnvGuard guard("ATEN_CPU_CAPABILITY", "AVX512");
+    ASSERT_EQ(
+        at::native::compute_cpu_capability(),
+        at::native::detect_cpu_capability());
+  }
+#endif
+#if defined(HAVE_AVX2_CPU_DEFINITION)
+  if (at::native::detect_cpu_capability() >= CPUCapability::AVX2) {
+    EnvGuard guard("ATEN_CPU_CAPABILITY", "avx2");
+    ASSERT_EQ(at::native::compute_cpu_capability(), CPUCapability::AVX2);
+  }
+#endif
+}
+
+TEST(DispatchStubTest, env_turns_vnni_off) {
+  const bool detected = [] {
+    EnvGuard guard("ATEN_CPU_CAPABILITY", "");
+    return at::native::compute_cpu_vnni();
+  }();
+  if (detected) {
+    ASSERT_EQ(at::native::detect_cpu_capability(), CPUCapability::AVX512);
+  }
+  {
+    EnvGuard guard("ATEN_CPU_CAPABILITY", "default");
+    ASSERT_FALSE(at::native::compute_cpu_vnni());
+  }
+#if defined(HAVE_AVX512_CPU_DEFINITION)
+  {
+    EnvGuard guard("ATEN_CPU_CAPABILITY", "avx512");
+    ASSERT_FALSE(at::native::compute_cpu_vnni());
+  }
+  {
+    // the capability of avx512_vnni is AVX512, capped like it
+    EnvGuard guard("ATEN_CPU_CAPABILITY", "avx512_vnni");
+    ASSERT_EQ(
+        at::native::compute_cpu_capability(),
+        at::native::detect_cpu_capability());
+    ASSERT_EQ(at::native::compute_cpu_vnni(), detected);
+  }
+#endif
+  const char* env = std::getenv("ATEN_CPU_CAPABILITY");
+  if (env == nullptr or *env == '\0' or
+      strcasecmp(env, "avx512_vnni") == 0) {
+    ASSERT_EQ(at::native::get_cpu_vnni(), detected);
+  } else {
+    ASSERT_FALSE(at::native::get_cpu_vnni());
+  }
+}
+
+TEST(DispatchStubTest, invalid_env_throws) {
+  EnvGuard guard("ATEN_CPU_CAPABILITY", "sse9");
+  ASSERT_THROW(at::native::compute_cpu_capability(), c10::Error);
+}
+
+TEST(DispatchStubTest, dispatches_to_current_capability) {
+  ASSERT_EQ(
+      at::native::capability_stub(c10::kCPU),
+      at::native::get_cpu_capability());
+  // the cached pointer is reused
+  ASSERT_EQ(
+      at::native::capability_stub(c10::kCPU),
+      at::native::get_cpu_capability());
+}
+
+TEST(FillTest, contiguous_all_dtypes) {
+  for (auto dtype :
+       {at::ScalarType::Byte,
+        at::ScalarType::Char,
+        at::ScalarType::Short,
+        at::ScalarType::Int,
+        at::ScalarType::Long,
+        at::ScalarType::Half,
+        at::ScalarType::Float,
+        at::ScalarType::Double}) {
+    // 67 elements leave a tail for every vector width
+    at::Tensor t = at::empty({67}, dtype);
+    t.fill_(3);
+    AT_DISPATCH_ALL_TYPES(dtype, "fill_test", [&] {
+      for (int64_t i = 0; i < 67; ++i) {
+        ASSERT_EQ(static_cast<double>(t.const_data_ptr<scalar_t>()[i]), 3.0)
+            << "dtype " << dtype << " index " << i;
+      }
+    });
+  }
+}
+
+TEST(FillTest, strided_view_only_touches_view) {
+  at::Tensor base = at::empty({8, 10});
+  base.fill_(0);
+  // every other column of rows 2..5, transposed
+  at::Tensor view = base.slice(0, 2, 6).slice(1, 0, 10, 2).t();
+  ASSERT_FALSE(view.is_contiguous());
+  view.fill_(1.5);
+  ASSERT_EQ(count_equal(base, 1.5f), 4 * 5);
+  ASSERT_EQ(count_equal(base, 0.f), 80 - 4 * 5);
+  for (int64_t i = 2; i < 6; ++i) {
+    for (int64_t j = 0; j < 10; ++j) {
+      float v = base.const_data_ptr<float>()[i * 10 + j];
+      ASSERT_EQ(v, j % 2 == 0 ? 1.5f : 0.f);
+    }
+  }
+}
+
+TEST(FillTest, empty_tensor) {
+  at::Tensor t = at::empty({0, 4});
+  ASSERT_EQ(&t.fill_(1), &t);
+}
@@ -0,0 +1,228 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "test_helpers.h"
+
+using at::test::at_flat;
+using at::test::bitwise_equal;
+using at::test::randu;
+using at::test::uniform;
+
+namespace {
+
+constexpr double kFloatEps = std::numeric_limits<float>::epsilon();
+
+// layer norm (rms = false) or RMSNorm (rms = true) of x over rows of n
+// trailing elements in double, indexed row-major like x
+std::vector<double> reference_norm(
+    const at::Tensor& x,
+    int64_t n,
+    const std::optional<at::Tensor>& weight,
+    const std::optional<at::Tensor>& bias,
+    double eps,
+    bool rms) {
+  std::vector<double> y(x.numel());
+  for (int64_t first = 0; first < x.numel(); first += n) {
+    double mean = 0;
+    for (int64_t k = 0; k < n; ++k) {
+      mean += at_flat(x, first + k);
+    }
+    mean = rms ? 0 : mean / n;
+    double var = 0;
+    for (int64_t k = 0; k < n; ++k) {
+      const double d = at_flat(x, first + k) - mean;
+      var += d * d;
+    }
+    const double rstd = 1 / std::sqrt(var / n + eps);
+    for (int64_t k = 0; k < n; ++k) {
+      double v = (at_flat(x, first + k) - mean) * rstd;
+      if (weight) {
+        v *= at_flat(*weight, k);
+      }
+      if (bias) {
+        v += at_flat(*bias, k);
+      }
+      y[first + k] = v;
+    }
+  }
+  return y;
+}
+
+void expect_near(
+    const at::Tensor& y,
+    const std::vector<double>& expected,
+    double tol) {
+  ASSERT_EQ(y.numel(), static_cast<int64_t>(expected.size()));
+  for (int64_t i = 0; i < y.numel(); ++i) {
+    ASSERT_NEAR(at_flat(y, i), expected[i], tol) << "at " << i;
+  }
+}
+
+} // namespace
+
+TEST(LayerNormTest, matches_reference) {
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float,
+        at::ScalarType::Double,
+        at::ScalarType::Half,
+        at::ScalarType::BFloat16}) {
+    const double tol = dtype == at::ScalarType::Half ? 1e-2
+        : dtype == at::ScalarType::BFloat16          ? 5e-2
+                                                     : 1e-5;
+    at::Tensor x = randu({4, 6, 37}, dtype);
+    at::Tensor w = uniform({37}, dtype, 0.5, 2, 1);
+    at::Tensor b = uniform({37}, dtype, -1, 1, 2);
+    at::Tensor y = at::layer_norm(x, {37}, w, b);
+    ASSERT_EQ(y.sizes(), x.sizes());
+    ASSERT_EQ(y.scalar_type(), dtype);
+    expect_near(y, reference_norm(x, 37, w, b, 1e-5, false), tol);
+    expect_near(
+        at::layer_norm(x, {37}),
+        reference_norm(x, 37, std::nullopt, std::nullopt, 1e-5, false),
+        tol);
+    expect_near(
+        at::layer_norm(x, {37}, w, std::nullopt, 0.1),
+        reference_norm(x, 37, w, std::nullopt, 0.1, false),
+        tol);
+    expect_near(
+        at::layer_norm(x, {37}, std::nullopt, b),
+        reference_norm(x, 37, std::nullopt, b, 1e-5, false),
+        tol);
+    // over the last two dims
+    at::Tensor w2 = uniform({6, 37}, dtype, 0.5, 2, 3);
+    expect_near(
+        at::layer_norm(x, {6, 37}, w2),
+        reference_norm(x, 6 * 37, w2, std::nullopt, 1e-5, false),
+        tol);
+  }
+}
+
+TEST(LayerNormTest, rms_norm_matches_reference) {
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float,
+        at::ScalarType::Double,
+        at::ScalarType::Half,
+        at::ScalarType::BFloat16}) {
+    const double tol = dtype == at::ScalarType::Half ? 1e-2
+        : dtype == at::ScalarType::BFloat16          ? 5e-2
+                                                     : 1e-5;
+    at::Tensor x = randu({5, 70}, dtype);
+    at::Tensor w = uniform({70}, dtype, 0.5, 2, 1);
+    expect_near(
+        at::rms_norm(x, {70}, w, 1e-6),
+        reference_norm(x, 70, w, std::nullopt, 1e-6, true),
+        tol);
+    const double eps = dtype == at::ScalarType::Double
+        ? std::numeric_limits<double>::epsilon()
+        : dtype == at::ScalarType::Half     ? 0.0009765625
+        : dtype == at::ScalarType::BFloat16 ? 0.0078125
+                                            : kFloatEps;
+    expect_near(
+        at::rms_norm(x, {70}),
+        reference_norm(x, 70, std::nullopt, std::nullopt, eps, true),
+        tol);
+  }
+}
+
+TEST(LayerNormTest, large_mean_and_long_rows) {
+  // a mean far from zero against a small spread, over several chunks: a
+  // single-pass sum of squares would lose the variance
+  at::Tensor x = uniform({3, 5000}, at::ScalarType::Float, 1000, 1001);
+  expect_near(
+      at::layer_norm(x, {5000}),
+      reference_norm(x, 5000, std::nullopt, std::nullopt, 1e-5, false),
+      2e-3);
+  at::Tensor w = uniform({5000}, at::ScalarType::Float, 0.5, 2, 1);
+  expect_near(
+      at::rms_norm(x, {5000}, w),
+      reference_norm(x, 5000, w, std::nullopt, kFloatEps, true),
+      1e-5);
+}
+
+TEST(LayerNormTest, reads_strided_operands) {
+  at::Tensor base = randu({30, 20});
+  at::Tensor w = uniform({60}, at::ScalarType::Float, 0.5, 2, 1)
+                     .slice(0, 0, 60, 3);
+  at::Tensor b = uniform({20}, at::ScalarType::Float, -1, 1, 2);
+  for (const at::Tensor& x :
+       {base.t().slice(1, 0, 20), base.slice(0, 1, 21)}) {
+    ASSERT_EQ(x.size(1), 20);
+    expect_near(
+        at::layer_norm(x, {20}, w, b),
+        reference_norm(x, 20, w, b, 1e-5, false),
+        1e-5);
+    expect_near(
+        at::rms_norm(x, {20}, w),
+        reference_norm(x, 20, w, std::nullopt, kFloatEps, true),
+        1e-5);
+  }
+}
+
+TEST(LayerNormTest, in_place) {
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float,
+        at::ScalarType::Half,
+        at::ScalarType::BFloat16}) {
+    at::Tensor w = uniform({33}, dtype, 0.5, 2, 1);
+    at::Tensor b = uniform({33}, dtype, -1, 1, 2);
+    at::Tensor x = randu({9, 33}, dtype);
+    at::Tensor expected = at::layer_norm(x, {33}, w, b);
+    ASSERT_EQ(&at::layer_norm_(x, {33}, w, b), &x);
+    ASSERT_TRUE(bitwise_equal(x, expected));
+    at::Tensor r = randu({9, 33}, dtype);
+    at::Tensor r_expected = at::rms_norm(r, {33}, w);
+    ASSERT_EQ(&at::rms_norm_(r, {33}, w), &r);
+    ASSERT_TRUE(bitwise_equal(r, r_expected));
+    // through a transposed view
+    at::Tensor t = randu({33, 9}, dtype).t();
+    at::Tensor t_expected = at::layer_norm(t, {33}, w, b);
+    at::layer_norm_(t, {33}, w, b);
+    for (int64_t i = 0; i < t.numel(); ++i) {
+      ASSERT_EQ(at_flat(t, i), at_flat(t_expected, i)) << i;
+    }
+  }
+}
+
+TEST(LayerNormTest, constant_and_empty_rows) {
+  at::Tensor x = at::empty({2, 16});
+  x.fill_(5);
+  at::Tensor y = at::layer_norm(x, {16});
+  for (int64_t i = 0; i < y.numel(); ++i) {
+    ASSERT_EQ(y.const_data_ptr<float>()[i], 0.f);
+  }
+  EXPECT_EQ(at::layer_norm(at::empty({0, 16}), {16}).numel(), 0);
+  EXPECT_EQ(at::rms_norm(at::empty({0, 16}), {16}).numel(), 0);
+}
+
+TEST(LayerNormTest, results_do_not_depend_on_thread_count) {
+  at::Tensor x = randu({64, 3000});
+  at::Tensor w = uniform({3000}, at::ScalarType::Float, 0.5, 2, 1);
+  at::set_num_threads(1);
+  at::Tensor one = at::layer_norm(x, {3000}, w);
+  at::Tensor one_rms = at::rms_norm(x, {3000}, w);
+  at::set_num_threads(4);
+  at::Tensor four = at::layer_norm(x, {3000}, w);
+  at::Tensor four_rms = at::rms_norm(x, {3000}, w);
+  at::set_num_threads(1);
+  ASSERT_TRUE(bitwise_equal(one, four));
+  ASSERT_TRUE(bitwise_equal(one_rms, four_rms));
+}
+
+TEST(LayerNormTest, checks_arguments) {
+  at::Tensor x = at::empty({4, 8});
+  ASSERT_THROW(at::layer_norm(x, {4}), c10::Error);
+  ASSERT_THROW(at::layer_norm(x, {}), c10::Error);
+  ASSERT_THROW(at::layer_norm(x, {2, 4, 8}), c10::Error);
+  ASSERT_THROW(at::layer_norm(x, {8}, at::empty({4})), c10::Error);
+  at::Tensor double_bias = at::empty({8}, at::ScalarType::Double);
+  ASSERT_THROW(at::layer_norm(x, {8}, std::nullopt, double_bias), c10::Error);
+  ASSERT_THROW(at::rms_norm(x, {8}, at::empty({1, 8})), c10::Error);
+  ASSERT_THROW(
+      at::rms_norm(at::empty({4, 8}, at::ScalarType::Long), {8}), c10::Error);
+}
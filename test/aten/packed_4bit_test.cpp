@@ -0,0 +1,247 @@
+#include <ATen/ATen.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+using at::ScalarType;
+
+constexpr ScalarType k4BitTypes[] = {ScalarType::Int4, ScalarType::NF4};
+
+// a Float tensor of the given sizes with normal randoms of the given
+// standard deviation
+at::Tensor randn(c10::IntArrayRef sizes, float stddev, uint32_t seed = 0) {
+  at::Tensor t = at::empty(sizes);
+  std::mt19937 gen(seed);
+  std::normal_distribution<float> dist(0, stddev);
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    t.mutable_data_ptr<float>()[i] = dist(gen);
+  }
+  return t;
+}
+
+// the code at flat index i of a packed tensor
+uint8_t code_at(const at::Tensor& packed, int64_t i) {
+  const auto* bytes = static_cast<const uint8_t*>(packed.const_data_ptr());
+  const uint8_t byte = bytes[i / 2];
+  return i % 2 == 0 ? byte & 0xF : byte >> 4;
+}
+
+// the value code stands for in dtype
+float code_value(ScalarType dtype, uint8_t code) {
+  return dtype == ScalarType::Int4 ? c10::int4x2(code).lo()
+                                   : c10::kNF4Values[code];
+}
+
+float scale_at(const at::Tensor& scales, int64_t row, int64_t group) {
+  return static_cast<float>(
+      scales.const_data_ptr<c10::Half>()[row * scales.size(1) + group]);
+}
+
+} // namespace
+
+TEST(Packed4BitTest, storage_counts_half_bytes) {
+  EXPECT_EQ(c10::elementBits(ScalarType::Int4), 4u);
+  EXPECT_EQ(c10::elementBits(ScalarType::NF4), 4u);
+  EXPECT_EQ(c10::elementBits(ScalarType::Half), 16u);
+  EXPECT_THROW(c10::elementSize(ScalarType::Int4), c10::Error);
+  for (ScalarType dtype : k4BitTypes) {
+    // an odd number of elements ends in half a byte
+    at::Tensor odd = at::empty({3}, dtype);
+    EXPECT_EQ(odd.storage().nbytes(), 2u);
+    EXPECT_EQ(odd.nbytes(), 2u);
+    at::Tensor even = at::empty({4, 5}, dtype);
+    EXPECT_EQ(even.storage().nbytes(), 10u);
+    EXPECT_EQ(even.nbytes(), 10u);
+    EXPECT_EQ(at::empty({0, 5}, dtype).nbytes(), 0u);
+    EXPECT_NE(even.const_data_ptr(), nullptr);
+  }
+}
+
+TEST(Packed4BitTest, has_no_views_or_elementwise_ops) {
+  at::Tensor t = at::empty({4, 6}, ScalarType::Int4);
+  EXPECT_THROW(t.t(), c10::Error);
+  EXPECT_THROW(t.slice(0, 1, 3), c10::Error);
+  EXPECT_THROW(t.view({24}), c10::Error);
+  EXPECT_THROW(t.as_strided({2}, {1}), c10::Error);
+  EXPECT_THROW(t.to(ScalarType::Float), c10::Error);
+  EXPECT_THROW(at::empty({4, 6}).copy_(t), c10::Error);
+  EXPECT_THROW(
+      at::empty_strided({4, 6}, {6, 1}, ScalarType::NF4), c10::Error);
+  EXPECT_THROW(
+      at::empty({1, 2, 3, 4}, ScalarType::NF4, at::MemoryFormat::ChannelsLast),
+      c10::Error);
+}
+
+TEST(Packed4BitTest, int4_codes_are_packed_low_nibble_first) {
+  at::Tensor w = at::empty({1, 4});
+  float* data = w.mutable_data_ptr<float>();
+  data[0] = 1;
+  data[1] = -1;
+  data[2] = 9; // saturates to 7
+  data[3] = -8;
+  at::Tensor scales = at::empty({1, 1}, ScalarType::Half);
+  scales.mutable_data_ptr<c10::Half>()[0] = c10::Half(1.0f);
+  at::Tensor packed = at::to_4bit(w, ScalarType::Int4, scales);
+  const auto* bytes = static_cast<const uint8_t*>(packed.const_data_ptr());
+  EXPECT_EQ(bytes[0], 0xF1);
+  EXPECT_EQ(bytes[1], 0x87);
+  at::Tensor decoded = at::from_4bit(packed, scales);
+  const std::vector<float> expected = {1, -1, 7, -8};
+  for (int64_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(decoded.const_data_ptr<float>()[i], expected[i]);
+  }
+}
+
+TEST(Packed4BitTest, round_trip_matches_reference) {
+  const int64_t n = 5;
+  const int64_t k = 96;
+  for (ScalarType dtype : k4BitTypes) {
+    for (int64_t group_size : {2, 6, 32, 96}) {
+      at::Tensor w = randn({n, k}, 0.5f, static_cast<uint32_t>(group_size));
+      // an all-zero group, whose scale is 0
+      std::fill_n(w.mutable_data_ptr<float>(), group_size, 0.0f);
+      at::Tensor scales = at::scales_4bit(w, dtype, group_size);
+      ASSERT_EQ(scales.sizes(), c10::IntArrayRef({n, k / group_size}));
+      EXPECT_EQ(scale_at(scales, 0, 0), 0.0f);
+      at::Tensor packed = at::to_4bit(w, dtype, scales);
+      ASSERT_EQ(packed.scalar_type(), dtype);
+      ASSERT_EQ(packed.sizes(), w.sizes());
+      at::Tensor decoded = at::from_4bit(packed, scales);
+      ASSERT_EQ(decoded.sizes(), w.sizes());
+      const float max_code = dtype == ScalarType::Int4 ? 7 : 1;
+      for (int64_t j = 0; j < n; ++j) {
+        for (int64_t g = 0; g < k / group_size; ++g) {
+          const float scale = scale_at(scales, j, g);
+          float max = 0;
+          for (int64_t i = g * group_size; i < (g + 1) * group_size; ++i) {
+            max = std::max(max, std::abs(w.const_data_ptr<float>()[j * k + i]));
+          }
+          EXPECT_EQ(scale, static_cast<float>(c10::Half(max / max_code)));
+          const float inv_scale = scale == 0 ? 0 : 1 / scale;
+          for (int64_t i = g * group_size; i < (g + 1) * group_size; ++i) {
+            const float x = w.const_data_ptr<float>()[j * k + i] * inv_scale;
+            const uint8_t code = dtype == ScalarType::Int4
+                ? static_cast<uint8_t>(
+                      static_cast<int>(
+                          std::clamp(std::nearbyint(x), -8.0f, 7.0f)) &
+                      0xF)
+                : c10::nf4_code(x);
+            ASSERT_EQ(code_at(packed, j * k + i), code) << j << " " << i;
+            ASSERT_EQ(
+                decoded.const_data_ptr<float>()[j * k + i],
+                code_value(dtype, code) * scale);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(Packed4BitTest, nf4_code_is_nearest_value) {
+  for (float x = -1.25f; x <= 1.25f; x += 1.0f / 512) {
+    const uint8_t code = c10::nf4_code(x);
+    ASSERT_LT(code, 16);
+    const float error = std::abs(c10::kNF4Values[code] - x);
+    for (float value : c10::kNF4Values) {
+      ASSERT_LE(error, std::abs(value - x)) << x;
+    }
+  }
+  EXPECT_EQ(c10::kNF4Values[c10::nf4_code(0)], 0.0f);
+}
+
+TEST(Packed4BitTest, linear_matches_decoded_weight) {
+  struct Shape {
+    int64_t m, n, k, group_size;
+  };
+  // groups shorter and longer than a vector, with and without tails, and
+  // row blocks of every size
+  const Shape shapes[] = {
+      {1, 1, 2, 2},
+      {1, 17, 64, 32},
+      {2, 9, 96, 6},
+      {3, 33, 40, 10},
+      {4, 8, 128, 128},
+      {7, 65, 256, 64},
+      {1, 300, 1024, 128},
+      // decoded for the GEMM
+      {130, 9, 64, 32},
+      {5, 3, 0, 2},
+  };
+  for (ScalarType dtype : k4BitTypes) {
+    for (const Shape& s : shapes) {
+      at::Tensor w = randn({s.n, s.k}, 0.1f, 1);
+      at::Tensor scales = at::scales_4bit(w, dtype, s.group_size);
+      at::Tensor packed = at::to_4bit(w, dtype, scales);
+      at::Tensor x = randn({s.m, s.k}, 1.0f, 2);
+      at::Tensor bias = randn({s.n}, 1.0f, 3);
+      at::Tensor decoded = at::from_4bit(packed, scales);
+      for (bool with_bias : {false, true}) {
+        at::Tensor out = with_bias
+            ? at::linear_4bit(x, packed, scales, bias)
+            : at::linear_4bit(x, packed, scales);
+        ASSERT_EQ(out.sizes(), c10::IntArrayRef({s.m, s.n}));
+        for (int64_t i = 0; i < s.m; ++i) {
+          for (int64_t j = 0; j < s.n; ++j) {
+            double expected = with_bias ? bias.const_data_ptr<float>()[j] : 0;
+            double magnitude = std::abs(expected);
+            for (int64_t l = 0; l < s.k; ++l) {
+              const double p = static_cast<double>(
+                                   x.const_data_ptr<float>()[i * s.k + l]) *
+                  decoded.const_data_ptr<float>()[j * s.k + l];
+              expected += p;
+              magnitude += std::abs(p);
+            }
+            ASSERT_NEAR(
+                out.const_data_ptr<float>()[i * s.n + j],
+                expected,
+                1e-5 * magnitude + 1e-6)
+                << dtype << " " << s.m << "x" << s.n << "x" << s.k << " at "
+                << i << ", " << j;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(Packed4BitTest, checks_arguments) {
+  at::Tensor w = randn({4, 8}, 1.0f);
+  at::Tensor scales = at::scales_4bit(w, ScalarType::Int4, 4);
+  at::Tensor packed = at::to_4bit(w, ScalarType::Int4, scales);
+  // not a 4-bit dtype
+  EXPECT_THROW(at::scales_4bit(w, ScalarType::Char, 4), c10::Error);
+  EXPECT_THROW(at::to_4bit(w, ScalarType::Float, scales), c10::Error);
+  EXPECT_THROW(at::from_4bit(w, scales), c10::Error);
+  // odd groups, groups that do not divide the rows
+  EXPECT_THROW(at::scales_4bit(w, ScalarType::Int4, 3), c10::Error);
+  EXPECT_THROW(at::scales_4bit(w, ScalarType::Int4, 6), c10::Error);
+  EXPECT_THROW(at::scales_4bit(w, ScalarType::Int4, 0), c10::Error);
+  EXPECT_THROW(
+      at::to_4bit(w, ScalarType::Int4, at::empty({4, 3}, ScalarType::Half)),
+      c10::Error);
+  EXPECT_THROW(
+      at::to_4bit(w, ScalarType::Int4, at::empty({4, 8}, ScalarType::Half)),
+      c10::Error);
+  // scales of the wrong dtype or rows
+  EXPECT_THROW(at::to_4bit(w, ScalarType::Int4, at::empty({4, 2})), c10::Error);
+  EXPECT_THROW(
+      at::from_4bit(packed, at::empty({3, 2}, ScalarType::Half)), c10::Error);
+  // no 2-D weight
+  EXPECT_THROW(at::scales_4bit(at::empty({8}), ScalarType::NF4, 2), c10::Error);
+  // magnitudes beyond Half scales
+  EXPECT_THROW(
+      at::scales_4bit(randn({2, 4}, 1e6f), ScalarType::Int4, 2), c10::Error);
+  // mismatched input and bias
+  EXPECT_THROW(at::linear_4bit(at::empty({2, 6}), packed, scales), c10::Error);
+  EXPECT_THROW(at::linear_4bit(at::empty({8}), packed, scales), c10::Error);
+  EXPECT_THROW(
+      at::linear_4bit(at::empty({2, 8}), packed, scales, at::empty({3})),
+      c10::Error);
+  EXPECT_THROW(at::linear_4bit(at::empty({2, 8}), w, scales), c10::Error);
+}
@@ -0,0 +1,161 @@
+#include <ATen/Parallel.h>
+#include <c10/core/thread_pool.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+TEST(ParallelTest, parallel_for_covers_range_once) {
+  at::set_num_threads(4);
+  ASSERT_EQ(at::get_num_threads(), 4);
+  for (int64_t n : {1, 7, 100, 1000, 12345}) {
+    std::vector<std::atomic<int>> hits(n);
+    at::parallel_for(0, n, 1, [&](int64_t begin, int64_t end) {
+      ASSERT_LT(begin, end);
+      for (int64_t i = begin; i < end; ++i) {
+        hits[i]++;
+      }
+    });
+    for (int64_t i = 0; i < n; ++i) {
+      ASSERT_EQ(hits[i].load(), 1) << "n = " << n << ", i = " << i;
+    }
+  }
+}
+
+TEST(ParallelTest, small_ranges_run_inline) {
+  at::set_num_threads(4);
+  int calls = 0;
+  at::parallel_for(0, 100, 1000, [&](int64_t begin, int64_t end) {
+    ASSERT_FALSE(at::in_parallel_region());
+    ASSERT_EQ(begin, 0);
+    ASSERT_EQ(end, 100);
+    ++calls;
+  });
+  ASSERT_EQ(calls, 1);
+  at::parallel_for(5, 5, 1, [&](int64_t, int64_t) { ++calls; });
+  ASSERT_EQ(calls, 1);
+}
+
+TEST(ParallelTest, thread_numbers) {
+  at::set_num_threads(3);
+  std::mutex mutex;
+  std::set<int> thread_nums;
+  at::parallel_for(0, 3000, 1, [&](int64_t, int64_t) {
+    ASSERT_TRUE(at::in_parallel_region());
+    std::lock_guard<std::mutex> guard(mutex);
+    thread_nums.insert(at::get_thread_num());
+  });
+  ASSERT_FALSE(at::in_parallel_region());
+  ASSERT_EQ(at::get_thread_num(), 0);
+  for (int tid : thread_nums) {
+    ASSERT_GE(tid, 0);
+    ASSERT_LT(tid, 3);
+  }
+}
+
+TEST(ParallelTest, nested_regions_run_inline) {
+  at::set_num_threads(4);
+  std::atomic<int64_t> total{0};
+  at::parallel_for(0, 16, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const int outer_thread = at::get_thread_num();
+      int inner_calls = 0;
+      at::parallel_for(0, 1000, 1, [&](int64_t b, int64_t e) {
+        ASSERT_EQ(at::get_thread_num(), outer_thread);
+        ++inner_calls;
+        total += e - b;
+      });
+      ASSERT_EQ(inner_calls, 1);
+    }
+  });
+  ASSERT_EQ(total.load(), 16 * 1000);
+}
+
+TEST(ParallelTest, exceptions_propagate) {
+  at::set_num_threads(4);
+  ASSERT_THROW(
+      at::parallel_for(
+          0,
+          1000,
+          1,
+          [](int64_t begin, int64_t end) {
+            if (begin <= 500 and 500 < end) {
+              throw std::runtime_error("chunk failed");
+            }
+          }),
+      std::runtime_error);
+  // the pool stays usable
+  std::atomic<int64_t> count{0};
+  at::parallel_for(0, 1000, 1, [&](int64_t b, int64_t e) { count += e - b; });
+  ASSERT_EQ(count.load(), 1000);
+}
+
+TEST(ParallelTest, parallel_reduce) {
+  at::set_num_threads(4);
+  const int64_t n = 100000;
+  const int64_t sum = at::parallel_reduce(
+      0,
+      n,
+      1000,
+      int64_t(0),
+      [](int64_t begin, int64_t end, int64_t ident) {
+        int64_t partial = ident;
+        for (int64_t i = begin; i < end; ++i) {
+          partial += i;
+        }
+        return partial;
+      },
+      [](int64_t a, int64_t b) { return a + b; });
+  ASSERT_EQ(sum, n * (n - 1) / 2);
+
+  // a non-commutative combination sees the partials in chunk order
+  const int64_t last = at::parallel_reduce(
+      0,
+      n,
+      1000,
+      int64_t(-1),
+      [](int64_t begin, int64_t end, int64_t) { return end - 1; },
+      [](int64_t a, int64_t b) { return b == -1 ? a : b; });
+  ASSERT_EQ(last, n - 1);
+}
+
+TEST(ParallelTest, concurrent_callers) {
+  at::set_num_threads(4);
+  // regions started while the pool is busy run on their own thread
+  std::vector<std::thread> threads;
+  std::atomic<int64_t> total{0};
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&] {
+      for (int r = 0; r < 50; ++r) {
+        at::parallel_for(0, 1000, 1, [&](int64_t b, int64_t e) {
+          total += e - b;
+        });
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(total.load(), 4 * 50 * 1000);
+}
+
+TEST(ParallelTest, thread_pool_resize_and_affinity) {
+  c10::ThreadPool pool(2, {0});
+  ASSERT_EQ(pool.size(), 2);
+  std::atomic<int> chunks{0};
+  pool.run(100, [&](int64_t) { chunks++; });
+  ASSERT_EQ(chunks.load(), 100);
+
+  pool.resize(5);
+  ASSERT_EQ(pool.size(), 5);
+  chunks = 0;
+  pool.run(3, [&](int64_t) { chunks++; });
+  ASSERT_EQ(chunks.load(), 3);
+
+  at::set_thread_affinity({0});
+  at::set_thread_affinity({});
+  ASSERT_THROW(at::set_num_threads(0), c10::Error);
+}
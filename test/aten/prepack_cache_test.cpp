@@ -0,0 +1,235 @@
+#include <ATen/ATen.h>
+#include <ATen/native/CPUBlas.h>
+#include <ATen/native/PrepackCache.h>
+#include <c10/cpu/CPUAllocator.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <new>
+
+#include "test_helpers.h"
+
+using at::native::cpublas::GemmParams;
+using at::native::cpublas::PackedB;
+using at::test::at_flat;
+using at::test::bitwise_equal;
+using at::test::randu;
+
+namespace {
+
+GemmParams mm_params(const at::Tensor& a, const at::Tensor& b, at::Tensor& c) {
+  GemmParams params;
+  params.dtype = a.scalar_type();
+  params.m = a.size(0);
+  params.n = b.size(1);
+  params.k = a.size(1);
+  params.a = a.const_data_ptr();
+  params.a_row_stride = a.stride(0);
+  params.a_col_stride = a.stride(1);
+  params.b = b.const_data_ptr();
+  params.b_row_stride = b.stride(0);
+  params.b_col_stride = b.stride(1);
+  params.c = c.mutable_data_ptr();
+  params.c_row_stride = c.stride(0);
+  params.c_col_stride = c.stride(1);
+  return params;
+}
+
+// writes x[0] without going through a mutable access, i.e. without the
+// cache seeing it
+void overwrite_first_behind_cache(const at::Tensor& x, float value) {
+  const_cast<float*>(x.const_data_ptr<float>())[0] = value;
+}
+
+class PrepackCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    at::native::empty_prepack_cache();
+  }
+
+  void TearDown() override {
+    at::native::set_prepack_cache_limit(std::numeric_limits<size_t>::max());
+    at::native::empty_prepack_cache();
+  }
+};
+
+} // namespace
+
+TEST_F(PrepackCacheTest, packed_b_gives_the_same_products) {
+  // {m, k, n}: more rows than a register tile, computed exactly as without
+  // packing; then few rows, which otherwise take the skinny path
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float, at::ScalarType::Double, at::ScalarType::Half}) {
+    const double tol = dtype == at::ScalarType::Half ? 5e-2 : 1e-3;
+    for (const auto& [m, k, n] : {std::array<int64_t, 3>{40, 300, 70},
+                                  std::array<int64_t, 3>{3, 520, 4100}}) {
+      at::Tensor a = randu({m, k}, dtype, 1);
+      for (const at::Tensor& b :
+           {randu({k, n}, dtype, 2), randu({n, k}, dtype, 3).t()}) {
+        at::Tensor expected = at::empty({m, n}, dtype);
+        at::native::cpublas::gemm(mm_params(a, b, expected));
+        at::Tensor c = at::empty({m, n}, dtype);
+        GemmParams params = mm_params(a, b, c);
+        const PackedB packed = at::native::cpublas::pack_b(params);
+        params.b = nullptr;
+        params.b_packed = &packed;
+        at::native::cpublas::gemm(params);
+        if (m > 12) {
+          ASSERT_TRUE(bitwise_equal(c, expected)) << m << "x" << k << "x" << n;
+          continue;
+        }
+        for (int64_t i = 0; i < c.numel(); ++i) {
+          ASSERT_NEAR(at_flat(c, i), at_flat(expected, i), tol) << i;
+        }
+      }
+    }
+  }
+}
+
+TEST_F(PrepackCacheTest, mm_reads_the_prepacked_weight) {
+  at::Tensor x = randu({20, 64}, at::ScalarType::Float, 1);
+  at::Tensor w = randu({32, 64}, at::ScalarType::Float, 2);
+  at::Tensor expected = x.mm(w.t());
+  at::native::prepack_mm_weight(w.t());
+  ASSERT_GE(at::native::prepack_cache_nbytes(), 32 * 64 * sizeof(float));
+  // another view of the weight with the same geometry finds the entry
+  ASSERT_TRUE(at::native::find_prepacked_mm_weight(w.t()).has_value());
+  ASSERT_FALSE(at::native::find_prepacked_mm_weight(w.slice(0, 0, 16).t())
+                   .has_value());
+  overwrite_first_behind_cache(w, 100);
+  ASSERT_TRUE(bitwise_equal(x.mm(w.t()), expected));
+}
+
+TEST_F(PrepackCacheTest, writes_make_the_entry_stale) {
+  at::Tensor x = randu({20, 64}, at::ScalarType::Float, 1);
+  at::Tensor w = randu({64, 32}, at::ScalarType::Float, 2);
+  at::native::prepack_mm_weight(w);
+  // through a view of the weight
+  w.slice(0, 10, 11).fill_(0.5);
+  ASSERT_FALSE(at::native::find_prepacked_mm_weight(w).has_value());
+  ASSERT_EQ(at::native::prepack_cache_nbytes(), 0);
+  at::Tensor y = x.mm(w);
+  for (int64_t j = 0; j < 32; ++j) {
+    double expected = 0;
+    for (int64_t p = 0; p < 64; ++p) {
+      expected += at_flat(x, p) * at_flat(w, p * 32 + j);
+    }
+    ASSERT_NEAR(at_flat(y, j), expected, 1e-4);
+  }
+}
+
+TEST_F(PrepackCacheTest, writes_through_a_held_pointer_need_a_bump) {
+  at::Tensor x = randu({20, 64}, at::ScalarType::Float, 1);
+  at::Tensor w = randu({64, 32}, at::ScalarType::Float, 2);
+  float* data = w.mutable_data_ptr<float>();
+  at::native::prepack_mm_weight(w);
+  // the access was counted before the packing, the write is not
+  data[0] = 1;
+  ASSERT_TRUE(at::native::find_prepacked_mm_weight(w).has_value());
+  w.storage().bump_version();
+  ASSERT_FALSE(at::native::find_prepacked_mm_weight(w).has_value());
+  at::Tensor y = x.mm(w);
+  double expected = 0;
+  for (int64_t p = 0; p < 64; ++p) {
+    expected += at_flat(x, p) * at_flat(w, p * 32);
+  }
+  ASSERT_NEAR(at_flat(y, 0), expected, 1e-4);
+
+  // in-place ops bump the version once they are done as well
+  const uint64_t version = w.storage().version();
+  w.fill_(0.5);
+  const uint64_t filled = w.storage().version();
+  ASSERT_GE(filled, version + 2);
+  w.copy_(x.slice(0, 0, 1).view({64}).unsqueeze(1).expand({64, 32}));
+  ASSERT_GE(w.storage().version(), filled + 2);
+}
+
+TEST_F(PrepackCacheTest, weights_normalized_in_place_are_packed_again) {
+  at::Tensor x = randu({20, 64}, at::ScalarType::Float, 1);
+  at::Tensor w = randu({64, 32}, at::ScalarType::Float, 2);
+  const auto expect_mm_reads = [&](const at::Tensor& weight) {
+    at::Tensor y = x.mm(weight);
+    for (int64_t j = 0; j < 32; ++j) {
+      double expected = 0;
+      for (int64_t p = 0; p < 64; ++p) {
+        expected += at_flat(x, p) * at_flat(weight, p * 32 + j);
+      }
+      ASSERT_NEAR(at_flat(y, j), expected, 1e-4);
+    }
+  };
+  at::native::prepack_mm_weight(w);
+  uint64_t version = w.storage().version();
+  at::layer_norm_(w, {32});
+  ASSERT_GE(w.storage().version(), version + 2);
+  ASSERT_FALSE(at::native::find_prepacked_mm_weight(w).has_value());
+  expect_mm_reads(w);
+
+  at::native::prepack_mm_weight(w);
+  version = w.storage().version();
+  at::rms_norm_(w, {32}, randu({32}, at::ScalarType::Float, 3));
+  ASSERT_GE(w.storage().version(), version + 2);
+  ASSERT_FALSE(at::native::find_prepacked_mm_weight(w).has_value());
+  expect_mm_reads(w);
+}
+
+TEST_F(PrepackCacheTest, entries_of_freed_weights_are_dropped) {
+  at::Tensor w = randu({64, 32}, at::ScalarType::Float, 2);
+  at::native::prepack_mm_weight(randu({64, 32}, at::ScalarType::Float, 1));
+  const size_t nbytes = at::native::prepack_cache_nbytes();
+  at::native::prepack_mm_weight(w);
+  ASSERT_EQ(at::native::prepack_cache_nbytes(), nbytes);
+  // packing a weight again replaces its entry
+  at::native::prepack_mm_weight(w);
+  ASSERT_EQ(at::native::prepack_cache_nbytes(), nbytes);
+}
+
+TEST_F(PrepackCacheTest, least_recently_used_entries_are_evicted) {
+  at::Tensor w0 = randu({64, 32}, at::ScalarType::Float, 1);
+  at::Tensor w1 = randu({64, 32}, at::ScalarType::Float, 2);
+  at::Tensor w2 = randu({64, 32}, at::ScalarType::Float, 3);
+  at::native::prepack_mm_weight(w0);
+  const size_t entry_nbytes = at::native::prepack_cache_nbytes();
+  at::native::set_prepack_cache_limit(2 * entry_nbytes);
+  at::native::prepack_mm_weight(w1);
+  ASSERT_TRUE(at::native::find_prepacked_mm_weight(w0).has_value());
+  at::native::prepack_mm_weight(w2);
+  ASSERT_TRUE(at::native::find_prepacked_mm_weight(w0).has_value());
+  ASSERT_FALSE(at::native::find_prepacked_mm_weight(w1).has_value());
+  ASSERT_TRUE(at::native::find_prepacked_mm_weight(w2).has_value());
+  at::native::set_prepack_cache_limit(entry_nbytes);
+  ASSERT_EQ(at::native::prepack_cache_nbytes(), entry_nbytes);
+  ASSERT_TRUE(at::native::find_prepacked_mm_weight(w2).has_value());
+  // an entry larger than the limit is not kept
+  at::native::prepack_mm_weight(randu({64, 64}, at::ScalarType::Float, 4));
+  ASSERT_EQ(at::native::prepack_cache_nbytes(), entry_nbytes);
+}
+
+TEST_F(PrepackCacheTest, failed_allocation_empties_the_cache) {
+  at::native::prepack_mm_weight(randu({64, 32}, at::ScalarType::Float, 1));
+  ASSERT_GT(at::native::prepack_cache_nbytes(), 0);
+  ASSERT_THROW(
+      c10::GetCPUAllocator()->allocate(size_t(1) << 62), std::bad_alloc);
+  ASSERT_EQ(at::native::prepack_cache_nbytes(), 0);
+}
+
+TEST_F(PrepackCacheTest, checks_arguments) {
+  ASSERT_THROW(at::native::prepack_mm_weight(at::empty({4})), c10::Error);
+  ASSERT_THROW(
+      at::native::prepack_mm_weight(at::empty({4, 4}, at::ScalarType::Int)),
+      c10::Error);
+  // sparse weights have no storage to key on
+  at::Tensor w = randu({8, 4});
+  ASSERT_THROW(at::native::prepack_mm_weight(w.to_sparse()), c10::Error);
+  ASSERT_THROW(
+      at::native::find_prepacked_mm_weight(w.to_sparse_csr()), c10::Error);
+  at::Tensor a = at::empty({2, 8});
+  at::Tensor b = at::empty({8, 4});
+  at::Tensor c = at::empty({2, 4});
+  GemmParams params = mm_params(a, b, c);
+  const PackedB packed = at::native::cpublas::pack_b(params);
+  params.n = 3;
+  params.b_packed = &packed;
+  ASSERT_THROW(at::native::cpublas::gemm(params), c10::Error);
+}
@@ -0,0 +1,453 @@
+#include <ATen/ATen.h>
+#include <ATen/native/AffineQuantizer.h>
+#include <ATen/native/CPUBlas.h>
+#include <ATen/quantized/Quantizer.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+using at::ScalarType;
+
+// a Float tensor of the given sizes with uniform randoms in [lo, hi)
+at::Tensor rand_float(
+    c10::IntArrayRef sizes,
+    float lo,
+    float hi,
+    uint32_t seed = 0) {
+  at::Tensor t = at::empty(sizes);
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> dist(lo, hi);
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    t.mutable_data_ptr<float>()[i] = dist(gen);
+  }
+  return t;
+}
+
+// an integer tensor of the given sizes and dtype with uniform randoms in
+// [lo, hi]
+at::Tensor rand_int(
+    c10::IntArrayRef sizes,
+    ScalarType dtype,
+    int lo,
+    int hi,
+    uint32_t seed = 0) {
+  at::Tensor t = at::empty(sizes, dtype);
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> dist(lo, hi);
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    if (dtype == ScalarType::Byte) {
+      t.mutable_data_ptr<uint8_t>()[i] = static_cast<uint8_t>(dist(gen));
+    } else {
+      t.mutable_data_ptr<int8_t>()[i] = static_cast<int8_t>(dist(gen));
+    }
+  }
+  return t;
+}
+
+// the stored integer at flat index i of a contiguous int_repr()
+int64_t int_at(const at::Tensor& ints, int64_t i) {
+  switch (ints.scalar_type()) {
+    case ScalarType::Char:
+      return ints.const_data_ptr<int8_t>()[i];
+    case ScalarType::Byte:
+      return ints.const_data_ptr<uint8_t>()[i];
+    default:
+      return ints.const_data_ptr<int32_t>()[i];
+  }
+}
+
+// quantize_val() of x to dtype, as an integer
+int64_t reference_quantize(
+    ScalarType dtype,
+    double scale,
+    int64_t zero_point,
+    float x) {
+  switch (dtype) {
+    case ScalarType::QInt8:
+      return at::native::quantize_val<c10::qint8>(scale, zero_point, x).val_;
+    case ScalarType::QUInt8:
+      return at::native::quantize_val<c10::quint8>(scale, zero_point, x).val_;
+    default:
+      return at::native::quantize_val<c10::qint32>(scale, zero_point, x).val_;
+  }
+}
+
+struct QParams {
+  ScalarType dtype;
+  double scale;
+  int64_t zero_point;
+};
+
+const std::vector<QParams>& qparams() {
+  static const std::vector<QParams> params = {
+      {ScalarType::QInt8, 0.05, 0},
+      {ScalarType::QInt8, 0.3, -7},
+      {ScalarType::QUInt8, 0.02, 128},
+      {ScalarType::QUInt8, 0.1, 3},
+      {ScalarType::QInt32, 1e-4, 5},
+  };
+  return params;
+}
+
+} // namespace
+
+TEST(QuantizedTest, quantize_per_tensor_matches_quantize_val) {
+  for (const QParams& q : qparams()) {
+    // below a vector, across a staging buffer, across threads
+    for (int64_t n : {1, 7, 300, 100000}) {
+      at::Tensor x = rand_float({n}, -8.f, 8.f, static_cast<uint32_t>(n));
+      // values exactly halfway between two steps round to even
+      for (int64_t i = 0; i < std::min<int64_t>(n, 20); ++i) {
+        x.mutable_data_ptr<float>()[i] =
+            static_cast<float>((static_cast<double>(i) - 10 + 0.5) * q.scale);
+      }
+      at::Tensor qx =
+          at::quantize_per_tensor(x, q.scale, q.zero_point, q.dtype);
+      ASSERT_EQ(qx.scalar_type(), q.dtype);
+      ASSERT_TRUE(qx.is_quantized());
+      ASSERT_EQ(qx.qscheme(), at::kPerTensorAffine);
+      ASSERT_EQ(qx.q_scale(), q.scale);
+      ASSERT_EQ(qx.q_zero_point(), q.zero_point);
+      const at::Tensor ints = qx.int_repr();
+      ASSERT_EQ(ints.scalar_type(), c10::toUnderlying(q.dtype));
+      const at::Tensor dq = qx.dequantize();
+      ASSERT_EQ(dq.scalar_type(), ScalarType::Float);
+      for (int64_t i = 0; i < n; ++i) {
+        const float xi = x.const_data_ptr<float>()[i];
+        const int64_t expected =
+            reference_quantize(q.dtype, q.scale, q.zero_point, xi);
+        ASSERT_EQ(int_at(ints, i), expected) << q.dtype << " " << xi;
+        ASSERT_EQ(
+            dq.const_data_ptr<float>()[i],
+            static_cast<float>(expected - q.zero_point) *
+                static_cast<float>(q.scale))
+            << q.dtype << " " << xi;
+      }
+    }
+  }
+}
+
+TEST(QuantizedTest, quantize_saturates) {
+  at::Tensor x = at::empty({4});
+  float* data = x.mutable_data_ptr<float>();
+  data[0] = 1e6f;
+  data[1] = -1e6f;
+  data[2] = std::numeric_limits<float>::infinity();
+  data[3] = -std::numeric_limits<float>::infinity();
+  const at::Tensor q8 =
+      at::quantize_per_tensor(x, 0.1, 10, ScalarType::QInt8).int_repr();
+  EXPECT_EQ(int_at(q8, 0), 127);
+  EXPECT_EQ(int_at(q8, 1), -128);
+  EXPECT_EQ(int_at(q8, 2), 127);
+  EXPECT_EQ(int_at(q8, 3), -128);
+  const at::Tensor qu8 =
+      at::quantize_per_tensor(x, 0.1, 10, ScalarType::QUInt8).int_repr();
+  EXPECT_EQ(int_at(qu8, 0), 255);
+  EXPECT_EQ(int_at(qu8, 1), 0);
+  const at::Tensor q32 =
+      at::quantize_per_tensor(x, 1e-6, 0, ScalarType::QInt32).int_repr();
+  EXPECT_EQ(int_at(q32, 0), std::numeric_limits<int32_t>::max());
+  EXPECT_EQ(int_at(q32, 1), std::numeric_limits<int32_t>::min());
+}
+
+TEST(QuantizedTest, quantize_per_channel_matches_quantize_val) {
+  // the channels in the middle (whole rows per channel), and innermost
+  // (one element per channel)
+  for (int64_t axis : {0, 1, 2}) {
+    for (ScalarType dtype :
+         {ScalarType::QInt8, ScalarType::QUInt8, ScalarType::QInt32}) {
+      const std::vector<int64_t> sizes = {3, 5, 40};
+      at::Tensor x = rand_float(sizes, -4.f, 4.f, 1);
+      const int64_t channels = sizes[axis];
+      at::Tensor scales = at::empty({channels}, ScalarType::Double);
+      at::Tensor zero_points = at::empty({channels}, ScalarType::Long);
+      for (int64_t c = 0; c < channels; ++c) {
+        scales.mutable_data_ptr<double>()[c] =
+            0.01 * static_cast<double>(c + 1);
+        zero_points.mutable_data_ptr<int64_t>()[c] =
+            dtype == ScalarType::QUInt8 ? 100 + c : c - 2;
+      }
+      at::Tensor qx =
+          at::quantize_per_channel(x, scales, zero_points, axis, dtype);
+      ASSERT_EQ(qx.qscheme(), at::kPerChannelAffine);
+      ASSERT_EQ(qx.q_per_channel_axis(), axis);
+      const at::Tensor ints = qx.int_repr();
+      const at::Tensor dq = qx.dequantize();
+      for (int64_t i = 0; i < x.numel(); ++i) {
+        int64_t c = i;
+        for (int64_t d = 2; d > axis; --d) {
+          c /= sizes[d];
+        }
+        c %= channels;
+        const double scale = scales.const_data_ptr<double>()[c];
+        const int64_t zero_point = zero_points.const_data_ptr<int64_t>()[c];
+        const int64_t expected = reference_quantize(
+            dtype, scale, zero_point, x.const_data_ptr<float>()[i]);
+        ASSERT_EQ(int_at(ints, i), expected) << axis << " " << i;
+        ASSERT_EQ(
+            dq.const_data_ptr<float>()[i],
+            static_cast<float>(expected - zero_point) *
+                static_cast<float>(scale));
+      }
+    }
+  }
+}
+
+TEST(QuantizedTest, views_keep_quantization) {
+  at::Tensor x = rand_float({4, 6}, -2.f, 2.f, 2);
+  at::Tensor scales = at::empty({4}, ScalarType::Double);
+  at::Tensor zero_points = at::empty({4}, ScalarType::Long);
+  for (int64_t c = 0; c < 4; ++c) {
+    scales.mutable_data_ptr<double>()[c] = 0.02 * static_cast<double>(c + 1);
+    zero_points.mutable_data_ptr<int64_t>()[c] = c;
+  }
+  const at::Tensor qx =
+      at::quantize_per_channel(x, scales, zero_points, 0, ScalarType::QInt8);
+  const at::Tensor dq = qx.dequantize();
+
+  // the channels follow their dim
+  const at::Tensor qt = qx.t();
+  ASSERT_EQ(qt.q_per_channel_axis(), 1);
+  const at::Tensor dqt = qt.dequantize();
+  const at::Tensor unsqueezed = qx.unsqueeze(0);
+  ASSERT_EQ(unsqueezed.q_per_channel_axis(), 1);
+  for (int64_t i = 0; i < 4; ++i) {
+    for (int64_t j = 0; j < 6; ++j) {
+      ASSERT_EQ(
+          dqt.const_data_ptr<float>()[j * 4 + i],
+          dq.const_data_ptr<float>()[i * 6 + j]);
+    }
+  }
+
+  // a slice of the channels keeps theirs
+  const at::Tensor sliced = qx.slice(0, 1, 4, 2);
+  ASSERT_EQ(sliced.q_per_channel_scales().numel(), 2);
+  ASSERT_EQ(sliced.q_per_channel_scales().const_data_ptr<double>()[1], 0.08);
+  ASSERT_EQ(sliced.q_per_channel_zero_points().const_data_ptr<int64_t>()[0], 1);
+  const at::Tensor dsliced = sliced.dequantize();
+  for (int64_t j = 0; j < 6; ++j) {
+    ASSERT_EQ(
+        dsliced.const_data_ptr<float>()[6 + j],
+        dq.const_data_ptr<float>()[3 * 6 + j]);
+  }
+
+  // a single channel is quantized per tensor
+  const at::Tensor row = qx.select(0, 2);
+  ASSERT_EQ(row.qscheme(), at::kPerTensorAffine);
+  ASSERT_EQ(row.q_scale(), 0.06);
+  ASSERT_EQ(row.q_zero_point(), 2);
+  const at::Tensor column = qx.select(1, 3);
+  ASSERT_EQ(column.q_per_channel_axis(), 0);
+
+  // views of a tensor quantized per tensor share its quantizer
+  const at::Tensor qp = at::quantize_per_tensor(x, 0.1, 1, ScalarType::QUInt8);
+  const at::Tensor view = qp.view({24});
+  ASSERT_TRUE(view.quantizer()->equalTo(qp.quantizer()));
+  ASSERT_EQ(view.q_scale(), 0.1);
+  EXPECT_THROW(qx.view({24}), c10::Error);
+}
+
+TEST(QuantizedTest, make_quantized_tensor_keeps_integers) {
+  const at::Tensor ints = rand_int({5, 7}, ScalarType::Char, -128, 127, 3);
+  const at::Tensor q = at::_make_per_tensor_quantized_tensor(ints, 0.5, -3);
+  ASSERT_EQ(q.scalar_type(), ScalarType::QInt8);
+  const at::Tensor back = q.int_repr();
+  for (int64_t i = 0; i < ints.numel(); ++i) {
+    ASSERT_EQ(int_at(back, i), int_at(ints, i));
+  }
+  // int_repr() of a strided view
+  const at::Tensor back_t = q.t().int_repr();
+  for (int64_t i = 0; i < 5; ++i) {
+    for (int64_t j = 0; j < 7; ++j) {
+      ASSERT_EQ(
+          back_t.const_data_ptr<int8_t>()
+              [back_t.storage_offset() + j * back_t.stride(0) +
+               i * back_t.stride(1)],
+          int_at(ints, i * 7 + j));
+    }
+  }
+  const at::Tensor d = q.t().dequantize();
+  ASSERT_TRUE(d.is_contiguous());
+  ASSERT_EQ(
+      d.const_data_ptr<float>()[1 * 5 + 2],
+      0.5f * static_cast<float>(int_at(ints, 2 * 7 + 1) + 3));
+}
+
+TEST(QuantizedTest, checks_arguments) {
+  const at::Tensor x = rand_float({2, 3}, -1.f, 1.f);
+  EXPECT_THROW(at::quantize_per_tensor(x, 0, 0, ScalarType::QInt8), c10::Error);
+  EXPECT_THROW(
+      at::quantize_per_tensor(x, std::nan(""), 0, ScalarType::QInt8),
+      c10::Error);
+  EXPECT_THROW(
+      at::quantize_per_tensor(x, 0.1, 128, ScalarType::QInt8), c10::Error);
+  EXPECT_THROW(
+      at::quantize_per_tensor(x, 0.1, -1, ScalarType::QUInt8), c10::Error);
+  EXPECT_THROW(
+      at::quantize_per_tensor(x, 0.1, 0, ScalarType::Float), c10::Error);
+  EXPECT_THROW(
+      at::quantize_per_tensor(
+          x.to(ScalarType::Double), 0.1, 0, ScalarType::QInt8),
+      c10::Error);
+  // one scale per channel
+  at::Tensor scales = at::empty({3}, ScalarType::Double);
+  scales.fill_(0.1);
+  at::Tensor zero_points = at::empty({3}, ScalarType::Long);
+  zero_points.fill_(0);
+  EXPECT_THROW(
+      at::quantize_per_channel(x, scales, zero_points, 0, ScalarType::QInt8),
+      c10::Error);
+  EXPECT_NO_THROW(
+      at::quantize_per_channel(x, scales, zero_points, 1, ScalarType::QInt8));
+  // quantized dtypes need their parameters
+  EXPECT_THROW(at::empty({2}, ScalarType::QInt8), c10::Error);
+  // and other operators do not know them
+  const at::Tensor q = at::quantize_per_tensor(x, 0.1, 0, ScalarType::QInt8);
+  EXPECT_THROW(q.sum(), c10::Error);
+  EXPECT_THROW(q.to(ScalarType::Float), c10::Error);
+  EXPECT_THROW(x.int_repr(), c10::Error);
+  EXPECT_THROW(q.q_per_channel_axis(), c10::Error);
+}
+
+TEST(QuantizedTest, qgemm_int32_sums_are_exact) {
+  // {m, k, n}: single elements, odd k, few rows (streamed when B is
+  // transposed), edge tiles, several blocks along k, more than a block of
+  // rows and of columns
+  const std::vector<std::array<int64_t, 3>> shapes = {
+      {1, 1, 1},
+      {3, 5, 2},
+      {4, 1001, 9},
+      {7, 33, 19},
+      {13, 300, 37},
+      {300, 67, 1100},
+      {50, 600, 40},
+  };
+  for (const auto& [m, k, n] : shapes) {
+    for (bool transposed_b : {false, true}) {
+      const auto seed = static_cast<uint32_t>(m * 7 + k * 3 + n);
+      const at::Tensor a = rand_int({m, k}, ScalarType::Byte, 0, 255, seed);
+      // B as [n, k] read transposed, like the weights of a linear layer
+      const at::Tensor b = transposed_b
+          ? rand_int({n, k}, ScalarType::Char, -128, 127, seed + 1).t()
+          : rand_int({k, n}, ScalarType::Char, -128, 127, seed + 1);
+      std::vector<int32_t> b_zero_points(n);
+      for (int64_t j = 0; j < n; ++j) {
+        b_zero_points[j] = static_cast<int32_t>(j % 256) - 128;
+      }
+      const int32_t a_zero_point = 255;
+      at::Tensor c = at::empty({m, n}, ScalarType::Int);
+      at::native::cpublas::QGemmParams p;
+      p.m = m;
+      p.n = n;
+      p.k = k;
+      p.a = a.const_data_ptr<uint8_t>();
+      p.a_row_stride = a.stride(0);
+      p.a_col_stride = a.stride(1);
+      p.a_zero_point = a_zero_point;
+      p.b = static_cast<const int8_t*>(b.const_data_ptr());
+      p.b_row_stride = b.stride(0);
+      p.b_col_stride = b.stride(1);
+      p.b_zero_points = b_zero_points.data();
+      p.c = c.mutable_data_ptr();
+      p.c_row_stride = c.stride(0);
+      p.c_col_stride = c.stride(1);
+      at::native::cpublas::qgemm(p);
+      const auto* a_data = a.const_data_ptr<uint8_t>();
+      const auto* b_data = static_cast<const int8_t*>(b.const_data_ptr());
+      for (int64_t i = 0; i < m; ++i) {
+        for (int64_t j = 0; j < n; ++j) {
+          int64_t expected = 0;
+          for (int64_t l = 0; l < k; ++l) {
+            expected += (int64_t(a_data[i * k + l]) - a_zero_point) *
+                (int64_t(b_data[l * b.stride(0) + j * b.stride(1)]) -
+                 b_zero_points[j]);
+          }
+          ASSERT_EQ(c.const_data_ptr<int32_t>()[i * n + j], expected)
+              << "at (" << i << ", " << j << ") of " << m << "x" << k
+              << " @ " << k << "x" << n;
+        }
+      }
+    }
+  }
+}
+
+TEST(QuantizedTest, quantized_linear_matches_reference) {
+  for (bool per_channel : {false, true}) {
+    for (const auto& [m, k, n] : std::vector<std::array<int64_t, 3>>{
+             {1, 64, 10}, {9, 129, 33}, {64, 256, 70}}) {
+      const auto seed = static_cast<uint32_t>(m + k + n);
+      const at::Tensor x = rand_float({m, k}, -1.f, 3.f, seed);
+      const at::Tensor w = rand_float({n, k}, -0.5f, 0.5f, seed + 1);
+      const at::Tensor bias = rand_float({n}, -1.f, 1.f, seed + 2);
+      const at::Tensor qx =
+          at::quantize_per_tensor(x, 4.0 / 255, 64, ScalarType::QUInt8);
+      at::Tensor qw;
+      if (per_channel) {
+        at::Tensor scales = at::empty({n}, ScalarType::Double);
+        at::Tensor zero_points = at::empty({n}, ScalarType::Long);
+        for (int64_t j = 0; j < n; ++j) {
+          scales.mutable_data_ptr<double>()[j] =
+              0.002 + 0.0001 * static_cast<double>(j);
+          zero_points.mutable_data_ptr<int64_t>()[j] = j % 5 - 2;
+        }
+        qw = at::quantize_per_channel(
+            w, scales, zero_points, 0, ScalarType::QInt8);
+      } else {
+        qw = at::quantize_per_tensor(w, 0.5 / 127, 0, ScalarType::QInt8);
+      }
+      const double out_scale = 0.05;
+      const int64_t out_zero_point = 120;
+      const at::Tensor y =
+          at::quantized_linear(qx, qw, bias, out_scale, out_zero_point);
+      ASSERT_EQ(y.scalar_type(), ScalarType::QUInt8);
+      ASSERT_EQ(y.size(0), m);
+      ASSERT_EQ(y.size(1), n);
+      ASSERT_EQ(y.q_scale(), out_scale);
+      const at::Tensor ys = y.int_repr();
+      // the dequantized operands multiplied in double, then quantized
+      const at::Tensor dx = qx.dequantize();
+      const at::Tensor dw = qw.dequantize();
+      for (int64_t i = 0; i < m; ++i) {
+        for (int64_t j = 0; j < n; ++j) {
+          double acc = bias.const_data_ptr<float>()[j];
+          for (int64_t l = 0; l < k; ++l) {
+            acc += double(dx.const_data_ptr<float>()[i * k + l]) *
+                dw.const_data_ptr<float>()[j * k + l];
+          }
+          const double expected = std::clamp<double>(
+              std::nearbyint(acc / out_scale) + out_zero_point, 0, 255);
+          ASSERT_NEAR(int_at(ys, i * n + j), expected, 1)
+              << "at (" << i << ", " << j << ")";
+        }
+      }
+    }
+  }
+}
+
+TEST(QuantizedTest, quantized_linear_checks_arguments) {
+  const at::Tensor x = at::quantize_per_tensor(
+      rand_float({2, 4}, 0.f, 1.f), 0.01, 0, ScalarType::QUInt8);
+  const at::Tensor w = at::quantize_per_tensor(
+      rand_float({3, 4}, -1.f, 1.f), 0.01, 0, ScalarType::QInt8);
+  EXPECT_NO_THROW(at::quantized_linear(x, w, std::nullopt, 0.1, 0));
+  // a QInt8 input, a QUInt8 weight, mismatched features
+  const at::Tensor x8 = at::quantize_per_tensor(
+      rand_float({2, 4}, 0.f, 1.f), 0.01, 0, ScalarType::QInt8);
+  EXPECT_THROW(at::quantized_linear(x8, w, std::nullopt, 0.1, 0), c10::Error);
+  EXPECT_THROW(at::quantized_linear(x, x, std::nullopt, 0.1, 0), c10::Error);
+  EXPECT_THROW(
+      at::quantized_linear(x, w.slice(1, 0, 3), std::nullopt, 0.1, 0),
+      c10::Error);
+  EXPECT_THROW(
+      at::quantized_linear(x, w, at::empty({4}), 0.1, 0), c10::Error);
+  EXPECT_THROW(at::quantized_linear(x, w, std::nullopt, 0.1, 256), c10::Error);
+  EXPECT_THROW(at::quantized_linear(x, w, std::nullopt, 0, 0), c10::Error);
+}
@@ -0,0 +1,277 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+#include "test_helpers.h"
+
+using at::test::at_index;
+using at::test::bitwise_equal;
+using at::test::randu;
+
+TEST(ReduceOpsTest, sum_all_matches_reference) {
+  // crosses several chunk boundaries
+  at::Tensor t = randu({100003});
+  double expected = 0;
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    expected += t.const_data_ptr<float>()[i];
+  }
+  at::Tensor s = t.sum();
+  ASSERT_EQ(s.dim(), 0);
+  ASSERT_NEAR(s.const_data_ptr<float>()[0], expected, 1e-3);
+}
+
+TEST(ReduceOpsTest, sum_over_each_dim) {
+  at::Tensor t = randu({5, 37, 70});
+  for (bool transposed : {false, true}) {
+    at::Tensor x = transposed ? randu({70, 37, 5}).permute({2, 1, 0}) : t;
+    for (int64_t dim = 0; dim < 3; ++dim) {
+      at::Tensor s = x.sum({dim});
+      ASSERT_EQ(s.dim(), 2);
+      at::Tensor k = x.sum({dim}, /*keepdim=*/true);
+      ASSERT_EQ(k.dim(), 3);
+      ASSERT_EQ(k.size(dim), 1);
+      for (int64_t i = 0; i < 5; ++i) {
+        for (int64_t j = 0; j < 37; ++j) {
+          for (int64_t l = 0; l < 70; ++l) {
+            int64_t index[3] = {i, j, l};
+            if (index[dim] != 0) {
+              continue;
+            }
+            double expected = 0;
+            for (int64_t r = 0; r < x.size(dim); ++r) {
+              index[dim] = r;
+              expected += at_index(x, {index[0], index[1], index[2]});
+            }
+            index[dim] = 0;
+            ASSERT_NEAR(
+                at_index(k, {index[0], index[1], index[2]}),
+                expected,
+                1e-4);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(ReduceOpsTest, sum_over_several_dims) {
+  at::Tensor t = randu({4, 6, 8});
+  at::Tensor s = t.sum({0, 2});
+  ASSERT_EQ(s.sizes(), c10::IntArrayRef({6}));
+  for (int64_t j = 0; j < 6; ++j) {
+    double expected = 0;
+    for (int64_t i = 0; i < 4; ++i) {
+      for (int64_t l = 0; l < 8; ++l) {
+        expected += at_index(t, {i, j, l});
+      }
+    }
+    ASSERT_NEAR(s.const_data_ptr<float>()[j], expected, 1e-5);
+  }
+  ASSERT_THROW(t.sum({1, -2}), c10::Error);
+  ASSERT_THROW(t.sum({3}), c10::Error);
+}
+
+TEST(ReduceOpsTest, results_do_not_depend_on_thread_count) {
+  const at::Tensor inputs[] = {
+      randu({100000}),
+      randu({3, 70000}),
+      randu({70000, 3}),
+      randu({33000, 8}).t(),
+      randu({16, 3000, 3}).permute({2, 0, 1}),
+  };
+  for (const at::Tensor& x : inputs) {
+    at::set_num_threads(1);
+    std::vector<at::Tensor> expected;
+    for (int64_t dim = 0; dim < x.dim(); ++dim) {
+      expected.push_back(x.sum({dim}));
+      expected.push_back(x.norm(2, {dim}));
+    }
+    expected.push_back(x.sum());
+    expected.push_back(x.mean());
+    for (int threads : {2, 3, 8}) {
+      at::set_num_threads(threads);
+      size_t i = 0;
+      for (int64_t dim = 0; dim < x.dim(); ++dim) {
+        ASSERT_TRUE(bitwise_equal(x.sum({dim}), expected[i++]))
+            << "threads " << threads << " dim " << dim;
+        ASSERT_TRUE(bitwise_equal(x.norm(2, {dim}), expected[i++]))
+            << "threads " << threads << " dim " << dim;
+      }
+      ASSERT_TRUE(bitwise_equal(x.sum(), expected[i++]));
+      ASSERT_TRUE(bitwise_equal(x.mean(), expected[i++]));
+    }
+  }
+  at::set_num_threads(1);
+}
+
+TEST(ReduceOpsTest, half_accumulates_in_float) {
+  at::Tensor t = at::empty({10000}, at::ScalarType::Half);
+  t.fill_(1);
+  // a Half accumulator would get stuck at 2048
+  at::Tensor s = t.sum();
+  ASSERT_EQ(s.scalar_type(), at::ScalarType::Half);
+  ASSERT_EQ(static_cast<float>(s.const_data_ptr<c10::Half>()[0]), 10000.f);
+  at::Tensor columns = t.view({100, 100}).sum({0});
+  for (int64_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(static_cast<float>(columns.const_data_ptr<c10::Half>()[i]), 100);
+  }
+  ASSERT_EQ(
+      static_cast<float>(t.mean().const_data_ptr<c10::Half>()[0]), 1.f);
+}
+
+TEST(ReduceOpsTest, bfloat16_accumulates_in_float) {
+  at::Tensor t = at::empty({10000}, at::ScalarType::BFloat16);
+  t.fill_(1);
+  // a BFloat16 accumulator would get stuck at 256
+  at::Tensor s = t.sum();
+  ASSERT_EQ(s.scalar_type(), at::ScalarType::BFloat16);
+  ASSERT_EQ(static_cast<float>(s.const_data_ptr<c10::BFloat16>()[0]), 9984.f);
+  ASSERT_EQ(
+      static_cast<float>(t.mean().const_data_ptr<c10::BFloat16>()[0]), 1.f);
+  at::Tensor m = t.view({100, 100}).amax({1});
+  for (int64_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(static_cast<float>(m.const_data_ptr<c10::BFloat16>()[i]), 1.f);
+  }
+}
+
+TEST(ReduceOpsTest, integer_sums_widen) {
+  at::Tensor t = at::empty({1000}, at::ScalarType::Byte);
+  t.fill_(255);
+  at::Tensor s = t.sum();
+  ASSERT_EQ(s.scalar_type(), at::ScalarType::Long);
+  ASSERT_EQ(s.const_data_ptr<int64_t>()[0], 255000);
+
+  at::Tensor u = at::empty({3}, at::ScalarType::UInt32);
+  u.fill_(4000000000.0);
+  ASSERT_EQ(u.sum().scalar_type(), at::ScalarType::UInt64);
+  ASSERT_EQ(u.sum().const_data_ptr<uint64_t>()[0], 12000000000ull);
+
+  at::Tensor b = at::empty({7}, at::ScalarType::Bool);
+  b.fill_(1);
+  ASSERT_EQ(b.sum().const_data_ptr<int64_t>()[0], 7);
+
+  ASSERT_THROW(t.mean(), c10::Error);
+}
+
+TEST(ReduceOpsTest, empty_reductions) {
+  at::Tensor t = at::empty({0, 3});
+  at::Tensor s = t.sum({0});
+  ASSERT_EQ(s.sizes(), c10::IntArrayRef({3}));
+  for (int64_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(s.const_data_ptr<float>()[i], 0.f);
+    ASSERT_TRUE(std::isnan(t.mean({0}).const_data_ptr<float>()[i]));
+  }
+  ASSERT_EQ(t.sum({1}).numel(), 0);
+  ASSERT_EQ(t.amax({1}).numel(), 0);
+  ASSERT_THROW(t.amax({0}), c10::Error);
+  ASSERT_THROW(t.max(), c10::Error);
+  ASSERT_THROW(t.argmax(), c10::Error);
+
+  at::Tensor scalar = at::empty({});
+  scalar.fill_(2.5);
+  ASSERT_EQ(scalar.sum().const_data_ptr<float>()[0], 2.5f);
+  ASSERT_EQ(scalar.sum({0}).dim(), 0);
+  ASSERT_EQ(scalar.argmax().const_data_ptr<int64_t>()[0], 0);
+}
+
+TEST(ReduceOpsTest, max_min_propagate_nan) {
+  at::Tensor t = randu({3, 1000});
+  float* data = t.mutable_data_ptr<float>();
+  data[1 * 1000 + 517] = std::numeric_limits<float>::quiet_NaN();
+  at::Tensor m = t.amax({1});
+  ASSERT_FALSE(std::isnan(m.const_data_ptr<float>()[0]));
+  ASSERT_TRUE(std::isnan(m.const_data_ptr<float>()[1]));
+  ASSERT_TRUE(std::isnan(t.amin({1}).const_data_ptr<float>()[1]));
+  ASSERT_TRUE(std::isnan(t.max().const_data_ptr<float>()[0]));
+  ASSERT_EQ(t.argmax({1}).const_data_ptr<int64_t>()[1], 517);
+  ASSERT_EQ(t.argmin().const_data_ptr<int64_t>()[0], 1517);
+
+  float expected_max = -2, expected_min = 2;
+  for (int64_t i = 0; i < 1000; ++i) {
+    expected_max = std::max(expected_max, data[2 * 1000 + i]);
+    expected_min = std::min(expected_min, data[2 * 1000 + i]);
+  }
+  ASSERT_EQ(m.const_data_ptr<float>()[2], expected_max);
+  ASSERT_EQ(t.amin({1}).const_data_ptr<float>()[2], expected_min);
+}
+
+TEST(ReduceOpsTest, max_min_integers) {
+  at::Tensor t = at::empty({4, 33}, at::ScalarType::Short);
+  int16_t* data = t.mutable_data_ptr<int16_t>();
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    data[i] = static_cast<int16_t>((i * 7919) % 1001 - 500);
+  }
+  at::Tensor rows = t.amax({1});
+  at::Tensor columns = t.amin({0});
+  for (int64_t i = 0; i < 4; ++i) {
+    int16_t expected = std::numeric_limits<int16_t>::lowest();
+    for (int64_t j = 0; j < 33; ++j) {
+      expected = std::max(expected, data[i * 33 + j]);
+    }
+    ASSERT_EQ(rows.const_data_ptr<int16_t>()[i], expected);
+  }
+  for (int64_t j = 0; j < 33; ++j) {
+    int16_t expected = std::numeric_limits<int16_t>::max();
+    for (int64_t i = 0; i < 4; ++i) {
+      expected = std::min(expected, data[i * 33 + j]);
+    }
+    ASSERT_EQ(columns.const_data_ptr<int16_t>()[j], expected);
+  }
+}
+
+TEST(ReduceOpsTest, argmax_returns_first_logical_index) {
+  at::Tensor t = at::empty({6, 5});
+  t.fill_(0);
+  float* data = t.mutable_data_ptr<float>();
+  data[2 * 5 + 3] = 1;
+  data[4 * 5 + 1] = 1;
+  // the transpose is 5 x 6 with maxima at (3, 2) and (1, 4)
+  at::Tensor x = t.t();
+  ASSERT_EQ(x.argmax().const_data_ptr<int64_t>()[0], 1 * 6 + 4);
+  ASSERT_EQ(t.argmax().const_data_ptr<int64_t>()[0], 2 * 5 + 3);
+  at::Tensor per_row = x.argmax({1});
+  ASSERT_EQ(per_row.sizes(), c10::IntArrayRef({5}));
+  const int64_t expected[] = {0, 4, 0, 2, 0};
+  for (int64_t i = 0; i < 5; ++i) {
+    ASSERT_EQ(per_row.const_data_ptr<int64_t>()[i], expected[i]);
+  }
+  ASSERT_EQ(x.argmax({1}, /*keepdim=*/true).sizes(), c10::IntArrayRef({5, 1}));
+  ASSERT_EQ(x.argmin({0}).const_data_ptr<int64_t>()[2], 0);
+}
+
+TEST(ReduceOpsTest, norms) {
+  at::Tensor t = randu({7, 129});
+  t.mutable_data_ptr<float>()[5] = 0;
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  for (double p : {0.0, 1.0, 2.0, 3.0, 0.5, inf, -inf}) {
+    at::Tensor n = t.norm(p, {1});
+    for (int64_t i = 0; i < 7; ++i) {
+      double expected = 0;
+      if (p == inf) {
+        expected = 0;
+      } else if (p == -inf) {
+        expected = inf;
+      }
+      for (int64_t j = 0; j < 129; ++j) {
+        const double v = std::abs(at_index(t, {i, j}));
+        if (p == 0) {
+          expected += v != 0;
+        } else if (p == inf) {
+          expected = std::max(expected, v);
+        } else if (p == -inf) {
+          expected = std::min(expected, v);
+        } else {
+          expected += std::pow(v, p);
+        }
+      }
+      if (p != 0 and std::isfinite(p)) {
+        expected = std::pow(expected, 1 / p);
+      }
+      ASSERT_NEAR(n.const_data_ptr<float>()[i], expected, 1e-4 * expected)
+          << "p = " << p << ", row " << i;
+    }
+  }
+}
@@ -0,0 +1,181 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "test_helpers.h"
+
+using at::test::at_flat;
+using at::test::bitwise_equal;
+using at::test::uniform;
+
+namespace {
+
+// softmax of x along dim in double, indexed row-major like x
+std::vector<double> reference_softmax(const at::Tensor& x, int64_t dim) {
+  const int64_t n = x.size(dim);
+  int64_t inner = 1;
+  for (int64_t d = dim + 1; d < x.dim(); ++d) {
+    inner *= x.size(d);
+  }
+  std::vector<double> y(x.numel());
+  for (int64_t first = 0; first < x.numel(); ++first) {
+    // one row per first element, whose index along dim is 0
+    if (first / inner % n != 0) {
+      continue;
+    }
+    double max = -std::numeric_limits<double>::infinity();
+    for (int64_t k = 0; k < n; ++k) {
+      max = std::max(max, at_flat(x, first + k * inner));
+    }
+    double sum = 0;
+    for (int64_t k = 0; k < n; ++k) {
+      y[first + k * inner] = std::exp(at_flat(x, first + k * inner) - max);
+      sum += y[first + k * inner];
+    }
+    for (int64_t k = 0; k < n; ++k) {
+      y[first + k * inner] /= sum;
+    }
+  }
+  return y;
+}
+
+void expect_softmax_near(
+    const at::Tensor& y,
+    const at::Tensor& x,
+    int64_t dim,
+    double tol) {
+  ASSERT_EQ(y.sizes(), x.sizes());
+  ASSERT_EQ(y.scalar_type(), x.scalar_type());
+  const std::vector<double> expected = reference_softmax(x, dim);
+  for (int64_t i = 0; i < y.numel(); ++i) {
+    ASSERT_NEAR(at_flat(y, i), expected[i], tol)
+        << "at " << i << " along dim " << dim << " of " << x.sizes();
+  }
+}
+
+} // namespace
+
+TEST(SoftmaxTest, matches_reference_along_each_dim) {
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float,
+        at::ScalarType::Double,
+        at::ScalarType::Half,
+        at::ScalarType::BFloat16}) {
+    const double tol = dtype == at::ScalarType::Half ? 1e-3
+        : dtype == at::ScalarType::BFloat16          ? 1e-2
+                                                     : 1e-6;
+    at::Tensor x = uniform({3, 17, 40}, dtype, -4, 4);
+    for (int64_t dim = 0; dim < 3; ++dim) {
+      expect_softmax_near(x.softmax(dim), x, dim, tol);
+    }
+    expect_softmax_near(at::softmax(x, -1), x, 2, tol);
+  }
+}
+
+TEST(SoftmaxTest, rows_longer_than_a_chunk) {
+  // the running maximum grows from chunk to chunk: later chunks are larger
+  at::Tensor x = at::empty({2, 5000});
+  float* data = x.mutable_data_ptr<float>();
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    data[i] = static_cast<float>(i % 5000) / 100.f;
+  }
+  expect_softmax_near(x.softmax(1), x, 1, 1e-6);
+  // and shrinks
+  at::Tensor reversed = uniform({2, 3001}, at::ScalarType::Double, -50, 50);
+  expect_softmax_near(reversed.softmax(1), reversed, 1, 1e-12);
+}
+
+TEST(SoftmaxTest, reads_strided_inputs) {
+  at::Tensor base = uniform({20, 30}, at::ScalarType::Float, -4, 4);
+  for (const at::Tensor& x :
+       {base.t(), base.slice(1, 1, 30, 3), base.slice(0, 2, 9)}) {
+    for (int64_t dim = 0; dim < 2; ++dim) {
+      expect_softmax_near(x.softmax(dim), x, dim, 1e-6);
+    }
+  }
+}
+
+TEST(SoftmaxTest, in_place) {
+  for (at::ScalarType dtype :
+       {at::ScalarType::Float,
+        at::ScalarType::Half,
+        at::ScalarType::BFloat16}) {
+    const double tol = dtype == at::ScalarType::Half ? 1e-3
+        : dtype == at::ScalarType::BFloat16          ? 1e-2
+                                                     : 1e-6;
+    for (int64_t dim = 0; dim < 2; ++dim) {
+      at::Tensor x = uniform({9, 33}, dtype, -4, 4, 1);
+      at::Tensor expected = x.softmax(dim);
+      at::Tensor y = uniform({9, 33}, dtype, -4, 4, 1);
+      ASSERT_EQ(&y.softmax_(dim), &y);
+      ASSERT_TRUE(bitwise_equal(y, expected));
+      // through a transposed view
+      at::Tensor z = uniform({33, 9}, dtype, -4, 4, 2).t();
+      at::Tensor z_expected = z.softmax(dim);
+      z.softmax_(dim);
+      for (int64_t i = 0; i < z.numel(); ++i) {
+        ASSERT_NEAR(at_flat(z, i), at_flat(z_expected, i), tol);
+      }
+    }
+  }
+}
+
+TEST(SoftmaxTest, large_and_infinite_inputs) {
+  const float inf = std::numeric_limits<float>::infinity();
+  at::Tensor x = at::empty({4, 3});
+  const float values[] = {
+      1000, 1000, -1000, // would overflow without the maximum
+      -inf, 0, -inf, // masked out
+      -inf, -inf, -inf, // all masked: NaN, as in PyTorch
+      std::nanf(""), 0, 1};
+  std::memcpy(x.mutable_data_ptr<float>(), values, sizeof(values));
+  at::Tensor y = x.softmax(1);
+  const float* out = y.const_data_ptr<float>();
+  EXPECT_FLOAT_EQ(out[0], 0.5f);
+  EXPECT_FLOAT_EQ(out[1], 0.5f);
+  EXPECT_EQ(out[2], 0.f);
+  EXPECT_EQ(out[3], 0.f);
+  EXPECT_EQ(out[4], 1.f);
+  EXPECT_EQ(out[5], 0.f);
+  for (int64_t i = 6; i < 12; ++i) {
+    EXPECT_TRUE(std::isnan(out[i])) << i;
+  }
+}
+
+TEST(SoftmaxTest, degenerate_shapes) {
+  at::Tensor scalar = at::empty({});
+  scalar.fill_(3);
+  at::Tensor y = scalar.softmax(0);
+  ASSERT_EQ(y.dim(), 0);
+  EXPECT_EQ(y.const_data_ptr<float>()[0], 1.f);
+  EXPECT_EQ(at::empty({0, 4}).softmax(1).numel(), 0);
+  at::Tensor ones = uniform({5, 1}, at::ScalarType::Float, -4, 4).softmax(1);
+  for (int64_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(ones.const_data_ptr<float>()[i], 1.f);
+  }
+}
+
+TEST(SoftmaxTest, results_do_not_depend_on_thread_count) {
+  at::Tensor x = uniform({64, 2000}, at::ScalarType::Float, -4, 4);
+  at::set_num_threads(1);
+  at::Tensor one = x.softmax(1);
+  at::Tensor one_outer = x.softmax(0);
+  at::set_num_threads(4);
+  at::Tensor four = x.softmax(1);
+  at::Tensor four_outer = x.softmax(0);
+  at::set_num_threads(1);
+  ASSERT_TRUE(bitwise_equal(one, four));
+  ASSERT_TRUE(bitwise_equal(one_outer, four_outer));
+}
+
+TEST(SoftmaxTest, checks_arguments) {
+  ASSERT_THROW(at::empty({2, 3}).softmax(2), c10::Error);
+  ASSERT_THROW(at::empty({2, 3}).softmax(-3), c10::Error);
+  ASSERT_THROW(
+      at::empty({2, 3}, at::ScalarType::Long).softmax(1), c10::Error);
+}
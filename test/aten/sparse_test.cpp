@@ -0,0 +1,338 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+using at::ScalarType;
+
+// a Float tensor of small integers, zero with probability `sparsity`, so
+// that sums of products are exact in any order
+at::Tensor random_sparse_dense(
+    c10::IntArrayRef sizes,
+    double sparsity,
+    uint32_t seed = 0) {
+  at::Tensor t = at::empty(sizes);
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> keep(0, 1);
+  std::uniform_int_distribution<int> value(-4, 4);
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    const int v = value(gen);
+    t.mutable_data_ptr<float>()[i] =
+        keep(gen) < sparsity ? 0.0f : static_cast<float>(v == 0 ? 5 : v);
+  }
+  return t;
+}
+
+at::Tensor long_tensor(const std::vector<int64_t>& values) {
+  at::Tensor t =
+      at::empty({static_cast<int64_t>(values.size())}, ScalarType::Long);
+  std::copy(values.begin(), values.end(), t.mutable_data_ptr<int64_t>());
+  return t;
+}
+
+at::Tensor float_tensor(const std::vector<float>& values) {
+  at::Tensor t = at::empty({static_cast<int64_t>(values.size())});
+  std::copy(values.begin(), values.end(), t.mutable_data_ptr<float>());
+  return t;
+}
+
+std::vector<int64_t> longs(const at::Tensor& t) {
+  const int64_t* data = t.const_data_ptr<int64_t>();
+  return std::vector<int64_t>(data, data + t.numel());
+}
+
+std::vector<float> floats(const at::Tensor& t) {
+  const float* data = t.const_data_ptr<float>();
+  return std::vector<float>(data, data + t.numel());
+}
+
+void expect_same_dense(const at::Tensor& a, const at::Tensor& b) {
+  ASSERT_EQ(a.layout(), at::kStrided);
+  ASSERT_EQ(b.layout(), at::kStrided);
+  ASSERT_EQ(a.sizes(), b.sizes());
+  const at::Tensor ac = a.is_contiguous() ? a : at::empty(a.sizes()).copy_(a);
+  const at::Tensor bc = b.is_contiguous() ? b : at::empty(b.sizes()).copy_(b);
+  EXPECT_EQ(floats(ac), floats(bc));
+}
+
+} // namespace
+
+TEST(SparseTest, coo_round_trip) {
+  const std::vector<std::vector<int64_t>> shapes = {{7}, {5, 9}, {3, 4, 6}};
+  for (const auto& sizes : shapes) {
+    at::Tensor dense = random_sparse_dense(sizes, 0.7);
+    at::Tensor sparse = dense.to_sparse();
+    ASSERT_EQ(sparse.layout(), at::kSparse);
+    EXPECT_TRUE(sparse.is_sparse());
+    EXPECT_FALSE(sparse.has_storage());
+    EXPECT_TRUE(sparse.is_coalesced());
+    EXPECT_EQ(sparse.sizes(), dense.sizes());
+    const at::Tensor indices = sparse.indices();
+    const at::Tensor values = sparse.values();
+    ASSERT_EQ(
+        indices.sizes(), c10::IntArrayRef({dense.dim(), sparse._nnz()}));
+    ASSERT_EQ(values.sizes(), c10::IntArrayRef({sparse._nnz()}));
+    int64_t nonzeros = 0;
+    for (float x : floats(dense)) {
+      nonzeros += x != 0;
+    }
+    EXPECT_EQ(sparse._nnz(), nonzeros);
+    expect_same_dense(sparse.to_dense(), dense);
+    EXPECT_TRUE(sparse.to_sparse().is_same(sparse));
+    EXPECT_TRUE(dense.to_dense().is_same(dense));
+  }
+}
+
+TEST(SparseTest, coalesce_sums_duplicates) {
+  // (1, 2) three times, (0, 3) twice, given out of order
+  at::Tensor indices = at::empty({2, 6}, ScalarType::Long);
+  const std::vector<int64_t> idx = {1, 0, 1, 2, 1, 0, 2, 3, 2, 0, 2, 3};
+  std::copy(idx.begin(), idx.end(), indices.mutable_data_ptr<int64_t>());
+  at::Tensor values = float_tensor({1, 2, 4, 8, 16, 32});
+  at::Tensor sparse = at::sparse_coo_tensor(indices, values, {3, 4});
+  EXPECT_FALSE(sparse.is_coalesced());
+  at::Tensor coalesced = sparse.coalesce();
+  EXPECT_TRUE(coalesced.is_coalesced());
+  EXPECT_EQ(
+      longs(coalesced.indices()), std::vector<int64_t>({0, 1, 2, 3, 2, 0}));
+  EXPECT_EQ(floats(coalesced.values()), std::vector<float>({34, 21, 8}));
+  EXPECT_TRUE(coalesced.coalesce().is_same(coalesced));
+  expect_same_dense(sparse.to_dense(), coalesced.to_dense());
+  EXPECT_EQ(coalesced.to_dense().const_data_ptr<float>()[1 * 4 + 2], 21);
+
+  // no elements at all
+  at::Tensor none = at::sparse_coo_tensor(
+      at::empty({2, 0}, ScalarType::Long), at::empty({0}), {2, 2});
+  EXPECT_EQ(none.coalesce()._nnz(), 0);
+  EXPECT_EQ(floats(none.to_dense()), std::vector<float>(4, 0));
+}
+
+TEST(SparseTest, compressed_arrays) {
+  // [[0 1 0 2]
+  //  [0 0 0 0]
+  //  [3 0 4 0]]
+  at::Tensor dense = at::empty({3, 4});
+  dense.fill_(0);
+  float* d = dense.mutable_data_ptr<float>();
+  d[1] = 1;
+  d[3] = 2;
+  d[8] = 3;
+  d[10] = 4;
+  at::Tensor csr = dense.to_sparse_csr();
+  ASSERT_EQ(csr.layout(), at::kSparseCsr);
+  EXPECT_TRUE(csr.is_sparse_csr());
+  EXPECT_EQ(longs(csr.crow_indices()), std::vector<int64_t>({0, 2, 2, 4}));
+  EXPECT_EQ(longs(csr.col_indices()), std::vector<int64_t>({1, 3, 0, 2}));
+  EXPECT_EQ(floats(csr.values()), std::vector<float>({1, 2, 3, 4}));
+  at::Tensor csc = dense.to_sparse_csc();
+  ASSERT_EQ(csc.layout(), at::kSparseCsc);
+  EXPECT_EQ(longs(csc.ccol_indices()), std::vector<int64_t>({0, 1, 2, 3, 4}));
+  EXPECT_EQ(longs(csc.row_indices()), std::vector<int64_t>({2, 0, 2, 0}));
+  EXPECT_EQ(floats(csc.values()), std::vector<float>({3, 1, 4, 2}));
+  EXPECT_THROW(csr.ccol_indices(), c10::Error);
+  EXPECT_THROW(csc.crow_indices(), c10::Error);
+  EXPECT_THROW(csr.indices(), c10::Error);
+}
+
+TEST(SparseTest, conversions_between_layouts) {
+  const std::vector<std::vector<int64_t>> shapes = {
+      {1, 1}, {6, 5}, {17, 33}, {0, 4}, {4, 0}};
+  for (const auto& shape : shapes) {
+    at::Tensor dense = random_sparse_dense(shape, 0.8, 1);
+    const int64_t nnz = dense.to_sparse()._nnz();
+    const at::Tensor sources[] = {
+        dense, dense.to_sparse(), dense.to_sparse_csr(), dense.to_sparse_csc()};
+    for (const at::Tensor& source : sources) {
+      const at::Tensor conversions[] = {
+          source.to_sparse(), source.to_sparse_csr(), source.to_sparse_csc()};
+      for (const at::Tensor& converted : conversions) {
+        expect_same_dense(converted.to_dense(), dense);
+        EXPECT_EQ(converted._nnz(), nnz);
+      }
+      // CSC elements come in column-major order
+      EXPECT_TRUE(
+          source.to_sparse().is_coalesced() or
+          source.layout() == at::kSparseCsc);
+    }
+    // a transposed (strided) matrix
+    at::Tensor t = dense.t();
+    expect_same_dense(t.to_sparse_csr().to_dense(), t);
+    expect_same_dense(t.to_sparse_csc().to_dense(), t);
+    expect_same_dense(t.to_sparse().to_dense(), t);
+  }
+
+  // duplicates of an uncoalesced COO matrix add up in CSR
+  at::Tensor indices = at::empty({2, 3}, ScalarType::Long);
+  const std::vector<int64_t> idx = {1, 0, 1, 1, 0, 1};
+  std::copy(idx.begin(), idx.end(), indices.mutable_data_ptr<int64_t>());
+  at::Tensor coo =
+      at::sparse_coo_tensor(indices, float_tensor({1, 2, 4}), {2, 2});
+  at::Tensor csr = coo.to_sparse_csr();
+  EXPECT_EQ(longs(csr.crow_indices()), std::vector<int64_t>({0, 1, 2}));
+  EXPECT_EQ(floats(csr.values()), std::vector<float>({2, 5}));
+}
+
+TEST(SparseTest, arrays_are_ordinary_tensors) {
+  at::Tensor csr = at::sparse_csr_tensor(
+      long_tensor({0, 1, 3}),
+      long_tensor({2, 0, 1}),
+      float_tensor({1, 2, 3}),
+      {2, 3});
+  EXPECT_FALSE(csr.has_storage());
+  EXPECT_EQ(csr.numel(), 6);
+  for (const at::Tensor& array :
+       {csr.crow_indices(), csr.col_indices(), csr.values()}) {
+    EXPECT_EQ(array.layout(), at::kStrided);
+    EXPECT_TRUE(array.has_storage());
+  }
+  // the arrays are shared, not copied
+  at::Tensor values = float_tensor({1, 2, 3});
+  at::Tensor shared = at::sparse_csr_tensor(
+      long_tensor({0, 1, 3}), long_tensor({2, 0, 1}), values, {2, 3});
+  EXPECT_TRUE(shared.values().is_same(values));
+  // dense ops and views refuse sparse tensors
+  EXPECT_THROW(at::empty({2, 3}).copy_(csr), c10::Error);
+  EXPECT_THROW(csr.to(ScalarType::Double), c10::Error);
+  EXPECT_THROW(csr.t(), c10::Error);
+  EXPECT_THROW(csr.sum(), c10::Error);
+  EXPECT_THROW(csr.to_sparse().view({6}), c10::Error);
+}
+
+TEST(SparseTest, checks_arguments) {
+  at::Tensor indices = at::empty({2, 2}, ScalarType::Long);
+  const std::vector<int64_t> idx = {0, 1, 0, 3};
+  std::copy(idx.begin(), idx.end(), indices.mutable_data_ptr<int64_t>());
+  at::Tensor values = float_tensor({1, 2});
+  // index out of bounds, wrong dims, wrong dtype, wrong nnz
+  EXPECT_THROW(at::sparse_coo_tensor(indices, values, {2, 3}), c10::Error);
+  EXPECT_THROW(at::sparse_coo_tensor(indices, values, {2, 4, 1}), c10::Error);
+  EXPECT_THROW(
+      at::sparse_coo_tensor(indices.to(ScalarType::Int), values, {2, 4}),
+      c10::Error);
+  EXPECT_THROW(
+      at::sparse_coo_tensor(indices, float_tensor({1}), {2, 4}), c10::Error);
+  EXPECT_NO_THROW(at::sparse_coo_tensor(indices, values, {2, 4}));
+
+  const at::Tensor col = long_tensor({2, 0, 1});
+  const at::Tensor vals = float_tensor({1, 2, 3});
+  // not starting at 0, not ending at nnz, decreasing, of the wrong size
+  EXPECT_THROW(
+      at::sparse_csr_tensor(long_tensor({1, 1, 3}), col, vals, {2, 3}),
+      c10::Error);
+  EXPECT_THROW(
+      at::sparse_csr_tensor(long_tensor({0, 1, 2}), col, vals, {2, 3}),
+      c10::Error);
+  EXPECT_THROW(
+      at::sparse_csr_tensor(long_tensor({0, 2, 1, 3}), col, vals, {3, 3}),
+      c10::Error);
+  EXPECT_THROW(
+      at::sparse_csr_tensor(long_tensor({0, 1, 3}), col, vals, {3, 3}),
+      c10::Error);
+  // column out of bounds
+  EXPECT_THROW(
+      at::sparse_csr_tensor(long_tensor({0, 1, 3}), col, vals, {2, 2}),
+      c10::Error);
+  EXPECT_THROW(
+      at::sparse_csc_tensor(long_tensor({0, 1, 3}), col, vals, {2, 2}),
+      c10::Error);
+  EXPECT_NO_THROW(
+      at::sparse_csc_tensor(long_tensor({0, 1, 3}), col, vals, {3, 2}));
+  // 2-D only
+  EXPECT_THROW(at::empty({2, 2, 2}).to_sparse_csr(), c10::Error);
+  // mismatched or integral operands of mm
+  at::Tensor csr = random_sparse_dense({4, 5}, 0.5).to_sparse_csr();
+  EXPECT_THROW(csr.mm(at::empty({4, 2})), c10::Error);
+  EXPECT_THROW(csr.mm(at::empty({5, 2}, ScalarType::Double)), c10::Error);
+  EXPECT_THROW(csr.mm(csr.t()), c10::Error);
+  // a strided self takes a strided mat2 only, whatever the sparse layout
+  const at::Tensor dense = at::empty({3, 4});
+  EXPECT_THROW(dense.mm(csr), c10::Error);
+  EXPECT_THROW(dense.mm(csr.to_dense().to_sparse()), c10::Error);
+  EXPECT_THROW(dense.mm(csr.to_dense().to_sparse_csc()), c10::Error);
+  EXPECT_NO_THROW(dense.mm(csr.to_dense()));
+}
+
+TEST(SparseTest, mm_matches_dense) {
+  struct Shape {
+    int64_t m, k, n;
+  };
+  // vector tiles with and without tails, a matrix-vector product, and
+  // sizes with no elements
+  const Shape shapes[] = {
+      {1, 1, 1},
+      {5, 7, 1},
+      {9, 13, 3},
+      {33, 17, 37},
+      {64, 48, 64},
+      {130, 70, 100},
+      {0, 4, 5},
+      {4, 0, 5},
+      {4, 5, 0},
+  };
+  for (const Shape& s : shapes) {
+    at::Tensor a = random_sparse_dense({s.m, s.k}, 0.9, 2);
+    at::Tensor b = random_sparse_dense({s.k, s.n}, 0.0, 3);
+    const at::Tensor expected = a.mm(b);
+    for (const at::Tensor& sparse :
+         {a.to_sparse_csr(), a.to_sparse(), a.to_sparse_csc()}) {
+      expect_same_dense(sparse.mm(b), expected);
+    }
+    // a transposed dense operand
+    at::Tensor bt = random_sparse_dense({s.n, s.k}, 0.0, 4).t();
+    expect_same_dense(a.to_sparse_csr().mm(bt), a.mm(bt));
+  }
+
+  // Double
+  at::Tensor a = random_sparse_dense({20, 30}, 0.8, 5).to(ScalarType::Double);
+  at::Tensor b = random_sparse_dense({30, 11}, 0.0, 6).to(ScalarType::Double);
+  at::Tensor product = a.to_sparse_csr().mm(b);
+  ASSERT_EQ(product.scalar_type(), ScalarType::Double);
+  expect_same_dense(
+      product.to(ScalarType::Float), a.mm(b).to(ScalarType::Float));
+}
+
+TEST(SparseTest, mm_of_skewed_rows_is_thread_independent) {
+  // a few dense rows among nearly empty ones, with fractional values whose
+  // sums do round
+  const int64_t m = 2000;
+  const int64_t k = 512;
+  const int64_t n = 40;
+  at::Tensor a = at::empty({m, k});
+  a.fill_(0);
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<float> dist(-1, 1);
+  float* data = a.mutable_data_ptr<float>();
+  for (int64_t i = 0; i < m; ++i) {
+    const bool heavy = i % 500 == 3;
+    for (int64_t j = 0; j < k; ++j) {
+      if (heavy or (i + j) % 97 == 0) {
+        data[i * k + j] = dist(gen);
+      }
+    }
+  }
+  at::Tensor b = at::empty({k, n});
+  for (int64_t i = 0; i < b.numel(); ++i) {
+    b.mutable_data_ptr<float>()[i] = dist(gen);
+  }
+  const at::Tensor csr = a.to_sparse_csr();
+  const int threads = at::get_num_threads();
+  at::set_num_threads(1);
+  const at::Tensor serial = csr.mm(b);
+  at::set_num_threads(4);
+  const at::Tensor parallel = csr.mm(b);
+  at::set_num_threads(threads);
+  expect_same_dense(serial, parallel);
+  const at::Tensor expected = a.mm(b);
+  for (int64_t i = 0; i < m * n; ++i) {
+    ASSERT_NEAR(
+        serial.const_data_ptr<float>()[i],
+        expected.const_data_ptr<float>()[i],
+        1e-4)
+        << i;
+  }
+}
@@ -0,0 +1,216 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/TensorIterator.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <numeric>
+
+namespace {
+
+at::Tensor arange(c10::IntArrayRef sizes) {
+  at::Tensor t = at::empty(sizes);
+  float* data = t.mutable_data_ptr<float>();
+  std::iota(data, data + t.numel(), 0.f);
+  return t;
+}
+
+float at_index(const at::Tensor& t, std::initializer_list<int64_t> index) {
+  int64_t offset = t.storage_offset();
+  int64_t d = 0;
+  for (int64_t i : index) {
+    offset += i * t.stride(d++);
+  }
+  return static_cast<const float*>(t.storage().data())[offset];
+}
+
+// out = a + b for float operands
+void add_kernel(at::TensorIterator& iter) {
+  iter.for_each(
+      [](char** data, const int64_t* strides, int64_t size0, int64_t size1) {
+        for (int64_t j = 0; j < size1; ++j) {
+          char* out = data[0] + j * strides[3];
+          const char* a = data[1] + j * strides[4];
+          const char* b = data[2] + j * strides[5];
+          for (int64_t i = 0; i < size0; ++i) {
+            *reinterpret_cast<float*>(out + i * strides[0]) =
+                *reinterpret_cast<const float*>(a + i * strides[1]) +
+                *reinterpret_cast<const float*>(b + i * strides[2]);
+          }
+        }
+      });
+}
+
+} // namespace
+
+TEST(TensorIteratorTest, contiguous_operands_coalesce_to_1d) {
+  at::Tensor a = arange({2, 3, 4});
+  at::Tensor b = arange({2, 3, 4});
+  auto iter = at::TensorIterator::binary_op(at::Tensor(), a, b);
+  ASSERT_EQ(iter.ndim(), 1);
+  ASSERT_EQ(iter.shape()[0], 24);
+  ASSERT_TRUE(iter.is_contiguous());
+  add_kernel(iter);
+
+  const at::Tensor& out = iter.output();
+  ASSERT_EQ(out.sizes(), c10::IntArrayRef({2, 3, 4}));
+  ASSERT_TRUE(out.is_contiguous());
+  for (int64_t i = 0; i < 24; ++i) {
+    ASSERT_EQ(out.const_data_ptr<float>()[i], 2.f * i);
+  }
+}
+
+TEST(TensorIteratorTest, broadcast) {
+  at::Tensor a = arange({3, 1});
+  at::Tensor b = arange({4});
+  auto iter = at::TensorIterator::binary_op(at::Tensor(), a, b);
+  ASSERT_EQ(iter.shape(), c10::IntArrayRef({4, 3}));
+  ASSERT_EQ(iter.strides(1), c10::IntArrayRef({0, 4}));
+  ASSERT_EQ(iter.strides(2), c10::IntArrayRef({4, 0}));
+  add_kernel(iter);
+
+  const at::Tensor& out = iter.output();
+  ASSERT_EQ(out.sizes(), c10::IntArrayRef({3, 4}));
+  for (int64_t i = 0; i < 3; ++i) {
+    for (int64_t j = 0; j < 4; ++j) {
+      ASSERT_EQ(at_index(out, {i, j}), i + j);
+    }
+  }
+
+  ASSERT_THROW(
+      at::TensorIterator::binary_op(at::Tensor(), a, arange({2, 2})),
+      c10::Error);
+}
+
+TEST(TensorIteratorTest, reorders_dims_by_stride) {
+  // both inputs are transposed, so iterating in their memory order is a
+  // single contiguous loop and the output inherits their layout
+  at::Tensor a = arange({4, 5}).t();
+  at::Tensor b = arange({4, 5}).t();
+  auto iter = at::TensorIterator::binary_op(at::Tensor(), a, b);
+  ASSERT_EQ(iter.ndim(), 1);
+  add_kernel(iter);
+  const at::Tensor& out = iter.output();
+  ASSERT_EQ(out.sizes(), c10::IntArrayRef({5, 4}));
+  ASSERT_EQ(out.strides(), c10::IntArrayRef({1, 5}));
+  ASSERT_EQ(at_index(out, {3, 2}), 2 * at_index(a, {3, 2}));
+
+  at::Tensor nhwc = at::empty(
+      {2, 3, 4, 5}, c10::ScalarType::Float, c10::MemoryFormat::ChannelsLast);
+  std::iota(
+      nhwc.mutable_data_ptr<float>(),
+      nhwc.mutable_data_ptr<float>() + nhwc.numel(),
+      0.f);
+  auto cl_iter = at::TensorIterator::unary_op(at::Tensor(), nhwc);
+  ASSERT_EQ(cl_iter.ndim(), 1);
+  ASSERT_TRUE(
+      cl_iter.output().is_contiguous(c10::MemoryFormat::ChannelsLast));
+}
+
+TEST(TensorIteratorTest, partial_coalescing) {
+  // the first half of each row: rows can't be merged
+  at::Tensor base = arange({4, 6});
+  at::Tensor a = base.slice(1, 0, 3);
+  at::Tensor out = at::empty({4, 3});
+  auto iter = at::TensorIterator::binary_op(out, a, a);
+  ASSERT_EQ(iter.shape(), c10::IntArrayRef({3, 4}));
+  ASSERT_EQ(iter.strides(0), c10::IntArrayRef({4, 12}));
+  ASSERT_EQ(iter.strides(1), c10::IntArrayRef({4, 24}));
+  add_kernel(iter);
+  for (int64_t i = 0; i < 4; ++i) {
+    for (int64_t j = 0; j < 3; ++j) {
+      ASSERT_EQ(at_index(out, {i, j}), 2 * (6 * i + j));
+    }
+  }
+
+  // every other column is a uniform stride-2 walk and still coalesces
+  at::Tensor b = base.slice(1, 0, 6, 2);
+  auto strided = at::TensorIterator::binary_op(out, b, b);
+  ASSERT_EQ(strided.shape(), c10::IntArrayRef({12}));
+  ASSERT_EQ(strided.strides(1), c10::IntArrayRef({8}));
+}
+
+TEST(TensorIteratorTest, checks) {
+  at::Tensor a = arange({2, 3});
+  at::Tensor d = at::empty({2, 3}, c10::ScalarType::Double);
+  ASSERT_THROW(
+      at::TensorIterator::binary_op(at::Tensor(), a, d), c10::Error);
+  ASSERT_THROW(
+      at::TensorIterator::unary_op(at::empty({3, 2}), a), c10::Error);
+  ASSERT_THROW(
+      at::TensorIterator::unary_op(at::empty({1, 3}).expand({2, 3}), a),
+      c10::Error);
+
+  auto convert = at::TensorIteratorConfig()
+                     .add_output(at::Tensor())
+                     .add_input(a)
+                     .check_all_same_dtype(false)
+                     .declare_output_dtype(c10::ScalarType::Double)
+                     .build();
+  ASSERT_EQ(convert.output().scalar_type(), c10::ScalarType::Double);
+  ASSERT_EQ(convert.input_dtype(), c10::ScalarType::Float);
+}
+
+TEST(TensorIteratorTest, scalars_and_empty) {
+  at::Tensor s = arange({});
+  auto iter = at::TensorIterator::binary_op(at::Tensor(), s, s);
+  ASSERT_EQ(iter.ndim(), 0);
+  ASSERT_EQ(iter.numel(), 1);
+  add_kernel(iter);
+  ASSERT_EQ(iter.output().dim(), 0);
+  ASSERT_EQ(iter.output().const_data_ptr<float>()[0], 0.f);
+
+  auto empty_iter =
+      at::TensorIterator::binary_op(at::Tensor(), at::empty({0, 3}), s);
+  int calls = 0;
+  empty_iter.for_each([&](char**, const int64_t*, int64_t, int64_t) {
+    ++calls;
+  });
+  ASSERT_EQ(calls, 0);
+  ASSERT_EQ(empty_iter.output().sizes(), c10::IntArrayRef({0, 3}));
+}
+
+TEST(TensorIteratorTest, one_dim_loop) {
+  at::Tensor a = arange({3, 5}).slice(1, 0, 4);
+  at::Tensor out = at::empty({3, 4});
+  auto iter = at::TensorIterator::unary_op(out, a);
+  ASSERT_EQ(iter.ndim(), 2);
+  iter.for_each([](char** data, const int64_t* strides, int64_t n) {
+    for (int64_t i = 0; i < n; ++i) {
+      *reinterpret_cast<float*>(data[0] + i * strides[0]) =
+          -*reinterpret_cast<const float*>(data[1] + i * strides[1]);
+    }
+  });
+  ASSERT_EQ(at_index(out, {2, 3}), -13.f);
+}
+
+TEST(TensorIteratorTest, parallel_for_each_visits_every_element_once) {
+  at::set_num_threads(4);
+  // a non-coalescable shape so that the chunks split rows mid-way
+  at::Tensor a = arange({64, 1000}).slice(1, 0, 999);
+  at::Tensor out = at::empty({64, 999});
+  auto iter = at::TensorIterator::unary_op(out, a);
+  ASSERT_EQ(iter.ndim(), 2);
+
+  std::atomic<int64_t> visited{0};
+  iter.for_each(
+      [&](char** data, const int64_t* strides, int64_t size0, int64_t size1) {
+        for (int64_t j = 0; j < size1; ++j) {
+          for (int64_t i = 0; i < size0; ++i) {
+            auto* dst = reinterpret_cast<float*>(
+                data[0] + i * strides[0] + j * strides[2]);
+            *dst = *reinterpret_cast<const float*>(
+                       data[1] + i * strides[1] + j * strides[3]) +
+                1.f;
+          }
+        }
+        visited += size0 * size1;
+      },
+      /*grain_size=*/1000);
+  ASSERT_EQ(visited.load(), 64 * 999);
+  for (int64_t i = 0; i < 64; ++i) {
+    for (int64_t j = 0; j < 999; ++j) {
+      ASSERT_EQ(at_index(out, {i, j}), at_index(a, {i, j}) + 1.f);
+    }
+  }
+}
@@ -0,0 +1,150 @@
+#include <ATen/ATen.h>
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+namespace {
+
+// a [2, 3, 4] float tensor holding 0, 1, 2, ...
+at::Tensor arange_234() {
+  at::Tensor t = at::empty({2, 3, 4});
+  float* data = t.mutable_data_ptr<float>();
+  std::iota(data, data + t.numel(), 0.f);
+  return t;
+}
+
+float at_index(const at::Tensor& t, std::initializer_list<int64_t> index) {
+  int64_t offset = t.storage_offset();
+  int64_t d = 0;
+  for (int64_t i : index) {
+    offset += i * t.stride(d++);
+  }
+  return static_cast<const float*>(t.storage().data())[offset];
+}
+
+void expect_shares_storage(const at::Tensor& view, const at::Tensor& base) {
+  ASSERT_TRUE(view.is_alias_of(base));
+  ASSERT_FALSE(view.is_same(base));
+}
+
+} // namespace
+
+TEST(TensorViewTest, support_as_strided) {
+  ASSERT_TRUE(c10::Device(c10::DeviceType::CPU).support_as_strided());
+}
+
+TEST(TensorViewTest, empty) {
+  at::Tensor t = at::empty({2, 3, 4});
+  ASSERT_EQ(t.sizes(), c10::IntArrayRef({2, 3, 4}));
+  ASSERT_EQ(t.strides(), c10::IntArrayRef({12, 4, 1}));
+  ASSERT_EQ(t.scalar_type(), c10::ScalarType::Float);
+  ASSERT_EQ(t.nbytes(), 96);
+  ASSERT_TRUE(t.is_contiguous());
+  ASSERT_THROW(t.mutable_data_ptr<double>(), c10::Error);
+
+  at::Tensor cl = at::empty(
+      {2, 3, 4, 5}, c10::ScalarType::Float, c10::MemoryFormat::ChannelsLast);
+  ASSERT_TRUE(cl.is_contiguous(c10::MemoryFormat::ChannelsLast));
+
+  ASSERT_THROW(at::empty({2, -1}), c10::Error);
+}
+
+TEST(TensorViewTest, as_strided) {
+  at::Tensor base = arange_234();
+  at::Tensor v = base.as_strided({3, 2}, {1, 3}, 2);
+  expect_shares_storage(v, base);
+  ASSERT_EQ(v.storage_offset(), 2);
+  ASSERT_EQ(at_index(v, {0, 0}), 2.f);
+  ASSERT_EQ(at_index(v, {2, 1}), 7.f);
+  ASSERT_EQ(v.const_data_ptr<float>(), base.const_data_ptr<float>() + 2);
+
+  // writes through the view land in the base
+  v.mutable_data_ptr<float>()[0] = -1.f;
+  ASSERT_EQ(base.const_data_ptr<float>()[2], -1.f);
+
+  // out of bounds for the 24-element storage
+  ASSERT_THROW(base.as_strided({5, 5}, {5, 1}), c10::Error);
+  ASSERT_THROW(base.as_strided({2}, {-1}), c10::Error);
+}
+
+TEST(TensorViewTest, slice) {
+  at::Tensor base = arange_234();
+  at::Tensor v = base.slice(2, 1, 4, 2);
+  expect_shares_storage(v, base);
+  ASSERT_EQ(v.sizes(), c10::IntArrayRef({2, 3, 2}));
+  ASSERT_EQ(v.strides(), c10::IntArrayRef({12, 4, 2}));
+  ASSERT_EQ(at_index(v, {1, 2, 1}), 23.f);
+  ASSERT_FALSE(v.is_contiguous());
+
+  // negative and out of range bounds are clamped
+  at::Tensor w = base.slice(-3, -1, 100);
+  ASSERT_EQ(w.sizes(), c10::IntArrayRef({1, 3, 4}));
+  ASSERT_EQ(w.storage_offset(), 12);
+  ASSERT_TRUE(w.is_contiguous());
+  ASSERT_EQ(base.slice(1, 2, 1).numel(), 0);
+
+  ASSERT_THROW(base.slice(0, 0, 1, 0), c10::Error);
+  ASSERT_THROW(base.slice(3), c10::Error);
+
+  at::Tensor s = base.select(1, -1);
+  ASSERT_EQ(s.sizes(), c10::IntArrayRef({2, 4}));
+  ASSERT_EQ(at_index(s, {1, 3}), 23.f);
+  ASSERT_THROW(base.select(1, 3), c10::Error);
+}
+
+TEST(TensorViewTest, transpose_and_permute) {
+  at::Tensor base = arange_234();
+  at::Tensor tr = base.transpose(0, 2);
+  expect_shares_storage(tr, base);
+  ASSERT_EQ(tr.sizes(), c10::IntArrayRef({4, 3, 2}));
+  ASSERT_EQ(tr.strides(), c10::IntArrayRef({1, 4, 12}));
+  ASSERT_EQ(at_index(tr, {3, 2, 1}), at_index(base, {1, 2, 3}));
+  ASSERT_FALSE(tr.is_contiguous());
+  ASSERT_TRUE(tr.is_non_overlapping_and_dense());
+
+  at::Tensor p = base.permute({1, 2, 0});
+  ASSERT_EQ(p.sizes(), c10::IntArrayRef({3, 4, 2}));
+  ASSERT_EQ(p.strides(), c10::IntArrayRef({4, 1, 12}));
+  ASSERT_EQ(at_index(p, {2, 1, 1}), at_index(base, {1, 2, 1}));
+  ASSERT_THROW(base.permute({0, 0, 1}), c10::Error);
+  ASSERT_THROW(base.permute({0, 1}), c10::Error);
+
+  // NCHW permuted to NHWC and back is channels-last contiguous
+  at::Tensor nhwc = at::empty({2, 4, 5, 3});
+  at::Tensor nchw = nhwc.permute({0, 3, 1, 2});
+  ASSERT_TRUE(nchw.is_contiguous(c10::MemoryFormat::ChannelsLast));
+
+  ASSERT_EQ(base.select(0, 0).t().sizes(), c10::IntArrayRef({4, 3}));
+}
+
+TEST(TensorViewTest, expand) {
+  at::Tensor base = at::empty({3, 1});
+  at::Tensor e = base.expand({2, 3, 4});
+  expect_shares_storage(e, base);
+  ASSERT_EQ(e.sizes(), c10::IntArrayRef({2, 3, 4}));
+  ASSERT_EQ(e.strides(), c10::IntArrayRef({0, 1, 0}));
+  ASSERT_FALSE(e.is_non_overlapping_and_dense());
+
+  ASSERT_EQ(base.expand({-1, 5}).sizes(), c10::IntArrayRef({3, 5}));
+  ASSERT_THROW(base.expand({2, 4}), c10::Error);
+  ASSERT_THROW(base.expand({4}), c10::Error);
+}
+
+TEST(TensorViewTest, view) {
+  at::Tensor base = arange_234();
+  at::Tensor v = base.view({6, -1});
+  expect_shares_storage(v, base);
+  ASSERT_EQ(v.sizes(), c10::IntArrayRef({6, 4}));
+  ASSERT_EQ(v.strides(), c10::IntArrayRef({4, 1}));
+
+  // splitting a dim of a non-contiguous tensor is fine, merging across a gap
+  // is not
+  at::Tensor tr = base.transpose(1, 2);
+  ASSERT_EQ(tr.view({2, 2, 2, 3}).strides(), c10::IntArrayRef({12, 2, 1, 4}));
+  ASSERT_THROW(tr.view({2, 12}), c10::Error);
+  ASSERT_THROW(base.view({5, -1}), c10::Error);
+
+  at::Tensor u = base.unsqueeze(1);
+  ASSERT_EQ(u.sizes(), c10::IntArrayRef({2, 1, 3, 4}));
+  ASSERT_TRUE(u.is_contiguous());
+}
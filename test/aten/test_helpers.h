@@ -0,0 +1,84 @@
+#pragma once
+
+// Tensor construction and element access shared by the tests of the aten
+// kernels. They read and write storage directly, so that checking an op
+// does not depend on other ops.
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+namespace at::test {
+
+// a tensor of the given shape filled with uniform randoms in [lo, hi), in
+// memory order
+inline Tensor uniform(
+    IntArrayRef sizes,
+    ScalarType dtype,
+    float lo,
+    float hi,
+    uint32_t seed = 0,
+    MemoryFormat memory_format = MemoryFormat::Contiguous) {
+  Tensor t = empty(sizes, dtype, memory_format);
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> dist(lo, hi);
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    const float x = dist(gen);
+    if (dtype == ScalarType::Double) {
+      t.mutable_data_ptr<double>()[i] = x;
+    } else if (dtype == ScalarType::Half) {
+      t.mutable_data_ptr<c10::Half>()[i] = c10::Half(x);
+    } else if (dtype == ScalarType::BFloat16) {
+      t.mutable_data_ptr<c10::BFloat16>()[i] = c10::BFloat16(x);
+    } else {
+      t.mutable_data_ptr<float>()[i] = x;
+    }
+  }
+  return t;
+}
+
+// uniform randoms in [-1, 1)
+inline Tensor randu(
+    IntArrayRef sizes,
+    ScalarType dtype = ScalarType::Float,
+    uint32_t seed = 0,
+    MemoryFormat memory_format = MemoryFormat::Contiguous) {
+  return uniform(sizes, dtype, -1.f, 1.f, seed, memory_format);
+}
+
+// the element of t at the given index as a double, t may be strided
+inline double at_index(const Tensor& t, IntArrayRef index) {
+  int64_t offset = t.storage_offset();
+  for (size_t d = 0; d < index.size(); ++d) {
+    offset += index[d] * t.stride(static_cast<int64_t>(d));
+  }
+  return AT_DISPATCH_ALL_TYPES_AND_FLOAT8(t.scalar_type(), "at_index", [&] {
+    return static_cast<double>(
+        static_cast<const scalar_t*>(t.storage().data())[offset]);
+  });
+}
+
+// the element at the row-major index i of t as a double, t may be strided
+inline double at_flat(const Tensor& t, int64_t i) {
+  int64_t offset = t.storage_offset();
+  for (int64_t d = t.dim() - 1; d >= 0; --d) {
+    offset += (i % t.size(d)) * t.stride(d);
+    i /= t.size(d);
+  }
+  return AT_DISPATCH_ALL_TYPES_AND_FLOAT8(t.scalar_type(), "at_flat", [&] {
+    return static_cast<double>(
+        static_cast<const scalar_t*>(t.storage().data())[offset]);
+  });
+}
+
+// same shape, layout, dtype and bytes
+inline bool bitwise_equal(const Tensor& a, const Tensor& b) {
+  return a.sizes() == b.sizes() and a.strides() == b.strides() and
+      a.scalar_type() == b.scalar_type() and
+      std::memcmp(a.const_data_ptr(), b.const_data_ptr(), a.nbytes()) == 0;
+}
+
+} // namespace at::test
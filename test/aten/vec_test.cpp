@@ -0,0 +1,787 @@
+#include <gtest/gtest.h>
+
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+// This file is compiled once per CPU capability (see test/CMakeLists.txt),
+// so the same tests cover the generic, AVX2 and AVX-512 implementations.
+
+using namespace at::vec;
+
+namespace {
+
+bool capability_supported() {
+#if defined(CPU_CAPABILITY_AVX512)
+  return __builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512vl") &&
+      __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("fma") &&
+      __builtin_cpu_supports("f16c");
+#elif defined(CPU_CAPABILITY_AVX2)
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+      __builtin_cpu_supports("f16c");
+#else
+  return true;
+#endif
+}
+
+// std::array rather than std::vector, which is packed for bool
+template <typename T>
+using Buffer = std::array<T, Vectorized<T>::size()>;
+
+template <typename T>
+Buffer<T> to_buffer(const Vectorized<T>& v) {
+  Buffer<T> out;
+  v.store(out.data());
+  return out;
+}
+
+// small values so that no integer operation below overflows
+template <typename T>
+T value(int64_t i) {
+  if constexpr (std::is_same_v<T, bool>) {
+    return i % 2 == 0;
+  } else if constexpr (is_floating_point_v<T>) {
+    return static_cast<T>(static_cast<float>(i % 11) * 0.75f - 3.f);
+  } else if constexpr (std::is_signed_v<T>) {
+    return static_cast<T>(i % 9 - 4);
+  } else {
+    return static_cast<T>(i % 9 + 1);
+  }
+}
+
+template <typename T>
+Vectorized<T> make_vec(int64_t offset) {
+  Buffer<T> values;
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = value<T>(offset + i);
+  }
+  return Vectorized<T>::loadu(values.data());
+}
+
+template <typename T>
+bool all_bits(T value) {
+  const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    if (bytes[i] != 0xff) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+bool no_bits(T value) {
+  const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    if (bytes[i] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+bool same(T a, T b) {
+  if constexpr (is_floating_point_v<T>) {
+    return static_cast<double>(a) == static_cast<double>(b) ||
+        (std::isnan(static_cast<double>(a)) &&
+         std::isnan(static_cast<double>(b)));
+  } else {
+    return a == b;
+  }
+}
+
+} // namespace
+
+template <typename T>
+class VecTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if (!capability_supported()) {
+      GTEST_SKIP() << "CPU does not support this capability";
+    }
+  }
+};
+
+// AT_FORALL_SCALAR_TYPES but the Float8 types, which have no arithmetic
+using ScalarTypes = ::testing::Types<
+    uint8_t,
+    int8_t,
+    int16_t,
+    int32_t,
+    int64_t,
+    c10::Half,
+    float,
+    double,
+    bool,
+    c10::BFloat16,
+    uint16_t,
+    uint32_t,
+    uint64_t>;
+TYPED_TEST_SUITE(VecTest, ScalarTypes);
+
+TYPED_TEST(VecTest, size_matches_register_width) {
+  EXPECT_EQ(
+      Vectorized<TypeParam>::size() * sizeof(TypeParam),
+#if defined(CPU_CAPABILITY_AVX512)
+      64u
+#else
+      32u
+#endif
+  );
+}
+
+TYPED_TEST(VecTest, load_store) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int64_t n = Vec::size();
+  Buffer<T> src;
+  for (int64_t i = 0; i < n; ++i) {
+    src[i] = value<T>(i);
+  }
+
+  auto full = to_buffer(Vec::loadu(src.data()));
+  for (int64_t i = 0; i < n; ++i) {
+    EXPECT_TRUE(same(full[i], src[i])) << i;
+  }
+
+  // partial loads zero the remaining lanes, partial stores leave the
+  // memory past `count` alone
+  for (int64_t count : {int64_t(0), int64_t(1), n / 2 + 1, n - 1}) {
+    auto partial = to_buffer(Vec::loadu(src.data(), count));
+    for (int64_t i = 0; i < n; ++i) {
+      EXPECT_TRUE(same(partial[i], i < count ? src[i] : T(0))) << i;
+    }
+
+    Buffer<T> dst;
+    dst.fill(static_cast<T>(1));
+    Vec::loadu(src.data()).store(dst.data(), count);
+    for (int64_t i = 0; i < n; ++i) {
+      EXPECT_TRUE(same(dst[i], i < count ? src[i] : static_cast<T>(1)))
+          << i;
+    }
+  }
+
+  auto splat = to_buffer(Vec(static_cast<T>(1)));
+  for (int64_t i = 0; i < n; ++i) {
+    EXPECT_TRUE(same(splat[i], static_cast<T>(1)));
+  }
+}
+
+TYPED_TEST(VecTest, arange_blend_set) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int64_t n = Vec::size();
+  if constexpr (!std::is_same_v<T, bool>) {
+    auto range = to_buffer(Vec::arange(static_cast<T>(1), 1));
+    for (int64_t i = 0; i < n; ++i) {
+      EXPECT_TRUE(same(range[i], static_cast<T>(1 + i))) << i;
+    }
+  }
+
+  Vec a(static_cast<T>(0));
+  Vec b(static_cast<T>(1));
+  auto blended = to_buffer(Vec::template blend<0b0101>(a, b));
+  for (int64_t i = 0; i < n; ++i) {
+    T expected = (i == 0 || i == 2) ? T(1) : T(0);
+    EXPECT_TRUE(same(blended[i], expected)) << i;
+  }
+
+  for (int64_t count = 0; count <= n; ++count) {
+    auto set = to_buffer(Vec::set(a, b, count));
+    for (int64_t i = 0; i < n; ++i) {
+      EXPECT_TRUE(same(set[i], i < count ? T(1) : T(0))) << i;
+    }
+  }
+
+  // blendv takes a comparison mask
+  Vec x = make_vec<T>(0);
+  Vec y = make_vec<T>(5);
+  auto xs = to_buffer(x);
+  auto ys = to_buffer(y);
+  auto picked = to_buffer(Vec::blendv(x, y, y < x));
+  for (int64_t i = 0; i < n; ++i) {
+    EXPECT_TRUE(same(picked[i], ys[i] < xs[i] ? ys[i] : xs[i])) << i;
+  }
+}
+
+TYPED_TEST(VecTest, arithmetic) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int64_t n = Vec::size();
+  Vec a = make_vec<T>(0);
+  Vec b = make_vec<T>(3);
+  auto as = to_buffer(a);
+  auto bs = to_buffer(b);
+
+  auto sum = to_buffer(a + b);
+  auto diff = to_buffer(a - b);
+  auto prod = to_buffer(a * b);
+  auto fma = to_buffer(fmadd(a, b, a));
+  for (int64_t i = 0; i < n; ++i) {
+    EXPECT_TRUE(same(sum[i], static_cast<T>(as[i] + bs[i]))) << i;
+    EXPECT_TRUE(same(diff[i], static_cast<T>(as[i] - bs[i]))) << i;
+    EXPECT_TRUE(same(prod[i], static_cast<T>(as[i] * bs[i]))) << i;
+    if constexpr (std::is_same_v<T, c10::Half>) {
+      // fused: rounded to half once
+      float expected = static_cast<float>(as[i]) * static_cast<float>(bs[i]) +
+          static_cast<float>(as[i]);
+      EXPECT_TRUE(same(fma[i], c10::Half(expected))) << i;
+    } else if constexpr (!std::is_same_v<T, bool>) {
+      EXPECT_TRUE(same(fma[i], static_cast<T>(as[i] * bs[i] + as[i]))) << i;
+    }
+  }
+
+  if constexpr (!std::is_same_v<T, bool>) {
+    // value() never produces 0 for unsigned types; for the others make the
+    // divisor nonzero
+    Vec divisor = b;
+    if constexpr (std::is_signed_v<T> || is_floating_point_v<T>) {
+      divisor = Vec::blendv(b, Vec(static_cast<T>(7)), b == Vec(T(0)));
+    }
+    auto ds = to_buffer(divisor);
+    auto quot = to_buffer(a / divisor);
+    for (int64_t i = 0; i < n; ++i) {
+      EXPECT_TRUE(same(quot[i], static_cast<T>(as[i] / ds[i]))) << i;
+    }
+  }
+}
+
+TYPED_TEST(VecTest, bitwise) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int64_t n = Vec::size();
+  Vec a = make_vec<T>(0);
+  Vec mask = a > Vec(static_cast<T>(0));
+  auto as = to_buffer(a);
+  auto masked = to_buffer(a & mask);
+  auto ored = to_buffer(a | mask);
+  auto xored = to_buffer(mask ^ mask);
+  for (int64_t i = 0; i < n; ++i) {
+    bool on = as[i] > static_cast<T>(0);
+    EXPECT_TRUE(same(masked[i], on ? as[i] : T(0))) << i;
+    EXPECT_TRUE(on ? all_bits(ored[i]) : same(ored[i], as[i])) << i;
+    EXPECT_TRUE(no_bits(xored[i])) << i;
+  }
+}
+
+TYPED_TEST(VecTest, comparisons) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int64_t n = Vec::size();
+  Vec a = make_vec<T>(0);
+  Vec b = make_vec<T>(4);
+  auto as = to_buffer(a);
+  auto bs = to_buffer(b);
+
+#define CHECK_COMPARISON(op, name)                                   \
+  {                                                                  \
+    auto mask = to_buffer(a op b);                                   \
+    auto ones = to_buffer(a.name(b));                                \
+    for (int64_t i = 0; i < n; ++i) {                                \
+      bool expected = as[i] op bs[i];                                \
+      EXPECT_TRUE(expected ? all_bits(mask[i]) : no_bits(mask[i]))   \
+          << #op << " " << i;                                        \
+      EXPECT_TRUE(same(ones[i], static_cast<T>(expected ? 1 : 0)))   \
+          << #name << " " << i;                                      \
+    }                                                                \
+  }
+  CHECK_COMPARISON(==, eq)
+  CHECK_COMPARISON(!=, ne)
+  CHECK_COMPARISON(<, lt)
+  CHECK_COMPARISON(<=, le)
+  CHECK_COMPARISON(>, gt)
+  CHECK_COMPARISON(>=, ge)
+#undef CHECK_COMPARISON
+
+  int zero_mask = a.zero_mask();
+  for (int64_t i = 0; i < std::min<int64_t>(n, 32); ++i) {
+    EXPECT_EQ(((zero_mask >> i) & 1) != 0, same(as[i], T(0))) << i;
+  }
+}
+
+TYPED_TEST(VecTest, min_max_clamp) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int64_t n = Vec::size();
+  Vec a = make_vec<T>(0);
+  Vec b = make_vec<T>(2);
+  auto as = to_buffer(a);
+  auto bs = to_buffer(b);
+  T lo = value<T>(3);
+  T hi = value<T>(6);
+  auto mx = to_buffer(maximum(a, b));
+  auto mn = to_buffer(minimum(a, b));
+  auto cl = to_buffer(clamp(a, Vec(lo), Vec(hi)));
+  auto cl_min = to_buffer(clamp_min(a, Vec(lo)));
+  auto cl_max = to_buffer(clamp_max(a, Vec(hi)));
+  for (int64_t i = 0; i < n; ++i) {
+    EXPECT_TRUE(same(mx[i], as[i] > bs[i] ? as[i] : bs[i])) << i;
+    EXPECT_TRUE(same(mn[i], as[i] < bs[i] ? as[i] : bs[i])) << i;
+    T expected = as[i] < lo ? lo : as[i];
+    expected = expected > hi ? hi : expected;
+    EXPECT_TRUE(same(cl[i], expected)) << i;
+    EXPECT_TRUE(same(cl_min[i], as[i] < lo ? lo : as[i])) << i;
+    EXPECT_TRUE(same(cl_max[i], as[i] > hi ? hi : as[i])) << i;
+  }
+}
+
+TYPED_TEST(VecTest, reduce) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  if constexpr (!std::is_same_v<T, bool>) {
+    Vec a = make_vec<T>(0);
+    auto as = to_buffer(a);
+    T expected_max = as[0];
+    for (T x : as) {
+      expected_max = x > expected_max ? x : expected_max;
+    }
+    T max = vec_reduce_all<T>(
+        [](const Vec& x, const Vec& y) { return maximum(x, y); }, a);
+    EXPECT_TRUE(same(max, expected_max));
+
+    // integers add exactly, floats are checked against the same pairwise
+    // order the reduction uses
+    if constexpr (!is_floating_point_v<T>) {
+      T expected_sum = 0;
+      for (T x : as) {
+        expected_sum = static_cast<T>(expected_sum + x);
+      }
+      T sum = vec_reduce_all<T>(
+          [](const Vec& x, const Vec& y) { return x + y; }, a);
+      EXPECT_EQ(sum, expected_sum);
+    }
+  }
+}
+
+template <typename T>
+class VecFloatTest : public VecTest<T> {};
+
+using FloatingTypes = ::testing::Types<c10::Half, float, double>;
+TYPED_TEST_SUITE(VecFloatTest, FloatingTypes);
+
+TYPED_TEST(VecFloatTest, unary_math) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int64_t n = Vec::size();
+  Vec a = make_vec<T>(0);
+  auto as = to_buffer(a);
+  auto abs = to_buffer(a.abs());
+  auto neg = to_buffer(a.neg());
+  auto floor = to_buffer(a.floor());
+  auto ceil = to_buffer(a.ceil());
+  auto round = to_buffer(a.round());
+  auto trunc = to_buffer(a.trunc());
+  auto sqrt = to_buffer(a.abs().sqrt());
+  auto recip = to_buffer(a.reciprocal());
+  for (int64_t i = 0; i < n; ++i) {
+    double x = static_cast<double>(as[i]);
+    EXPECT_TRUE(same(abs[i], static_cast<T>(std::abs(x)))) << i;
+    EXPECT_TRUE(same(neg[i], static_cast<T>(-x))) << i;
+    EXPECT_TRUE(same(floor[i], static_cast<T>(std::floor(x)))) << i;
+    EXPECT_TRUE(same(ceil[i], static_cast<T>(std::ceil(x)))) << i;
+    EXPECT_TRUE(same(round[i], static_cast<T>(std::nearbyint(x)))) << i;
+    EXPECT_TRUE(same(trunc[i], static_cast<T>(std::trunc(x)))) << i;
+    EXPECT_NEAR(
+        static_cast<double>(sqrt[i]),
+        std::sqrt(std::abs(x)),
+        1e-3 * (1 + std::abs(x)));
+    if (x != 0) {
+      EXPECT_NEAR(static_cast<double>(recip[i]), 1 / x, 1e-3 * std::abs(1 / x));
+    }
+  }
+}
+
+TYPED_TEST(VecFloatTest, nan_handling) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int64_t n = Vec::size();
+  T nan = static_cast<T>(std::numeric_limits<float>::quiet_NaN());
+  Vec a = Vec::set(make_vec<T>(0), Vec(nan), 1);
+  Vec b = make_vec<T>(1);
+
+  auto isnan = to_buffer(a.isnan());
+  EXPECT_TRUE(all_bits(isnan[0]));
+  for (int64_t i = 1; i < n; ++i) {
+    EXPECT_TRUE(no_bits(isnan[i])) << i;
+  }
+
+  // maximum/minimum propagate NaN from either side
+  for (auto v : {to_buffer(maximum(a, b)),
+                 to_buffer(maximum(b, a)),
+                 to_buffer(minimum(a, b)),
+                 to_buffer(minimum(b, a))}) {
+    EXPECT_TRUE(std::isnan(static_cast<double>(v[0])));
+    for (int64_t i = 1; i < n; ++i) {
+      EXPECT_FALSE(std::isnan(static_cast<double>(v[i]))) << i;
+    }
+  }
+
+  // NaN compares unequal to everything, itself included
+  auto eq = to_buffer(a == a);
+  auto ne = to_buffer(a != a);
+  EXPECT_TRUE(no_bits(eq[0]));
+  EXPECT_TRUE(all_bits(ne[0]));
+}
+
+TYPED_TEST(VecFloatTest, exp_accuracy) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int64_t n = Vec::size();
+  // Half only represents a small range, exercise the float kernel over the
+  // whole float range through it anyway
+  std::vector<float> inputs;
+  for (float x = -110.f; x <= 95.f; x += 0.37f) {
+    inputs.push_back(x);
+  }
+  for (float x : {0.f, -0.f, 1e-8f, -1e-8f, 88.7f, -87.3f}) {
+    inputs.push_back(x);
+  }
+  inputs.push_back(std::numeric_limits<float>::infinity());
+  inputs.push_back(-std::numeric_limits<float>::infinity());
+  inputs.push_back(std::numeric_limits<float>::quiet_NaN());
+
+  Buffer<T> in;
+  for (size_t start = 0; start < inputs.size(); start += n) {
+    int64_t count = std::min<int64_t>(n, inputs.size() - start);
+    for (int64_t i = 0; i < count; ++i) {
+      in[i] = static_cast<T>(inputs[start + i]);
+    }
+    auto out = to_buffer(Vec::loadu(in.data(), count).exp());
+    for (int64_t i = 0; i < count; ++i) {
+      T expected = static_cast<T>(std::exp(static_cast<double>(in[i])));
+      double e = static_cast<double>(expected);
+      double got = static_cast<double>(out[i]);
+      if (std::isnan(e) || std::isinf(e)) {
+        EXPECT_TRUE(same(out[i], expected)) << static_cast<double>(in[i]);
+      } else {
+        // a few ulp relative, absolute near the denormal range
+        double tol =
+            4 * static_cast<double>(std::numeric_limits<T>::epsilon()) * e +
+            std::numeric_limits<float>::min();
+        if constexpr (std::is_same_v<T, c10::Half>) {
+          tol = 1e-3 * e + 6e-8;
+        }
+        EXPECT_NEAR(got, e, tol) << static_cast<double>(in[i]);
+      }
+    }
+  }
+}
+
+TEST(VecHalfTest, convert_half_float) {
+  if (!capability_supported()) {
+    GTEST_SKIP() << "CPU does not support this capability";
+  }
+  using HalfVec = Vectorized<c10::Half>;
+  using FloatVec = Vectorized<float>;
+  static_assert(HalfVec::size() == 2 * FloatVec::size());
+  constexpr int64_t n = HalfVec::size();
+
+  std::vector<float> floats(n);
+  for (int64_t i = 0; i < n; ++i) {
+    // includes values that round when narrowed to half
+    floats[i] = (static_cast<float>(i) - 7.f) * 1.0001f;
+  }
+  FloatVec lo = FloatVec::loadu(floats.data());
+  FloatVec hi = FloatVec::loadu(floats.data() + FloatVec::size());
+  auto halves = to_buffer(convert_float_half(lo, hi));
+  for (int64_t i = 0; i < n; ++i) {
+    EXPECT_EQ(halves[i].x, c10::Half(floats[i]).x) << i;
+  }
+
+  auto [lo2, hi2] = convert_half_float(HalfVec::loadu(halves.data()));
+  auto lo2s = to_buffer(lo2);
+  auto hi2s = to_buffer(hi2);
+  for (int64_t i = 0; i < FloatVec::size(); ++i) {
+    EXPECT_EQ(lo2s[i], static_cast<float>(halves[i])) << i;
+    EXPECT_EQ(hi2s[i], static_cast<float>(halves[i + FloatVec::size()])) << i;
+  }
+
+  auto loaded = to_buffer(load_fp32_from_fp16(halves.data()));
+  for (int64_t i = 0; i < FloatVec::size(); ++i) {
+    EXPECT_EQ(loaded[i], static_cast<float>(halves[i])) << i;
+  }
+
+  // bulk conversion with a tail
+  std::vector<float> back(n - 3);
+  convert(halves.data(), back.data(), n - 3);
+  std::vector<c10::Half> again(n - 3);
+  convert(back.data(), again.data(), n - 3);
+  for (int64_t i = 0; i < n - 3; ++i) {
+    EXPECT_EQ(back[i], static_cast<float>(halves[i])) << i;
+    EXPECT_EQ(again[i].x, halves[i].x) << i;
+  }
+}
+
+TEST(VecBFloat16Test, convert_bfloat16_float) {
+  if (!capability_supported()) {
+    GTEST_SKIP() << "CPU does not support this capability";
+  }
+  // ties in both directions, values that round up into the next binade,
+  // to infinity, subnormals, infinities and NaN, then random values, with
+  // vector tails
+  std::vector<float> floats = {
+      1.00390625f,
+      1.01171875f,
+      -1.00390625f,
+      1.99999f,
+      3.4e38f,
+      1e-40f,
+      -0.f,
+      std::numeric_limits<float>::infinity(),
+      -std::numeric_limits<float>::infinity(),
+      std::numeric_limits<float>::quiet_NaN()};
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-1000.f, 1000.f);
+  for (int i = 0; i < 61; ++i) {
+    floats.push_back(dist(gen));
+  }
+  const int64_t n = static_cast<int64_t>(floats.size());
+  std::vector<c10::BFloat16> narrowed(n);
+  convert(floats.data(), narrowed.data(), n);
+  std::vector<float> widened(n);
+  convert(narrowed.data(), widened.data(), n);
+  for (int64_t i = 0; i < n; ++i) {
+    EXPECT_EQ(narrowed[i].x, c10::BFloat16(floats[i]).x) << floats[i];
+    if (std::isnan(floats[i])) {
+      EXPECT_TRUE(std::isnan(widened[i]));
+    } else {
+      EXPECT_EQ(widened[i], static_cast<float>(narrowed[i])) << i;
+    }
+  }
+  auto loaded = to_buffer(load_fp32_from_bf16(narrowed.data()));
+  for (int64_t i = 0; i < Vectorized<float>::size(); ++i) {
+    EXPECT_TRUE(
+        loaded[i] == widened[i] or
+        (std::isnan(loaded[i]) and std::isnan(widened[i])))
+        << i;
+  }
+}
+
+template <typename T>
+class VecFloat8Test : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if (!capability_supported()) {
+      GTEST_SKIP() << "CPU does not support this capability";
+    }
+  }
+};
+
+using Float8Types = ::testing::Types<c10::Float8_e4m3fn, c10::Float8_e5m2>;
+TYPED_TEST_SUITE(VecFloat8Test, Float8Types);
+
+TYPED_TEST(VecFloat8Test, convert_matches_scalar) {
+  // every value, with a vector tail
+  std::vector<TypeParam> all(256 + 3);
+  for (size_t i = 0; i < all.size(); ++i) {
+    all[i] = TypeParam(static_cast<uint8_t>(i), TypeParam::from_bits());
+  }
+  const int64_t n = static_cast<int64_t>(all.size());
+  std::vector<float> widened(n);
+  convert(all.data(), widened.data(), n);
+  for (int64_t i = 0; i < n; ++i) {
+    const float expected = static_cast<float>(all[i]);
+    EXPECT_TRUE(
+        widened[i] == expected or
+        (std::isnan(widened[i]) and std::isnan(expected)))
+        << i;
+  }
+
+  // ties, subnormals, saturation, infinities and NaN, then random values
+  // of every magnitude, including those of the widened values
+  const float inf = std::numeric_limits<float>::infinity();
+  std::vector<float> floats = {
+      0.f, -0.f, 1.0625f, 1.1875f, 0.0009765625f, 1e-7f, 240.f,
+      464.f, 500.f, 60000.f, 1e30f, inf, -inf, std::nanf("")};
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-2.f, 2.f);
+  for (int i = 0; i < 500; ++i) {
+    floats.push_back(std::ldexp(dist(gen), i % 40 - 20));
+  }
+  floats.insert(floats.end(), widened.begin(), widened.end());
+  const int64_t m = static_cast<int64_t>(floats.size());
+  std::vector<TypeParam> narrowed(m);
+  convert(floats.data(), narrowed.data(), m);
+  for (int64_t i = 0; i < m; ++i) {
+    EXPECT_EQ(narrowed[i].x, TypeParam(floats[i]).x) << floats[i];
+  }
+}
+
+TEST(VecFunctionalTest, map_and_reduce_all) {
+  if (!capability_supported()) {
+    GTEST_SKIP() << "CPU does not support this capability";
+  }
+  using Vec = Vectorized<float>;
+  for (int64_t size : {1, 3, 8, 16, 17, 100}) {
+    std::vector<float> in(size);
+    std::vector<float> in2(size);
+    std::vector<float> out(size + 1, -1.f);
+    for (int64_t i = 0; i < size; ++i) {
+      in[i] = static_cast<float>(i % 13) - 6.f;
+      in2[i] = static_cast<float>(i % 5);
+    }
+
+    map([](const Vec& x) { return x * Vec(2.f); }, out.data(), in.data(), size);
+    for (int64_t i = 0; i < size; ++i) {
+      EXPECT_EQ(out[i], in[i] * 2.f) << i;
+    }
+    EXPECT_EQ(out[size], -1.f);
+
+    map2(
+        [](const Vec& x, const Vec& y) { return x - y; },
+        out.data(),
+        in.data(),
+        in2.data(),
+        size);
+    for (int64_t i = 0; i < size; ++i) {
+      EXPECT_EQ(out[i], in[i] - in2[i]) << i;
+    }
+
+    map3(
+        [](const Vec& x, const Vec& y, const Vec& z) { return x * y + z; },
+        out.data(),
+        in.data(),
+        in2.data(),
+        in.data(),
+        size);
+    for (int64_t i = 0; i < size; ++i) {
+      EXPECT_EQ(out[i], in[i] * in2[i] + in[i]) << i;
+    }
+    EXPECT_EQ(out[size], -1.f);
+
+    // small integers, so the sum is exact in any order
+    float sum = reduce_all(
+        [](const Vec& x, const Vec& y) { return x + y; }, in.data(), size);
+    float expected_sum = 0;
+    float expected_max = in[0];
+    for (float x : in) {
+      expected_sum += x;
+      expected_max = std::max(expected_max, x);
+    }
+    EXPECT_EQ(sum, expected_sum) << size;
+    float max = reduce_all(
+        [](const Vec& x, const Vec& y) { return maximum(x, y); },
+        in.data(),
+        size);
+    EXPECT_EQ(max, expected_max) << size;
+
+    // the lanes past the tail map to a nonzero value and must not count
+    float expected_sum_squares = 0;
+    for (float x : in) {
+      expected_sum_squares += (x - 1.f) * (x - 1.f);
+    }
+    float sum_squares = map_reduce_all(
+        [](const Vec& x) { return (x - Vec(1.f)) * (x - Vec(1.f)); },
+        [](const Vec& x, const Vec& y) { return x + y; },
+        in.data(),
+        size);
+    EXPECT_EQ(sum_squares, expected_sum_squares) << size;
+  }
+}
+
+TEST(VecFunctionalTest, half_rounds_once) {
+  if (!capability_supported()) {
+    GTEST_SKIP() << "CPU does not support this capability";
+  }
+  using Vec = Vectorized<float>;
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-4.f, 4.f);
+  for (int64_t size : {1, 3, 8, 16, 17, 32, 33, 100}) {
+    std::vector<c10::Half> a(size);
+    std::vector<c10::Half> b(size);
+    std::vector<c10::Half> c(size);
+    for (int64_t i = 0; i < size; ++i) {
+      a[i] = c10::Half(dist(gen));
+      b[i] = c10::Half(dist(gen));
+      // away from zero, for the divisions
+      c[i] = c10::Half(dist(gen) + (i % 2 == 0 ? 5.f : -5.f));
+    }
+    const c10::Half sentinel(-1.f);
+    std::vector<c10::Half> out(size + 1, sentinel);
+
+    // a single operation matches c10::Half's scalar operators
+    map2(
+        [](const Vec& x, const Vec& y) { return x / y; },
+        out.data(),
+        a.data(),
+        c.data(),
+        size);
+    for (int64_t i = 0; i < size; ++i) {
+      EXPECT_EQ(out[i].x, (a[i] / c[i]).x) << i;
+    }
+    EXPECT_EQ(out[size].x, sentinel.x);
+
+    // an expression is computed in float and rounded once; no product is
+    // followed by a sum, so the float reference cannot contract to an fma
+    map(
+        [](const Vec& x) { return (x + Vec(1.f)) * x * Vec(3.f); },
+        out.data(),
+        a.data(),
+        size);
+    for (int64_t i = 0; i < size; ++i) {
+      const float x = static_cast<float>(a[i]);
+      EXPECT_EQ(out[i].x, c10::Half((x + 1.f) * x * 3.f).x) << i;
+    }
+    map3(
+        [](const Vec& x, const Vec& y, const Vec& z) {
+          return (x - y) * z / (y + z);
+        },
+        out.data(),
+        a.data(),
+        b.data(),
+        c.data(),
+        size);
+    for (int64_t i = 0; i < size; ++i) {
+      const float x = static_cast<float>(a[i]);
+      const float y = static_cast<float>(b[i]);
+      const float z = static_cast<float>(c[i]);
+      EXPECT_EQ(out[i].x, c10::Half((x - y) * z / (y + z)).x) << i;
+    }
+    EXPECT_EQ(out[size].x, sentinel.x);
+
+    // reductions are those of the widened values, and stay in float
+    std::vector<float> widened(size);
+    for (int64_t i = 0; i < size; ++i) {
+      widened[i] = static_cast<float>(a[i]);
+    }
+    const auto add = [](const Vec& x, const Vec& y) { return x + y; };
+    EXPECT_EQ(
+        reduce_all(add, a.data(), size),
+        reduce_all(add, widened.data(), size))
+        << size;
+    const auto square = [](const Vec& x) { return x * x; };
+    EXPECT_EQ(
+        map_reduce_all(square, add, a.data(), size),
+        map_reduce_all(square, add, widened.data(), size))
+        << size;
+  }
+
+  // intermediates beyond the range of half: rounding after every
+  // operation overflows to infinity, rounding once does not
+  const int64_t n = 2 * Vectorized<c10::Half>::size() + 1;
+  std::vector<c10::Half> big(n, c10::Half(300.f));
+  std::vector<c10::Half> ten(n, c10::Half(10.f));
+  std::vector<c10::Half> out(n);
+  map2(
+      [](const Vec& x, const Vec& y) { return x * x / y; },
+      out.data(),
+      big.data(),
+      ten.data(),
+      n);
+  EXPECT_TRUE(std::isinf(static_cast<float>(big[0] * big[0] / ten[0])));
+  for (int64_t i = 0; i < n; ++i) {
+    EXPECT_EQ(static_cast<float>(out[i]), 9000.f) << i;
+  }
+  EXPECT_EQ(
+      reduce_all(
+          [](const Vec& x, const Vec& y) { return x + y; }, big.data(), n),
+      300.f * n);
+}
@@ -0,0 +1,139 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/Convolution.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <thread>
+
+// Measures the GFLOP/s of conv2d over ResNet and MobileNet style layers
+// with each algorithm that supports them, contiguous (NCHW) and
+// channels-last (NHWC), and marks the one the heuristic picks.
+
+using at::native::ConvAlgorithm;
+
+namespace {
+
+constexpr double kMinSeconds = 0.2;
+
+struct Layer {
+  const char* name;
+  int64_t batch, cin, cout, size, kernel, stride, padding, groups;
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// negative when the algorithm does not support the layer
+double gflops(
+    const Layer& l,
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    ConvAlgorithm algorithm) {
+  auto conv = [&] {
+    return at::native::convolution_with_algorithm(
+        input,
+        weight,
+        std::nullopt,
+        l.stride,
+        l.padding,
+        1,
+        l.groups,
+        algorithm);
+  };
+  at::Tensor output;
+  try {
+    output = conv(); // warm up
+  } catch (const c10::Error&) {
+    return -1;
+  }
+  int reps = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    conv();
+    ++reps;
+    elapsed = seconds_since(start);
+  } while (elapsed < kMinSeconds);
+  const double flops = 2.0 * output.numel() * (l.cin / l.groups) * l.kernel *
+      l.kernel;
+  return flops * reps / elapsed / 1e9;
+}
+
+void run(const Layer& l, at::MemoryFormat memory_format, int threads) {
+  at::Tensor input =
+      at::empty({l.batch, l.cin, l.size, l.size}, at::ScalarType::Float,
+                memory_format);
+  input.fill_(1);
+  at::Tensor weight =
+      at::empty({l.cout, l.cin / l.groups, l.kernel, l.kernel});
+  weight.fill_(1);
+  at::set_num_threads(threads);
+  const ConvAlgorithm selected = at::native::select_conv_algorithm(
+      input, weight, l.stride, l.padding, 1, l.groups);
+  std::printf(
+      "%-10s %-5s %8d",
+      l.name,
+      memory_format == at::MemoryFormat::Contiguous ? "nchw" : "nhwc",
+      threads);
+  for (ConvAlgorithm algorithm :
+       {ConvAlgorithm::Im2col,
+        ConvAlgorithm::Direct,
+        ConvAlgorithm::Winograd2x3,
+        ConvAlgorithm::Winograd4x3}) {
+    const double result = gflops(l, input, weight, algorithm);
+    if (result < 0) {
+      std::printf(" %12s", "-");
+    } else {
+      std::printf(
+          " %11.2f%c", result, algorithm == selected ? '*' : ' ');
+    }
+  }
+  std::printf("\n");
+}
+
+} // namespace
+
+int main() {
+  const int cpus =
+      std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  // name, batch, cin, cout, size, kernel, stride, padding, groups
+  const Layer layers[] = {
+      {"stem7x7", 1, 3, 64, 224, 7, 2, 3, 1},
+      {"res3x3-56", 1, 64, 64, 56, 3, 1, 1, 1},
+      {"res3x3-28", 1, 128, 128, 28, 3, 1, 1, 1},
+      {"res3x3-7", 1, 512, 512, 7, 3, 1, 1, 1},
+      {"down3x3", 1, 128, 256, 28, 3, 2, 1, 1},
+      {"res1x1", 1, 256, 64, 56, 1, 1, 0, 1},
+      {"dw3x3", 1, 144, 144, 56, 3, 1, 1, 144},
+      {"dw3x3-s2", 1, 96, 96, 112, 3, 2, 1, 96},
+      {"b8-3x3", 8, 64, 64, 28, 3, 1, 1, 1},
+  };
+  std::printf(
+      "%-10s %-5s %8s %12s %12s %12s %12s   (GFLOP/s, * = selected)\n",
+      "layer",
+      "fmt",
+      "threads",
+      "im2col",
+      "direct",
+      "winograd2x3",
+      "winograd4x3");
+  for (int threads : {1, cpus}) {
+    for (const Layer& l : layers) {
+      for (at::MemoryFormat memory_format :
+           {at::MemoryFormat::Contiguous, at::MemoryFormat::ChannelsLast}) {
+        run(l, memory_format, threads);
+      }
+    }
+    if (cpus == 1) {
+      break;
+    }
+  }
+  at::set_num_threads(1);
+  return 0;
+}
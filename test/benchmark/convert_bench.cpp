@@ -0,0 +1,132 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/Copy.h>
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <utility>
+
+// Measures the throughput of dtype conversions with the conversion engine
+// (at::native::convert on contiguous buffers, copy_ from a transposed
+// matrix) against a per-element loop of C++ conversions, the way a cast
+// without the engine runs. Throughput counts the bytes read and written.
+
+namespace {
+
+constexpr int64_t kNumel = int64_t(1) << 22;
+constexpr double kMinSeconds = 0.1;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+template <typename F>
+double gb_per_second(int64_t bytes, const F& f) {
+  f(); // warm up
+  int reps = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    f();
+    ++reps;
+    elapsed = seconds_since(start);
+  } while (elapsed < kMinSeconds);
+  return static_cast<double>(bytes) * reps / elapsed / 1e9;
+}
+
+// dst[i] = src[i] through the C++ conversions, one element at a time
+void per_element(const at::Tensor& src, const at::Tensor& dst) {
+  AT_DISPATCH_ALL_TYPES_AND_FLOAT8(dst.scalar_type(), "per_element", [&] {
+    using dst_t = scalar_t;
+    AT_DISPATCH_ALL_TYPES_AND_FLOAT8(src.scalar_type(), "per_element", [&] {
+      const scalar_t* in = src.const_data_ptr<scalar_t>();
+      dst_t* out = dst.mutable_data_ptr<dst_t>();
+      for (int64_t i = 0; i < src.numel(); ++i) {
+        if constexpr (std::is_same_v<dst_t, bool>) {
+          out[i] = static_cast<float>(in[i]) != 0.f;
+        } else {
+          out[i] = static_cast<dst_t>(static_cast<float>(in[i]));
+        }
+      }
+    });
+  });
+}
+
+void run(at::ScalarType from, at::ScalarType to, int threads) {
+  at::Tensor src = at::empty({kNumel}, from);
+  src.fill_(3);
+  at::Tensor dst = at::empty({kNumel}, to);
+  const int64_t bytes = src.nbytes() + dst.nbytes();
+  at::set_num_threads(1);
+  const double scalar = gb_per_second(bytes, [&] { per_element(src, dst); });
+  at::set_num_threads(threads);
+  const double engine = gb_per_second(bytes, [&] {
+    at::native::convert(
+        src.const_data_ptr(), from, dst.mutable_data_ptr(), to, kNumel);
+  });
+  at::Tensor matrix = at::empty({2048, kNumel / 2048}, from).t();
+  matrix.fill_(3);
+  at::Tensor contiguous = at::empty({kNumel / 2048, 2048}, to);
+  const double strided =
+      gb_per_second(bytes, [&] { contiguous.copy_(matrix); });
+  at::set_num_threads(1);
+  std::printf(
+      "%-13s -> %-13s %8d %10.2f %10.2f %11.2f\n",
+      c10::toString(from),
+      c10::toString(to),
+      threads,
+      scalar,
+      engine,
+      strided);
+}
+
+} // namespace
+
+int main() {
+  using at::ScalarType;
+  const int cpus =
+      std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  const std::pair<ScalarType, ScalarType> pairs[] = {
+      {ScalarType::Float, ScalarType::Half},
+      {ScalarType::Half, ScalarType::Float},
+      {ScalarType::Double, ScalarType::Half},
+      {ScalarType::Half, ScalarType::Int},
+      {ScalarType::Byte, ScalarType::Half},
+      {ScalarType::Float, ScalarType::BFloat16},
+      {ScalarType::BFloat16, ScalarType::Float},
+      {ScalarType::Float, ScalarType::Float8_e4m3fn},
+      {ScalarType::Float8_e4m3fn, ScalarType::Float},
+      {ScalarType::Float, ScalarType::Double},
+      {ScalarType::Double, ScalarType::Float},
+      {ScalarType::Int, ScalarType::Float},
+      {ScalarType::Float, ScalarType::Int},
+      {ScalarType::Long, ScalarType::Float},
+      {ScalarType::Long, ScalarType::Double},
+      {ScalarType::Byte, ScalarType::Float},
+      {ScalarType::Float, ScalarType::Byte},
+      {ScalarType::Char, ScalarType::Long},
+      {ScalarType::Bool, ScalarType::Float},
+      {ScalarType::Float, ScalarType::Bool},
+      {ScalarType::Long, ScalarType::Bool},
+  };
+  std::printf(
+      "%-30s %8s %10s %10s %11s   (GB/s)\n",
+      "conversion",
+      "threads",
+      "scalar",
+      "convert",
+      "copy_(t())");
+  for (int threads : {1, cpus}) {
+    for (const auto& pair : pairs) {
+      run(pair.first, pair.second, threads);
+    }
+    if (cpus == 1) {
+      break;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+// Measures layout changes with copy_: a transposed 4096 x 4096 matrix and an
+// NCHW batch into contiguous and channels-last tensors, and the transposed
+// matrix converted to Half on the way, against a contiguous copy of the
+// same bytes, which is as fast as any copy can go. Throughput counts the
+// bytes read and written.
+
+namespace {
+
+constexpr double kMinSeconds = 0.2;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+template <typename F>
+double gb_per_second(int64_t bytes, const F& f) {
+  f(); // warm up
+  int reps = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    f();
+    ++reps;
+    elapsed = seconds_since(start);
+  } while (elapsed < kMinSeconds);
+  return static_cast<double>(bytes) * reps / elapsed / 1e9;
+}
+
+// copies src into dst and prints its throughput next to that of the
+// contiguous copy of src
+void run(const char* name, const at::Tensor& dst, const at::Tensor& src) {
+  const int64_t bytes = src.nbytes() + dst.nbytes();
+  const at::Tensor flat = at::empty(src.sizes(), src.scalar_type());
+  const at::Tensor flat_dst = at::empty(src.sizes(), dst.scalar_type());
+  flat.fill_(1);
+  const double contiguous =
+      gb_per_second(bytes, [&] { flat_dst.copy_(flat); });
+  const double layout = gb_per_second(bytes, [&] { dst.copy_(src); });
+  std::printf(
+      "%-32s %-9s %8d %12.2f %12.2f\n",
+      name,
+      c10::toString(src.scalar_type()),
+      at::get_num_threads(),
+      contiguous,
+      layout);
+}
+
+void run_all(at::ScalarType dtype) {
+  at::Tensor matrix = at::empty({4096, 4096}, dtype);
+  matrix.fill_(1);
+  run("t() -> contiguous", at::empty({4096, 4096}, dtype), matrix.t());
+  if (dtype == at::ScalarType::Float) {
+    run("t() -> contiguous Half",
+        at::empty({4096, 4096}, at::ScalarType::Half),
+        matrix.t());
+  }
+  at::Tensor nchw = at::empty({32, 64, 56, 56}, dtype);
+  nchw.fill_(1);
+  run("NCHW -> channels-last",
+      at::empty(nchw.sizes(), dtype, at::MemoryFormat::ChannelsLast),
+      nchw);
+  run("channels-last -> NCHW",
+      at::empty(nchw.sizes(), dtype),
+      nchw.contiguous(at::MemoryFormat::ChannelsLast));
+}
+
+} // namespace
+
+int main() {
+  const int cpus =
+      std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  std::printf(
+      "%-32s %-9s %8s %12s %12s   (GB/s)\n",
+      "copy",
+      "dtype",
+      "threads",
+      "contiguous",
+      "layout");
+  for (int threads : {1, cpus}) {
+    at::set_num_threads(threads);
+    for (at::ScalarType dtype :
+         {at::ScalarType::Byte,
+          at::ScalarType::Half,
+          at::ScalarType::Float,
+          at::ScalarType::Double}) {
+      run_all(dtype);
+    }
+    if (cpus == 1) {
+      break;
+    }
+  }
+  at::set_num_threads(1);
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/PrepackCache.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+// Measures the GFLOP/s of mm over square shapes and over the skinny shapes
+// of inference (a batch of M = 1..64 rows times a weight matrix), with the
+// weights both k x n and stored n x k and read transposed, the latter also
+// prepacked, on one thread and on every cpu.
+
+namespace {
+
+constexpr double kMinSeconds = 0.2;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+double gflops(const at::Tensor& a, const at::Tensor& b) {
+  a.mm(b); // warm up
+  int reps = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    a.mm(b);
+    ++reps;
+    elapsed = seconds_since(start);
+  } while (elapsed < kMinSeconds);
+  return 2.0 * a.size(0) * a.size(1) * b.size(1) * reps / elapsed / 1e9;
+}
+
+void run(at::ScalarType dtype, int64_t m, int64_t k, int64_t n, int threads) {
+  at::Tensor a = at::empty({m, k}, dtype);
+  a.fill_(1);
+  at::Tensor b = at::empty({k, n}, dtype);
+  b.fill_(1);
+  at::Tensor b_t = at::empty({n, k}, dtype);
+  b_t.fill_(1);
+  at::set_num_threads(threads);
+  const double plain = gflops(a, b);
+  const double transposed = gflops(a, b_t.t());
+  at::native::prepack_mm_weight(b_t.t());
+  const double prepacked = gflops(a, b_t.t());
+  at::native::empty_prepack_cache();
+  std::printf(
+      "%-6s %5lld %5lld %5lld %8d %10.2f %10.2f %10.2f\n",
+      dtype == at::ScalarType::Half ? "half" : "float",
+      static_cast<long long>(m),
+      static_cast<long long>(k),
+      static_cast<long long>(n),
+      threads,
+      plain,
+      transposed,
+      prepacked);
+}
+
+} // namespace
+
+int main() {
+  const int cpus =
+      std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  std::printf(
+      "%-6s %5s %5s %5s %8s %10s %10s %10s   (GFLOP/s)\n",
+      "dtype",
+      "M",
+      "K",
+      "N",
+      "threads",
+      "A @ B",
+      "A @ B^T",
+      "prepacked");
+  for (at::ScalarType dtype : {at::ScalarType::Float, at::ScalarType::Half}) {
+    for (int threads : {1, cpus}) {
+      for (int64_t size : {128, 512, 1024, 2048}) {
+        run(dtype, size, size, size, threads);
+      }
+      for (int64_t m : {1, 4, 16, 64}) {
+        run(dtype, m, 4096, 4096, threads);
+      }
+      if (cpus == 1) {
+        break;
+      }
+    }
+  }
+  at::set_num_threads(1);
+  return 0;
+}
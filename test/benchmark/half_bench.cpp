@@ -0,0 +1,89 @@
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Measures (a + b) * c / (a - c) over Half buffers three ways: with
+// c10::Half's scalar operators, with chained Vectorized<Half> operators, both
+// of which round to half after every operation, and with vec::map3, which
+// widens to float once and rounds once, in Gelem/s. The buffers fit in L2,
+// so conversions rather than memory bound the loops.
+
+namespace {
+
+using namespace at::vec;
+
+constexpr int64_t kSize = 1 << 14;
+constexpr double kMinSeconds = 0.2;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+template <typename F>
+double gelems(const F& f) {
+  f(); // warm up
+  int reps = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    f();
+    ++reps;
+    elapsed = seconds_since(start);
+  } while (elapsed < kMinSeconds);
+  return static_cast<double>(kSize) * reps / elapsed / 1e9;
+}
+
+} // namespace
+
+int main() {
+  std::vector<c10::Half> a(kSize);
+  std::vector<c10::Half> b(kSize);
+  std::vector<c10::Half> c(kSize);
+  std::vector<c10::Half> out(kSize);
+  for (int64_t i = 0; i < kSize; ++i) {
+    a[i] = c10::Half(static_cast<float>(i % 7) + 0.5f);
+    b[i] = c10::Half(static_cast<float>(i % 5) - 2.f);
+    c[i] = c10::Half(static_cast<float>(i % 3) + 8.f);
+  }
+
+  const double scalar = gelems([&] {
+    for (int64_t i = 0; i < kSize; ++i) {
+      out[i] = (a[i] + b[i]) * c[i] / (a[i] - c[i]);
+    }
+  });
+
+  using HalfVec = Vectorized<c10::Half>;
+  const double chained = gelems([&] {
+    for (int64_t i = 0; i < kSize; i += HalfVec::size()) {
+      const HalfVec x = HalfVec::loadu(a.data() + i);
+      const HalfVec y = HalfVec::loadu(b.data() + i);
+      const HalfVec z = HalfVec::loadu(c.data() + i);
+      ((x + y) * z / (x - z)).store(out.data() + i);
+    }
+  });
+
+  using Vec = Vectorized<float>;
+  const double mapped = gelems([&] {
+    map3(
+        [](const Vec& x, const Vec& y, const Vec& z) {
+          return (x + y) * z / (x - z);
+        },
+        out.data(),
+        a.data(),
+        b.data(),
+        c.data(),
+        kSize);
+  });
+
+  std::printf("%-28s %10s\n", "(a + b) * c / (a - c)", "Gelem/s");
+  std::printf("%-28s %10.2f\n", "c10::Half operators", scalar);
+  std::printf("%-28s %10.2f\n", "Vectorized<Half> operators", chained);
+  std::printf(
+      "%-28s %10.2f %8.2fx\n", "map3 in float", mapped, mapped / chained);
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+// Measures linear_4bit with Int4 and NF4 weights (groups of 128) against
+// the Float product x @ W^T and against decoding the weight with from_4bit
+// before that product, in GOP/s (two per multiply-add), over the batch
+// sizes of token generation, on one thread and on every cpu.
+
+namespace {
+
+constexpr double kMinSeconds = 0.2;
+constexpr int64_t kGroupSize = 128;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+template <typename F>
+double gops(int64_t m, int64_t k, int64_t n, const F& f) {
+  f(); // warm up
+  int reps = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    f();
+    ++reps;
+    elapsed = seconds_since(start);
+  } while (elapsed < kMinSeconds);
+  return 2.0 * m * k * n * reps / elapsed / 1e9;
+}
+
+void run(int64_t m, int64_t k, int64_t n, int threads) {
+  at::Tensor x = at::empty({m, k});
+  x.fill_(0.5);
+  at::Tensor w = at::empty({n, k});
+  w.fill_(0.25);
+  const at::Tensor int4_scales =
+      at::scales_4bit(w, at::ScalarType::Int4, kGroupSize);
+  const at::Tensor int4 = at::to_4bit(w, at::ScalarType::Int4, int4_scales);
+  const at::Tensor nf4_scales =
+      at::scales_4bit(w, at::ScalarType::NF4, kGroupSize);
+  const at::Tensor nf4 = at::to_4bit(w, at::ScalarType::NF4, nf4_scales);
+  at::set_num_threads(threads);
+  const double float_gops = gops(m, k, n, [&] { x.mm(w.t()); });
+  const double decode_gops = gops(
+      m, k, n, [&] { x.mm(at::from_4bit(int4, int4_scales).t()); });
+  const double int4_gops =
+      gops(m, k, n, [&] { at::linear_4bit(x, int4, int4_scales); });
+  const double nf4_gops =
+      gops(m, k, n, [&] { at::linear_4bit(x, nf4, nf4_scales); });
+  std::printf(
+      "%5lld %5lld %5lld %8d %10.2f %10.2f %10.2f %10.2f %8.2fx\n",
+      static_cast<long long>(m),
+      static_cast<long long>(k),
+      static_cast<long long>(n),
+      threads,
+      float_gops,
+      decode_gops,
+      int4_gops,
+      nf4_gops,
+      int4_gops / float_gops);
+}
+
+} // namespace
+
+int main() {
+  const int cpus =
+      std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  std::printf(
+      "%5s %5s %5s %8s %10s %10s %10s %10s %9s   (GOP/s)\n",
+      "M",
+      "K",
+      "N",
+      "threads",
+      "float",
+      "decode+mm",
+      "int4",
+      "nf4",
+      "speedup");
+  for (int threads : {1, cpus}) {
+    for (int64_t m : {1, 4, 16, 64, 256}) {
+      run(m, 4096, 4096, threads);
+    }
+    run(1, 4096, 11008, threads);
+    run(1, 11008, 4096, threads);
+    if (cpus == 1) {
+      break;
+    }
+  }
+  at::set_num_threads(1);
+  return 0;
+}
@@ -0,0 +1,175 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+// Measures the throughput of the fused softmax, layer_norm and rms_norm
+// kernels against the same computations composed of separate whole-tensor
+// passes (reductions with at:: ops, elementwise steps as plain loops, each
+// writing a full intermediate), as a framework without fusion would run
+// them. Throughput counts one read of the input and one write of the output.
+
+namespace {
+
+constexpr int kReps = 10;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+template <typename F>
+double gb_per_second(const at::Tensor& input, const F& f) {
+  f(); // warm up
+  auto start = std::chrono::steady_clock::now();
+  for (int rep = 0; rep < kReps; ++rep) {
+    f();
+  }
+  return 2.0 * static_cast<double>(input.nbytes()) * kReps /
+      seconds_since(start) / 1e9;
+}
+
+// the passes below read and write rows x n float matrices
+struct Passes {
+  int64_t rows, n;
+
+  // out[i][j] = f(a[i][j], r[i])
+  template <typename F>
+  void per_row(
+      at::Tensor& out,
+      const at::Tensor& a,
+      const at::Tensor& r,
+      F f) const {
+    const float* in = a.const_data_ptr<float>();
+    const float* row = r.const_data_ptr<float>();
+    float* o = out.mutable_data_ptr<float>();
+    for (int64_t i = 0; i < rows; ++i) {
+      for (int64_t j = 0; j < n; ++j) {
+        o[i * n + j] = f(in[i * n + j], row[i]);
+      }
+    }
+  }
+
+  // out[i][j] = f(a[i][j], v[j])
+  template <typename F>
+  void per_column(
+      at::Tensor& out,
+      const at::Tensor& a,
+      const at::Tensor& v,
+      F f) const {
+    const float* in = a.const_data_ptr<float>();
+    const float* col = v.const_data_ptr<float>();
+    float* o = out.mutable_data_ptr<float>();
+    for (int64_t i = 0; i < rows; ++i) {
+      for (int64_t j = 0; j < n; ++j) {
+        o[i * n + j] = f(in[i * n + j], col[j]);
+      }
+    }
+  }
+
+  // out[i][j] = f(a[i][j])
+  template <typename F>
+  void each(at::Tensor& out, const at::Tensor& a, F f) const {
+    const float* in = a.const_data_ptr<float>();
+    float* o = out.mutable_data_ptr<float>();
+    for (int64_t i = 0; i < rows * n; ++i) {
+      o[i] = f(in[i]);
+    }
+  }
+};
+
+// amax, subtract, exp, sum, divide
+void unfused_softmax(const Passes& p, const at::Tensor& x) {
+  at::Tensor max = x.amax({1});
+  at::Tensor shifted = at::empty(x.sizes());
+  p.per_row(shifted, x, max, [](float v, float m) { return v - m; });
+  at::Tensor e = at::empty(x.sizes());
+  p.each(e, shifted, [](float v) { return std::exp(v); });
+  at::Tensor sum = e.sum({1});
+  at::Tensor y = at::empty(x.sizes());
+  p.per_row(y, e, sum, [](float v, float s) { return v / s; });
+}
+
+// mean, subtract, square, mean, normalize, scale, shift
+void unfused_layer_norm(
+    const Passes& p,
+    const at::Tensor& x,
+    const at::Tensor& w,
+    const at::Tensor& b) {
+  at::Tensor mean = x.mean({1});
+  at::Tensor centered = at::empty(x.sizes());
+  p.per_row(centered, x, mean, [](float v, float m) { return v - m; });
+  at::Tensor squares = at::empty(x.sizes());
+  p.each(squares, centered, [](float v) { return v * v; });
+  at::Tensor var = squares.mean({1});
+  at::Tensor normalized = at::empty(x.sizes());
+  p.per_row(normalized, centered, var, [](float v, float s) {
+    return v / std::sqrt(s + 1e-5f);
+  });
+  at::Tensor scaled = at::empty(x.sizes());
+  p.per_column(scaled, normalized, w, [](float v, float g) { return v * g; });
+  at::Tensor y = at::empty(x.sizes());
+  p.per_column(y, scaled, b, [](float v, float c) { return v + c; });
+}
+
+// square, mean, normalize, scale
+void unfused_rms_norm(
+    const Passes& p,
+    const at::Tensor& x,
+    const at::Tensor& w) {
+  at::Tensor squares = at::empty(x.sizes());
+  p.each(squares, x, [](float v) { return v * v; });
+  at::Tensor mean_square = squares.mean({1});
+  at::Tensor normalized = at::empty(x.sizes());
+  p.per_row(normalized, x, mean_square, [](float v, float s) {
+    return v / std::sqrt(s + 1e-6f);
+  });
+  at::Tensor y = at::empty(x.sizes());
+  p.per_column(y, normalized, w, [](float v, float g) { return v * g; });
+}
+
+void run(int64_t rows, int64_t n) {
+  at::Tensor x = at::empty({rows, n});
+  float* data = x.mutable_data_ptr<float>();
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    data[i] = static_cast<float>(i % 17) / 8.f - 1.f;
+  }
+  at::Tensor w = at::empty({n});
+  w.fill_(1.5);
+  at::Tensor b = at::empty({n});
+  b.fill_(0.25);
+  const Passes p{rows, n};
+  std::printf(
+      "%7lld x %-7lld %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f\n",
+      static_cast<long long>(rows),
+      static_cast<long long>(n),
+      gb_per_second(x, [&] { x.softmax(1); }),
+      gb_per_second(x, [&] { unfused_softmax(p, x); }),
+      gb_per_second(x, [&] { at::layer_norm(x, {n}, w, b); }),
+      gb_per_second(x, [&] { unfused_layer_norm(p, x, w, b); }),
+      gb_per_second(x, [&] { at::rms_norm(x, {n}, w, 1e-6); }),
+      gb_per_second(x, [&] { unfused_rms_norm(p, x, w); }));
+}
+
+} // namespace
+
+int main() {
+  at::set_num_threads(1);
+  std::printf(
+      "%-17s %9s %9s %9s %9s %9s %9s   (GB/s, float)\n",
+      "rows x n",
+      "softmax",
+      "unfused",
+      "layernorm",
+      "unfused",
+      "rmsnorm",
+      "unfused");
+  run(8192, 128);
+  run(4096, 1024);
+  run(1024, 4096);
+  run(64, 65536);
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Measures the fixed cost of a parallel region (a parallel_for whose chunks do
+// no work) and how a compute-bound loop scales from 1 thread to every cpu.
+
+namespace {
+
+constexpr int kRegions = 20000;
+constexpr int64_t kScalingElements = 1 << 22;
+constexpr int kScalingReps = 5;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+double region_overhead_ns(int num_threads) {
+  // one chunk per thread
+  const int64_t range = num_threads;
+  std::vector<int64_t> sink(range);
+  auto body = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      sink[i] += i;
+    }
+  };
+  at::parallel_for(0, range, 0, body); // warm up
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < kRegions; ++r) {
+    at::parallel_for(0, range, 0, body);
+  }
+  return seconds_since(start) * 1e9 / kRegions;
+}
+
+double compute_bound_seconds(
+    const std::vector<float>& in,
+    std::vector<float>& out) {
+  auto start = std::chrono::steady_clock::now();
+  for (int rep = 0; rep < kScalingReps; ++rep) {
+    at::parallel_for(
+        0,
+        static_cast<int64_t>(in.size()),
+        at::internal::GRAIN_SIZE,
+        [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            float x = in[i];
+            for (int k = 0; k < 32; ++k) {
+              x = std::sqrt(x * 1.0001f + 0.5f);
+            }
+            out[i] = x;
+          }
+        });
+  }
+  return seconds_since(start) / kScalingReps;
+}
+
+} // namespace
+
+int main() {
+  const int max_threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<int> thread_counts;
+  for (int t = 1; t < max_threads; t *= 2) {
+    thread_counts.push_back(t);
+  }
+  thread_counts.push_back(max_threads);
+
+  std::printf("%8s %18s\n", "threads", "region overhead");
+  for (int t : thread_counts) {
+    at::set_num_threads(t);
+    std::printf("%8d %15.0f ns\n", t, region_overhead_ns(t));
+  }
+
+  std::vector<float> in(kScalingElements, 2.f);
+  std::vector<float> out(kScalingElements);
+  std::printf("\n%8s %12s %9s\n", "threads", "time", "speedup");
+  double baseline = 0;
+  for (int t : thread_counts) {
+    at::set_num_threads(t);
+    compute_bound_seconds(in, out); // warm up
+    const double elapsed = compute_bound_seconds(in, out);
+    if (t == 1) {
+      baseline = elapsed;
+    }
+    std::printf("%8d %9.2f ms %8.2fx\n", t, elapsed * 1e3, baseline / elapsed);
+  }
+  return 0;
+}
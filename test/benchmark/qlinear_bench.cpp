@@ -0,0 +1,91 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+// Measures quantized_linear against the Float product it replaces, x @ W^T
+// with the n x k weight read transposed, in GOP/s (two per multiply-add)
+// over the batch sizes of inference and square shapes, on one thread and
+// on every cpu.
+
+namespace {
+
+constexpr double kMinSeconds = 0.2;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+template <typename F>
+double gops(int64_t m, int64_t k, int64_t n, const F& f) {
+  f(); // warm up
+  int reps = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    f();
+    ++reps;
+    elapsed = seconds_since(start);
+  } while (elapsed < kMinSeconds);
+  return 2.0 * m * k * n * reps / elapsed / 1e9;
+}
+
+void run(int64_t m, int64_t k, int64_t n, int threads) {
+  at::Tensor x = at::empty({m, k});
+  x.fill_(0.5);
+  at::Tensor w = at::empty({n, k});
+  w.fill_(0.25);
+  at::Tensor bias = at::empty({n});
+  bias.fill_(0);
+  const at::Tensor qx =
+      at::quantize_per_tensor(x, 1.0 / 255, 0, at::ScalarType::QUInt8);
+  const at::Tensor qw =
+      at::quantize_per_tensor(w, 0.5 / 127, 0, at::ScalarType::QInt8);
+  at::set_num_threads(threads);
+  const double float_gops = gops(m, k, n, [&] { x.mm(w.t()); });
+  const double int8_gops = gops(
+      m, k, n, [&] { at::quantized_linear(qx, qw, bias, 0.1, 128); });
+  std::printf(
+      "%5lld %5lld %5lld %8d %10.2f %10.2f %8.2fx\n",
+      static_cast<long long>(m),
+      static_cast<long long>(k),
+      static_cast<long long>(n),
+      threads,
+      float_gops,
+      int8_gops,
+      int8_gops / float_gops);
+}
+
+} // namespace
+
+int main() {
+  const int cpus =
+      std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  std::printf(
+      "%5s %5s %5s %8s %10s %10s %9s   (GOP/s)\n",
+      "M",
+      "K",
+      "N",
+      "threads",
+      "float",
+      "int8",
+      "speedup");
+  for (int threads : {1, cpus}) {
+    for (int64_t m : {1, 16, 64, 256}) {
+      run(m, 4096, 4096, threads);
+    }
+    for (int64_t size : {512, 1024, 2048}) {
+      run(size, size, size, threads);
+    }
+    if (cpus == 1) {
+      break;
+    }
+  }
+  at::set_num_threads(1);
+  return 0;
+}
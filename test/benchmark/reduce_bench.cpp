@@ -0,0 +1,59 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+
+#include <chrono>
+#include <cstdio>
+
+// Measures the throughput of sum over the inner dim, the outer dim and all
+// dims of a float matrix, and of the same sums over Half.
+
+namespace {
+
+constexpr int kReps = 20;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+template <typename F>
+double gb_per_second(const at::Tensor& input, const F& f) {
+  f(); // warm up
+  auto start = std::chrono::steady_clock::now();
+  for (int rep = 0; rep < kReps; ++rep) {
+    f();
+  }
+  return static_cast<double>(input.nbytes()) * kReps / seconds_since(start) /
+      1e9;
+}
+
+void run(const char* name, const at::Tensor& x) {
+  std::printf(
+      "%-28s %10.2f %10.2f %10.2f\n",
+      name,
+      gb_per_second(x, [&] { x.sum({1}); }),
+      gb_per_second(x, [&] { x.sum({0}); }),
+      gb_per_second(x, [&] { x.sum(); }));
+}
+
+} // namespace
+
+int main() {
+  at::set_num_threads(1);
+  std::printf(
+      "%-28s %10s %10s %10s   (GB/s)\n", "", "sum(1)", "sum(0)", "sum()");
+  for (at::ScalarType dtype : {at::ScalarType::Float, at::ScalarType::Half}) {
+    at::Tensor wide = at::empty({64, 1 << 18}, dtype);
+    wide.fill_(1);
+    at::Tensor tall = at::empty({1 << 18, 64}, dtype);
+    tall.fill_(1);
+    at::Tensor square = at::empty({4096, 4096}, dtype);
+    square.fill_(1);
+    const bool half = dtype == at::ScalarType::Half;
+    run(half ? "half 64 x 262144" : "float 64 x 262144", wide);
+    run(half ? "half 262144 x 64" : "float 262144 x 64", tall);
+    run(half ? "half 4096 x 4096" : "float 4096 x 4096", square);
+  }
+  return 0;
+}
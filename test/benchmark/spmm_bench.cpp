@@ -0,0 +1,114 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+// Measures the product of a CSR matrix, 95% and 99% zeros, with a dense
+// Float matrix against the dense product of the same matrices, in useful
+// GFLOP/s (two per multiply-add of a specified element), on one thread and
+// on every cpu. The skewed matrices put half of their elements in 1% of
+// the rows, which a partition into equal numbers of rows would leave to a
+// single thread.
+
+namespace {
+
+constexpr double kMinSeconds = 0.2;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+template <typename F>
+double seconds_per_call(const F& f) {
+  f(); // warm up
+  int reps = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    f();
+    ++reps;
+    elapsed = seconds_since(start);
+  } while (elapsed < kMinSeconds);
+  return elapsed / reps;
+}
+
+// an m x k matrix with the given density, skewed or uniform over the rows
+at::Tensor sparse_matrix(int64_t m, int64_t k, double density, bool skewed) {
+  at::Tensor a = at::empty({m, k});
+  a.fill_(0);
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> dist(0, 1);
+  float* data = a.mutable_data_ptr<float>();
+  const int64_t heavy_rows = std::max<int64_t>(1, m / 100);
+  for (int64_t i = 0; i < m; ++i) {
+    double p = density;
+    if (skewed) {
+      // half of the elements in the first 1% of the rows
+      p = i < heavy_rows ? std::min(1.0, density * m / 2 / heavy_rows)
+                         : density / 2;
+    }
+    for (int64_t j = 0; j < k; ++j) {
+      if (dist(gen) < p) {
+        data[i * k + j] = 1;
+      }
+    }
+  }
+  return a;
+}
+
+void run(double density, bool skewed, int64_t n, int threads) {
+  const int64_t m = 4096;
+  const int64_t k = 4096;
+  const at::Tensor a = sparse_matrix(m, k, density, skewed);
+  const at::Tensor csr = a.to_sparse_csr();
+  at::Tensor b = at::empty({k, n});
+  b.fill_(0.5);
+  at::set_num_threads(threads);
+  const double flops = 2.0 * csr._nnz() * n;
+  const double sparse_s = seconds_per_call([&] { csr.mm(b); });
+  const double dense_s = seconds_per_call([&] { a.mm(b); });
+  std::printf(
+      "%7.0f%% %8s %5lld %8d %10.2f %10.2f %8.2fx\n",
+      100 * (1 - density),
+      skewed ? "skewed" : "uniform",
+      static_cast<long long>(n),
+      threads,
+      flops / sparse_s / 1e9,
+      flops / dense_s / 1e9,
+      dense_s / sparse_s);
+}
+
+} // namespace
+
+int main() {
+  const int cpus =
+      std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  std::printf(
+      "%8s %8s %5s %8s %10s %10s %9s   (4096 x 4096 @ 4096 x N, GFLOP/s)\n",
+      "zeros",
+      "rows",
+      "N",
+      "threads",
+      "csr",
+      "dense",
+      "speedup");
+  for (int threads : {1, cpus}) {
+    for (double density : {0.05, 0.01}) {
+      for (bool skewed : {false, true}) {
+        run(density, skewed, 64, threads);
+      }
+    }
+    run(0.01, true, 1, threads);
+    if (cpus == 1) {
+      break;
+    }
+  }
+  at::set_num_threads(1);
+  return 0;
+}
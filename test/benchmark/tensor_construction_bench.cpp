@@ -0,0 +1,121 @@
+#include <c10/core/Storage.h>
+#include <c10/core/StorageImpl.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/cpu/CPUAllocator.h>
+#include <c10/util/SlabPool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Measures how many storage/tensor objects can be created and destroyed per
+// second. Objects are created in batches and released in a shuffled order, as
+// temporaries of a real program are, so that the general purpose allocator
+// cannot simply recycle the last freed block.
+
+namespace {
+
+constexpr int kBatch = 256;
+constexpr int kRounds = 20000;
+constexpr int kThreads = 8;
+
+// same size as c10::StorageImpl, allocated from the general heap
+struct UnpooledImpl : public c10::intrusive_ptr_target {
+  char payload[sizeof(c10::StorageImpl) - sizeof(c10::intrusive_ptr_target)];
+};
+
+struct PooledImpl : public UnpooledImpl {
+  C10_SLAB_POOLED_ALLOCATION
+};
+
+std::vector<int> release_order() {
+  std::vector<int> order(kBatch);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937(42));
+  return order;
+}
+
+// create kBatch objects with `make`, then release them in shuffled order
+template <typename T, typename Make>
+void churn(std::vector<T>& objs, const std::vector<int>& order, Make make) {
+  for (auto& obj : objs) {
+    obj = make();
+  }
+  for (int i : order) {
+    objs[i] = T();
+  }
+}
+
+template <typename T, typename Make>
+double run(const char* name, int num_threads, Make make) {
+  const auto order = release_order();
+  auto body = [&] {
+    std::vector<T> objs(kBatch);
+    churn(objs, order, make); // warm up
+    for (int r = 0; r < kRounds / num_threads; ++r) {
+      churn(objs, order, make);
+    }
+  };
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int t = 1; t < num_threads; ++t) {
+    threads.emplace_back(body);
+  }
+  body();
+  for (auto& t : threads) {
+    t.join();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  const double rate =
+      static_cast<double>(kBatch) * (kRounds / num_threads) * num_threads /
+      elapsed.count();
+  std::printf(
+      "%-44s %2d threads %10.2f Mobj/s\n", name, num_threads, rate / 1e6);
+  return rate;
+}
+
+} // namespace
+
+int main() {
+  auto* allocator = c10::GetCPUAllocator();
+
+  for (int num_threads : {1, kThreads}) {
+    const double heap = run<c10::intrusive_ptr<UnpooledImpl>>(
+        "make_intrusive (operator new)", num_threads, [] {
+          return c10::make_intrusive<UnpooledImpl>();
+        });
+    const double pooled = run<c10::intrusive_ptr<PooledImpl>>(
+        "make_intrusive (slab pool)", num_threads, [] {
+          return c10::make_intrusive<PooledImpl>();
+        });
+    std::printf("impl allocation speedup: %.2fx\n", pooled / heap);
+
+    run<c10::Storage>(
+        "Storage(64 bytes), inline data", num_threads, [allocator] {
+          return c10::Storage(c10::Storage::use_byte_size_t{}, 64, allocator);
+        });
+
+    // resizable storages never co-allocate their data
+    run<c10::Storage>(
+        "Storage(64 bytes), separate data", num_threads, [allocator] {
+          return c10::Storage(
+              c10::Storage::use_byte_size_t{}, 64, allocator, true);
+        });
+
+    run<c10::intrusive_ptr<c10::TensorImpl>>(
+        "Storage + TensorImpl [4, 4] float", num_threads, [allocator] {
+          c10::Storage storage(
+              c10::Storage::use_byte_size_t{}, 64, allocator);
+          auto t = c10::make_intrusive<c10::TensorImpl>(
+              std::move(storage), TypeMeta(c10::ScalarType::Float));
+          t->set_sizes_contiguous({4, 4});
+          return t;
+        });
+  }
+  return 0;
+}
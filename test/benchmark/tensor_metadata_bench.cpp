@@ -0,0 +1,63 @@
+#include <c10/core/Storage.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/cpu/CPUAllocator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Emulates the metadata checks an op performs before launching a kernel
+// (data pointer, dtype, numel, contiguity, sizes and strides) over a working
+// set of tensors that is larger than L1, visited in random order.
+
+namespace {
+
+constexpr int kTensors = 16384;
+constexpr int kRounds = 200;
+
+} // namespace
+
+int main() {
+  std::printf("sizeof(TensorImpl) = %zu bytes\n", sizeof(c10::TensorImpl));
+
+  std::vector<c10::intrusive_ptr<c10::TensorImpl>> tensors;
+  tensors.reserve(kTensors);
+  for (int i = 0; i < kTensors; ++i) {
+    c10::Storage storage(
+        c10::Storage::use_byte_size_t{}, 4 * 8 * 8 * 4, c10::GetCPUAllocator());
+    auto t = c10::make_intrusive<c10::TensorImpl>(
+        std::move(storage), TypeMeta(c10::ScalarType::Float));
+    t->set_sizes_contiguous({4, 8, 8, 4});
+    tensors.push_back(std::move(t));
+  }
+  std::vector<int> order(kTensors);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937(0));
+
+  uintptr_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < kRounds; ++r) {
+    for (int i : order) {
+      const c10::TensorImpl& t = *tensors[i];
+      checksum += reinterpret_cast<uintptr_t>(t.data());
+      checksum += static_cast<uintptr_t>(t.dtype().toScalarType());
+      checksum += t.numel() + t.is_contiguous();
+      const auto sizes = t.sizes();
+      const auto strides = t.strides();
+      for (size_t d = 0; d < sizes.size(); ++d) {
+        checksum += sizes[d] * strides[d];
+      }
+    }
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::printf(
+      "metadata checks: %.2f ns/tensor (checksum %zu)\n",
+      elapsed.count() / (static_cast<double>(kTensors) * kRounds),
+      static_cast<size_t>(checksum));
+  return 0;
+}
@@ -1,8 +1,11 @@
 #include <c10/core/Allocator.h>
 #include <c10/core/DeviceType.h>
 #include <c10/cpu/CPUAllocator.h>
+#include <c10/cpu/impl/alloc.h>
 #include <gtest/gtest.h>
 
+#include <new>
+
 TEST(CPUAllocator, get) {
   using namespace c10;
   auto allocator = GetAllocator(DeviceType::CPU);
@@ -11,3 +14,24 @@ TEST(CPUAllocator, get) {
   EXPECT_TRUE(allocator->is_simple_data_ptr(block));
   EXPECT_TRUE(block.get() == block.get_context());
 }
+
+namespace {
+
+int g_free_memory_calls = 0;
+
+bool count_free_memory_call() {
+  ++g_free_memory_calls;
+  return false;
+}
+
+} // namespace
+
+TEST(CPUAllocator, failed_allocation_asks_to_free_memory) {
+  using namespace c10;
+  add_free_memory_callback(&count_free_memory_call);
+  auto allocator = GetAllocator(DeviceType::CPU);
+  ASSERT_THROW(allocator->allocate(size_t(1) << 62), std::bad_alloc);
+  EXPECT_EQ(g_free_memory_calls, 1);
+  allocator->allocate(34);
+  EXPECT_EQ(g_free_memory_calls, 1);
+}
@@ -0,0 +1,97 @@
+#include <c10/util/BFloat16.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+uint16_t bits_of(float value) {
+  return c10::BFloat16(value).x;
+}
+
+float from_bits(uint16_t bits) {
+  return static_cast<float>(c10::BFloat16(bits, c10::BFloat16::from_bits()));
+}
+
+float float_from_bits(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+} // namespace
+
+TEST(BFloat16Test, widening_is_exact) {
+  for (uint32_t bits = 0; bits <= 0xFFFF; ++bits) {
+    const float value = from_bits(static_cast<uint16_t>(bits));
+    if (std::isnan(value)) {
+      continue;
+    }
+    ASSERT_EQ(value, float_from_bits(bits << 16)) << bits;
+    // and narrowing the result gives it back
+    ASSERT_EQ(bits_of(value), bits);
+  }
+}
+
+TEST(BFloat16Test, rounds_to_nearest_even) {
+  // 1 + 2^-8 lies halfway between 1 and 1 + 2^-7: to the even one, 1
+  EXPECT_EQ(bits_of(1.00390625f), 0x3F80);
+  // 1 + 3 * 2^-8 lies halfway between 1 + 2^-7 and 1 + 2^-6: 1 + 2^-6
+  EXPECT_EQ(bits_of(1.01171875f), 0x3F82);
+  EXPECT_EQ(bits_of(-1.00390625f), 0xBF80);
+  // just above and below a tie
+  EXPECT_EQ(bits_of(float_from_bits(0x3F808001)), 0x3F81);
+  EXPECT_EQ(bits_of(float_from_bits(0x3F807FFF)), 0x3F80);
+  // the carry rounds up into the next binade
+  EXPECT_EQ(bits_of(float_from_bits(0x3FFFFFFF)), 0x4000);
+}
+
+TEST(BFloat16Test, special_values) {
+  const float inf = std::numeric_limits<float>::infinity();
+  EXPECT_EQ(bits_of(0.f), 0x0000);
+  EXPECT_EQ(bits_of(-0.f), 0x8000);
+  EXPECT_EQ(bits_of(inf), 0x7F80);
+  EXPECT_EQ(bits_of(-inf), 0xFF80);
+  // beyond the largest finite value, rounds to infinity
+  EXPECT_EQ(bits_of(std::numeric_limits<float>::max()), 0x7F80);
+  EXPECT_EQ(bits_of(-std::numeric_limits<float>::max()), 0xFF80);
+  // subnormals keep their upper bits
+  EXPECT_EQ(bits_of(float_from_bits(0x00012345)), 0x0001);
+  // NaNs, including ones whose payload is only in the dropped bits, stay
+  // NaN
+  EXPECT_TRUE(std::isnan(from_bits(bits_of(std::nanf("")))));
+  EXPECT_TRUE(std::isnan(from_bits(bits_of(float_from_bits(0x7F800001)))));
+  EXPECT_TRUE(std::isnan(from_bits(bits_of(float_from_bits(0xFF800001)))));
+}
+
+TEST(BFloat16Test, arithmetic_rounds_through_float) {
+  const c10::BFloat16 a(1.f);
+  const c10::BFloat16 b(0.00390625f);
+  // 1 + 2^-8 ties back to 1
+  EXPECT_EQ(static_cast<float>(a + b), 1.f);
+  EXPECT_EQ(static_cast<float>(a - b), 0.99609375f);
+  EXPECT_EQ(static_cast<float>(a * b), 0.00390625f);
+  EXPECT_EQ(static_cast<float>(a / b), 256.f);
+}
+
+TEST(BFloat16Test, numeric_limits) {
+  using limits = std::numeric_limits<c10::BFloat16>;
+  EXPECT_EQ(static_cast<float>(limits::epsilon()), 0.0078125f);
+  EXPECT_EQ(
+      static_cast<float>(limits::min()), std::numeric_limits<float>::min());
+  EXPECT_EQ(static_cast<float>(limits::max()), 3.38953139e38f);
+  EXPECT_EQ(static_cast<float>(limits::lowest()), -3.38953139e38f);
+  EXPECT_TRUE(std::isinf(static_cast<float>(limits::infinity())));
+  EXPECT_TRUE(std::isnan(static_cast<float>(limits::quiet_NaN())));
+  EXPECT_TRUE(std::isnan(static_cast<float>(limits::signaling_NaN())));
+  EXPECT_EQ(
+      static_cast<float>(limits::denorm_min()), float_from_bits(0x00010000));
+  // the step from 1 is epsilon
+  EXPECT_EQ(
+      static_cast<float>(
+          c10::BFloat16(1.f + static_cast<float>(limits::epsilon()))),
+      1.0078125f);
+}
@@ -0,0 +1,89 @@
+#include <c10/core/Contiguity.h>
+#include <c10/core/MemoryFormat.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using c10::compute_contiguity_flags;
+
+TEST(ContiguityTest, contiguous) {
+  auto flags = compute_contiguity_flags({2, 3, 4}, {12, 4, 1});
+  ASSERT_TRUE(flags.is_contiguous);
+  ASSERT_TRUE(flags.is_non_overlapping_and_dense);
+  ASSERT_FALSE(flags.is_channels_last_contiguous);
+  ASSERT_FALSE(flags.is_channels_last);
+
+  // strides of size-1 dims do not matter
+  flags = compute_contiguity_flags({2, 1, 4}, {4, 100, 1});
+  ASSERT_TRUE(flags.is_contiguous);
+
+  // neither do strides of empty tensors
+  flags = compute_contiguity_flags({2, 0, 4}, {7, 3, 2});
+  ASSERT_TRUE(flags.is_contiguous);
+  ASSERT_TRUE(flags.is_non_overlapping_and_dense);
+
+  flags = compute_contiguity_flags({}, {});
+  ASSERT_TRUE(flags.is_contiguous);
+  ASSERT_TRUE(flags.is_non_overlapping_and_dense);
+}
+
+TEST(ContiguityTest, non_contiguous) {
+  // a slice with a gap
+  auto flags = compute_contiguity_flags({2, 3}, {6, 1});
+  ASSERT_FALSE(flags.is_contiguous);
+  ASSERT_FALSE(flags.is_non_overlapping_and_dense);
+
+  // a transpose is dense but not contiguous
+  flags = compute_contiguity_flags({3, 2}, {1, 3});
+  ASSERT_FALSE(flags.is_contiguous);
+  ASSERT_TRUE(flags.is_non_overlapping_and_dense);
+
+  // expanded dims overlap
+  flags = compute_contiguity_flags({4, 3}, {0, 1});
+  ASSERT_FALSE(flags.is_contiguous);
+  ASSERT_FALSE(flags.is_non_overlapping_and_dense);
+}
+
+TEST(ContiguityTest, channels_last) {
+  const std::vector<int64_t> sizes = {2, 3, 4, 5};
+  const auto strides = c10::get_channels_last_strides_2d(sizes);
+  ASSERT_EQ(strides, std::vector<int64_t>({60, 1, 15, 3}));
+
+  auto flags = compute_contiguity_flags(sizes, strides);
+  ASSERT_FALSE(flags.is_contiguous);
+  ASSERT_TRUE(flags.is_channels_last_contiguous);
+  ASSERT_TRUE(flags.is_channels_last);
+  ASSERT_TRUE(flags.is_non_overlapping_and_dense);
+  ASSERT_FALSE(flags.is_channels_last_3d);
+
+  // NHWC ordered but with a gap between images
+  flags = compute_contiguity_flags(sizes, {100, 1, 15, 3});
+  ASSERT_FALSE(flags.is_channels_last_contiguous);
+  ASSERT_TRUE(flags.is_channels_last);
+  ASSERT_FALSE(flags.is_non_overlapping_and_dense);
+
+  // a contiguous NCHW tensor is not channels last
+  flags = compute_contiguity_flags(sizes, {60, 20, 5, 1});
+  ASSERT_TRUE(flags.is_contiguous);
+  ASSERT_FALSE(flags.is_channels_last_contiguous);
+  ASSERT_FALSE(flags.is_channels_last);
+
+  // ambiguous N111 falls back to NCHW
+  flags = compute_contiguity_flags({4, 1, 1, 1}, {1, 1, 1, 1});
+  ASSERT_TRUE(flags.is_contiguous);
+  ASSERT_TRUE(flags.is_channels_last_contiguous);
+  ASSERT_FALSE(flags.is_channels_last);
+}
+
+TEST(ContiguityTest, channels_last_3d) {
+  const std::vector<int64_t> sizes = {2, 3, 4, 5, 6};
+  const auto strides = c10::get_channels_last_strides_3d(sizes);
+  ASSERT_EQ(strides, std::vector<int64_t>({360, 1, 90, 18, 3}));
+
+  auto flags = compute_contiguity_flags(sizes, strides);
+  ASSERT_FALSE(flags.is_contiguous);
+  ASSERT_TRUE(flags.is_channels_last_3d_contiguous);
+  ASSERT_TRUE(flags.is_channels_last_3d);
+  ASSERT_TRUE(flags.is_non_overlapping_and_dense);
+  ASSERT_FALSE(flags.is_channels_last);
+}
@@ -0,0 +1,114 @@
+#include <c10/core/StorageImpl.h>
+#include <c10/cpu/CPUAllocator.h>
+#include <c10/util/ExclusivelyOwned.h>
+#include <c10/util/IntrusivePtr.h>
+#include <gtest/gtest.h>
+
+#include <utility>
+
+namespace {
+
+int live_objects = 0;
+
+class Counted : public c10::intrusive_ptr_target {
+ public:
+  explicit Counted(int v) : value(v) {
+    ++live_objects;
+  }
+
+  ~Counted() override {
+    --live_objects;
+  }
+
+  int value;
+};
+
+using OwnedCounted = c10::ExclusivelyOwned<c10::intrusive_ptr<Counted>>;
+
+uint32_t use_count(const Counted* p) {
+  return c10::raw::intrusive_ptr::use_count(const_cast<Counted*>(p));
+}
+
+} // namespace
+
+TEST(ExclusivelyOwnedTest, create_and_destroy) {
+  {
+    auto owned = c10::make_exclusively_owned<c10::intrusive_ptr<Counted>>(3);
+    ASSERT_TRUE(owned);
+    ASSERT_EQ(owned->value, 3);
+    ASSERT_EQ((*owned).value, 3);
+    ASSERT_EQ(live_objects, 1);
+    ASSERT_EQ(use_count(owned.get()), 1);
+  }
+  ASSERT_EQ(live_objects, 0);
+
+  OwnedCounted empty;
+  ASSERT_FALSE(empty);
+}
+
+TEST(ExclusivelyOwnedTest, move) {
+  OwnedCounted a(std::in_place, 1);
+  OwnedCounted b(std::move(a));
+  ASSERT_FALSE(a); // NOLINT(bugprone-use-after-move)
+  ASSERT_EQ(b->value, 1);
+
+  OwnedCounted c(std::in_place, 2);
+  c = std::move(b);
+  ASSERT_EQ(c->value, 1);
+  ASSERT_EQ(live_objects, 1);
+}
+
+TEST(ExclusivelyOwnedTest, take_escapes_to_shared) {
+  OwnedCounted owned(std::in_place, 5);
+  auto* raw = owned.get();
+  c10::intrusive_ptr<Counted> shared = std::move(owned).take();
+  ASSERT_FALSE(owned); // NOLINT(bugprone-use-after-move)
+  ASSERT_EQ(shared.get(), raw);
+  ASSERT_TRUE(shared.unique());
+  ASSERT_EQ(shared.weak_use_count(), 1);
+
+  c10::weak_intrusive_ptr<Counted> weak(shared);
+  shared.reset();
+  ASSERT_TRUE(weak.expire());
+  ASSERT_EQ(live_objects, 1); // kept alive by the weak reference
+  weak.reset();
+  ASSERT_EQ(live_objects, 0);
+}
+
+TEST(ExclusivelyOwnedTest, from_unique_intrusive_ptr) {
+  auto p = c10::make_intrusive<Counted>(7);
+  OwnedCounted owned(std::move(p));
+  ASSERT_EQ(owned->value, 7);
+
+  auto shared = c10::make_intrusive<Counted>(8);
+  auto copy = shared;
+  ASSERT_THROW(OwnedCounted{std::move(shared)}, c10::Error);
+}
+
+TEST(ExclusivelyOwnedTest, borrow) {
+  c10::intrusive_ptr<Counted> escaped;
+  {
+    OwnedCounted owned(std::in_place, 9);
+    auto borrowed = owned.borrow();
+    ASSERT_EQ((*borrowed)->value, 9);
+    ASSERT_EQ(use_count(owned.get()), 1);
+    // a callee that keeps a reference forces the shared release path
+    escaped = *borrowed;
+    ASSERT_EQ(use_count(owned.get()), 2);
+  }
+  ASSERT_EQ(live_objects, 1);
+  ASSERT_TRUE(escaped.unique());
+  escaped.reset();
+  ASSERT_EQ(live_objects, 0);
+}
+
+TEST(ExclusivelyOwnedTest, storage_impl) {
+  c10::ExclusivelyOwned<c10::intrusive_ptr<c10::StorageImpl>> storage(
+      std::in_place,
+      c10::StorageImpl::use_byte_size_t{},
+      128,
+      c10::GetCPUAllocator(),
+      false);
+  ASSERT_EQ(storage->nbytes(), 128);
+  ASSERT_NE(storage->data_ptr().get(), nullptr);
+}
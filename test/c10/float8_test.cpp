@@ -0,0 +1,172 @@
+#include <c10/util/Float8_e4m3fn.h>
+#include <c10/util/Float8_e5m2.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+template <typename T>
+class Float8Test : public ::testing::Test {};
+
+using Float8Types = ::testing::Types<c10::Float8_e4m3fn, c10::Float8_e5m2>;
+TYPED_TEST_SUITE(Float8Test, Float8Types);
+
+template <typename T>
+float from_bits(uint8_t bits) {
+  return static_cast<float>(T(bits, T::from_bits()));
+}
+
+// the value of the bits from the definition of the format
+template <typename T>
+double reference_value(uint8_t bits) {
+  constexpr int mantissa_bits = std::numeric_limits<T>::digits - 1;
+  constexpr int exponent_bits = 7 - mantissa_bits;
+  constexpr int bias = (1 << (exponent_bits - 1)) - 1;
+  const int exponent = (bits & 0x7F) >> mantissa_bits;
+  const int mantissa = bits & ((1 << mantissa_bits) - 1);
+  const double sign = bits & 0x80 ? -1 : 1;
+  if (exponent == 0) {
+    return sign * std::ldexp(mantissa, 1 - bias - mantissa_bits);
+  }
+  return sign *
+      std::ldexp(
+             mantissa + (1 << mantissa_bits),
+             exponent - bias - mantissa_bits);
+}
+
+template <typename T>
+bool is_nan_bits(uint8_t bits) {
+  if constexpr (std::is_same_v<T, c10::Float8_e4m3fn>) {
+    return (bits & 0x7F) == 0x7F;
+  } else {
+    return (bits & 0x7F) > 0x7C;
+  }
+}
+
+template <typename T>
+bool is_inf_bits(uint8_t bits) {
+  return std::is_same_v<T, c10::Float8_e5m2> and (bits & 0x7F) == 0x7C;
+}
+
+// x rounded to nearest even among the finite values, saturating
+template <typename T>
+uint8_t reference_round(float x) {
+  const double max = static_cast<float>(std::numeric_limits<T>::max());
+  const auto sign = static_cast<uint8_t>(x < 0 ? 0x80 : 0);
+  if constexpr (std::numeric_limits<T>::has_infinity) {
+    if (std::isinf(x)) {
+      return std::numeric_limits<T>::infinity().x | sign;
+    }
+  }
+  if (std::abs(x) >= max) {
+    return std::numeric_limits<T>::max().x | sign;
+  }
+  uint8_t best = 0;
+  double best_error = std::numeric_limits<double>::infinity();
+  for (int bits = 0; bits < 256; ++bits) {
+    const auto b = static_cast<uint8_t>(bits);
+    if (is_nan_bits<T>(b) or is_inf_bits<T>(b) or
+        std::signbit(x) != static_cast<bool>(b & 0x80)) {
+      continue;
+    }
+    const double error = std::abs(reference_value<T>(b) - x);
+    if (error < best_error or (error == best_error and (b & 1) == 0)) {
+      best = b;
+      best_error = error;
+    }
+  }
+  return best;
+}
+
+} // namespace
+
+TYPED_TEST(Float8Test, widening_is_exact) {
+  for (int bits = 0; bits < 256; ++bits) {
+    const auto b = static_cast<uint8_t>(bits);
+    const float value = from_bits<TypeParam>(b);
+    if (is_nan_bits<TypeParam>(b)) {
+      ASSERT_TRUE(std::isnan(value)) << bits;
+      ASSERT_TRUE(std::isnan(from_bits<TypeParam>(TypeParam(value).x)));
+      continue;
+    }
+    if (is_inf_bits<TypeParam>(b)) {
+      ASSERT_TRUE(std::isinf(value)) << bits;
+    } else {
+      ASSERT_EQ(value, reference_value<TypeParam>(b)) << bits;
+    }
+    // and narrowing the result gives it back
+    ASSERT_EQ(TypeParam(value).x, b) << bits;
+  }
+}
+
+TYPED_TEST(Float8Test, rounds_to_nearest_even) {
+  std::vector<float> values;
+  // every midpoint between neighbouring values, and just around it
+  for (int bits = 0; bits < 0x7F; ++bits) {
+    const auto b = static_cast<uint8_t>(bits);
+    const auto next = static_cast<uint8_t>(bits + 1);
+    if (is_nan_bits<TypeParam>(next) or is_inf_bits<TypeParam>(next)) {
+      break;
+    }
+    const float mid = static_cast<float>(
+        (reference_value<TypeParam>(b) + reference_value<TypeParam>(next)) /
+        2);
+    values.push_back(mid);
+    values.push_back(std::nextafter(mid, 0.f));
+    values.push_back(std::nextafter(mid, 1e9f));
+  }
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-2.f, 2.f);
+  for (int i = 0; i < 2000; ++i) {
+    // magnitudes across the whole range, subnormals included
+    values.push_back(std::ldexp(dist(gen), static_cast<int>(i % 40) - 20));
+  }
+  for (float x : values) {
+    ASSERT_EQ(TypeParam(x).x, reference_round<TypeParam>(x)) << x;
+    ASSERT_EQ(TypeParam(-x).x, reference_round<TypeParam>(-x)) << -x;
+  }
+}
+
+TYPED_TEST(Float8Test, saturates) {
+  using limits = std::numeric_limits<TypeParam>;
+  const float max = static_cast<float>(limits::max());
+  const float inf = std::numeric_limits<float>::infinity();
+  EXPECT_EQ(static_cast<float>(TypeParam(max * 1.1f)), max);
+  EXPECT_EQ(static_cast<float>(TypeParam(-max * 1.1f)), -max);
+  EXPECT_EQ(static_cast<float>(TypeParam(3e38f)), max);
+  if constexpr (limits::has_infinity) {
+    EXPECT_EQ(static_cast<float>(TypeParam(inf)), inf);
+    EXPECT_EQ(static_cast<float>(TypeParam(-inf)), -inf);
+  } else {
+    EXPECT_EQ(static_cast<float>(TypeParam(inf)), max);
+    EXPECT_EQ(static_cast<float>(TypeParam(-inf)), -max);
+  }
+  EXPECT_TRUE(std::isnan(static_cast<float>(TypeParam(std::nanf("")))));
+  EXPECT_TRUE(std::isnan(static_cast<float>(limits::quiet_NaN())));
+  // below half the smallest subnormal: zero, keeping the sign
+  const float tiny = static_cast<float>(limits::denorm_min()) / 4;
+  EXPECT_EQ(TypeParam(tiny).x, 0x00);
+  EXPECT_EQ(TypeParam(-tiny).x, 0x80);
+}
+
+TEST(Float8Test, numeric_limits) {
+  using e4m3 = std::numeric_limits<c10::Float8_e4m3fn>;
+  EXPECT_EQ(static_cast<float>(e4m3::max()), 448.f);
+  EXPECT_EQ(static_cast<float>(e4m3::lowest()), -448.f);
+  EXPECT_EQ(static_cast<float>(e4m3::min()), 0.015625f);
+  EXPECT_EQ(static_cast<float>(e4m3::denorm_min()), 0.001953125f);
+  EXPECT_EQ(static_cast<float>(e4m3::epsilon()), 0.125f);
+  using e5m2 = std::numeric_limits<c10::Float8_e5m2>;
+  EXPECT_EQ(static_cast<float>(e5m2::max()), 57344.f);
+  EXPECT_EQ(static_cast<float>(e5m2::lowest()), -57344.f);
+  EXPECT_EQ(static_cast<float>(e5m2::min()), 6.103515625e-05f);
+  EXPECT_EQ(static_cast<float>(e5m2::denorm_min()), 1.52587890625e-05f);
+  EXPECT_EQ(static_cast<float>(e5m2::epsilon()), 0.25f);
+  EXPECT_TRUE(std::isinf(static_cast<float>(e5m2::infinity())));
+}
@@ -1,7 +1,10 @@
 #include <c10/util/IntrusivePtr.h>
 #include <c10/util/MaybeOwned.h>
 #include <gtest/gtest.h>
+#include <atomic>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 class TestClass : public c10::intrusive_ptr_target {
  public:
@@ -162,3 +165,124 @@ TEST(IntrusivePtrTEST, test_maybe_owned) {
   auto owned = c10::MaybeOwned<decltype(ptr2)>::owned(std::move(ptr2));
   print_count(*owned);
 }
+
+namespace {
+
+class ReleaseCounter : public c10::intrusive_ptr_target {
+ public:
+  explicit ReleaseCounter(std::atomic<int>* released) : released_(released) {}
+
+  void release_resources() override {
+    released_->fetch_add(1);
+  }
+
+ private:
+  std::atomic<int>* released_;
+};
+
+} // namespace
+
+TEST(IntrusivePtrTEST, test_lock_after_expire) {
+  std::atomic<int> released{0};
+  auto ptr = c10::make_intrusive<ReleaseCounter>(&released);
+  c10::weak_intrusive_ptr<ReleaseCounter> wptr(ptr);
+  ptr.reset();
+  ASSERT_EQ(released.load(), 1);
+  ASSERT_TRUE(wptr.expire());
+  ASSERT_EQ(wptr.ref_use_count(), 0);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_FALSE(wptr.lock().defined());
+  }
+  ASSERT_EQ(wptr.ref_use_count(), 0);
+  ASSERT_EQ(wptr.weak_use_count(), 1);
+}
+
+TEST(IntrusivePtrTEST, test_concurrent_lock_and_release) {
+  constexpr int kThreads = 4;
+  for (int round = 0; round < 200; ++round) {
+    std::atomic<int> released{0};
+    std::atomic<bool> go{false};
+    auto ptr = c10::make_intrusive<ReleaseCounter>(&released);
+    c10::weak_intrusive_ptr<ReleaseCounter> wptr(ptr);
+    std::vector<std::thread> threads;
+    std::atomic<int> failed_after_success{0};
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&] {
+        while (!go.load()) {
+        }
+        bool seen_dead = false;
+        for (int i = 0; i < 100; ++i) {
+          auto locked = wptr.lock();
+          if (locked) {
+            // a revived target must never have released its resources
+            if (released.load() != 0 or seen_dead) {
+              failed_after_success.fetch_add(1);
+            }
+          } else {
+            seen_dead = true;
+          }
+        }
+      });
+    }
+    go.store(true);
+    ptr.reset();
+    for (auto& t : threads) {
+      t.join();
+    }
+    ASSERT_EQ(failed_after_success.load(), 0);
+    ASSERT_EQ(released.load(), 1);
+    ASSERT_TRUE(wptr.expire());
+  }
+}
+
+namespace {
+
+class DeleteCounter : public ReleaseCounter {
+ public:
+  DeleteCounter(std::atomic<int>* released, std::atomic<int>* deleted)
+      : ReleaseCounter(released), deleted_(deleted) {}
+
+  ~DeleteCounter() override {
+    deleted_->fetch_add(1);
+  }
+
+ private:
+  std::atomic<int>* deleted_;
+};
+
+} // namespace
+
+// The weak references are dropped while the last strong one is, by the
+// threads locking through them, so whichever reference goes last deletes
+// the target; run under ASan or TSan to see use after free.
+TEST(IntrusivePtrTEST, test_concurrent_weak_drop_and_release) {
+  constexpr int kThreads = 4;
+  for (int round = 0; round < 2000; ++round) {
+    std::atomic<int> released{0};
+    std::atomic<int> deleted{0};
+    std::atomic<bool> go{false};
+    auto ptr = c10::make_intrusive<DeleteCounter>(&released, &deleted);
+    std::vector<c10::weak_intrusive_ptr<DeleteCounter>> wptrs(
+        kThreads, c10::weak_intrusive_ptr<DeleteCounter>(ptr));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&, t] {
+        while (!go.load()) {
+        }
+        for (int i = 0; i < 1 + round % 8; ++i) {
+          // revives the target if it gets in before the release is sealed
+          auto locked = wptrs[t].lock();
+          locked.reset();
+        }
+        wptrs[t].reset();
+      });
+    }
+    go.store(true);
+    ptr.reset();
+    for (auto& t : threads) {
+      t.join();
+    }
+    ASSERT_EQ(deleted.load(), 1);
+    ASSERT_LE(released.load(), 1);
+  }
+}
@@ -0,0 +1,101 @@
+#include <c10/core/SizesAndStrides.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using c10::impl::SizesAndStrides;
+
+namespace {
+
+std::vector<int64_t> iota_vec(size_t n, int64_t start) {
+  std::vector<int64_t> v(n);
+  for (size_t i = 0; i < n; ++i) {
+    v[i] = start + static_cast<int64_t>(i);
+  }
+  return v;
+}
+
+void fill(SizesAndStrides& ss, size_t n) {
+  ss.set_sizes(iota_vec(n, 1));
+  ss.set_strides(iota_vec(n, 100));
+}
+
+void check(const SizesAndStrides& ss, size_t n) {
+  ASSERT_EQ(ss.size(), n);
+  for (size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(ss.size_at(i), static_cast<int64_t>(i) + 1);
+    ASSERT_EQ(ss.stride_at(i), static_cast<int64_t>(i) + 100);
+  }
+}
+
+} // namespace
+
+TEST(SizesAndStridesTest, default_and_inline) {
+  SizesAndStrides ss;
+  ASSERT_EQ(ss.size(), 1);
+  ASSERT_EQ(ss.size_at(0), 0);
+  ASSERT_EQ(ss.stride_at(0), 1);
+  // two 5-slot arrays plus the size, no 10-dim worth of padding
+  ASSERT_EQ(
+      sizeof(SizesAndStrides),
+      sizeof(size_t) + 2 * C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE * 8);
+
+  fill(ss, 4);
+  check(ss, 4);
+}
+
+TEST(SizesAndStridesTest, resize_across_inline_boundary) {
+  SizesAndStrides ss;
+  fill(ss, 3);
+  ss.resize(12);
+  ASSERT_EQ(ss.size(), 12);
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(ss.size_at(i), static_cast<int64_t>(i) + 1);
+    ASSERT_EQ(ss.stride_at(i), static_cast<int64_t>(i) + 100);
+  }
+  for (size_t i = 3; i < 12; ++i) {
+    ASSERT_EQ(ss.size_at(i), 0);
+    ASSERT_EQ(ss.stride_at(i), 0);
+  }
+
+  fill(ss, 12);
+  ss.resize(16); // grows out of line
+  ss.resize(7); // shrinks out of line
+  check(ss, 7);
+  ss.resize(5); // back inline
+  check(ss, 5);
+  ss.resize(2);
+  check(ss, 2);
+}
+
+TEST(SizesAndStridesTest, copy_and_move) {
+  for (size_t n : {1, 5, 6, 11}) {
+    SizesAndStrides ss;
+    fill(ss, n);
+
+    SizesAndStrides copy(ss);
+    check(copy, n);
+    check(ss, n);
+
+    SizesAndStrides copy_assigned;
+    fill(copy_assigned, 9);
+    copy_assigned = ss;
+    check(copy_assigned, n);
+
+    const int64_t* sizes = ss.sizes_data();
+    SizesAndStrides moved(std::move(ss));
+    check(moved, n);
+    if (n > C10_SIZES_AND_STRIDES_MAX_INLINE_SIZE) {
+      // the heap block was stolen, not copied
+      ASSERT_EQ(moved.sizes_data(), sizes);
+    }
+    ASSERT_EQ(ss.size(), 0); // NOLINT(bugprone-use-after-move)
+
+    SizesAndStrides move_assigned;
+    fill(move_assigned, 8);
+    move_assigned = std::move(moved);
+    check(move_assigned, n);
+  }
+}
@@ -0,0 +1,76 @@
+#include <c10/core/Storage.h>
+#include <c10/core/StorageImpl.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/cpu/CPUAllocator.h>
+#include <c10/util/SlabPool.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(SlabPoolTest, reuse_slot) {
+  void* p = c10::SlabPool::allocate(40);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % c10::SlabPool::kSlotAlignment, 0);
+  c10::SlabPool::deallocate(p, 40);
+  // the same size class is served LIFO from the thread cache
+  void* q = c10::SlabPool::allocate(48);
+  ASSERT_EQ(p, q);
+  c10::SlabPool::deallocate(q, 48);
+}
+
+TEST(SlabPoolTest, distinct_slots) {
+  std::vector<void*> ptrs;
+  std::set<void*> unique;
+  for (int i = 0; i < 1000; ++i) {
+    ptrs.push_back(c10::SlabPool::allocate(64));
+    unique.insert(ptrs.back());
+  }
+  ASSERT_EQ(unique.size(), ptrs.size());
+  for (auto* p : ptrs) {
+    c10::SlabPool::deallocate(p, 64);
+  }
+  ASSERT_LE(c10::SlabPool::cached_slots(64), c10::SlabPool::kMaxCachedSlots);
+}
+
+TEST(SlabPoolTest, large_falls_back) {
+  void* p = c10::SlabPool::allocate(c10::SlabPool::kMaxSlotSize + 1);
+  ASSERT_NE(p, nullptr);
+  c10::SlabPool::deallocate(p, c10::SlabPool::kMaxSlotSize + 1);
+}
+
+TEST(SlabPoolTest, cross_thread_free) {
+  std::vector<void*> ptrs;
+  std::thread producer([&] {
+    for (int i = 0; i < 2000; ++i) {
+      ptrs.push_back(c10::SlabPool::allocate(128));
+    }
+  });
+  producer.join();
+  // the producer's cache went to the depot on exit, these land in ours
+  for (auto* p : ptrs) {
+    c10::SlabPool::deallocate(p, 128);
+  }
+  ASSERT_GT(c10::SlabPool::cached_slots(128), 0);
+}
+
+TEST(SlabPoolTest, pooled_make_intrusive) {
+  auto* allocator = c10::GetCPUAllocator();
+  auto impl = c10::make_intrusive<c10::StorageImpl>(
+      c10::StorageImpl::use_byte_size_t{}, 16, allocator, false);
+  c10::StorageImpl* raw = impl.get();
+  impl.reset();
+  auto impl2 = c10::make_intrusive<c10::StorageImpl>(
+      c10::StorageImpl::use_byte_size_t{}, 16, allocator, false);
+  ASSERT_EQ(impl2.get(), raw);
+
+  c10::Storage storage(c10::Storage::use_byte_size_t{}, 64, allocator);
+  auto tensor = c10::make_intrusive<c10::TensorImpl>(
+      std::move(storage), TypeMeta(c10::ScalarType::Float));
+  tensor->set_sizes_contiguous({2, 8});
+  ASSERT_EQ(tensor->numel(), 16);
+  ASSERT_EQ(tensor->stride(0), 8);
+  ASSERT_EQ(tensor->stride(-1), 1);
+  ASSERT_NE(tensor->data(), nullptr);
+}
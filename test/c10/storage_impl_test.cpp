@@ -0,0 +1,70 @@
+#include <c10/core/Storage.h>
+#include <c10/core/StorageImpl.h>
+#include <c10/cpu/CPUAllocator.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+bool data_is_inline(const c10::Storage& storage) {
+  auto* impl = reinterpret_cast<const char*>(storage.unsafeGetStorageImpl());
+  auto* data = static_cast<const char*>(storage.data());
+  return data > impl and data < impl + sizeof(c10::StorageImpl) + 256;
+}
+
+} // namespace
+
+TEST(StorageImplTest, small_storage_is_inline) {
+  auto* allocator = c10::GetCPUAllocator();
+  for (size_t nbytes : {1, 8, 32, 33, 100, 256}) {
+    c10::Storage storage(c10::Storage::use_byte_size_t{}, nbytes, allocator);
+    ASSERT_EQ(storage.nbytes(), nbytes);
+    ASSERT_TRUE(data_is_inline(storage)) << nbytes;
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(storage.data()) % 16, 0);
+    ASSERT_EQ(storage.device(), c10::Device(c10::DeviceType::CPU));
+    ASSERT_FALSE(storage.resizable());
+    std::memset(storage.mutable_data(), 0x5a, nbytes);
+  }
+}
+
+TEST(StorageImplTest, large_or_resizable_storage_is_separate) {
+  auto* allocator = c10::GetCPUAllocator();
+  c10::Storage large(
+      c10::Storage::use_byte_size_t{},
+      c10::kMaxInlineStorageBytes + 1,
+      allocator);
+  ASSERT_FALSE(data_is_inline(large));
+  ASSERT_TRUE(allocator->is_simple_data_ptr(large.data_ptr()));
+
+  c10::Storage resizable(
+      c10::Storage::use_byte_size_t{}, 16, allocator, /*resizable=*/true);
+  ASSERT_FALSE(data_is_inline(resizable));
+  ASSERT_TRUE(resizable.resizable());
+
+  c10::Storage empty(c10::Storage::use_byte_size_t{}, 0, allocator);
+  ASSERT_EQ(empty.data(), nullptr);
+}
+
+TEST(StorageImplTest, inline_storage_outlives_strong_refs) {
+  auto* allocator = c10::GetCPUAllocator();
+  c10::Storage storage(c10::Storage::use_byte_size_t{}, 24, allocator);
+  auto weak = storage.getWeakStorageImpl();
+  storage = c10::Storage();
+  ASSERT_TRUE(weak.expire());
+  ASSERT_FALSE(weak.lock().defined());
+}
+
+TEST(StorageImplTest, version_counts_mutable_accesses) {
+  auto* allocator = c10::GetCPUAllocator();
+  c10::Storage storage(c10::Storage::use_byte_size_t{}, 1024, allocator);
+  const uint64_t version = storage.version();
+  storage.data();
+  storage.data_ptr();
+  ASSERT_EQ(storage.version(), version);
+  storage.mutable_data();
+  ASSERT_EQ(storage.version(), version + 1);
+  storage.set_data_ptr(allocator->allocate(1024));
+  ASSERT_EQ(storage.version(), version + 2);
+}
@@ -0,0 +1,113 @@
+#include <c10/core/Storage.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/cpu/CPUAllocator.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace {
+
+c10::intrusive_ptr<c10::TensorImpl> make_tensor(
+    c10::IntArrayRef sizes,
+    c10::ScalarType dtype = c10::ScalarType::Float) {
+  int64_t numel = 1;
+  for (auto s : sizes) {
+    numel *= s;
+  }
+  c10::Storage storage(
+      c10::Storage::use_byte_size_t{},
+      numel * c10::elementSize(dtype),
+      c10::GetCPUAllocator());
+  auto impl =
+      c10::make_intrusive<c10::TensorImpl>(std::move(storage), TypeMeta(dtype));
+  impl->set_sizes_contiguous(sizes);
+  return impl;
+}
+
+struct DummyAutogradMeta : c10::AutogradMetaInterface {
+  explicit DummyAutogradMeta(bool* destroyed) : destroyed_(destroyed) {}
+  ~DummyAutogradMeta() override {
+    *destroyed_ = true;
+  }
+  bool* destroyed_;
+};
+
+struct DummyBackendMeta : c10::BackendMeta {
+  int tag = 42;
+};
+
+} // namespace
+
+TEST(TensorImplTest, metadata) {
+  auto t = make_tensor({2, 3, 4});
+  ASSERT_EQ(t->dim(), 3);
+  ASSERT_EQ(t->numel(), 24);
+  ASSERT_EQ(t->sizes(), c10::IntArrayRef({2, 3, 4}));
+  ASSERT_EQ(t->strides(), c10::IntArrayRef({12, 4, 1}));
+  ASSERT_EQ(t->dtype(), TypeMeta(c10::ScalarType::Float));
+  ASSERT_EQ(t->itemsize(), 4);
+  ASSERT_EQ(t->device(), c10::Device(c10::DeviceType::CPU));
+  ASSERT_EQ(t->data(), t->storage().data());
+  ASSERT_THROW(t->size(3), c10::Error);
+}
+
+TEST(TensorImplTest, high_rank) {
+  std::vector<int64_t> sizes(12, 2);
+  auto t = make_tensor(sizes);
+  ASSERT_EQ(t->dim(), 12);
+  ASSERT_EQ(t->numel(), 4096);
+  ASSERT_EQ(t->stride(0), 2048);
+  ASSERT_EQ(t->stride(-1), 1);
+}
+
+TEST(TensorImplTest, cold_state_is_lazy) {
+  auto t = make_tensor({4});
+  ASSERT_EQ(t->autograd_meta(), nullptr);
+  ASSERT_EQ(t->named_tensor_meta(), nullptr);
+  ASSERT_FALSE(t->get_backend_meta_intrusive_ptr());
+  t->set_autograd_meta(nullptr); // must not allocate anything
+
+  bool destroyed = false;
+  t->set_autograd_meta(std::make_unique<DummyAutogradMeta>(&destroyed));
+  ASSERT_NE(t->autograd_meta(), nullptr);
+  t->set_backend_meta(c10::make_intrusive<DummyBackendMeta>());
+  auto backend_meta = t->get_backend_meta_intrusive_ptr();
+  ASSERT_EQ(static_cast<DummyBackendMeta*>(backend_meta.get())->tag, 42);
+
+  t.reset();
+  ASSERT_TRUE(destroyed);
+}
+
+TEST(TensorImplTest, layout_flags_follow_strides) {
+  auto t = make_tensor({2, 3, 4, 5});
+  ASSERT_TRUE(t->is_contiguous());
+  ASSERT_FALSE(t->is_contiguous(c10::MemoryFormat::ChannelsLast));
+
+  t->empty_tensor_restride(c10::MemoryFormat::ChannelsLast);
+  ASSERT_EQ(t->strides(), c10::IntArrayRef({60, 1, 15, 3}));
+  ASSERT_FALSE(t->is_contiguous());
+  ASSERT_TRUE(t->is_contiguous(c10::MemoryFormat::ChannelsLast));
+  ASSERT_TRUE(t->is_strides_like(c10::MemoryFormat::ChannelsLast));
+  ASSERT_TRUE(t->is_non_overlapping_and_dense());
+
+  // transpose the last two dims
+  t->set_sizes_and_strides({2, 3, 5, 4}, {60, 20, 1, 5}, 0);
+  ASSERT_EQ(t->numel(), 120);
+  ASSERT_FALSE(t->is_contiguous());
+  ASSERT_FALSE(t->is_contiguous(c10::MemoryFormat::ChannelsLast));
+  ASSERT_TRUE(t->is_non_overlapping_and_dense());
+
+  // take every other row
+  t->set_sizes_and_strides({2, 3, 2, 5}, {60, 20, 10, 1}, 5);
+  ASSERT_EQ(t->storage_offset(), 5);
+  ASSERT_FALSE(t->is_contiguous());
+  ASSERT_FALSE(t->is_non_overlapping_and_dense());
+
+  t->set_sizes_contiguous({6, 5});
+  ASSERT_TRUE(t->is_contiguous());
+  ASSERT_TRUE(t->is_non_overlapping_and_dense());
+
+  ASSERT_THROW(t->set_sizes_and_strides({2, 3}, {1}), c10::Error);
+}